@@ -166,6 +166,7 @@ static const char *tests[] = {
                               "rasterop_reg",
                               "rasteropip_reg",
                               "rectangle_reg",
+                              "rle_reg",
                               "rotate1_reg",
                               "rotate2_reg",
                               "rotateorth_reg",
@@ -178,6 +179,7 @@ static const char *tests[] = {
                               "speckle_reg",
                               "splitcomp_reg",
                               "string_reg",
+                              "stripio_reg",
                               "subpixel_reg",
                               "texturefill_reg",
                               "threshnorm_reg",
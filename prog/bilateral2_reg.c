@@ -34,6 +34,9 @@
  *     separable operation with full resolution intermediate images.
  *     Using 4x reduction on intermediates, this runs at about
  *     3 MPix/sec, with very good quality.
+ *
+ *     Also tests the bilateral grid, whose time does not depend
+ *     on the spatial stdev.
  */
 
 #include "allheaders.h"
@@ -45,7 +48,8 @@ static const l_int32  ncomps = 10;
 int main(int    argc,
          char **argv)
 {
-PIX          *pixs;
+BOX          *box;
+PIX          *pixs, *pix1, *pix2, *pix3;
 L_REGPARAMS  *rp;
 
     if (regTestSetup(argc, argv, &rp))
@@ -53,8 +57,32 @@ L_REGPARAMS  *rp;
 
     pixs = pixRead("test24.jpg");
     DoTestsOnImage(pixs, rp);  /* 0 - 7 */
+
+        /* Bilateral grid: compare with the exact filter on part
+         * of the image */
+    box = boxCreate(300, 300, 200, 200);
+    pix1 = pixClipRectangle(pixs, box, NULL);
+    pix2 = pixBilateralGrid(pix1, 5.0, 20.0);
+    pix3 = pixBlockBilateralExact(pix1, 5.0, 20.0);
+    regTestCompareSimilarPix(rp, pix2, pix3, 8, 0.01, 0);  /* 8 */
+    boxDestroy(&box);
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    pixDestroy(&pix3);
     pixDestroy(&pixs);
 
+        /* A step edge that is large compared to the range stdev
+         * is preserved exactly */
+    pix1 = pixCreate(120, 80, 8);
+    pixSetAllArbitrary(pix1, 50);
+    box = boxCreate(60, 0, 60, 80);
+    pixSetInRectArbitrary(pix1, box, 200);
+    pix2 = pixBilateralGrid(pix1, 10.0, 10.0);
+    regTestComparePix(rp, pix1, pix2);  /* 9 */
+    boxDestroy(&box);
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+
     return regTestCleanup(rp);
 }
 
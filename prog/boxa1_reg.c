@@ -39,7 +39,7 @@ int main(int    argc,
          char **argv)
 {
 l_uint8      *data1, *data2;
-l_int32       same;
+l_int32       i, n, same, x, y, w, h;
 size_t        size1, size2;
 l_float32     diffarea, diffxor;
 BOX          *box;
@@ -123,6 +123,59 @@ L_REGPARAMS  *rp;
     filesAreIdentical("/tmp/lept/boxa/boxa1.ba", "/tmp/lept/boxa/boxa2.ba",
                       &same);
     regTestCompareValues(rp, 1, same, 0.0);  /* 13 */
+    boxaDestroy(&boxa2);
+    lept_free(data1);
+    lept_free(data2);
+
+        /* Test compact boxa: it must serialize the same as the
+         * regular boxa, before and after the same modifications */
+    n = boxaGetCount(boxa1);
+    boxa2 = boxaCreateCompact(0);
+    for (i = 0; i < n; i++) {
+        boxaGetBoxGeometry(boxa1, i, &x, &y, &w, &h);
+        boxaAddBoxGeometry(boxa2, x, y, w, h);
+    }
+    regTestCompareValues(rp, 1, boxaIsCompact(boxa2), 0.0);  /* 14 */
+    boxaWriteMem(&data1, &size1, boxa1);
+    boxaWriteMem(&data2, &size2, boxa2);
+    regTestCompareStrings(rp, data1, size1, data2, size2);  /* 15 */
+    lept_free(data1);
+    lept_free(data2);
+    boxaInsertBox(boxa1, 1, boxCreate(10, 20, 30, 40));
+    boxaInsertBox(boxa2, 1, boxCreate(10, 20, 30, 40));
+    boxaRemoveBox(boxa1, 3);
+    boxaRemoveBox(boxa2, 3);
+    boxaSwapBoxes(boxa1, 0, n - 1);
+    boxaSwapBoxes(boxa2, 0, n - 1);
+    boxaReplaceBox(boxa1, 2, boxCreate(5, 6, 7, 8));
+    boxaReplaceBox(boxa2, 2, boxCreate(5, 6, 7, 8));
+    boxa3 = boxaCopy(boxa2, L_COPY);
+    regTestCompareValues(rp, 1, boxaIsCompact(boxa3), 0.0);  /* 16 */
+    boxaWriteMem(&data1, &size1, boxa1);
+    boxaWriteMem(&data2, &size2, boxa3);
+    regTestCompareStrings(rp, data1, size1, data2, size2);  /* 17 */
+    boxaGetBoxGeometry(boxa3, 2, &x, &y, &w, &h);
+    regTestCompareValues(rp, 26, x + y + w + h, 0.0);  /* 18 */
+    boxaDestroy(&boxa3);
+    lept_free(data1);
+    lept_free(data2);
+
+        /* A box taken from a compact boxa is not stored in it */
+    box = boxaGetBox(boxa2, 2, L_CLONE);
+    boxSetGeometry(box, 1, 1, 1, 1);
+    boxDestroy(&box);
+    boxaGetBoxGeometry(boxa2, 2, &x, &y, &w, &h);
+    regTestCompareValues(rp, 26, x + y + w + h, 0.0);  /* 19 */
+
+        /* Functions that modify boxes in place must write them back */
+    boxaAdjustBoxSides(boxa1, 1, -3, 2, -1, 4);
+    boxaAdjustBoxSides(boxa2, 1, -3, 2, -1, 4);
+    boxaSetSide(boxa1, boxa1, L_SET_LEFT, 20, 0);
+    boxaSetSide(boxa2, boxa2, L_SET_LEFT, 20, 0);
+    regTestCompareValues(rp, 1, boxaIsCompact(boxa2), 0.0);  /* 20 */
+    boxaWriteMem(&data1, &size1, boxa1);
+    boxaWriteMem(&data2, &size2, boxa2);
+    regTestCompareStrings(rp, data1, size1, data2, size2);  /* 21 */
     boxaDestroy(&boxa1);
     boxaDestroy(&boxa2);
     lept_free(data1);
@@ -31,6 +31,9 @@
  *
  *   (1) translated with respect to each other
  *   (2) only slightly different in content
+ *
+ *   It also tests the correlation counts over a window of shifts,
+ *   computed directly and by FFT, and registration by phase correlation.
  */
 
 #include "string.h"
@@ -40,9 +43,10 @@
 l_int32 main(int    argc,
              char **argv)
 {
-l_int32       delx, dely, etransx, etransy, w, h, area1, area2;
-l_int32      *stab, *ctab;
-l_float32     cx1, cy1, cx2, cy2, score, fract;
+l_int32       i, j, delx, dely, etransx, etransy, w, h, area1, area2;
+l_int32       count, same;
+l_int32      *stab, *ctab, *counts, *counts2;
+l_float32     cx1, cy1, cx2, cy2, score, score2, fract;
 PIX          *pix0, *pix1, *pix2, *pix3, *pix4, *pix5;
 L_REGPARAMS  *rp;
 
@@ -134,5 +138,64 @@ L_REGPARAMS  *rp;
     pixDestroy(&pix4);
     pixDestroy(&pix5);
 
+    /* ------------ Test of pixCorrelationCountShifts() ------------ */
+        /* Compare the counts for a window of shifts with the
+         * rasterop implementation in pixCorrelationScoreSimple() */
+    pix0 = pixRead("harmoniam100-11.png");
+    pix1 = pixConvertTo1(pix0, 160);
+    pixGetDimensions(pix1, &w, &h, NULL);
+    pix2 = pixCreate(w - 37, h - 5, 1);
+    pixRasterop(pix2, 0, 0, w, h, PIX_SRC, pix1, 29, 7);
+    stab = makePixelSumTab8();
+    pixCountPixels(pix1, &area1, stab);
+    pixCountPixels(pix2, &area2, stab);
+    counts = (l_int32 *)lept_calloc(9 * 7, sizeof(l_int32));
+    pixCorrelationCountShifts(pix1, pix2, 25, 4, 9, 7, 0, stab, counts, NULL);
+    same = TRUE;
+    for (i = 0; i < 7; i++) {
+        for (j = 0; j < 9; j++) {
+            pixCorrelationScoreSimple(pix1, pix2, area1, area2, 25 + j, 4 + i,
+                                      100, 100, stab, &score);
+            count = counts[i * 9 + j];
+            score2 = (l_float32)count * (l_float32)count /
+                     ((l_float32)area1 * (l_float32)area2);
+            if (score != score2) same = FALSE;
+        }
+    }
+    regTestCompareValues(rp, TRUE, same, 0);  /* 13 */
+    pixCorrelationScoreShifted(pix1, pix2, area1, area2, 29, 7, stab, &score);
+    regTestCompareValues(rp, (l_float32)area2 / (l_float32)area1, score,
+                         0.0001);  /* 14 */
+    lept_free(counts);
+
+        /* Compare the counts found by FFT over a large window of shifts */
+    counts = (l_int32 *)lept_calloc(41 * 41, sizeof(l_int32));
+    counts2 = (l_int32 *)lept_calloc(41 * 41, sizeof(l_int32));
+    pixCorrelationCountShifts(pix1, pix2, 9, -13, 41, 41, 0, stab,
+                              counts, NULL);
+    pixCorrelationCountShiftsFFT(pix1, pix2, 9, -13, 41, 41, counts2);
+    same = TRUE;
+    for (i = 0; i < 41 * 41; i++) {
+        if (counts[i] != counts2[i]) same = FALSE;
+    }
+    regTestCompareValues(rp, TRUE, same, 0);  /* 15 */
+    lept_free(counts);
+    lept_free(counts2);
+
+        /* This window is large enough to use the FFT */
+    pixBestCorrelation(pix1, pix2, area1, area2, 20, 0, 20, stab,
+                       &delx, &dely, NULL, 0);
+    regTestCompareValues(rp, 29, delx, 0);  /* 16 */
+    regTestCompareValues(rp, 7, dely, 0);  /* 17 */
+
+        /* Registration by phase correlation */
+    pixPhaseCorrelation(pix1, pix2, &delx, &dely, NULL);
+    regTestCompareValues(rp, 29, delx, 0);  /* 18 */
+    regTestCompareValues(rp, 7, dely, 0);  /* 19 */
+    lept_free(stab);
+    pixDestroy(&pix0);
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+
     return regTestCleanup(rp);
 }
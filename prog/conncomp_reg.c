@@ -33,7 +33,8 @@
  *      test of rasterop.
  *
  *      Also tests iterative covering of connected components by
- *      minimum spanning rectangles.
+ *      minimum spanning rectangles, and the labelling of connected
+ *      components with pixConnCompLabel().
  */
 
 #include "allheaders.h"
@@ -43,9 +44,13 @@ int main(int    argc,
 {
 l_uint8      *array1, *array2;
 l_int32       i, n1, n2, n3;
+l_uint32      val;
+l_float32     x, y;
 size_t        size1, size2;
 FILE         *fp;
 BOXA         *boxa1, *boxa2;
+NUMA         *na1;
+PTA          *pta1;
 PIX          *pixs, *pix1, *pix2, *pix3;
 PIXA         *pixa1;
 PIXCMAP      *cmap;
@@ -155,6 +160,43 @@ L_REGPARAMS  *rp;
     pixDestroy(&pix3);
     pixaDestroy(&pixa1);
 
+    /* --------------------------------------------------------------- *
+     *      Test pixConnCompLabel(): a rectangle with a pixel that      *
+     *      touches its corner diagonally                              *
+     * --------------------------------------------------------------- */
+    pix1 = pixCreate(20, 10, 1);
+    pixRasterop(pix1, 2, 2, 4, 3, PIX_SET, NULL, 0, 0);
+    pixSetPixel(pix1, 6, 5, 1);
+    pixConnCompLabel(pix1, 4, 0, &pix2, &boxa1, NULL, NULL);
+    regTestCompareValues(rp, 2, boxaGetCount(boxa1), 0);  /* 19 */
+    pixGetPixel(pix2, 6, 5, &val);
+    regTestCompareValues(rp, 2, val, 0);  /* 20 */
+    pixConnCompLabel(pix1, 8, 0, NULL, &boxa2, &na1, &pta1);
+    regTestCompareValues(rp, 1, boxaGetCount(boxa2), 0);  /* 21 */
+    numaGetIValue(na1, 0, &n1);
+    regTestCompareValues(rp, 13, n1, 0);  /* 22 */
+    ptaGetPt(pta1, 0, &x, &y);
+    regTestCompareValues(rp, 48.0 / 13.0, x, 0.0001);  /* 23 */
+    pixDestroy(&pix2);
+    boxaDestroy(&boxa1);
+    boxaDestroy(&boxa2);
+    numaDestroy(&na1);
+    ptaDestroy(&pta1);
+
+        /* Only pixConnCompBBCompact() returns a compact boxa */
+    boxa1 = pixConnCompBB(pix1, 4);
+    boxa2 = pixConnCompBBCompact(pix1, 4);
+    regTestCompareValues(rp, 0, boxaIsCompact(boxa1), 0);  /* 24 */
+    regTestCompareValues(rp, 1, boxaIsCompact(boxa2), 0);  /* 25 */
+    boxaWriteMem(&array1, &size1, boxa1);
+    boxaWriteMem(&array2, &size2, boxa2);
+    regTestCompareStrings(rp, array1, size1, array2, size2);  /* 26 */
+    lept_free(array1);
+    lept_free(array2);
+    pixDestroy(&pix1);
+    boxaDestroy(&boxa1);
+    boxaDestroy(&boxa2);
+
     return regTestCleanup(rp);
 }
 
@@ -28,6 +28,9 @@
  *  convolve_reg.c
  *
  *    Tests a number of convolution functions.
+ *    Also compares the recursive gaussian with convolution
+ *    by a gaussian kernel, and convolution by FFT with direct
+ *    convolution.
  */
 
 #include "allheaders.h"
@@ -52,6 +55,8 @@ int main(int    argc,
          char **argv)
 {
 l_int32       i, j, sizex, sizey, bias;
+l_float32     minval, maxval;
+BOX          *box;
 FPIX         *fpixv, *fpixrv;
 L_KERNEL     *kel1, *kel2, *kel3x, *kel3y;
 PIX          *pixs, *pixacc, *pixg, *pixt, *pixd;
@@ -203,5 +208,61 @@ L_REGPARAMS  *rp;
     fpixDestroy(&fpixv);
     fpixDestroy(&fpixrv);
 
+        /* Recursive gaussian: compare with the gaussian kernel
+         * away from the image boundary */
+    pixs = pixRead("test8.jpg");
+    kel3x = makeGaussianKernel(0, 40, 10.0, 1.0);
+    kel3y = makeGaussianKernel(40, 0, 10.0, 1.0);
+    pix1 = pixConvolveSep(pixs, kel3x, kel3y, 8, 1);
+    pix2 = pixGaussianRecursive(pixs, 10.0);
+    box = boxCreate(40, 40, pixGetWidth(pixs) - 80, pixGetHeight(pixs) - 80);
+    pix3 = pixClipRectangle(pix1, box, NULL);
+    pix4 = pixClipRectangle(pix2, box, NULL);
+    regTestCompareSimilarPix(rp, pix3, pix4, 4, 0.01, 0);  /* 18 */
+    pixDestroy(&pixs);
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    pixDestroy(&pix3);
+    pixDestroy(&pix4);
+    boxDestroy(&box);
+    kernelDestroy(&kel3x);
+    kernelDestroy(&kel3y);
+
+        /* A constant is unchanged */
+    fpixv = fpixCreate(50, 30);
+    fpixSetAllArbitrary(fpixv, 7.5);
+    fpixrv = fpixGaussianRecursive(fpixv, 20.0);
+    fpixGetMin(fpixrv, &minval, NULL, NULL);
+    fpixGetMax(fpixrv, &maxval, NULL, NULL);
+    regTestCompareValues(rp, 7.5, minval, 0.001);  /* 19 */
+    regTestCompareValues(rp, 7.5, maxval, 0.001);  /* 20 */
+    fpixDestroy(&fpixv);
+    fpixDestroy(&fpixrv);
+
+        /* With the FFT enabled, large kernels are convolved by FFT;
+         * compare with the separable convolution, which is direct */
+    l_setConvolveFFT(400);
+    pixs = pixRead("test8.jpg");
+    kel1 = makeGaussianKernel(12, 12, 5.0, 1.0);
+    kel3x = makeGaussianKernel(0, 12, 5.0, 1.0);
+    kel3y = makeGaussianKernel(12, 0, 5.0, 1.0);
+    pix1 = pixConvolve(pixs, kel1, 8, 1);
+    pix2 = pixConvolveSep(pixs, kel3x, kel3y, 8, 1);
+    regTestCompareSimilarPix(rp, pix1, pix2, 2, 0.0, 0);  /* 21 */
+    fpixv = pixConvertToFPix(pixs, 1);
+    fpixrv = fpixConvolve(fpixv, kel1, 1);
+    pix3 = fpixConvertToPix(fpixrv, 8, L_CLIP_TO_ZERO, 0);
+    regTestCompareSimilarPix(rp, pix1, pix3, 2, 0.0, 0);  /* 22 */
+    l_setConvolveFFT(0);
+    pixDestroy(&pixs);
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    pixDestroy(&pix3);
+    fpixDestroy(&fpixv);
+    fpixDestroy(&fpixrv);
+    kernelDestroy(&kel1);
+    kernelDestroy(&kel3x);
+    kernelDestroy(&kel3y);
+
     return regTestCleanup(rp);
 }
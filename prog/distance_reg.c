@@ -33,6 +33,9 @@
  *     connectivity :   4 or 8
  *     dest depth :     8 or 16
  *     boundary cond :  L_BOUNDARY_BG or L_BOUNDARY_FG
+ *
+ *   It also tests the exact Euclidean distance function,
+ *   pixEuclideanDistance(), and pixSeedspreadEuclidean().
  */
 
 #include "allheaders.h"
@@ -47,8 +50,11 @@ int main(int    argc,
          char **argv)
 {
 l_int32       i, j, k, index, conn, depth, bc;
+l_uint32      val;
+l_float32     fval;
 BOX          *box;
-PIX          *pix, *pixs, *pixd;
+FPIX         *fpix;
+PIX          *pix, *pixs, *pixd, *pix1, *pix2, *pix3;
 PIXA         *pixa;
 L_REGPARAMS  *rp;
 
@@ -83,6 +89,43 @@ L_REGPARAMS  *rp;
         }
     }
 
+        /* Exact Euclidean distance from a single bg pixel at the center */
+    pix1 = pixCreate(101, 101, 1);
+    pixSetAll(pix1);
+    pixSetPixel(pix1, 50, 50, 0);
+    pix2 = pixEuclideanDistance(pix1, 32, L_BOUNDARY_FG);
+    pixGetPixel(pix2, 0, 0, &val);
+    regTestCompareValues(rp, 5000, val, 0);  /* 61 */
+    pixGetPixel(pix2, 50, 0, &val);
+    regTestCompareValues(rp, 2500, val, 0);  /* 62 */
+    pixGetPixel(pix2, 53, 46, &val);
+    regTestCompareValues(rp, 25, val, 0);  /* 63 */
+    fpix = pixEuclideanDistanceFPix(pix1, L_BOUNDARY_FG);
+    fpixGetPixel(fpix, 0, 0, &fval);
+    regTestCompareValues(rp, 70.7107, fval, 0.001);  /* 64 */
+    pix3 = pixEuclideanDistance(pix1, 16, L_BOUNDARY_BG);
+    pixGetPixel(pix3, 0, 0, &val);
+    regTestCompareValues(rp, 1, val, 0);  /* 65 */
+    pixGetPixel(pix3, 40, 50, &val);
+    regTestCompareValues(rp, 10, val, 0);  /* 66 */
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    pixDestroy(&pix3);
+    fpixDestroy(&fpix);
+
+        /* Euclidean seed spread of two seeds: the boundary between
+         * the two regions is the perpendicular bisector */
+    pix1 = pixCreate(60, 40, 8);
+    pixSetPixel(pix1, 10, 20, 100);
+    pixSetPixel(pix1, 50, 20, 200);
+    pix2 = pixSeedspreadEuclidean(pix1);
+    pixGetPixel(pix2, 29, 0, &val);
+    regTestCompareValues(rp, 100, val, 0);  /* 67 */
+    pixGetPixel(pix2, 31, 39, &val);
+    regTestCompareValues(rp, 200, val, 0);  /* 68 */
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+
     boxDestroy(&box);
     pixDestroy(&pix);
     pixDestroy(&pixs);
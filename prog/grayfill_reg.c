@@ -148,6 +148,26 @@ L_REGPARAMS  *rp;
     pixDestroy(&pixs1);
     pixDestroy(&pixs2);
 
+        /* Binary seedfill of a serpentine mask from one end; the
+         * hybrid fill must reach the other end, which would take
+         * about 100 iterations of raster and anti-raster sweeps */
+    pixb1 = pixCreate(200, 200, 1);
+    pixSetAll(pixb1);
+    for (i = 1; i < 200; i += 2) {
+        pixRasterop(pixb1, 0, i, 200, 1, PIX_CLR, NULL, 0, 0);
+        pixSetPixel(pixb1, ((i / 2) % 2) ? 0 : 199, i, 1);
+    }
+    pixb2 = pixCreate(200, 200, 1);
+    pixSetPixel(pixb2, 0, 0, 1);
+    pixb3 = pixSeedfillBinary(NULL, pixb2, pixb1, 4);
+    regTestComparePix(rp, pixb1, pixb3);  /* 33 */
+    pixDestroy(&pixb3);
+    pixb3 = pixSeedfillBinary(NULL, pixb2, pixb1, 8);
+    regTestComparePix(rp, pixb1, pixb3);  /* 34 */
+    pixDestroy(&pixb1);
+    pixDestroy(&pixb2);
+    pixDestroy(&pixb3);
+
     pixDestroy(&pixm);
     pixDestroy(&pixmi);
     pixDestroy(&pixmin);
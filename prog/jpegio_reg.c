@@ -56,6 +56,7 @@ void DoJpegTest1(L_REGPARAMS *rp, const char *fname);
 void DoJpegTest2(L_REGPARAMS *rp, const char *fname);
 void DoJpegTest3(L_REGPARAMS *rp, const char *fname);
 void DoJpegTest4(L_REGPARAMS *rp, const char *fname);
+void DoJpegTest5(L_REGPARAMS *rp, const char *fname);
 
 
 int main(int    argc,
@@ -86,6 +87,8 @@ L_REGPARAMS  *rp;
     DoJpegTest3(rp, "lucasta.150.jpg");
     DoJpegTest3(rp, "tetons.jpg");
     DoJpegTest4(rp, "karen8.jpg");
+    DoJpegTest5(rp, "test8.jpg");
+    DoJpegTest5(rp, "fish24.jpg");
 
     return regTestCleanup(rp);
 }
@@ -260,3 +263,42 @@ PIX     *pixs;
 }
 
 
+/* Use this for reading a region of 8 bpp or rgb jpeg */
+void DoJpegTest5(L_REGPARAMS  *rp,
+                 const char   *fname)
+{
+l_int32  i;
+BOX     *box1, *box2;
+PIX     *pixs, *pix1, *pix2, *pix3;
+static const l_int32  boxes[4][4] = {{0, 0, 100, 80}, {130, 94, 218, 152},
+                                     {402, 300, 2000, 2000}, {500, 380, 200, 100}};
+
+        /* Compare with clipping the full image, at full and half res */
+    pixs = pixReadJpeg(fname, 0, 1, NULL, 0);
+    pix1 = pixReadJpeg(fname, 0, 2, NULL, 0);
+    for (i = 0; i < 4; i++) {
+        box1 = boxCreate(boxes[i][0], boxes[i][1], boxes[i][2], boxes[i][3]);
+        pix2 = pixClipRectangle(pixs, box1, NULL);
+        pix3 = pixReadJpegRegion(fname, box1, 1, NULL, 0);
+        regTestComparePix(rp, pix2, pix3);
+        pixDestroy(&pix3);
+        pix3 = pixReadRegion(fname, box1);
+        regTestComparePix(rp, pix2, pix3);
+        pixDestroy(&pix2);
+        pixDestroy(&pix3);
+
+            /* Use even coordinates, so the reduced box is exact */
+        box2 = boxTransform(box1, 0, 0, 0.5, 0.5);
+        pix2 = pixClipRectangle(pix1, box2, NULL);
+        pix3 = pixReadJpegRegion(fname, box1, 2, NULL, 0);
+        regTestComparePix(rp, pix2, pix3);
+        boxDestroy(&box1);
+        boxDestroy(&box2);
+        pixDestroy(&pix2);
+        pixDestroy(&pix3);
+    }
+
+    pixDestroy(&pixs);
+    pixDestroy(&pix1);
+    return;
+}
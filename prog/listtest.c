@@ -38,7 +38,7 @@ int main(int    argc,
          char **argv)
 {
 char        *filein;
-l_int32      i, n, w, h, samecount, count;
+l_int32      i, n, w, h, wn, hn, samecount, count;
 BOX         *box, *boxc;
 BOXA        *boxa, *boxan;
 DLLIST      *head, *tail, *head2, *tail2, *elem, *nextelem;
@@ -140,8 +140,9 @@ static char  mainName[] = "listtest";
             listRemoveElement(&head, elem);
         L_END_LIST
         for (i = 0, samecount = 0; i < n; i++) {
-            if (boxa->box[i]->w == boxan->box[i]->w  &&
-                boxa->box[i]->h == boxan->box[i]->h)
+            boxaGetBoxGeometry(boxa, i, NULL, NULL, &w, &h);
+            boxaGetBoxGeometry(boxan, i, NULL, NULL, &wn, &hn);
+            if (w == wn && h == hn)
                 samecount++;
         }
         fprintf(stderr, " num boxes = %d, same count = %d\n",
@@ -155,8 +156,9 @@ static char  mainName[] = "listtest";
             listRemoveElement(&head, elem);
         L_END_LIST
         for (i = 0, samecount = 0; i < n; i++) {
-            if (boxa->box[i]->w == boxan->box[i]->w  &&
-                boxa->box[i]->h == boxan->box[i]->h)
+            boxaGetBoxGeometry(boxa, i, NULL, NULL, &w, &h);
+            boxaGetBoxGeometry(boxan, i, NULL, NULL, &wn, &hn);
+            if (w == wn && h == hn)
                 samecount++;
         }
         fprintf(stderr, " num boxes = %d, same count = %d\n",
@@ -41,6 +41,11 @@
  *   For the second case, timing shows that the custom allocator does
  *   about as well as (malloc, free), even for thousands of very small pix.
  *   (Turn off logging to get a fair comparison).
+ *
+ *   We also test the scratch arena, where all the temporary pix made in
+ *   a composite operation are released at once, and the recycling pool,
+ *   where the data of destroyed pix is reused for new pix of the same size.
+ *   Finally, we test the accounting of the bytes of image data in use.
  */
 
 #include <math.h>
@@ -55,16 +60,25 @@ static const l_int32 ntimes = 30;
 
 PIXA *GenerateSetOfMargePix(void);
 void CopyStoreClean(PIXA *pixas, l_int32 nlevels, l_int32 ncopies);
+PIX *NormalizePix(PIX *pixs);
 
 
 int main(int    argc,
          char **argv)
 {
-l_int32  i;
-BOXA    *boxa;
-NUMA    *nas, *nab;
-PIX     *pixs;
-PIXA    *pixa, *pixas;
+l_int32       i, same, nhits, nmisses;
+l_int64       current;
+size_t        size, maxused, nheap;
+BOXA         *boxa;
+l_float32    *fdata;
+l_float64    *ddata;
+DPIX         *dpix1, *dpix2;
+FPIX         *fpix, *fpix2;
+L_MEM_STATS   stats;
+NUMA         *nas, *nab;
+PIX          *pixs, *pixt, *pix1, *pix2, *pix3, *pix4;
+PIXA         *pixa, *pixas;
+PIXC         *pixc;
 
     setLeptDebugOK(1);
     lept_mkdir("lept/alloc");
@@ -146,6 +160,144 @@ PIXA    *pixa, *pixas;
     }
     pixDestroy(&pixs);
     fprintf(stderr, "Time (standard) = %7.3f sec\n", stopTimer());
+
+
+    /* --------------- Scratch arena for temporary pix ---------------*/
+    pixs = pixRead("marge.jpg");
+    pix1 = NormalizePix(pixs);  /* using malloc and free */
+    setPixMemoryManager(pixArenaAlloc, pixArenaDealloc);
+    startTimer();
+    for (i = 0; i < ntimes; i++) {
+        pixArenaOpen(0);
+        pixt = NormalizePix(pixs);
+        pix2 = pixArenaClose(&pixt);
+        pixEqual(pix1, pix2, &same);
+        if (!same)
+            fprintf(stderr, "Failure in arena: pix differ\n");
+        pixDestroy(&pix2);
+    }
+    fprintf(stderr, "Time (arena) = %7.3f sec\n", stopTimer());
+    pixArenaGetInfo(&size, NULL, &maxused, &nheap);
+    fprintf(stderr, "Arena: size = %zu, max used = %zu, from heap = %zu\n",
+            size, maxused, nheap);
+
+        /* A pix made before the scope and given new data in it, and a
+         * clone of the kept pix, must still be valid after the scope
+         * is closed and the arena is reused */
+    pix3 = pixCreate(1, 1, 8);
+    pixArenaOpen(0);
+    pixCopy(pix3, pix1);
+    pixt = NormalizePix(pixs);
+    pix4 = pixClone(pixt);
+    pix2 = pixArenaClose(&pixt);
+    pixArenaOpen(0);
+    pixt = pixCreate(1000, 1000, 32);  /* covers all that was used */
+    pixSetAll(pixt);
+    pixArenaClose(NULL);
+    pixDestroy(&pixt);
+    pixEqual(pix1, pix3, &same);
+    if (!same)
+        fprintf(stderr, "Failure in arena: pix resized in scope differs\n");
+    pixEqual(pix1, pix4, &same);
+    if (!same)
+        fprintf(stderr, "Failure in arena: clone of kept pix differs\n");
+    pixDestroy(&pix2);
+    pixDestroy(&pix3);
+    pixDestroy(&pix4);
+
+        /* The arena must not be replaced while a pix made in it,
+         * in an earlier scope, has not been destroyed */
+    pixArenaOpen(0);
+    pixt = pixCreate(100, 100, 8);
+    pixArenaClose(NULL);
+    if (pixArenaOpen(size + 1000) == 0) {
+        fprintf(stderr, "Failure in arena: replaced while in use\n");
+        pixArenaClose(NULL);
+    }
+    pixDestroy(&pixt);
+    if (pixArenaOpen(size + 1000) == 0)
+        pixArenaClose(NULL);
+    else
+        fprintf(stderr, "Failure in arena: not replaced when unused\n");
+    pixArenaDestroy();
+    setPixMemoryManager(malloc, free);
+
+    startTimer();
+    for (i = 0; i < ntimes; i++) {
+        pix2 = NormalizePix(pixs);
+        pixDestroy(&pix2);
+    }
+    fprintf(stderr, "Time (standard) = %7.3f sec\n", stopTimer());
+
+
+    /* ------------- Recycling pool for same-sized pix -------------*/
+    setPixMemoryManager(pixPoolAlloc, pixPoolDealloc);
+    pixPoolCreate(0);
+    startTimer();
+    for (i = 0; i < ntimes; i++) {
+        pix2 = NormalizePix(pixs);
+        pixEqual(pix1, pix2, &same);
+        if (!same)
+            fprintf(stderr, "Failure in pool: pix differ\n");
+        pixDestroy(&pix2);
+    }
+    fprintf(stderr, "Time (pool) = %7.3f sec\n", stopTimer());
+    pixPoolGetStats(&nhits, &nmisses, &size);
+    fprintf(stderr, "Pool: hits = %d, misses = %d, bytes kept = %zu\n",
+            nhits, nmisses, size);
+    if (nhits < (ntimes - 1) * nmisses)
+        fprintf(stderr, "Failure in pool: too few hits\n");
+    pixPoolDestroy();
+    setPixMemoryManager(malloc, free);  /* pixs and pix1 were malloced */
+
+
+    /* ------------- Accounting of image data in use -------------*/
+    pixMemResetStats(L_MEM_THREAD);
+    pixMemGetStats(L_MEM_THREAD, &stats);
+    current = stats.current;
+    pix2 = NormalizePix(pixs);
+    fpix = pixConvertToFPix(pix2, 1);
+    pixc = pixcompCreateFromPix(pix2, IFF_PNG);
+    pixMemGetStats(L_MEM_THREAD, &stats);
+    fprintf(stderr, "Memory: current = %lld, peak = %lld, allocs = %lld\n",
+            (long long)stats.current, (long long)stats.peak,
+            (long long)stats.nalloc);
+    if (stats.typebytes[L_MEM_FPIX] != 4LL * pixGetWidth(pix2) *
+                                       pixGetHeight(pix2) ||
+        stats.typebytes[L_MEM_PIXCOMP] != (l_int64)pixc->size)
+        fprintf(stderr, "Failure in accounting: wrong bytes by type\n");
+    if (stats.peak <= stats.current || stats.nalloc <= stats.nfree)
+        fprintf(stderr, "Failure in accounting: wrong peak or counts\n");
+
+        /* Move the data of one fpix (and dpix) to another with
+         * fpixSetData(); the moved data is no longer counted, and the
+         * count must still balance after both are destroyed */
+    fpix2 = fpixCreateTemplate(fpix);
+    fdata = fpixGetData(fpix);
+    fpixSetData(fpix, fpixGetData(fpix2));
+    fpixSetData(fpix2, NULL);
+    LEPT_FREE(fdata);
+    dpix1 = dpixCreate(100, 100);
+    dpix2 = dpixCreate(100, 100);
+    ddata = dpixGetData(dpix1);
+    dpixSetData(dpix1, dpixGetData(dpix2));
+    dpixSetData(dpix2, NULL);
+    LEPT_FREE(ddata);
+    pixDestroy(&pix2);
+    fpixDestroy(&fpix);
+    fpixDestroy(&fpix2);
+    dpixDestroy(&dpix1);
+    dpixDestroy(&dpix2);
+    pixcompDestroy(&pixc);
+    pixMemGetStats(L_MEM_THREAD, &stats);
+    if (stats.current != current || stats.nalloc != stats.nfree)
+        fprintf(stderr, "Failure in accounting: data not all freed\n");
+    pixDestroy(&pixs);
+    pixDestroy(&pix1);
+    pixMemGetStats(L_MEM_GLOBAL, &stats);
+    if (stats.current != 0)
+        fprintf(stderr, "Failure in accounting: %lld bytes still in use\n",
+                (long long)stats.current);
     return 0;
 }
 
@@ -202,3 +354,17 @@ PIXAA   *paa;
     return;
 }
 
+
+    /* Composite operation with many temporary pix */
+PIX *
+NormalizePix(PIX  *pixs)
+{
+PIX  *pix1, *pix2, *pixd;
+
+    pix1 = pixConvertRGBToLuminance(pixs);
+    pix2 = pixBackgroundNormSimple(pix1, NULL, NULL);
+    pixd = pixContrastNorm(NULL, pix2, 20, 20, 130, 2, 2);
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    return pixd;
+}
@@ -30,7 +30,8 @@
  *    Regression test for compressed pix and compressed pix arrays
  *    in memory.
  *
- *    We also show some other ways to accumulate and display pixa.
+ *    We also show some other ways to accumulate and display pixa,
+ *    and test the cache of decoded pix in a pixacomp.
  */
 
 #include <math.h>
@@ -47,8 +48,8 @@ int main(int    argc,
          char **argv)
 {
 l_uint8      *data1, *data2;
-l_int32       i;
-size_t        size1, size2;
+l_int32       i, j, nhits, nmisses;
+size_t        size1, size2, nbytes;
 BOX          *box;
 PIX          *pix, *pix1, *pix2, *pix3;
 PIXA         *pixa, *pixa1;
@@ -209,6 +210,48 @@ SARRAY       *sa;
     lept_free(data1);
     lept_free(data2);
 
+        /* Test the cache of decoded pix.  All 6 pix fit in the cache,
+         * so the second pass has only hits. */
+    sa = sarrayCreate(0);
+    for (i = 0; i < 6; i++)
+        sarrayAddString(sa, fnames[i], L_COPY);
+    pixac1 = pixacompCreateFromSA(sa, IFF_DEFAULT);
+    pix1 = pixacompGetPix(pixac1, 0);  /* the largest */
+    size1 = 4 * pixGetWpl(pix1) * pixGetHeight(pix1);
+    pixDestroy(&pix1);
+    pixacompSetCache(pixac1, 3 * size1);
+    for (j = 0; j < 2; j++) {
+        for (i = 0; i < 6; i++) {
+            pix1 = pixacompGetPix(pixac1, i);
+            pix2 = pixCreateFromPixcomp(pixacompGetPixcomp(pixac1, i,
+                                                           L_NOCOPY));
+            if (j == 1) regTestComparePix(rp, pix1, pix2);  /* 16 - 21 */
+            pixDestroy(&pix1);
+            pixDestroy(&pix2);
+        }
+    }
+    pixacompGetCacheStats(pixac1, &nhits, &nmisses, &nbytes);
+    regTestCompareValues(rp, 6, nhits, 0);  /* 22 */
+    regTestCompareValues(rp, 6, nmisses, 0);  /* 23 */
+    pixacompSetCache(pixac1, size1);  /* shrink */
+    pixacompGetCacheStats(pixac1, NULL, NULL, &nbytes);
+    regTestCompareValues(rp, 1, nbytes <= size1, 0);  /* 24 */
+    pix1 = pixRead("weasel8.240c.png");
+    pixacompReplacePix(pixac1, 1, pix1, IFF_PNG);
+    pix2 = pixacompGetPix(pixac1, 1);
+    regTestComparePix(rp, pix1, pix2);  /* 25 */
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    pixa1 = pixaCreateFromPixacomp(pixac1, L_COPY);
+    pix1 = pixaDisplayTiledAndScaled(pixa1, 32, 250, 10, 0, 20, 2);
+    pix2 = pixacompDisplayTiledAndScaled(pixac1, 32, 250, 10, 0, 20, 2);
+    regTestComparePix(rp, pix1, pix2);  /* 26 */
+    pixacompDestroy(&pixac1);
+    pixaDestroy(&pixa1);
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    sarrayDestroy(&sa);
+
     return regTestCleanup(rp);
 }
 
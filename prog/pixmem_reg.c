@@ -36,6 +36,8 @@ int main(int    argc,
          char **argv)
 {
 l_uint32     *data;
+size_t        nbytes;
+BOX          *box;
 PIX          *pix1, *pix2, *pix3, *pix4, *pix5;
 PIXA         *pixa;
 L_REGPARAMS  *rp;
@@ -144,5 +146,74 @@ L_REGPARAMS  *rp;
     pixaDestroy(&pixa);
     pixDestroy(&pix1);
 
+        /* Views of a rectangle, with word-aligned left edge */
+    pix1 = pixRead("test8.jpg");
+    box = boxCreate(40, 30, 101, 77);
+    pix2 = pixClipRectangleView(pix1, box, NULL);
+    pix3 = pixClipRectangle(pix1, box, NULL);
+    regTestCompareValues(rp, 1, pixIsView(pix2), 0.0);  /* 13 */
+    regTestComparePix(rp, pix2, pix3);  /* 14 */
+    pix4 = pixCopy(NULL, pix2);
+    regTestCompareValues(rp, 0, pixIsView(pix4), 0.0);  /* 15 */
+    regTestComparePix(rp, pix3, pix4);  /* 16 */
+    pixDestroy(&pix4);
+    pixDestroy(&pix1);  /* the view keeps the data */
+    pix4 = pixScale(pix2, 0.7, 0.7);
+    pix5 = pixScale(pix3, 0.7, 0.7);
+    regTestComparePix(rp, pix4, pix5);  /* 17 */
+    pixDestroy(&pix4);
+    pixDestroy(&pix5);
+    pixSerializeToMemory(pix2, &data, &nbytes);
+    pix4 = pixDeserializeFromMemory(data, nbytes);
+    regTestComparePix(rp, pix3, pix4);  /* 18 */
+    lept_free(data);
+    pixDestroy(&pix4);
+    pixDestroy(&pix2);
+    pixDestroy(&pix3);
+    boxDestroy(&box);
+
+        /* A left edge that is not word-aligned gives a copy */
+    pix1 = pixRead("test8.jpg");
+    box = boxCreate(41, 30, 101, 77);
+    pix2 = pixClipRectangleView(pix1, box, NULL);
+    pix3 = pixClipRectangle(pix1, box, NULL);
+    regTestCompareValues(rp, 0, pixIsView(pix2), 0.0);  /* 19 */
+    regTestComparePix(rp, pix2, pix3);  /* 20 */
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    pixDestroy(&pix3);
+    boxDestroy(&box);
+
+        /* Gray filters on a view, which has the wpl of its parent */
+    pix1 = pixRead("test8.jpg");
+    box = boxCreate(64, 40, 40, 40);
+    pix2 = pixClipRectangleView(pix1, box, NULL);
+    pix3 = pixClipRectangle(pix1, box, NULL);
+    regTestCompareValues(rp, 1, pixIsView(pix2), 0.0);  /* 21 */
+    pix4 = pixBlockconv(pix2, 3, 3);
+    pix5 = pixBlockconv(pix3, 3, 3);
+    regTestComparePix(rp, pix4, pix5);  /* 22 */
+    pixDestroy(&pix4);
+    pixDestroy(&pix5);
+    pix4 = pixErodeGray3(pix2, 3, 3);
+    pix5 = pixErodeGray3(pix3, 3, 3);
+    regTestComparePix(rp, pix4, pix5);  /* 23 */
+    pixDestroy(&pix4);
+    pixDestroy(&pix5);
+    pix4 = pixDilateGray3(pix2, 3, 3);
+    pix5 = pixDilateGray3(pix3, 3, 3);
+    regTestComparePix(rp, pix4, pix5);  /* 24 */
+    pixDestroy(&pix4);
+    pixDestroy(&pix5);
+    pix4 = pixRankRowTransform(pix2);
+    pix5 = pixRankRowTransform(pix3);
+    regTestComparePix(rp, pix4, pix5);  /* 25 */
+    pixDestroy(&pix4);
+    pixDestroy(&pix5);
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    pixDestroy(&pix3);
+    boxDestroy(&box);
+
     return regTestCleanup(rp);
 }
@@ -28,7 +28,8 @@
  * pixserial_reg.c
  *
  *    Tests the fast (uncompressed) serialization of pix to a string
- *    in memory and the deserialization back to a pix.
+ *    in memory and the deserialization back to a pix, and the
+ *    reading of spix files in place from a file mapping.
  */
 
 #include "allheaders.h"
@@ -100,6 +101,23 @@ L_REGPARAMS  *rp;
         pixDestroy(&pixt2);
     }
 
+            /* Test reading spix files in place from a file mapping.
+             * The mapping is private, so writing to the mapped pix
+             * must leave the file unchanged. */
+    for (i = 0; i < nfiles; i++) {
+        pixs = pixRead(filename[i]);
+        snprintf(buf, sizeof(buf), "/tmp/lept/regout/pixm.%d.spix", i);
+        pixWrite(buf, pixs, IFF_SPIX);
+        pixd = pixReadSpixMapped(buf);
+        regTestComparePix(rp, pixs, pixd);  /* 3 * nfiles + i */
+        pixInvert(pixd, pixd);
+        pixt = pixReadSpixMapped(buf);
+        regTestComparePix(rp, pixs, pixt);  /* 4 * nfiles + i */
+        pixDestroy(&pixs);
+        pixDestroy(&pixt);
+        pixDestroy(&pixd);
+    }
+
             /* Test read header.  Note that for rgb input, spp = 3,
              * but for 32 bpp spix, we set spp = 4. */
     data = NULL;
@@ -36,14 +36,21 @@ int main(int    argc,
          char **argv)
 {
 l_uint8      *data;
-l_int32       i, j, w, h, error;
-l_float32     val1, val2;
+l_int32       i, j, w, h, error, same;
+l_float32     val1, val2, var1, var2;
 l_float32     val00, val10, val01, val11, valc00, valc10, valc01, valc11;
 size_t        size;
+BOX          *box;
+DPIX         *dpix;
+NUMA         *na1, *na2;
 PIX          *pixs, *pixg, *pix1, *pix2, *pix3, *pix4, *pix5;
-FPIXA        *fpixam, *fpixav, *fpixarv;
+FPIXA        *fpixam, *fpixav, *fpixarv, *fpixar;
 BOXAA        *baa;
+L_IHISTO     *ih1, *ih2;
 L_REGPARAMS  *rp;
+static const l_int32  boxes[6][4] = {{0, 0, 160, 128}, {37, 21, 101, 77},
+                                     {3, 5, 9, 7}, {90, 50, 500, 500},
+                                     {-10, 60, 40, 15}, {1, 1, 134, 1}};
 
     if (regTestSetup(argc, argv, &rp))
         return 1;
@@ -128,5 +135,81 @@ L_REGPARAMS  *rp;
     regTestCompareValues(rp, 0, error, 0.0);  /* 8 */
     fpixaDestroy(&fpixam);
 
+        /* Test integral histogram statistics against direct computation
+         * on the clipped region, for aligned and unaligned boxes */
+    pixs = pixRead("rabi.png");
+    pixg = pixScaleToGray4(pixs);
+    pixDestroy(&pixs);
+    ih1 = ihistoCreate(pixg, 256, 16);
+    ih2 = ihistoCreate(pixg, 256, 1);
+    error = FALSE;
+    for (i = 0; i < 6; i++) {
+        box = boxCreate(boxes[i][0], boxes[i][1], boxes[i][2], boxes[i][3]);
+        pix1 = pixClipRectangle(pixg, box, NULL);
+        na1 = ihistoGetHisto(ih1, box);
+        na2 = pixGetGrayHistogram(pix1, 1);
+        numaSimilar(na1, na2, 0.0, &same);
+        if (!same) error = TRUE;
+        numaDestroy(&na1);
+        na1 = ihistoGetHisto(ih2, box);
+        numaSimilar(na1, na2, 0.0, &same);
+        if (!same) error = TRUE;
+        numaDestroy(&na1);
+        numaDestroy(&na2);
+        pixDestroy(&pix1);
+        boxDestroy(&box);
+    }
+    regTestCompareValues(rp, 0, error, 0.0);  /* 9 */
+    pix2 = pixBlockconvAccum(pixg);
+    dpix = pixMeanSquareAccum(pixg);
+    error = FALSE;
+    for (i = 0; i < 6; i++) {
+        box = boxCreate(boxes[i][0], boxes[i][1], boxes[i][2], boxes[i][3]);
+        ihistoGetMeanVariance(ih1, box, &val1, &var1, NULL);
+        pixMeanInRectangle(pixg, box, pix2, &val2);
+        pixVarianceInRectangle(pixg, box, pix2, dpix, &var2, NULL);
+        if (L_ABS(val1 - val2) > 0.01 || L_ABS(var1 - var2) > 0.1)
+            error = TRUE;
+        boxDestroy(&box);
+    }
+    regTestCompareValues(rp, 0, error, 0.0);  /* 10 */
+    pixDestroy(&pix2);
+    dpixDestroy(&dpix);
+    error = FALSE;
+    for (i = 0; i < 6; i++) {
+        box = boxCreate(boxes[i][0], boxes[i][1], boxes[i][2], boxes[i][3]);
+        pix1 = pixClipRectangle(pixg, box, NULL);
+        ihistoGetRankValue(ih1, box, 0.3, &val1);
+        pixGetRankValueMasked(pix1, NULL, 0, 0, 1, 0.3, &val2, NULL);
+        if (val1 != val2) error = TRUE;
+        pixDestroy(&pix1);
+        boxDestroy(&box);
+    }
+    regTestCompareValues(rp, 0, error, 0.0);  /* 11 */
+
+        /* Test quadtree rank; the median at each level must lie
+         * between the values of its 4 children */
+    pixQuadtreeRank(pixg, 6, 0.5, ih1, &fpixar);
+    pixGetRankValueMasked(pixg, NULL, 0, 0, 1, 0.5, &val2, NULL);
+    fpixaGetPixel(fpixar, 0, 0, 0, &val1);
+    regTestCompareValues(rp, val2, val1, 0.0);  /* 12 */
+    error = FALSE;
+    fpixaGetFPixDimensions(fpixar, 4, &w, &h);
+    for (i = 0; i < h; i++) {
+        for (j = 0; j < w; j++) {
+            fpixaGetPixel(fpixar, 4, j, i, &val1);
+            quadtreeGetChildren(fpixar, 4, j, i,
+                                &val00, &val10, &val01, &val11);
+            if (val1 < L_MIN(L_MIN(val00, val10), L_MIN(val01, val11)) ||
+                val1 > L_MAX(L_MAX(val00, val10), L_MAX(val01, val11)))
+                error = TRUE;
+        }
+    }
+    regTestCompareValues(rp, 0, error, 0.0);  /* 13 */
+    fpixaDestroy(&fpixar);
+    ihistoDestroy(&ih1);
+    ihistoDestroy(&ih2);
+    pixDestroy(&pixg);
+
     return regTestCleanup(rp);
 }
@@ -0,0 +1,136 @@
+/*====================================================================*
+ -  Copyright (C) 2001 Leptonica.  All rights reserved.
+ -
+ -  Redistribution and use in source and binary forms, with or without
+ -  modification, are permitted provided that the following conditions
+ -  are met:
+ -  1. Redistributions of source code must retain the above copyright
+ -     notice, this list of conditions and the following disclaimer.
+ -  2. Redistributions in binary form must reproduce the above
+ -     copyright notice, this list of conditions and the following
+ -     disclaimer in the documentation and/or other materials
+ -     provided with the distribution.
+ -
+ -  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ -  ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ -  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ -  A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL ANY
+ -  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ -  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ -  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ -  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ -  OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ -  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ -  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *====================================================================*/
+
+/*
+ * rle_reg.c
+ *
+ *     Tests the run-length encoded 1 bpp image, L_Rle.  Each operation
+ *     on the runs is compared with the same operation on the Pix:
+ *         conversion to and from Pix
+ *         boolean ops
+ *         brick dilation and erosion, with both boundary conditions
+ *         pixel count, bounding box and connected components
+ */
+
+#include "allheaders.h"
+
+int main(int    argc,
+         char **argv)
+{
+l_int32       i, n1, n2;
+BOX          *box1, *box2;
+BOXA         *boxa1, *boxa2;
+PIX          *pix0, *pixs, *pixt, *pix1, *pix2;
+L_RLE        *rles, *rlet, *rle1;
+L_REGPARAMS  *rp;
+
+    if (regTestSetup(argc, argv, &rp))
+        return 1;
+
+    pix0 = pixRead("rabi.png");
+    pixs = pixConvertTo1(pix0, 128);
+    pixt = pixDilateBrick(NULL, pixs, 3, 7);
+    pixDestroy(&pix0);
+
+        /* Conversion */
+    rles = pixConvertToRle(pixs);
+    rlet = pixConvertToRle(pixt);
+    pix1 = rleConvertToPix(rles);
+    regTestComparePix(rp, pixs, pix1);  /* 0 */
+    pixDestroy(&pix1);
+
+        /* Boolean ops */
+    rle1 = rleXor(rles, rlet);
+    pix1 = rleConvertToPix(rle1);
+    pix2 = pixXor(NULL, pixs, pixt);
+    regTestComparePix(rp, pix1, pix2);  /* 1 */
+    rleDestroy(&rle1);
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    rle1 = rleSubtract(rlet, rles);
+    pix1 = rleConvertToPix(rle1);
+    pix2 = pixSubtract(NULL, pixt, pixs);
+    regTestComparePix(rp, pix1, pix2);  /* 2 */
+    rleDestroy(&rle1);
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    rle1 = rleRasterop(rles, rlet, PIX_NOT(PIX_SRC) | PIX_DST);
+    pix1 = rleConvertToPix(rle1);
+    pix2 = pixCopy(NULL, pixs);
+    pixRasterop(pix2, 0, 0, pixGetWidth(pixs), pixGetHeight(pixs),
+                PIX_NOT(PIX_SRC) | PIX_DST, pixt, 0, 0);
+    regTestComparePix(rp, pix1, pix2);  /* 3 */
+    rleDestroy(&rle1);
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+
+        /* Brick morphology, with both boundary conditions */
+    for (i = 0; i < 2; i++) {
+        resetMorphBoundaryCondition((i == 0) ? ASYMMETRIC_MORPH_BC :
+                                               SYMMETRIC_MORPH_BC);
+        rle1 = rleDilateBrick(rles, 6, 11);
+        pix1 = rleConvertToPix(rle1);
+        pix2 = pixDilateBrick(NULL, pixs, 6, 11);
+        regTestComparePix(rp, pix1, pix2);  /* 4, 6 */
+        rleDestroy(&rle1);
+        pixDestroy(&pix1);
+        pixDestroy(&pix2);
+        rle1 = rleErodeBrick(rlet, 8, 5);
+        pix1 = rleConvertToPix(rle1);
+        pix2 = pixErodeBrick(NULL, pixt, 8, 5);
+        regTestComparePix(rp, pix1, pix2);  /* 5, 7 */
+        rleDestroy(&rle1);
+        pixDestroy(&pix1);
+        pixDestroy(&pix2);
+    }
+    resetMorphBoundaryCondition(ASYMMETRIC_MORPH_BC);
+
+        /* Measurements */
+    rleCountPixels(rles, &n1);
+    pixCountPixels(pixs, &n2, NULL);
+    regTestCompareValues(rp, n2, n1, 0);  /* 8 */
+    rleFindBoundingBox(rlet, &box1);
+    pixClipToForeground(pixt, NULL, &box2);
+    boxEqual(box1, box2, &n1);
+    regTestCompareValues(rp, 1, n1, 0);  /* 9 */
+    boxa1 = rleConnCompBB(rles, 8);
+    boxa2 = pixConnCompBB(pixs, 8);
+    boxaEqual(boxa1, boxa2, 0, NULL, &n1);
+    regTestCompareValues(rp, 1, n1, 0);  /* 10 */
+    rleCountConnComp(rlet, 4, &n1);
+    pixCountConnComp(pixt, 4, &n2);
+    regTestCompareValues(rp, n2, n1, 0);  /* 11 */
+    boxDestroy(&box1);
+    boxDestroy(&box2);
+    boxaDestroy(&boxa1);
+    boxaDestroy(&boxa2);
+
+    rleDestroy(&rles);
+    rleDestroy(&rlet);
+    pixDestroy(&pixs);
+    pixDestroy(&pixt);
+    return regTestCleanup(rp);
+}
@@ -28,7 +28,8 @@
  * scale_reg.c
  *
  *      This tests a number of scaling operations, through the pixScale()
- *      interface.
+ *      interface.  It also tests the variants that write into an
+ *      existing pix.
  */
 
 #include "allheaders.h"
@@ -57,8 +58,9 @@ static void PixaSaveDisplay(PIXA *pixa, L_REGPARAMS *rp);
 int main(int    argc,
          char **argv)
 {
-l_int32       i;
-PIX          *pixs, *pixc;
+l_int32       i, j;
+l_float32     vc[6] = {0.95f, -0.05f, 12.0f, 0.04f, 0.98f, -8.0f};
+PIX          *pixs, *pixc, *pixd, *pix1, *pix2;
 PIXA         *pixa;
 L_REGPARAMS  *rp;
 
@@ -242,8 +244,94 @@ L_REGPARAMS  *rp;
     regTestWritePixAndCheck(rp, pixc, IFF_JFIF_JPEG);  /* 48 */
     PixSave32(pixa, pixc);
     PixaSaveDisplay(pixa, rp);  /* 49 */
+
+        /* Test writing into an existing pix.  The same pixd is reused
+         * for results of different sizes and depths. */
+    fprintf(stderr, "\n-------------- Testing reuse of pixd ------------\n");
+    pixd = NULL;
+    pix1 = pixScaleColorLI(pixs, 0.8, 0.8);
+    pixd = pixScaleColorLIInto(pixd, pixs, 0.8, 0.8);
+    regTestComparePix(rp, pix1, pixd);  /* 50 */
+    pixDestroy(&pix1);
+    pix1 = pixScaleColorLI(pixs, 2.0, 2.0);
+    pixd = pixScaleColorLIInto(pixd, pixs, 2.0, 2.0);
+    regTestComparePix(rp, pix1, pixd);  /* 51 */
+    pixDestroy(&pix1);
+    pix1 = pixConvertRGBToGray(pixs, 0.0, 0.0, 0.0);
+    pixd = pixConvertRGBToGrayInto(pixd, pixs, 0.0, 0.0, 0.0);
+    regTestComparePix(rp, pix1, pixd);  /* 52 */
+    pix2 = pixClone(pix1);  /* keep the 8 bpp image */
+    pixDestroy(&pix1);
+    pix1 = pixScaleGrayLI(pix2, 0.75, 0.75);
+    pixd = pixScaleGrayLIInto(pixd, pix2, 0.75, 0.75);
+    regTestComparePix(rp, pix1, pixd);  /* 53 */
+    pixDestroy(&pix1);
+    pix1 = pixScaleBySampling(pix2, 0.37, 0.37);
+    pixd = pixScaleBySamplingInto(pixd, pix2, 0.37, 0.37);
+    regTestComparePix(rp, pix1, pixd);  /* 54 */
+    pixDestroy(&pix1);
+    pix1 = pixRotateAMGray(pix2, 0.12, 255);
+    pixd = pixRotateAMGrayInto(pixd, pix2, 0.12, 255);
+    regTestComparePix(rp, pix1, pixd);  /* 55 */
+    pixDestroy(&pix1);
+    pix1 = pixRotateAMColor(pixs, -0.12, 0xffffff00);
+    pixd = pixRotateAMColorInto(pixd, pixs, -0.12, 0xffffff00);
+    regTestComparePix(rp, pix1, pixd);  /* 56 */
+    pixDestroy(&pix1);
+    pix1 = pixAffineGray(pix2, vc, 0);
+    pixd = pixAffineGrayInto(pixd, pix2, vc, 0);
+    regTestComparePix(rp, pix1, pixd);  /* 57 */
+    pixDestroy(&pix1);
+    pix1 = pixAffineColor(pixs, vc, 0);
+    pixd = pixAffineColorInto(pixd, pixs, vc, 0);
+    regTestComparePix(rp, pix1, pixd);  /* 58 */
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    pixDestroy(&pixs);
+
+    pixs = pixRead("rabi.png");
+    pix1 = pixScaleToGray4(pixs);
+    pixd = pixScaleToGrayInto(pixd, pixs, 4);
+    regTestComparePix(rp, pix1, pixd);  /* 59 */
+    pixDestroy(&pix1);
+    pix1 = pixScaleToGray3(pixs);
+    pixd = pixScaleToGrayInto(pixd, pixs, 3);
+    regTestComparePix(rp, pix1, pixd);  /* 60 */
+    pixDestroy(&pix1);
+    pix1 = pixScaleBySampling(pixs, 0.5, 0.5);
+    pixd = pixScaleBySamplingInto(pixd, pixs, 0.5, 0.5);
+    regTestComparePix(rp, pix1, pixd);  /* 61 */
+    pixDestroy(&pix1);
+    pix1 = pixAffineSampled(pixs, vc, L_BRING_IN_WHITE);
+    pixd = pixAffineSampledInto(pixd, pixs, vc, L_BRING_IN_WHITE);
+    regTestComparePix(rp, pix1, pixd);  /* 62 */
+    pixDestroy(&pix1);
+    pix1 = pixConvertTo8(pixs, 0);
+    pixd = pixConvertTo8Into(pixd, pixs, 0);
+    regTestComparePix(rp, pix1, pixd);  /* 63 */
+    pixDestroy(&pix1);
     pixDestroy(&pixs);
 
+        /* Conversion to 8 bpp from 2, 4 and 8 bpp, with and without
+         * a colormap, and from 16 bpp */
+    for (i = 1; i < 8; i++) {
+        if (i < 7) {
+            pixs = pixRead(image[i]);
+        } else {
+            pix2 = pixRead(image[5]);
+            pixs = pixConvert8To16(pix2, 8);
+            pixDestroy(&pix2);
+        }
+        for (j = 0; j < 2; j++) {
+            pix1 = pixConvertTo8(pixs, j);
+            pixd = pixConvertTo8Into(pixd, pixs, j);
+            regTestComparePix(rp, pix1, pixd);  /* 64 - 77 */
+            pixDestroy(&pix1);
+        }
+        pixDestroy(&pixs);
+    }
+    pixDestroy(&pixd);
+
     return regTestCleanup(rp);
 }
 
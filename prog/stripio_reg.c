@@ -0,0 +1,257 @@
+/*====================================================================*
+ -  Copyright (C) 2001 Leptonica.  All rights reserved.
+ -
+ -  Redistribution and use in source and binary forms, with or without
+ -  modification, are permitted provided that the following conditions
+ -  are met:
+ -  1. Redistributions of source code must retain the above copyright
+ -     notice, this list of conditions and the following disclaimer.
+ -  2. Redistributions in binary form must reproduce the above
+ -     copyright notice, this list of conditions and the following
+ -     disclaimer in the documentation and/or other materials
+ -     provided with the distribution.
+ -
+ -  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ -  ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ -  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ -  A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL ANY
+ -  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ -  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ -  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ -  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ -  OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ -  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ -  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *====================================================================*/
+
+/*
+ * stripio_reg.c
+ *
+ *     Tests strip-streaming decode, process and encode.  Each result
+ *     is compared with the same operation on the entire image:
+ *         strip reading of png and jpeg, compared with pixRead()
+ *         strip writing of png and jpeg, compared with pixWrite()
+ *         strip pipelines, compared with stripPipeApply()
+ *         region reading of png, compared with pixClipRectangle()
+ *         strip reading and writing of tiff, if libtiff is present
+ *         region reading of multistrip tiff, if libtiff is present
+ */
+
+    /* Needed for HAVE_LIBTIFF */
+#ifdef HAVE_CONFIG_H
+#include <config_auto.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "allheaders.h"
+
+static PIX *ReadByStrips(const char *filename, l_int32 nrows);
+static l_int32 WriteByStrips(PIX *pixs, const char *filename,
+                             l_int32 format, l_int32 nrows);
+
+
+int main(int    argc,
+         char **argv)
+{
+l_int32          i, same;
+BOX             *box;
+PIX             *pix0, *pix1, *pix2;
+L_STRIP_PIPE    *pipe;
+NUMA            *na;
+L_REGPARAMS     *rp;
+static const char *fnames[] = {"rabi.png", "weasel8.png",
+                               "books_logo.png", "karen8.jpg",
+                               "marge.jpg"};
+
+    if (regTestSetup(argc, argv, &rp))
+        return 1;
+
+    lept_mkdir("lept/strip");
+
+        /* Strip reading; the strip height need not divide the image */
+    for (i = 0; i < 5; i++) {
+        pix0 = pixRead(fnames[i]);
+        pix1 = ReadByStrips(fnames[i], 37);
+        regTestComparePix(rp, pix0, pix1);  /* 0, 2, 4, 6, 8 */
+        regTestCompareValues(rp, pixGetSpp(pix0), pixGetSpp(pix1), 0.0);
+        pixDestroy(&pix0);
+        pixDestroy(&pix1);
+    }
+
+        /* Colormapped png is returned as rgb */
+    pix0 = pixRead("dreyfus8.png");
+    pix1 = pixRemoveColormap(pix0, REMOVE_CMAP_TO_FULL_COLOR);
+    pix2 = ReadByStrips("dreyfus8.png", 16);
+    regTestComparePix(rp, pix1, pix2);  /* 10 */
+    pixDestroy(&pix0);
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+
+        /* Strip writing of png at 1, 8 and 32 bpp with alpha */
+    for (i = 0; i < 3; i++) {
+        pix0 = pixRead(fnames[i]);
+        WriteByStrips(pix0, "/tmp/lept/strip/write.png", IFF_PNG, 50);
+        pix1 = pixRead("/tmp/lept/strip/write.png");
+        pixEqualWithAlpha(pix0, pix1, 1, &same);
+        regTestCompareValues(rp, 1, same, 0.0);  /* 11, 12, 13 */
+        pixDestroy(&pix0);
+        pixDestroy(&pix1);
+    }
+
+        /* Strip writing of jpeg gives the same image as pixWrite() */
+    for (i = 3; i < 5; i++) {
+        pix0 = pixRead(fnames[i]);
+        WriteByStrips(pix0, "/tmp/lept/strip/write1.jpg", IFF_JFIF_JPEG, 40);
+        pixWrite("/tmp/lept/strip/write2.jpg", pix0, IFF_JFIF_JPEG);
+        pix1 = pixRead("/tmp/lept/strip/write1.jpg");
+        pix2 = pixRead("/tmp/lept/strip/write2.jpg");
+        regTestComparePix(rp, pix1, pix2);  /* 14, 15 */
+        pixDestroy(&pix0);
+        pixDestroy(&pix1);
+        pixDestroy(&pix2);
+    }
+
+        /* Pipeline with a halo: TRC, gray, blockconv and threshold */
+    pipe = stripPipeCreate();
+    na = numaGammaTRC(0.7, 30, 220);
+    stripPipeAddTRC(pipe, na);
+    stripPipeAddConvertToGray(pipe, 0.0, 0.0, 0.0);
+    stripPipeAddBlockconv(pipe, 3, 4);
+    stripPipeAddThreshold(pipe, 128);
+    pix0 = pixRead("marge.jpg");
+    pix1 = stripPipeApply(pipe, pix0);
+    stripPipeProcess(pipe, "marge.jpg", "/tmp/lept/strip/pipe1.png",
+                     IFF_PNG, 20, 0);
+    pix2 = pixRead("/tmp/lept/strip/pipe1.png");
+    regTestComparePix(rp, pix1, pix2);  /* 16 */
+    regTestCompareValues(rp, 1, pixGetDepth(pix2), 0.0);  /* 17 */
+    numaDestroy(&na);
+    stripPipeDestroy(&pipe);
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+
+        /* Pipeline on rgb, with large kernel and thin strips */
+    pipe = stripPipeCreate();
+    stripPipeAddBlockconv(pipe, 5, 11);
+    pix1 = stripPipeApply(pipe, pix0);
+    stripPipeProcess(pipe, "marge.jpg", "/tmp/lept/strip/pipe2.png",
+                     IFF_PNG, 1, 0);
+    pix2 = pixRead("/tmp/lept/strip/pipe2.png");
+    regTestComparePix(rp, pix1, pix2);  /* 18 */
+    stripPipeDestroy(&pipe);
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+
+        /* Transcoding without a pipe */
+    stripPipeProcess(NULL, "marge.jpg", "/tmp/lept/strip/pipe3.png",
+                     IFF_PNG, 64, 0);
+    pix1 = pixRead("/tmp/lept/strip/pipe3.png");
+    regTestComparePix(rp, pix0, pix1);  /* 19 */
+    pixDestroy(&pix0);
+    pixDestroy(&pix1);
+
+        /* Region reading of png falls back to reading and clipping */
+    pix0 = pixRead("books_logo.png");
+    box = boxCreate(50, 20, 120, 500);
+    pix1 = pixClipRectangle(pix0, box, NULL);
+    pixCopySpp(pix1, pix0);
+    pix2 = pixReadRegion("books_logo.png", box);
+    pixEqualWithAlpha(pix1, pix2, 1, &same);
+    regTestCompareValues(rp, 1, same, 0.0);  /* 20 */
+    boxDestroy(&box);
+    pixDestroy(&pix0);
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+
+#if HAVE_LIBTIFF
+        /* Strip writing and reading of tiff */
+    pix0 = pixRead("rabi.png");
+    WriteByStrips(pix0, "/tmp/lept/strip/write.tif", IFF_TIFF_G4, 100);
+    pix1 = ReadByStrips("/tmp/lept/strip/write.tif", 77);
+    regTestComparePix(rp, pix0, pix1);  /* 21 */
+    pixDestroy(&pix0);
+    pixDestroy(&pix1);
+    pix0 = pixRead("marge.jpg");
+    WriteByStrips(pix0, "/tmp/lept/strip/write.tif", IFF_TIFF_ZIP, 30);
+    pix1 = ReadByStrips("/tmp/lept/strip/write.tif", 45);
+    pix2 = pixRead("/tmp/lept/strip/write.tif");
+    regTestComparePix(rp, pix0, pix1);  /* 22 */
+    regTestComparePix(rp, pix0, pix2);  /* 23 */
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+
+        /* Region reading of tiff; only the strips in the box are read */
+    for (i = 0; i < 2; i++) {
+        box = (i == 0) ? boxCreate(37, 41, 150, 77) :
+                         boxCreate(200, 250, 1000, 1000);
+        pix1 = pixClipRectangle(pix0, box, NULL);
+        pix2 = pixReadTiffRegion("/tmp/lept/strip/write.tif", 0, box);
+        regTestComparePix(rp, pix1, pix2);  /* 24, 26 */
+        pixDestroy(&pix2);
+        pix2 = pixReadRegion("/tmp/lept/strip/write.tif", box);
+        regTestComparePix(rp, pix1, pix2);  /* 25, 27 */
+        boxDestroy(&box);
+        pixDestroy(&pix1);
+        pixDestroy(&pix2);
+    }
+    pixDestroy(&pix0);
+#endif  /* HAVE_LIBTIFF */
+
+    return regTestCleanup(rp);
+}
+
+
+    /* Reads the image a strip at a time, and reassembles it */
+static PIX *
+ReadByStrips(const char  *filename,
+             l_int32      nrows)
+{
+l_int32          w, h, d, y, sh;
+L_STRIP_READER  *sr;
+PIX             *pixd, *pix1;
+
+    if ((sr = stripReaderCreate(filename)) == NULL)
+        return NULL;
+    stripReaderGetDimensions(sr, &w, &h, &d);
+    pixd = pixCreate(w, h, d);
+    pixSetSpp(pixd, sr->spp);
+    for (y = 0; (pix1 = stripReaderRead(sr, nrows)) != NULL; y += sh) {
+        sh = pixGetHeight(pix1);
+        pixRasterop(pixd, 0, y, w, sh, PIX_SRC, pix1, 0, 0);
+        pixDestroy(&pix1);
+    }
+    if (y != h)
+        pixDestroy(&pixd);
+    stripReaderDestroy(&sr);
+    return pixd;
+}
+
+
+    /* Cuts the image into strips and writes them in order */
+static l_int32
+WriteByStrips(PIX         *pixs,
+              const char  *filename,
+              l_int32      format,
+              l_int32      nrows)
+{
+l_int32          w, h, y, ret;
+BOX             *box;
+L_STRIP_WRITER  *sw;
+PIX             *pix1;
+
+    pixGetDimensions(pixs, &w, &h, NULL);
+    if ((sw = stripWriterCreate(filename, format, h, 0)) == NULL)
+        return 1;
+    ret = 0;
+    for (y = 0; y < h && !ret; y += nrows) {
+        box = boxCreate(0, y, w, nrows);
+        pix1 = pixClipRectangle(pixs, box, NULL);
+        pixCopySpp(pix1, pixs);
+        ret = stripWriterWrite(sw, pix1);
+        boxDestroy(&box);
+        pixDestroy(&pix1);
+    }
+    if (!ret)
+        ret = stripWriterFinish(sw);
+    stripWriterDestroy(&sw);
+    return ret;
+}
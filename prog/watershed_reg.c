@@ -60,8 +60,8 @@ L_REGPARAMS  *rp;
             pixSetPixel(pix2, j, i, (l_int32)f);
         }
     }
-    DoWatershed(rp, pix1);  /* 0 - 11 */
-    DoWatershed(rp, pix2);  /* 12 - 23 */
+    DoWatershed(rp, pix1);  /* 0 - 12 */
+    DoWatershed(rp, pix2);  /* 13 - 25 */
     pixDestroy(&pix1);
     pixDestroy(&pix2);
     return regTestCleanup(rp);
@@ -78,6 +78,7 @@ l_int32    w, h, empty;
 l_uint32   redval, greenval;
 L_WSHED   *wshed;
 PIX       *pixc, *pix1, *pix2, *pix3, *pix4, *pix5, *pix6, *pix7, *pix8, *pix9;
+PIX       *pix10, *pix11;
 PIXA      *pixa;
 PTA       *pta;
 
@@ -131,12 +132,22 @@ PTA       *pta;
     pix8 = wshedRenderColors(wshed);
     regTestWritePixAndCheck(rp, pix8, IFF_PNG);  /* 10 */
     pixSaveTiled(pix8, pixa, 1.0, 0, 10, 32);
+    pix10 = wshedLabels(wshed);
     wshedDestroy(&wshed);
 
     pix9 = pixaDisplay(pixa, 0, 0);
     regTestWritePixAndCheck(rp, pix9, IFF_PNG);  /* 11 */
     pixDisplayWithTitle(pix9, 100, 100, NULL, rp->display);
 
+        /* Make only the label image; it must be the same as the
+         * label image rendered from the pixa of basins */
+    wshed = wshedCreate(pixs, pix3, 10, 0);
+    wshedSetLabelsOnly(wshed, 1);
+    wshedApply(wshed);
+    pix11 = wshedLabels(wshed);
+    regTestComparePix(rp, pix10, pix11);  /* 12 */
+    wshedDestroy(&wshed);
+
     lept_free(data);
     pixDestroy(&pix1);
     pixDestroy(&pix2);
@@ -147,6 +158,8 @@ PTA       *pta;
     pixDestroy(&pix7);
     pixDestroy(&pix8);
     pixDestroy(&pix9);
+    pixDestroy(&pix10);
+    pixDestroy(&pix11);
     pixDestroy(&pixc);
     pixaDestroy(&pixa);
     ptaDestroy(&pta);
@@ -2747,7 +2747,7 @@ pixSetLowContrast(PIX     *pixs1,
                   PIX     *pixs2,
                   l_int32  mindiff)
 {
-l_int32    i, j, w, h, d, wpl, val1, val2, found;
+l_int32    i, j, w, h, d, wpl1, wpl2, val1, val2, found;
 l_uint32  *data1, *data2, *line1, *line2;
 
     PROCNAME("pixSetLowContrast");
@@ -2763,11 +2763,12 @@ l_uint32  *data1, *data2, *line1, *line2;
 
     data1 = pixGetData(pixs1);
     data2 = pixGetData(pixs2);
-    wpl = pixGetWpl(pixs1);
+    wpl1 = pixGetWpl(pixs1);
+    wpl2 = pixGetWpl(pixs2);
     found = 0;  /* init to not finding any diffs >= mindiff */
     for (i = 0; i < h; i++) {
-        line1 = data1 + i * wpl;
-        line2 = data2 + i * wpl;
+        line1 = data1 + i * wpl1;
+        line2 = data2 + i * wpl2;
         for (j = 0; j < w; j++) {
             val1 = GET_DATA_BYTE(line1, j);
             val2 = GET_DATA_BYTE(line2, j);
@@ -2786,8 +2787,8 @@ l_uint32  *data1, *data2, *line1, *line2;
     }
 
     for (i = 0; i < h; i++) {
-        line1 = data1 + i * wpl;
-        line2 = data2 + i * wpl;
+        line1 = data1 + i * wpl1;
+        line2 = data2 + i * wpl2;
         for (j = 0; j < w; j++) {
             val1 = GET_DATA_BYTE(line1, j);
             val2 = GET_DATA_BYTE(line2, j);
@@ -2833,7 +2834,7 @@ pixLinearTRCTiled(PIX       *pixd,
                   PIX       *pixmin,
                   PIX       *pixmax)
 {
-l_int32    i, j, k, m, w, h, wt, ht, wpl, wplt, xoff, yoff;
+l_int32    i, j, k, m, w, h, wt, ht, wpl, wplmin, wplmax, xoff, yoff;
 l_int32    minval, maxval, val, sval;
 l_int32   *ia;
 l_int32  **iaa;
@@ -2864,12 +2865,13 @@ l_uint32  *data, *datamin, *datamax, *line, *tline, *linemin, *linemax;
     wpl = pixGetWpl(pixd);
     datamin = pixGetData(pixmin);
     datamax = pixGetData(pixmax);
-    wplt = pixGetWpl(pixmin);
+    wplmin = pixGetWpl(pixmin);
+    wplmax = pixGetWpl(pixmax);
     pixGetDimensions(pixmin, &wt, &ht, NULL);
     for (i = 0; i < ht; i++) {
         line = data + sy * i * wpl;
-        linemin = datamin + i * wplt;
-        linemax = datamax + i * wplt;
+        linemin = datamin + i * wplmin;
+        linemax = datamax + i * wplmax;
         yoff = sy * i;
         for (j = 0; j < wt; j++) {
             xoff = sx * j;
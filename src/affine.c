@@ -33,6 +33,7 @@
  *      (to nearest integer) transform on each dest point
  *           PIX        *pixAffineSampledPta()
  *           PIX        *pixAffineSampled()
+ *           PIX        *pixAffineSampledInto()
  *
  *      Affine (3 pt) image transformation using interpolation
  *      (or area mapping) for anti-aliasing images that are
@@ -41,8 +42,10 @@
  *           PIX        *pixAffine()
  *           PIX        *pixAffinePtaColor()
  *           PIX        *pixAffineColor()
+ *           PIX        *pixAffineColorInto()
  *           PIX        *pixAffinePtaGray()
  *           PIX        *pixAffineGray()
+ *           PIX        *pixAffineGrayInto()
  *
  *      Affine transform including alpha (blend) component
  *           PIX        *pixAffinePtaWithAlpha()
@@ -331,11 +334,7 @@ pixAffineSampled(PIX        *pixs,
                  l_float32  *vc,
                  l_int32     incolor)
 {
-l_int32     i, j, w, h, d, x, y, wpls, wpld, color, cmapindex;
-l_uint32    val;
-l_uint32   *datas, *datad, *lines, *lined;
-PIX        *pixd;
-PIXCMAP    *cmap;
+l_int32  d;
 
     PROCNAME("pixAffineSampled");
 
@@ -345,12 +344,67 @@ PIXCMAP    *cmap;
         return (PIX *)ERROR_PTR("vc not defined", procName, NULL);
     if (incolor != L_BRING_IN_WHITE && incolor != L_BRING_IN_BLACK)
         return (PIX *)ERROR_PTR("invalid incolor", procName, NULL);
-    pixGetDimensions(pixs, &w, &h, &d);
+    d = pixGetDepth(pixs);
     if (d != 1 && d != 2 && d != 4 && d != 8 && d != 32)
         return (PIX *)ERROR_PTR("depth not 1, 2, 4, 8 or 16", procName, NULL);
 
+    return pixAffineSampledInto(NULL, pixs, vc, incolor);
+}
+
+
+/*!
+ * \brief   pixAffineSampledInto()
+ *
+ * \param[in]    pixd      [optional] pix to be reused; can be null
+ * \param[in]    pixs      all depths
+ * \param[in]    vc        vector of 6 coefficients for affine transformation
+ * \param[in]    incolor   L_BRING_IN_WHITE, L_BRING_IN_BLACK
+ * \return  pixd, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This is pixAffineSampled(), written into pixd.  If pixd is
+ *          null, a new pix is made.  Otherwise pixd is resized as
+ *          required, and its image data is reused when the size of
+ *          the result does not change.  See pixReuseOrCreate().
+ *      (2) pixd cannot be the same as pixs.
+ * </pre>
+ */
+PIX *
+pixAffineSampledInto(PIX        *pixd,
+                     PIX        *pixs,
+                     l_float32  *vc,
+                     l_int32     incolor)
+{
+l_int32     i, j, w, h, d, x, y, wpls, wpld, color, cmapindex;
+l_uint32    val;
+l_uint32   *datas, *datad, *lines, *lined;
+PIX        *pixt;
+PIXCMAP    *cmap;
+
+    PROCNAME("pixAffineSampledInto");
+
+    if (!pixs)
+        return (PIX *)ERROR_PTR("pixs not defined", procName, pixd);
+    if (pixd == pixs)
+        return (PIX *)ERROR_PTR("pixd == pixs", procName, pixd);
+    if (!vc)
+        return (PIX *)ERROR_PTR("vc not defined", procName, pixd);
+    if (incolor != L_BRING_IN_WHITE && incolor != L_BRING_IN_BLACK)
+        return (PIX *)ERROR_PTR("invalid incolor", procName, pixd);
+    pixGetDimensions(pixs, &w, &h, &d);
+    if (d != 1 && d != 2 && d != 4 && d != 8 && d != 32)
+        return (PIX *)ERROR_PTR("depth not 1, 2, 4, 8 or 16", procName, pixd);
+
         /* Init all dest pixels to color to be brought in from outside */
-    pixd = pixCreateTemplate(pixs);
+    if ((pixt = pixReuseOrCreate(pixd, w, h, d)) == NULL)
+        return (PIX *)ERROR_PTR("pixd not made", procName, pixd);
+    pixd = pixt;
+    pixCopySpp(pixd, pixs);
+    pixCopyResolution(pixd, pixs);
+    pixCopyColormap(pixd, pixs);
+    pixCopyText(pixd, pixs);
+    pixCopyInputFormat(pixd, pixs);
     if ((cmap = pixGetColormap(pixs)) != NULL) {
         if (incolor == L_BRING_IN_WHITE)
             color = 1;
@@ -590,26 +644,71 @@ PIX *
 pixAffineColor(PIX        *pixs,
                l_float32  *vc,
                l_uint32    colorval)
+{
+    PROCNAME("pixAffineColor");
+
+    if (!pixs)
+        return (PIX *)ERROR_PTR("pixs not defined", procName, NULL);
+    if (pixGetDepth(pixs) != 32)
+        return (PIX *)ERROR_PTR("pixs must be 32 bpp", procName, NULL);
+    if (!vc)
+        return (PIX *)ERROR_PTR("vc not defined", procName, NULL);
+
+    return pixAffineColorInto(NULL, pixs, vc, colorval);
+}
+
+
+/*!
+ * \brief   pixAffineColorInto()
+ *
+ * \param[in]    pixd       [optional] pix to be reused; can be null
+ * \param[in]    pixs       32 bpp
+ * \param[in]    vc         vector of 6 coefficients for affine transformation
+ * \param[in]    colorval   e.g.: 0 to bring in BLACK, 0xffffff00 for WHITE
+ * \return  pixd, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This is pixAffineColor(), written into pixd.  See the notes
+ *          in pixAffineSampledInto().
+ *      (2) With an alpha channel, the transformation of the alpha
+ *          component makes temporary pix.
+ * </pre>
+ */
+PIX *
+pixAffineColorInto(PIX        *pixd,
+                   PIX        *pixs,
+                   l_float32  *vc,
+                   l_uint32    colorval)
 {
 l_int32    i, j, w, h, d, wpls, wpld;
 l_uint32   val;
 l_uint32  *datas, *datad, *lined;
 l_float32  x, y;
-PIX       *pix1, *pix2, *pixd;
+PIX       *pix1, *pix2, *pixt;
 
-    PROCNAME("pixAffineColor");
+    PROCNAME("pixAffineColorInto");
 
     if (!pixs)
-        return (PIX *)ERROR_PTR("pixs not defined", procName, NULL);
+        return (PIX *)ERROR_PTR("pixs not defined", procName, pixd);
     pixGetDimensions(pixs, &w, &h, &d);
     if (d != 32)
-        return (PIX *)ERROR_PTR("pixs must be 32 bpp", procName, NULL);
+        return (PIX *)ERROR_PTR("pixs must be 32 bpp", procName, pixd);
+    if (pixd == pixs)
+        return (PIX *)ERROR_PTR("pixd == pixs", procName, pixd);
     if (!vc)
-        return (PIX *)ERROR_PTR("vc not defined", procName, NULL);
+        return (PIX *)ERROR_PTR("vc not defined", procName, pixd);
 
     datas = pixGetData(pixs);
     wpls = pixGetWpl(pixs);
-    pixd = pixCreateTemplate(pixs);
+    if ((pixt = pixReuseOrCreate(pixd, w, h, 32)) == NULL)
+        return (PIX *)ERROR_PTR("pixd not made", procName, pixd);
+    pixd = pixt;
+    pixCopySpp(pixd, pixs);
+    pixCopyResolution(pixd, pixs);
+    pixCopyColormap(pixd, pixs);
+    pixCopyText(pixd, pixs);
+    pixCopyInputFormat(pixd, pixs);
     pixSetAllArbitrary(pixd, colorval);
     datad = pixGetData(pixd);
     wpld = pixGetWpl(pixd);
@@ -694,25 +793,68 @@ PIX *
 pixAffineGray(PIX        *pixs,
               l_float32  *vc,
               l_uint8     grayval)
+{
+    PROCNAME("pixAffineGray");
+
+    if (!pixs)
+        return (PIX *)ERROR_PTR("pixs not defined", procName, NULL);
+    if (pixGetDepth(pixs) != 8)
+        return (PIX *)ERROR_PTR("pixs must be 8 bpp", procName, NULL);
+    if (!vc)
+        return (PIX *)ERROR_PTR("vc not defined", procName, NULL);
+
+    return pixAffineGrayInto(NULL, pixs, vc, grayval);
+}
+
+
+/*!
+ * \brief   pixAffineGrayInto()
+ *
+ * \param[in]    pixd      [optional] pix to be reused; can be null
+ * \param[in]    pixs      8 bpp
+ * \param[in]    vc        vector of 6 coefficients for affine transformation
+ * \param[in]    grayval   e.g.: 0 to bring in BLACK, 255 for WHITE
+ * \return  pixd, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This is pixAffineGray(), written into pixd.  See the notes
+ *          in pixAffineSampledInto().
+ * </pre>
+ */
+PIX *
+pixAffineGrayInto(PIX        *pixd,
+                  PIX        *pixs,
+                  l_float32  *vc,
+                  l_uint8     grayval)
 {
 l_int32    i, j, w, h, wpls, wpld, val;
 l_uint32  *datas, *datad, *lined;
 l_float32  x, y;
-PIX       *pixd;
+PIX       *pixt;
 
-    PROCNAME("pixAffineGray");
+    PROCNAME("pixAffineGrayInto");
 
     if (!pixs)
-        return (PIX *)ERROR_PTR("pixs not defined", procName, NULL);
+        return (PIX *)ERROR_PTR("pixs not defined", procName, pixd);
     pixGetDimensions(pixs, &w, &h, NULL);
     if (pixGetDepth(pixs) != 8)
-        return (PIX *)ERROR_PTR("pixs must be 8 bpp", procName, NULL);
+        return (PIX *)ERROR_PTR("pixs must be 8 bpp", procName, pixd);
+    if (pixd == pixs)
+        return (PIX *)ERROR_PTR("pixd == pixs", procName, pixd);
     if (!vc)
-        return (PIX *)ERROR_PTR("vc not defined", procName, NULL);
+        return (PIX *)ERROR_PTR("vc not defined", procName, pixd);
 
     datas = pixGetData(pixs);
     wpls = pixGetWpl(pixs);
-    pixd = pixCreateTemplate(pixs);
+    if ((pixt = pixReuseOrCreate(pixd, w, h, 8)) == NULL)
+        return (PIX *)ERROR_PTR("pixd not made", procName, pixd);
+    pixd = pixt;
+    pixCopySpp(pixd, pixs);
+    pixCopyResolution(pixd, pixs);
+    pixCopyColormap(pixd, pixs);
+    pixCopyText(pixd, pixs);
+    pixCopyInputFormat(pixd, pixs);
     pixSetAllArbitrary(pixd, grayval);
     datad = pixGetData(pixd);
     wpld = pixGetWpl(pixd);
@@ -71,12 +71,15 @@ LEPT_DLL extern l_ok pixSetLowContrast ( PIX *pixs1, PIX *pixs2, l_int32 mindiff
 LEPT_DLL extern PIX * pixLinearTRCTiled ( PIX *pixd, PIX *pixs, l_int32 sx, l_int32 sy, PIX *pixmin, PIX *pixmax );
 LEPT_DLL extern PIX * pixAffineSampledPta ( PIX *pixs, PTA *ptad, PTA *ptas, l_int32 incolor );
 LEPT_DLL extern PIX * pixAffineSampled ( PIX *pixs, l_float32 *vc, l_int32 incolor );
+LEPT_DLL extern PIX * pixAffineSampledInto ( PIX *pixd, PIX *pixs, l_float32 *vc, l_int32 incolor );
 LEPT_DLL extern PIX * pixAffinePta ( PIX *pixs, PTA *ptad, PTA *ptas, l_int32 incolor );
 LEPT_DLL extern PIX * pixAffine ( PIX *pixs, l_float32 *vc, l_int32 incolor );
 LEPT_DLL extern PIX * pixAffinePtaColor ( PIX *pixs, PTA *ptad, PTA *ptas, l_uint32 colorval );
 LEPT_DLL extern PIX * pixAffineColor ( PIX *pixs, l_float32 *vc, l_uint32 colorval );
+LEPT_DLL extern PIX * pixAffineColorInto ( PIX *pixd, PIX *pixs, l_float32 *vc, l_uint32 colorval );
 LEPT_DLL extern PIX * pixAffinePtaGray ( PIX *pixs, PTA *ptad, PTA *ptas, l_uint8 grayval );
 LEPT_DLL extern PIX * pixAffineGray ( PIX *pixs, l_float32 *vc, l_uint8 grayval );
+LEPT_DLL extern PIX * pixAffineGrayInto ( PIX *pixd, PIX *pixs, l_float32 *vc, l_uint8 grayval );
 LEPT_DLL extern PIX * pixAffinePtaWithAlpha ( PIX *pixs, PTA *ptad, PTA *ptas, PIX *pixg, l_float32 fract, l_int32 border );
 LEPT_DLL extern l_ok getAffineXformCoeffs ( PTA *ptas, PTA *ptad, l_float32 **pvc );
 LEPT_DLL extern l_ok affineInvertXform ( l_float32 *vc, l_float32 **pvci );
@@ -133,6 +136,8 @@ LEPT_DLL extern l_ok bbufferWrite ( L_BBUFFER *bb, l_uint8 *dest, size_t nbytes,
 LEPT_DLL extern l_ok bbufferWriteStream ( L_BBUFFER *bb, FILE *fp, size_t nbytes, size_t *pnout );
 LEPT_DLL extern PIX * pixBilateral ( PIX *pixs, l_float32 spatial_stdev, l_float32 range_stdev, l_int32 ncomps, l_int32 reduction );
 LEPT_DLL extern PIX * pixBilateralGray ( PIX *pixs, l_float32 spatial_stdev, l_float32 range_stdev, l_int32 ncomps, l_int32 reduction );
+LEPT_DLL extern PIX * pixBilateralGrid ( PIX *pixs, l_float32 spatial_stdev, l_float32 range_stdev );
+LEPT_DLL extern PIX * pixBilateralGridGray ( PIX *pixs, l_float32 spatial_stdev, l_float32 range_stdev );
 LEPT_DLL extern PIX * pixBilateralExact ( PIX *pixs, L_KERNEL *spatial_kel, L_KERNEL *range_kel );
 LEPT_DLL extern PIX * pixBilateralGrayExact ( PIX *pixs, L_KERNEL *spatial_kel, L_KERNEL *range_kel );
 LEPT_DLL extern PIX* pixBlockBilateralExact ( PIX *pixs, l_float32 spatial_stdev, l_float32 range_stdev );
@@ -206,9 +211,11 @@ LEPT_DLL extern l_int32 boxGetRefcount ( BOX *box );
 LEPT_DLL extern l_ok boxChangeRefcount ( BOX *box, l_int32 delta );
 LEPT_DLL extern l_ok boxIsValid ( BOX *box, l_int32 *pvalid );
 LEPT_DLL extern BOXA * boxaCreate ( l_int32 n );
+LEPT_DLL extern BOXA * boxaCreateCompact ( l_int32 n );
 LEPT_DLL extern BOXA * boxaCopy ( BOXA *boxa, l_int32 copyflag );
 LEPT_DLL extern void boxaDestroy ( BOXA **pboxa );
 LEPT_DLL extern l_ok boxaAddBox ( BOXA *boxa, BOX *box, l_int32 copyflag );
+LEPT_DLL extern l_ok boxaAddBoxGeometry ( BOXA *boxa, l_int32 x, l_int32 y, l_int32 w, l_int32 h );
 LEPT_DLL extern l_ok boxaExtendArray ( BOXA *boxa );
 LEPT_DLL extern l_ok boxaExtendArrayToSize ( BOXA *boxa, l_int32 size );
 LEPT_DLL extern l_int32 boxaGetCount ( BOXA *boxa );
@@ -218,6 +225,7 @@ LEPT_DLL extern BOX * boxaGetValidBox ( BOXA *boxa, l_int32 index, l_int32 acces
 LEPT_DLL extern NUMA * boxaFindInvalidBoxes ( BOXA *boxa );
 LEPT_DLL extern l_ok boxaGetBoxGeometry ( BOXA *boxa, l_int32 index, l_int32 *px, l_int32 *py, l_int32 *pw, l_int32 *ph );
 LEPT_DLL extern l_ok boxaIsFull ( BOXA *boxa, l_int32 *pfull );
+LEPT_DLL extern l_int32 boxaIsCompact ( BOXA *boxa );
 LEPT_DLL extern l_ok boxaReplaceBox ( BOXA *boxa, l_int32 index, BOX *box );
 LEPT_DLL extern l_ok boxaInsertBox ( BOXA *boxa, l_int32 index, BOX *box );
 LEPT_DLL extern l_ok boxaRemoveBox ( BOXA *boxa, l_int32 index );
@@ -609,6 +617,10 @@ LEPT_DLL extern l_ok pixBestCorrelation ( PIX *pix1, PIX *pix2, l_int32 area1, l
 LEPT_DLL extern BOXA * pixConnComp ( PIX *pixs, PIXA **ppixa, l_int32 connectivity );
 LEPT_DLL extern BOXA * pixConnCompPixa ( PIX *pixs, PIXA **ppixa, l_int32 connectivity );
 LEPT_DLL extern BOXA * pixConnCompBB ( PIX *pixs, l_int32 connectivity );
+LEPT_DLL extern BOXA * pixConnCompBBCompact ( PIX *pixs, l_int32 connectivity );
+LEPT_DLL extern BOXA * rleConnCompBB ( L_RLE *rle, l_int32 connectivity );
+LEPT_DLL extern l_ok rleCountConnComp ( L_RLE *rle, l_int32 connectivity, l_int32 *pcount );
+LEPT_DLL extern l_ok pixConnCompLabel ( PIX *pixs, l_int32 connectivity, l_int32 depth, PIX **ppixd, BOXA **pboxa, NUMA **pnaa, PTA **ppta );
 LEPT_DLL extern l_ok pixCountConnComp ( PIX *pixs, l_int32 connectivity, l_int32 *pcount );
 LEPT_DLL extern l_int32 nextOnPixelInRaster ( PIX *pixs, l_int32 xstart, l_int32 ystart, l_int32 *px, l_int32 *py );
 LEPT_DLL extern BOX * pixSeedfillBB ( PIX *pixs, L_STACK *stack, l_int32 x, l_int32 y, l_int32 connectivity );
@@ -639,13 +651,17 @@ LEPT_DLL extern PIX * pixConvolveRGBSep ( PIX *pixs, L_KERNEL *kelx, L_KERNEL *k
 LEPT_DLL extern FPIX * fpixConvolve ( FPIX *fpixs, L_KERNEL *kel, l_int32 normflag );
 LEPT_DLL extern FPIX * fpixConvolveSep ( FPIX *fpixs, L_KERNEL *kelx, L_KERNEL *kely, l_int32 normflag );
 LEPT_DLL extern PIX * pixConvolveWithBias ( PIX *pixs, L_KERNEL *kel1, L_KERNEL *kel2, l_int32 force8, l_int32 *pbias );
+LEPT_DLL extern PIX * pixGaussianRecursive ( PIX *pix, l_float32 sigma );
+LEPT_DLL extern FPIX * fpixGaussianRecursive ( FPIX *fpixs, l_float32 sigma );
 LEPT_DLL extern void l_setConvolveSampling ( l_int32 xfact, l_int32 yfact );
+LEPT_DLL extern void l_setConvolveFFT ( l_int32 minsize );
 LEPT_DLL extern PIX * pixAddGaussianNoise ( PIX *pixs, l_float32 stdev );
 LEPT_DLL extern l_float32 gaussDistribSampling (  );
 LEPT_DLL extern l_ok pixCorrelationScore ( PIX *pix1, PIX *pix2, l_int32 area1, l_int32 area2, l_float32 delx, l_float32 dely, l_int32 maxdiffw, l_int32 maxdiffh, l_int32 *tab, l_float32 *pscore );
 LEPT_DLL extern l_int32 pixCorrelationScoreThresholded ( PIX *pix1, PIX *pix2, l_int32 area1, l_int32 area2, l_float32 delx, l_float32 dely, l_int32 maxdiffw, l_int32 maxdiffh, l_int32 *tab, l_int32 *downcount, l_float32 score_threshold );
 LEPT_DLL extern l_ok pixCorrelationScoreSimple ( PIX *pix1, PIX *pix2, l_int32 area1, l_int32 area2, l_float32 delx, l_float32 dely, l_int32 maxdiffw, l_int32 maxdiffh, l_int32 *tab, l_float32 *pscore );
 LEPT_DLL extern l_ok pixCorrelationScoreShifted ( PIX *pix1, PIX *pix2, l_int32 area1, l_int32 area2, l_int32 delx, l_int32 dely, l_int32 *tab, l_float32 *pscore );
+LEPT_DLL extern l_ok pixCorrelationCountShifts ( PIX *pix1, PIX *pix2, l_int32 delx, l_int32 dely, l_int32 nx, l_int32 ny, l_int32 mincount, l_int32 *tab8, l_int32 *counts, l_int32 *pabandoned );
 LEPT_DLL extern L_DEWARP * dewarpCreate ( PIX *pixs, l_int32 pageno );
 LEPT_DLL extern L_DEWARP * dewarpCreateRef ( l_int32 pageno, l_int32 refpage );
 LEPT_DLL extern void dewarpDestroy ( L_DEWARP **pdew );
@@ -802,6 +818,10 @@ LEPT_DLL extern PIX * pixDarkenGray ( PIX *pixd, PIX *pixs, l_int32 thresh, l_in
 LEPT_DLL extern PIX * pixMultConstantColor ( PIX *pixs, l_float32 rfact, l_float32 gfact, l_float32 bfact );
 LEPT_DLL extern PIX * pixMultMatrixColor ( PIX *pixs, L_KERNEL *kel );
 LEPT_DLL extern PIX * pixHalfEdgeByBandpass ( PIX *pixs, l_int32 sm1h, l_int32 sm1v, l_int32 sm2h, l_int32 sm2v );
+LEPT_DLL extern FPIX * fpixConvolveFFT ( FPIX *fpixs, L_KERNEL *kel, l_int32 normflag );
+LEPT_DLL extern PIX * pixConvolveFFT ( PIX *pixs, L_KERNEL *kel, l_int32 outdepth, l_int32 normflag );
+LEPT_DLL extern l_ok pixCorrelationCountShiftsFFT ( PIX *pix1, PIX *pix2, l_int32 delx, l_int32 dely, l_int32 nx, l_int32 ny, l_int32 *counts );
+LEPT_DLL extern l_ok pixPhaseCorrelation ( PIX *pix1, PIX *pix2, l_int32 *pdelx, l_int32 *pdely, l_float32 *ppeak );
 LEPT_DLL extern l_ok fhmtautogen ( SELA *sela, l_int32 fileindex, const char *filename );
 LEPT_DLL extern l_ok fhmtautogen1 ( SELA *sela, l_int32 fileindex, const char *filename );
 LEPT_DLL extern l_ok fhmtautogen2 ( SELA *sela, l_int32 fileindex, const char *filename );
@@ -1035,6 +1055,12 @@ LEPT_DLL extern l_ok lheapSwapDown ( L_HEAP *lh );
 LEPT_DLL extern l_ok lheapSort ( L_HEAP *lh );
 LEPT_DLL extern l_ok lheapSortStrictOrder ( L_HEAP *lh );
 LEPT_DLL extern l_ok lheapPrint ( FILE *fp, L_HEAP *lh );
+LEPT_DLL extern L_IHISTO * ihistoCreate ( PIX *pixs, l_int32 nbins, l_int32 cellsize );
+LEPT_DLL extern void ihistoDestroy ( L_IHISTO **pih );
+LEPT_DLL extern l_ok ihistoGetParameters ( L_IHISTO *ih, l_int32 *pw, l_int32 *ph, l_int32 *pnbins, l_int32 *pcellsize );
+LEPT_DLL extern NUMA * ihistoGetHisto ( L_IHISTO *ih, BOX *box );
+LEPT_DLL extern l_ok ihistoGetRankValue ( L_IHISTO *ih, BOX *box, l_float32 rank, l_float32 *pval );
+LEPT_DLL extern l_ok ihistoGetMeanVariance ( L_IHISTO *ih, BOX *box, l_float32 *pmean, l_float32 *pvar, l_float32 *prvar );
 LEPT_DLL extern JBCLASSER * jbRankHausInit ( l_int32 components, l_int32 maxwidth, l_int32 maxheight, l_int32 size, l_float32 rank );
 LEPT_DLL extern JBCLASSER * jbCorrelationInit ( l_int32 components, l_int32 maxwidth, l_int32 maxheight, l_float32 thresh, l_float32 weightfactor );
 LEPT_DLL extern JBCLASSER * jbCorrelationInitWithoutComponents ( l_int32 components, l_int32 maxwidth, l_int32 maxheight, l_float32 thresh, l_float32 weightfactor );
@@ -1071,6 +1097,8 @@ LEPT_DLL extern PIX * pixReadMemJp2k ( const l_uint8 *data, size_t size, l_uint3
 LEPT_DLL extern l_ok pixWriteMemJp2k ( l_uint8 **pdata, size_t *psize, PIX *pix, l_int32 quality, l_int32 nlevels, l_int32 hint, l_int32 debug );
 LEPT_DLL extern PIX * pixReadJpeg ( const char *filename, l_int32 cmapflag, l_int32 reduction, l_int32 *pnwarn, l_int32 hint );
 LEPT_DLL extern PIX * pixReadStreamJpeg ( FILE *fp, l_int32 cmapflag, l_int32 reduction, l_int32 *pnwarn, l_int32 hint );
+LEPT_DLL extern PIX * pixReadJpegRegion ( const char *filename, BOX *box, l_int32 reduction, l_int32 *pnwarn, l_int32 hint );
+LEPT_DLL extern PIX * pixReadStreamJpegRegion ( FILE *fp, BOX *box, l_int32 reduction, l_int32 *pnwarn, l_int32 hint );
 LEPT_DLL extern l_ok readHeaderJpeg ( const char *filename, l_int32 *pw, l_int32 *ph, l_int32 *pspp, l_int32 *pycck, l_int32 *pcmyk );
 LEPT_DLL extern l_ok freadHeaderJpeg ( FILE *fp, l_int32 *pw, l_int32 *ph, l_int32 *pspp, l_int32 *pycck, l_int32 *pcmyk );
 LEPT_DLL extern l_int32 fgetJpegResolution ( FILE *fp, l_int32 *pxres, l_int32 *pyres );
@@ -1082,6 +1110,12 @@ LEPT_DLL extern l_ok readHeaderMemJpeg ( const l_uint8 *data, size_t size, l_int
 LEPT_DLL extern l_ok readResolutionMemJpeg ( const l_uint8 *data, size_t size, l_int32 *pxres, l_int32 *pyres );
 LEPT_DLL extern l_ok pixWriteMemJpeg ( l_uint8 **pdata, size_t *psize, PIX *pix, l_int32 quality, l_int32 progressive );
 LEPT_DLL extern l_ok pixSetChromaSampling ( PIX *pix, l_int32 sampling );
+LEPT_DLL extern l_ok stripReadOpenJpeg ( L_STRIP_READER *sr );
+LEPT_DLL extern l_ok stripReadRowsJpeg ( L_STRIP_READER *sr, PIX *pix, l_int32 nrows );
+LEPT_DLL extern void stripReadCloseJpeg ( L_STRIP_READER *sr );
+LEPT_DLL extern l_ok stripWriteOpenJpeg ( L_STRIP_WRITER *sw );
+LEPT_DLL extern l_ok stripWriteRowsJpeg ( L_STRIP_WRITER *sw, PIX *pix );
+LEPT_DLL extern l_ok stripWriteCloseJpeg ( L_STRIP_WRITER *sw, l_int32 finish );
 LEPT_DLL extern L_KERNEL * kernelCreate ( l_int32 height, l_int32 width );
 LEPT_DLL extern void kernelDestroy ( L_KERNEL **pkel );
 LEPT_DLL extern L_KERNEL * kernelCopy ( L_KERNEL *kels );
@@ -1438,6 +1472,8 @@ LEPT_DLL extern PIX * pixCreateTemplate ( const PIX *pixs );
 LEPT_DLL extern PIX * pixCreateTemplateNoInit ( const PIX *pixs );
 LEPT_DLL extern PIX * pixCreateHeader ( l_int32 width, l_int32 height, l_int32 depth );
 LEPT_DLL extern PIX * pixClone ( PIX *pixs );
+LEPT_DLL extern PIX * pixCreateView ( PIX *pixs, l_int32 x, l_int32 y, l_int32 w, l_int32 h );
+LEPT_DLL extern PIX * pixReuseOrCreate ( PIX *pixd, l_int32 width, l_int32 height, l_int32 depth );
 LEPT_DLL extern void pixDestroy ( PIX **ppix );
 LEPT_DLL extern PIX * pixCopy ( PIX *pixd, const PIX *pixs );
 LEPT_DLL extern l_ok pixResizeImageData ( PIX *pixd, const PIX *pixs );
@@ -1484,6 +1520,8 @@ LEPT_DLL extern l_uint32 * pixGetData ( PIX *pix );
 LEPT_DLL extern l_int32 pixSetData ( PIX *pix, l_uint32 *data );
 LEPT_DLL extern l_uint32 * pixExtractData ( PIX *pixs );
 LEPT_DLL extern l_int32 pixFreeData ( PIX *pix );
+LEPT_DLL extern l_int32 pixIsView ( const PIX *pix );
+LEPT_DLL extern l_int32 pixIsMapped ( const PIX *pix );
 LEPT_DLL extern void ** pixGetLinePtrs ( PIX *pix, l_int32 *psize );
 LEPT_DLL extern l_ok pixPrintStreamInfo ( FILE *fp, const PIX *pix, const char *text );
 LEPT_DLL extern l_ok pixGetPixel ( PIX *pix, l_int32 x, l_int32 y, l_uint32 *pval );
@@ -1645,6 +1683,8 @@ LEPT_DLL extern BOXA * pixFindRectangleComps ( PIX *pixs, l_int32 dist, l_int32
 LEPT_DLL extern l_ok pixConformsToRectangle ( PIX *pixs, BOX *box, l_int32 dist, l_int32 *pconforms );
 LEPT_DLL extern PIXA * pixClipRectangles ( PIX *pixs, BOXA *boxa );
 LEPT_DLL extern PIX * pixClipRectangle ( PIX *pixs, BOX *box, BOX **pboxc );
+LEPT_DLL extern PIXA * pixClipRectanglesView ( PIX *pixs, BOXA *boxa );
+LEPT_DLL extern PIX * pixClipRectangleView ( PIX *pixs, BOX *box, BOX **pboxc );
 LEPT_DLL extern PIX * pixClipMasked ( PIX *pixs, PIX *pixm, l_int32 x, l_int32 y, l_uint32 outval );
 LEPT_DLL extern l_ok pixCropToMatch ( PIX *pixs1, PIX *pixs2, PIX **ppixd1, PIX **ppixd2 );
 LEPT_DLL extern PIX * pixCropToSize ( PIX *pixs, l_int32 w, l_int32 h );
@@ -1831,6 +1871,23 @@ LEPT_DLL extern void * pmsGetAlloc ( size_t nbytes );
 LEPT_DLL extern l_ok pmsGetLevelForAlloc ( size_t nbytes, l_int32 *plevel );
 LEPT_DLL extern l_ok pmsGetLevelForDealloc ( void *data, l_int32 *plevel );
 LEPT_DLL extern void pmsLogInfo (  );
+LEPT_DLL extern l_ok pixArenaOpen ( size_t nbytes );
+LEPT_DLL extern PIX * pixArenaClose ( PIX **ppixs );
+LEPT_DLL extern void pixArenaDestroy (  );
+LEPT_DLL extern void * pixArenaAlloc ( size_t nbytes );
+LEPT_DLL extern void pixArenaDealloc ( void *data );
+LEPT_DLL extern l_ok pixArenaGetInfo ( size_t *psize, size_t *pused, size_t *pmaxused, size_t *pnheap );
+LEPT_DLL extern l_uint32 pixArenaGetScope (  );
+LEPT_DLL extern void pixArenaSuspend ( l_int32 flag );
+LEPT_DLL extern l_ok pixPoolCreate ( size_t maxbytes );
+LEPT_DLL extern void pixPoolDestroy (  );
+LEPT_DLL extern void * pixPoolAlloc ( size_t nbytes );
+LEPT_DLL extern void pixPoolDealloc ( void *data );
+LEPT_DLL extern l_ok pixPoolGetStats ( l_int32 *pnhits, l_int32 *pnmisses, size_t *pnbytes );
+LEPT_DLL extern void pixMemRecordAlloc ( l_int32 type, size_t nbytes );
+LEPT_DLL extern void pixMemRecordFree ( l_int32 type, size_t nbytes );
+LEPT_DLL extern l_ok pixMemGetStats ( l_int32 scope, L_MEM_STATS *stats );
+LEPT_DLL extern l_ok pixMemResetStats ( l_int32 scope );
 LEPT_DLL extern l_ok pixAddConstantGray ( PIX *pixs, l_int32 val );
 LEPT_DLL extern l_ok pixMultConstantGray ( PIX *pixs, l_float32 val );
 LEPT_DLL extern PIX * pixAddGray ( PIX *pixd, PIX *pixs1, PIX *pixs2 );
@@ -1880,6 +1937,8 @@ LEPT_DLL extern BOX * pixacompGetBox ( PIXAC *pixac, l_int32 index, l_int32 acce
 LEPT_DLL extern l_ok pixacompGetBoxGeometry ( PIXAC *pixac, l_int32 index, l_int32 *px, l_int32 *py, l_int32 *pw, l_int32 *ph );
 LEPT_DLL extern l_int32 pixacompGetOffset ( PIXAC *pixac );
 LEPT_DLL extern l_ok pixacompSetOffset ( PIXAC *pixac, l_int32 offset );
+LEPT_DLL extern l_ok pixacompSetCache ( PIXAC *pixac, size_t maxbytes );
+LEPT_DLL extern l_ok pixacompGetCacheStats ( PIXAC *pixac, l_int32 *pnhits, l_int32 *pnmisses, size_t *pnbytes );
 LEPT_DLL extern PIXA * pixaCreateFromPixacomp ( PIXAC *pixac, l_int32 accesstype );
 LEPT_DLL extern l_ok pixacompJoin ( PIXAC *pixacd, PIXAC *pixacs, l_int32 istart, l_int32 iend );
 LEPT_DLL extern PIXAC * pixacompInterleave ( PIXAC *pixac1, PIXAC *pixac2 );
@@ -1904,6 +1963,7 @@ LEPT_DLL extern l_ok pixAddGrayColormap8 ( PIX *pixs );
 LEPT_DLL extern PIX * pixAddMinimalGrayColormap8 ( PIX *pixs );
 LEPT_DLL extern PIX * pixConvertRGBToLuminance ( PIX *pixs );
 LEPT_DLL extern PIX * pixConvertRGBToGray ( PIX *pixs, l_float32 rwt, l_float32 gwt, l_float32 bwt );
+LEPT_DLL extern PIX * pixConvertRGBToGrayInto ( PIX *pixd, PIX *pixs, l_float32 rwt, l_float32 gwt, l_float32 bwt );
 LEPT_DLL extern PIX * pixConvertRGBToGrayFast ( PIX *pixs );
 LEPT_DLL extern PIX * pixConvertRGBToGrayMinMax ( PIX *pixs, l_int32 type );
 LEPT_DLL extern PIX * pixConvertRGBToGraySatBoost ( PIX *pixs, l_int32 refval );
@@ -1937,6 +1997,7 @@ LEPT_DLL extern PIX * pixConvertTo1Adaptive ( PIX *pixs );
 LEPT_DLL extern PIX * pixConvertTo1 ( PIX *pixs, l_int32 threshold );
 LEPT_DLL extern PIX * pixConvertTo1BySampling ( PIX *pixs, l_int32 factor, l_int32 threshold );
 LEPT_DLL extern PIX * pixConvertTo8 ( PIX *pixs, l_int32 cmapflag );
+LEPT_DLL extern PIX * pixConvertTo8Into ( PIX *pixd, PIX *pixs, l_int32 cmapflag );
 LEPT_DLL extern PIX * pixConvertTo8BySampling ( PIX *pixs, l_int32 factor, l_int32 cmapflag );
 LEPT_DLL extern PIX * pixConvertTo8Colormap ( PIX *pixs, l_int32 dither );
 LEPT_DLL extern PIX * pixConvertTo16 ( PIX *pixs );
@@ -1980,6 +2041,12 @@ LEPT_DLL extern l_ok pixWritePng ( const char *filename, PIX *pix, l_float32 gam
 LEPT_DLL extern l_ok pixWriteStreamPng ( FILE *fp, PIX *pix, l_float32 gamma );
 LEPT_DLL extern l_ok pixSetZlibCompression ( PIX *pix, l_int32 compval );
 LEPT_DLL extern void l_pngSetReadStrip16To8 ( l_int32 flag );
+LEPT_DLL extern l_ok stripReadOpenPng ( L_STRIP_READER *sr );
+LEPT_DLL extern l_ok stripReadRowsPng ( L_STRIP_READER *sr, PIX *pix, l_int32 nrows );
+LEPT_DLL extern void stripReadClosePng ( L_STRIP_READER *sr );
+LEPT_DLL extern l_ok stripWriteOpenPng ( L_STRIP_WRITER *sw );
+LEPT_DLL extern l_ok stripWriteRowsPng ( L_STRIP_WRITER *sw, PIX *pix );
+LEPT_DLL extern l_ok stripWriteClosePng ( L_STRIP_WRITER *sw, l_int32 finish );
 LEPT_DLL extern PIX * pixReadMemPng ( const l_uint8 *filedata, size_t filesize );
 LEPT_DLL extern l_ok pixWriteMemPng ( l_uint8 **pfiledata, size_t *pfilesize, PIX *pix, l_float32 gamma );
 LEPT_DLL extern PIX * pixReadStreamPnm ( FILE *fp );
@@ -2151,6 +2218,7 @@ LEPT_DLL extern L_PTRA * ptraaGetPtra ( L_PTRAA *paa, l_int32 index, l_int32 acc
 LEPT_DLL extern L_PTRA * ptraaFlattenToPtra ( L_PTRAA *paa );
 LEPT_DLL extern l_ok pixQuadtreeMean ( PIX *pixs, l_int32 nlevels, PIX *pix_ma, FPIXA **pfpixa );
 LEPT_DLL extern l_ok pixQuadtreeVariance ( PIX *pixs, l_int32 nlevels, PIX *pix_ma, DPIX *dpix_msa, FPIXA **pfpixa_v, FPIXA **pfpixa_rv );
+LEPT_DLL extern l_ok pixQuadtreeRank ( PIX *pixs, l_int32 nlevels, l_float32 rank, L_IHISTO *ih, FPIXA **pfpixa );
 LEPT_DLL extern l_ok pixMeanInRectangle ( PIX *pixs, BOX *box, PIX *pixma, l_float32 *pval );
 LEPT_DLL extern l_ok pixVarianceInRectangle ( PIX *pixs, BOX *box, PIX *pix_ma, DPIX *dpix_msa, l_float32 *pvar, l_float32 *prvar );
 LEPT_DLL extern BOXAA * boxaaQuadtreeRegions ( l_int32 w, l_int32 h, l_int32 nlevels );
@@ -2164,6 +2232,11 @@ LEPT_DLL extern l_ok lqueueAdd ( L_QUEUE *lq, void *item );
 LEPT_DLL extern void * lqueueRemove ( L_QUEUE *lq );
 LEPT_DLL extern l_int32 lqueueGetCount ( L_QUEUE *lq );
 LEPT_DLL extern l_ok lqueuePrint ( FILE *fp, L_QUEUE *lq );
+LEPT_DLL extern L_PAIRQUEUE * lpairqueueCreate ( l_int32 nalloc );
+LEPT_DLL extern void lpairqueueDestroy ( L_PAIRQUEUE **plpq );
+LEPT_DLL extern l_ok lpairqueueAdd ( L_PAIRQUEUE *lpq, l_int32 v1, l_int32 v2 );
+LEPT_DLL extern l_ok lpairqueueRemove ( L_PAIRQUEUE *lpq, l_int32 *pv1, l_int32 *pv2 );
+LEPT_DLL extern l_int32 lpairqueueGetCount ( L_PAIRQUEUE *lpq );
 LEPT_DLL extern PIX * pixRankFilter ( PIX *pixs, l_int32 wf, l_int32 hf, l_float32 rank );
 LEPT_DLL extern PIX * pixRankFilterRGB ( PIX *pixs, l_int32 wf, l_int32 hf, l_float32 rank );
 LEPT_DLL extern PIX * pixRankFilterGray ( PIX *pixs, l_int32 wf, l_int32 hf, l_float32 rank );
@@ -2195,6 +2268,7 @@ LEPT_DLL extern PIXA * pixaReadFiles ( const char *dirname, const char *substr )
 LEPT_DLL extern PIXA * pixaReadFilesSA ( SARRAY *sa );
 LEPT_DLL extern PIX * pixRead ( const char *filename );
 LEPT_DLL extern PIX * pixReadWithHint ( const char *filename, l_int32 hint );
+LEPT_DLL extern PIX * pixReadRegion ( const char *filename, BOX *box );
 LEPT_DLL extern PIX * pixReadIndexed ( SARRAY *sa, l_int32 index );
 LEPT_DLL extern PIX * pixReadStream ( FILE *fp, l_int32 hint );
 LEPT_DLL extern l_ok pixReadHeader ( const char *filename, l_int32 *pformat, l_int32 *pw, l_int32 *ph, l_int32 *pbps, l_int32 *pspp, l_int32 *piscmap );
@@ -2297,6 +2371,8 @@ LEPT_DLL extern PIX * pixRotateWithAlpha ( PIX *pixs, l_float32 angle, PIX *pixg
 LEPT_DLL extern PIX * pixRotateAM ( PIX *pixs, l_float32 angle, l_int32 incolor );
 LEPT_DLL extern PIX * pixRotateAMColor ( PIX *pixs, l_float32 angle, l_uint32 colorval );
 LEPT_DLL extern PIX * pixRotateAMGray ( PIX *pixs, l_float32 angle, l_uint8 grayval );
+LEPT_DLL extern PIX * pixRotateAMColorInto ( PIX *pixd, PIX *pixs, l_float32 angle, l_uint32 colorval );
+LEPT_DLL extern PIX * pixRotateAMGrayInto ( PIX *pixd, PIX *pixs, l_float32 angle, l_uint8 grayval );
 LEPT_DLL extern PIX * pixRotateAMCorner ( PIX *pixs, l_float32 angle, l_int32 incolor );
 LEPT_DLL extern PIX * pixRotateAMColorCorner ( PIX *pixs, l_float32 angle, l_uint32 fillval );
 LEPT_DLL extern PIX * pixRotateAMGrayCorner ( PIX *pixs, l_float32 angle, l_uint8 grayval );
@@ -2320,6 +2396,23 @@ LEPT_DLL extern NUMA * pixFindMaxRuns ( PIX *pix, l_int32 direction, NUMA **pnas
 LEPT_DLL extern l_ok pixFindMaxHorizontalRunOnLine ( PIX *pix, l_int32 y, l_int32 *pxstart, l_int32 *psize );
 LEPT_DLL extern l_ok pixFindMaxVerticalRunOnLine ( PIX *pix, l_int32 x, l_int32 *pystart, l_int32 *psize );
 LEPT_DLL extern l_ok runlengthMembershipOnLine ( l_int32 *buffer, l_int32 size, l_int32 depth, l_int32 *start, l_int32 *end, l_int32 n );
+LEPT_DLL extern L_RLE * rleCreate ( l_int32 w, l_int32 h, l_int32 n );
+LEPT_DLL extern void rleDestroy ( L_RLE **prle );
+LEPT_DLL extern L_RLE * rleCopy ( L_RLE *rles );
+LEPT_DLL extern l_ok rleGetDimensions ( L_RLE *rle, l_int32 *pw, l_int32 *ph, l_int32 *pnruns );
+LEPT_DLL extern L_RLE * pixConvertToRle ( PIX *pixs );
+LEPT_DLL extern PIX * rleConvertToPix ( L_RLE *rle );
+LEPT_DLL extern void setLineRun ( l_uint32 *line, l_int32 x0, l_int32 x1 );
+LEPT_DLL extern L_RLE * rleRasterop ( L_RLE *rled, L_RLE *rles, l_int32 op );
+LEPT_DLL extern L_RLE * rleInvert ( L_RLE *rles );
+LEPT_DLL extern L_RLE * rleAnd ( L_RLE *rle1, L_RLE *rle2 );
+LEPT_DLL extern L_RLE * rleOr ( L_RLE *rle1, L_RLE *rle2 );
+LEPT_DLL extern L_RLE * rleXor ( L_RLE *rle1, L_RLE *rle2 );
+LEPT_DLL extern L_RLE * rleSubtract ( L_RLE *rle1, L_RLE *rle2 );
+LEPT_DLL extern L_RLE * rleDilateBrick ( L_RLE *rles, l_int32 hsize, l_int32 vsize );
+LEPT_DLL extern L_RLE * rleErodeBrick ( L_RLE *rles, l_int32 hsize, l_int32 vsize );
+LEPT_DLL extern l_ok rleCountPixels ( L_RLE *rle, l_int32 *pcount );
+LEPT_DLL extern l_ok rleFindBoundingBox ( L_RLE *rle, BOX **pbox );
 LEPT_DLL extern l_int32 * makeMSBitLocTab ( l_int32 bitval );
 LEPT_DLL extern SARRAY * sarrayCreate ( l_int32 n );
 LEPT_DLL extern SARRAY * sarrayCreateInitialized ( l_int32 n, const char *initstr );
@@ -2400,6 +2493,9 @@ LEPT_DLL extern PIX * pixScaleAreaMap ( PIX *pix, l_float32 scalex, l_float32 sc
 LEPT_DLL extern PIX * pixScaleAreaMap2 ( PIX *pix );
 LEPT_DLL extern PIX * pixScaleAreaMapToSize ( PIX *pixs, l_int32 wd, l_int32 hd );
 LEPT_DLL extern PIX * pixScaleBinary ( PIX *pixs, l_float32 scalex, l_float32 scaley );
+LEPT_DLL extern PIX * pixScaleGrayLIInto ( PIX *pixd, PIX *pixs, l_float32 scalex, l_float32 scaley );
+LEPT_DLL extern PIX * pixScaleColorLIInto ( PIX *pixd, PIX *pixs, l_float32 scalex, l_float32 scaley );
+LEPT_DLL extern PIX * pixScaleBySamplingInto ( PIX *pixd, PIX *pixs, l_float32 scalex, l_float32 scaley );
 LEPT_DLL extern PIX * pixScaleToGray ( PIX *pixs, l_float32 scalefactor );
 LEPT_DLL extern PIX * pixScaleToGrayFast ( PIX *pixs, l_float32 scalefactor );
 LEPT_DLL extern PIX * pixScaleToGray2 ( PIX *pixs );
@@ -2408,6 +2504,7 @@ LEPT_DLL extern PIX * pixScaleToGray4 ( PIX *pixs );
 LEPT_DLL extern PIX * pixScaleToGray6 ( PIX *pixs );
 LEPT_DLL extern PIX * pixScaleToGray8 ( PIX *pixs );
 LEPT_DLL extern PIX * pixScaleToGray16 ( PIX *pixs );
+LEPT_DLL extern PIX * pixScaleToGrayInto ( PIX *pixd, PIX *pixs, l_int32 factor );
 LEPT_DLL extern PIX * pixScaleToGrayMipmap ( PIX *pixs, l_float32 scalefactor );
 LEPT_DLL extern PIX * pixScaleMipmap ( PIX *pixs1, PIX *pixs2, l_float32 scale );
 LEPT_DLL extern PIX * pixExpandReplicate ( PIX *pixs, l_int32 factor );
@@ -2432,6 +2529,9 @@ LEPT_DLL extern l_ok pixSeedfillGrayInvSimple ( PIX *pixs, PIX *pixm, l_int32 co
 LEPT_DLL extern PIX * pixSeedfillGrayBasin ( PIX *pixb, PIX *pixm, l_int32 delta, l_int32 connectivity );
 LEPT_DLL extern PIX * pixDistanceFunction ( PIX *pixs, l_int32 connectivity, l_int32 outdepth, l_int32 boundcond );
 LEPT_DLL extern PIX * pixSeedspread ( PIX *pixs, l_int32 connectivity );
+LEPT_DLL extern PIX * pixEuclideanDistance ( PIX *pixs, l_int32 outdepth, l_int32 boundcond );
+LEPT_DLL extern FPIX * pixEuclideanDistanceFPix ( PIX *pixs, l_int32 boundcond );
+LEPT_DLL extern PIX * pixSeedspreadEuclidean ( PIX *pixs );
 LEPT_DLL extern l_ok pixLocalExtrema ( PIX *pixs, l_int32 maxmin, l_int32 minmax, PIX **ppixmin, PIX **ppixmax );
 LEPT_DLL extern l_ok pixSelectedLocalExtrema ( PIX *pixs, l_int32 mindist, PIX **ppixmin, PIX **ppixmax );
 LEPT_DLL extern PIX * pixFindEqualValues ( PIX *pixs1, PIX *pixs2 );
@@ -2519,6 +2619,7 @@ LEPT_DLL extern l_int32 pixFindSkewOrthogonalRange ( PIX *pixs, l_float32 *pangl
 LEPT_DLL extern l_ok pixFindDifferentialSquareSum ( PIX *pixs, l_float32 *psum );
 LEPT_DLL extern l_ok pixFindNormalizedSquareSum ( PIX *pixs, l_float32 *phratio, l_float32 *pvratio, l_float32 *pfract );
 LEPT_DLL extern PIX * pixReadStreamSpix ( FILE *fp );
+LEPT_DLL extern PIX * pixReadSpixMapped ( const char *filename );
 LEPT_DLL extern l_ok readHeaderSpix ( const char *filename, l_int32 *pwidth, l_int32 *pheight, l_int32 *pbps, l_int32 *pspp, l_int32 *piscmap );
 LEPT_DLL extern l_ok freadHeaderSpix ( FILE *fp, l_int32 *pwidth, l_int32 *pheight, l_int32 *pbps, l_int32 *pspp, l_int32 *piscmap );
 LEPT_DLL extern l_ok sreadHeaderSpix ( const l_uint32 *data, l_int32 *pwidth, l_int32 *pheight, l_int32 *pbps, l_int32 *pspp, l_int32 *piscmap );
@@ -2538,6 +2639,22 @@ LEPT_DLL extern l_ok strcodeCreateFromFile ( const char *filein, l_int32 fileno,
 LEPT_DLL extern l_ok strcodeGenerate ( L_STRCODE *strcode, const char *filein, const char *type );
 LEPT_DLL extern l_int32 strcodeFinalize ( L_STRCODE **pstrcode, const char *outdir );
 LEPT_DLL extern l_int32 l_getStructStrFromFile ( const char *filename, l_int32 field, char **pstr );
+LEPT_DLL extern L_STRIP_READER * stripReaderCreate ( const char *filename );
+LEPT_DLL extern void stripReaderDestroy ( L_STRIP_READER **psr );
+LEPT_DLL extern l_ok stripReaderGetDimensions ( L_STRIP_READER *sr, l_int32 *pw, l_int32 *ph, l_int32 *pd );
+LEPT_DLL extern PIX * stripReaderRead ( L_STRIP_READER *sr, l_int32 nrows );
+LEPT_DLL extern L_STRIP_WRITER * stripWriterCreate ( const char *filename, l_int32 format, l_int32 h, l_int32 quality );
+LEPT_DLL extern void stripWriterDestroy ( L_STRIP_WRITER **psw );
+LEPT_DLL extern l_ok stripWriterWrite ( L_STRIP_WRITER *sw, PIX *pix );
+LEPT_DLL extern l_ok stripWriterFinish ( L_STRIP_WRITER *sw );
+LEPT_DLL extern L_STRIP_PIPE * stripPipeCreate ( void );
+LEPT_DLL extern void stripPipeDestroy ( L_STRIP_PIPE **ppipe );
+LEPT_DLL extern l_ok stripPipeAddTRC ( L_STRIP_PIPE *pipe, NUMA *na );
+LEPT_DLL extern l_ok stripPipeAddConvertToGray ( L_STRIP_PIPE *pipe, l_float32 rwt, l_float32 gwt, l_float32 bwt );
+LEPT_DLL extern l_ok stripPipeAddThreshold ( L_STRIP_PIPE *pipe, l_int32 thresh );
+LEPT_DLL extern l_ok stripPipeAddBlockconv ( L_STRIP_PIPE *pipe, l_int32 wc, l_int32 hc );
+LEPT_DLL extern PIX * stripPipeApply ( L_STRIP_PIPE *pipe, PIX *pixs );
+LEPT_DLL extern l_ok stripPipeProcess ( L_STRIP_PIPE *pipe, const char *filein, const char *fileout, l_int32 format, l_int32 striph, l_int32 quality );
 LEPT_DLL extern l_ok pixFindStrokeLength ( PIX *pixs, l_int32 *tab8, l_int32 *plength );
 LEPT_DLL extern l_ok pixFindStrokeWidth ( PIX *pixs, l_float32 thresh, l_int32 *tab8, l_float32 *pwidth, NUMA **pnahisto );
 LEPT_DLL extern NUMA * pixaFindStrokeWidth ( PIXA *pixa, l_float32 thresh, l_int32 *tab8, l_int32 debug );
@@ -2566,6 +2683,8 @@ LEPT_DLL extern l_ok bmfGetStringWidth ( L_BMF *bmf, const char *textstr, l_int3
 LEPT_DLL extern SARRAY * splitStringToParagraphs ( char *textstr, l_int32 splitflag );
 LEPT_DLL extern PIX * pixReadTiff ( const char *filename, l_int32 n );
 LEPT_DLL extern PIX * pixReadStreamTiff ( FILE *fp, l_int32 n );
+LEPT_DLL extern PIX * pixReadTiffRegion ( const char *filename, l_int32 n, BOX *box );
+LEPT_DLL extern PIX * pixReadStreamTiffRegion ( FILE *fp, l_int32 n, BOX *box );
 LEPT_DLL extern l_ok pixWriteTiff ( const char *filename, PIX *pix, l_int32 comptype, const char *modestr );
 LEPT_DLL extern l_ok pixWriteTiffCustom ( const char *filename, PIX *pix, l_int32 comptype, const char *modestr, NUMA *natags, SARRAY *savals, SARRAY *satypes, NUMA *nasizes );
 LEPT_DLL extern l_ok pixWriteStreamTiff ( FILE *fp, PIX *pix, l_int32 comptype );
@@ -2589,6 +2708,12 @@ LEPT_DLL extern PIXA * pixaReadMemMultipageTiff ( const l_uint8 *data, size_t si
 LEPT_DLL extern l_ok pixaWriteMemMultipageTiff ( l_uint8 **pdata, size_t *psize, PIXA *pixa );
 LEPT_DLL extern l_ok pixWriteMemTiff ( l_uint8 **pdata, size_t *psize, PIX *pix, l_int32 comptype );
 LEPT_DLL extern l_ok pixWriteMemTiffCustom ( l_uint8 **pdata, size_t *psize, PIX *pix, l_int32 comptype, NUMA *natags, SARRAY *savals, SARRAY *satypes, NUMA *nasizes );
+LEPT_DLL extern l_ok stripReadOpenTiff ( L_STRIP_READER *sr );
+LEPT_DLL extern l_ok stripReadRowsTiff ( L_STRIP_READER *sr, PIX *pix, l_int32 nrows );
+LEPT_DLL extern void stripReadCloseTiff ( L_STRIP_READER *sr );
+LEPT_DLL extern l_ok stripWriteOpenTiff ( L_STRIP_WRITER *sw );
+LEPT_DLL extern l_ok stripWriteRowsTiff ( L_STRIP_WRITER *sw, PIX *pix );
+LEPT_DLL extern l_ok stripWriteCloseTiff ( L_STRIP_WRITER *sw, l_int32 finish );
 LEPT_DLL extern l_int32 setMsgSeverity ( l_int32 newsev );
 LEPT_DLL extern l_int32 returnErrorInt ( const char *msg, const char *procname, l_int32 ival );
 LEPT_DLL extern l_float32 returnErrorFloat ( const char *msg, const char *procname, l_float32 fval );
@@ -2693,7 +2818,9 @@ LEPT_DLL extern PIX * pixStereoFromPair ( PIX *pix1, PIX *pix2, l_float32 rwt, l
 LEPT_DLL extern L_WSHED * wshedCreate ( PIX *pixs, PIX *pixm, l_int32 mindepth, l_int32 debugflag );
 LEPT_DLL extern void wshedDestroy ( L_WSHED **pwshed );
 LEPT_DLL extern l_ok wshedApply ( L_WSHED *wshed );
+LEPT_DLL extern l_ok wshedSetLabelsOnly ( L_WSHED *wshed, l_int32 flag );
 LEPT_DLL extern l_ok wshedBasins ( L_WSHED *wshed, PIXA **ppixa, NUMA **pnalevels );
+LEPT_DLL extern PIX * wshedLabels ( L_WSHED *wshed );
 LEPT_DLL extern PIX * wshedRenderFill ( L_WSHED *wshed );
 LEPT_DLL extern PIX * wshedRenderColors ( L_WSHED *wshed );
 LEPT_DLL extern l_ok pixaWriteWebPAnim ( const char *filename, PIXA *pixa, l_int32 loopcount, l_int32 duration, l_int32 quality, l_int32 lossless );
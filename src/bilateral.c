@@ -37,6 +37,11 @@
  *          static void         *bilateralDestroy()
  *          static PIX          *bilateralApply()
  *
+ *     Bilateral filtering with a grid
+ *          PIX                 *pixBilateralGrid()
+ *          PIX                 *pixBilateralGridGray()
+ *          static void          bilateralGridBlur()
+ *
  *     Slow, exact implementation of grayscale or color bilateral filtering
  *          PIX                 *pixBilateralExact()
  *          PIX                 *pixBilateralGrayExact()
@@ -73,6 +78,7 @@
  * </pre>
  */
 
+#include <string.h>
 #include <math.h>
 #include "allheaders.h"
 #include "bilateral.h"
@@ -82,6 +88,11 @@ static L_BILATERAL *bilateralCreate(PIX *pixs, l_float32 spatial_stdev,
                                     l_int32 reduction);
 static PIX *bilateralApply(L_BILATERAL *bil);
 static void bilateralDestroy(L_BILATERAL **pbil);
+    /* Max size of the grid used in pixBilateralGridGray(), in bytes */
+static const size_t  MaxGridBytes = 1 << 30;  /* 1 GB */
+
+static void bilateralGridBlur(l_float32 *grid, l_int32 size, l_int32 n,
+                              l_int32 stride);
 
 
 #ifndef  NO_CONSOLE_IO
@@ -553,6 +564,310 @@ L_BILATERAL  *bil;
 }
 
 
+/*----------------------------------------------------------------------*
+ *                  Bilateral filtering with a grid                     *
+ *----------------------------------------------------------------------*/
+/*!
+ * \brief   pixBilateralGrid()
+ *
+ * \param[in]    pixs            8 bpp gray or 32 bpp rgb, no colormap
+ * \param[in]    spatial_stdev   of gaussian kernel; in pixels, >= 1.0
+ * \param[in]    range_stdev     of gaussian range kernel; >= 2.0
+ * \return  pixd   bilateral filtered image, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This is the bilateral grid of Paris and Durand.  The image is
+ *          embedded in a 3D grid over (x, y, intensity), with cells of
+ *          size %spatial_stdev in x and y, and %range_stdev in intensity.
+ *          Each pixel adds its value and a unit weight to the nearest
+ *          cell.  The grid is smoothed with a gaussian of unit width in
+ *          each direction, and the filtered value of each pixel is the
+ *          ratio of the smoothed sums, interpolated trilinearly at its
+ *          location in the grid.
+ *      (2) The time is proportional to the number of pixels, plus the
+ *          number of grid cells, and does not grow with %spatial_stdev.
+ *          Larger values of either stdev make a smaller grid and a
+ *          faster filter.  The grid holds two floats in each cell, and
+ *          has approximately
+ *              (w / spatial_stdev) * (h / spatial_stdev) *
+ *                  (256 / range_stdev)
+ *          cells.
+ *      (3) The result approximates pixBlockBilateralExact() with the
+ *          same stdevs.  For 32 bpp, each component is filtered
+ *          independently, as with pixBilateralExact().
+ * </pre>
+ */
+PIX *
+pixBilateralGrid(PIX       *pixs,
+                 l_float32  spatial_stdev,
+                 l_float32  range_stdev)
+{
+l_int32  d;
+PIX     *pixt, *pixr, *pixg, *pixb, *pixd;
+
+    PROCNAME("pixBilateralGrid");
+
+    if (!pixs || pixGetColormap(pixs))
+        return (PIX *)ERROR_PTR("pixs not defined or cmapped", procName, NULL);
+    d = pixGetDepth(pixs);
+    if (d != 8 && d != 32)
+        return (PIX *)ERROR_PTR("pixs not 8 or 32 bpp", procName, NULL);
+    if (spatial_stdev < 1.0)
+        return (PIX *)ERROR_PTR("spatial_stdev < 1.0", procName, NULL);
+    if (range_stdev < 2.0)
+        return (PIX *)ERROR_PTR("range_stdev < 2.0", procName, NULL);
+
+    if (d == 8)
+        return pixBilateralGridGray(pixs, spatial_stdev, range_stdev);
+
+    pixt = pixGetRGBComponent(pixs, COLOR_RED);
+    pixr = pixBilateralGridGray(pixt, spatial_stdev, range_stdev);
+    pixDestroy(&pixt);
+    pixt = pixGetRGBComponent(pixs, COLOR_GREEN);
+    pixg = pixBilateralGridGray(pixt, spatial_stdev, range_stdev);
+    pixDestroy(&pixt);
+    pixt = pixGetRGBComponent(pixs, COLOR_BLUE);
+    pixb = pixBilateralGridGray(pixt, spatial_stdev, range_stdev);
+    pixDestroy(&pixt);
+    pixd = pixCreateRGBImage(pixr, pixg, pixb);
+    pixDestroy(&pixr);
+    pixDestroy(&pixg);
+    pixDestroy(&pixb);
+    return pixd;
+}
+
+
+/*!
+ * \brief   pixBilateralGridGray()
+ *
+ * \param[in]    pixs            8 bpp gray
+ * \param[in]    spatial_stdev   of gaussian kernel; in pixels, >= 1.0
+ * \param[in]    range_stdev     of gaussian range kernel; >= 2.0
+ * \return  pixd   8 bpp bilateral filtered image, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) See pixBilateralGrid().
+ *      (2) The grid is indexed by (y, x, z), with z varying fastest,
+ *          so that the two intensity planes used in the interpolation
+ *          for a pixel are adjacent in memory.  A border of 2 cells
+ *          on all sides holds the spread of the smoothing kernel.
+ *      (3) The grid has about 2 * w * h * 256 / (spatial_stdev^2 *
+ *          range_stdev) floats.  An error is returned if it would
+ *          be larger than 1 GB; use a larger %spatial_stdev or
+ *          %range_stdev for very large images.
+ * </pre>
+ */
+PIX *
+pixBilateralGridGray(PIX       *pixs,
+                     l_float32  spatial_stdev,
+                     l_float32  range_stdev)
+{
+l_int32     i, j, k, w, h, gw, gh, gd, wpls, wpld, val, x0, y0, z0;
+l_int32     size, sxy, sy, sz, index;
+l_int32    *nx, *ny, *nz, *fx, *fy, *fz;
+size_t      nbytes;
+l_uint32   *datas, *datad, *lines, *lined;
+l_float32   wx, wy, wz, sumv, sumw;
+l_float32  *grid, *cell, *ax, *ay, *az;
+PIX        *pixd;
+
+    PROCNAME("pixBilateralGridGray");
+
+    if (!pixs || pixGetColormap(pixs))
+        return (PIX *)ERROR_PTR("pixs not defined or cmapped", procName, NULL);
+    if (pixGetDepth(pixs) != 8)
+        return (PIX *)ERROR_PTR("pixs not 8 bpp gray", procName, NULL);
+    if (spatial_stdev < 1.0)
+        return (PIX *)ERROR_PTR("spatial_stdev < 1.0", procName, NULL);
+    if (range_stdev < 2.0)
+        return (PIX *)ERROR_PTR("range_stdev < 2.0", procName, NULL);
+
+        /* Grid dimensions, including a border of 2 cells */
+    pixGetDimensions(pixs, &w, &h, NULL);
+    gw = (l_int32)((w - 1) / spatial_stdev + 0.5) + 5;
+    gh = (l_int32)((h - 1) / spatial_stdev + 0.5) + 5;
+    gd = (l_int32)(255 / range_stdev + 0.5) + 5;
+    nbytes = 2 * (size_t)gw * (size_t)gh * (size_t)gd * sizeof(l_float32);
+    if (nbytes > MaxGridBytes) {
+        L_ERROR("grid of %lu bytes exceeds max of %lu\n", procName,
+                (unsigned long)nbytes, (unsigned long)MaxGridBytes);
+        return NULL;
+    }
+    size = 2 * gw * gh * gd;
+    grid = (l_float32 *)LEPT_CALLOC(size, sizeof(l_float32));
+    if (!grid)
+        return (PIX *)ERROR_PTR("grid not made", procName, NULL);
+    sz = 2;  /* strides in the grid */
+    sxy = 2 * gd;
+    sy = 2 * gd * gw;
+
+        /* For each coordinate: the nearest cell, for splatting, and the
+         * cell below and the interpolation fraction, for slicing */
+    nx = (l_int32 *)LEPT_CALLOC(w, sizeof(l_int32));
+    fx = (l_int32 *)LEPT_CALLOC(w, sizeof(l_int32));
+    ax = (l_float32 *)LEPT_CALLOC(w, sizeof(l_float32));
+    ny = (l_int32 *)LEPT_CALLOC(h, sizeof(l_int32));
+    fy = (l_int32 *)LEPT_CALLOC(h, sizeof(l_int32));
+    ay = (l_float32 *)LEPT_CALLOC(h, sizeof(l_float32));
+    nz = (l_int32 *)LEPT_CALLOC(256, sizeof(l_int32));
+    fz = (l_int32 *)LEPT_CALLOC(256, sizeof(l_int32));
+    az = (l_float32 *)LEPT_CALLOC(256, sizeof(l_float32));
+    for (j = 0; j < w; j++) {
+        nx[j] = (l_int32)(j / spatial_stdev + 0.5) + 2;
+        fx[j] = (l_int32)(j / spatial_stdev);
+        ax[j] = j / spatial_stdev - fx[j];
+        fx[j] += 2;
+    }
+    for (i = 0; i < h; i++) {
+        ny[i] = (l_int32)(i / spatial_stdev + 0.5) + 2;
+        fy[i] = (l_int32)(i / spatial_stdev);
+        ay[i] = i / spatial_stdev - fy[i];
+        fy[i] += 2;
+    }
+    for (k = 0; k < 256; k++) {
+        nz[k] = (l_int32)(k / range_stdev + 0.5) + 2;
+        fz[k] = (l_int32)(k / range_stdev);
+        az[k] = k / range_stdev - fz[k];
+        fz[k] += 2;
+    }
+
+        /* Splat */
+    datas = pixGetData(pixs);
+    wpls = pixGetWpl(pixs);
+    for (i = 0; i < h; i++) {
+        lines = datas + i * wpls;
+        for (j = 0; j < w; j++) {
+            val = GET_DATA_BYTE(lines, j);
+            cell = grid + ny[i] * sy + nx[j] * sxy + nz[val] * sz;
+            cell[0] += val;
+            cell[1] += 1.0;
+        }
+    }
+
+        /* Smooth along each direction */
+    bilateralGridBlur(grid, size, gd, sz);
+    bilateralGridBlur(grid, size, gw, sxy);
+    bilateralGridBlur(grid, size, gh, sy);
+
+        /* Slice */
+    pixd = pixCreateTemplate(pixs);
+    datad = pixGetData(pixd);
+    wpld = pixGetWpl(pixd);
+    for (i = 0; i < h; i++) {
+        lines = datas + i * wpls;
+        lined = datad + i * wpld;
+        y0 = fy[i];
+        wy = ay[i];
+        for (j = 0; j < w; j++) {
+            val = GET_DATA_BYTE(lines, j);
+            x0 = fx[j];
+            z0 = fz[val];
+            wx = ax[j];
+            wz = az[val];
+            index = y0 * sy + x0 * sxy + z0 * sz;
+            cell = grid + index;
+            sumv = (1.0 - wy) * ((1.0 - wx) *
+                       ((1.0 - wz) * cell[0] + wz * cell[sz]) +
+                   wx * ((1.0 - wz) * cell[sxy] + wz * cell[sxy + sz])) +
+                   wy * ((1.0 - wx) *
+                       ((1.0 - wz) * cell[sy] + wz * cell[sy + sz]) +
+                   wx * ((1.0 - wz) * cell[sy + sxy] +
+                         wz * cell[sy + sxy + sz]));
+            cell++;
+            sumw = (1.0 - wy) * ((1.0 - wx) *
+                       ((1.0 - wz) * cell[0] + wz * cell[sz]) +
+                   wx * ((1.0 - wz) * cell[sxy] + wz * cell[sxy + sz])) +
+                   wy * ((1.0 - wx) *
+                       ((1.0 - wz) * cell[sy] + wz * cell[sy + sz]) +
+                   wx * ((1.0 - wz) * cell[sy + sxy] +
+                         wz * cell[sy + sxy + sz]));
+            if (sumw > 0.0) {
+                val = (l_int32)(sumv / sumw + 0.5);
+                val = L_MIN(255, L_MAX(0, val));
+            }
+            SET_DATA_BYTE(lined, j, val);
+        }
+    }
+
+    LEPT_FREE(grid);
+    LEPT_FREE(nx);
+    LEPT_FREE(fx);
+    LEPT_FREE(ax);
+    LEPT_FREE(ny);
+    LEPT_FREE(fy);
+    LEPT_FREE(ay);
+    LEPT_FREE(nz);
+    LEPT_FREE(fz);
+    LEPT_FREE(az);
+    return pixd;
+}
+
+
+/*!
+ * \brief   bilateralGridBlur()
+ *
+ * \param[in]    grid      bilateral grid, with 2 floats in each cell
+ * \param[in]    size      total number of floats in the grid
+ * \param[in]    n         number of cells in the direction of smoothing
+ * \param[in]    stride    number of floats between adjacent cells
+ *                         in the direction of smoothing
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) This smooths both floats in each cell along one direction,
+ *          with the 5-tap binomial kernel (1 4 6 4 1) / 16, which
+ *          approximates a gaussian with unit standard deviation.
+ *          Cells outside the grid are taken as 0.
+ *      (2) The grid is a sequence of blocks of %n rows, each with
+ *          %stride floats, where the rows are the cells along the
+ *          direction of smoothing.  The rows of each block are
+ *          smoothed in place, saving the original values of the
+ *          two previous rows.
+ * </pre>
+ */
+static void
+bilateralGridBlur(l_float32  *grid,
+                  l_int32     size,
+                  l_int32     n,
+                  l_int32     stride)
+{
+l_int32     i, k, b, nblocks;
+l_float32   sum;
+l_float32  *row, *next1, *next2, *prev1, *prev2, *cur, *tmp;
+
+    nblocks = size / (n * stride);
+    prev1 = (l_float32 *)LEPT_CALLOC(stride, sizeof(l_float32));
+    prev2 = (l_float32 *)LEPT_CALLOC(stride, sizeof(l_float32));
+    cur = (l_float32 *)LEPT_CALLOC(stride, sizeof(l_float32));
+    for (b = 0; b < nblocks; b++) {
+        memset(prev1, 0, stride * sizeof(l_float32));
+        memset(prev2, 0, stride * sizeof(l_float32));
+        for (k = 0; k < n; k++) {
+            row = grid + (b * n + k) * stride;
+            next1 = (k + 1 < n) ? row + stride : NULL;
+            next2 = (k + 2 < n) ? row + 2 * stride : NULL;
+            memcpy(cur, row, stride * sizeof(l_float32));
+            for (i = 0; i < stride; i++) {
+                sum = 0.375 * cur[i] + 0.25 * prev1[i] + 0.0625 * prev2[i];
+                if (next1) sum += 0.25 * next1[i];
+                if (next2) sum += 0.0625 * next2[i];
+                row[i] = sum;
+            }
+            tmp = prev2;
+            prev2 = prev1;
+            prev1 = cur;
+            cur = tmp;
+        }
+    }
+    LEPT_FREE(prev1);
+    LEPT_FREE(prev2);
+    LEPT_FREE(cur);
+}
+
+
 /*----------------------------------------------------------------------*
  *    Exact implementation of grayscale or color bilateral filtering    *
  *----------------------------------------------------------------------*/
@@ -49,8 +49,7 @@
  *      Sauvola local thresholding
  *          l_int32       pixSauvolaBinarizeTiled()
  *          l_int32       pixSauvolaBinarize()
- *          static PIX   *pixSauvolaGetThreshold()
- *          static PIX   *pixApplyLocalThreshold();
+ *          static l_int32  pixSauvolaThresholdByRow()
  *
  *      Thresholding using connected components
  *          PIX          *pixThresholdByConnComp()
@@ -78,9 +77,9 @@
 #include <math.h>
 #include "allheaders.h"
 
-static PIX *pixSauvolaGetThreshold(PIX *pixm, PIX *pixms, l_float32 factor,
-                                   PIX **ppixsd);
-static PIX *pixApplyLocalThreshold(PIX *pixs, PIX *pixth);
+static l_int32 pixSauvolaThresholdByRow(PIX *pixg, l_int32 whsize,
+                                        l_float32 factor, PIX *pixm,
+                                        PIX *pixsd, PIX *pixth, PIX *pixd);
 
 /*------------------------------------------------------------------*
  *                 Adaptive Otsu-based thresholding                 *
@@ -604,8 +603,8 @@ pixSauvolaBinarize(PIX       *pixs,
                    PIX      **ppixth,
                    PIX      **ppixd)
 {
-l_int32  w, h;
-PIX     *pixg, *pixsc, *pixm, *pixms, *pixth, *pixd;
+l_int32  w, h, ret;
+PIX     *pixg, *pixm, *pixsd, *pixth, *pixd;
 
     PROCNAME("pixSauvolaBinarize");
 
@@ -630,55 +629,64 @@ PIX     *pixg, *pixsc, *pixm, *pixms, *pixth, *pixd;
     if (addborder) {
         pixg = pixAddMirroredBorder(pixs, whsize + 1, whsize + 1,
                                     whsize + 1, whsize + 1);
-        pixsc = pixClone(pixs);
     } else {
         pixg = pixClone(pixs);
-        pixsc = pixRemoveBorder(pixs, whsize + 1);
+        w -= 2 * (whsize + 1);
+        h -= 2 * (whsize + 1);
     }
-    if (!pixg || !pixsc)
-        return ERROR_INT("pixg and pixsc not made", procName, 1);
-
-        /* All these functions strip off the border pixels. */
-    if (ppixm || ppixth || ppixd)
-        pixm = pixWindowedMean(pixg, whsize, whsize, 1, 1);
-    if (ppixsd || ppixth || ppixd)
-        pixms = pixWindowedMeanSquare(pixg, whsize, whsize, 1);
-    if (ppixth || ppixd)
-        pixth = pixSauvolaGetThreshold(pixm, pixms, factor, ppixsd);
-    if (ppixd) {
-        pixd = pixApplyLocalThreshold(pixsc, pixth);
-        pixCopyResolution(pixd, pixs);
-    }
-
-    if (ppixm)
-        *ppixm = pixm;
-    else
+    if (!pixg)
+        return ERROR_INT("pixg not made", procName, 1);
+
+        /* Make only the requested outputs; these are all of the size
+         * of pixs with the border pixels stripped off. */
+    pixm = (ppixm) ? pixCreate(w, h, 8) : NULL;
+    pixsd = (ppixsd) ? pixCreate(w, h, 8) : NULL;
+    pixth = (ppixth) ? pixCreate(w, h, 8) : NULL;
+    pixd = (ppixd) ? pixCreate(w, h, 1) : NULL;
+    if (pixd) pixCopyResolution(pixd, pixs);
+    ret = pixSauvolaThresholdByRow(pixg, whsize, factor, pixm, pixsd,
+                                   pixth, pixd);
+    pixDestroy(&pixg);
+    if (ret) {
         pixDestroy(&pixm);
-    pixDestroy(&pixms);
-    if (ppixth)
-        *ppixth = pixth;
-    else
+        pixDestroy(&pixsd);
         pixDestroy(&pixth);
-    if (ppixd)
-        *ppixd = pixd;
-    pixDestroy(&pixg);
-    pixDestroy(&pixsc);
+        pixDestroy(&pixd);
+        return ERROR_INT("sauvola threshold failed", procName, 1);
+    }
+
+    if (ppixm) *ppixm = pixm;
+    if (ppixsd) *ppixsd = pixsd;
+    if (ppixth) *ppixth = pixth;
+    if (ppixd) *ppixd = pixd;
     return 0;
 }
 
 
 /*!
- * \brief   pixSauvolaGetThreshold()
+ * \brief   pixSauvolaThresholdByRow()
  *
- * \param[in]    pixm     8 bpp grayscale; not colormapped
- * \param[in]    pixms    32 bpp
+ * \param[in]    pixg     8 bpp grayscale, with border of (%whsize + 1)
+ * \param[in]    whsize   window half-width for measuring local statistics
  * \param[in]    factor   factor for reducing threshold due to variance; >= 0
- * \param[out]   ppixsd   [optional] local standard deviation
- * \return  pixd   8 bpp, sauvola threshold values, or NULL on error
+ * \param[in]    pixm     [optional] 8 bpp; local mean values
+ * \param[in]    pixsd    [optional] 8 bpp; local standard deviation
+ * \param[in]    pixth    [optional] 8 bpp; threshold values
+ * \param[in]    pixd     [optional] 1 bpp; thresholded image
+ * \return  0 if OK, 1 on error
  *
  * <pre>
  * Notes:
- *      (1) The Sauvola threshold is determined from the formula:
+ *      (1) The non-null dest pix are made by the caller, with the size
+ *          of pixg with the border removed, and are filled in here.
+ *      (2) The window sums and sums of squares are found a row at a
+ *          time from running sums down each column of pixg, and the
+ *          threshold is applied to each row as soon as it is found.
+ *          Except for the requested outputs, the memory used is a few
+ *          rows, instead of full accumulator arrays for the mean and
+ *          mean square.  The values are identical to those from
+ *          pixWindowedMean() and pixWindowedMeanSquare().
+ *      (3) The Sauvola threshold is determined from the formula:
  *            t = m * (1 - k * (1 - s / 128))
  *          where:
  *            t = local threshold
@@ -686,8 +694,7 @@ PIX     *pixg, *pixsc, *pixm, *pixms, *pixth, *pixd;
  *            k = %factor (>= 0)   [ typ. 0.35 ]
  *            s = local standard deviation, which is maximized at
  *                127.5 when half the samples are 0 and half are 255.
- *      (2) See pixSauvolaBinarize() for other details.
- *      (3) Important definitions and relations for computing averages:
+ *      (4) Important definitions and relations for computing averages:
  *            v == pixel value
  *            E(p) == expected value of p == average of p over some pixel set
  *            S(v) == square of v == v * v
@@ -704,126 +711,108 @@ PIX     *pixg, *pixsc, *pixm, *pixms, *pixth, *pixd;
  *            s = sqrt(ms - mv * mv)
  * </pre>
  */
-static PIX *
-pixSauvolaGetThreshold(PIX       *pixm,
-                       PIX       *pixms,
-                       l_float32  factor,
-                       PIX      **ppixsd)
+static l_int32
+pixSauvolaThresholdByRow(PIX       *pixg,
+                         l_int32    whsize,
+                         l_float32  factor,
+                         PIX       *pixm,
+                         PIX       *pixsd,
+                         PIX       *pixth,
+                         PIX       *pixd)
 {
-l_int32     i, j, w, h, tabsize, wplm, wplms, wplsd, wpld, usetab;
+l_int32     i, j, w, h, wg, hg, wplg, wincr, bord, val1, val2;
 l_int32     mv, ms, var, thresh;
-l_uint32   *datam, *datams, *datasd, *datad;
-l_uint32   *linem, *linems, *linesd, *lined;
-l_float32   sd;
-l_float32  *tab;  /* of 2^16 square roots */
-PIX        *pixsd, *pixd;
-
-    PROCNAME("pixSauvolaGetThreshold");
-
-    if (ppixsd) *ppixsd = NULL;
-    if (!pixm || pixGetDepth(pixm) != 8)
-        return (PIX *)ERROR_PTR("pixm undefined or not 8 bpp", procName, NULL);
-    if (pixGetColormap(pixm))
-        return (PIX *)ERROR_PTR("pixm is colormapped", procName, NULL);
-    if (!pixms || pixGetDepth(pixms) != 32)
-        return (PIX *)ERROR_PTR("pixms undefined or not 32 bpp",
-                                procName, NULL);
+l_uint8     valt;
+l_uint32    sum;
+l_uint32   *datag, *lineg, *lineg1, *lineg2, *lines;
+l_uint32   *linem, *linesd, *lineth, *lined;
+l_uint32   *colsum;
+l_float32   norm, sd;
+l_float64   normsq, sumsq;
+l_float64  *colsq;
+
+    PROCNAME("pixSauvolaThresholdByRow");
+
+    if (!pixg || pixGetDepth(pixg) != 8)
+        return ERROR_INT("pixg undefined or not 8 bpp", procName, 1);
     if (factor < 0.0)
-        return (PIX *)ERROR_PTR("factor must be >= 0", procName, NULL);
-
-        /* Only make a table of 2^16 square roots if there
-         * are enough pixels to justify it. */
-    pixGetDimensions(pixm, &w, &h, NULL);
-    usetab = (w * h > 100000) ? 1 : 0;
-    if (usetab) {
-        tabsize = 1 << 16;
-        tab = (l_float32 *)LEPT_CALLOC(tabsize, sizeof(l_float32));
-        for (i = 0; i < tabsize; i++)
-            tab[i] = sqrtf((l_float32)i);
-    }
+        return ERROR_INT("factor must be >= 0", procName, 1);
 
-    pixd = pixCreate(w, h, 8);
-    if (ppixsd) {
-        pixsd = pixCreate(w, h, 8);
-        *ppixsd = pixsd;
+    pixGetDimensions(pixg, &wg, &hg, NULL);
+    bord = whsize + 1;
+    w = wg - 2 * bord;
+    h = hg - 2 * bord;
+    wincr = 2 * whsize + 1;
+    norm = 1.0 / ((l_float32)(wincr) * wincr);
+    normsq = 1.0 / ((l_float32)(wincr) * wincr);
+    datag = pixGetData(pixg);
+    wplg = pixGetWpl(pixg);
+    colsum = (l_uint32 *)LEPT_CALLOC(wg, sizeof(l_uint32));
+    colsq = (l_float64 *)LEPT_CALLOC(wg, sizeof(l_float64));
+    if (!colsum || !colsq) {
+        LEPT_FREE(colsum);
+        LEPT_FREE(colsq);
+        return ERROR_INT("column sum arrays not made", procName, 1);
     }
-    datam = pixGetData(pixm);
-    datams = pixGetData(pixms);
-    if (ppixsd) datasd = pixGetData(pixsd);
-    datad = pixGetData(pixd);
-    wplm = pixGetWpl(pixm);
-    wplms = pixGetWpl(pixms);
-    if (ppixsd) wplsd = pixGetWpl(pixsd);
-    wpld = pixGetWpl(pixd);
-    for (i = 0; i < h; i++) {
-        linem = datam + i * wplm;
-        linems = datams + i * wplms;
-        if (ppixsd) linesd = datasd + i * wplsd;
-        lined = datad + i * wpld;
-        for (j = 0; j < w; j++) {
-            mv = GET_DATA_BYTE(linem, j);
-            ms = linems[j];
-            var = ms - mv * mv;
-            if (usetab)
-                sd = tab[var];
-            else
-                sd = sqrtf((l_float32)var);
-            if (ppixsd) SET_DATA_BYTE(linesd, j, (l_int32)sd);
-            thresh = (l_int32)(mv * (1.0 - factor * (1.0 - sd / 128.)));
-            SET_DATA_BYTE(lined, j, thresh);
+
+        /* The window for pixel (i, j) covers rows (i + 1 ... i + wincr)
+         * and columns (j + 1 ... j + wincr) of pixg.  Start the
+         * column sums with rows (1 ... wincr). */
+    for (i = 1; i <= wincr; i++) {
+        lineg = datag + i * wplg;
+        for (j = 0; j < wg; j++) {
+            val1 = GET_DATA_BYTE(lineg, j);
+            colsum[j] += val1;
+            colsq[j] += (l_float64)(val1 * val1);
         }
     }
 
-    if (usetab) LEPT_FREE(tab);
-    return pixd;
-}
-
-
-/*!
- * \brief   pixApplyLocalThreshold()
- *
- * \param[in]    pixs     8 bpp grayscale; not colormapped
- * \param[in]    pixth    8 bpp array of local thresholds
- * \return  pixd   1 bpp, thresholded image, or NULL on error
- */
-static PIX *
-pixApplyLocalThreshold(PIX     *pixs,
-                       PIX     *pixth)
-{
-l_int32    i, j, w, h, wpls, wplt, wpld, vals, valt;
-l_uint32  *datas, *datat, *datad, *lines, *linet, *lined;
-PIX       *pixd;
-
-    PROCNAME("pixApplyLocalThreshold");
-
-    if (!pixs || pixGetDepth(pixs) != 8)
-        return (PIX *)ERROR_PTR("pixs undefined or not 8 bpp", procName, NULL);
-    if (pixGetColormap(pixs))
-        return (PIX *)ERROR_PTR("pixs is colormapped", procName, NULL);
-    if (!pixth || pixGetDepth(pixth) != 8)
-        return (PIX *)ERROR_PTR("pixth undefined or not 8 bpp", procName, NULL);
-
-    pixGetDimensions(pixs, &w, &h, NULL);
-    pixd = pixCreate(w, h, 1);
-    datas = pixGetData(pixs);
-    datat = pixGetData(pixth);
-    datad = pixGetData(pixd);
-    wpls = pixGetWpl(pixs);
-    wplt = pixGetWpl(pixth);
-    wpld = pixGetWpl(pixd);
     for (i = 0; i < h; i++) {
-        lines = datas + i * wpls;
-        linet = datat + i * wplt;
-        lined = datad + i * wpld;
+        if (i > 0) {  /* move the column sums down by one row */
+            lineg1 = datag + i * wplg;
+            lineg2 = datag + (i + wincr) * wplg;
+            for (j = 0; j < wg; j++) {
+                val1 = GET_DATA_BYTE(lineg1, j);
+                val2 = GET_DATA_BYTE(lineg2, j);
+                colsum[j] += val2 - val1;
+                colsq[j] += (l_float64)(val2 * val2 - val1 * val1);
+            }
+        }
+
+        lines = datag + (i + bord) * wplg;  /* source pixels, for pixd */
+        if (pixm) linem = pixGetData(pixm) + i * pixGetWpl(pixm);
+        if (pixsd) linesd = pixGetData(pixsd) + i * pixGetWpl(pixsd);
+        if (pixth) lineth = pixGetData(pixth) + i * pixGetWpl(pixth);
+        if (pixd) lined = pixGetData(pixd) + i * pixGetWpl(pixd);
+        sum = 0;
+        sumsq = 0.0;
+        for (j = 1; j <= wincr; j++) {
+            sum += colsum[j];
+            sumsq += colsq[j];
+        }
         for (j = 0; j < w; j++) {
-            vals = GET_DATA_BYTE(lines, j);
-            valt = GET_DATA_BYTE(linet, j);
-            if (vals < valt)
+            if (j > 0) {
+                sum += colsum[j + wincr] - colsum[j];
+                sumsq += colsq[j + wincr] - colsq[j];
+            }
+            mv = (l_uint8)(norm * sum);
+            if (pixm) SET_DATA_BYTE(linem, j, mv);
+            if (!pixsd && !pixth && !pixd) continue;
+            ms = (l_uint32)(normsq * sumsq + 0.5);  /* to round up */
+            var = ms - mv * mv;
+            sd = sqrtf((l_float32)var);
+            if (pixsd) SET_DATA_BYTE(linesd, j, (l_int32)sd);
+            thresh = (l_int32)(mv * (1.0 - factor * (1.0 - sd / 128.)));
+            valt = (l_uint8)thresh;  /* as stored in pixth */
+            if (pixth) SET_DATA_BYTE(lineth, j, valt);
+            if (pixd && GET_DATA_BYTE(lines, j + bord) < valt)
                 SET_DATA_BIT(lined, j);
         }
     }
 
-    return pixd;
+    LEPT_FREE(colsum);
+    LEPT_FREE(colsq);
+    return 0;
 }
 
 
@@ -34,22 +34,15 @@
  *      Special case: power of 2 replicated expansion
  *         PIX     *pixExpandBinaryPower2()
  *
- *      Expansion tables for power of 2 expansion
- *         static l_uint16    *makeExpandTab2x()
- *         static l_uint32    *makeExpandTab4x()
- *         static l_uint32    *makeExpandTab8x()
+ *      Bit expansion for power of 2 expansion
+ *         static l_uint32     expandBitsPower2()
  * </pre>
  */
 
 #include <string.h>
 #include "allheaders.h"
 
-    /* Static table functions and tables */
-static l_uint16 * makeExpandTab2x(void);
-static l_uint32 * makeExpandTab4x(void);
-static l_uint32 * makeExpandTab8x(void);
-static  l_uint32 expandtab16[] = {
-              0x00000000, 0x0000ffff, 0xffff0000, 0xffffffff};
+static l_uint32 expandBitsPower2(l_uint32 val, l_int32 factor);
 
 
 /*------------------------------------------------------------------*
@@ -127,15 +120,25 @@ PIX       *pixd;
  * \param[in]    pixs      1 bpp
  * \param[in]    factor    expansion factor: 1, 2, 4, 8, 16
  * \return  pixd expanded 1 bpp by replication, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) Each 32-bit src word is expanded to %factor dest words on
+ *          the first of each set of %factor dest lines, which are then
+ *          replicated.  The bits are spread with masked shifts on
+ *          the full word (a parallel bit deposit), so no lookup
+ *          tables are required.
+ *      (2) Src pixels beyond the image width are not expanded, so the
+ *          dest padding bits are 0.
+ * </pre>
  */
 PIX *
 pixExpandBinaryPower2(PIX     *pixs,
                       l_int32  factor)
 {
-l_uint8    sval;
-l_uint16  *tab2;
-l_int32    i, j, k, w, h, d, wd, hd, wpls, wpld, sdibits, sqbits, sbytes;
-l_uint32  *datas, *datad, *lines, *lined, *tab4, *tab8;
+l_int32    i, j, k, m, w, h, d, wd, hd, wpls, wpld, nswords, jd;
+l_uint32   sword, lastmask;
+l_uint32  *datas, *datad, *lines, *lined;
 PIX       *pixd;
 
     PROCNAME("pixExpandBinaryPower2");
@@ -160,61 +163,25 @@ PIX       *pixd;
     pixScaleResolution(pixd, (l_float32)factor, (l_float32)factor);
     wpld = pixGetWpl(pixd);
     datad = pixGetData(pixd);
-    if (factor == 2) {
-        tab2 = makeExpandTab2x();
-        sbytes = (w + 7) / 8;
-        for (i = 0; i < h; i++) {
-            lines = datas + i * wpls;
-            lined = datad + 2 * i * wpld;
-            for (j = 0; j < sbytes; j++) {
-                sval = GET_DATA_BYTE(lines, j);
-                SET_DATA_TWO_BYTES(lined, j, tab2[sval]);
-            }
-            memcpy(lined + wpld, lined, 4 * wpld);
-        }
-        LEPT_FREE(tab2);
-    } else if (factor == 4) {
-        tab4 = makeExpandTab4x();
-        sbytes = (w + 7) / 8;
-        for (i = 0; i < h; i++) {
-            lines = datas + i * wpls;
-            lined = datad + 4 * i * wpld;
-            for (j = 0; j < sbytes; j++) {
-                sval = GET_DATA_BYTE(lines, j);
-                lined[j] = tab4[sval];
-            }
-            for (k = 1; k < 4; k++)
-                memcpy(lined + k * wpld, lined, 4 * wpld);
-        }
-        LEPT_FREE(tab4);
-    } else if (factor == 8) {
-        tab8 = makeExpandTab8x();
-        sqbits = (w + 3) / 4;
-        for (i = 0; i < h; i++) {
-            lines = datas + i * wpls;
-            lined = datad + 8 * i * wpld;
-            for (j = 0; j < sqbits; j++) {
-                sval = GET_DATA_QBIT(lines, j);
-                if (sval > 15)
-                    L_WARNING("sval = %d; should be < 16\n", procName, sval);
-                lined[j] = tab8[sval];
-            }
-            for (k = 1; k < 8; k++)
-                memcpy(lined + k * wpld, lined, 4 * wpld);
-        }
-        LEPT_FREE(tab8);
-    } else {  /* factor == 16 */
-        sdibits = (w + 1) / 2;
-        for (i = 0; i < h; i++) {
-            lines = datas + i * wpls;
-            lined = datad + 16 * i * wpld;
-            for (j = 0; j < sdibits; j++) {
-                sval = GET_DATA_DIBIT(lines, j);
-                lined[j] = expandtab16[sval];
+
+    nswords = (w + 31) / 32;
+    lastmask = (w & 31) ? ~(0xffffffff >> (w & 31)) : 0xffffffff;
+    for (i = 0; i < h; i++) {
+        lines = datas + i * wpls;
+        lined = datad + factor * i * wpld;
+        for (j = 0, jd = 0; j < nswords; j++) {
+            sword = lines[j];
+            if (j == nswords - 1)
+                sword &= lastmask;
+            for (m = 32 - 32 / factor; m >= 0 && jd < wpld;
+                 m -= 32 / factor, jd++) {
+                if (sword == 0)  /* dest is already cleared */
+                    continue;
+                lined[jd] = expandBitsPower2(sword >> m, factor);
             }
-            for (k = 1; k < 16; k++)
-                memcpy(lined + k * wpld, lined, 4 * wpld);
         }
+        for (k = 1; k < factor; k++)
+            memcpy(lined + k * wpld, lined, 4 * wpld);
     }
 
     return pixd;
@@ -222,82 +189,51 @@ PIX       *pixd;
 
 
 /*-------------------------------------------------------------------*
- *             Expansion tables for 2x, 4x and 8x expansion          *
+ *              Bit expansion for 2x, 4x, 8x and 16x                 *
  *-------------------------------------------------------------------*/
-static l_uint16 *
-makeExpandTab2x(void)
-{
-l_uint16  *tab;
-l_int32    i;
-
-    tab = (l_uint16 *) LEPT_CALLOC(256, sizeof(l_uint16));
-    for (i = 0; i < 256; i++) {
-        if (i & 0x01)
-            tab[i] = 0x3;
-        if (i & 0x02)
-            tab[i] |= 0xc;
-        if (i & 0x04)
-            tab[i] |= 0x30;
-        if (i & 0x08)
-            tab[i] |= 0xc0;
-        if (i & 0x10)
-            tab[i] |= 0x300;
-        if (i & 0x20)
-            tab[i] |= 0xc00;
-        if (i & 0x40)
-            tab[i] |= 0x3000;
-        if (i & 0x80)
-            tab[i] |= 0xc000;
-    }
-    return tab;
-}
-
-
-static l_uint32 *
-makeExpandTab4x(void)
-{
-l_uint32  *tab;
-l_int32    i;
-
-    tab = (l_uint32 *) LEPT_CALLOC(256, sizeof(l_uint32));
-    for (i = 0; i < 256; i++) {
-        if (i & 0x01)
-            tab[i] = 0xf;
-        if (i & 0x02)
-            tab[i] |= 0xf0;
-        if (i & 0x04)
-            tab[i] |= 0xf00;
-        if (i & 0x08)
-            tab[i] |= 0xf000;
-        if (i & 0x10)
-            tab[i] |= 0xf0000;
-        if (i & 0x20)
-            tab[i] |= 0xf00000;
-        if (i & 0x40)
-            tab[i] |= 0xf000000;
-        if (i & 0x80)
-            tab[i] |= 0xf0000000;
-    }
-    return tab;
-}
-
-
-static l_uint32 *
-makeExpandTab8x(void)
+/*!
+ * \brief   expandBitsPower2()
+ *
+ * \param[in]    val       the 32 / %factor low-order bits are expanded
+ * \param[in]    factor    2, 4, 8 or 16
+ * \return  32-bit word with each input bit replicated %factor times
+ *
+ * <pre>
+ * Notes:
+ *      (1) The bits are spread out to every %factor bit position with
+ *          masked shifts, and then filled in by multiplication, which
+ *          can't carry because the replicated bits don't overlap.
+ * </pre>
+ */
+static l_uint32
+expandBitsPower2(l_uint32  val,
+                 l_int32   factor)
 {
-l_uint32  *tab;
-l_int32    i;
-
-    tab = (l_uint32 *) LEPT_CALLOC(16, sizeof(l_uint32));
-    for (i = 0; i < 16; i++) {
-        if (i & 0x01)
-            tab[i] = 0xff;
-        if (i & 0x02)
-            tab[i] |= 0xff00;
-        if (i & 0x04)
-            tab[i] |= 0xff0000;
-        if (i & 0x08)
-            tab[i] |= 0xff000000;
+    switch (factor)
+    {
+    case 2:
+        val &= 0xffff;
+        val = (val | (val << 8)) & 0x00ff00ff;
+        val = (val | (val << 4)) & 0x0f0f0f0f;
+        val = (val | (val << 2)) & 0x33333333;
+        val = (val | (val << 1)) & 0x55555555;
+        return val * 0x3;
+    case 4:
+        val &= 0xff;
+        val = (val | (val << 12)) & 0x000f000f;
+        val = (val | (val << 6)) & 0x03030303;
+        val = (val | (val << 3)) & 0x11111111;
+        return val * 0xf;
+    case 8:
+        val &= 0xf;
+        val = (val | (val << 14)) & 0x00030003;
+        val = (val | (val << 7)) & 0x01010101;
+        return val * 0xff;
+    case 16:
+        val &= 0x3;
+        val = (val | (val << 15)) & 0x00010001;
+        return val * 0xffff;
+    default:
+        return 0;
     }
-    return tab;
 }
@@ -37,12 +37,17 @@
  *
  *      Permutation table for 2x rank binary reduction
  *           l_uint8  *makeSubsampleTab2x(void)
+ *
+ *      Low-level 2x subsampling of a word
+ *           static l_uint16  subsampleWord2x()
  * </pre>
  */
 
 #include <string.h>
 #include "allheaders.h"
 
+static l_uint16 subsampleWord2x(l_uint32 word);
+
 
 /*------------------------------------------------------------------*
  *                       Subsampled reduction                       *
@@ -51,29 +56,22 @@
  * \brief   pixReduceBinary2()
  *
  * \param[in]    pixs
- * \param[in]    intab   [optional]; if null, a table is made here
- *                       and destroyed before exit
+ * \param[in]    intab   [unused]; can be null
  * \return  pixd 2x subsampled, or NULL on error
  *
  * <pre>
  * Notes:
- *      (1) After folding, the data is in bytes 0 and 2 of the word,
- *          and the bits in each byte are in the following order
- *          (with 0 being the leftmost originating pair and 7 being
- *          the rightmost originating pair):
- *               0 4 1 5 2 6 3 7
- *          These need to be permuted to
- *               0 1 2 3 4 5 6 7
- *          which is done with an 8-bit table generated by makeSubsampleTab2x().
+ *      (1) The pixels in the even columns of each 32-bit src word are
+ *          gathered into 16 contiguous bits with subsampleWord2x().
+ *          This is done with masked shifts on the full word, so
+ *          the permutation table from makeSubsampleTab2x() is no
+ *          longer required.  %intab is kept for compatibility.
  * </pre>
  */
 PIX *
 pixReduceBinary2(PIX      *pixs,
                  l_uint8  *intab)
 {
-l_uint8    byte0, byte1;
-l_uint8   *tab;
-l_uint16   shortd;
 l_int32    i, id, j, ws, hs, wpls, wpld, wplsi;
 l_uint32   word;
 l_uint32  *datas, *datad, *lines, *lined;
@@ -97,12 +95,6 @@ PIX       *pixd;
     wpld = pixGetWpl(pixd);
     datad = pixGetData(pixd);
 
-    tab = (intab) ? intab : makeSubsampleTab2x();
-    if (!tab) {
-        pixDestroy(&pixd);
-        return (PIX *)ERROR_PTR("tab not made", procName, NULL);
-    }
-
         /* e.g., if ws = 65: wd = 32, wpls = 3, wpld = 1 --> trouble */
     wplsi = L_MIN(wpls, 2 * wpld);  /* iterate over this number of words */
 
@@ -111,16 +103,10 @@ PIX       *pixd;
         lined = datad + id * wpld;
         for (j = 0; j < wplsi; j++) {
             word = *(lines + j);
-            word = word & 0xaaaaaaaa;  /* mask */
-            word = word | (word << 7);  /* fold; data in bytes 0 & 2 */
-            byte0 = word >> 24;
-            byte1 = (word >> 8) & 0xff;
-            shortd = (tab[byte0] << 8) | tab[byte1];
-            SET_DATA_TWO_BYTES(lined, j, shortd);
+            SET_DATA_TWO_BYTES(lined, j, subsampleWord2x(word));
         }
     }
 
-    if (!intab) LEPT_FREE(tab);
     return pixd;
 }
 
@@ -151,8 +137,7 @@ pixReduceRankBinaryCascade(PIX     *pixs,
                            l_int32  level3,
                            l_int32  level4)
 {
-PIX      *pix1, *pix2, *pix3, *pix4;
-l_uint8  *tab;
+PIX  *pix1, *pix2, *pix3, *pix4;
 
     PROCNAME("pixReduceRankBinaryCascade");
 
@@ -168,32 +153,22 @@ l_uint8  *tab;
         return pixCopy(NULL, pixs);
     }
 
-    if ((tab = makeSubsampleTab2x()) == NULL)
-        return (PIX *)ERROR_PTR("tab not made", procName, NULL);
-
-    pix1 = pixReduceRankBinary2(pixs, level1, tab);
-    if (level2 <= 0) {
-        LEPT_FREE(tab);
+    pix1 = pixReduceRankBinary2(pixs, level1, NULL);
+    if (level2 <= 0)
         return pix1;
-    }
 
-    pix2 = pixReduceRankBinary2(pix1, level2, tab);
+    pix2 = pixReduceRankBinary2(pix1, level2, NULL);
     pixDestroy(&pix1);
-    if (level3 <= 0) {
-        LEPT_FREE(tab);
+    if (level3 <= 0)
         return pix2;
-    }
 
-    pix3 = pixReduceRankBinary2(pix2, level3, tab);
+    pix3 = pixReduceRankBinary2(pix2, level3, NULL);
     pixDestroy(&pix2);
-    if (level4 <= 0) {
-        LEPT_FREE(tab);
+    if (level4 <= 0)
         return pix3;
-    }
 
-    pix4 = pixReduceRankBinary2(pix3, level4, tab);
+    pix4 = pixReduceRankBinary2(pix3, level4, NULL);
     pixDestroy(&pix3);
-    LEPT_FREE(tab);
     return pix4;
 }
 
@@ -203,8 +178,7 @@ l_uint8  *tab;
  *
  * \param[in]    pixs    1 bpp
  * \param[in]    level   rank threshold: 1, 2, 3, 4
- * \param[in]    intab   [optional]; if null, a table is made here
- *                       and destroyed before exit
+ * \param[in]    intab   [unused]; can be null
  * \return  pixd   1 bpp, 2x rank threshold reduced, or NULL on error
  *
  * <pre>
@@ -217,6 +191,7 @@ l_uint8  *tab;
  *          using only logical operations.  Then these pixels are chosen
  *          in the 2x subsampling process, subsampled, as described
  *          above in pixReduceBinary2().
+ *      (4) %intab is kept for compatibility; it is not used.
  * </pre>
  */
 PIX *
@@ -224,9 +199,6 @@ pixReduceRankBinary2(PIX      *pixs,
                      l_int32   level,
                      l_uint8  *intab)
 {
-l_uint8    byte0, byte1;
-l_uint8   *tab;
-l_uint16   shortd;
 l_int32    i, id, j, ws, hs, wpls, wpld, wplsi;
 l_uint32   word1, word2, word3, word4;
 l_uint32  *datas, *datad, *lines, *lined;
@@ -256,12 +228,6 @@ PIX       *pixd;
     wpld = pixGetWpl(pixd);
     datad = pixGetData(pixd);
 
-    tab = (intab) ? intab : makeSubsampleTab2x();
-    if (!tab) {
-        pixDestroy(&pixd);
-        return (PIX *)ERROR_PTR("tab not made", procName, NULL);
-    }
-
         /* e.g., if ws = 65: wd = 32, wpls = 3, wpld = 1 --> trouble */
     wplsi = L_MIN(wpls, 2 * wpld);  /* iterate over this number of words */
 
@@ -280,12 +246,7 @@ PIX       *pixd;
                 word2 = word1 | word2;
                 word2 = word2 | (word2 << 1);
 
-                word2 = word2 & 0xaaaaaaaa;  /* mask */
-                word1 = word2 | (word2 << 7);  /* fold; data in bytes 0 & 2 */
-                byte0 = word1 >> 24;
-                byte1 = (word1 >> 8) & 0xff;
-                shortd = (tab[byte0] << 8) | tab[byte1];
-                SET_DATA_TWO_BYTES(lined, j, shortd);
+                SET_DATA_TWO_BYTES(lined, j, subsampleWord2x(word2));
             }
         }
         break;
@@ -305,12 +266,7 @@ PIX       *pixd;
                 word4 = word4 & (word4 << 1);
                 word2 = word3 | word4;
 
-                word2 = word2 & 0xaaaaaaaa;  /* mask */
-                word1 = word2 | (word2 << 7);  /* fold; data in bytes 0 & 2 */
-                byte0 = word1 >> 24;
-                byte1 = (word1 >> 8) & 0xff;
-                shortd = (tab[byte0] << 8) | tab[byte1];
-                SET_DATA_TWO_BYTES(lined, j, shortd);
+                SET_DATA_TWO_BYTES(lined, j, subsampleWord2x(word2));
             }
         }
         break;
@@ -330,12 +286,7 @@ PIX       *pixd;
                 word4 = word4 & (word4 << 1);
                 word2 = word3 & word4;
 
-                word2 = word2 & 0xaaaaaaaa;  /* mask */
-                word1 = word2 | (word2 << 7);  /* fold; data in bytes 0 & 2 */
-                byte0 = word1 >> 24;
-                byte1 = (word1 >> 8) & 0xff;
-                shortd = (tab[byte0] << 8) | tab[byte1];
-                SET_DATA_TWO_BYTES(lined, j, shortd);
+                SET_DATA_TWO_BYTES(lined, j, subsampleWord2x(word2));
             }
         }
         break;
@@ -352,18 +303,12 @@ PIX       *pixd;
                 word2 = word1 & word2;
                 word2 = word2 & (word2 << 1);
 
-                word2 = word2 & 0xaaaaaaaa;  /* mask */
-                word1 = word2 | (word2 << 7);  /* fold; data in bytes 0 & 2 */
-                byte0 = word1 >> 24;
-                byte1 = (word1 >> 8) & 0xff;
-                shortd = (tab[byte0] << 8) | tab[byte1];
-                SET_DATA_TWO_BYTES(lined, j, shortd);
+                SET_DATA_TWO_BYTES(lined, j, subsampleWord2x(word2));
             }
         }
         break;
     }
 
-    if (!intab) LEPT_FREE(tab);
     return pixd;
 }
 
@@ -405,3 +350,30 @@ l_int32   i;
 
     return tab;
 }
+
+
+/*!
+ * \brief   subsampleWord2x()
+ *
+ * \param[in]    word    32 pixels of 1 bpp data
+ * \return  the 16 pixels in the even columns, in order
+ *
+ * <pre>
+ * Notes:
+ *      (1) Pixel 0 is in the MSB.  The pixels in the even columns
+ *          are shifted down by 1 bit to the even bit positions, and
+ *          then compacted in 4 steps of masked shifts.  This is the
+ *          parallel bit extract (pext) for the mask 0xaaaaaaaa, done
+ *          without a lookup table.
+ * </pre>
+ */
+static l_uint16
+subsampleWord2x(l_uint32  word)
+{
+    word = (word >> 1) & 0x55555555;
+    word = (word | (word >> 1)) & 0x33333333;
+    word = (word | (word >> 2)) & 0x0f0f0f0f;
+    word = (word | (word >> 4)) & 0x00ff00ff;
+    word = (word | (word >> 8)) & 0x0000ffff;
+    return (l_uint16)word;
+}
@@ -49,11 +49,13 @@
  *
  *      Boxa creation, copy, destruction
  *           BOXA     *boxaCreate()
+ *           BOXA     *boxaCreateCompact()
  *           BOXA     *boxaCopy()
  *           void      boxaDestroy()
  *
  *      Boxa array extension
  *           l_int32   boxaAddBox()
+ *           l_int32   boxaAddBoxGeometry()
  *           l_int32   boxaExtendArray()
  *           l_int32   boxaExtendArrayToSize()
  *
@@ -65,6 +67,7 @@
  *           NUMA     *boxaFindInvalidBoxes()
  *           l_int32   boxaGetBoxGeometry()
  *           l_int32   boxaIsFull()
+ *           l_int32   boxaIsCompact()
  *
  *      Boxa array modifiers
  *           l_int32   boxaReplaceBox()
@@ -133,6 +136,8 @@
 #include <string.h>
 #include "allheaders.h"
 
+static BOX *boxaGetCompactBox(BOXA *boxa, l_int32 index);
+
     /* Bounds on initial array size */
 static const l_uint32  MaxPtrArraySize = 1000000;
 static const l_int32 InitialPtrArraySize = 20;      /*!< n'importe quoi */
@@ -516,6 +521,50 @@ BOXA  *boxa;
 }
 
 
+/*!
+ * \brief   boxaCreateCompact()
+ *
+ * \param[in]    n    initial number of ptrs; 0 for default
+ * \return  boxa, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) A compact boxa stores the box geometry in four contiguous
+ *          arrays of x, y, w and h.  It does not keep a BOX for an
+ *          entry, except one that is inserted with boxaInsertBox().
+ *          Use boxaAddBoxGeometry() to add entries without making a BOX.
+ *      (2) This saves a heap allocation per box when a large number
+ *          of boxes is generated (e.g., by pixConnCompBBCompact()),
+ *          and lets boxaGetBoxGeometry() read the arrays directly.
+ *      (3) All other boxa functions work on a compact boxa; they
+ *          just do not benefit from the compact storage.  Code must not
+ *          access boxa->box[] directly, because it may hold null ptrs.
+ * </pre>
+ */
+BOXA *
+boxaCreateCompact(l_int32  n)
+{
+BOXA  *boxa;
+
+    PROCNAME("boxaCreateCompact");
+
+    if (n <= 0 || n > MaxPtrArraySize)
+        n = InitialPtrArraySize;
+
+    if ((boxa = boxaCreate(n)) == NULL)
+        return (BOXA *)ERROR_PTR("boxa not made", procName, NULL);
+    boxa->bx = (l_int32 *)LEPT_CALLOC(n, sizeof(l_int32));
+    boxa->by = (l_int32 *)LEPT_CALLOC(n, sizeof(l_int32));
+    boxa->bw = (l_int32 *)LEPT_CALLOC(n, sizeof(l_int32));
+    boxa->bh = (l_int32 *)LEPT_CALLOC(n, sizeof(l_int32));
+    if (!boxa->bx || !boxa->by || !boxa->bw || !boxa->bh) {
+        boxaDestroy(&boxa);
+        return (BOXA *)ERROR_PTR("geometry arrays not made", procName, NULL);
+    }
+    return boxa;
+}
+
+
 /*!
  * \brief   boxaCopy()
  *
@@ -527,13 +576,14 @@ BOXA  *boxa;
  * Notes:
  *      (1) See pix.h for description of the copyflag.
  *      (2) The copy-clone makes a new boxa that holds clones of each box.
+ *      (3) The copy of a compact boxa is compact, and holds no boxes.
  * </pre>
  */
 BOXA *
 boxaCopy(BOXA    *boxa,
          l_int32  copyflag)
 {
-l_int32  i;
+l_int32  i, x, y, w, h;
 BOX     *boxc;
 BOXA    *boxac;
 
@@ -550,6 +600,16 @@ BOXA    *boxac;
     if (copyflag != L_COPY && copyflag != L_COPY_CLONE)
         return (BOXA *)ERROR_PTR("invalid copyflag", procName, NULL);
 
+    if (copyflag == L_COPY && boxaIsCompact(boxa)) {
+        if ((boxac = boxaCreateCompact(boxa->nalloc)) == NULL)
+            return (BOXA *)ERROR_PTR("boxac not made", procName, NULL);
+        for (i = 0; i < boxa->n; i++) {
+            boxaGetBoxGeometry(boxa, i, &x, &y, &w, &h);
+            boxaAddBoxGeometry(boxac, x, y, w, h);
+        }
+        return boxac;
+    }
+
     if ((boxac = boxaCreate(boxa->nalloc)) == NULL)
         return (BOXA *)ERROR_PTR("boxac not made", procName, NULL);
     for (i = 0; i < boxa->n; i++) {
@@ -597,6 +657,10 @@ BOXA    *boxa;
         for (i = 0; i < boxa->n; i++)
             boxDestroy(&boxa->box[i]);
         LEPT_FREE(boxa->box);
+        LEPT_FREE(boxa->bx);
+        LEPT_FREE(boxa->by);
+        LEPT_FREE(boxa->bw);
+        LEPT_FREE(boxa->bh);
         LEPT_FREE(boxa);
     }
 
@@ -649,6 +713,71 @@ BOX     *boxc;
 }
 
 
+/*!
+ * \brief   boxaAddBoxGeometry()
+ *
+ * \param[in]    boxa
+ * \param[in]    x, y, w, h
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) For a compact boxa, this stores the geometry without making
+ *          a box.  Otherwise, it makes a box and adds it.
+ *      (2) The geometry is constrained as in boxCreate().
+ * </pre>
+ */
+l_ok
+boxaAddBoxGeometry(BOXA    *boxa,
+                   l_int32  x,
+                   l_int32  y,
+                   l_int32  w,
+                   l_int32  h)
+{
+l_int32  n;
+BOX     *box;
+
+    PROCNAME("boxaAddBoxGeometry");
+
+    if (!boxa)
+        return ERROR_INT("boxa not defined", procName, 1);
+
+    if (!boxaIsCompact(boxa)) {
+        if ((box = boxCreate(x, y, w, h)) == NULL)
+            return ERROR_INT("box not made", procName, 1);
+        return boxaAddBox(boxa, box, L_INSERT);
+    }
+
+    if (w < 0 || h < 0)
+        return ERROR_INT("w and h not both >= 0", procName, 1);
+    if (x < 0) {  /* take part in +quad */
+        w = w + x;
+        x = 0;
+        if (w <= 0)
+            return ERROR_INT("x < 0 and box off +quad", procName, 1);
+    }
+    if (y < 0) {  /* take part in +quad */
+        h = h + y;
+        y = 0;
+        if (h <= 0)
+            return ERROR_INT("y < 0 and box off +quad", procName, 1);
+    }
+
+    n = boxaGetCount(boxa);
+    if (n >= boxa->nalloc) {
+        if (boxaExtendArray(boxa))
+            return ERROR_INT("extension failed", procName, 1);
+    }
+    boxa->box[n] = NULL;
+    boxa->bx[n] = x;
+    boxa->by[n] = y;
+    boxa->bw[n] = w;
+    boxa->bh[n] = h;
+    boxa->n++;
+    return 0;
+}
+
+
 /*!
  * \brief   boxaExtendArray()
  *
@@ -682,12 +811,15 @@ boxaExtendArray(BOXA  *boxa)
  * <pre>
  * Notes:
  *      (1) If necessary, reallocs new boxa ptr array to %size.
+ *      (2) For a compact boxa, the geometry arrays are also realloc'd.
  * </pre>
  */
 l_ok
 boxaExtendArrayToSize(BOXA    *boxa,
                       l_int32  size)
 {
+size_t  oldsize, newsize;
+
     PROCNAME("boxaExtendArrayToSize");
 
     if (!boxa)
@@ -698,6 +830,21 @@ boxaExtendArrayToSize(BOXA    *boxa,
                                             sizeof(BOX *) * boxa->nalloc,
                                             size * sizeof(BOX *))) == NULL)
             return ERROR_INT("new ptr array not returned", procName, 1);
+        if (boxaIsCompact(boxa)) {
+            oldsize = sizeof(l_int32) * boxa->nalloc;
+            newsize = sizeof(l_int32) * size;
+            boxa->bx = (l_int32 *)reallocNew((void **)&boxa->bx,
+                                             oldsize, newsize);
+            boxa->by = (l_int32 *)reallocNew((void **)&boxa->by,
+                                             oldsize, newsize);
+            boxa->bw = (l_int32 *)reallocNew((void **)&boxa->bw,
+                                             oldsize, newsize);
+            boxa->bh = (l_int32 *)reallocNew((void **)&boxa->bh,
+                                             oldsize, newsize);
+            if (!boxa->bx || !boxa->by || !boxa->bw || !boxa->bh)
+                return ERROR_INT("new geometry arrays not returned",
+                                 procName, 1);
+        }
         boxa->nalloc = size;
     }
     return 0;
@@ -757,6 +904,16 @@ l_int32  n, i, w, h, count;
  * \param[in]    index        to the index-th box
  * \param[in]    accessflag   L_COPY or L_CLONE
  * \return  box, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) For an entry of a compact boxa that has no box, a new box
+ *          is made from the geometry arrays, for either %accessflag.
+ *          It is not stored in the boxa, so changing it does not change
+ *          the boxa; use boxaReplaceBox() to store the change.
+ *      (2) To read the geometry of an entry without making a box,
+ *          use boxaGetBoxGeometry().
+ * </pre>
  */
 BOX *
 boxaGetBox(BOXA    *boxa,
@@ -770,6 +927,12 @@ boxaGetBox(BOXA    *boxa,
     if (index < 0 || index >= boxa->n)
         return (BOX *)ERROR_PTR("index not valid", procName, NULL);
 
+    if (!boxa->box[index] && boxaIsCompact(boxa)) {
+        if (accessflag != L_COPY && accessflag != L_CLONE)
+            return (BOX *)ERROR_PTR("invalid accessflag", procName, NULL);
+        return boxaGetCompactBox(boxa, index);
+    }
+
     if (accessflag == L_COPY)
         return boxCopy(boxa->box[index]);
     else if (accessflag == L_CLONE)
@@ -857,6 +1020,13 @@ NUMA    *na;
  * \param[in]    index            to the index-th box
  * \param[out]   px, py, pw, ph   [optional] each can be null
  * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This neither copies nor clones the box.  For a compact boxa,
+ *          the geometry is read from the arrays unless a box has been
+ *          made for the entry.
+ * </pre>
  */
 l_ok
 boxaGetBoxGeometry(BOXA     *boxa,
@@ -879,10 +1049,14 @@ BOX  *box;
     if (index < 0 || index >= boxa->n)
         return ERROR_INT("index not valid", procName, 1);
 
-    if ((box = boxaGetBox(boxa, index, L_CLONE)) == NULL)
+    if ((box = boxa->box[index]) != NULL)
+        return boxGetGeometry(box, px, py, pw, ph);
+    if (!boxaIsCompact(boxa))
         return ERROR_INT("box not found!", procName, 1);
-    boxGetGeometry(box, px, py, pw, ph);
-    boxDestroy(&box);
+    if (px) *px = boxa->bx[index];
+    if (py) *py = boxa->by[index];
+    if (pw) *pw = boxa->bw[index];
+    if (ph) *ph = boxa->bh[index];
     return 0;
 }
 
@@ -899,7 +1073,6 @@ boxaIsFull(BOXA     *boxa,
            l_int32  *pfull)
 {
 l_int32  i, n, full;
-BOX     *box;
 
     PROCNAME("boxaIsFull");
 
@@ -909,20 +1082,57 @@ BOX     *box;
     if (!boxa)
         return ERROR_INT("boxa not defined", procName, 1);
 
+    if (boxaIsCompact(boxa)) {  /* every entry has geometry */
+        *pfull = 1;
+        return 0;
+    }
+
     n = boxaGetCount(boxa);
     full = 1;
     for (i = 0; i < n; i++) {
-        if ((box = boxaGetBox(boxa, i, L_CLONE)) == NULL) {
+        if (!boxa->box[i]) {
             full = 0;
             break;
         }
-        boxDestroy(&box);
     }
     *pfull = full;
     return 0;
 }
 
 
+/*!
+ * \brief   boxaIsCompact()
+ *
+ * \param[in]    boxa
+ * \return  1 if boxa has compact geometry storage; 0 if not or on error
+ */
+l_int32
+boxaIsCompact(BOXA  *boxa)
+{
+    PROCNAME("boxaIsCompact");
+
+    if (!boxa)
+        return ERROR_INT("boxa not defined", procName, 0);
+    return (boxa->bx != NULL) ? 1 : 0;
+}
+
+
+/*!
+ * \brief   boxaGetCompactBox()
+ *
+ * \param[in]    boxa     compact
+ * \param[in]    index    to an entry in the geometry arrays
+ * \return  new box, or NULL on error
+ */
+static BOX *
+boxaGetCompactBox(BOXA    *boxa,
+                  l_int32  index)
+{
+    return boxCreate(boxa->bx[index], boxa->by[index],
+                     boxa->bw[index], boxa->bh[index]);
+}
+
+
 /*---------------------------------------------------------------------*
  *                        Boxa array modifiers                         *
  *---------------------------------------------------------------------*/
@@ -939,6 +1149,8 @@ BOX     *box;
  *      (1) In-place replacement of one box; the input %box is now
  *          owned by the boxa.
  *      (2) The previous box at that location, if any, is destroyed.
+ *      (3) For a compact boxa, only the geometry of %box is kept, and
+ *          %box is destroyed.
  * </pre>
  */
 l_ok
@@ -956,6 +1168,12 @@ boxaReplaceBox(BOXA    *boxa,
         return ERROR_INT("box not defined", procName, 1);
 
     boxDestroy(&(boxa->box[index]));
+    if (boxaIsCompact(boxa)) {
+        boxGetGeometry(box, &boxa->bx[index], &boxa->by[index],
+                       &boxa->bw[index], &boxa->bh[index]);
+        boxDestroy(&box);
+        return 0;
+    }
     boxa->box[index] = box;
     return 0;
 }
@@ -1004,6 +1222,16 @@ BOX    **array;
     for (i = n; i > index; i--)
         array[i] = array[i - 1];
     array[index] = box;
+    if (boxaIsCompact(boxa)) {
+        for (i = n; i > index; i--) {
+            boxa->bx[i] = boxa->bx[i - 1];
+            boxa->by[i] = boxa->by[i - 1];
+            boxa->bw[i] = boxa->bw[i - 1];
+            boxa->bh[i] = boxa->bh[i - 1];
+        }
+        boxGetGeometry(box, &boxa->bx[index], &boxa->by[index],
+                       &boxa->bw[index], &boxa->bh[index]);
+    }
 
     return 0;
 }
@@ -1072,6 +1300,14 @@ BOX    **array;
     for (i = index + 1; i < n; i++)
         array[i - 1] = array[i];
     array[n - 1] = NULL;
+    if (boxaIsCompact(boxa)) {
+        for (i = index + 1; i < n; i++) {
+            boxa->bx[i - 1] = boxa->bx[i];
+            boxa->by[i - 1] = boxa->by[i];
+            boxa->bw[i - 1] = boxa->bw[i];
+            boxa->bh[i - 1] = boxa->bh[i];
+        }
+    }
     boxa->n--;
 
     return 0;
@@ -2241,8 +2477,7 @@ l_ok
 boxaWriteStream(FILE  *fp,
                 BOXA  *boxa)
 {
-l_int32  n, i;
-BOX     *box;
+l_int32  n, i, x, y, w, h;
 
     PROCNAME("boxaWriteStream");
 
@@ -2255,11 +2490,10 @@ BOX     *box;
     fprintf(fp, "\nBoxa Version %d\n", BOXA_VERSION_NUMBER);
     fprintf(fp, "Number of boxes = %d\n", n);
     for (i = 0; i < n; i++) {
-        if ((box = boxaGetBox(boxa, i, L_CLONE)) == NULL)
+        if (boxaGetBoxGeometry(boxa, i, &x, &y, &w, &h))
             return ERROR_INT("box not found", procName, 1);
         fprintf(fp, "  Box[%d]: x = %d, y = %d, w = %d, h = %d\n",
-                i, box->x, box->y, box->w, box->h);
-        boxDestroy(&box);
+                i, x, y, w, h);
     }
     return 0;
 }
@@ -1182,9 +1182,8 @@ boxaGetNearestToPt(BOXA    *boxa,
                    l_int32  x,
                    l_int32  y)
 {
-l_int32    i, n, minindex;
+l_int32    i, n, minindex, bx, by, bw, bh;
 l_float32  delx, dely, dist, mindist, cx, cy;
-BOX       *box;
 
     PROCNAME("boxaGetNearestToPt");
 
@@ -1196,9 +1195,11 @@ BOX       *box;
     mindist = 1000000000.;
     minindex = 0;
     for (i = 0; i < n; i++) {
-        if ((box = boxaGetValidBox(boxa, i, L_CLONE)) == NULL)
+        boxaGetBoxGeometry(boxa, i, &bx, &by, &bw, &bh);
+        if (bw <= 0 || bh <= 0)  /* invalid box */
             continue;
-        boxGetCenter(box, &cx, &cy);
+        cx = (l_float32)(bx + 0.5 * bw);
+        cy = (l_float32)(by + 0.5 * bh);
         delx = (l_float32)(cx - x);
         dely = (l_float32)(cy - y);
         dist = delx * delx + dely * dely;
@@ -1206,7 +1207,6 @@ BOX       *box;
             minindex = i;
             mindist = dist;
         }
-        boxDestroy(&box);
     }
 
     return boxaGetBox(boxa, minindex, L_COPY);
@@ -1235,9 +1235,8 @@ boxaGetNearestToLine(BOXA    *boxa,
                      l_int32  x,
                      l_int32  y)
 {
-l_int32    i, n, minindex;
+l_int32    i, n, minindex, bx, by, bw, bh;
 l_float32  dist, mindist, cx, cy;
-BOX       *box;
 
     PROCNAME("boxaGetNearestToLine");
 
@@ -1253,9 +1252,11 @@ BOX       *box;
     mindist = 1000000000.;
     minindex = 0;
     for (i = 0; i < n; i++) {
-        if ((box = boxaGetValidBox(boxa, i, L_CLONE)) == NULL)
+        boxaGetBoxGeometry(boxa, i, &bx, &by, &bw, &bh);
+        if (bw <= 0 || bh <= 0)  /* invalid box */
             continue;
-        boxGetCenter(box, &cx, &cy);
+        cx = (l_float32)(bx + 0.5 * bw);
+        cy = (l_float32)(by + 0.5 * bh);
         if (x >= 0)
             dist = L_ABS(cx - (l_float32)x);
         else  /* y >= 0 */
@@ -1264,7 +1265,6 @@ BOX       *box;
             minindex = i;
             mindist = dist;
         }
-        boxDestroy(&box);
     }
 
     return boxaGetBox(boxa, minindex, L_COPY);
@@ -1887,7 +1887,7 @@ BOX  *box;
         return ERROR_INT("invalid index", procName, 1);
 
     boxAdjustSides(box, box, delleft, delright, deltop, delbot);
-    boxDestroy(&box);  /* the clone */
+    boxaReplaceBox(boxa, index, box);  /* needed if boxa is compact */
     return 0;
 }
 
@@ -1996,7 +1996,7 @@ BOX     *box;
     for (i = 0; i < n; i++) {
         box = boxaGetBox(boxad, i, L_CLONE);
         boxSetSide(box, side, val, thresh);
-        boxDestroy(&box);  /* the clone */
+        boxaReplaceBox(boxad, i, box);  /* needed if boxad is compact */
     }
 
     return boxad;
@@ -2120,7 +2120,7 @@ BOX     *box;
             if (L_ABS(diff) >= thresh)
                 boxSetGeometry(box, L_MAX(0, x + diff/2), y, target, h);
         }
-        boxDestroy(&box);
+        boxaReplaceBox(boxad, i, box);  /* needed if boxad is compact */
     }
 
     return boxad;
@@ -2188,7 +2188,7 @@ BOX     *box;
             if (L_ABS(diff) >= thresh)
                 boxSetGeometry(box, x, L_MAX(0, y + diff/2), w, target);
         }
-        boxDestroy(&box);
+        boxaReplaceBox(boxad, i, box);  /* needed if boxad is compact */
     }
 
     return boxad;
@@ -151,7 +151,6 @@ pixMaskBoxa(PIX     *pixd,
             l_int32  op)
 {
 l_int32  i, n, x, y, w, h;
-BOX     *box;
 
     PROCNAME("pixMaskBoxa");
 
@@ -173,15 +172,13 @@ BOX     *box;
     }
 
     for (i = 0; i < n; i++) {
-        box = boxaGetBox(boxa, i, L_CLONE);
-        boxGetGeometry(box, &x, &y, &w, &h);
+        boxaGetBoxGeometry(boxa, i, &x, &y, &w, &h);
         if (op == L_SET_PIXELS)
             pixRasterop(pixd, x, y, w, h, PIX_SET, NULL, 0, 0);
         else if (op == L_CLEAR_PIXELS)
             pixRasterop(pixd, x, y, w, h, PIX_CLR, NULL, 0, 0);
         else  /* op == L_FLIP_PIXELS */
             pixRasterop(pixd, x, y, w, h, PIX_NOT(PIX_DST), NULL, 0, 0);
-        boxDestroy(&box);
     }
 
     return pixd;
@@ -711,7 +711,7 @@ boxaSwapBoxes(BOXA    *boxa,
               l_int32  i,
               l_int32  j)
 {
-l_int32  n;
+l_int32  n, t;
 BOX     *box;
 
     PROCNAME("boxaSwapBoxes");
@@ -729,6 +729,12 @@ BOX     *box;
     box = boxa->box[i];
     boxa->box[i] = boxa->box[j];
     boxa->box[j] = box;
+    if (boxaIsCompact(boxa)) {
+        t = boxa->bx[i]; boxa->bx[i] = boxa->bx[j]; boxa->bx[j] = t;
+        t = boxa->by[i]; boxa->by[i] = boxa->by[j]; boxa->by[j] = t;
+        t = boxa->bw[i]; boxa->bw[i] = boxa->bw[j]; boxa->bw[j] = t;
+        t = boxa->bh[i]; boxa->bh[i] = boxa->bh[j]; boxa->bh[j] = t;
+    }
     return 0;
 }
 
@@ -1049,10 +1055,8 @@ PIX     *pixt;
     } else {  /* slower and exact */
         pixt = pixCreate(wc, hc, 1);
         for (i = 0; i < n; i++) {
-            box = boxaGetBox(boxa, i, L_CLONE);
-            boxGetGeometry(box, &x, &y, &w, &h);
+            boxaGetBoxGeometry(boxa, i, &x, &y, &w, &h);
             pixRasterop(pixt, x, y, w, h, PIX_SET, NULL, 0, 0);
-            boxDestroy(&box);
         }
         pixCountPixels(pixt, &sum, NULL);
         pixDestroy(&pixt);
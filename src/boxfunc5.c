@@ -419,10 +419,10 @@ PTA       *ptal, *ptat, *ptar, *ptab;
         tval = (l_int32)(at * i + bt + 0.5);
         rval = (l_int32)(ar * i + br + 0.5);
         bval = (l_int32)(ab * i + bb + 0.5);
-        if ((box = boxaGetValidBox(boxas, i, L_CLONE)) == NULL) {
+        boxaGetBoxGeometry(boxas, i, NULL, NULL, &w, &h);
+        if (w <= 0 || h <= 0) {  /* invalid box */
             boxaAddBox(boxad, boxempty, L_COPY);
         } else {
-            boxDestroy(&box);
             box = boxCreate(lval, tval, rval - lval + 1, bval - tval + 1);
             boxaAddBox(boxad, box, L_INSERT);
         }
@@ -606,7 +606,7 @@ boxaModifyWithBoxa(BOXA    *boxas,
                    l_int32  extrapixels)
 {
 l_int32  n, i, ls, ts, rs, bs, ws, hs, lm, tm, rm, bm, wm, hm, ld, td, rd, bd;
-BOX     *boxs, *boxm, *boxd, *boxempty;
+BOX     *boxd, *boxempty;
 BOXA    *boxad;
 
     PROCNAME("boxaModifyWithBoxa");
@@ -632,13 +632,11 @@ BOXA    *boxad;
     boxad = boxaCreate(n);
     boxempty = boxCreate(0, 0, 0, 0);  /* placeholders */
     for (i = 0; i < n; i++) {
-        boxs = boxaGetValidBox(boxas, i, L_CLONE);
-        boxm = boxaGetValidBox(boxam, i, L_CLONE);
-        if (!boxs || !boxm) {
+        boxaGetBoxGeometry(boxas, i, &ls, &ts, &ws, &hs);
+        boxaGetBoxGeometry(boxam, i, &lm, &tm, &wm, &hm);
+        if (ws <= 0 || hs <= 0 || wm <= 0 || hm <= 0) {  /* not both valid */
             boxaAddBox(boxad, boxempty, L_COPY);
         } else {
-            boxGetGeometry(boxs, &ls, &ts, &ws, &hs);
-            boxGetGeometry(boxm, &lm, &tm, &wm, &hm);
             rs = ls + ws - 1;
             bs = ts + hs - 1;
             rm = lm + wm - 1;
@@ -677,8 +675,6 @@ BOXA    *boxad;
             boxd = boxCreate(ld, td, rd - ld + 1, bd - td + 1);
             boxaAddBox(boxad, boxd, L_INSERT);
         }
-        boxDestroy(&boxs);
-        boxDestroy(&boxm);
     }
     boxDestroy(&boxempty);
 
@@ -1929,9 +1925,9 @@ BOXA    *boxae, *boxao, *boxad;
 static l_int32
 boxaFillAll(BOXA  *boxa)
 {
-l_int32   n, nv, i, j, spandown, spanup;
+l_int32   n, nv, i, j, w, h, spandown, spanup;
 l_int32  *indic;
-BOX      *box, *boxt;
+BOX      *boxt;
 
     PROCNAME("boxaFillAll");
 
@@ -1949,16 +1945,14 @@ BOX      *box, *boxt;
     if ((indic = (l_int32 *)LEPT_CALLOC(n, sizeof(l_int32))) == NULL)
         return ERROR_INT("indic not made", procName, 1);
     for (i = 0; i < n; i++) {
-        box = boxaGetValidBox(boxa, i, L_CLONE);
-        if (box)
+        boxaGetBoxGeometry(boxa, i, NULL, NULL, &w, &h);
+        if (w > 0 && h > 0)
             indic[i] = 1;
-        boxDestroy(&box);
     }
 
         /* Replace invalid boxes with the nearest valid one */
     for (i = 0; i < n; i++) {
-        box = boxaGetValidBox(boxa, i, L_CLONE);
-        if (!box) {
+        if (indic[i] == 0) {
             spandown = spanup = 10000000;
             for (j = i - 1; j >= 0; j--) {
                 if (indic[j] == 1) {
@@ -1978,7 +1972,6 @@ BOX      *box, *boxt;
                 boxt = boxaGetBox(boxa, i + spanup, L_COPY);
             boxaReplaceBox(boxa, i, boxt);
         }
-        boxDestroy(&box);
     }
 
     LEPT_FREE(indic);
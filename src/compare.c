@@ -109,6 +109,10 @@
     /* Small enough to consider equal to 0.0, for plot output */
 static const l_float32  TINY = 0.00001;
 
+    /* Min number of shifts for which pixBestCorrelation() finds
+     * the correlation counts by FFT */
+static const l_int32  MIN_SHIFTS_FOR_FFT = 1600;
+
 static l_ok findHistoGridDimensions(l_int32 n, l_int32 w, l_int32 h,
                                     l_int32 *pnx, l_int32 *pny, l_int32 debug);
 static l_ok pixCompareTilesByHisto(PIX *pix1, PIX *pix2, l_int32 maxgray,
@@ -313,7 +317,7 @@ PIXCMAP   *cmap1, *cmap2;
         for (i = 0; i < h1; i++) {
             line1 = data1 + wpl1 * i;
             line2 = data2 + wpl2 * i;
-            for (j = 0; j < wpl1; j++) {
+            for (j = 0; j < w1; j++) {
                 if ((*line1 ^ *line2) & wordmask) {
                     pixDestroy(&pixt1);
                     pixDestroy(&pixt2);
@@ -3375,7 +3379,6 @@ pixCompareWithTranslation(PIX        *pix1,
                           l_float32  *pscore,
                           l_int32     debugflag)
 {
-l_uint8   *subtab;
 l_int32    i, level, area1, area2, delx, dely;
 l_int32    etransx, etransy, maxshift, dbint;
 l_int32   *stab, *ctab;
@@ -3398,7 +3401,6 @@ PIXA      *pixa1, *pixa2, *pixadb;
         return ERROR_INT("pix2 not defined", procName, 1);
 
         /* Make tables */
-    subtab = makeSubsampleTab2x();
     stab = makePixelSumTab8();
     ctab = makePixelCentroidTab8();
 
@@ -3415,8 +3417,8 @@ PIXA      *pixa1, *pixa2, *pixadb;
     pixaAddPix(pixa1, pixb1, L_INSERT);
     pixaAddPix(pixa2, pixb2, L_INSERT);
     for (i = 0; i < 3; i++) {
-        pixt1 = pixReduceRankBinary2(pixb1, 2, subtab);
-        pixt2 = pixReduceRankBinary2(pixb2, 2, subtab);
+        pixt1 = pixReduceRankBinary2(pixb1, 2, NULL);
+        pixt2 = pixReduceRankBinary2(pixb2, 2, NULL);
         pixaAddPix(pixa1, pixt1, L_INSERT);
         pixaAddPix(pixa2, pixt2, L_INSERT);
         pixb1 = pixt1;
@@ -3473,7 +3475,6 @@ PIXA      *pixa1, *pixa2, *pixadb;
     *pscore = score;
     pixaDestroy(&pixa1);
     pixaDestroy(&pixa2);
-    LEPT_FREE(subtab);
     LEPT_FREE(stab);
     LEPT_FREE(ctab);
     return 0;
@@ -3518,6 +3519,11 @@ PIXA      *pixa1, *pixa2, *pixadb;
  *          Consequently, if pix1 and pix2 are large, you should do this
  *          in a coarse-to-fine sequence.  See the use of this function
  *          in pixCompareWithTranslation().
+ *      (4) The correlations for all shifts are computed together with
+ *          pixCorrelationCountShifts(), which visits each row of pix2
+ *          only once.  For %maxshift >= 20, its time exceeds that of
+ *          a correlation by FFT, and pixCorrelationCountShiftsFFT()
+ *          is used instead.  Both give the same counts.
  * </pre>
  */
 l_ok
@@ -3534,8 +3540,8 @@ pixBestCorrelation(PIX        *pix1,
                    l_float32  *pscore,
                    l_int32     debugflag)
 {
-l_int32    shiftx, shifty, delx, dely;
-l_int32   *tab;
+l_int32    shiftx, shifty, delx, dely, nshift, count;
+l_int32   *tab, *counts;
 l_float32  maxscore, score;
 FPIX      *fpix;
 PIX       *pix3, *pix4;
@@ -3560,15 +3566,26 @@ PIX       *pix3, *pix4;
     else
         tab = tab8;
 
-        /* Search over a set of {shiftx, shifty} for the max */
+        /* Get the correlation counts for the full window of
+         * {shiftx, shifty} in one pass, and search for the max */
+    nshift = 2 * maxshift + 1;
+    counts = (l_int32 *)LEPT_CALLOC(nshift * nshift, sizeof(l_int32));
+    if (nshift * nshift >= MIN_SHIFTS_FOR_FFT)
+        pixCorrelationCountShiftsFFT(pix1, pix2, etransx - maxshift,
+                                     etransy - maxshift, nshift, nshift,
+                                     counts);
+    else
+        pixCorrelationCountShifts(pix1, pix2, etransx - maxshift,
+                                  etransy - maxshift, nshift, nshift, 0, tab,
+                                  counts, NULL);
     maxscore = 0;
     delx = etransx;
     dely = etransy;
     for (shifty = -maxshift; shifty <= maxshift; shifty++) {
         for (shiftx = -maxshift; shiftx <= maxshift; shiftx++) {
-            pixCorrelationScoreShifted(pix1, pix2, area1, area2,
-                                       etransx + shiftx,
-                                       etransy + shifty, tab, &score);
+            count = counts[(maxshift + shifty) * nshift + maxshift + shiftx];
+            score = (l_float32)count * (l_float32)count /
+                    ((l_float32)area1 * (l_float32)area2);
             if (debugflag > 0) {
                 fpixSetPixel(fpix, maxshift + shiftx, maxshift + shifty,
                              1000.0 * score);
@@ -3582,6 +3599,7 @@ PIX       *pix3, *pix4;
             }
         }
     }
+    LEPT_FREE(counts);
 
     if (debugflag > 0) {
         lept_mkdir("lept/comp");
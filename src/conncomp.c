@@ -28,8 +28,8 @@
  * \file conncomp.c
  * <pre>
  *
- *    Connected component counting and extraction, using Heckbert's
- *    stack-based filling algorithm.
+ *    Connected component counting and extraction, using union-find
+ *    on runs, and Heckbert's stack-based filling algorithm.
  *
  *      4- and 8-connected components: counts, bounding boxes and images
  *
@@ -37,8 +37,18 @@
  *            BOXA     *pixConnComp()
  *            BOXA     *pixConnCompPixa()
  *            BOXA     *pixConnCompBB()
+ *            BOXA     *pixConnCompBBCompact()
  *            l_int32   pixCountConnComp()
  *
+ *      Connected components of a run-length encoded image:
+ *            BOXA     *rleConnCompBB()
+ *            l_int32   rleCountConnComp()
+ *
+ *      Labels, bounding boxes, areas and centroids in one pass:
+ *            l_int32   pixConnCompLabel()
+ *    static  l_int32   connCompRunsLow()
+ *    static  l_int32   connCompStatsLow()
+ *
  *      Identify the next c.c. to be erased:
  *            l_int32   nextOnPixelInRaster()
  *    static  l_int32   nextOnPixelInRasterLow()
@@ -58,33 +68,31 @@
  *            static void    pushFillseg()
  *            static void    popFillseg()
  *
- *  The basic method in pixConnCompBB() is very simple.  We scan the
- *  image in raster order, looking for the next ON pixel.  When it
- *  is found, we erase it and every pixel of the 4- or 8-connected
- *  component to which it belongs, using Heckbert's seedfill
- *  algorithm.  As pixels are erased, we keep track of the
- *  minimum rectangle that encloses all erased pixels; after
- *  the connected component has been erased, we save its
- *  bounding box in an array of boxes.  When all pixels in the
- *  image have been erased, we have an array that describes every
- *  4- or 8-connected component in terms of its bounding box.
+ *  The top-level calls use a two-pass method on the runs of ON pixels.
+ *  In the first pass, the image is converted to an L_Rle, which
+ *  holds the horizontal runs in each line.  Each run is joined,
+ *  using union-find, to the runs in the previous line that it
+ *  touches (with 4- or 8-connectivity).  The root of each set is
+ *  always the earliest run, so in the second pass, the runs can be
+ *  assigned component indices in a single sweep.  The components are
+ *  numbered in the raster order of their first pixel, which is the
+ *  order in which they are found by the seedfill method below.
+ *  Nothing is erased, no copy of the image is made, and the time
+ *  is proportional to the number of words plus the number of runs.
  *
- *  pixConnCompPixa() is a slight variation on pixConnCompBB(),
- *  where we additionally save an array of images (in a Pixa)
- *  of each of the 4- or 8-connected components.  This is done trivially
- *  by maintaining two temporary images.  We erase a component from one,
- *  and use the bounding box to extract the pixels within the b.b.
- *  from each of the two images.  An XOR between these subimages
- *  gives the erased component.  Then we erase the component from the
- *  second image using the XOR again, with the extracted component
- *  placed on the second image at the location of the bounding box.
- *  Rasterop does all the work.  At the end, we have an array
- *  of the 4- or 8-connected components, as well as an array of the
- *  bounding boxes that describe where they came from in the original image.
+ *  pixConnCompPixa() additionally saves an array of images (in a Pixa)
+ *  of each of the 4- or 8-connected components.  Each image is made
+ *  from the bounding box, and the runs of the component are painted
+ *  into it.  pixConnCompLabel() gives a label image and the
+ *  bounding box, area and centroid of each component from the
+ *  same pass.
  *
- *  If you just want the number of connected components, pixCountConnComp()
- *  is a bit faster than pixConnCompBB(), because it doesn't have to
- *  keep track of the bounding rectangles for each c.c.
+ *  The older method, which is still available through pixSeedfillBB()
+ *  and pixSeedfill(), is to scan the image in raster order, looking
+ *  for the next ON pixel.  When it is found, we erase it and every
+ *  pixel of the 4- or 8-connected component to which it belongs,
+ *  using Heckbert's seedfill algorithm.  As pixels are erased, we keep
+ *  track of the minimum rectangle that encloses all erased pixels.
  * </pre>
  */
 
@@ -108,6 +116,11 @@ typedef struct FillSeg    FILLSEG;
 static l_int32 nextOnPixelInRasterLow(l_uint32 *data, l_int32 w, l_int32 h,
                                       l_int32 wpl, l_int32 xstart,
                                       l_int32 ystart, l_int32 *px, l_int32 *py);
+static l_int32 connCompRunsLow(L_RLE *rle, l_int32 connectivity,
+                               l_int32 **pcomp, l_int32 *pncomp);
+static l_int32 connCompStatsLow(L_RLE *rle, l_int32 *comp, l_int32 ncomp,
+                                l_int32 compact, BOXA **pboxa, NUMA **pnaa,
+                                PTA **ppta);
 
     /* Static accessors for FillSegs on a stack */
 static void pushFillsegBB(L_STACK *stack, l_int32 xleft, l_int32 xright,
@@ -177,10 +190,9 @@ pixConnComp(PIX     *pixs,
  *      (1) This finds bounding boxes of 4- or 8-connected components
  *          in a binary image, and saves images of each c.c
  *          in a pixa array.
- *      (2) It sets up 2 temporary pix, and for each c.c. that is
- *          located in raster order, it erases the c.c. from one pix,
- *          then uses the b.b. to extract the c.c. from the two pix using
- *          an XOR, and finally erases the c.c. from the second pix.
+ *      (2) The c.c. are found by union-find on the runs of pixs.
+ *          The image of each c.c. is made by painting its runs into
+ *          a pix of the size of its b.b.
  *      (3) A clone of the returned boxa (where all boxes in the array
  *          are clones) is inserted into the pixa.
  *      (4) If the input is valid, this always returns a boxa and a pixa.
@@ -192,13 +204,12 @@ pixConnCompPixa(PIX     *pixs,
                 PIXA   **ppixa,
                 l_int32  connectivity)
 {
-l_int32   h, iszero;
-l_int32   x, y, xstart, ystart;
-PIX      *pix1, *pix2, *pix3, *pix4;
-PIXA     *pixa;
-BOX      *box;
-BOXA     *boxa;
-L_STACK  *stack, *auxstack;
+l_int32    i, k, ncomp, xb, yb, wb, hb;
+l_int32   *comp;
+PIX      **pixs1;
+PIXA      *pixa;
+BOXA      *boxa;
+L_RLE     *rle;
 
     PROCNAME("pixConnCompPixa");
 
@@ -210,78 +221,42 @@ L_STACK  *stack, *auxstack;
     if (connectivity != 4 && connectivity != 8)
         return (BOXA *)ERROR_PTR("connectivity not 4 or 8", procName, NULL);
 
-    pix1 = pix2 = pix3 = pix4 = NULL;
-    stack = NULL;
-    pixa = pixaCreate(0);
-    boxa = NULL;
-    *ppixa = pixa;
-    pixZero(pixs, &iszero);
-    if (iszero)
-        return boxaCreate(1);  /* return empty boxa and empty pixa */
-
-    pixSetPadBits(pixs, 0);
-    pix1 = pixCopy(NULL, pixs);
-    pix2 = pixCopy(NULL, pixs);
-    if (!pix1 || !pix2) {
-        L_ERROR("pix1 or pix2 not made\n", procName);
-        pixaDestroy(ppixa);
-        goto cleanup;
+    if ((rle = pixConvertToRle(pixs)) == NULL)
+        return (BOXA *)ERROR_PTR("rle not made", procName, NULL);
+    if (connCompRunsLow(rle, connectivity, &comp, &ncomp)) {
+        rleDestroy(&rle);
+        return (BOXA *)ERROR_PTR("runs not labelled", procName, NULL);
     }
+    connCompStatsLow(rle, comp, ncomp, 0, &boxa, NULL, NULL);
+    pixa = pixaCreate(ncomp);
+    *ppixa = pixa;
 
-    h = pixGetHeight(pixs);
-    if ((stack = lstackCreate(h)) == NULL) {
-        L_ERROR("stack not made\n", procName);
-        pixaDestroy(ppixa);
-        goto cleanup;
+        /* Make an image for each c.c. of the size of its b.b.,
+         * and paint the runs of the c.c. into it.  If pixs is empty,
+         * the boxa and pixa will be empty. */
+    pixs1 = (PIX **)LEPT_CALLOC(L_MAX(1, ncomp), sizeof(PIX *));
+    for (i = 0; i < ncomp; i++) {
+        boxaGetBoxGeometry(boxa, i, NULL, NULL, &wb, &hb);
+        pixs1[i] = pixCreate(wb, hb, 1);
     }
-    auxstack = lstackCreate(0);
-    stack->auxstack = auxstack;
-    boxa = boxaCreate(0);
-
-    xstart = 0;
-    ystart = 0;
-    while (1) {
-        if (!nextOnPixelInRaster(pix1, xstart, ystart, &x, &y))
-            break;
-
-        if ((box = pixSeedfillBB(pix1, stack, x, y, connectivity)) == NULL) {
-            boxaDestroy(&boxa);
-            pixaDestroy(ppixa);
-            L_ERROR("box not made\n", procName);
-            goto cleanup;
+    for (i = 0; i < rle->h; i++) {
+        for (k = rle->linestart[i]; k < rle->linestart[i + 1]; k++) {
+            boxaGetBoxGeometry(boxa, comp[k], &xb, &yb, NULL, NULL);
+            setLineRun(pixGetData(pixs1[comp[k]]) +
+                       (i - yb) * pixGetWpl(pixs1[comp[k]]),
+                       rle->x0[k] - xb, rle->x1[k] - xb);
         }
-        boxaAddBox(boxa, box, L_INSERT);
-
-            /* Save the c.c. and remove from pix2 as well */
-        pix3 = pixClipRectangle(pix1, box, NULL);
-        pix4 = pixClipRectangle(pix2, box, NULL);
-        pixXor(pix3, pix3, pix4);
-        pixRasterop(pix2, box->x, box->y, box->w, box->h, PIX_SRC ^ PIX_DST,
-                    pix3, 0, 0);
-        pixaAddPix(pixa, pix3, L_INSERT);
-        pixDestroy(&pix4);
-
-        xstart = x;
-        ystart = y;
     }
-
-#if  DEBUG
-    pixCountPixels(pix1, &iszero, NULL);
-    fprintf(stderr, "Number of remaining pixels = %d\n", iszero);
-    lept_mkdir("lept/cc");
-    pixWriteDebug("/tmp/lept/cc/remain.png", pix1, IFF_PNG);
-#endif  /* DEBUG */
+    for (i = 0; i < ncomp; i++)
+        pixaAddPix(pixa, pixs1[i], L_INSERT);
 
         /* Remove old boxa of pixa and replace with a copy */
     boxaDestroy(&pixa->boxa);
     pixa->boxa = boxaCopy(boxa, L_COPY);
-    *ppixa = pixa;
 
-        /* Cleanup, freeing the fillsegs on each stack */
-cleanup:
-    lstackDestroy(&stack, TRUE);
-    pixDestroy(&pix1);
-    pixDestroy(&pix2);
+    LEPT_FREE(pixs1);
+    LEPT_FREE(comp);
+    rleDestroy(&rle);
     return boxa;
 }
 
@@ -297,21 +272,17 @@ cleanup:
  * Notes:
  *     (1) Finds bounding boxes of 4- or 8-connected components
  *         in a binary image.
- *     (2) This works on a copy of the input pix.  The c.c. are located
- *         in raster order and erased one at a time.  In the process,
- *         the b.b. is computed and saved.
+ *     (2) The c.c. are found by union-find on the runs of pixs,
+ *         and are returned in the raster order of their first pixel.
+ *         If pixs is empty, the boxa will be empty.
  * </pre>
  */
 BOXA *
 pixConnCompBB(PIX     *pixs,
               l_int32  connectivity)
 {
-l_int32   h, iszero;
-l_int32   x, y, xstart, ystart;
-PIX      *pix1;
-BOX      *box;
-BOXA     *boxa;
-L_STACK  *stack, *auxstack;
+BOXA   *boxa;
+L_RLE  *rle;
 
     PROCNAME("pixConnCompBB");
 
@@ -320,54 +291,57 @@ L_STACK  *stack, *auxstack;
     if (connectivity != 4 && connectivity != 8)
         return (BOXA *)ERROR_PTR("connectivity not 4 or 8", procName, NULL);
 
-    boxa = NULL;
-    pix1 = NULL;
-    stack = NULL;
-    pixZero(pixs, &iszero);
-    if (iszero)
-        return boxaCreate(1);  /* return empty boxa */
-
-    pixSetPadBits(pixs, 0);
-    if ((pix1 = pixCopy(NULL, pixs)) == NULL)
-        return (BOXA *)ERROR_PTR("pix1 not made", procName, NULL);
-
-    h = pixGetHeight(pixs);
-    if ((stack = lstackCreate(h)) == NULL) {
-        L_ERROR("stack not made\n", procName);
-        goto cleanup;
-    }
-    auxstack = lstackCreate(0);
-    stack->auxstack = auxstack;
-    boxa = boxaCreate(0);
-
-    xstart = 0;
-    ystart = 0;
-    while (1) {
-        if (!nextOnPixelInRaster(pix1, xstart, ystart, &x, &y))
-            break;
-
-        if ((box = pixSeedfillBB(pix1, stack, x, y, connectivity)) == NULL) {
-            L_ERROR("box not made\n", procName);
-            boxaDestroy(&boxa);
-            goto cleanup;
-        }
-        boxaAddBox(boxa, box, L_INSERT);
+    if ((rle = pixConvertToRle(pixs)) == NULL)
+        return (BOXA *)ERROR_PTR("rle not made", procName, NULL);
+    boxa = rleConnCompBB(rle, connectivity);
+    rleDestroy(&rle);
+    return boxa;
+}
 
-        xstart = x;
-        ystart = y;
-    }
 
-#if  DEBUG
-    pixCountPixels(pix1, &iszero, NULL);
-    fprintf(stderr, "Number of remaining pixels = %d\n", iszero);
-    lept_mkdir("lept/cc");
-    pixWriteDebug("/tmp/lept/cc/remain.png", pix1, IFF_PNG);
-#endif  /* DEBUG */
-
-        /* Cleanup, freeing the fillsegs on each stack */
-cleanup:
-    lstackDestroy(&stack, TRUE);
-    pixDestroy(&pix1);
+/*!
+ * \brief   pixConnCompBBCompact()
+ *
+ * \param[in]    pixs           1 bpp
+ * \param[in]    connectivity   4 or 8
+ * \return  boxa, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *     (1) This is the same as pixConnCompBB(), except that the returned
+ *         boxa is compact (see boxaCreateCompact()), so no box is
+ *         allocated for the components.  Use it for images with many
+ *         components, when only the geometry is needed.
+ *     (2) A box taken from the returned boxa with boxaGetBox() is not
+ *         stored in it, even with L_CLONE.  Use boxaReplaceBox() to
+ *         change a box in the boxa.
+ * </pre>
+ */
+BOXA *
+pixConnCompBBCompact(PIX     *pixs,
+                     l_int32  connectivity)
+{
+l_int32   ncomp;
+l_int32  *comp;
+BOXA     *boxa;
+L_RLE    *rle;
+
+    PROCNAME("pixConnCompBBCompact");
+
+    if (!pixs || pixGetDepth(pixs) != 1)
+        return (BOXA *)ERROR_PTR("pixs undefined or not 1 bpp", procName, NULL);
+    if (connectivity != 4 && connectivity != 8)
+        return (BOXA *)ERROR_PTR("connectivity not 4 or 8", procName, NULL);
+
+    if ((rle = pixConvertToRle(pixs)) == NULL)
+        return (BOXA *)ERROR_PTR("rle not made", procName, NULL);
+    if (connCompRunsLow(rle, connectivity, &comp, &ncomp)) {
+        rleDestroy(&rle);
+        return (BOXA *)ERROR_PTR("runs not labelled", procName, NULL);
+    }
+    connCompStatsLow(rle, comp, ncomp, 1, &boxa, NULL, NULL);
+    LEPT_FREE(comp);
+    rleDestroy(&rle);
     return boxa;
 }
 
@@ -383,18 +357,15 @@ cleanup:
  * Notes:
  *     (1 This is the top-level call for getting the number of
  *         4- or 8-connected components in a 1 bpp image.
- *     2 It works on a copy of the input pix.  The c.c. are located
- *         in raster order and erased one at a time.
+ *     2 The c.c. are found by union-find on the runs of pixs.
  */
 l_ok
 pixCountConnComp(PIX      *pixs,
                  l_int32   connectivity,
                  l_int32  *pcount)
 {
-l_int32   h, iszero;
-l_int32   x, y, xstart, ystart;
-PIX      *pix1;
-L_STACK  *stack, *auxstack;
+l_int32  ret;
+L_RLE   *rle;
 
     PROCNAME("pixCountConnComp");
 
@@ -406,37 +377,370 @@ L_STACK  *stack, *auxstack;
     if (connectivity != 4 && connectivity != 8)
         return ERROR_INT("connectivity not 4 or 8", procName, 1);
 
-    stack = NULL;
-    pixZero(pixs, &iszero);
-    if (iszero)
-        return 0;
+    if ((rle = pixConvertToRle(pixs)) == NULL)
+        return ERROR_INT("rle not made", procName, 1);
+    ret = rleCountConnComp(rle, connectivity, pcount);
+    rleDestroy(&rle);
+    return ret;
+}
+
+
+/*-----------------------------------------------------------------------*
+ *            Connected components of a run-length encoded image         *
+ *-----------------------------------------------------------------------*/
+/*!
+ * \brief   rleConnCompBB()
+ *
+ * \param[in]    rle
+ * \param[in]    connectivity   4 or 8
+ * \return  boxa, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *     (1) This is the same as pixConnCompBB(), working directly
+ *         on the runs of an L_Rle.
+ * </pre>
+ */
+BOXA *
+rleConnCompBB(L_RLE   *rle,
+              l_int32  connectivity)
+{
+l_int32   ncomp;
+l_int32  *comp;
+BOXA     *boxa;
+
+    PROCNAME("rleConnCompBB");
+
+    if (!rle)
+        return (BOXA *)ERROR_PTR("rle not defined", procName, NULL);
+    if (connectivity != 4 && connectivity != 8)
+        return (BOXA *)ERROR_PTR("connectivity not 4 or 8", procName, NULL);
+
+    if (connCompRunsLow(rle, connectivity, &comp, &ncomp))
+        return (BOXA *)ERROR_PTR("runs not labelled", procName, NULL);
+    connCompStatsLow(rle, comp, ncomp, 0, &boxa, NULL, NULL);
+    LEPT_FREE(comp);
+    return boxa;
+}
+
+
+/*!
+ * \brief   rleCountConnComp()
+ *
+ * \param[in]    rle
+ * \param[in]    connectivity   4 or 8
+ * \param[out]   pcount
+ * \return  0 if OK, 1 on error
+ */
+l_ok
+rleCountConnComp(L_RLE    *rle,
+                 l_int32   connectivity,
+                 l_int32  *pcount)
+{
+l_int32  *comp;
+
+    PROCNAME("rleCountConnComp");
+
+    if (!pcount)
+        return ERROR_INT("&count not defined", procName, 1);
+    *pcount = 0;
+    if (!rle)
+        return ERROR_INT("rle not defined", procName, 1);
+    if (connectivity != 4 && connectivity != 8)
+        return ERROR_INT("connectivity not 4 or 8", procName, 1);
+
+    if (connCompRunsLow(rle, connectivity, &comp, pcount))
+        return ERROR_INT("runs not labelled", procName, 1);
+    LEPT_FREE(comp);
+    return 0;
+}
+
+
+/*-----------------------------------------------------------------------*
+ *        Connected components by union-find on runs: labels, b.b.,      *
+ *                       areas and centroids                             *
+ *-----------------------------------------------------------------------*/
+/*!
+ * \brief   pixConnCompLabel()
+ *
+ * \param[in]    pixs           1 bpp
+ * \param[in]    connectivity   4 or 8
+ * \param[in]    depth          of pixd: 8, 16 or 32 bpp; use 0 for auto
+ *                              determination; ignored if &pixd == NULL
+ * \param[out]   ppixd          [optional] label image
+ * \param[out]   pboxa          [optional] b.b. of each c.c.
+ * \param[out]   pnaa           [optional] area (number of pixels) of each c.c.
+ * \param[out]   ppta           [optional] centroid of each c.c.
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) All of the requested outputs are found from a single labeling
+ *          of the runs in pixs; see the discussion at the top of this file.
+ *          The c.c. are indexed in the raster order of their first
+ *          pixel, which is the same order as for pixConnComp().
+ *      (2) In pixd, the bg is labelled 0.  If %depth == 0, the depth is
+ *          8 if the number of c.c. is less than 254, 16 if the number
+ *          is less than 0xfffe, and 32 otherwise.  The n-th c.c. is
+ *          labelled 1 + n % 254 for 8 bpp, 1 + n % 0xfffe for 16 bpp,
+ *          and 1 + n for 32 bpp.  This is the same as for
+ *          pixConnCompTransform().
+ *      (3) The centroid of a c.c. is the average of the (x, y)
+ *          coordinates of its pixels.
+ *      (4) If pixs is empty, the boxa, numa and pta are empty, and
+ *          pixd has all pixels 0.
+ * </pre>
+ */
+l_ok
+pixConnCompLabel(PIX     *pixs,
+                 l_int32  connectivity,
+                 l_int32  depth,
+                 PIX    **ppixd,
+                 BOXA   **pboxa,
+                 NUMA   **pnaa,
+                 PTA    **ppta)
+{
+l_int32    i, j, k, w, h, ncomp, label, wpld;
+l_int32   *comp;
+l_uint32  *lined;
+PIX       *pixd;
+L_RLE     *rle;
+
+    PROCNAME("pixConnCompLabel");
+
+    if (ppixd) *ppixd = NULL;
+    if (pboxa) *pboxa = NULL;
+    if (pnaa) *pnaa = NULL;
+    if (ppta) *ppta = NULL;
+    if (!ppixd && !pboxa && !pnaa && !ppta)
+        return ERROR_INT("no output requested", procName, 1);
+    if (!pixs || pixGetDepth(pixs) != 1)
+        return ERROR_INT("pixs undefined or not 1 bpp", procName, 1);
+    if (connectivity != 4 && connectivity != 8)
+        return ERROR_INT("connectivity not 4 or 8", procName, 1);
+    if (depth != 0 && depth != 8 && depth != 16 && depth != 32)
+        return ERROR_INT("depth must be 0, 8, 16 or 32", procName, 1);
+
+    if ((rle = pixConvertToRle(pixs)) == NULL)
+        return ERROR_INT("rle not made", procName, 1);
+    if (connCompRunsLow(rle, connectivity, &comp, &ncomp)) {
+        rleDestroy(&rle);
+        return ERROR_INT("runs not labelled", procName, 1);
+    }
+    if (pboxa || pnaa || ppta)
+        connCompStatsLow(rle, comp, ncomp, 0, pboxa, pnaa, ppta);
+
+    if (ppixd) {
+        if (depth == 0) {
+            if (ncomp < 254)
+                depth = 8;
+            else if (ncomp < 0xfffe)
+                depth = 16;
+            else
+                depth = 32;
+        }
+        pixGetDimensions(pixs, &w, &h, NULL);
+        pixd = pixCreate(w, h, depth);
+        pixSetSpp(pixd, 1);
+        pixCopyResolution(pixd, pixs);
+        wpld = pixGetWpl(pixd);
+        for (i = 0; i < h; i++) {
+            lined = pixGetData(pixd) + i * wpld;
+            for (k = rle->linestart[i]; k < rle->linestart[i + 1]; k++) {
+                if (depth == 8) {
+                    label = 1 + (comp[k] % 254);
+                    for (j = rle->x0[k]; j <= rle->x1[k]; j++)
+                        SET_DATA_BYTE(lined, j, label);
+                } else if (depth == 16) {
+                    label = 1 + (comp[k] % 0xfffe);
+                    for (j = rle->x0[k]; j <= rle->x1[k]; j++)
+                        SET_DATA_TWO_BYTES(lined, j, label);
+                } else {  /* depth == 32 */
+                    label = 1 + comp[k];
+                    for (j = rle->x0[k]; j <= rle->x1[k]; j++)
+                        lined[j] = label;
+                }
+            }
+        }
+        *ppixd = pixd;
+    }
+
+    LEPT_FREE(comp);
+    rleDestroy(&rle);
+    return 0;
+}
+
+
+/*!
+ * \brief   connCompRunsLow()
+ *
+ * \param[in]    rle
+ * \param[in]    connectivity   4 or 8
+ * \param[out]   pcomp          array of the c.c. index of each run
+ * \param[out]   pncomp         number of c.c.
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) The runs are visited in raster order.  Each is joined to the
+ *          runs in the previous line that it touches, using union-find.
+ *          The union always makes the earlier run the root, so each
+ *          root is the first run of its c.c., and all parents precede
+ *          their children.  That allows the c.c. indices to be
+ *          assigned, in raster order of the first pixel, in one sweep.
+ *      (2) The returned array must be freed by the caller.  It is
+ *          allocated even if there are no runs.
+ * </pre>
+ */
+static l_int32
+connCompRunsLow(L_RLE     *rle,
+                l_int32    connectivity,
+                l_int32  **pcomp,
+                l_int32   *pncomp)
+{
+l_int32   i, j, n, ncomp, off, p, pend, q, ra, rb;
+l_int32  *x0, *x1, *parent, *comp;
+
+    PROCNAME("connCompRunsLow");
+
+    *pcomp = NULL;
+    *pncomp = 0;
+    n = L_MAX(1, rle->nruns);
+    comp = (l_int32 *)LEPT_CALLOC(n, sizeof(l_int32));
+    parent = (l_int32 *)LEPT_CALLOC(n, sizeof(l_int32));
+    if (!comp || !parent) {
+        LEPT_FREE(comp);
+        LEPT_FREE(parent);
+        return ERROR_INT("label arrays not made", procName, 1);
+    }
+
+        /* Join each run to the runs in the previous line that it
+         * touches.  For 8-connectivity, runs that touch diagonally
+         * are also joined.  */
+    x0 = rle->x0;
+    x1 = rle->x1;
+    off = (connectivity == 4) ? 0 : 1;
+    for (i = 0; i < rle->h; i++) {
+        p = (i > 0) ? rle->linestart[i - 1] : 0;
+        pend = rle->linestart[i];
+        for (j = rle->linestart[i]; j < rle->linestart[i + 1]; j++) {
+            parent[j] = j;
+            while (p < pend && x1[p] + off < x0[j])
+                p++;
+            for (q = p; q < pend && x0[q] <= x1[j] + off; q++) {
+                for (ra = j; parent[ra] != ra; ra = parent[ra])
+                    parent[ra] = parent[parent[ra]];
+                for (rb = q; parent[rb] != rb; rb = parent[rb])
+                    parent[rb] = parent[parent[rb]];
+                if (ra < rb)
+                    parent[rb] = ra;
+                else if (rb < ra)
+                    parent[ra] = rb;
+            }
+        }
+    }
+
+        /* Second pass: each parent precedes its children, so in raster
+         * order each parent is already pointing at its root */
+    ncomp = 0;
+    for (j = 0; j < rle->nruns; j++) {
+        if (parent[j] == j) {
+            comp[j] = ncomp++;
+        } else {
+            parent[j] = parent[parent[j]];
+            comp[j] = comp[parent[j]];
+        }
+    }
 
-    pixSetPadBits(pixs, 0);
-    if ((pix1 = pixCopy(NULL, pixs)) == NULL)
-        return ERROR_INT("pix1 not made", procName, 1);
-    h = pixGetHeight(pixs);
-    if ((stack = lstackCreate(h)) == NULL) {
-        pixDestroy(&pix1);
-        return ERROR_INT("stack not made\n", procName, 1);
+    LEPT_FREE(parent);
+    *pcomp = comp;
+    *pncomp = ncomp;
+    return 0;
+}
+
+
+/*!
+ * \brief   connCompStatsLow()
+ *
+ * \param[in]    rle
+ * \param[in]    comp, ncomp   from connCompRunsLow()
+ * \param[in]    compact  1 to make the boxa compact; 0 otherwise
+ * \param[out]   pboxa    [optional] b.b. of each c.c.
+ * \param[out]   pnaa     [optional] area of each c.c.
+ * \param[out]   ppta     [optional] centroid of each c.c.
+ * \return  0 if OK, 1 on error
+ */
+static l_int32
+connCompStatsLow(L_RLE    *rle,
+                 l_int32  *comp,
+                 l_int32   ncomp,
+                 l_int32   compact,
+                 BOXA    **pboxa,
+                 NUMA    **pnaa,
+                 PTA     **ppta)
+{
+l_int32     i, k, c, len, n;
+l_int32    *xmin, *xmax, *ymin, *ymax, *area;
+l_float64  *xsum, *ysum;
+
+    PROCNAME("connCompStatsLow");
+
+    n = L_MAX(1, ncomp);
+    xmin = (l_int32 *)LEPT_CALLOC(n, sizeof(l_int32));
+    xmax = (l_int32 *)LEPT_CALLOC(n, sizeof(l_int32));
+    ymin = (l_int32 *)LEPT_CALLOC(n, sizeof(l_int32));
+    ymax = (l_int32 *)LEPT_CALLOC(n, sizeof(l_int32));
+    area = (l_int32 *)LEPT_CALLOC(n, sizeof(l_int32));
+    xsum = (l_float64 *)LEPT_CALLOC(n, sizeof(l_float64));
+    ysum = (l_float64 *)LEPT_CALLOC(n, sizeof(l_float64));
+    if (!xmin || !xmax || !ymin || !ymax || !area || !xsum || !ysum) {
+        L_ERROR("stats arrays not made\n", procName);
+        ncomp = 0;
+    }
+
+    for (i = 0; i < ncomp; i++) {
+        xmin[i] = ymin[i] = 0x7fffffff;
+        xmax[i] = ymax[i] = -1;
+    }
+    for (i = 0; i < rle->h && ncomp > 0; i++) {
+        for (k = rle->linestart[i]; k < rle->linestart[i + 1]; k++) {
+            c = comp[k];
+            len = rle->x1[k] - rle->x0[k] + 1;
+            xmin[c] = L_MIN(xmin[c], rle->x0[k]);
+            xmax[c] = L_MAX(xmax[c], rle->x1[k]);
+            ymin[c] = L_MIN(ymin[c], i);
+            ymax[c] = L_MAX(ymax[c], i);
+            area[c] += len;
+            xsum[c] += 0.5 * (l_float64)len * (rle->x0[k] + rle->x1[k]);
+            ysum[c] += (l_float64)len * i;
+        }
+    }
+
+    if (pboxa) {
+        *pboxa = (compact) ? boxaCreateCompact(n) : boxaCreate(n);
+        for (i = 0; i < ncomp; i++) {
+            boxaAddBoxGeometry(*pboxa, xmin[i], ymin[i],
+                               xmax[i] - xmin[i] + 1, ymax[i] - ymin[i] + 1);
+        }
+    }
+    if (pnaa) {
+        *pnaa = numaCreate(n);
+        for (i = 0; i < ncomp; i++)
+            numaAddNumber(*pnaa, area[i]);
     }
-    auxstack = lstackCreate(0);
-    stack->auxstack = auxstack;
-
-    xstart = 0;
-    ystart = 0;
-    while (1) {
-        if (!nextOnPixelInRaster(pix1, xstart, ystart, &x, &y))
-            break;
-
-        pixSeedfill(pix1, stack, x, y, connectivity);
-        (*pcount)++;
-        xstart = x;
-        ystart = y;
+    if (ppta) {
+        *ppta = ptaCreate(n);
+        for (i = 0; i < ncomp; i++)
+            ptaAddPt(*ppta, xsum[i] / area[i], ysum[i] / area[i]);
     }
 
-        /* Cleanup, freeing the fillsegs on each stack */
-    lstackDestroy(&stack, TRUE);
-    pixDestroy(&pix1);
+    LEPT_FREE(xmin);
+    LEPT_FREE(xmax);
+    LEPT_FREE(ymin);
+    LEPT_FREE(ymax);
+    LEPT_FREE(area);
+    LEPT_FREE(xsum);
+    LEPT_FREE(ysum);
     return 0;
 }
 
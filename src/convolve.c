@@ -75,8 +75,13 @@
  *      Convolution with bias (for non-negative output)
  *          PIX          *pixConvolveWithBias()
  *
- *      Set parameter for convolution subsampling
+ *      Recursive gaussian smoothing
+ *          PIX          *pixGaussianRecursive()
+ *          FPIX         *fpixGaussianRecursive()
+ *
+ *      Set parameters for convolution subsampling and FFT
  *          void          l_setConvolveSampling()
+ *          void          l_setConvolveFFT()
  *
  *      Additive gaussian noise
  *          PIX          *pixAddGaussNoise()
@@ -93,6 +98,12 @@
 LEPT_DLL l_int32  ConvolveSamplingFactX = 1;
 LEPT_DLL l_int32  ConvolveSamplingFactY = 1;
 
+    /* This global is the min number of kernel elements for which
+     * pixConvolve() and fpixConvolve() do the convolution by FFT.
+     * The default of 0 never uses the FFT.  Declare extern to use.
+     * To change the value, use l_setConvolveFFT(). */
+LEPT_DLL l_int32  ConvolveMinSizeForFFT = 0;
+
     /* Low-level static functions */
 static void blockconvLow(l_uint32 *data, l_int32 w, l_int32 h, l_int32 wpl,
                          l_uint32 *dataa, l_int32 wpla, l_int32 wc,
@@ -212,7 +223,7 @@ pixBlockconvGray(PIX     *pixs,
                  l_int32  wc,
                  l_int32  hc)
 {
-l_int32    w, h, d, wpl, wpla;
+l_int32    w, h, d, wpld, wpla;
 l_uint32  *datad, *dataa;
 PIX       *pixd, *pixt;
 
@@ -252,11 +263,11 @@ PIX       *pixd, *pixt;
         return (PIX *)ERROR_PTR("pixd not made", procName, NULL);
     }
 
-    wpl = pixGetWpl(pixs);
+    wpld = pixGetWpl(pixd);
     wpla = pixGetWpl(pixt);
     datad = pixGetData(pixd);
     dataa = pixGetData(pixt);
-    blockconvLow(datad, w, h, wpl, dataa, wpla, wc, hc);
+    blockconvLow(datad, w, h, wpld, dataa, wpla, wc, hc);
 
     pixDestroy(&pixt);
     return pixd;
@@ -972,7 +983,7 @@ PIX       *pixt, *pixd;
  *          the mean value; and the square root of the variance is the
  *          root mean square difference from the mean, sometimes also
  *          called the 'standard deviation'.
- *      (5) The added border, along with the use of an accumulator array,
+ *      (5) The added border, along with the use of running column sums,
  *          allows computation without special treatment of pixels near
  *          the image boundary, and runs in a time that is independent
  *          of the size of the convolution kernel.
@@ -1055,9 +1066,11 @@ PIX  *pixb, *pixm, *pixms;
  *      (3) Typically, %normflag == 1.  However, if you want the sum
  *          within the window, rather than a normalized convolution,
  *          use %normflag == 0.
- *      (4) This builds a block accumulator pix, uses it here, and
- *          destroys it.
- *      (5) The added border, along with the use of an accumulator array,
+ *      (4) Rather than building a full block accumulator, this keeps
+ *          a running sum down each column over the rows in the window,
+ *          and slides the window along each row.  The extra memory is
+ *          a single row of sums, and the results are identical.
+ *      (5) The added border, along with the use of running sums,
  *          allows computation without special treatment of pixels near
  *          the image boundary, and runs in a time that is independent
  *          of the size of the convolution kernel.
@@ -1070,11 +1083,12 @@ pixWindowedMean(PIX     *pixs,
                 l_int32  hasborder,
                 l_int32  normflag)
 {
-l_int32    i, j, w, h, d, wd, hd, wplc, wpld, wincr, hincr;
+l_int32    i, j, w, h, d, wd, hd, wplb, wpld, wincr, hincr;
 l_uint32   val;
-l_uint32  *datac, *datad, *linec1, *linec2, *lined;
+l_uint32  *datab, *datad, *lineb, *lineb1, *lineb2, *lined;
+l_uint32  *colsum;
 l_float32  norm;
-PIX       *pixb, *pixc, *pixd;
+PIX       *pixb, *pixd;
 
     PROCNAME("pixWindowedMean");
 
@@ -1086,21 +1100,16 @@ PIX       *pixb, *pixc, *pixd;
     if (wc < 2 || hc < 2)
         return (PIX *)ERROR_PTR("wc and hc not >= 2", procName, NULL);
 
-    pixb = pixc = pixd = NULL;
+    pixd = NULL;
+    colsum = NULL;
 
         /* Add border if requested */
     if (!hasborder)
         pixb = pixAddBorderGeneral(pixs, wc + 1, wc + 1, hc + 1, hc + 1, 0);
     else
         pixb = pixClone(pixs);
-
-        /* Make the accumulator pix from pixb */
-    if ((pixc = pixBlockconvAccum(pixb)) == NULL) {
-        L_ERROR("pixc not made\n", procName);
-        goto cleanup;
-    }
-    wplc = pixGetWpl(pixc);
-    datac = pixGetData(pixc);
+    wplb = pixGetWpl(pixb);
+    datab = pixGetData(pixb);
 
         /* The output has wc + 1 border pixels stripped from each side
          * of pixb, and hc + 1 border pixels stripped from top and bottom. */
@@ -1123,25 +1132,48 @@ PIX       *pixb, *pixc, *pixd;
     norm = 1.0;  /* use this for sum-in-window */
     if (normflag)
         norm = 1.0 / ((l_float32)(wincr) * hincr);
+
+        /* The window for pixel (i, j) in pixd covers rows (i + 1 ...
+         * i + hincr) and columns (j + 1 ... j + wincr) of pixb.
+         * Start the column sums with rows (1 ... hincr). */
+    colsum = (l_uint32 *)LEPT_CALLOC(w, sizeof(l_uint32));
+    for (i = 1; i <= hincr; i++) {
+        lineb = datab + i * wplb;
+        for (j = 0; j < w; j++)
+            colsum[j] += (d == 8) ? GET_DATA_BYTE(lineb, j) : lineb[j];
+    }
+
     for (i = 0; i < hd; i++) {
-        linec1 = datac + i * wplc;
-        linec2 = datac + (i + hincr) * wplc;
-        lined = datad + i * wpld;
-        for (j = 0; j < wd; j++) {
-            val = linec2[j + wincr] - linec2[j] - linec1[j + wincr] + linec1[j];
+        if (i > 0) {  /* move the column sums down by one row */
+            lineb1 = datab + i * wplb;
+            lineb2 = datab + (i + hincr) * wplb;
             if (d == 8) {
-                val = (l_uint8)(norm * val);
-                SET_DATA_BYTE(lined, j, val);
+                for (j = 0; j < w; j++)
+                    colsum[j] += GET_DATA_BYTE(lineb2, j) -
+                                 GET_DATA_BYTE(lineb1, j);
             } else {  /* d == 32 */
-                val = (l_uint32)(norm * val);
-                lined[j] = val;
+                for (j = 0; j < w; j++)
+                    colsum[j] += lineb2[j] - lineb1[j];
             }
         }
+
+        lined = datad + i * wpld;
+        val = 0;
+        for (j = 1; j <= wincr; j++)
+            val += colsum[j];
+        for (j = 0; j < wd; j++) {
+            if (j > 0)
+                val += colsum[j + wincr] - colsum[j];
+            if (d == 8)
+                SET_DATA_BYTE(lined, j, (l_uint8)(norm * val));
+            else  /* d == 32 */
+                lined[j] = (l_uint32)(norm * val);
+        }
     }
 
 cleanup:
     pixDestroy(&pixb);
-    pixDestroy(&pixc);
+    LEPT_FREE(colsum);
     return pixd;
 }
 
@@ -1174,7 +1206,11 @@ cleanup:
  *          to satisfy this condition?  Answer: the accumulators
  *          are asymmetric, requiring an extra row and column of
  *          pixels at top and left to work accurately.
- *      (4) The added border, along with the use of an accumulator array,
+ *      (4) As with pixWindowedMean(), this keeps a running sum of
+ *          squares down each column, rather than building the full
+ *          64 bit accumulator of pixMeanSquareAccum().  The extra memory
+ *          is a single row of sums, and the results are identical.
+ *      (5) The added border, along with the use of running sums,
  *          allows computation without special treatment of pixels near
  *          the image boundary, and runs in a time that is independent
  *          of the size of the convolution kernel.
@@ -1186,13 +1222,12 @@ pixWindowedMeanSquare(PIX     *pixs,
                       l_int32  hc,
                       l_int32  hasborder)
 {
-l_int32     i, j, w, h, wd, hd, wpl, wpld, wincr, hincr;
+l_int32     i, j, w, h, wd, hd, wplb, wpld, wincr, hincr, val1, val2;
 l_uint32    ival;
-l_uint32   *datad, *lined;
+l_uint32   *datab, *datad, *lineb, *lineb1, *lineb2, *lined;
 l_float64   norm;
 l_float64   val;
-l_float64  *data, *line1, *line2;
-DPIX       *dpix;
+l_float64  *colsum;
 PIX        *pixb, *pixd;
 
     PROCNAME("pixWindowedMeanSquare");
@@ -1203,19 +1238,15 @@ PIX        *pixb, *pixd;
         return (PIX *)ERROR_PTR("wc and hc not >= 2", procName, NULL);
 
     pixd = NULL;
+    colsum = NULL;
 
         /* Add border if requested */
     if (!hasborder)
         pixb = pixAddBorderGeneral(pixs, wc + 1, wc + 1, hc + 1, hc + 1, 0);
     else
         pixb = pixClone(pixs);
-
-    if ((dpix = pixMeanSquareAccum(pixb)) == NULL) {
-        L_ERROR("dpix not made\n", procName);
-        goto cleanup;
-    }
-    wpl = dpixGetWpl(dpix);
-    data = dpixGetData(dpix);
+    wplb = pixGetWpl(pixb);
+    datab = pixGetData(pixb);
 
         /* The output has wc + 1 border pixels stripped from each side
          * of pixb, and hc + 1 border pixels stripped from top and bottom. */
@@ -1236,20 +1267,43 @@ PIX        *pixb, *pixd;
     wincr = 2 * wc + 1;
     hincr = 2 * hc + 1;
     norm = 1.0 / ((l_float32)(wincr) * hincr);
+
+        /* Start the column sums of squares with rows (1 ... hincr) */
+    colsum = (l_float64 *)LEPT_CALLOC(w, sizeof(l_float64));
+    for (i = 1; i <= hincr; i++) {
+        lineb = datab + i * wplb;
+        for (j = 0; j < w; j++) {
+            val1 = GET_DATA_BYTE(lineb, j);
+            colsum[j] += (l_float64)(val1 * val1);
+        }
+    }
+
     for (i = 0; i < hd; i++) {
-        line1 = data + i * wpl;
-        line2 = data + (i + hincr) * wpl;
+        if (i > 0) {  /* move the column sums down by one row */
+            lineb1 = datab + i * wplb;
+            lineb2 = datab + (i + hincr) * wplb;
+            for (j = 0; j < w; j++) {
+                val1 = GET_DATA_BYTE(lineb1, j);
+                val2 = GET_DATA_BYTE(lineb2, j);
+                colsum[j] += (l_float64)(val2 * val2 - val1 * val1);
+            }
+        }
+
         lined = datad + i * wpld;
+        val = 0.0;
+        for (j = 1; j <= wincr; j++)
+            val += colsum[j];
         for (j = 0; j < wd; j++) {
-            val = line2[j + wincr] - line2[j] - line1[j + wincr] + line1[j];
+            if (j > 0)
+                val += colsum[j + wincr] - colsum[j];
             ival = (l_uint32)(norm * val + 0.5);  /* to round up */
             lined[j] = ival;
         }
     }
 
 cleanup:
-    dpixDestroy(&dpix);
     pixDestroy(&pixb);
+    LEPT_FREE(colsum);
     return pixd;
 }
 
@@ -1868,6 +1922,11 @@ PIX       *pixav, *pixd;
  *          each pixel-op in the convolution.  For example, with a 3 GHz
  *          cpu, a 1 Mpixel grayscale image, and a kernel with
  *          (sx * sy) = 25 elements, the convolution takes about 100 msec.
+ *      (9) If enabled with l_setConvolveFFT(), for large kernels and
+ *          no subsampling this calls pixConvolveFFT(), whose time does
+ *          not depend on the kernel size.  The result can then differ
+ *          by 1 in some pixels, due to rounding.  By default the FFT
+ *          is not used.
  * </pre>
  */
 PIX *
@@ -1895,6 +1954,12 @@ PIX       *pixt, *pixd;
     if (!kel)
         return (PIX *)ERROR_PTR("kel not defined", procName, NULL);
 
+        /* For a large kernel, use the FFT */
+    kernelGetParameters(kel, &sy, &sx, NULL, NULL);
+    if (ConvolveMinSizeForFFT > 0 && ConvolveSamplingFactX == 1 &&
+        ConvolveSamplingFactY == 1 && sx * sy >= ConvolveMinSizeForFFT)
+        return pixConvolveFFT(pixs, kel, outdepth, normflag);
+
     pixd = NULL;
 
     keli = kernelInvert(kel);
@@ -2191,6 +2256,9 @@ PIX  *pixt, *pixr, *pixg, *pixb, *pixd;
  *          product of the sampling factors.
  *      (5) This uses a mirrored border to avoid special casing on
  *          the boundaries.
+ *      (6) If enabled with l_setConvolveFFT(), for large kernels and
+ *          no subsampling this calls fpixConvolveFFT().  The result
+ *          can then differ slightly, due to rounding.
  * </pre>
  */
 FPIX *
@@ -2212,6 +2280,12 @@ FPIX       *fpixt, *fpixd;
     if (!kel)
         return (FPIX *)ERROR_PTR("kel not defined", procName, NULL);
 
+        /* For a large kernel, use the FFT */
+    kernelGetParameters(kel, &sy, &sx, NULL, NULL);
+    if (ConvolveMinSizeForFFT > 0 && ConvolveSamplingFactX == 1 &&
+        ConvolveSamplingFactY == 1 && sx * sy >= ConvolveMinSizeForFFT)
+        return fpixConvolveFFT(fpixs, kel, normflag);
+
     fpixd = NULL;
 
     keli = kernelInvert(kel);
@@ -2440,7 +2514,190 @@ PIX       *pixd;
 
 
 /*------------------------------------------------------------------------*
- *                Set parameter for convolution subsampling               *
+ *                     Recursive gaussian smoothing                       *
+ *------------------------------------------------------------------------*/
+/*!
+ * \brief   pixGaussianRecursive()
+ *
+ * \param[in]    pix      8 or 32 bpp; or 2, 4 or 8 bpp with colormap
+ * \param[in]    sigma    standard deviation of the gaussian; >= 0.5
+ * \return  pixd 8 or 32 bpp, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This approximates convolution with a gaussian using the
+ *          recursive filter of Young and van Vliet; see
+ *          fpixGaussianRecursive().  The time is independent of
+ *          %sigma, so it is much faster than pixConvolveSep()
+ *          with a gaussian kernel for large %sigma.
+ *      (2) Each rgb component of a 32 bpp image is smoothed separately.
+ * </pre>
+ */
+PIX *
+pixGaussianRecursive(PIX       *pix,
+                     l_float32  sigma)
+{
+l_int32  d, i;
+FPIX    *fpix1, *fpix2;
+PIX     *pixs, *pixd, *pix1, *pixc[3];
+
+    PROCNAME("pixGaussianRecursive");
+
+    if (!pix)
+        return (PIX *)ERROR_PTR("pix not defined", procName, NULL);
+    if (sigma < 0.5)
+        return (PIX *)ERROR_PTR("sigma < 0.5", procName, NULL);
+
+        /* Remove colormap if necessary */
+    d = pixGetDepth(pix);
+    if ((d == 2 || d == 4 || d == 8) && pixGetColormap(pix)) {
+        L_WARNING("pix has colormap; removing\n", procName);
+        pixs = pixRemoveColormap(pix, REMOVE_CMAP_BASED_ON_SRC);
+        d = pixGetDepth(pixs);
+    } else {
+        pixs = pixClone(pix);
+    }
+    if (d != 8 && d != 32) {
+        pixDestroy(&pixs);
+        return (PIX *)ERROR_PTR("depth not 8 or 32 bpp", procName, NULL);
+    }
+
+    if (d == 8) {
+        fpix1 = pixConvertToFPix(pixs, 1);
+        fpix2 = fpixGaussianRecursive(fpix1, sigma);
+        pixd = fpixConvertToPix(fpix2, 8, L_CLIP_TO_ZERO, 0);
+        fpixDestroy(&fpix1);
+        fpixDestroy(&fpix2);
+    } else {  /* d == 32 */
+        for (i = 0; i < 3; i++) {
+            pix1 = pixGetRGBComponent(pixs, COLOR_RED + i);
+            fpix1 = pixConvertToFPix(pix1, 1);
+            fpix2 = fpixGaussianRecursive(fpix1, sigma);
+            pixc[i] = fpixConvertToPix(fpix2, 8, L_CLIP_TO_ZERO, 0);
+            pixDestroy(&pix1);
+            fpixDestroy(&fpix1);
+            fpixDestroy(&fpix2);
+        }
+        pixd = pixCreateRGBImage(pixc[0], pixc[1], pixc[2]);
+        for (i = 0; i < 3; i++)
+            pixDestroy(&pixc[i]);
+    }
+
+    pixCopyResolution(pixd, pixs);
+    pixDestroy(&pixs);
+    return pixd;
+}
+
+
+/*!
+ * \brief   fpixGaussianRecursive()
+ *
+ * \param[in]    fpixs
+ * \param[in]    sigma    standard deviation of the gaussian; >= 0.5
+ * \return  fpixd, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This is the recursive gaussian filter of I.T. Young and
+ *          L.J. van Vliet, "Recursive implementation of the Gaussian
+ *          filter", Signal Processing 44 (1995), pp. 139-151.  Along
+ *          each line and column, a causal third-order filter
+ *              w[n] = B * x[n] + a1 * w[n-1] + a2 * w[n-2] + a3 * w[n-3]
+ *          is followed by the same filter in the anti-causal direction.
+ *          The cost is 4 passes of 4 multiplications per pixel,
+ *          independent of %sigma.
+ *      (2) The filter coefficients sum to 1, so a constant is unchanged.
+ *          Pixels outside the image are taken to be equal to the
+ *          nearest edge pixel.  With that boundary condition the first
+ *          pixel of each causal pass and the last pixel of each
+ *          anti-causal pass are unchanged, and the pixels before and
+ *          after the edges can be taken from the edge pixel itself.
+ *      (3) The vertical passes are done a full line at a time, so
+ *          the inner loop runs along the raster lines for all columns
+ *          together.
+ *      (4) The impulse response differs from the gaussian by at most
+ *          about 7 percent of its peak value for small %sigma, and by
+ *          less than 3 percent for %sigma >= 8.
+ * </pre>
+ */
+FPIX *
+fpixGaussianRecursive(FPIX      *fpixs,
+                      l_float32  sigma)
+{
+l_int32     i, j, w, h, wpl;
+l_float32  *datad, *line, *line1, *line2, *line3;
+l_float64   q, b0, b1, b2, b3, a1, a2, a3, bn;
+FPIX       *fpixd;
+
+    PROCNAME("fpixGaussianRecursive");
+
+    if (!fpixs)
+        return (FPIX *)ERROR_PTR("fpixs not defined", procName, NULL);
+    if (sigma < 0.5)
+        return (FPIX *)ERROR_PTR("sigma < 0.5", procName, NULL);
+
+        /* Coefficients from Young and van Vliet (1995) */
+    if (sigma >= 2.5)
+        q = 0.98711 * sigma - 0.96330;
+    else
+        q = 3.97156 - 4.14554 * sqrt(1.0 - 0.26891 * sigma);
+    b0 = 1.57825 + 2.44413 * q + 1.4281 * q * q + 0.422205 * q * q * q;
+    b1 = 2.44413 * q + 2.85619 * q * q + 1.26661 * q * q * q;
+    b2 = -1.4281 * q * q - 1.26661 * q * q * q;
+    b3 = 0.422205 * q * q * q;
+    a1 = b1 / b0;
+    a2 = b2 / b0;
+    a3 = b3 / b0;
+    bn = 1.0 - (a1 + a2 + a3);
+
+    if ((fpixd = fpixCopy(NULL, fpixs)) == NULL)
+        return (FPIX *)ERROR_PTR("fpixd not made", procName, NULL);
+    fpixGetDimensions(fpixd, &w, &h);
+    datad = fpixGetData(fpixd);
+    wpl = fpixGetWpl(fpixd);
+
+        /* Horizontal passes */
+    for (i = 0; i < h; i++) {
+        line = datad + i * wpl;
+        for (j = 1; j < w; j++) {
+            line[j] = bn * line[j] + a1 * line[j - 1] +
+                      a2 * line[L_MAX(0, j - 2)] + a3 * line[L_MAX(0, j - 3)];
+        }
+        for (j = w - 2; j >= 0; j--) {
+            line[j] = bn * line[j] + a1 * line[j + 1] +
+                      a2 * line[L_MIN(w - 1, j + 2)] +
+                      a3 * line[L_MIN(w - 1, j + 3)];
+        }
+    }
+
+        /* Vertical passes */
+    for (i = 1; i < h; i++) {
+        line = datad + i * wpl;
+        line1 = datad + (i - 1) * wpl;
+        line2 = datad + L_MAX(0, i - 2) * wpl;
+        line3 = datad + L_MAX(0, i - 3) * wpl;
+        for (j = 0; j < w; j++) {
+            line[j] = bn * line[j] + a1 * line1[j] + a2 * line2[j] +
+                      a3 * line3[j];
+        }
+    }
+    for (i = h - 2; i >= 0; i--) {
+        line = datad + i * wpl;
+        line1 = datad + (i + 1) * wpl;
+        line2 = datad + L_MIN(h - 1, i + 2) * wpl;
+        line3 = datad + L_MIN(h - 1, i + 3) * wpl;
+        for (j = 0; j < w; j++) {
+            line[j] = bn * line[j] + a1 * line1[j] + a2 * line2[j] +
+                      a3 * line3[j];
+        }
+    }
+
+    return fpixd;
+}
+
+
+/*------------------------------------------------------------------------*
+ *         Set parameters for convolution subsampling and FFT             *
  *------------------------------------------------------------------------*/
 /*!
  * \brief   l_setConvolveSampling()
@@ -2466,6 +2723,30 @@ l_setConvolveSampling(l_int32  xfact,
 }
 
 
+/*!
+ * \brief   l_setConvolveFFT()
+ *
+ * \param[in]    minsize     min number of kernel elements for using
+ *                           the FFT; 0 to never use it
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) This sets the kernel size at and above which pixConvolve()
+ *          and fpixConvolve() do the convolution by FFT, when there
+ *          is no subsampling.  The default is 0, which never uses it.
+ *      (2) The FFT result can differ from the direct convolution by
+ *          rounding; for 8 bpp output, by 1 in some pixels.  A value
+ *          of about 400 is where the FFT becomes faster.
+ * </pre>
+ */
+void
+l_setConvolveFFT(l_int32  minsize)
+{
+    ConvolveMinSizeForFFT = L_MAX(0, minsize);
+}
+
+
 /*------------------------------------------------------------------------*
  *                          Additive gaussian noise                       *
  *------------------------------------------------------------------------*/
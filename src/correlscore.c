@@ -38,6 +38,12 @@
  *         l_int32     pixCorrelationScoreSimple()
  *         l_int32     pixCorrelationScoreShifted()
  *
+ *     Correlation counts over a window of shifts
+ *         l_int32     pixCorrelationCountShifts()
+ *
+ *     Static helper
+ *         static l_uint32  getShiftedWord()
+ *
  *     There are other, more application-oriented functions, that
  *     compute the correlation between two binary images, taking into
  *     account small translational shifts, between two binary images.
@@ -46,11 +52,31 @@
  *                        Uses coarse-to-fine translations of full image
  *         recogident.c:  pixCorrelationBestShift()
  *                        Uses small shifts between c.c. centroids.
+ *     Both of these use pixCorrelationCountShifts() to evaluate a
+ *     window of shifts in a single pass over the rows of the template.
+ *
+ *     The number of ON pixels in the AND of two words is found with
+ *     the popcount instruction when compiled with gcc or clang.  Otherwise
+ *     it is the sum of byte lookups in the table from makePixelSumTab8().
  */
 
+#include <string.h>
 #include <math.h>
 #include "allheaders.h"
 
+    /* Number of ON pixels in a 32-bit word */
+#if defined(__GNUC__)
+#define  USE_PIXEL_SUM_TAB   0
+#define COUNT_ON_BITS(word, tab)   __builtin_popcount(word)
+#else
+#define  USE_PIXEL_SUM_TAB   1
+#define COUNT_ON_BITS(word, tab) \
+    ((tab)[(word) & 0xff] + (tab)[((word) >> 8) & 0xff] + \
+     (tab)[((word) >> 16) & 0xff] + (tab)[(word) >> 24])
+#endif  /* __GNUC__ */
+
+static l_uint32 getShiftedWord(l_uint32 *line, l_int32 nwords, l_int32 bit);
+
 
 /* -------------------------------------------------------------------- *
  *           Optimized 2 pix correlators (for jbig2 clustering)         *
@@ -224,10 +250,7 @@ l_uint32  *row1, *row2;
             for (y = lorow; y < hirow; y++, row1 += wpl1, row2 += wpl2) {
                 for (x = 0; x < rowwords1; x++) {
                     andw = row1[x] & row2[x];
-                    count += tab[andw & 0xff] +
-                        tab[(andw >> 8) & 0xff] +
-                        tab[(andw >> 16) & 0xff] +
-                        tab[andw >> 24];
+                    count += COUNT_ON_BITS(andw, tab);
                 }
             }
         } else if (idelx > 0) {
@@ -254,20 +277,14 @@ l_uint32  *row1, *row2;
                     word1 = row1[0];
                     word2 = row2[0] >> idelx;
                     andw = word1 & word2;
-                    count += tab[andw & 0xff] +
-                        tab[(andw >> 8) & 0xff] +
-                        tab[(andw >> 16) & 0xff] +
-                        tab[andw >> 24];
+                    count += COUNT_ON_BITS(andw, tab);
 
                     for (x = 1; x < rowwords2; x++) {
                         word1 = row1[x];
                         word2 = (row2[x] >> idelx) |
                             (row2[x - 1] << (32 - idelx));
                         andw = word1 & word2;
-                        count += tab[andw & 0xff] +
-                            tab[(andw >> 8) & 0xff] +
-                            tab[(andw >> 16) & 0xff] +
-                            tab[andw >> 24];
+                        count += COUNT_ON_BITS(andw, tab);
                     }
 
                         /* Now the last iteration - we know that this is safe
@@ -277,10 +294,7 @@ l_uint32  *row1, *row2;
                     word1 = row1[x];
                     word2 = row2[x - 1] << (32 - idelx);
                     andw = word1 & word2;
-                    count += tab[andw & 0xff] +
-                        tab[(andw >> 8) & 0xff] +
-                        tab[(andw >> 16) & 0xff] +
-                        tab[andw >> 24];
+                    count += COUNT_ON_BITS(andw, tab);
                 }
             } else {
                 for (y = lorow; y < hirow; y++, row1 += wpl1, row2 += wpl2) {
@@ -292,20 +306,14 @@ l_uint32  *row1, *row2;
                     word1 = row1[0];
                     word2 = row2[0] >> idelx;
                     andw = word1 & word2;
-                    count += tab[andw & 0xff] +
-                        tab[(andw >> 8) & 0xff] +
-                        tab[(andw >> 16) & 0xff] +
-                        tab[andw >> 24];
+                    count += COUNT_ON_BITS(andw, tab);
 
                     for (x = 1; x < rowwords1; x++) {
                         word1 = row1[x];
                         word2 = (row2[x] >> idelx) |
                             (row2[x - 1] << (32 - idelx));
                         andw = word1 & word2;
-                        count += tab[andw & 0xff] +
-                            tab[(andw >> 8) & 0xff] +
-                            tab[(andw >> 16) & 0xff] +
-                            tab[andw >> 24];
+                        count += COUNT_ON_BITS(andw, tab);
                     }
                 }
             }
@@ -324,10 +332,7 @@ l_uint32  *row1, *row2;
                         word2 = row2[x] << -idelx;
                         word2 |= row2[x + 1] >> (32 + idelx);
                         andw = word1 & word2;
-                        count += tab[andw & 0xff] +
-                            tab[(andw >> 8) & 0xff] +
-                            tab[(andw >> 16) & 0xff] +
-                            tab[andw >> 24];
+                        count += COUNT_ON_BITS(andw, tab);
                     }
                 }
             } else {
@@ -339,19 +344,13 @@ l_uint32  *row1, *row2;
                         word2 = row2[x] << -idelx;
                         word2 |= row2[x + 1] >> (32 + idelx);
                         andw = word1 & word2;
-                        count += tab[andw & 0xff] +
-                            tab[(andw >> 8) & 0xff] +
-                            tab[(andw >> 16) & 0xff] +
-                            tab[andw >> 24];
+                        count += COUNT_ON_BITS(andw, tab);
                     }
 
                     word1 = row1[x];
                     word2 = row2[x] << -idelx;
                     andw = word1 & word2;
-                    count += tab[andw & 0xff] +
-                        tab[(andw >> 8) & 0xff] +
-                        tab[(andw >> 16) & 0xff] +
-                        tab[andw >> 24];
+                    count += COUNT_ON_BITS(andw, tab);
                 }
             }
         }
@@ -530,10 +529,7 @@ l_int32    threshold;
             for (y = lorow; y < hirow; y++, row1 += wpl1, row2 += wpl2) {
                 for (x = 0; x < rowwords1; x++) {
                     andw = row1[x] & row2[x];
-                    count += tab[andw & 0xff] +
-                        tab[(andw >> 8) & 0xff] +
-                        tab[(andw >> 16) & 0xff] +
-                        tab[andw >> 24];
+                    count += COUNT_ON_BITS(andw, tab);
                 }
 
                     /* If the count is over the threshold, no need to
@@ -569,20 +565,14 @@ l_int32    threshold;
                     word1 = row1[0];
                     word2 = row2[0] >> idelx;
                     andw = word1 & word2;
-                    count += tab[andw & 0xff] +
-                        tab[(andw >> 8) & 0xff] +
-                        tab[(andw >> 16) & 0xff] +
-                        tab[andw >> 24];
+                    count += COUNT_ON_BITS(andw, tab);
 
                     for (x = 1; x < rowwords2; x++) {
                         word1 = row1[x];
                         word2 = (row2[x] >> idelx) |
                             (row2[x - 1] << (32 - idelx));
                         andw = word1 & word2;
-                        count += tab[andw & 0xff] +
-                            tab[(andw >> 8) & 0xff] +
-                            tab[(andw >> 16) & 0xff] +
-                            tab[andw >> 24];
+                        count += COUNT_ON_BITS(andw, tab);
                     }
 
                         /* Now the last iteration - we know that this is safe
@@ -592,10 +582,7 @@ l_int32    threshold;
                     word1 = row1[x];
                     word2 = row2[x - 1] << (32 - idelx);
                     andw = word1 & word2;
-                    count += tab[andw & 0xff] +
-                        tab[(andw >> 8) & 0xff] +
-                        tab[(andw >> 16) & 0xff] +
-                        tab[andw >> 24];
+                    count += COUNT_ON_BITS(andw, tab);
 
                     if (count >= threshold) return TRUE;
                     if (count + downcount[y] - untouchable < threshold) {
@@ -612,20 +599,14 @@ l_int32    threshold;
                     word1 = row1[0];
                     word2 = row2[0] >> idelx;
                     andw = word1 & word2;
-                    count += tab[andw & 0xff] +
-                        tab[(andw >> 8) & 0xff] +
-                        tab[(andw >> 16) & 0xff] +
-                        tab[andw >> 24];
+                    count += COUNT_ON_BITS(andw, tab);
 
                     for (x = 1; x < rowwords1; x++) {
                         word1 = row1[x];
                         word2 = (row2[x] >> idelx) |
                             (row2[x - 1] << (32 - idelx));
                         andw = word1 & word2;
-                        count += tab[andw & 0xff] +
-                            tab[(andw >> 8) & 0xff] +
-                            tab[(andw >> 16) & 0xff] +
-                            tab[andw >> 24];
+                        count += COUNT_ON_BITS(andw, tab);
                     }
 
                     if (count >= threshold) return TRUE;
@@ -649,10 +630,7 @@ l_int32    threshold;
                         word2 = row2[x] << -idelx;
                         word2 |= row2[x + 1] >> (32 + idelx);
                         andw = word1 & word2;
-                        count += tab[andw & 0xff] +
-                            tab[(andw >> 8) & 0xff] +
-                            tab[(andw >> 16) & 0xff] +
-                            tab[andw >> 24];
+                        count += COUNT_ON_BITS(andw, tab);
                     }
 
                     if (count >= threshold) return TRUE;
@@ -669,19 +647,13 @@ l_int32    threshold;
                         word2 = row2[x] << -idelx;
                         word2 |= row2[x + 1] >> (32 + idelx);
                         andw = word1 & word2;
-                        count += tab[andw & 0xff] +
-                            tab[(andw >> 8) & 0xff] +
-                            tab[(andw >> 16) & 0xff] +
-                            tab[andw >> 24];
+                        count += COUNT_ON_BITS(andw, tab);
                     }
 
                     word1 = row1[x];
                     word2 = row2[x] << -idelx;
                     andw = word1 & word2;
-                    count += tab[andw & 0xff] +
-                        tab[(andw >> 8) & 0xff] +
-                        tab[(andw >> 16) & 0xff] +
-                        tab[andw >> 24];
+                    count += COUNT_ON_BITS(andw, tab);
 
                     if (count >= threshold) return TRUE;
                     if (count + downcount[y] - untouchable < threshold) {
@@ -816,8 +788,10 @@ PIX     *pixt;
  *      (1) This finds the correlation between two 1 bpp images,
  *          when pix2 is shifted by (delx, dely) with respect
  *          to each other.
- *      (2) This is implemented by starting with a copy of pix1 and
- *          ANDing its pixels with those of a shifted pix2.
+ *      (2) This counts the ON pixels in the AND of pix1 with the
+ *          shifted pix2 in a single pass, without making a temporary
+ *          image.  It gives the same result as starting with a copy of
+ *          pix1 and ANDing its pixels with those of a shifted pix2.
  *      (3) Get the pixel counts for area1 and area2 using piCountPixels().
  *      (4) A good estimate for a shift that would maximize the correlation
  *          is to align the centroids (cx1, cy1; cx2, cy2), giving the
@@ -841,8 +815,7 @@ pixCorrelationScoreShifted(PIX        *pix1,
                            l_int32    *tab,
                            l_float32  *pscore)
 {
-l_int32  w1, h1, w2, h2, count;
-PIX     *pixt;
+l_int32  count;
 
     PROCNAME("pixCorrelationScoreShifted");
 
@@ -858,22 +831,228 @@ PIX     *pixt;
     if (!area1 || !area2)
         return ERROR_INT("areas must be > 0", procName, 1);
 
+    if (pixCorrelationCountShifts(pix1, pix2, delx, dely, 1, 1, 0, tab,
+                                  &count, NULL))
+        return ERROR_INT("count not made", procName, 1);
+
+    *pscore = (l_float32)count * (l_float32)count /
+               ((l_float32)area1 * (l_float32)area2);
+    return 0;
+}
+
+
+/* -------------------------------------------------------------------- *
+ *              Correlation counts over a window of shifts              *
+ * -------------------------------------------------------------------- */
+/*!
+ * \brief   pixCorrelationCountShifts()
+ *
+ * \param[in]    pix1        1 bpp
+ * \param[in]    pix2        1 bpp; typically the template
+ * \param[in]    delx        x translation of pix2 relative to pix1 for
+ *                           the first shift in the window
+ * \param[in]    dely        y translation of pix2 relative to pix1 for
+ *                           the first shift in the window
+ * \param[in]    nx          number of x shifts, starting at %delx
+ * \param[in]    ny          number of y shifts, starting at %dely
+ * \param[in]    mincount    abandon the computation when no shift can
+ *                           reach this count; use 0 to compute all counts
+ * \param[in]    tab8        [optional] sum tab for ON pixels in byte;
+ *                           can be NULL
+ * \param[in]    counts      caller-allocated array of size %nx * %ny
+ * \param[out]   pabandoned  [optional] 1 if abandoned early; 0 otherwise
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) On return, counts[j * nx + i] is the number of ON pixels in
+ *          the AND of pix1 with pix2 translated by (delx + i, dely + j).
+ *          This is the count used in the correlation score in
+ *          pixCorrelationScoreShifted().
+ *      (2) This makes a single pass over the rows of pix2.  Each row is
+ *          shifted once for each of the %nx x shifts, aligned to the
+ *          words of pix1, and then ANDed with the %ny rows of pix1
+ *          that it touches.  No temporary images are made.
+ *      (3) Pixels outside the overlap of pix1 and the translated pix2
+ *          are ignored, including any pad bits at the right side of
+ *          either image.
+ *      (4) If %mincount > 0, the computation stops as soon as the count
+ *          for every shift, plus the number of ON pixels in the rows
+ *          of pix2 yet to be visited, is less than %mincount.  The
+ *          returned counts are then partial, and are all less than
+ *          %mincount.  Use this in a search where only counts that
+ *          could beat a known score are of interest.
+ *      (5) %tab8 is only used where the popcount instruction is not
+ *          available; otherwise it is ignored and no table is made.
+ * </pre>
+ */
+l_ok
+pixCorrelationCountShifts(PIX      *pix1,
+                          PIX      *pix2,
+                          l_int32   delx,
+                          l_int32   dely,
+                          l_int32   nx,
+                          l_int32   ny,
+                          l_int32   mincount,
+                          l_int32  *tab8,
+                          l_int32  *counts,
+                          l_int32  *pabandoned)
+{
+l_int32    w1, h1, w2, h2, wpl1, wpl2, nwords2, i, j, k, y1, y2, bit;
+l_int32    dx, locol, hicol, maxcount, remaining, count;
+l_int32   *tab, *kstart, *kend, *rowcount;
+l_uint32   word, lmask, rmask;
+l_uint32  *data1, *data2, *line1, *line2, *sline, *shifted;
+
+    PROCNAME("pixCorrelationCountShifts");
+
+    if (pabandoned) *pabandoned = 0;
+    if (!pix1 || pixGetDepth(pix1) != 1)
+        return ERROR_INT("pix1 undefined or not 1 bpp", procName, 1);
+    if (!pix2 || pixGetDepth(pix2) != 1)
+        return ERROR_INT("pix2 undefined or not 1 bpp", procName, 1);
+    if (!counts)
+        return ERROR_INT("counts not defined", procName, 1);
+    if (nx < 1 || ny < 1)
+        return ERROR_INT("nx and ny must be > 0", procName, 1);
+
+    memset(counts, 0, nx * ny * sizeof(l_int32));
     pixGetDimensions(pix1, &w1, &h1, NULL);
     pixGetDimensions(pix2, &w2, &h2, NULL);
+    wpl1 = pixGetWpl(pix1);
+    wpl2 = pixGetWpl(pix2);
+    data1 = pixGetData(pix1);
+    data2 = pixGetData(pix2);
+    nwords2 = (w2 + 31) / 32;
+#if USE_PIXEL_SUM_TAB
+    tab = (tab8) ? tab8 : makePixelSumTab8();
+#else
+    tab = NULL;  /* not needed with popcount */
+#endif  /* USE_PIXEL_SUM_TAB */
 
-        /*  To insure that pixels are ON only within the
-         *  intersection of pix1 and the shifted pix2:
-         *  (1) Start with pixt cleared and equal in size to pix1.
-         *  (2) Blit the shifted pix2 onto pixt.  Then all ON pixels
-         *      are within the intersection of pix1 and the shifted pix2.
-         *  (3) AND pix1 with pixt. */
-    pixt = pixCreateTemplate(pix1);
-    pixRasterop(pixt, delx, dely, w2, h2, PIX_SRC, pix2, 0, 0);
-    pixRasterop(pixt, 0, 0, w1, h1, PIX_SRC & PIX_DST, pix1, 0, 0);
-    pixCountPixels(pixt, &count, tab);
-    pixDestroy(&pixt);
+        /* For each x shift, find the range of words of pix1 touched by
+         * the shifted pix2, and the masks on the end words.  Pixels
+         * are counted only in the overlap columns [locol, hicol). */
+    shifted = (l_uint32 *)LEPT_CALLOC(nx * wpl1, sizeof(l_uint32));
+    kstart = (l_int32 *)LEPT_CALLOC(nx, sizeof(l_int32));
+    kend = (l_int32 *)LEPT_CALLOC(nx, sizeof(l_int32));
+    for (i = 0; i < nx; i++) {
+        dx = delx + i;
+        locol = L_MAX(dx, 0);
+        hicol = L_MIN(w2 + dx, w1);
+        if (locol >= hicol) {  /* no overlap */
+            kstart[i] = 0;
+            kend[i] = -1;
+        } else {
+            kstart[i] = locol >> 5;
+            kend[i] = (hicol - 1) >> 5;
+        }
+    }
 
-    *pscore = (l_float32)count * (l_float32)count /
-               ((l_float32)area1 * (l_float32)area2);
+        /* Number of ON pixels in each row of pix2, for early termination */
+    rowcount = NULL;
+    remaining = 0;
+    if (mincount > 0) {
+        rowcount = (l_int32 *)LEPT_CALLOC(h2, sizeof(l_int32));
+        for (y2 = 0; y2 < h2; y2++) {
+            line2 = data2 + y2 * wpl2;
+            for (k = 0, count = 0; k < nwords2; k++) {
+                word = line2[k];
+                if (k == nwords2 - 1 && (w2 & 31))
+                    word &= ~(0xffffffff >> (w2 & 31));
+                count += COUNT_ON_BITS(word, tab);
+            }
+            rowcount[y2] = count;
+            remaining += count;
+        }
+    }
+
+        /* Visit each row of pix2 that touches pix1 for some y shift */
+    for (y2 = 0; y2 < h2; y2++) {
+        if (rowcount) remaining -= rowcount[y2];
+        if (y2 + dely >= h1) break;
+        if (y2 + dely + ny - 1 < 0) continue;
+        line2 = data2 + y2 * wpl2;
+
+            /* Make the shifted and masked row for each x shift */
+        for (i = 0; i < nx; i++) {
+            if (kstart[i] > kend[i]) continue;
+            dx = delx + i;
+            locol = L_MAX(dx, 0);
+            hicol = L_MIN(w2 + dx, w1);
+            lmask = 0xffffffff >> (locol & 31);
+            rmask = (hicol & 31) ? ~(0xffffffff >> (hicol & 31)) : 0xffffffff;
+            sline = shifted + i * wpl1;
+            for (k = kstart[i]; k <= kend[i]; k++) {
+                bit = 32 * k - dx;  /* pix2 pixel at start of word k */
+                sline[k] = getShiftedWord(line2, nwords2, bit);
+            }
+            sline[kstart[i]] &= lmask;
+            sline[kend[i]] &= rmask;
+        }
+
+            /* AND with each row of pix1 that it touches */
+        for (j = 0; j < ny; j++) {
+            y1 = y2 + dely + j;
+            if (y1 < 0 || y1 >= h1) continue;
+            line1 = data1 + y1 * wpl1;
+            for (i = 0; i < nx; i++) {
+                sline = shifted + i * wpl1;
+                for (k = kstart[i], count = 0; k <= kend[i]; k++) {
+                    word = line1[k] & sline[k];
+                    count += COUNT_ON_BITS(word, tab);
+                }
+                counts[j * nx + i] += count;
+            }
+        }
+
+            /* Stop if no shift can reach the requested count */
+        if (mincount > 0) {
+            for (k = 0, maxcount = 0; k < nx * ny; k++)
+                maxcount = L_MAX(maxcount, counts[k]);
+            if (maxcount + remaining < mincount) {
+                if (pabandoned) *pabandoned = 1;
+                break;
+            }
+        }
+    }
+
+    LEPT_FREE(shifted);
+    LEPT_FREE(kstart);
+    LEPT_FREE(kend);
+    LEPT_FREE(rowcount);
+    if (tab != tab8) LEPT_FREE(tab);
     return 0;
 }
+
+
+/*!
+ * \brief   getShiftedWord()
+ *
+ * \param[in]    line      row of 1 bpp data
+ * \param[in]    nwords    number of words in %line that hold pixels
+ * \param[in]    bit       pixel index of the MSB of the returned word;
+ *                         can be negative
+ * \return  32 pixels starting at %bit, with 0 for pixels outside the line
+ */
+static l_uint32
+getShiftedWord(l_uint32  *line,
+               l_int32    nwords,
+               l_int32    bit)
+{
+l_int32   index, shift;
+l_uint32  word;
+
+    if (bit <= -32 || bit >= 32 * nwords)
+        return 0;
+    if (bit < 0)
+        return line[0] >> (-bit);
+    index = bit >> 5;
+    shift = bit & 31;
+    if (shift == 0)
+        return line[index];
+    word = line[index] << shift;
+    if (index + 1 < nwords)
+        word |= line[index + 1] >> (32 - shift);
+    return word;
+}
@@ -205,7 +205,8 @@ pixFMorphopGen_2(PIX     *pixd,
                  l_int32  operation,
                  char    *selname)
 {
-l_int32    i, index, found, w, h, wpls, wpld, bordercolor, erodeop, borderop;
+l_int32    i, index, found, w, h, wpls, wpld, wplt, bordercolor, erodeop;
+l_int32    borderop;
 l_uint32  *datad, *datas, *datat;
 PIX       *pixt;
 
@@ -261,9 +262,10 @@ PIX       *pixt;
         if (pixd == pixs) {  /* in-place; generate a temp image */
             if ((pixt = pixCopy(NULL, pixs)) == NULL)
                 return (PIX *)ERROR_PTR("pixt not made", procName, pixd);
-            datat = pixGetData(pixt) + 32 * wpls + 1;
+            wplt = pixGetWpl(pixt);
+            datat = pixGetData(pixt) + 32 * wplt + 1;
             pixSetOrClearBorder(pixt, 32, 32, 32, 32, borderop);
-            fmorphopgen_low_2(datad, w, h, wpld, datat, wpls, index);
+            fmorphopgen_low_2(datad, w, h, wpld, datat, wplt, index);
             pixDestroy(&pixt);
         }
         else { /* not in-place */
@@ -274,18 +276,19 @@ PIX       *pixt;
     else {  /* opening or closing; generate a temp image */
         if ((pixt = pixCreateTemplate(pixs)) == NULL)
             return (PIX *)ERROR_PTR("pixt not made", procName, pixd);
-        datat = pixGetData(pixt) + 32 * wpls + 1;
+        wplt = pixGetWpl(pixt);
+        datat = pixGetData(pixt) + 32 * wplt + 1;
         if (operation == L_MORPH_OPEN) {
             pixSetOrClearBorder(pixs, 32, 32, 32, 32, erodeop);
-            fmorphopgen_low_2(datat, w, h, wpls, datas, wpls, index+1);
+            fmorphopgen_low_2(datat, w, h, wplt, datas, wpls, index+1);
             pixSetOrClearBorder(pixt, 32, 32, 32, 32, PIX_CLR);
-            fmorphopgen_low_2(datad, w, h, wpld, datat, wpls, index);
+            fmorphopgen_low_2(datad, w, h, wpld, datat, wplt, index);
         }
         else {  /* closing */
             pixSetOrClearBorder(pixs, 32, 32, 32, 32, PIX_CLR);
-            fmorphopgen_low_2(datat, w, h, wpls, datas, wpls, index);
+            fmorphopgen_low_2(datat, w, h, wplt, datas, wpls, index);
             pixSetOrClearBorder(pixt, 32, 32, 32, 32, erodeop);
-            fmorphopgen_low_2(datad, w, h, wpld, datat, wpls, index+1);
+            fmorphopgen_low_2(datad, w, h, wpld, datat, wplt, index+1);
         }
         pixDestroy(&pixt);
     }
@@ -0,0 +1,1152 @@
+/*====================================================================*
+ -  Copyright (C) 2001 Leptonica.  All rights reserved.
+ -
+ -  Redistribution and use in source and binary forms, with or without
+ -  modification, are permitted provided that the following conditions
+ -  are met:
+ -  1. Redistributions of source code must retain the above copyright
+ -     notice, this list of conditions and the following disclaimer.
+ -  2. Redistributions in binary form must reproduce the above
+ -     copyright notice, this list of conditions and the following
+ -     disclaimer in the documentation and/or other materials
+ -     provided with the distribution.
+ -
+ -  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ -  ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ -  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ -  A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL ANY
+ -  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ -  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ -  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ -  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ -  OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ -  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ -  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *====================================================================*/
+
+/*!
+ * \file fft.c
+ * <pre>
+ *
+ *      Convolution by FFT
+ *          FPIX         *fpixConvolveFFT()
+ *          PIX          *pixConvolveFFT()
+ *
+ *      Correlation by FFT
+ *          l_int32       pixCorrelationCountShiftsFFT()
+ *          l_int32       pixPhaseCorrelation()
+ *
+ *      Static helpers for 2D real transforms
+ *          static l_float64    *fftCorrelate2D()
+ *          static FFTCOMPLEX   *fftRealForward2D()
+ *          static void          fftRealInverse2D()
+ *          static void          fftColumns()
+ *
+ *      Static helpers for 1D complex transforms
+ *          static l_int32       fftGoodSize()
+ *          static FFTPLAN      *fftPlanCreate()
+ *          static void          fftPlanDestroy()
+ *          static void          fftTransform()
+ *          static void          fftInverse()
+ *          static void          fftWork()
+ *
+ *    These use a self-contained mixed-radix complex FFT, for sizes
+ *    whose only prime factors are 2, 3 and 5.  The input arrays are
+ *    zero-padded up to such a size.  The 2D real transform of a
+ *    w x h array is the (w/2 + 1) x h half of its spectrum; the other
+ *    half is given by hermitian symmetry.  It is computed by packing
+ *    pairs of rows into one complex row, followed by transforms on
+ *    the columns.
+ *
+ *    The cost of a convolution or correlation by FFT is O(N log N)
+ *    for N pixels, independent of the size of the kernel or the number
+ *    of shifts.  pixConvolve() and fpixConvolve() use it for large
+ *    kernels when enabled with l_setConvolveFFT(), and
+ *    pixBestCorrelation() uses it for large search windows.
+ * </pre>
+ */
+
+#include <string.h>
+#include <math.h>
+#include "allheaders.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif  /* M_PI */
+
+/*!
+ * \brief   The struct FFTComplex is a double precision complex number.
+ */
+struct FFTComplex
+{
+    l_float64    re;      /*!< real part */
+    l_float64    im;      /*!< imaginary part */
+};
+typedef struct FFTComplex    FFTCOMPLEX;
+
+/*!
+ * \brief   The struct FFTPlan holds the factorization and the twiddle
+ *  factors for a complex FFT of size n.
+ */
+struct FFTPlan
+{
+    l_int32      n;             /*!< size of the transform */
+    l_int32      factors[64];   /*!< pairs of (radix, remaining size) */
+    FFTCOMPLEX  *twiddles;      /*!< exp(-2 pi i k / n), for 0 <= k < n */
+};
+typedef struct FFTPlan    FFTPLAN;
+
+    /* Number of columns transformed together, for cache efficiency */
+static const l_int32  FFT_COLUMN_BLOCK = 8;
+
+    /* c = a * b, for complex a and b */
+#define  COMPLEX_MUL(c, a, b) \
+    { (c).re = (a).re * (b).re - (a).im * (b).im; \
+      (c).im = (a).re * (b).im + (a).im * (b).re; }
+
+static l_float64 *fftCorrelate2D(l_float64 *dataa, l_float64 *datab,
+                                 l_int32 pw, l_int32 ph, l_int32 phaseflag);
+static FFTCOMPLEX *fftRealForward2D(l_float64 *data, l_int32 pw, l_int32 ph);
+static void fftRealInverse2D(FFTCOMPLEX *spec, l_int32 pw, l_int32 ph,
+                             l_float64 *data);
+static void fftColumns(FFTPLAN *plan, FFTCOMPLEX *spec, l_int32 nh,
+                       l_int32 inverse);
+static l_int32 fftGoodSize(l_int32 n);
+static FFTPLAN *fftPlanCreate(l_int32 n);
+static void fftPlanDestroy(FFTPLAN **pplan);
+static void fftTransform(FFTPLAN *plan, FFTCOMPLEX *in, FFTCOMPLEX *out);
+static void fftInverse(FFTPLAN *plan, FFTCOMPLEX *in, FFTCOMPLEX *out);
+static void fftWork(FFTPLAN *plan, FFTCOMPLEX *out, FFTCOMPLEX *in,
+                    l_int32 fstride, l_int32 *factors);
+
+
+/*------------------------------------------------------------------------*
+ *                          Convolution by FFT                            *
+ *------------------------------------------------------------------------*/
+/*!
+ * \brief   fpixConvolveFFT()
+ *
+ * \param[in]    fpixs      32 bit float array
+ * \param[in]    kel        kernel
+ * \param[in]    normflag   1 to normalize kernel to unit sum; 0 otherwise
+ * \return  fpixd 32 bit float array
+ *
+ * <pre>
+ * Notes:
+ *      (1) This gives the same result as fpixConvolve(), up to rounding,
+ *          without subsampling.  It uses the same mirrored border.
+ *      (2) The image and kernel are zero-padded to a common size
+ *          and correlated with a 2D real FFT.  The time is independent
+ *          of the kernel size, so this is much faster than fpixConvolve()
+ *          for large kernels.  fpixConvolve() calls this function
+ *          for large kernels if enabled with l_setConvolveFFT().
+ *      (3) The arithmetic is in double precision.
+ * </pre>
+ */
+FPIX *
+fpixConvolveFFT(FPIX      *fpixs,
+                L_KERNEL  *kel,
+                l_int32    normflag)
+{
+l_int32     i, j, k, m, w, h, sx, sy, cx, cy, pw, ph, wplt, wpld;
+l_float32  *datat, *datad, *linet, *lined;
+l_float64  *dataa, *datab, *datac;
+L_KERNEL   *keli, *keln;
+FPIX       *fpixt, *fpixd;
+
+    PROCNAME("fpixConvolveFFT");
+
+    if (!fpixs)
+        return (FPIX *)ERROR_PTR("fpixs not defined", procName, NULL);
+    if (!kel)
+        return (FPIX *)ERROR_PTR("kel not defined", procName, NULL);
+
+    fpixd = NULL;
+    dataa = datab = datac = NULL;
+
+    keli = kernelInvert(kel);
+    kernelGetParameters(keli, &sy, &sx, &cy, &cx);
+    if (normflag)
+        keln = kernelNormalize(keli, 1.0);
+    else
+        keln = kernelCopy(keli);
+
+    fpixGetDimensions(fpixs, &w, &h);
+    fpixt = fpixAddMirroredBorder(fpixs, cx, sx - cx, cy, sy - cy);
+    if (!fpixt) {
+        L_ERROR("fpixt not made\n", procName);
+        goto cleanup;
+    }
+
+        /* Only the first (w + sx - 1) columns and (h + sy - 1) rows
+         * of fpixt are used by the output pixels */
+    pw = fftGoodSize(w + sx - 1);
+    ph = fftGoodSize(h + sy - 1);
+    dataa = (l_float64 *)LEPT_CALLOC(pw * ph, sizeof(l_float64));
+    datab = (l_float64 *)LEPT_CALLOC(pw * ph, sizeof(l_float64));
+    datat = fpixGetData(fpixt);
+    wplt = fpixGetWpl(fpixt);
+    for (i = 0; i < h + sy - 1; i++) {
+        linet = datat + i * wplt;
+        for (j = 0; j < w + sx - 1; j++)
+            dataa[i * pw + j] = linet[j];
+    }
+    for (k = 0; k < sy; k++) {
+        for (m = 0; m < sx; m++)
+            datab[k * pw + m] = keln->data[k][m];
+    }
+    if ((datac = fftCorrelate2D(dataa, datab, pw, ph, 0)) == NULL) {
+        L_ERROR("correlation failed\n", procName);
+        goto cleanup;
+    }
+
+    fpixd = fpixCreate(w, h);
+    datad = fpixGetData(fpixd);
+    wpld = fpixGetWpl(fpixd);
+    for (i = 0; i < h; i++) {
+        lined = datad + i * wpld;
+        for (j = 0; j < w; j++)
+            lined[j] = (l_float32)datac[i * pw + j];
+    }
+
+cleanup:
+    kernelDestroy(&keli);
+    kernelDestroy(&keln);
+    fpixDestroy(&fpixt);
+    LEPT_FREE(dataa);
+    LEPT_FREE(datab);
+    LEPT_FREE(datac);
+    return fpixd;
+}
+
+
+/*!
+ * \brief   pixConvolveFFT()
+ *
+ * \param[in]    pixs       8, 16, 32 bpp; no colormap
+ * \param[in]    kel        kernel
+ * \param[in]    outdepth   of pixd: 8, 16 or 32
+ * \param[in]    normflag   1 to normalize kernel to unit sum; 0 otherwise
+ * \return  pixd 8, 16 or 32 bpp
+ *
+ * <pre>
+ * Notes:
+ *      (1) This gives the same result as pixConvolve(), up to rounding,
+ *          without subsampling.  As with pixConvolve(), the absolute
+ *          value of the convolution is stored in pixd.
+ *      (2) The time is independent of the kernel size.  pixConvolve()
+ *          calls this function for large kernels if enabled with
+ *          l_setConvolveFFT().
+ * </pre>
+ */
+PIX *
+pixConvolveFFT(PIX       *pixs,
+               L_KERNEL  *kel,
+               l_int32    outdepth,
+               l_int32    normflag)
+{
+l_int32     i, j, k, m, w, h, d, sx, sy, cx, cy, pw, ph, wplt, wpld;
+l_uint32   *datat, *datad, *linet, *lined;
+l_float64   sum;
+l_float64  *dataa, *datab, *datac, *linea;
+L_KERNEL   *keli, *keln;
+PIX        *pixt, *pixd;
+
+    PROCNAME("pixConvolveFFT");
+
+    if (!pixs)
+        return (PIX *)ERROR_PTR("pixs not defined", procName, NULL);
+    if (pixGetColormap(pixs))
+        return (PIX *)ERROR_PTR("pixs has colormap", procName, NULL);
+    pixGetDimensions(pixs, &w, &h, &d);
+    if (d != 8 && d != 16 && d != 32)
+        return (PIX *)ERROR_PTR("pixs not 8, 16, or 32 bpp", procName, NULL);
+    if (!kel)
+        return (PIX *)ERROR_PTR("kel not defined", procName, NULL);
+
+    pixd = NULL;
+    dataa = datab = datac = NULL;
+
+    keli = kernelInvert(kel);
+    kernelGetParameters(keli, &sy, &sx, &cy, &cx);
+    if (normflag)
+        keln = kernelNormalize(keli, 1.0);
+    else
+        keln = kernelCopy(keli);
+
+    if ((pixt = pixAddMirroredBorder(pixs, cx, sx - cx, cy, sy - cy)) == NULL) {
+        L_ERROR("pixt not made\n", procName);
+        goto cleanup;
+    }
+
+    pw = fftGoodSize(w + sx - 1);
+    ph = fftGoodSize(h + sy - 1);
+    dataa = (l_float64 *)LEPT_CALLOC(pw * ph, sizeof(l_float64));
+    datab = (l_float64 *)LEPT_CALLOC(pw * ph, sizeof(l_float64));
+    datat = pixGetData(pixt);
+    wplt = pixGetWpl(pixt);
+    for (i = 0; i < h + sy - 1; i++) {
+        linet = datat + i * wplt;
+        linea = dataa + i * pw;
+        if (d == 8) {
+            for (j = 0; j < w + sx - 1; j++)
+                linea[j] = GET_DATA_BYTE(linet, j);
+        } else if (d == 16) {
+            for (j = 0; j < w + sx - 1; j++)
+                linea[j] = GET_DATA_TWO_BYTES(linet, j);
+        } else {  /* d == 32 */
+            for (j = 0; j < w + sx - 1; j++)
+                linea[j] = linet[j];
+        }
+    }
+    for (k = 0; k < sy; k++) {
+        for (m = 0; m < sx; m++)
+            datab[k * pw + m] = keln->data[k][m];
+    }
+    if ((datac = fftCorrelate2D(dataa, datab, pw, ph, 0)) == NULL) {
+        L_ERROR("correlation failed\n", procName);
+        goto cleanup;
+    }
+
+    pixd = pixCreate(w, h, outdepth);
+    datad = pixGetData(pixd);
+    wpld = pixGetWpl(pixd);
+    for (i = 0; i < h; i++) {
+        lined = datad + i * wpld;
+        for (j = 0; j < w; j++) {
+            sum = datac[i * pw + j];
+            if (sum < 0.0) sum = -sum;  /* make it non-negative */
+            if (outdepth == 8)
+                SET_DATA_BYTE(lined, j, (l_int32)(sum + 0.5));
+            else if (outdepth == 16)
+                SET_DATA_TWO_BYTES(lined, j, (l_int32)(sum + 0.5));
+            else  /* outdepth == 32 */
+                *(lined + j) = (l_uint32)(sum + 0.5);
+        }
+    }
+
+cleanup:
+    kernelDestroy(&keli);
+    kernelDestroy(&keln);
+    pixDestroy(&pixt);
+    LEPT_FREE(dataa);
+    LEPT_FREE(datab);
+    LEPT_FREE(datac);
+    return pixd;
+}
+
+
+/*------------------------------------------------------------------------*
+ *                          Correlation by FFT                            *
+ *------------------------------------------------------------------------*/
+/*!
+ * \brief   pixCorrelationCountShiftsFFT()
+ *
+ * \param[in]    pix1        1 bpp
+ * \param[in]    pix2        1 bpp; typically the template
+ * \param[in]    delx        x translation of pix2 relative to pix1 for
+ *                           the first shift in the window
+ * \param[in]    dely        y translation of pix2 relative to pix1 for
+ *                           the first shift in the window
+ * \param[in]    nx          number of x shifts, starting at %delx
+ * \param[in]    ny          number of y shifts, starting at %dely
+ * \param[in]    counts      caller-allocated array of size %nx * %ny
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This returns the same counts as pixCorrelationCountShifts():
+ *          counts[j * nx + i] is the number of ON pixels in the AND of
+ *          pix1 with pix2 translated by (delx + i, dely + j).
+ *      (2) The counts for all shifts where the images overlap are
+ *          found with a single correlation by FFT, so the time depends
+ *          only on the image sizes, and not on the number of shifts.
+ *          Use this for large windows of shifts.  The values are exact
+ *          after rounding, because the arithmetic is in double precision.
+ *      (3) The images are zero-padded only as much as is needed to
+ *          prevent the cyclic correlation from aliasing the shifts in
+ *          the window.  For a window of small shifts, this is little
+ *          more than the size of the larger image.
+ * </pre>
+ */
+l_ok
+pixCorrelationCountShiftsFFT(PIX      *pix1,
+                             PIX      *pix2,
+                             l_int32   delx,
+                             l_int32   dely,
+                             l_int32   nx,
+                             l_int32   ny,
+                             l_int32  *counts)
+{
+l_int32     i, j, w1, h1, w2, h2, wpl1, wpl2, pw, ph, dx, dy;
+l_int32     x0, x1, y0, y1;
+l_uint32   *data1, *data2, *line1, *line2;
+l_float64   val;
+l_float64  *dataa, *datab, *datac;
+
+    PROCNAME("pixCorrelationCountShiftsFFT");
+
+    if (!pix1 || pixGetDepth(pix1) != 1)
+        return ERROR_INT("pix1 undefined or not 1 bpp", procName, 1);
+    if (!pix2 || pixGetDepth(pix2) != 1)
+        return ERROR_INT("pix2 undefined or not 1 bpp", procName, 1);
+    if (!counts)
+        return ERROR_INT("counts not defined", procName, 1);
+    if (nx < 1 || ny < 1)
+        return ERROR_INT("nx and ny must be > 0", procName, 1);
+
+    memset(counts, 0, nx * ny * sizeof(l_int32));
+    pixGetDimensions(pix1, &w1, &h1, NULL);
+    pixGetDimensions(pix2, &w2, &h2, NULL);
+
+        /* Restrict the window to shifts where the images overlap */
+    x0 = L_MAX(delx, 1 - w2);
+    x1 = L_MIN(delx + nx - 1, w1 - 1);
+    y0 = L_MAX(dely, 1 - h2);
+    y1 = L_MIN(dely + ny - 1, h1 - 1);
+    if (x0 > x1 || y0 > y1)
+        return 0;
+
+        /* With this padding, the cyclic correlation has no aliasing
+         * for the shifts in [x0, x1] x [y0, y1]: every other shift that
+         * is congruent to one of these has no overlap. */
+    pw = fftGoodSize(L_MAX(w1 - L_MIN(x0, 0), w2 + L_MAX(x1, 0)));
+    ph = fftGoodSize(L_MAX(h1 - L_MIN(y0, 0), h2 + L_MAX(y1, 0)));
+    dataa = (l_float64 *)LEPT_CALLOC(pw * ph, sizeof(l_float64));
+    datab = (l_float64 *)LEPT_CALLOC(pw * ph, sizeof(l_float64));
+    data1 = pixGetData(pix1);
+    data2 = pixGetData(pix2);
+    wpl1 = pixGetWpl(pix1);
+    wpl2 = pixGetWpl(pix2);
+    for (i = 0; i < h1; i++) {
+        line1 = data1 + i * wpl1;
+        for (j = 0; j < w1; j++)
+            dataa[i * pw + j] = GET_DATA_BIT(line1, j);
+    }
+    for (i = 0; i < h2; i++) {
+        line2 = data2 + i * wpl2;
+        for (j = 0; j < w2; j++)
+            datab[i * pw + j] = GET_DATA_BIT(line2, j);
+    }
+    datac = fftCorrelate2D(dataa, datab, pw, ph, 0);
+    LEPT_FREE(dataa);
+    LEPT_FREE(datab);
+    if (!datac)
+        return ERROR_INT("correlation failed", procName, 1);
+
+    for (j = 0; j < ny; j++) {
+        dy = dely + j;
+        if (dy < y0 || dy > y1) continue;
+        if (dy < 0) dy += ph;
+        for (i = 0; i < nx; i++) {
+            dx = delx + i;
+            if (dx < x0 || dx > x1) continue;
+            if (dx < 0) dx += pw;
+            val = datac[dy * pw + dx];
+            counts[j * nx + i] = (val > 0.0) ? (l_int32)(val + 0.5) : 0;
+        }
+    }
+
+    LEPT_FREE(datac);
+    return 0;
+}
+
+
+/*!
+ * \brief   pixPhaseCorrelation()
+ *
+ * \param[in]    pix1      any depth; colormap OK
+ * \param[in]    pix2      any depth; colormap OK
+ * \param[out]   pdelx     [optional] x shift of pix2 relative to pix1
+ * \param[out]   pdely     [optional] y shift of pix2 relative to pix1
+ * \param[out]   ppeak     [optional] height of the correlation peak
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This finds the translation (%delx, %dely) that best aligns
+ *          pix2 with pix1: pix2 translated by that amount matches pix1.
+ *          This is the same convention as pixBestCorrelation().
+ *      (2) The images are converted to 8 bpp gray and the mean is
+ *          subtracted from each.  The cross-power spectrum of the two
+ *          is normalized to unit magnitude, and its inverse transform
+ *          is searched for the maximum.  Because only the phase is
+ *          used, the peak is sharp, and the result is insensitive to
+ *          differences in contrast and to slowly varying illumination.
+ *      (3) The correlation is cyclic, on arrays large enough to hold
+ *          the larger of the two images.  Shifts are found in the range
+ *          [-pw/2, pw/2) in x, and likewise in y, where pw is slightly
+ *          larger than the width.  For a good result, the shift should
+ *          be small compared to the image size.
+ *      (4) The peak height is 1.0 for identical images that differ only
+ *          by a cyclic translation, and is near 0.0 for unrelated images.
+ *          It can be used to judge the quality of the registration.
+ *      (5) For registering a scanned page with its template, it is
+ *          usually sufficient to use images reduced by 2x or 4x, and
+ *          then refine with pixBestCorrelation() at full resolution.
+ * </pre>
+ */
+l_ok
+pixPhaseCorrelation(PIX        *pix1,
+                    PIX        *pix2,
+                    l_int32    *pdelx,
+                    l_int32    *pdely,
+                    l_float32  *ppeak)
+{
+l_int32     i, j, w1, h1, w2, h2, wpl1, wpl2, pw, ph, imax, jmax;
+l_uint32   *data1, *data2, *line1, *line2;
+l_float32   mean1, mean2;
+l_float64   maxval;
+l_float64  *dataa, *datab, *datac;
+PIX        *pix3, *pix4;
+
+    PROCNAME("pixPhaseCorrelation");
+
+    if (pdelx) *pdelx = 0;
+    if (pdely) *pdely = 0;
+    if (ppeak) *ppeak = 0.0;
+    if (!pix1 || !pix2)
+        return ERROR_INT("pix1 and pix2 not both defined", procName, 1);
+
+    pix3 = pixConvertTo8(pix1, FALSE);
+    pix4 = pixConvertTo8(pix2, FALSE);
+    if (!pix3 || !pix4) {
+        pixDestroy(&pix3);
+        pixDestroy(&pix4);
+        return ERROR_INT("8 bpp pix not made", procName, 1);
+    }
+    pixGetDimensions(pix3, &w1, &h1, NULL);
+    pixGetDimensions(pix4, &w2, &h2, NULL);
+    pixGetAverageMasked(pix3, NULL, 0, 0, 1, L_MEAN_ABSVAL, &mean1);
+    pixGetAverageMasked(pix4, NULL, 0, 0, 1, L_MEAN_ABSVAL, &mean2);
+
+    pw = fftGoodSize(L_MAX(w1, w2));
+    ph = fftGoodSize(L_MAX(h1, h2));
+    dataa = (l_float64 *)LEPT_CALLOC(pw * ph, sizeof(l_float64));
+    datab = (l_float64 *)LEPT_CALLOC(pw * ph, sizeof(l_float64));
+    data1 = pixGetData(pix3);
+    data2 = pixGetData(pix4);
+    wpl1 = pixGetWpl(pix3);
+    wpl2 = pixGetWpl(pix4);
+    for (i = 0; i < h1; i++) {
+        line1 = data1 + i * wpl1;
+        for (j = 0; j < w1; j++)
+            dataa[i * pw + j] = GET_DATA_BYTE(line1, j) - mean1;
+    }
+    for (i = 0; i < h2; i++) {
+        line2 = data2 + i * wpl2;
+        for (j = 0; j < w2; j++)
+            datab[i * pw + j] = GET_DATA_BYTE(line2, j) - mean2;
+    }
+    pixDestroy(&pix3);
+    pixDestroy(&pix4);
+    datac = fftCorrelate2D(dataa, datab, pw, ph, 1);
+    LEPT_FREE(dataa);
+    LEPT_FREE(datab);
+    if (!datac)
+        return ERROR_INT("correlation failed", procName, 1);
+
+    imax = jmax = 0;
+    maxval = datac[0];
+    for (i = 0; i < ph; i++) {
+        for (j = 0; j < pw; j++) {
+            if (datac[i * pw + j] > maxval) {
+                maxval = datac[i * pw + j];
+                imax = i;
+                jmax = j;
+            }
+        }
+    }
+    LEPT_FREE(datac);
+
+        /* Convert the cyclic location of the peak to a signed shift */
+    if (jmax >= (pw + 1) / 2) jmax -= pw;
+    if (imax >= (ph + 1) / 2) imax -= ph;
+    if (pdelx) *pdelx = jmax;
+    if (pdely) *pdely = imax;
+    if (ppeak) *ppeak = (l_float32)maxval;
+    return 0;
+}
+
+
+/*------------------------------------------------------------------------*
+ *                 Static helpers for 2D real transforms                  *
+ *------------------------------------------------------------------------*/
+/*!
+ * \brief   fftCorrelate2D()
+ *
+ * \param[in]    dataa, datab   real arrays of size pw * ph
+ * \param[in]    pw, ph         dimensions; only factors of 2, 3 and 5
+ * \param[in]    phaseflag      1 to normalize the cross-power spectrum
+ *                              to unit magnitude; 0 otherwise
+ * \return  datac, array of size pw * ph, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This computes the cyclic correlation
+ *              c(y, x) = Sum[a(y + v, x + u) * b(v, u)]
+ *          over all (v, u), with the indices taken modulo (ph, pw).
+ *          It is the inverse transform of A * conj(B).
+ * </pre>
+ */
+static l_float64 *
+fftCorrelate2D(l_float64  *dataa,
+               l_float64  *datab,
+               l_int32     pw,
+               l_int32     ph,
+               l_int32     phaseflag)
+{
+l_int32      i, n;
+l_float64    re, im, mag;
+l_float64   *datac;
+FFTCOMPLEX  *speca, *specb;
+
+    PROCNAME("fftCorrelate2D");
+
+    speca = fftRealForward2D(dataa, pw, ph);
+    specb = fftRealForward2D(datab, pw, ph);
+    if (!speca || !specb) {
+        LEPT_FREE(speca);
+        LEPT_FREE(specb);
+        return (l_float64 *)ERROR_PTR("spectra not made", procName, NULL);
+    }
+
+    n = (pw / 2 + 1) * ph;
+    for (i = 0; i < n; i++) {
+        re = speca[i].re * specb[i].re + speca[i].im * specb[i].im;
+        im = speca[i].im * specb[i].re - speca[i].re * specb[i].im;
+        if (phaseflag) {
+            mag = sqrt(re * re + im * im);
+            if (mag > 1.0e-10) {
+                re /= mag;
+                im /= mag;
+            } else {
+                re = im = 0.0;
+            }
+        }
+        speca[i].re = re;
+        speca[i].im = im;
+    }
+    LEPT_FREE(specb);
+
+    datac = (l_float64 *)LEPT_CALLOC(pw * ph, sizeof(l_float64));
+    fftRealInverse2D(speca, pw, ph, datac);
+    LEPT_FREE(speca);
+    return datac;
+}
+
+
+/*!
+ * \brief   fftRealForward2D()
+ *
+ * \param[in]    data     real array of size pw * ph
+ * \param[in]    pw, ph   dimensions; only factors of 2, 3 and 5
+ * \return  spec, half spectrum of size (pw / 2 + 1) * ph, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) Two real rows a and b are transformed together as the
+ *          complex row z = a + ib.  With Z the transform of z, and
+ *          k' = (pw - k) mod pw, the transforms of a and b are
+ *              A(k) = (Z(k) + conj(Z(k'))) / 2
+ *              B(k) = (Z(k) - conj(Z(k'))) / 2i
+ *      (2) The columns of the half spectrum are then transformed.
+ * </pre>
+ */
+static FFTCOMPLEX *
+fftRealForward2D(l_float64  *data,
+                 l_int32     pw,
+                 l_int32     ph)
+{
+l_int32      i, j, k, kc, nh;
+l_float64   *linea, *lineb;
+FFTCOMPLEX   z, zc;
+FFTCOMPLEX  *spec, *bufin, *bufout;
+FFTPLAN     *rowplan, *colplan;
+
+    PROCNAME("fftRealForward2D");
+
+    nh = pw / 2 + 1;
+    rowplan = fftPlanCreate(pw);
+    colplan = fftPlanCreate(ph);
+    spec = (FFTCOMPLEX *)LEPT_CALLOC(nh * ph, sizeof(FFTCOMPLEX));
+    bufin = (FFTCOMPLEX *)LEPT_CALLOC(L_MAX(pw, ph), sizeof(FFTCOMPLEX));
+    bufout = (FFTCOMPLEX *)LEPT_CALLOC(L_MAX(pw, ph), sizeof(FFTCOMPLEX));
+    if (!rowplan || !colplan || !spec || !bufin || !bufout) {
+        fftPlanDestroy(&rowplan);
+        fftPlanDestroy(&colplan);
+        LEPT_FREE(spec);
+        LEPT_FREE(bufin);
+        LEPT_FREE(bufout);
+        return (FFTCOMPLEX *)ERROR_PTR("memory not made", procName, NULL);
+    }
+
+        /* Rows, two at a time */
+    for (i = 0; i < ph; i += 2) {
+        linea = data + i * pw;
+        lineb = (i + 1 < ph) ? linea + pw : NULL;
+        for (j = 0; j < pw; j++) {
+            bufin[j].re = linea[j];
+            bufin[j].im = (lineb) ? lineb[j] : 0.0;
+        }
+        fftTransform(rowplan, bufin, bufout);
+        for (k = 0; k < nh; k++) {
+            kc = (k == 0) ? 0 : pw - k;
+            z = bufout[k];
+            zc = bufout[kc];
+            spec[i * nh + k].re = 0.5 * (z.re + zc.re);
+            spec[i * nh + k].im = 0.5 * (z.im - zc.im);
+            if (lineb) {
+                spec[(i + 1) * nh + k].re = 0.5 * (z.im + zc.im);
+                spec[(i + 1) * nh + k].im = 0.5 * (zc.re - z.re);
+            }
+        }
+    }
+
+        /* Columns */
+    fftColumns(colplan, spec, nh, 0);
+
+    fftPlanDestroy(&rowplan);
+    fftPlanDestroy(&colplan);
+    LEPT_FREE(bufin);
+    LEPT_FREE(bufout);
+    return spec;
+}
+
+
+/*!
+ * \brief   fftRealInverse2D()
+ *
+ * \param[in]    spec     half spectrum of size (pw / 2 + 1) * ph;
+ *                        overwritten
+ * \param[in]    pw, ph   dimensions; only factors of 2, 3 and 5
+ * \param[in]    data     real array of size pw * ph, for the result
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) This is the inverse of fftRealForward2D(), including the
+ *          1 / (pw * ph) normalization.  The spectrum must be hermitian,
+ *          as it is for the transform of any real array, or the product
+ *          of two such transforms.
+ *      (2) After the inverse transforms on the columns, each row of the
+ *          half spectrum is extended to full width by hermitian
+ *          symmetry, and two rows are inverted together.
+ * </pre>
+ */
+static void
+fftRealInverse2D(FFTCOMPLEX  *spec,
+                 l_int32      pw,
+                 l_int32      ph,
+                 l_float64   *data)
+{
+l_int32      i, j, k, nh;
+l_float64    scale;
+l_float64   *linea, *lineb;
+FFTCOMPLEX   a, b;
+FFTCOMPLEX  *speca, *specb, *bufin, *bufout;
+FFTPLAN     *rowplan, *colplan;
+
+    PROCNAME("fftRealInverse2D");
+
+    nh = pw / 2 + 1;
+    rowplan = fftPlanCreate(pw);
+    colplan = fftPlanCreate(ph);
+    bufin = (FFTCOMPLEX *)LEPT_CALLOC(L_MAX(pw, ph), sizeof(FFTCOMPLEX));
+    bufout = (FFTCOMPLEX *)LEPT_CALLOC(L_MAX(pw, ph), sizeof(FFTCOMPLEX));
+    if (!rowplan || !colplan || !bufin || !bufout) {
+        L_ERROR("memory not made\n", procName);
+        goto cleanup;
+    }
+
+        /* Columns */
+    fftColumns(colplan, spec, nh, 1);
+
+        /* Rows, two at a time */
+    scale = 1.0 / ((l_float64)pw * (l_float64)ph);
+    b.re = b.im = 0.0;
+    for (i = 0; i < ph; i += 2) {
+        speca = spec + i * nh;
+        specb = (i + 1 < ph) ? speca + nh : NULL;
+        for (k = 0; k < pw; k++) {
+            if (k < nh) {
+                a = speca[k];
+                if (specb) b = specb[k];
+            } else {
+                a.re = speca[pw - k].re;
+                a.im = -speca[pw - k].im;
+                if (specb) {
+                    b.re = specb[pw - k].re;
+                    b.im = -specb[pw - k].im;
+                }
+            }
+            bufin[k].re = a.re - b.im;
+            bufin[k].im = a.im + b.re;
+        }
+        fftInverse(rowplan, bufin, bufout);
+        linea = data + i * pw;
+        lineb = (specb) ? linea + pw : NULL;
+        for (j = 0; j < pw; j++) {
+            linea[j] = scale * bufout[j].re;
+            if (lineb) lineb[j] = scale * bufout[j].im;
+        }
+    }
+
+cleanup:
+    fftPlanDestroy(&rowplan);
+    fftPlanDestroy(&colplan);
+    LEPT_FREE(bufin);
+    LEPT_FREE(bufout);
+    return;
+}
+
+
+/*!
+ * \brief   fftColumns()
+ *
+ * \param[in]    plan      for transforms of size ph
+ * \param[in]    spec      array of size nh * ph; transformed in place
+ * \param[in]    nh        number of columns
+ * \param[in]    inverse   1 for inverse transforms; 0 for forward
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) This transforms each column of %spec.  A block of adjacent
+ *          columns is copied out together, so that each cache line
+ *          of %spec is read and written only once per block.
+ * </pre>
+ */
+static void
+fftColumns(FFTPLAN     *plan,
+           FFTCOMPLEX  *spec,
+           l_int32      nh,
+           l_int32      inverse)
+{
+l_int32      i, k, b, nb, ph;
+FFTCOMPLEX  *line, *bufcol, *bufout;
+
+    ph = plan->n;
+    bufcol = (FFTCOMPLEX *)LEPT_CALLOC(FFT_COLUMN_BLOCK * ph,
+                                       sizeof(FFTCOMPLEX));
+    bufout = (FFTCOMPLEX *)LEPT_CALLOC(ph, sizeof(FFTCOMPLEX));
+    for (k = 0; k < nh; k += FFT_COLUMN_BLOCK) {
+        nb = L_MIN(FFT_COLUMN_BLOCK, nh - k);
+        for (i = 0; i < ph; i++) {
+            line = spec + i * nh + k;
+            for (b = 0; b < nb; b++)
+                bufcol[b * ph + i] = line[b];
+        }
+        for (b = 0; b < nb; b++) {
+            if (inverse)
+                fftInverse(plan, bufcol + b * ph, bufout);
+            else
+                fftTransform(plan, bufcol + b * ph, bufout);
+            memcpy(bufcol + b * ph, bufout, ph * sizeof(FFTCOMPLEX));
+        }
+        for (i = 0; i < ph; i++) {
+            line = spec + i * nh + k;
+            for (b = 0; b < nb; b++)
+                line[b] = bufcol[b * ph + i];
+        }
+    }
+    LEPT_FREE(bufcol);
+    LEPT_FREE(bufout);
+}
+
+
+/*------------------------------------------------------------------------*
+ *                 Static helpers for 1D complex transforms               *
+ *------------------------------------------------------------------------*/
+/*!
+ * \brief   fftGoodSize()
+ *
+ * \param[in]    n     minimum size
+ * \return  smallest integer >= n of the form 2^a * 3^b * 5^c
+ */
+static l_int32
+fftGoodSize(l_int32  n)
+{
+l_int32  m;
+
+    if (n <= 1) return 1;
+    while (1) {
+        m = n;
+        while (m % 2 == 0) m /= 2;
+        while (m % 3 == 0) m /= 3;
+        while (m % 5 == 0) m /= 5;
+        if (m == 1) return n;
+        n++;
+    }
+}
+
+
+/*!
+ * \brief   fftPlanCreate()
+ *
+ * \param[in]    n     size of the transform; only factors of 2, 3 and 5
+ * \return  plan, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) The size is factored into radices 4, 2, 3 and 5, in that
+ *          order.  Each factor is stored with the size of the
+ *          sub-transforms that remain after it.
+ * </pre>
+ */
+static FFTPLAN *
+fftPlanCreate(l_int32  n)
+{
+l_int32     i, p, m, nf;
+l_float64   angle;
+FFTPLAN    *plan;
+
+    PROCNAME("fftPlanCreate");
+
+    if (n < 1)
+        return (FFTPLAN *)ERROR_PTR("n < 1", procName, NULL);
+
+    plan = (FFTPLAN *)LEPT_CALLOC(1, sizeof(FFTPLAN));
+    plan->n = n;
+    plan->twiddles = (FFTCOMPLEX *)LEPT_CALLOC(n, sizeof(FFTCOMPLEX));
+    for (i = 0; i < n; i++) {
+        angle = -2.0 * M_PI * (l_float64)i / (l_float64)n;
+        plan->twiddles[i].re = cos(angle);
+        plan->twiddles[i].im = sin(angle);
+    }
+
+    m = n;
+    nf = 0;
+    do {
+        if (m % 4 == 0)
+            p = 4;
+        else if (m % 2 == 0)
+            p = 2;
+        else if (m % 3 == 0)
+            p = 3;
+        else if (m % 5 == 0)
+            p = 5;
+        else  /* m == 1, or not a good size */
+            p = m;
+        if (p > 5 || 2 * nf + 1 >= 64) {
+            fftPlanDestroy(&plan);
+            return (FFTPLAN *)ERROR_PTR("invalid size", procName, NULL);
+        }
+        m /= p;
+        plan->factors[2 * nf] = p;
+        plan->factors[2 * nf + 1] = m;
+        nf++;
+    } while (m > 1);
+
+    return plan;
+}
+
+
+/*!
+ * \brief   fftPlanDestroy()
+ *
+ * \param[in,out]   pplan    will be set to null before returning
+ * \return  void
+ */
+static void
+fftPlanDestroy(FFTPLAN  **pplan)
+{
+FFTPLAN  *plan;
+
+    if (!pplan || (plan = *pplan) == NULL)
+        return;
+    LEPT_FREE(plan->twiddles);
+    LEPT_FREE(plan);
+    *pplan = NULL;
+}
+
+
+/*!
+ * \brief   fftTransform()
+ *
+ * \param[in]    plan
+ * \param[in]    in      input array of size plan->n
+ * \param[in]    out     output array of size plan->n; not the same as %in
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) This is the forward transform
+ *              out(k) = Sum[in(j) * exp(-2 pi i j k / n)]
+ *          with no normalization.
+ * </pre>
+ */
+static void
+fftTransform(FFTPLAN     *plan,
+             FFTCOMPLEX  *in,
+             FFTCOMPLEX  *out)
+{
+    fftWork(plan, out, in, 1, plan->factors);
+}
+
+
+/*!
+ * \brief   fftInverse()
+ *
+ * \param[in]    plan
+ * \param[in]    in      input array of size plan->n; overwritten
+ * \param[in]    out     output array of size plan->n; not the same as %in
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) This is the inverse transform, with no normalization,
+ *          computed as conj(F(conj(in))).
+ * </pre>
+ */
+static void
+fftInverse(FFTPLAN     *plan,
+           FFTCOMPLEX  *in,
+           FFTCOMPLEX  *out)
+{
+l_int32  i;
+
+    for (i = 0; i < plan->n; i++)
+        in[i].im = -in[i].im;
+    fftWork(plan, out, in, 1, plan->factors);
+    for (i = 0; i < plan->n; i++)
+        out[i].im = -out[i].im;
+}
+
+
+/*!
+ * \brief   fftWork()
+ *
+ * \param[in]    plan
+ * \param[in]    out       output array for this sub-transform
+ * \param[in]    in        input array, accessed with stride %fstride
+ * \param[in]    fstride   stride in %in, and in the twiddle array
+ * \param[in]    factors   remaining (radix, size) pairs
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) Decimation in time.  For the first radix p, with n = p * m,
+ *          the p sub-transforms of size m on the decimated inputs are
+ *          computed recursively into consecutive blocks of %out,
+ *          and then combined with butterflies of radix p.
+ *      (2) There is a butterfly for each of the radices 2, 3, 4 and 5.
+ *          A factor of 1 only occurs for n = 1, and needs nothing.
+ * </pre>
+ */
+static void
+fftWork(FFTPLAN     *plan,
+        FFTCOMPLEX  *out,
+        FFTCOMPLEX  *in,
+        l_int32      fstride,
+        l_int32     *factors)
+{
+l_int32      p, m, k;
+FFTCOMPLEX   s0, s1, s2, s3, s4, s5, s6, s7, s8, s9, s10, s11, s12;
+FFTCOMPLEX   t, ya, yb;
+FFTCOMPLEX  *outbeg, *outend, *tw;
+
+    p = factors[0];
+    m = factors[1];
+    tw = plan->twiddles;
+    outbeg = out;
+    outend = out + p * m;
+    if (m == 1) {
+        do {
+            *out = *in;
+            in += fstride;
+        } while (++out != outend);
+    } else {
+        do {
+            fftWork(plan, out, in, fstride * p, factors + 2);
+            in += fstride;
+        } while ((out += m) != outend);
+    }
+    out = outbeg;
+
+    if (p == 2) {
+        for (k = 0; k < m; k++) {
+            COMPLEX_MUL(t, out[k + m], tw[k * fstride]);
+            out[k + m].re = out[k].re - t.re;
+            out[k + m].im = out[k].im - t.im;
+            out[k].re += t.re;
+            out[k].im += t.im;
+        }
+    } else if (p == 4) {
+        for (k = 0; k < m; k++) {
+            COMPLEX_MUL(s0, out[k + m], tw[k * fstride]);
+            COMPLEX_MUL(s1, out[k + 2 * m], tw[2 * k * fstride]);
+            COMPLEX_MUL(s2, out[k + 3 * m], tw[3 * k * fstride]);
+            s5.re = out[k].re - s1.re;
+            s5.im = out[k].im - s1.im;
+            out[k].re += s1.re;
+            out[k].im += s1.im;
+            s3.re = s0.re + s2.re;
+            s3.im = s0.im + s2.im;
+            s4.re = s0.re - s2.re;
+            s4.im = s0.im - s2.im;
+            out[k + 2 * m].re = out[k].re - s3.re;
+            out[k + 2 * m].im = out[k].im - s3.im;
+            out[k].re += s3.re;
+            out[k].im += s3.im;
+            out[k + m].re = s5.re + s4.im;
+            out[k + m].im = s5.im - s4.re;
+            out[k + 3 * m].re = s5.re - s4.im;
+            out[k + 3 * m].im = s5.im + s4.re;
+        }
+    } else if (p == 3) {
+        ya = tw[fstride * m];  /* exp(-2 pi i / 3) */
+        for (k = 0; k < m; k++) {
+            COMPLEX_MUL(s1, out[k + m], tw[k * fstride]);
+            COMPLEX_MUL(s2, out[k + 2 * m], tw[2 * k * fstride]);
+            s3.re = s1.re + s2.re;
+            s3.im = s1.im + s2.im;
+            s0.re = ya.im * (s1.re - s2.re);
+            s0.im = ya.im * (s1.im - s2.im);
+            out[k + m].re = out[k].re - 0.5 * s3.re;
+            out[k + m].im = out[k].im - 0.5 * s3.im;
+            out[k].re += s3.re;
+            out[k].im += s3.im;
+            out[k + 2 * m].re = out[k + m].re + s0.im;
+            out[k + 2 * m].im = out[k + m].im - s0.re;
+            out[k + m].re -= s0.im;
+            out[k + m].im += s0.re;
+        }
+    } else if (p == 5) {
+        ya = tw[fstride * m];  /* exp(-2 pi i / 5) */
+        yb = tw[2 * fstride * m];  /* exp(-4 pi i / 5) */
+        for (k = 0; k < m; k++) {
+            s0 = out[k];
+            COMPLEX_MUL(s1, out[k + m], tw[k * fstride]);
+            COMPLEX_MUL(s2, out[k + 2 * m], tw[2 * k * fstride]);
+            COMPLEX_MUL(s3, out[k + 3 * m], tw[3 * k * fstride]);
+            COMPLEX_MUL(s4, out[k + 4 * m], tw[4 * k * fstride]);
+            s7.re = s1.re + s4.re;
+            s7.im = s1.im + s4.im;
+            s10.re = s1.re - s4.re;
+            s10.im = s1.im - s4.im;
+            s8.re = s2.re + s3.re;
+            s8.im = s2.im + s3.im;
+            s9.re = s2.re - s3.re;
+            s9.im = s2.im - s3.im;
+            out[k].re += s7.re + s8.re;
+            out[k].im += s7.im + s8.im;
+            s5.re = s0.re + s7.re * ya.re + s8.re * yb.re;
+            s5.im = s0.im + s7.im * ya.re + s8.im * yb.re;
+            s6.re = s10.im * ya.im + s9.im * yb.im;
+            s6.im = -s10.re * ya.im - s9.re * yb.im;
+            out[k + m].re = s5.re - s6.re;
+            out[k + m].im = s5.im - s6.im;
+            out[k + 4 * m].re = s5.re + s6.re;
+            out[k + 4 * m].im = s5.im + s6.im;
+            s11.re = s0.re + s7.re * yb.re + s8.re * ya.re;
+            s11.im = s0.im + s7.im * yb.re + s8.im * ya.re;
+            s12.re = ya.im * s9.im - yb.im * s10.im;
+            s12.im = yb.im * s10.re - ya.im * s9.re;
+            out[k + 2 * m].re = s11.re + s12.re;
+            out[k + 2 * m].im = s11.im + s12.im;
+            out[k + 3 * m].re = s11.re - s12.re;
+            out[k + 3 * m].im = s11.im - s12.im;
+        }
+    }
+}
@@ -312,7 +312,7 @@ SARRAY  *sa1, *sa2, *sa3;
             fileindex);
     str_dwa1 = stringNew(bigbuf);
     sprintf(bigbuf,
-            "        fhmtgen_low_%d(datad, w, h, wpld, datat, wpls, index);",
+            "        fhmtgen_low_%d(datad, w, h, wpld, datat, wplt, index);",
             fileindex);
     str_low_dt = stringNew(bigbuf);
     sprintf(bigbuf,
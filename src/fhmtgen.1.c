@@ -122,7 +122,7 @@ pixFHMTGen_1(PIX         *pixd,
              PIX         *pixs,
              const char  *selname)
 {
-l_int32    i, index, found, w, h, wpls, wpld;
+l_int32    i, index, found, w, h, wpls, wpld, wplt;
 l_uint32  *datad, *datas, *datat;
 PIX       *pixt;
 
@@ -165,8 +165,9 @@ PIX       *pixt;
     if (pixd == pixs) {  /* need temp image if in-place */
         if ((pixt = pixCopy(NULL, pixs)) == NULL)
             return (PIX *)ERROR_PTR("pixt not made", procName, pixd);
-        datat = pixGetData(pixt) + 32 * wpls + 1;
-        fhmtgen_low_1(datad, w, h, wpld, datat, wpls, index);
+        wplt = pixGetWpl(pixt);
+        datat = pixGetData(pixt) + 32 * wplt + 1;
+        fhmtgen_low_1(datad, w, h, wpld, datat, wplt, index);
         pixDestroy(&pixt);
     }
     else {  /* not in-place */
@@ -78,7 +78,7 @@ pixFlipFHMTGen(PIX         *pixd,
                PIX         *pixs,
                const char  *selname)
 {
-l_int32    i, index, found, w, h, wpls, wpld;
+l_int32    i, index, found, w, h, wpls, wpld, wplt;
 l_uint32  *datad, *datas, *datat;
 PIX       *pixt;
 
@@ -123,8 +123,9 @@ PIX       *pixt;
     if (pixd == pixs) {  /* need temp image if in-place */
         if ((pixt = pixCopy(NULL, pixs)) == NULL)
             return (PIX *)ERROR_PTR("pixt not made", procName, pixd);
-        datat = pixGetData(pixt) + ADDED_BORDER * wpls + ADDED_BORDER / 32;
-        flipfhmtgen_low(datad, w, h, wpld, datat, wpls, index);
+        wplt = pixGetWpl(pixt);
+        datat = pixGetData(pixt) + ADDED_BORDER * wplt + ADDED_BORDER / 32;
+        flipfhmtgen_low(datad, w, h, wpld, datat, wplt, index);
         pixDestroy(&pixt);
     } else {  /* simple and not in-place */
         flipfhmtgen_low(datad, w, h, wpld, datas, wpls, index);
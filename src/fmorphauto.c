@@ -348,7 +348,7 @@ SARRAY  *sa1, *sa2, *sa3;
             fileindex);
     str_dwa1 = stringNew(bigbuf);
     sprintf(bigbuf,
-      "            fmorphopgen_low_%d(datad, w, h, wpld, datat, wpls, index);",
+      "            fmorphopgen_low_%d(datad, w, h, wpld, datat, wplt, index);",
       fileindex);
     str_low_dt = stringNew(bigbuf);
     sprintf(bigbuf,
@@ -356,15 +356,15 @@ SARRAY  *sa1, *sa2, *sa3;
       fileindex);
     str_low_ds = stringNew(bigbuf);
     sprintf(bigbuf,
-     "            fmorphopgen_low_%d(datat, w, h, wpls, datas, wpls, index+1);",
+     "            fmorphopgen_low_%d(datat, w, h, wplt, datas, wpls, index+1);",
       fileindex);
     str_low_tsp1 = stringNew(bigbuf);
     sprintf(bigbuf,
-      "            fmorphopgen_low_%d(datat, w, h, wpls, datas, wpls, index);",
+      "            fmorphopgen_low_%d(datat, w, h, wplt, datas, wpls, index);",
       fileindex);
     str_low_ts = stringNew(bigbuf);
     sprintf(bigbuf,
-     "            fmorphopgen_low_%d(datad, w, h, wpld, datat, wpls, index+1);",
+     "            fmorphopgen_low_%d(datad, w, h, wpld, datat, wplt, index+1);",
       fileindex);
     str_low_dtp1 = stringNew(bigbuf);
 
@@ -184,6 +184,8 @@ FPIX       *fpixd;
         return (FPIX *)ERROR_PTR("calloc fail for data", procName, NULL);
     }
     fpixSetData(fpixd, data);
+    fpixd->datasize = 4 * (size_t)width * height;
+    pixMemRecordAlloc(L_MEM_FPIX, fpixd->datasize);
     return fpixd;
 }
 
@@ -351,10 +353,13 @@ l_float32  *data;
     fpixSetWpl(fpixd, ws);
     bytes = 4 * ws * hs;
     data = fpixGetData(fpixd);
-    if (data) LEPT_FREE(data);
+    fpixSetData(fpixd, NULL);  /* records the free of owned data */
+    LEPT_FREE(data);
     if ((data = (l_float32 *)LEPT_MALLOC(bytes)) == NULL)
         return ERROR_INT("LEPT_MALLOC fail for data", procName, 1);
     fpixSetData(fpixd, data);
+    fpixd->datasize = bytes;
+    pixMemRecordAlloc(L_MEM_FPIX, bytes);
     return 0;
 }
 
@@ -390,8 +395,10 @@ FPIX       *fpix;
         /* Decrement the ref count.  If it is 0, destroy the fpix. */
     fpixChangeRefcount(fpix, -1);
     if (fpixGetRefcount(fpix) <= 0) {
-        if ((data = fpixGetData(fpix)) != NULL)
+        if ((data = fpixGetData(fpix)) != NULL) {
             LEPT_FREE(data);
+            pixMemRecordFree(L_MEM_FPIX, fpix->datasize);
+        }
         LEPT_FREE(fpix);
     }
 
@@ -617,6 +624,13 @@ fpixGetData(FPIX  *fpix)
  * \param[in]    fpix
  * \param[in]    data
  * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This does not free any existing data.  If the existing data
+ *          was allocated by the fpix, it is no longer counted as fpix
+ *          data.  The new data is not counted.
+ * </pre>
  */
 l_ok
 fpixSetData(FPIX       *fpix,
@@ -627,6 +641,10 @@ fpixSetData(FPIX       *fpix,
     if (!fpix)
         return ERROR_INT("fpix not defined", procName, 1);
 
+    if (data != fpix->data && fpix->datasize > 0) {
+        pixMemRecordFree(L_MEM_FPIX, fpix->datasize);
+        fpix->datasize = 0;
+    }
     fpix->data = data;
     return 0;
 }
@@ -1185,6 +1203,8 @@ DPIX       *dpix;
         return (DPIX *)ERROR_PTR("calloc fail for data", procName, NULL);
     }
     dpixSetData(dpix, data);
+    dpix->datasize = 8 * (size_t)width * height;
+    pixMemRecordAlloc(L_MEM_DPIX, dpix->datasize);
     return dpix;
 }
 
@@ -1343,10 +1363,13 @@ l_float64  *data;
     dpixSetWpl(dpixd, ws);  /* 8 byte words */
     bytes = 8 * ws * hs;
     data = dpixGetData(dpixd);
-    if (data) LEPT_FREE(data);
+    dpixSetData(dpixd, NULL);  /* records the free of owned data */
+    LEPT_FREE(data);
     if ((data = (l_float64 *)LEPT_MALLOC(bytes)) == NULL)
         return ERROR_INT("LEPT_MALLOC fail for data", procName, 1);
     dpixSetData(dpixd, data);
+    dpixd->datasize = bytes;
+    pixMemRecordAlloc(L_MEM_DPIX, bytes);
     return 0;
 }
 
@@ -1382,8 +1405,10 @@ DPIX       *dpix;
         /* Decrement the ref count.  If it is 0, destroy the dpix. */
     dpixChangeRefcount(dpix, -1);
     if (dpixGetRefcount(dpix) <= 0) {
-        if ((data = dpixGetData(dpix)) != NULL)
+        if ((data = dpixGetData(dpix)) != NULL) {
             LEPT_FREE(data);
+            pixMemRecordFree(L_MEM_DPIX, dpix->datasize);
+        }
         LEPT_FREE(dpix);
     }
 
@@ -1609,6 +1634,13 @@ dpixGetData(DPIX  *dpix)
  * \param[in]    dpix
  * \param[in]    data
  * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This does not free any existing data.  If the existing data
+ *          was allocated by the dpix, it is no longer counted as dpix
+ *          data.  The new data is not counted.
+ * </pre>
  */
 l_ok
 dpixSetData(DPIX       *dpix,
@@ -1619,6 +1651,10 @@ dpixSetData(DPIX       *dpix,
     if (!dpix)
         return ERROR_INT("dpix not defined", procName, 1);
 
+    if (data != dpix->data && dpix->datasize > 0) {
+        pixMemRecordFree(L_MEM_DPIX, dpix->datasize);
+        dpix->datasize = 0;
+    }
     dpix->data = data;
     return 0;
 }
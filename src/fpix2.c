@@ -104,6 +104,9 @@
 #include <string.h>
 #include "allheaders.h"
 
+    /* Size of square tiles in fpixRotate90() */
+static const l_int32  Rotate90TileSize = 32;
+
 /*--------------------------------------------------------------------*
  *                     FPix  <-->  Pix conversions                    *
  *--------------------------------------------------------------------*/
@@ -1835,13 +1838,15 @@ fpixRotate180(FPIX  *fpixd,
  *      (1) This does a 90 degree rotation of the image about the center,
  *          either cw or ccw, returning a new pix.
  *      (2) The direction must be either 1 (cw) or -1 (ccw).
+ *      (3) This is done in square tiles, to avoid walking down the
+ *          columns of a large src image.
  * </pre>
  */
 FPIX *
 fpixRotate90(FPIX    *fpixs,
              l_int32  direction)
 {
-l_int32     i, j, wd, hd, wpls, wpld;
+l_int32     i, j, i0, j0, iend, jend, wd, hd, wpls, wpld;
 l_float32  *datas, *datad, *lines, *lined;
 FPIX       *fpixd;
 
@@ -1861,22 +1866,27 @@ FPIX       *fpixd;
     wpls = fpixGetWpl(fpixs);
     datad = fpixGetData(fpixd);
     wpld = fpixGetWpl(fpixd);
-    if (direction == 1) {  /* clockwise */
-        for (i = 0; i < hd; i++) {
-            lined = datad + i * wpld;
-            lines = datas + (wd - 1) * wpls;
-            for (j = 0; j < wd; j++) {
-                lined[j] = lines[i];
-                lines -= wpls;
-            }
-        }
-    } else {  /* ccw */
-        for (i = 0; i < hd; i++) {
-            lined = datad + i * wpld;
-            lines = datas;
-            for (j = 0; j < wd; j++) {
-                lined[j] = lines[hd - 1 - i];
-                lines += wpls;
+        /* Visit the dest in square tiles, so that the src lines
+         * read for each tile stay in the cache */
+    for (i0 = 0; i0 < hd; i0 += Rotate90TileSize) {
+        iend = L_MIN(i0 + Rotate90TileSize, hd);
+        for (j0 = 0; j0 < wd; j0 += Rotate90TileSize) {
+            jend = L_MIN(j0 + Rotate90TileSize, wd);
+            for (i = i0; i < iend; i++) {
+                lined = datad + i * wpld;
+                if (direction == 1) {  /* clockwise */
+                    lines = datas + (wd - 1 - j0) * wpls;
+                    for (j = j0; j < jend; j++) {
+                        lined[j] = lines[i];
+                        lines -= wpls;
+                    }
+                } else {  /* ccw */
+                    lines = datas + j0 * wpls;
+                    for (j = j0; j < jend; j++) {
+                        lined[j] = lines[hd - 1 - i];
+                        lines += wpls;
+                    }
+                }
             }
         }
     }
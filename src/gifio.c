@@ -642,7 +642,7 @@ static const l_int32 InterlacedJumps[] = {8, 8, 4, 2};
 static PIX *
 pixUninterlaceGIF(PIX  *pixs)
 {
-l_int32    w, h, d, wpl, j, k, srow, drow;
+l_int32    w, h, d, wpls, wpld, j, k, srow, drow;
 l_uint32  *datas, *datad, *lines, *lined;
 PIX       *pixd;
 
@@ -652,17 +652,18 @@ PIX       *pixd;
         return (PIX *)ERROR_PTR("pixs not defined", procName, NULL);
 
     pixGetDimensions(pixs, &w, &h, &d);
-    wpl = pixGetWpl(pixs);
+    wpls = pixGetWpl(pixs);
     pixd = pixCreateTemplate(pixs);
+    wpld = pixGetWpl(pixd);
     datas = pixGetData(pixs);
     datad = pixGetData(pixd);
     for (k = 0, srow = 0; k < 4; k++) {
         for (drow = InterlacedOffset[k]; drow < h;
              drow += InterlacedJumps[k], srow++) {
-            lines = datas + srow * wpl;
-            lined = datad + drow * wpl;
+            lines = datas + srow * wpls;
+            lined = datad + drow * wpld;
             for (j = 0; j < w; j++)
-                memcpy(lined, lines, 4 * wpl);
+                memcpy(lined, lines, 4 * wpld);
         }
     }
 
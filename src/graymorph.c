@@ -714,7 +714,7 @@ static PIX *
 pixErodeGray3h(PIX  *pixs)
 {
 l_uint32  *datas, *datad, *lines, *lined;
-l_int32    w, h, wpl, i, j;
+l_int32    w, h, wpls, wpld, i, j;
 l_int32    val0, val1, val2, val3, val4, val5, val6, val7, val8, val9, minval;
 PIX       *pixd;
 
@@ -729,10 +729,11 @@ PIX       *pixd;
     pixGetDimensions(pixs, &w, &h, NULL);
     datas = pixGetData(pixs);
     datad = pixGetData(pixd);
-    wpl = pixGetWpl(pixs);
+    wpls = pixGetWpl(pixs);
+    wpld = pixGetWpl(pixd);
     for (i = 0; i < h; i++) {
-        lines = datas + i * wpl;
-        lined = datad + i * wpl;
+        lines = datas + i * wpls;
+        lined = datad + i * wpld;
         for (j = 1; j < w - 8; j += 8) {
             val0 = GET_DATA_BYTE(lines, j - 1);
             val1 = GET_DATA_BYTE(lines, j);
@@ -781,7 +782,7 @@ static PIX *
 pixErodeGray3v(PIX  *pixs)
 {
 l_uint32  *datas, *datad, *linesi, *linedi;
-l_int32    w, h, wpl, i, j;
+l_int32    w, h, wpls, wpld, i, j;
 l_int32    val0, val1, val2, val3, val4, val5, val6, val7, val8, val9, minval;
 PIX       *pixd;
 
@@ -796,33 +797,34 @@ PIX       *pixd;
     pixGetDimensions(pixs, &w, &h, NULL);
     datas = pixGetData(pixs);
     datad = pixGetData(pixd);
-    wpl = pixGetWpl(pixs);
+    wpls = pixGetWpl(pixs);
+    wpld = pixGetWpl(pixd);
     for (j = 0; j < w; j++) {
         for (i = 1; i < h - 8; i += 8) {
-            linesi = datas + i * wpl;
-            linedi = datad + i * wpl;
-            val0 = GET_DATA_BYTE(linesi - wpl, j);
+            linesi = datas + i * wpls;
+            linedi = datad + i * wpld;
+            val0 = GET_DATA_BYTE(linesi - wpls, j);
             val1 = GET_DATA_BYTE(linesi, j);
-            val2 = GET_DATA_BYTE(linesi + wpl, j);
-            val3 = GET_DATA_BYTE(linesi + 2 * wpl, j);
-            val4 = GET_DATA_BYTE(linesi + 3 * wpl, j);
-            val5 = GET_DATA_BYTE(linesi + 4 * wpl, j);
-            val6 = GET_DATA_BYTE(linesi + 5 * wpl, j);
-            val7 = GET_DATA_BYTE(linesi + 6 * wpl, j);
-            val8 = GET_DATA_BYTE(linesi + 7 * wpl, j);
-            val9 = GET_DATA_BYTE(linesi + 8 * wpl, j);
+            val2 = GET_DATA_BYTE(linesi + wpls, j);
+            val3 = GET_DATA_BYTE(linesi + 2 * wpls, j);
+            val4 = GET_DATA_BYTE(linesi + 3 * wpls, j);
+            val5 = GET_DATA_BYTE(linesi + 4 * wpls, j);
+            val6 = GET_DATA_BYTE(linesi + 5 * wpls, j);
+            val7 = GET_DATA_BYTE(linesi + 6 * wpls, j);
+            val8 = GET_DATA_BYTE(linesi + 7 * wpls, j);
+            val9 = GET_DATA_BYTE(linesi + 8 * wpls, j);
             minval = L_MIN(val1, val2);
             SET_DATA_BYTE(linedi, j, L_MIN(val0, minval));
-            SET_DATA_BYTE(linedi + wpl, j, L_MIN(minval, val3));
+            SET_DATA_BYTE(linedi + wpld, j, L_MIN(minval, val3));
             minval = L_MIN(val3, val4);
-            SET_DATA_BYTE(linedi + 2 * wpl, j, L_MIN(val2, minval));
-            SET_DATA_BYTE(linedi + 3 * wpl, j, L_MIN(minval, val5));
+            SET_DATA_BYTE(linedi + 2 * wpld, j, L_MIN(val2, minval));
+            SET_DATA_BYTE(linedi + 3 * wpld, j, L_MIN(minval, val5));
             minval = L_MIN(val5, val6);
-            SET_DATA_BYTE(linedi + 4 * wpl, j, L_MIN(val4, minval));
-            SET_DATA_BYTE(linedi + 5 * wpl, j, L_MIN(minval, val7));
+            SET_DATA_BYTE(linedi + 4 * wpld, j, L_MIN(val4, minval));
+            SET_DATA_BYTE(linedi + 5 * wpld, j, L_MIN(minval, val7));
             minval = L_MIN(val7, val8);
-            SET_DATA_BYTE(linedi + 6 * wpl, j, L_MIN(val6, minval));
-            SET_DATA_BYTE(linedi + 7 * wpl, j, L_MIN(minval, val9));
+            SET_DATA_BYTE(linedi + 6 * wpld, j, L_MIN(val6, minval));
+            SET_DATA_BYTE(linedi + 7 * wpld, j, L_MIN(minval, val9));
         }
     }
     return pixd;
@@ -900,7 +902,7 @@ static PIX *
 pixDilateGray3h(PIX  *pixs)
 {
 l_uint32  *datas, *datad, *lines, *lined;
-l_int32    w, h, wpl, i, j;
+l_int32    w, h, wpls, wpld, i, j;
 l_int32    val0, val1, val2, val3, val4, val5, val6, val7, val8, val9, maxval;
 PIX       *pixd;
 
@@ -915,10 +917,11 @@ PIX       *pixd;
     pixGetDimensions(pixs, &w, &h, NULL);
     datas = pixGetData(pixs);
     datad = pixGetData(pixd);
-    wpl = pixGetWpl(pixs);
+    wpls = pixGetWpl(pixs);
+    wpld = pixGetWpl(pixd);
     for (i = 0; i < h; i++) {
-        lines = datas + i * wpl;
-        lined = datad + i * wpl;
+        lines = datas + i * wpls;
+        lined = datad + i * wpld;
         for (j = 1; j < w - 8; j += 8) {
             val0 = GET_DATA_BYTE(lines, j - 1);
             val1 = GET_DATA_BYTE(lines, j);
@@ -964,7 +967,7 @@ static PIX *
 pixDilateGray3v(PIX  *pixs)
 {
 l_uint32  *datas, *datad, *linesi, *linedi;
-l_int32    w, h, wpl, i, j;
+l_int32    w, h, wpls, wpld, i, j;
 l_int32    val0, val1, val2, val3, val4, val5, val6, val7, val8, val9, maxval;
 PIX       *pixd;
 
@@ -979,33 +982,34 @@ PIX       *pixd;
     pixGetDimensions(pixs, &w, &h, NULL);
     datas = pixGetData(pixs);
     datad = pixGetData(pixd);
-    wpl = pixGetWpl(pixs);
+    wpls = pixGetWpl(pixs);
+    wpld = pixGetWpl(pixd);
     for (j = 0; j < w; j++) {
         for (i = 1; i < h - 8; i += 8) {
-            linesi = datas + i * wpl;
-            linedi = datad + i * wpl;
-            val0 = GET_DATA_BYTE(linesi - wpl, j);
+            linesi = datas + i * wpls;
+            linedi = datad + i * wpld;
+            val0 = GET_DATA_BYTE(linesi - wpls, j);
             val1 = GET_DATA_BYTE(linesi, j);
-            val2 = GET_DATA_BYTE(linesi + wpl, j);
-            val3 = GET_DATA_BYTE(linesi + 2 * wpl, j);
-            val4 = GET_DATA_BYTE(linesi + 3 * wpl, j);
-            val5 = GET_DATA_BYTE(linesi + 4 * wpl, j);
-            val6 = GET_DATA_BYTE(linesi + 5 * wpl, j);
-            val7 = GET_DATA_BYTE(linesi + 6 * wpl, j);
-            val8 = GET_DATA_BYTE(linesi + 7 * wpl, j);
-            val9 = GET_DATA_BYTE(linesi + 8 * wpl, j);
+            val2 = GET_DATA_BYTE(linesi + wpls, j);
+            val3 = GET_DATA_BYTE(linesi + 2 * wpls, j);
+            val4 = GET_DATA_BYTE(linesi + 3 * wpls, j);
+            val5 = GET_DATA_BYTE(linesi + 4 * wpls, j);
+            val6 = GET_DATA_BYTE(linesi + 5 * wpls, j);
+            val7 = GET_DATA_BYTE(linesi + 6 * wpls, j);
+            val8 = GET_DATA_BYTE(linesi + 7 * wpls, j);
+            val9 = GET_DATA_BYTE(linesi + 8 * wpls, j);
             maxval = L_MAX(val1, val2);
             SET_DATA_BYTE(linedi, j, L_MAX(val0, maxval));
-            SET_DATA_BYTE(linedi + wpl, j, L_MAX(maxval, val3));
+            SET_DATA_BYTE(linedi + wpld, j, L_MAX(maxval, val3));
             maxval = L_MAX(val3, val4);
-            SET_DATA_BYTE(linedi + 2 * wpl, j, L_MAX(val2, maxval));
-            SET_DATA_BYTE(linedi + 3 * wpl, j, L_MAX(maxval, val5));
+            SET_DATA_BYTE(linedi + 2 * wpld, j, L_MAX(val2, maxval));
+            SET_DATA_BYTE(linedi + 3 * wpld, j, L_MAX(maxval, val5));
             maxval = L_MAX(val5, val6);
-            SET_DATA_BYTE(linedi + 4 * wpl, j, L_MAX(val4, maxval));
-            SET_DATA_BYTE(linedi + 5 * wpl, j, L_MAX(maxval, val7));
+            SET_DATA_BYTE(linedi + 4 * wpld, j, L_MAX(val4, maxval));
+            SET_DATA_BYTE(linedi + 5 * wpld, j, L_MAX(maxval, val7));
             maxval = L_MAX(val7, val8);
-            SET_DATA_BYTE(linedi + 6 * wpl, j, L_MAX(val6, maxval));
-            SET_DATA_BYTE(linedi + 7 * wpl, j, L_MAX(maxval, val9));
+            SET_DATA_BYTE(linedi + 6 * wpld, j, L_MAX(val6, maxval));
+            SET_DATA_BYTE(linedi + 7 * wpld, j, L_MAX(maxval, val9));
         }
     }
     return pixd;
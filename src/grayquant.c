@@ -119,10 +119,12 @@ static void ditherTo2bppLineLow(l_uint32 *lined, l_int32 w, l_uint32 *bufs1,
 static l_int32 make8To2DitherTables(l_int32 **ptabval, l_int32 **ptab38,
                                     l_int32 **ptab14, l_int32 cliptoblack,
                                     l_int32 cliptowhite);
-static void thresholdTo2bppLow(l_uint32 *datad, l_int32 h, l_int32 wpld,
-                               l_uint32 *datas, l_int32 wpls, l_int32 *tab);
-static void thresholdTo4bppLow(l_uint32 *datad, l_int32 h, l_int32 wpld,
-                               l_uint32 *datas, l_int32 wpls, l_int32 *tab);
+static void thresholdTo2bppLow(l_uint32 *datad, l_int32 w, l_int32 h,
+                               l_int32 wpld, l_uint32 *datas, l_int32 wpls,
+                               l_int32 *tab);
+static void thresholdTo4bppLow(l_uint32 *datad, l_int32 w, l_int32 h,
+                               l_int32 wpld, l_uint32 *datas, l_int32 wpls,
+                               l_int32 *tab);
 static l_int32 *makeGrayQuantTargetTable(l_int32 nlevels, l_int32 depth);
 static l_int32 makeGrayQuantColormapArb(PIX *pixs, l_int32 *tab,
                                         l_int32 outdepth, PIXCMAP **pcmap);
@@ -1413,7 +1415,7 @@ PIXCMAP   *cmap;
     else
         qtab = makeGrayQuantTargetTable(4, 2);
 
-    thresholdTo2bppLow(datad, h, wpld, datat, wplt, qtab);
+    thresholdTo2bppLow(datad, w, h, wpld, datat, wplt, qtab);
 
     LEPT_FREE(qtab);
     pixDestroy(&pixt);
@@ -1435,6 +1437,7 @@ PIXCMAP   *cmap;
  */
 static void
 thresholdTo2bppLow(l_uint32  *datad,
+                   l_int32    w,
                    l_int32    h,
                    l_int32    wpld,
                    l_uint32  *datas,
@@ -1442,13 +1445,14 @@ thresholdTo2bppLow(l_uint32  *datad,
                    l_int32   *tab)
 {
 l_uint8    sval1, sval2, sval3, sval4, dval;
-l_int32    i, j, k;
+l_int32    i, j, k, nswords;
 l_uint32  *lines, *lined;
 
+    nswords = (w + 3) / 4;  /* words with pixels in each src line */
     for (i = 0; i < h; i++) {
         lines = datas + i * wpls;
         lined = datad + i * wpld;
-        for (j = 0; j < wpls; j++) {
+        for (j = 0; j < nswords; j++) {
             k = 4 * j;
             sval1 = GET_DATA_BYTE(lines, k);
             sval2 = GET_DATA_BYTE(lines, k + 1);
@@ -1555,7 +1559,7 @@ PIXCMAP   *cmap;
     else
         qtab = makeGrayQuantTargetTable(16, 4);
 
-    thresholdTo4bppLow(datad, h, wpld, datat, wplt, qtab);
+    thresholdTo4bppLow(datad, w, h, wpld, datat, wplt, qtab);
 
     LEPT_FREE(qtab);
     pixDestroy(&pixt);
@@ -1577,6 +1581,7 @@ PIXCMAP   *cmap;
  */
 static void
 thresholdTo4bppLow(l_uint32  *datad,
+                   l_int32    w,
                    l_int32    h,
                    l_int32    wpld,
                    l_uint32  *datas,
@@ -1585,13 +1590,14 @@ thresholdTo4bppLow(l_uint32  *datad,
 {
 l_uint8    sval1, sval2, sval3, sval4;
 l_uint16   dval;
-l_int32    i, j, k;
+l_int32    i, j, k, nswords;
 l_uint32  *lines, *lined;
 
+    nswords = (w + 3) / 4;  /* words with pixels in each src line */
     for (i = 0; i < h; i++) {
         lines = datas + i * wpls;
         lined = datad + i * wpld;
-        for (j = 0; j < wpls; j++) {
+        for (j = 0; j < nswords; j++) {
             k = 4 * j;
             sval1 = GET_DATA_BYTE(lines, k);
             sval2 = GET_DATA_BYTE(lines, k + 1);
@@ -1802,9 +1808,9 @@ PIXCMAP   *cmap;
     wplt = pixGetWpl(pixt);
 
     if (outdepth == 2) {
-        thresholdTo2bppLow(datad, h, wpld, datat, wplt, qtab);
+        thresholdTo2bppLow(datad, w, h, wpld, datat, wplt, qtab);
     } else if (outdepth == 4) {
-        thresholdTo4bppLow(datad, h, wpld, datat, wplt, qtab);
+        thresholdTo4bppLow(datad, w, h, wpld, datat, wplt, qtab);
     } else {
         for (i = 0; i < h; i++) {
             lined = datad + i * wpld;
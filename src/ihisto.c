@@ -0,0 +1,505 @@
+/*====================================================================*
+ -  Copyright (C) 2001 Leptonica.  All rights reserved.
+ -
+ -  Redistribution and use in source and binary forms, with or without
+ -  modification, are permitted provided that the following conditions
+ -  are met:
+ -  1. Redistributions of source code must retain the above copyright
+ -     notice, this list of conditions and the following disclaimer.
+ -  2. Redistributions in binary form must reproduce the above
+ -     copyright notice, this list of conditions and the following
+ -     disclaimer in the documentation and/or other materials
+ -     provided with the distribution.
+ -
+ -  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ -  ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ -  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ -  A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL ANY
+ -  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ -  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ -  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ -  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ -  OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ -  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ -  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *====================================================================*/
+
+/*!
+ * \file ihisto.c
+ * <pre>
+ *
+ *      Create/destroy
+ *           L_IHISTO        *ihistoCreate()
+ *           void             ihistoDestroy()
+ *           l_int32          ihistoGetParameters()
+ *
+ *      Statistics in an arbitrary rectangle
+ *           NUMA            *ihistoGetHisto()
+ *           l_int32          ihistoGetRankValue()
+ *           l_int32          ihistoGetMeanVariance()
+ *
+ *      Static helpers
+ *           static l_int32   ihistoAccumulate()
+ *           static void      ihistoScanRect()
+ *
+ *  An integral histogram holds, for points on a grid over an 8 bpp
+ *  image, the histogram of all pixels above and to the left of each
+ *  point.  It is made once for the image, in a time proportional to
+ *  the number of pixels.  The histogram of any rectangle that is
+ *  aligned to the grid is then found from 4 grid histograms, in a
+ *  time proportional to the number of bins and independent of the
+ *  size of the rectangle.
+ *
+ *  Any other rectangle is split into the largest aligned rectangle
+ *  inside it, plus up to 4 strips along its sides, each less than
+ *  %cellsize pixels wide.  The pixels in the strips are counted
+ *  directly, so the histogram is always exact.  With %cellsize = 1,
+ *  every rectangle is aligned, but the storage is 4 * %nbins bytes
+ *  for every pixel.  A cellsize of 8 or 16 is usually a good compromise
+ *  between the storage and the work on the strips.
+ *
+ *  This is useful when histogram statistics are needed in many
+ *  rectangles of the same image, and particularly when the
+ *  rectangles overlap, as in a sliding window or a quadtree
+ *  (see pixQuadtreeRank()).  For the mean and variance alone,
+ *  the accumulators used in pixMeanInRectangle() and
+ *  pixVarianceInRectangle() are smaller.
+ * </pre>
+ */
+
+#include <string.h>
+#include <math.h>
+#include "allheaders.h"
+
+static l_int32 ihistoAccumulate(L_IHISTO *ih, BOX *box, l_uint32 *hist);
+static void ihistoScanRect(L_IHISTO *ih, l_int32 x0, l_int32 y0,
+                           l_int32 x1, l_int32 y1, l_uint32 *hist);
+
+    /* Maximum number of counts stored; about 2 GB */
+static const l_float64  MAX_IHISTO_COUNTS = 500000000.;
+
+
+/*-----------------------------------------------------------------------*
+ *                            Create/destroy                             *
+ *-----------------------------------------------------------------------*/
+/*!
+ * \brief   ihistoCreate()
+ *
+ * \param[in]    pixs       any depth; colormap OK
+ * \param[in]    nbins      power of 2 in [2 ... 256]; use 0 for 256
+ * \param[in]    cellsize   spacing of the grid; >= 1
+ * \return  ih, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) If pixs is not 8 bpp gray, it is converted by pixConvertTo8().
+ *      (2) With %nbins < 256, each bin holds 256 / %nbins consecutive
+ *          pixel values.  Rank values are then interpolated within
+ *          a bin, and the mean and variance use the center of each bin.
+ *      (3) The integral histogram keeps a clone of the 8 bpp image,
+ *          for counting the pixels in rectangles that are not aligned
+ *          to the grid.
+ * </pre>
+ */
+L_IHISTO *
+ihistoCreate(PIX     *pixs,
+             l_int32  nbins,
+             l_int32  cellsize)
+{
+l_int32    i, j, k, w, h, nx, ny, ky, kx, y0, y1, wpl, shift, size;
+l_int32   *xtab;
+l_uint32  *data, *line, *band, *prev, *curr, *bin, *binprev;
+PIX       *pix1;
+L_IHISTO  *ih;
+
+    PROCNAME("ihistoCreate");
+
+    if (!pixs)
+        return (L_IHISTO *)ERROR_PTR("pixs not defined", procName, NULL);
+    if (nbins == 0) nbins = 256;
+    for (shift = 0; shift <= 7; shift++) {
+        if ((256 >> shift) == nbins)
+            break;
+    }
+    if (shift > 7)
+        return (L_IHISTO *)ERROR_PTR("nbins not power of 2 in [2 ... 256]",
+                                     procName, NULL);
+    if (cellsize < 1)
+        return (L_IHISTO *)ERROR_PTR("cellsize < 1", procName, NULL);
+
+    pixGetDimensions(pixs, &w, &h, NULL);
+    nx = (w + cellsize - 1) / cellsize;
+    ny = (h + cellsize - 1) / cellsize;
+    if ((l_float64)(nx + 1) * (ny + 1) * nbins > MAX_IHISTO_COUNTS)
+        return (L_IHISTO *)ERROR_PTR("too many counts; increase cellsize",
+                                     procName, NULL);
+    if ((pix1 = pixConvertTo8(pixs, FALSE)) == NULL)
+        return (L_IHISTO *)ERROR_PTR("pix1 not made", procName, NULL);
+
+    ih = (L_IHISTO *)LEPT_CALLOC(1, sizeof(L_IHISTO));
+    size = (nx + 1) * (ny + 1) * nbins;
+    ih->data = (l_uint32 *)LEPT_CALLOC(size, sizeof(l_uint32));
+    band = (l_uint32 *)LEPT_CALLOC((nx + 1) * nbins, sizeof(l_uint32));
+    xtab = (l_int32 *)LEPT_CALLOC(w, sizeof(l_int32));
+    if (!ih->data || !band || !xtab) {
+        LEPT_FREE(band);
+        LEPT_FREE(xtab);
+        pixDestroy(&pix1);
+        ihistoDestroy(&ih);
+        return (L_IHISTO *)ERROR_PTR("arrays not made", procName, NULL);
+    }
+    ih->w = w;
+    ih->h = h;
+    ih->nbins = nbins;
+    ih->shift = shift;
+    ih->cellsize = cellsize;
+    ih->nx = nx;
+    ih->ny = ny;
+    ih->pix = pix1;
+
+        /* Offset into a band for the bins of the cell holding each column */
+    for (j = 0; j < w; j++)
+        xtab[j] = (j / cellsize + 1) * nbins;
+
+        /* For each band of rows between grid lines, histogram each cell,
+         * accumulate the cells from the left, and add the result to
+         * the grid line above. */
+    data = pixGetData(pix1);
+    wpl = pixGetWpl(pix1);
+    for (ky = 1; ky <= ny; ky++) {
+        memset(band, 0, (nx + 1) * nbins * sizeof(l_uint32));
+        y0 = (ky - 1) * cellsize;
+        y1 = L_MIN(ky * cellsize, h);
+        for (i = y0; i < y1; i++) {
+            line = data + i * wpl;
+            for (j = 0; j < w; j++)
+                band[xtab[j] + (GET_DATA_BYTE(line, j) >> shift)]++;
+        }
+        for (kx = 1; kx <= nx; kx++) {
+            bin = band + kx * nbins;
+            binprev = bin - nbins;
+            for (k = 0; k < nbins; k++)
+                bin[k] += binprev[k];
+        }
+        prev = ih->data + (ky - 1) * (nx + 1) * nbins;
+        curr = prev + (nx + 1) * nbins;
+        for (k = 0; k < (nx + 1) * nbins; k++)
+            curr[k] = prev[k] + band[k];
+    }
+
+    LEPT_FREE(band);
+    LEPT_FREE(xtab);
+    return ih;
+}
+
+
+/*!
+ * \brief   ihistoDestroy()
+ *
+ * \param[in,out]   pih     will be set to null before returning
+ * \return  void
+ */
+void
+ihistoDestroy(L_IHISTO  **pih)
+{
+L_IHISTO  *ih;
+
+    PROCNAME("ihistoDestroy");
+
+    if (pih == NULL) {
+        L_WARNING("ptr address is null!\n", procName);
+        return;
+    }
+    if ((ih = *pih) == NULL)
+        return;
+
+    pixDestroy(&ih->pix);
+    LEPT_FREE(ih->data);
+    LEPT_FREE(ih);
+    *pih = NULL;
+    return;
+}
+
+
+/*!
+ * \brief   ihistoGetParameters()
+ *
+ * \param[in]    ih
+ * \param[out]   pw, ph       [optional] image dimensions
+ * \param[out]   pnbins       [optional] number of bins
+ * \param[out]   pcellsize    [optional] spacing of the grid
+ * \return  0 if OK, 1 on error
+ */
+l_ok
+ihistoGetParameters(L_IHISTO  *ih,
+                    l_int32   *pw,
+                    l_int32   *ph,
+                    l_int32   *pnbins,
+                    l_int32   *pcellsize)
+{
+    PROCNAME("ihistoGetParameters");
+
+    if (pw) *pw = 0;
+    if (ph) *ph = 0;
+    if (pnbins) *pnbins = 0;
+    if (pcellsize) *pcellsize = 0;
+    if (!ih)
+        return ERROR_INT("ih not defined", procName, 1);
+
+    if (pw) *pw = ih->w;
+    if (ph) *ph = ih->h;
+    if (pnbins) *pnbins = ih->nbins;
+    if (pcellsize) *pcellsize = ih->cellsize;
+    return 0;
+}
+
+
+/*-----------------------------------------------------------------------*
+ *                 Statistics in an arbitrary rectangle                  *
+ *-----------------------------------------------------------------------*/
+/*!
+ * \brief   ihistoGetHisto()
+ *
+ * \param[in]    ih
+ * \param[in]    box     [optional] region; use the entire image if null
+ * \return  na  histogram of the pixels in the box, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) The box is clipped to the image.
+ *      (2) The histogram has %nbins entries.  Its parameters are set
+ *          so that the bin width is 256 / %nbins, as for histograms
+ *          made by numaMakeHistogram().
+ *      (3) With 256 bins, this gives the same result as
+ *          pixGetGrayHistogram() on the clipped region, with factor 1.
+ * </pre>
+ */
+NUMA *
+ihistoGetHisto(L_IHISTO  *ih,
+               BOX       *box)
+{
+l_int32   i;
+l_uint32  hist[256];
+NUMA     *na;
+
+    PROCNAME("ihistoGetHisto");
+
+    if (!ih)
+        return (NUMA *)ERROR_PTR("ih not defined", procName, NULL);
+    if (ihistoAccumulate(ih, box, hist))
+        return (NUMA *)ERROR_PTR("no pixels in box", procName, NULL);
+
+    na = numaCreate(ih->nbins);
+    for (i = 0; i < ih->nbins; i++)
+        numaAddNumber(na, hist[i]);
+    numaSetParameters(na, 0, 256 / ih->nbins);
+    return na;
+}
+
+
+/*!
+ * \brief   ihistoGetRankValue()
+ *
+ * \param[in]    ih
+ * \param[in]    box     [optional] region; use the entire image if null
+ * \param[in]    rank    between 0.0 and 1.0; 1.0 is brightest, 0.0 is darkest
+ * \param[out]   pval    pixel value corresponding to input rank
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) With 256 bins, this gives the same result as
+ *          pixGetRankValueMasked() on the clipped region, with no
+ *          mask and factor 1.
+ * </pre>
+ */
+l_ok
+ihistoGetRankValue(L_IHISTO   *ih,
+                   BOX        *box,
+                   l_float32   rank,
+                   l_float32  *pval)
+{
+NUMA  *na;
+
+    PROCNAME("ihistoGetRankValue");
+
+    if (!pval)
+        return ERROR_INT("&val not defined", procName, 1);
+    *pval = 0.0;
+    if (!ih)
+        return ERROR_INT("ih not defined", procName, 1);
+    if (rank < 0.0 || rank > 1.0)
+        return ERROR_INT("rank not in [0.0 ... 1.0]", procName, 1);
+
+    if ((na = ihistoGetHisto(ih, box)) == NULL)
+        return ERROR_INT("na not made", procName, 1);
+    numaHistogramGetValFromRank(na, rank, pval);
+    numaDestroy(&na);
+    return 0;
+}
+
+
+/*!
+ * \brief   ihistoGetMeanVariance()
+ *
+ * \param[in]    ih
+ * \param[in]    box      [optional] region; use the entire image if null
+ * \param[out]   pmean    [optional] mean value
+ * \param[out]   pvar     [optional] variance
+ * \param[out]   prvar    [optional] root variance
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) With fewer than 256 bins, each pixel is given the value
+ *          at the center of its bin.
+ * </pre>
+ */
+l_ok
+ihistoGetMeanVariance(L_IHISTO   *ih,
+                      BOX        *box,
+                      l_float32  *pmean,
+                      l_float32  *pvar,
+                      l_float32  *prvar)
+{
+l_int32    i, binsize;
+l_uint32   hist[256];
+l_float64  val, sum, sumsq, count, mean, var;
+
+    PROCNAME("ihistoGetMeanVariance");
+
+    if (!pmean && !pvar && !prvar)
+        return ERROR_INT("no output requested", procName, 1);
+    if (pmean) *pmean = 0.0;
+    if (pvar) *pvar = 0.0;
+    if (prvar) *prvar = 0.0;
+    if (!ih)
+        return ERROR_INT("ih not defined", procName, 1);
+    if (ihistoAccumulate(ih, box, hist))
+        return ERROR_INT("no pixels in box", procName, 1);
+
+    binsize = 256 / ih->nbins;
+    sum = sumsq = count = 0.0;
+    for (i = 0; i < ih->nbins; i++) {
+        val = binsize * i + 0.5 * (binsize - 1);
+        count += hist[i];
+        sum += val * hist[i];
+        sumsq += val * val * hist[i];
+    }
+    mean = sum / count;
+    var = L_MAX(0.0, sumsq / count - mean * mean);
+    if (pmean) *pmean = (l_float32)mean;
+    if (pvar) *pvar = (l_float32)var;
+    if (prvar) *prvar = (l_float32)sqrt(var);
+    return 0;
+}
+
+
+/*-----------------------------------------------------------------------*
+ *                            Static helpers                             *
+ *-----------------------------------------------------------------------*/
+/*!
+ * \brief   ihistoAccumulate()
+ *
+ * \param[in]    ih
+ * \param[in]    box     [optional] region; use the entire image if null
+ * \param[out]   hist    array of at least %nbins counts
+ * \return  0 if OK, 1 if there are no pixels in the box
+ *
+ * <pre>
+ * Notes:
+ *      (1) The grid points that are inside the box, or on its boundary,
+ *          bound an aligned rectangle, whose histogram is found from
+ *          the 4 corner histograms.  The pixels in the box outside the
+ *          aligned rectangle are in at most 4 strips, which are scanned.
+ *      (2) The counts are unsigned, so the differences are correct
+ *          even if the intermediate sums wrap around.
+ * </pre>
+ */
+static l_int32
+ihistoAccumulate(L_IHISTO  *ih,
+                 BOX       *box,
+                 l_uint32  *hist)
+{
+l_int32    k, x0, y0, x1, y1, bw, bh, kx0, ky0, kx1, ky1;
+l_int32    gx0, gy0, gx1, gy1, nbins, cellsize, stride;
+l_uint32  *d00, *d01, *d10, *d11;
+
+    nbins = ih->nbins;
+    memset(hist, 0, nbins * sizeof(l_uint32));
+    if (box) {
+        boxClipToRectangleParams(box, ih->w, ih->h, &x0, &y0, &x1, &y1,
+                                 &bw, &bh);
+        if (bw <= 0 || bh <= 0)
+            return 1;
+    } else {
+        x0 = y0 = 0;
+        x1 = ih->w;
+        y1 = ih->h;
+    }
+
+        /* Find the aligned rectangle.  The last grid point in each
+         * direction is at the image boundary. */
+    cellsize = ih->cellsize;
+    kx0 = (x0 + cellsize - 1) / cellsize;
+    ky0 = (y0 + cellsize - 1) / cellsize;
+    kx1 = (x1 == ih->w) ? ih->nx : x1 / cellsize;
+    ky1 = (y1 == ih->h) ? ih->ny : y1 / cellsize;
+    gx0 = L_MIN(kx0 * cellsize, ih->w);
+    gy0 = L_MIN(ky0 * cellsize, ih->h);
+    gx1 = L_MIN(kx1 * cellsize, ih->w);
+    gy1 = L_MIN(ky1 * cellsize, ih->h);
+    if (gx0 >= gx1 || gy0 >= gy1) {
+        ihistoScanRect(ih, x0, y0, x1, y1, hist);
+        return 0;
+    }
+
+    stride = (ih->nx + 1) * nbins;
+    d00 = ih->data + ky0 * stride + kx0 * nbins;
+    d01 = ih->data + ky0 * stride + kx1 * nbins;
+    d10 = ih->data + ky1 * stride + kx0 * nbins;
+    d11 = ih->data + ky1 * stride + kx1 * nbins;
+    for (k = 0; k < nbins; k++)
+        hist[k] = d11[k] - d01[k] - d10[k] + d00[k];
+
+        /* Strips above and below, then to the left and right */
+    ihistoScanRect(ih, x0, y0, x1, gy0, hist);
+    ihistoScanRect(ih, x0, gy1, x1, y1, hist);
+    ihistoScanRect(ih, x0, gy0, gx0, gy1, hist);
+    ihistoScanRect(ih, gx1, gy0, x1, gy1, hist);
+    return 0;
+}
+
+
+/*!
+ * \brief   ihistoScanRect()
+ *
+ * \param[in]    ih
+ * \param[in]    x0, y0    UL corner of rectangle
+ * \param[in]    x1, y1    one beyond the LR corner of rectangle
+ * \param[in]    hist      counts are added to this array
+ * \return  void
+ */
+static void
+ihistoScanRect(L_IHISTO  *ih,
+               l_int32    x0,
+               l_int32    y0,
+               l_int32    x1,
+               l_int32    y1,
+               l_uint32  *hist)
+{
+l_int32    i, j, wpl, shift;
+l_uint32  *data, *line;
+
+    if (x0 >= x1 || y0 >= y1)
+        return;
+    data = pixGetData(ih->pix);
+    wpl = pixGetWpl(ih->pix);
+    shift = ih->shift;
+    for (i = y0; i < y1; i++) {
+        line = data + i * wpl;
+        for (j = x0; j < x1; j++)
+            hist[GET_DATA_BYTE(line, j) >> shift]++;
+    }
+    return;
+}
@@ -235,4 +235,78 @@ struct L_Pdf_Data
 typedef struct L_Pdf_Data  L_PDF_DATA;
 
 
+/* ------------------------------------------------------------------------- *
+ *                       Strip-streaming image I/O                           *
+ * ------------------------------------------------------------------------- */
+/*
+ *  A strip reader decodes an image a band of rows at a time, and a
+ *  strip writer encodes the bands in order as they are delivered,
+ *  so that only one band of raster data need be in memory.
+ *  The supported formats are png, jpeg and tiff.  The decoder or
+ *  encoder state is opaque and owned by the format-specific functions
+ *  in pngio.c, jpegio.c and tiffio.c.  See stripio.c.
+ */
+
+/*! Strip reader */
+struct L_Strip_Reader
+{
+    l_int32            format;       /*!< IFF_PNG, IFF_JFIF_JPEG or IFF_TIFF* */
+    l_int32            w;            /*!< image width                         */
+    l_int32            h;            /*!< image height                        */
+    l_int32            d;            /*!< depth of returned strips: 1, 8, 32  */
+    l_int32            spp;          /*!< samples/pixel of returned strips    */
+    l_int32            xres;         /*!< x resolution (ppi); 0 if unknown    */
+    l_int32            yres;         /*!< y resolution (ppi); 0 if unknown    */
+    l_int32            nextrow;      /*!< index of next row to be decoded     */
+    FILE              *fp;           /*!< input stream                        */
+    void              *codec;        /*!< format-specific decoder state       */
+};
+typedef struct L_Strip_Reader  L_STRIP_READER;
+
+/*! Strip writer */
+struct L_Strip_Writer
+{
+    l_int32            format;       /*!< IFF_PNG, IFF_JFIF_JPEG or IFF_TIFF* */
+    l_int32            w;            /*!< image width; from first strip       */
+    l_int32            h;            /*!< image height                        */
+    l_int32            d;            /*!< depth; from first strip             */
+    l_int32            spp;          /*!< samples/pixel; from first strip     */
+    l_int32            xres;         /*!< x resolution; from first strip      */
+    l_int32            yres;         /*!< y resolution; from first strip      */
+    l_int32            quality;      /*!< jpeg quality; 0 for default         */
+    l_int32            nextrow;      /*!< index of next row to be encoded     */
+    FILE              *fp;           /*!< output stream                       */
+    void              *codec;        /*!< format-specific encoder state       */
+};
+typedef struct L_Strip_Writer  L_STRIP_WRITER;
+
+/*! Strip pipeline operations */
+enum {
+    L_STRIP_TRC             = 1,  /*!< tone reproduction map: 8, 32 bpp  */
+    L_STRIP_CONVERT_TO_GRAY = 2,  /*!< rgb to 8 bpp gray                 */
+    L_STRIP_THRESHOLD       = 3,  /*!< threshold 8 bpp to 1 bpp          */
+    L_STRIP_BLOCKCONV       = 4   /*!< block convolution; needs a halo   */
+};
+
+/*! One operation in a strip pipeline */
+struct L_Strip_Op
+{
+    l_int32            type;         /*!< L_STRIP_TRC, ...                    */
+    l_int32            ival[2];      /*!< integer parameters                  */
+    l_float32          fval[3];      /*!< float parameters                    */
+    struct Numa       *na;           /*!< map for L_STRIP_TRC                 */
+};
+typedef struct L_Strip_Op  L_STRIP_OP;
+
+/*! Sequence of operations applied to each strip */
+struct L_Strip_Pipe
+{
+    l_int32            n;            /*!< number of operations                */
+    l_int32            nalloc;       /*!< size of allocated op array          */
+    l_int32            halo;         /*!< rows of context needed above/below  */
+    struct L_Strip_Op *op;           /*!< array of operations                 */
+};
+typedef struct L_Strip_Pipe  L_STRIP_PIPE;
+
+
 #endif  /* LEPTONICA_IMAGEIO_H */
@@ -32,6 +32,10 @@
  *          PIX             *pixReadJpeg()  [special top level]
  *          PIX             *pixReadStreamJpeg()
  *
+ *    Read region of jpeg from file
+ *          PIX             *pixReadJpegRegion()
+ *          PIX             *pixReadStreamJpegRegion()
+ *
  *    Read jpeg metadata from file
  *          l_int32          readHeaderJpeg()
  *          l_int32          freadHeaderJpeg()
@@ -51,6 +55,14 @@
  *    Setting special flag for chroma sampling on write
  *          l_int32          pixSetChromaSampling()
  *
+ *    Strip-streaming jpeg
+ *          l_int32          stripReadOpenJpeg()
+ *          l_int32          stripReadRowsJpeg()
+ *          void             stripReadCloseJpeg()
+ *          l_int32          stripWriteOpenJpeg()
+ *          l_int32          stripWriteRowsJpeg()
+ *          l_int32          stripWriteCloseJpeg()
+ *
  *    Static system helpers
  *          static void      jpeg_error_catch_all_1()
  *          static void      jpeg_error_catch_all_2()
@@ -109,6 +121,15 @@
  *    are issued.  In order to be most likely to fail to read when there
  *    is data corruption, use L_JPEG_FAIL_ON_BAD_DATA in the %hint arg.
  *
+ *    How to decode only a region of a large image
+ *    --------------------------------------------
+ *    pixReadJpegRegion() returns the pixels within a box, optionally
+ *    at reduced resolution.  With libjpeg-turbo, the rows above the box
+ *    are skipped without color conversion and upsampling, and only the
+ *    columns of iMCUs that intersect the box are decoded.  With other
+ *    versions of libjpeg, the rows above are decoded and discarded.
+ *    In either case, decoding stops at the bottom of the box.
+ *
  *    Compressing to memory and decompressing from memory
  *    ---------------------------------------------------
  *    On systems like windows without fmemopen() and open_memstream(),
@@ -148,6 +169,15 @@
 #undef HAVE_STDLIB_H
 #include "jpeglib.h"
 
+    /* libjpeg-turbo 1.5 and later can skip rows and crop columns
+     * in decompression; see pixReadStreamJpegRegion() */
+#if defined(LIBJPEG_TURBO_VERSION_NUMBER) && \
+    LIBJPEG_TURBO_VERSION_NUMBER >= 1005000
+#define  JPEG_CROP_AND_SKIP   1
+#else
+#define  JPEG_CROP_AND_SKIP   0
+#endif
+
 static void jpeg_error_catch_all_1(j_common_ptr cinfo);
 static void jpeg_error_catch_all_2(j_common_ptr cinfo);
 static l_uint8 jpeg_getc(j_decompress_ptr cinfo);
@@ -166,6 +196,29 @@ struct callback_data {
     l_uint8  *comment;
 };
 
+    /*! Decoder state for strip-streaming jpeg */
+struct JpegStripRState
+{
+    struct jpeg_decompress_struct  cinfo;
+    struct jpeg_error_mgr          jerr;
+    jmp_buf                        jmpbuf;
+    JSAMPROW                       rowbuffer;
+    l_int32                        created;  /* cinfo needs destruction */
+    l_int32                        cmyk;     /* YCCK or CMYK source */
+};
+typedef struct JpegStripRState  JPEG_STRIP_RSTATE;
+
+    /*! Encoder state for strip-streaming jpeg */
+struct JpegStripWState
+{
+    struct jpeg_compress_struct    cinfo;
+    struct jpeg_error_mgr          jerr;
+    jmp_buf                        jmpbuf;
+    JSAMPROW                       rowbuffer;
+    l_int32                        created;  /* cinfo needs destruction */
+};
+typedef struct JpegStripWState  JPEG_STRIP_WSTATE;
+
 #ifndef  NO_CONSOLE_IO
 #define  DEBUG_INFO      0
 #endif  /* ~NO_CONSOLE_IO */
@@ -489,6 +542,276 @@ jmp_buf                        jmpbuf;  /* must be local to the function */
 }
 
 
+/*---------------------------------------------------------------------*
+ *                    Read region of jpeg from file                    *
+ *---------------------------------------------------------------------*/
+/*!
+ * \brief   pixReadJpegRegion()
+ *
+ * \param[in]    filename
+ * \param[in]    box          region to be decoded, in full resolution
+ *                            image coordinates
+ * \param[in]    reduction    scaling factor: 1, 2, 4 or 8
+ * \param[out]   pnwarn       [optional] number of warnings about
+ *                            corrupted data
+ * \param[in]    hint         a bitwise OR of L_JPEG_* values; 0 for default
+ * \return  pix, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This is a version of pixReadJpeg() that decodes only the
+ *          part of the image within %box.  See pixReadStreamJpegRegion().
+ * </pre>
+ */
+PIX *
+pixReadJpegRegion(const char  *filename,
+                  BOX         *box,
+                  l_int32      reduction,
+                  l_int32     *pnwarn,
+                  l_int32      hint)
+{
+FILE  *fp;
+PIX   *pix;
+
+    PROCNAME("pixReadJpegRegion");
+
+    if (pnwarn) *pnwarn = 0;
+    if (!filename)
+        return (PIX *)ERROR_PTR("filename not defined", procName, NULL);
+    if (!box)
+        return (PIX *)ERROR_PTR("box not defined", procName, NULL);
+
+    if ((fp = fopenReadStream(filename)) == NULL)
+        return (PIX *)ERROR_PTR("image file not found", procName, NULL);
+    pix = pixReadStreamJpegRegion(fp, box, reduction, pnwarn, hint);
+    fclose(fp);
+
+    if (!pix)
+        return (PIX *)ERROR_PTR("image not returned", procName, NULL);
+    return pix;
+}
+
+
+/*!
+ * \brief   pixReadStreamJpegRegion()
+ *
+ * \param[in]    fp           file stream
+ * \param[in]    box          region to be decoded, in full resolution
+ *                            image coordinates
+ * \param[in]    reduction    scaling factor: 1, 2, 4 or 8
+ * \param[out]   pnwarn       [optional] number of warnings
+ * \param[in]    hint         a bitwise OR of L_JPEG_* values; 0 for default
+ * \return  pix, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) %box is clipped to the image.  With %reduction > 1, the
+ *          returned pix holds the pixels of the reduced image that
+ *          cover %box, so its size is about that of %box / %reduction.
+ *      (2) The result is the same as clipping the corresponding
+ *          region from the image returned by pixReadStreamJpeg(),
+ *          without colormap.
+ *      (3) With libjpeg-turbo, jpeg_skip_scanlines() and
+ *          jpeg_crop_scanline() are used, so that the time to decode
+ *          a small region of a large image is nearly proportional to
+ *          the area of the region.  Decoding always stops at the bottom
+ *          of the region.
+ * </pre>
+ */
+PIX *
+pixReadStreamJpegRegion(FILE     *fp,
+                        BOX      *box,
+                        l_int32   reduction,
+                        l_int32  *pnwarn,
+                        l_int32   hint)
+{
+l_int32                        cyan, yellow, magenta, black, nwarn;
+l_int32                        i, j, k, w, h, wpl, spp, cmyk;
+l_int32                        x0, y0, x1, y1, bx, by, bw, bh;
+l_int32                        rval, gval, bval, imcuw;
+l_uint32                      *data, *line, *ppixel;
+JDIMENSION                     xoff, cropw;
+JSAMPROW                       rowbuffer, rowptr;
+PIX                           *pix;
+struct jpeg_decompress_struct  cinfo;
+struct jpeg_error_mgr          jerr;
+jmp_buf                        jmpbuf;  /* must be local to the function */
+
+    PROCNAME("pixReadStreamJpegRegion");
+
+    if (pnwarn) *pnwarn = 0;
+    if (!fp)
+        return (PIX *)ERROR_PTR("fp not defined", procName, NULL);
+    if (!box)
+        return (PIX *)ERROR_PTR("box not defined", procName, NULL);
+    if (reduction != 1 && reduction != 2 && reduction != 4 && reduction != 8)
+        return (PIX *)ERROR_PTR("reduction not in {1,2,4,8}", procName, NULL);
+
+    if (BITS_IN_JSAMPLE != 8)  /* set in jmorecfg.h */
+        return (PIX *)ERROR_PTR("BITS_IN_JSAMPLE != 8", procName, NULL);
+
+    rewind(fp);
+    pix = NULL;
+    rowbuffer = NULL;
+
+        /* Modify the jpeg error handling to catch fatal errors  */
+    cinfo.err = jpeg_std_error(&jerr);
+    jerr.error_exit = jpeg_error_catch_all_1;
+    cinfo.client_data = (void *)&jmpbuf;
+    if (setjmp(jmpbuf)) {
+        pixDestroy(&pix);
+        LEPT_FREE(rowbuffer);
+        return (PIX *)ERROR_PTR("internal jpeg error", procName, NULL);
+    }
+
+        /* Initialize jpeg structs for decompression */
+    jpeg_create_decompress(&cinfo);
+    jpeg_stdio_src(&cinfo, fp);
+    jpeg_read_header(&cinfo, TRUE);
+    cinfo.scale_denom = reduction;
+    cinfo.scale_num = 1;
+    jpeg_calc_output_dimensions(&cinfo);
+    if (hint & L_JPEG_READ_LUMINANCE) {
+        cinfo.out_color_space = JCS_GRAYSCALE;
+        spp = 1;
+    } else {
+        spp = cinfo.out_color_components;
+    }
+    cmyk = (spp == 4 && (cinfo.jpeg_color_space == JCS_YCCK ||
+                         cinfo.jpeg_color_space == JCS_CMYK));
+    if (spp != 1 && spp != 3 && !cmyk) {
+        jpeg_destroy_decompress(&cinfo);
+        return (PIX *)ERROR_PTR("spp must be 1 or 3, or YCCK or CMYK",
+                                procName, NULL);
+    }
+
+        /* Find the region in the (possibly reduced) output image */
+    w = cinfo.output_width;
+    h = cinfo.output_height;
+    boxGetGeometry(box, &bx, &by, &bw, &bh);
+    x0 = L_MAX(0, bx / reduction);
+    y0 = L_MAX(0, by / reduction);
+    x1 = L_MIN(w, (bx + bw + reduction - 1) / reduction);
+    y1 = L_MIN(h, (by + bh + reduction - 1) / reduction);
+    if (x1 <= x0 || y1 <= y0) {
+        jpeg_destroy_decompress(&cinfo);
+        return (PIX *)ERROR_PTR("box not within image", procName, NULL);
+    }
+
+    if ((pix = pixCreate(x1 - x0, y1 - y0, (spp == 1) ? 8 : 32)) == NULL) {
+        jpeg_destroy_decompress(&cinfo);
+        return (PIX *)ERROR_PTR("pix not made", procName, NULL);
+    }
+    pixSetInputFormat(pix, IFF_JFIF_JPEG);
+    wpl  = pixGetWpl(pix);
+    data = pixGetData(pix);
+
+        /* Start decompression, and go to the first row of the region.
+         * The cropped columns start at an iMCU boundary.  Because
+         * fancy upsampling of the chroma treats the sides of the crop
+         * as image boundaries, the crop extends one iMCU beyond the
+         * region on each side. */
+    cinfo.quantize_colors = FALSE;
+    jpeg_start_decompress(&cinfo);
+    imcuw = cinfo.max_h_samp_factor * cinfo.min_DCT_scaled_size;
+    xoff = L_MAX(0, x0 - imcuw);
+    cropw = L_MIN(w, x1 + imcuw) - xoff;
+#if JPEG_CROP_AND_SKIP
+    jpeg_crop_scanline(&cinfo, &xoff, &cropw);
+#else
+    xoff = 0;
+    cropw = w;
+#endif  /* JPEG_CROP_AND_SKIP */
+    rowbuffer = (JSAMPROW)LEPT_CALLOC(sizeof(JSAMPLE), (size_t)spp * cropw);
+    if (!rowbuffer) {
+        pixDestroy(&pix);
+        jpeg_destroy_decompress(&cinfo);
+        return (PIX *)ERROR_PTR("rowbuffer not made", procName, NULL);
+    }
+#if JPEG_CROP_AND_SKIP
+    if (y0 > 0)
+        jpeg_skip_scanlines(&cinfo, (JDIMENSION)y0);
+#else
+    for (i = 0; i < y0; i++)
+        jpeg_read_scanlines(&cinfo, &rowbuffer, (JDIMENSION)1);
+#endif  /* JPEG_CROP_AND_SKIP */
+
+        /* Decompress the rows of the region.  See pixReadStreamJpeg()
+         * for the conversion of CMYK and YCCK to rgb. */
+    for (i = 0; i < y1 - y0; i++) {
+        if (jpeg_read_scanlines(&cinfo, &rowbuffer, (JDIMENSION)1) == 0) {
+            L_ERROR("read error at scanline %d\n", procName, y0 + i);
+            pixDestroy(&pix);
+            jpeg_destroy_decompress(&cinfo);
+            LEPT_FREE(rowbuffer);
+            return (PIX *)ERROR_PTR("bad data", procName, NULL);
+        }
+        rowptr = rowbuffer + (size_t)spp * (x0 - xoff);
+        line = data + i * wpl;
+        if (spp == 1) {
+            for (j = 0; j < x1 - x0; j++)
+                SET_DATA_BYTE(line, j, rowptr[j]);
+        } else if (spp == 3) {
+            ppixel = line;
+            for (j = k = 0; j < x1 - x0; j++) {
+                SET_DATA_BYTE(ppixel, COLOR_RED, rowptr[k++]);
+                SET_DATA_BYTE(ppixel, COLOR_GREEN, rowptr[k++]);
+                SET_DATA_BYTE(ppixel, COLOR_BLUE, rowptr[k++]);
+                ppixel++;
+            }
+        } else {  /* cmyk */
+            ppixel = line;
+            for (j = k = 0; j < x1 - x0; j++) {
+                cyan = rowptr[k++];
+                magenta = rowptr[k++];
+                yellow = rowptr[k++];
+                black = rowptr[k++];
+                if (cinfo.saw_Adobe_marker) {
+                    rval = (black * cyan) / 255;
+                    gval = (black * magenta) / 255;
+                    bval = (black * yellow) / 255;
+                } else {
+                    rval = black * (255 - cyan) / 255;
+                    gval = black * (255 - magenta) / 255;
+                    bval = black * (255 - yellow) / 255;
+                }
+                rval = L_MIN(L_MAX(rval, 0), 255);
+                gval = L_MIN(L_MAX(gval, 0), 255);
+                bval = L_MIN(L_MAX(bval, 0), 255);
+                composeRGBPixel(rval, gval, bval, ppixel);
+                ppixel++;
+            }
+        }
+    }
+
+    nwarn = cinfo.err->num_warnings;
+    if (pnwarn) *pnwarn = nwarn;
+    if (cinfo.density_unit == 1) {  /* pixels per inch */
+        pixSetXRes(pix, cinfo.X_density);
+        pixSetYRes(pix, cinfo.Y_density);
+    } else if (cinfo.density_unit == 2) {  /* pixels per centimeter */
+        pixSetXRes(pix, (l_int32)((l_float32)cinfo.X_density * 2.54 + 0.5));
+        pixSetYRes(pix, (l_int32)((l_float32)cinfo.Y_density * 2.54 + 0.5));
+    }
+
+        /* The rows below the region are not read, so decompression
+         * is aborted rather than finished */
+    jpeg_destroy_decompress(&cinfo);
+    LEPT_FREE(rowbuffer);
+
+    if (nwarn > 0) {
+        if (hint & L_JPEG_FAIL_ON_BAD_DATA) {
+            L_ERROR("fail with %d warning(s) of bad data\n", procName, nwarn);
+            pixDestroy(&pix);
+        } else {
+            L_WARNING("%d warning(s) of bad data\n", procName, nwarn);
+        }
+    }
+
+    return pix;
+}
+
+
 /*---------------------------------------------------------------------*
  *                     Read jpeg metadata from file                    *
  *---------------------------------------------------------------------*/
@@ -1201,6 +1524,361 @@ pixSetChromaSampling(PIX     *pix,
 }
 
 
+/*---------------------------------------------------------------------*
+ *                      Strip-streaming jpeg I/O                       *
+ *---------------------------------------------------------------------*/
+/*!
+ * \brief   stripReadOpenJpeg()
+ *
+ * \param[in]    sr     strip reader, with open stream
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This reads the jpeg header and starts decompression.
+ *          Grayscale is returned in 8 bpp strips; rgb, YCCK and CMYK
+ *          are returned in 32 bpp strips, converted as in
+ *          pixReadStreamJpeg().
+ *      (2) The jmp_buf is stored with the decoder state, and each
+ *          function that calls into libjpeg sets it before doing so.
+ *      (3) On error, the caller must call stripReadCloseJpeg().
+ * </pre>
+ */
+l_ok
+stripReadOpenJpeg(L_STRIP_READER  *sr)
+{
+l_int32              spp;
+JPEG_STRIP_RSTATE   *js;
+
+    PROCNAME("stripReadOpenJpeg");
+
+    if (!sr || !sr->fp)
+        return ERROR_INT("sr or stream not defined", procName, 1);
+    if (BITS_IN_JSAMPLE != 8)  /* set in jmorecfg.h */
+        return ERROR_INT("BITS_IN_JSAMPLE != 8", procName, 1);
+
+    if ((js = (JPEG_STRIP_RSTATE *)LEPT_CALLOC(1, sizeof(JPEG_STRIP_RSTATE)))
+        == NULL)
+        return ERROR_INT("js not made", procName, 1);
+    sr->codec = js;
+
+        /* Modify the jpeg error handling to catch fatal errors  */
+    js->cinfo.err = jpeg_std_error(&js->jerr);
+    js->jerr.error_exit = jpeg_error_catch_all_1;
+    js->cinfo.client_data = (void *)&js->jmpbuf;
+    if (setjmp(js->jmpbuf))
+        return ERROR_INT("internal jpeg error", procName, 1);
+
+    rewind(sr->fp);
+    jpeg_create_decompress(&js->cinfo);
+    js->created = 1;
+    jpeg_stdio_src(&js->cinfo, sr->fp);
+    jpeg_read_header(&js->cinfo, TRUE);
+    jpeg_calc_output_dimensions(&js->cinfo);
+    spp = js->cinfo.out_color_components;
+    js->cmyk = (spp == 4 && (js->cinfo.jpeg_color_space == JCS_YCCK ||
+                             js->cinfo.jpeg_color_space == JCS_CMYK));
+    if (spp != 1 && spp != 3 && !js->cmyk)
+        return ERROR_INT("spp must be 1 or 3, or YCCK or CMYK",
+                         procName, 1);
+    js->cinfo.quantize_colors = FALSE;
+    jpeg_start_decompress(&js->cinfo);
+
+    sr->w = js->cinfo.output_width;
+    sr->h = js->cinfo.output_height;
+    sr->d = (spp == 1) ? 8 : 32;
+    sr->spp = (spp == 1) ? 1 : 3;
+    if (js->cinfo.density_unit == 1) {  /* pixels per inch */
+        sr->xres = js->cinfo.X_density;
+        sr->yres = js->cinfo.Y_density;
+    } else if (js->cinfo.density_unit == 2) {  /* pixels per centimeter */
+        sr->xres = (l_int32)((l_float32)js->cinfo.X_density * 2.54 + 0.5);
+        sr->yres = (l_int32)((l_float32)js->cinfo.Y_density * 2.54 + 0.5);
+    }
+    js->rowbuffer = (JSAMPROW)LEPT_CALLOC(sizeof(JSAMPLE),
+                                          (size_t)spp * sr->w);
+    if (!js->rowbuffer)
+        return ERROR_INT("rowbuffer not made", procName, 1);
+    return 0;
+}
+
+
+/*!
+ * \brief   stripReadRowsJpeg()
+ *
+ * \param[in]    sr       strip reader, opened with stripReadOpenJpeg()
+ * \param[in]    pix      width and depth given by %sr
+ * \param[in]    nrows    number of rows to decode into the top of %pix
+ * \return  0 if OK, 1 on error
+ */
+l_ok
+stripReadRowsJpeg(L_STRIP_READER  *sr,
+                  PIX             *pix,
+                  l_int32          nrows)
+{
+l_int32             i, j, k, w, wpl, rval, gval, bval;
+l_int32             cyan, magenta, yellow, black;
+l_uint32           *data, *line, *ppixel;
+JSAMPROW            rowbuf;
+JPEG_STRIP_RSTATE  *js;
+
+    PROCNAME("stripReadRowsJpeg");
+
+    if (!sr || (js = (JPEG_STRIP_RSTATE *)sr->codec) == NULL)
+        return ERROR_INT("sr or decoder not defined", procName, 1);
+    if (!pix || pixGetHeight(pix) < nrows)
+        return ERROR_INT("pix not defined or too small", procName, 1);
+
+    if (setjmp(js->jmpbuf))
+        return ERROR_INT("internal jpeg error", procName, 1);
+
+    w = sr->w;
+    rowbuf = js->rowbuffer;
+    data = pixGetData(pix);
+    wpl = pixGetWpl(pix);
+    for (i = 0; i < nrows; i++) {
+        if (jpeg_read_scanlines(&js->cinfo, &rowbuf, (JDIMENSION)1) == 0)
+            return ERROR_INT("read error at scanline", procName, 1);
+        line = data + i * wpl;
+        if (sr->d == 8) {
+            for (j = 0; j < w; j++)
+                SET_DATA_BYTE(line, j, rowbuf[j]);
+        } else if (!js->cmyk) {
+            ppixel = line;
+            for (j = k = 0; j < w; j++) {
+                SET_DATA_BYTE(ppixel, COLOR_RED, rowbuf[k++]);
+                SET_DATA_BYTE(ppixel, COLOR_GREEN, rowbuf[k++]);
+                SET_DATA_BYTE(ppixel, COLOR_BLUE, rowbuf[k++]);
+                ppixel++;
+            }
+        } else {  /* see pixReadStreamJpeg() for the conversion */
+            ppixel = line;
+            for (j = k = 0; j < w; j++) {
+                cyan = rowbuf[k++];
+                magenta = rowbuf[k++];
+                yellow = rowbuf[k++];
+                black = rowbuf[k++];
+                if (js->cinfo.saw_Adobe_marker) {
+                    rval = (black * cyan) / 255;
+                    gval = (black * magenta) / 255;
+                    bval = (black * yellow) / 255;
+                } else {
+                    rval = black * (255 - cyan) / 255;
+                    gval = black * (255 - magenta) / 255;
+                    bval = black * (255 - yellow) / 255;
+                }
+                rval = L_MIN(L_MAX(rval, 0), 255);
+                gval = L_MIN(L_MAX(gval, 0), 255);
+                bval = L_MIN(L_MAX(bval, 0), 255);
+                composeRGBPixel(rval, gval, bval, ppixel);
+                ppixel++;
+            }
+        }
+    }
+    return 0;
+}
+
+
+/*!
+ * \brief   stripReadCloseJpeg()
+ *
+ * \param[in]    sr     strip reader
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) This destroys the decoder state.  It is safe to call
+ *          after a failure in stripReadOpenJpeg().  Decompression
+ *          is aborted if not all rows have been read.
+ * </pre>
+ */
+void
+stripReadCloseJpeg(L_STRIP_READER  *sr)
+{
+JPEG_STRIP_RSTATE  *js;
+
+    if (!sr || (js = (JPEG_STRIP_RSTATE *)sr->codec) == NULL)
+        return;
+    if (js->created)
+        jpeg_destroy_decompress(&js->cinfo);
+    LEPT_FREE(js->rowbuffer);
+    LEPT_FREE(js);
+    sr->codec = NULL;
+}
+
+
+/*!
+ * \brief   stripWriteOpenJpeg()
+ *
+ * \param[in]    sw     strip writer, with open stream and image parameters
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This writes the jpeg header and starts compression.
+ *          The depth must be 8 or 32; the alpha channel is not written.
+ *          %sw->quality is used as in pixWriteStreamJpeg().
+ *      (2) On error, the caller must call stripWriteCloseJpeg().
+ * </pre>
+ */
+l_ok
+stripWriteOpenJpeg(L_STRIP_WRITER  *sw)
+{
+l_int32             quality;
+JPEG_STRIP_WSTATE  *js;
+
+    PROCNAME("stripWriteOpenJpeg");
+
+    if (!sw || !sw->fp)
+        return ERROR_INT("sw or stream not defined", procName, 1);
+    if (sw->d != 8 && sw->d != 32)
+        return ERROR_INT("depth not 8 or 32", procName, 1);
+    quality = sw->quality;
+    if (quality <= 0) quality = 75;  /* default */
+    if (quality > 100) {
+        L_ERROR("invalid jpeg quality; setting to 75\n", procName);
+        quality = 75;
+    }
+
+    if ((js = (JPEG_STRIP_WSTATE *)LEPT_CALLOC(1, sizeof(JPEG_STRIP_WSTATE)))
+        == NULL)
+        return ERROR_INT("js not made", procName, 1);
+    sw->codec = js;
+    js->rowbuffer = (JSAMPROW)LEPT_CALLOC(sizeof(JSAMPLE), 3 * sw->w);
+    if (!js->rowbuffer)
+        return ERROR_INT("rowbuffer not made", procName, 1);
+
+        /* Modify the jpeg error handling to catch fatal errors  */
+    js->cinfo.err = jpeg_std_error(&js->jerr);
+    js->jerr.error_exit = jpeg_error_catch_all_1;
+    js->cinfo.client_data = (void *)&js->jmpbuf;
+    if (setjmp(js->jmpbuf))
+        return ERROR_INT("internal jpeg error", procName, 1);
+
+    jpeg_create_compress(&js->cinfo);
+    js->created = 1;
+    jpeg_stdio_dest(&js->cinfo, sw->fp);
+    js->cinfo.image_width  = sw->w;
+    js->cinfo.image_height = sw->h;
+    if (sw->d == 8) {
+        js->cinfo.input_components = 1;
+        js->cinfo.in_color_space = JCS_GRAYSCALE;
+    } else {
+        js->cinfo.input_components = 3;
+        js->cinfo.in_color_space = JCS_RGB;
+    }
+    jpeg_set_defaults(&js->cinfo);
+    js->cinfo.optimize_coding = FALSE;
+    if (sw->xres != 0 && sw->yres != 0) {
+        js->cinfo.density_unit = 1;  /* designates pixels per inch */
+        js->cinfo.X_density = sw->xres;
+        js->cinfo.Y_density = sw->yres;
+    }
+    jpeg_set_quality(&js->cinfo, quality, TRUE);
+    jpeg_start_compress(&js->cinfo, TRUE);
+    return 0;
+}
+
+
+/*!
+ * \brief   stripWriteRowsJpeg()
+ *
+ * \param[in]    sw     strip writer, opened with stripWriteOpenJpeg()
+ * \param[in]    pix    strip; all rows are encoded
+ * \return  0 if OK, 1 on error
+ */
+l_ok
+stripWriteRowsJpeg(L_STRIP_WRITER  *sw,
+                   PIX             *pix)
+{
+l_int32             i, j, k, w, h, wpl;
+l_uint32           *data, *line, *ppixel;
+JSAMPROW            rowbuf;
+JPEG_STRIP_WSTATE  *js;
+
+    PROCNAME("stripWriteRowsJpeg");
+
+    if (!sw || (js = (JPEG_STRIP_WSTATE *)sw->codec) == NULL)
+        return ERROR_INT("sw or encoder not defined", procName, 1);
+    if (!pix)
+        return ERROR_INT("pix not defined", procName, 1);
+
+    if (setjmp(js->jmpbuf))
+        return ERROR_INT("internal jpeg error", procName, 1);
+
+    w = sw->w;
+    h = pixGetHeight(pix);
+    rowbuf = js->rowbuffer;
+    data = pixGetData(pix);
+    wpl = pixGetWpl(pix);
+    for (i = 0; i < h; i++) {
+        line = data + i * wpl;
+        if (sw->d == 8) {
+            for (j = 0; j < w; j++)
+                rowbuf[j] = GET_DATA_BYTE(line, j);
+        } else {
+            ppixel = line;
+            for (j = k = 0; j < w; j++) {
+                rowbuf[k++] = GET_DATA_BYTE(ppixel, COLOR_RED);
+                rowbuf[k++] = GET_DATA_BYTE(ppixel, COLOR_GREEN);
+                rowbuf[k++] = GET_DATA_BYTE(ppixel, COLOR_BLUE);
+                ppixel++;
+            }
+        }
+        jpeg_write_scanlines(&js->cinfo, &rowbuf, 1);
+    }
+    return 0;
+}
+
+
+/*!
+ * \brief   stripWriteCloseJpeg()
+ *
+ * \param[in]    sw       strip writer
+ * \param[in]    finish   1 to complete the jpeg; 0 to abandon it
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This destroys the encoder state.  It is safe to call
+ *          after a failure in stripWriteOpenJpeg(), with %finish = 0.
+ * </pre>
+ */
+l_ok
+stripWriteCloseJpeg(L_STRIP_WRITER  *sw,
+                    l_int32          finish)
+{
+l_int32             ret;
+volatile l_int32    dofinish;
+JPEG_STRIP_WSTATE  *js;
+
+    PROCNAME("stripWriteCloseJpeg");
+
+    if (!sw)
+        return ERROR_INT("sw not defined", procName, 1);
+    if ((js = (JPEG_STRIP_WSTATE *)sw->codec) == NULL)
+        return 0;
+
+        /* Copy %finish before the setjmp; the longjmp can clobber it */
+    dofinish = (finish && js->created) ? 1 : 0;
+    ret = 0;
+    if (dofinish) {
+        if (setjmp(js->jmpbuf)) {
+            L_ERROR("internal jpeg error\n", procName);
+            ret = 1;
+        } else {
+            jpeg_finish_compress(&js->cinfo);
+        }
+    }
+    if (js->created)
+        jpeg_destroy_compress(&js->cinfo);
+    LEPT_FREE(js->rowbuffer);
+    LEPT_FREE(js);
+    sw->codec = NULL;
+    return ret;
+}
+
+
 /*---------------------------------------------------------------------*
  *                        Static system helpers                        *
  *---------------------------------------------------------------------*/
@@ -60,6 +60,23 @@ PIX * pixReadStreamJpeg(FILE *fp, l_int32 cmflag, l_int32 reduction,
 
 /* ----------------------------------------------------------------------*/
 
+PIX * pixReadJpegRegion(const char *filename, BOX *box, l_int32 reduction,
+                        l_int32 *pnwarn, l_int32 hint)
+{
+    return (PIX * )ERROR_PTR("function not present", "pixReadJpegRegion", NULL);
+}
+
+/* ----------------------------------------------------------------------*/
+
+PIX * pixReadStreamJpegRegion(FILE *fp, BOX *box, l_int32 reduction,
+                              l_int32 *pnwarn, l_int32 hint)
+{
+    return (PIX * )ERROR_PTR("function not present",
+                             "pixReadStreamJpegRegion", NULL);
+}
+
+/* ----------------------------------------------------------------------*/
+
 l_ok readHeaderJpeg(const char *filename, l_int32 *pw, l_int32 *ph,
                     l_int32 *pspp, l_int32 *pycck, l_int32 *pcmyk)
 {
@@ -146,6 +163,49 @@ l_ok pixSetChromaSampling(PIX *pix, l_int32 sampling)
 
 /* ----------------------------------------------------------------------*/
 
+l_ok stripReadOpenJpeg(L_STRIP_READER *sr)
+{
+    return ERROR_INT("function not present", "stripReadOpenJpeg", 1);
+}
+
+/* ----------------------------------------------------------------------*/
+
+l_ok stripReadRowsJpeg(L_STRIP_READER *sr, PIX *pix, l_int32 nrows)
+{
+    return ERROR_INT("function not present", "stripReadRowsJpeg", 1);
+}
+
+/* ----------------------------------------------------------------------*/
+
+void stripReadCloseJpeg(L_STRIP_READER *sr)
+{
+    L_ERROR("function not present\n", "stripReadCloseJpeg");
+    return;
+}
+
+/* ----------------------------------------------------------------------*/
+
+l_ok stripWriteOpenJpeg(L_STRIP_WRITER *sw)
+{
+    return ERROR_INT("function not present", "stripWriteOpenJpeg", 1);
+}
+
+/* ----------------------------------------------------------------------*/
+
+l_ok stripWriteRowsJpeg(L_STRIP_WRITER *sw, PIX *pix)
+{
+    return ERROR_INT("function not present", "stripWriteRowsJpeg", 1);
+}
+
+/* ----------------------------------------------------------------------*/
+
+l_ok stripWriteCloseJpeg(L_STRIP_WRITER *sw, l_int32 finish)
+{
+    return ERROR_INT("function not present", "stripWriteCloseJpeg", 1);
+}
+
+/* ----------------------------------------------------------------------*/
+
 /* --------------------------------------------*/
 #endif  /* !HAVE_LIBJPEG */
 /* --------------------------------------------*/
@@ -1533,10 +1533,10 @@ pixCentroid(PIX        *pix,
             l_float32  *pxave,
             l_float32  *pyave)
 {
-l_int32    w, h, d, i, j, wpl, pixsum, rowsum, val;
+l_int32    w, h, d, i, j, wpl, nwords, pixsum, rowsum, val;
 l_float32  xsum, ysum;
 l_uint32  *data, *line;
-l_uint32   word;
+l_uint32   word, endmask;
 l_uint8    byte;
 l_int32   *ctab, *stab;
 
@@ -1554,7 +1554,6 @@ l_int32   *ctab, *stab;
     ctab = centtab;
     stab = sumtab;
     if (d == 1) {
-        pixSetPadBits(pix, 0);
         if (!centtab)
             ctab = makePixelCentroidTab8();
         if (!sumtab)
@@ -1563,6 +1562,8 @@ l_int32   *ctab, *stab;
 
     data = pixGetData(pix);
     wpl = pixGetWpl(pix);
+    nwords = (w + 31) / 32;  /* mask out the pad bits in the last word */
+    endmask = (w % 32) ? 0xffffffff << (32 - w % 32) : 0xffffffff;
     xsum = ysum = 0.0;
     pixsum = 0;
     if (d == 1) {
@@ -1583,8 +1584,10 @@ l_int32   *ctab, *stab;
                  */
             line = data + wpl * i;
             rowsum = 0;
-            for (j = 0; j < wpl; j++) {
+            for (j = 0; j < nwords; j++) {
                 word = line[j];
+                if (j == nwords - 1)
+                    word &= endmask;
                 if (word) {
                     byte = word & 0xff;
                     rowsum += stab[byte];
@@ -66,7 +66,11 @@
  *         struct FPixa
  *         struct DPix
  *         struct PixComp
+ *         struct L_PixCache
  *         struct PixaComp
+ *         struct L_Rle
+ *         struct L_IHisto
+ *         struct L_MemStats
  *
  *   (2) This file has definitions for:
  *         Colors for RGBA
@@ -133,6 +137,10 @@
     /* The 'special' field is by default 0, but it can hold integers
      * that direct non-default actions, e.g., in png and jpeg I/O. */
 
+    /* A view is a pix whose data is a rectangle within the data of
+     * another pix, its parent.  It uses the wpl of the parent and holds
+     * a reference to it.  See pixCreateView(). */
+
 /*! Basic Pix */
 struct Pix
 {
@@ -151,6 +159,15 @@ struct Pix
     char                *text;      /*!< text string associated with pix   */
     struct PixColormap  *colormap;  /*!< colormap (may be null)            */
     l_uint32            *data;      /*!< the image data                    */
+    struct Pix          *parent;    /*!< owner of the data, for a view;    */
+                                    /*!< null if the pix owns its data     */
+    void                *mapaddr;   /*!< start of the file mapping holding */
+                                    /*!< the data; null if not mapped      */
+    size_t               mapsize;   /*!< size of the file mapping in bytes */
+    size_t               datasize;  /*!< bytes of data allocated for this  */
+                                    /*!< pix; 0 if not allocated by it     */
+    l_uint32             arenascope; /*!< id of the arena scope in which   */
+                                    /*!< the pix was made; 0 if none       */
 };
 typedef struct Pix PIX;
 
@@ -489,13 +506,21 @@ struct Box
 };
 typedef struct Box    BOX;
 
-/*! Array of Box */
+/*! Array of Box.  A compact boxa (see boxaCreateCompact()) also holds
+ *  the geometry in the arrays bx, by, bw and bh.  In a compact boxa,
+ *  box[i] may be null; it is then made on demand from the arrays.
+ *  A non-null box[i] always takes precedence over the arrays.
+ *  Use the accessors; do not read box[i] directly. */
 struct Boxa
 {
     l_int32            n;           /*!< number of box in ptr array        */
     l_int32            nalloc;      /*!< number of box ptrs allocated      */
     l_uint32           refcount;    /*!< reference count (1 if no clones)  */
     struct Box       **box;         /*!< box ptr array                     */
+    l_int32           *bx;          /*!< compact storage of x; else null   */
+    l_int32           *by;          /*!< compact storage of y; else null   */
+    l_int32           *bw;          /*!< compact storage of w; else null   */
+    l_int32           *bh;          /*!< compact storage of h; else null   */
 };
 typedef struct Boxa  BOXA;
 
@@ -591,6 +616,8 @@ struct FPix
     l_int32              yres;      /*!< image res (ppi) in y direction    */
                                     /*!< (use 0 if unknown)                */
     l_float32           *data;      /*!< the float image data              */
+    size_t               datasize;  /*!< bytes of data allocated for this  */
+                                    /*!< fpix; 0 if not allocated by it    */
 };
 typedef struct FPix FPIX;
 
@@ -622,6 +649,8 @@ struct DPix
     l_int32              yres;      /*!< image res (ppi) in y direction    */
                                     /*!< (use 0 if unknown)                */
     l_float64           *data;      /*!< the double image data             */
+    size_t               datasize;  /*!< bytes of data allocated for this  */
+                                    /*!< dpix; 0 if not allocated by it    */
 };
 typedef struct DPix DPIX;
 
@@ -655,6 +684,24 @@ typedef struct PixComp PIXC;
  *-------------------------------------------------------------------------*/
 #define  PIXACOMP_VERSION_NUMBER 2  /*!< Version for PixaComp serialization */
 
+/*! Cache of recently decoded pix in a PixaComp.  The arrays are indexed
+ *  by the index into the PixComp ptr array.  The cached pix are in a
+ *  list ordered by the time of last use, with links in prev and next. */
+struct L_PixCache
+{
+    l_int32              nalloc;    /*!< size of the arrays                */
+    struct Pix         **pix;       /*!< decoded pix, or null if not held  */
+    l_int32             *prev;      /*!< more recently used index, or -1   */
+    l_int32             *next;      /*!< less recently used index, or -1   */
+    l_int32              head;      /*!< most recently used index, or -1   */
+    l_int32              tail;      /*!< least recently used index, or -1  */
+    size_t               maxbytes;  /*!< bound on bytes of cached pix data */
+    size_t               nbytes;    /*!< bytes of cached pix data          */
+    l_int32              nhits;     /*!< number of requests found in cache */
+    l_int32              nmisses;   /*!< number of requests decoded        */
+};
+typedef struct L_PixCache L_PIX_CACHE;
+
 /*! Array of compressed pix */
 struct PixaComp
 {
@@ -663,10 +710,74 @@ struct PixaComp
     l_int32              offset;    /*!< indexing offset into ptr array    */
     struct PixComp     **pixc;      /*!< the array of ptrs to PixComp      */
     struct Boxa         *boxa;      /*!< array of boxes                    */
+    struct L_PixCache   *cache;     /*!< optional cache of decoded pix     */
 };
 typedef struct PixaComp PIXAC;
 
 
+/*-------------------------------------------------------------------------*
+ *                  L_Rle: run-length encoded 1 bpp image                  *
+ *-------------------------------------------------------------------------*/
+/*! Run-length encoded 1 bpp image.  The runs of fg pixels on line i
+ *  have indices in [linestart[i], linestart[i + 1]), are ordered by
+ *  increasing x, and are separated by at least one bg pixel. */
+struct L_Rle
+{
+    l_int32              w;         /*!< width in pixels                   */
+    l_int32              h;         /*!< height in pixels                  */
+    l_int32              nruns;     /*!< number of runs of fg pixels       */
+    l_int32              nalloc;    /*!< size of allocated run arrays      */
+    l_int32             *x0;        /*!< first pixel of each run           */
+    l_int32             *x1;        /*!< last pixel of each run            */
+    l_int32             *linestart; /*!< index of first run on each line;  */
+                                    /*!<   array has h + 1 entries         */
+};
+typedef struct L_Rle L_RLE;
+
+
+/*-------------------------------------------------------------------------*
+ *             L_IHisto: integral histogram of an 8 bpp image              *
+ *-------------------------------------------------------------------------*/
+/*! Integral histogram.  Grid point (kx, ky) is at pixel location
+ *  (min(kx * cellsize, w), min(ky * cellsize, h)), and holds the
+ *  histogram of all pixels above and to the left of it.  The histograms
+ *  for the (nx + 1) * (ny + 1) grid points are stored in raster order. */
+struct L_IHisto
+{
+    l_int32              w;         /*!< width of image                    */
+    l_int32              h;         /*!< height of image                   */
+    l_int32              nbins;     /*!< number of bins; power of 2        */
+    l_int32              shift;     /*!< bin is (pixel value >> shift)     */
+    l_int32              cellsize;  /*!< spacing of grid points            */
+    l_int32              nx;        /*!< number of cells in x              */
+    l_int32              ny;        /*!< number of cells in y              */
+    struct Pix          *pix;       /*!< 8 bpp image, for unaligned boxes  */
+    l_uint32            *data;      /*!< counts at the grid points         */
+};
+typedef struct L_IHisto L_IHISTO;
+
+
+/*-------------------------------------------------------------------------*
+ *            L_MemStats: accounting of allocated image data               *
+ *-------------------------------------------------------------------------*/
+#define  L_MEM_NUM_TYPES      4   /*!< Number of L_MEM_* data types       */
+#define  L_MEM_NUM_BUCKETS   16   /*!< Number of allocation size buckets  */
+
+/*! Statistics for allocated image data */
+struct L_MemStats
+{
+    l_int64    current;     /*!< bytes now allocated                     */
+    l_int64    peak;        /*!< max of current since the last reset     */
+    l_int64    nalloc;      /*!< number of allocations since reset       */
+    l_int64    nfree;       /*!< number of deallocations since reset     */
+    l_int64    typebytes[L_MEM_NUM_TYPES];   /*!< current bytes, by type  */
+    l_int64    buckets[L_MEM_NUM_BUCKETS];   /*!< allocations, by size:   */
+                            /*!< bucket 0 is < 1 KB, bucket k > 0 is      */
+                            /*!< [2^(k+9), 2^(k+10)), the last is >= 16 MB */
+};
+typedef struct L_MemStats L_MEM_STATS;
+
+
 /*-------------------------------------------------------------------------*
  *                         Access and storage flags                        *
  *-------------------------------------------------------------------------*/
@@ -1338,4 +1449,22 @@ typedef void *(*alloc_fn)(size_t);
 typedef void (*dealloc_fn)(void *);
 
 
+/*-------------------------------------------------------------------------*
+ *                   Flags for accounting of image data                    *
+ *-------------------------------------------------------------------------*/
+/*! Memory Accounting Type */
+enum {
+    L_MEM_PIX = 0,           /*!< Image data of a Pix                      */
+    L_MEM_FPIX = 1,          /*!< Image data of an FPix                    */
+    L_MEM_DPIX = 2,          /*!< Image data of a DPix                     */
+    L_MEM_PIXCOMP = 3        /*!< Compressed data of a PixComp             */
+};
+
+/*! Memory Accounting Scope */
+enum {
+    L_MEM_GLOBAL = 1,        /*!< Totals for all threads                   */
+    L_MEM_THREAD = 2         /*!< Totals for the calling thread            */
+};
+
+
 #endif  /* LEPTONICA_PIX_H */
@@ -43,6 +43,8 @@
  *    Pix memory management (allows custom allocator and deallocator)
  *          static void  *pix_malloc()
  *          static void   pix_free()
+ *          static void  *pix_malloc_reuse()
+ *          static void   pixSetOwnedData()
  *          void          setPixMemoryManager()
  *
  *    Pix creation
@@ -52,6 +54,8 @@
  *          PIX          *pixCreateTemplateNoInit()
  *          PIX          *pixCreateHeader()
  *          PIX          *pixClone()
+ *          PIX          *pixCreateView()
+ *          PIX          *pixReuseOrCreate()
  *
  *    Pix destruction
  *          void          pixDestroy()
@@ -64,6 +68,7 @@
  *          l_int32       pixSizesEqual()
  *          l_int32       pixTransferAllData()
  *          l_int32       pixSwapAndDestroy()
+ *          static void   pixCopyImageData()
  *
  *    Pix accessors
  *          l_int32       pixGetWidth()
@@ -105,6 +110,8 @@
  *          l_int32       pixSetData()
  *          l_uint32     *pixExtractData()
  *          l_int32       pixFreeData()
+ *          l_int32       pixIsView()
+ *          l_int32       pixIsMapped()
  *
  *    Pix line ptrs
  *          void        **pixGetLinePtrs()
@@ -182,6 +189,32 @@
  *  sufficient so that you can do anything you want without
  *  explicitly referencing any of the pix member fields.
  *
+ *  Views of a rectangle in a pix
+ *  -----------------------------
+ *
+ *  pixCreateView() makes a pix whose data field points into the data
+ *  of another pix, without copying.  The view has its own width and
+ *  height, but the wpl of the pix it was made from, and it holds a
+ *  reference to that pix (the parent), which is released when the
+ *  view is destroyed.  Functions that only read from the pix data,
+ *  such as counting, histograms, correlation and scaling, can be
+ *  given a view in place of a clipped copy.  The copy, transfer and
+ *  data extraction functions above handle views properly.
+ *
+ *  Similarly, pixReadSpixMapped() makes a pix whose data lies in a
+ *  private mapping of an spix file.  The mapping is owned by the pix
+ *  and is unmapped when the data is freed.
+ *
+ *  Accounting of the pix data
+ *  --------------------------
+ *
+ *  The data that a pix allocates is recorded with pixMemRecordAlloc(),
+ *  and its size is kept in the pix, so that it can be recorded with
+ *  pixMemRecordFree() when it is freed or removed from the pix.  Data
+ *  that is given to a pix with pixSetData() is not counted.  See
+ *  pixMemGetStats() in pixalloc.c.
+ *
+ *
  *  However, to avoid memory smashes and leaks when doing special operations
  *  on the pix data field, look carefully at the behavior of the image
  *  data accessors and keep in mind that when you invoke pixDestroy(),
@@ -190,9 +223,15 @@
  */
 
 #include <string.h>
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif  /* !_WIN32 */
 #include "allheaders.h"
 
 static void pixFree(PIX *pix);
+static void pixSetOwnedData(PIX *pix, l_uint32 *data, size_t nbytes);
+static void pixUnmapData(PIX *pix);
+static void pixCopyImageData(PIX *pixd, const PIX *pixs);
 
 
 /*-------------------------------------------------------------------------*
@@ -253,6 +292,60 @@ pix_free(void  *ptr)
 #endif  /* _MSC_VER */
 }
 
+/*!
+ * \brief   pix_malloc_reuse()
+ *
+ * \param[in]   pix       existing pix that will get the data
+ * \param[in]   size      number of bytes requested
+ * \return  data ptr
+ *
+ * <pre>
+ * Notes:
+ *      (1) Use this for new data of an existing pix.  If the pix was not
+ *          made in the innermost open arena scope, the data must not be
+ *          taken from the arena, because the pix is still valid after
+ *          that scope is closed.  See pixArenaOpen().
+ * </pre>
+ */
+static void *
+pix_malloc_reuse(PIX     *pix,
+                 size_t   size)
+{
+void  *data;
+
+    if (pix->arenascope == pixArenaGetScope())
+        return pix_malloc(size);
+    pixArenaSuspend(1);
+    data = pix_malloc(size);
+    pixArenaSuspend(0);
+    return data;
+}
+
+/*!
+ * \brief   pixSetOwnedData()
+ *
+ * \param[in]   pix
+ * \param[in]   data      allocated with pix_malloc()
+ * \param[in]   nbytes    size of data
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) This sets data that has just been allocated for the pix,
+ *          and records the allocation.  Any existing data must first
+ *          be freed with pixFreeData().
+ * </pre>
+ */
+static void
+pixSetOwnedData(PIX       *pix,
+                l_uint32  *data,
+                size_t     nbytes)
+{
+    pixSetData(pix, data);
+    pix->datasize = nbytes;
+    pixMemRecordAlloc(L_MEM_PIX, nbytes);
+}
+
 /*!
  * \brief   setPixMemoryManager()
  *
@@ -344,7 +437,7 @@ l_uint32  *data;
         pixDestroy(&pixd);
         return (PIX *)ERROR_PTR("pix_malloc fail for data", procName, NULL);
     }
-    pixSetData(pixd, data);
+    pixSetOwnedData(pixd, data, 4LL * wpl * height);
     pixSetPadBits(pixd, 0);
     return pixd;
 }
@@ -482,6 +575,7 @@ PIX      *pixd;
         pixSetSpp(pixd, 1);
     pixd->refcount = 1;
     pixd->informat = IFF_UNKNOWN;
+    pixd->arenascope = pixArenaGetScope();
     return pixd;
 }
 
@@ -523,6 +617,152 @@ pixClone(PIX  *pixs)
 }
 
 
+/*!
+ * \brief   pixCreateView()
+ *
+ * \param[in]    pixs     all depths; colormap OK
+ * \param[in]    x, y     UL corner of the view in pixs
+ * \param[in]    w, h     size of the view
+ * \return  pixd  view of a rectangle in pixs, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) The returned pix does not own its data; it points into
+ *          the data of pixs and has the same wpl.  It holds a
+ *          reference to pixs (or to the parent of pixs, if pixs is
+ *          itself a view), so the data remains valid until the view
+ *          is destroyed, even if pixDestroy() is called on pixs.
+ *      (2) The left edge must be on a 32-bit word boundary, so
+ *          x * d must be a multiple of 32.  This is always true for
+ *          32 bpp, and for 8 bpp when x is a multiple of 4.  Also,
+ *          the full wpl of the last line of the view must lie within
+ *          the parent data, so if the rectangle touches the bottom of
+ *          the parent, x must be 0.  Use pixClipRectangleView() to make
+ *          a view where possible and a copy otherwise.
+ *      (3) The bits to the right of the view in each line, which
+ *          take the place of the pad bits, are pixels of the parent,
+ *          and pixSetPadBits() does not change them.
+ *      (4) The view shares its data with the parent, so any change
+ *          to the pixels of either is seen in the other.  Treat a
+ *          view as read-only unless that is what you want.
+ *      (5) The colormap, spp, resolution and input format are copied
+ *          from pixs; the text is not.
+ * </pre>
+ */
+PIX *
+pixCreateView(PIX     *pixs,
+              l_int32  x,
+              l_int32  y,
+              l_int32  w,
+              l_int32  h)
+{
+l_int32    ws, hs, d, wpl;
+l_uint32  *data, *dataend;
+PIX       *pixp, *pixd;
+
+    PROCNAME("pixCreateView");
+
+    if (!pixs)
+        return (PIX *)ERROR_PTR("pixs not defined", procName, NULL);
+    pixGetDimensions(pixs, &ws, &hs, &d);
+    if (x < 0 || y < 0 || w <= 0 || h <= 0 || x + w > ws || y + h > hs)
+        return (PIX *)ERROR_PTR("rectangle not within pixs", procName, NULL);
+    if ((x * d) % 32 != 0)
+        return (PIX *)ERROR_PTR("x not on a word boundary", procName, NULL);
+
+        /* The last line of the view must not extend past the data */
+    pixp = (pixs->parent) ? pixs->parent : pixs;
+    wpl = pixGetWpl(pixs);
+    data = pixGetData(pixs) + y * wpl + (x * d) / 32;
+    dataend = pixGetData(pixp) + pixGetHeight(pixp) * pixGetWpl(pixp);
+    if (data + h * wpl > dataend)
+        return (PIX *)ERROR_PTR("view extends past parent data",
+                                procName, NULL);
+
+    if ((pixd = pixCreateHeader(w, h, d)) == NULL)
+        return (PIX *)ERROR_PTR("pixd not made", procName, NULL);
+    pixSetWpl(pixd, wpl);
+    pixSetData(pixd, data);
+    pixd->parent = pixClone(pixp);
+    pixCopySpp(pixd, pixs);
+    pixCopyResolution(pixd, pixs);
+    pixCopyColormap(pixd, pixs);
+    pixCopyInputFormat(pixd, pixs);
+    return pixd;
+}
+
+
+/*!
+ * \brief   pixReuseOrCreate()
+ *
+ * \param[in]    pixd     [optional] pix to be reused; can be null
+ * \param[in]    width, height, depth
+ * \return  pixd, or a new pix if pixd is null; or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This is used by the functions that write their result into
+ *          a pix supplied by the caller (e.g., pixScaleGrayLIInto()),
+ *          so that a loop that repeatedly makes results of the same
+ *          size does not allocate image data.
+ *      (2) If pixd is null, this returns pixCreateNoInit().  Otherwise
+ *          pixd is given the requested size and depth.  Its image data
+ *          is kept if it has the required number of bytes, and is
+ *          otherwise replaced by a new buffer.  Any colormap in pixd
+ *          is removed; the other fields are unchanged.
+ *      (3) In both cases the image data is not initialized, except
+ *          for the pad bits, which are cleared.
+ *      (4) pixd must not be a clone, because the other handles would
+ *          see the change in size.
+ * </pre>
+ */
+PIX *
+pixReuseOrCreate(PIX     *pixd,
+                 l_int32  width,
+                 l_int32  height,
+                 l_int32  depth)
+{
+l_int32    wpl;
+l_uint32  *data;
+
+    PROCNAME("pixReuseOrCreate");
+
+    if (!pixd)
+        return pixCreateNoInit(width, height, depth);
+
+    if ((depth != 1) && (depth != 2) && (depth != 4) && (depth != 8)
+         && (depth != 16) && (depth != 24) && (depth != 32))
+        return (PIX *)ERROR_PTR("depth must be {1, 2, 4, 8, 16, 24, 32}",
+                                procName, NULL);
+    if (width <= 0 || height <= 0)
+        return (PIX *)ERROR_PTR("width and height must be > 0",
+                                procName, NULL);
+    if (((l_uint64)width * depth + 31) / 32 * 4 * height > ((1LL << 31) - 1))
+        return (PIX *)ERROR_PTR("requested bytes >= 2^31", procName, NULL);
+    if (pixGetRefcount(pixd) > 1)
+        return (PIX *)ERROR_PTR("pixd is a clone", procName, NULL);
+
+    wpl = (width * depth + 31) / 32;
+    if (!pixGetData(pixd) || pixIsView(pixd) || pixIsMapped(pixd) ||
+        wpl * height != pixGetWpl(pixd) * pixGetHeight(pixd)) {
+        data = (l_uint32 *)pix_malloc_reuse(pixd, 4LL * wpl * height);
+        if (!data)
+            return (PIX *)ERROR_PTR("pix_malloc fail for data",
+                                    procName, NULL);
+        pixFreeData(pixd);
+        pixSetOwnedData(pixd, data, 4LL * wpl * height);
+    }
+    pixSetWidth(pixd, width);
+    pixSetHeight(pixd, height);
+    pixSetDepth(pixd, depth);
+    pixSetWpl(pixd, wpl);
+    pixSetSpp(pixd, (depth == 24 || depth == 32) ? 3 : 1);
+    pixDestroyColormap(pixd);
+    pixSetPadBits(pixd, 0);
+    return pixd;
+}
+
+
 /*--------------------------------------------------------------------*
  *                           Pix Destruction                          *
  *--------------------------------------------------------------------*/
@@ -579,8 +819,14 @@ char      *text;
 
     pixChangeRefcount(pix, -1);
     if (pixGetRefcount(pix) <= 0) {
-        if ((data = pixGetData(pix)) != NULL)
+        if (pix->parent)  /* view; the data belongs to the parent */
+            pixDestroy(&pix->parent);
+        else if (pix->mapaddr)  /* the data is in a file mapping */
+            pixUnmapData(pix);
+        else if ((data = pixGetData(pix)) != NULL) {
+            pixMemRecordFree(L_MEM_PIX, pix->datasize);
             pix_free(data);
+        }
         if ((text = pixGetText(pix)) != NULL)
             LEPT_FREE(text);
         pixDestroyColormap(pix);
@@ -621,14 +867,15 @@ char      *text;
  *          and the copy proceeds.  The refcount of pixd is unchanged.
  *      (4) This operation, like all others that may involve a pre-existing
  *          pixd, will side-effect any existing clones of pixd.
+ *      (5) If pixs is a view, case (a) makes a pix that owns its data.
+ *          If pixd is a view of the same size as pixs, case (c) writes
+ *          into the parent of pixd.
  * </pre>
  */
 PIX *
 pixCopy(PIX        *pixd,   /* can be null */
         const PIX  *pixs)
 {
-l_int32  bytes;
-
     PROCNAME("pixCopy");
 
     if (!pixs)
@@ -636,14 +883,11 @@ l_int32  bytes;
     if (pixs == pixd)
         return pixd;
 
-        /* Total bytes in image data */
-    bytes = 4 * pixGetWpl(pixs) * pixGetHeight(pixs);
-
         /* If we're making a new pix ... */
     if (!pixd) {
-        if ((pixd = pixCreateTemplate(pixs)) == NULL)
+        if ((pixd = pixCreateTemplateNoInit(pixs)) == NULL)
             return (PIX *)ERROR_PTR("pixd not made", procName, NULL);
-        memcpy(pixd->data, pixs->data, bytes);
+        pixCopyImageData(pixd, pixs);
         return pixd;
     }
 
@@ -664,7 +908,7 @@ l_int32  bytes;
     pixCopyText(pixd, pixs);
 
         /* Copy image data */
-    memcpy(pixd->data, pixs->data, bytes);
+    pixCopyImageData(pixd, pixs);
     return pixd;
 }
 
@@ -705,9 +949,9 @@ l_uint32  *data;
 
         /* Make sure we can copy the data */
     pixGetDimensions(pixs, &w, &h, &d);
-    wpl = pixGetWpl(pixs);
+    wpl = (pixIsView(pixs)) ? (w * d + 31) / 32 : pixGetWpl(pixs);
     bytes = 4 * wpl * h;
-    if ((data = (l_uint32 *)pix_malloc(bytes)) == NULL)
+    if ((data = (l_uint32 *)pix_malloc_reuse(pixd, bytes)) == NULL)
         return ERROR_INT("pix_malloc fail for data", procName, 1);
 
         /* OK, do it */
@@ -716,7 +960,7 @@ l_uint32  *data;
     pixSetDepth(pixd, d);
     pixSetWpl(pixd, wpl);
     pixFreeData(pixd);  /* free any existing image data */
-    pixSetData(pixd, data);  /* set the uninitialized memory buffer */
+    pixSetOwnedData(pixd, data, bytes);  /* set the uninitialized buffer */
     pixCopyResolution(pixd, pixs);
     return 0;
 }
@@ -810,7 +1054,9 @@ pixSizesEqual(const PIX  *pix1,
  *      (3) This operation, like all others with a pre-existing pixd,
  *          will side-effect any existing clones of pixd.  The pixd
  *          refcount does not change.
- *      (4) When might you use this?  Suppose you have an in-place Pix
+ *      (4) If pixs is a view with refcount 1, pixd becomes a view
+ *          of the same parent.
+ *      (5) When might you use this?  Suppose you have an in-place Pix
  *          function (returning void) with the typical signature:
  *              void function-inplace(PIX *pix, ...)
  *          where "..." are non-pointer input parameters, and suppose
@@ -851,8 +1097,7 @@ pixTransferAllData(PIX     *pixd,
                    l_int32  copytext,
                    l_int32  copyformat)
 {
-l_int32  nbytes;
-PIX     *pixs;
+PIX  *pixs;
 
     PROCNAME("pixTransferAllData");
 
@@ -869,16 +1114,23 @@ PIX     *pixs;
         pixFreeData(pixd);  /* dealloc any existing data */
         pixSetData(pixd, pixGetData(pixs));  /* transfer new data from pixs */
         pixs->data = NULL;  /* pixs no longer owns data */
+        pixd->datasize = pixs->datasize;  /* transfer the accounting */
+        pixs->datasize = 0;
+        pixd->parent = pixs->parent;  /* transfer the parent of a view */
+        pixs->parent = NULL;
+        pixd->mapaddr = pixs->mapaddr;  /* transfer any file mapping */
+        pixd->mapsize = pixs->mapsize;
+        pixs->mapaddr = NULL;
         pixSetColormap(pixd, pixGetColormap(pixs));  /* frees old; sets new */
         pixs->colormap = NULL;  /* pixs no longer owns colormap */
         if (copytext) {
             pixSetText(pixd, pixGetText(pixs));
             pixSetText(pixs, NULL);
         }
+        pixCopyDimensions(pixd, pixs);
     } else {  /* preserve pixs by making a copy of the data, cmap, text */
-        pixResizeImageData(pixd, pixs);
-        nbytes = 4 * pixGetWpl(pixs) * pixGetHeight(pixs);
-        memcpy(pixGetData(pixd), pixGetData(pixs), nbytes);
+        pixResizeImageData(pixd, pixs);  /* sets the dimensions */
+        pixCopyImageData(pixd, pixs);
         pixCopyColormap(pixd, pixs);
         if (copytext)
             pixCopyText(pixd, pixs);
@@ -886,7 +1138,6 @@ PIX     *pixs;
 
     pixCopySpp(pixd, pixs);
     pixCopyResolution(pixd, pixs);
-    pixCopyDimensions(pixd, pixs);
     if (copyformat)
         pixCopyInputFormat(pixd, pixs);
 
@@ -957,6 +1208,36 @@ pixSwapAndDestroy(PIX  **ppixd,
 }
 
 
+/*!
+ * \brief   pixCopyImageData()
+ *
+ * \param[in]   pixd    same size as pixs
+ * \param[in]   pixs
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) If neither pix is a view, the data is copied in one block.
+ *          Otherwise, the wpl may differ and the bits to the right of
+ *          a view belong to its parent, so the pixels are copied
+ *          with a rasterop.
+ * </pre>
+ */
+static void
+pixCopyImageData(PIX        *pixd,
+                 const PIX  *pixs)
+{
+    if (!pixIsView(pixd) && !pixIsView(pixs)) {
+        memcpy(pixd->data, pixs->data,
+               4LL * pixGetWpl(pixs) * pixGetHeight(pixs));
+    } else {
+        pixRasterop(pixd, 0, 0, pixGetWidth(pixs), pixGetHeight(pixs),
+                    PIX_SRC, (PIX *)pixs, 0, 0);
+    }
+    return;
+}
+
+
 /*--------------------------------------------------------------------*
  *                                Accessors                           *
  *--------------------------------------------------------------------*/
@@ -1636,6 +1917,8 @@ pixGetData(PIX  *pix)
  * Notes:
  *      (1) This does not free any existing data.  To free existing
  *          data, use pixFreeData() before pixSetData().
+ *      (2) If the existing data was allocated by the pix, it is no
+ *          longer counted as pix data.  The new data is not counted.
  * </pre>
  */
 l_int32
@@ -1647,6 +1930,10 @@ pixSetData(PIX       *pix,
     if (!pix)
         return ERROR_INT("pix not defined", procName, 1);
 
+    if (data != pix->data && pix->datasize > 0) {
+        pixMemRecordFree(L_MEM_PIX, pix->datasize);
+        pix->datasize = 0;
+    }
     pix->data = data;
     return 0;
 }
@@ -1666,6 +1953,11 @@ pixSetData(PIX       *pix,
  *          pix->data ptr is set to NULL.
  *      (3) If refcount > 1, this simply returns a copy of the data,
  *          using the pix allocator, and leaving the input pix unchanged.
+ *      (4) If pixs is a view, the data belongs to the parent, so a copy
+ *          is always returned.  The lines of the copy are packed with
+ *          wpl = (w * d + 31) / 32, which is less than pixGetWpl(pixs).
+ *      (5) Likewise, if the data of pixs is in a file mapping, a copy
+ *          is always returned.
  * </pre>
  */
 l_uint32 *
@@ -1673,12 +1965,22 @@ pixExtractData(PIX  *pixs)
 {
 l_int32    count, bytes;
 l_uint32  *data, *datas;
+PIX       *pix1;
 
     PROCNAME("pixExtractData");
 
     if (!pixs)
         return (l_uint32 *)ERROR_PTR("pixs not defined", procName, NULL);
 
+    if (pixIsView(pixs) || pixIsMapped(pixs)) {  /* copy; packed lines */
+        if ((pix1 = pixCopy(NULL, pixs)) == NULL)
+            return (l_uint32 *)ERROR_PTR("pix1 not made", procName, NULL);
+        data = pixGetData(pix1);
+        pixSetData(pix1, NULL);
+        pixDestroy(&pix1);
+        return data;
+    }
+
     count = pixGetRefcount(pixs);
     if (count == 1) {  /* extract */
         data = pixGetData(pixs);
@@ -1707,6 +2009,9 @@ l_uint32  *data, *datas;
  *          It should be used before pixSetData() in the situation where
  *          you want to free any existing data before doing
  *          a subsequent assignment with pixSetData().
+ *      (2) If the pix is a view, the reference to its parent is
+ *          released instead, and the pix is no longer a view.
+ *      (3) If the data is in a file mapping, the mapping is removed.
  * </pre>
  */
 l_int32
@@ -1719,7 +2024,15 @@ l_uint32  *data;
     if (!pix)
         return ERROR_INT("pix not defined", procName, 1);
 
-    if ((data = pixGetData(pix)) != NULL) {
+    if (pix->parent) {
+        pixDestroy(&pix->parent);
+        pix->data = NULL;
+    } else if (pix->mapaddr) {
+        pixUnmapData(pix);
+        pix->data = NULL;
+    } else if ((data = pixGetData(pix)) != NULL) {
+        pixMemRecordFree(L_MEM_PIX, pix->datasize);
+        pix->datasize = 0;
         pix_free(data);
         pix->data = NULL;
     }
@@ -1727,6 +2040,68 @@ l_uint32  *data;
 }
 
 
+/*!
+ * \brief   pixIsView()
+ *
+ * \param[in]   pix
+ * \return  1 if the pix is a view of the data in another pix; 0 otherwise
+ */
+l_int32
+pixIsView(const PIX  *pix)
+{
+    PROCNAME("pixIsView");
+
+    if (!pix)
+        return ERROR_INT("pix not defined", procName, 0);
+    return (pix->parent != NULL) ? 1 : 0;
+}
+
+
+/*!
+ * \brief   pixIsMapped()
+ *
+ * \param[in]   pix
+ * \return  1 if the pix data is in a file mapping; 0 otherwise
+ *
+ * <pre>
+ * Notes:
+ *      (1) See pixReadSpixMapped().
+ * </pre>
+ */
+l_int32
+pixIsMapped(const PIX  *pix)
+{
+    PROCNAME("pixIsMapped");
+
+    if (!pix)
+        return ERROR_INT("pix not defined", procName, 0);
+    return (pix->mapaddr != NULL) ? 1 : 0;
+}
+
+
+/*!
+ * \brief   pixUnmapData()
+ *
+ * \param[in]   pix
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) Removes the file mapping that holds the pix data.  The data
+ *          ptr is left for the caller to reset.
+ * </pre>
+ */
+static void
+pixUnmapData(PIX  *pix)
+{
+#ifndef _WIN32
+    munmap(pix->mapaddr, pix->mapsize);
+#endif  /* !_WIN32 */
+    pix->mapaddr = NULL;
+    pix->mapsize = 0;
+}
+
+
 /*--------------------------------------------------------------------*
  *                          Pix line ptrs                             *
  *--------------------------------------------------------------------*/
@@ -870,14 +870,16 @@ PIXCMAP  *cmap;
  *          alpha component will be retained and used. The function
  *          pixCreate(w, h, 32) makes an RGB image by default, and
  *          pixSetSpp(pix, 4) can be used to promote an RGB image to RGBA.
+ *      (4) For a view, the bits to the right of each line are pixels
+ *          of the parent, and they are not changed.
  * </pre>
  */
 l_ok
 pixSetAllArbitrary(PIX      *pix,
                    l_uint32  val)
 {
-l_int32    n, i, j, w, h, d, wpl, npix;
-l_uint32   maxval, wordval;
+l_int32    n, i, j, w, h, d, wpl, npix, nwords, endbits;
+l_uint32   maxval, wordval, endmask;
 l_uint32  *data, *line;
 PIXCMAP   *cmap;
 
@@ -915,11 +917,20 @@ PIXCMAP   *cmap;
         wordval |= (val << (j * d));
     wpl = pixGetWpl(pix);
     data = pixGetData(pix);
+    nwords = wpl;
+    endbits = 0;
+    if (pixIsView(pix)) {
+        nwords = (w * d) / 32;
+        endbits = (w * d) % 32;
+    }
+    endmask = (endbits) ? ~rmask32[32 - endbits] : 0;
     for (i = 0; i < h; i++) {
         line = data + i * wpl;
-        for (j = 0; j < wpl; j++) {
+        for (j = 0; j < nwords; j++) {
             *(line + j) = wordval;
         }
+        if (endbits)
+            line[nwords] = (line[nwords] & ~endmask) | (wordval & endmask);
     }
     return 0;
 }
@@ -1291,6 +1302,8 @@ l_uint32  *datas, *lines;
  *      (2) This sets the value of the pad bits (if any) in the last
  *          32-bit word in each scanline.
  *      (3) For 32 bpp pix, there are no pad bits, so this is a no-op.
+ *          It is also a no-op for a view, where the bits to the right
+ *          of each line are pixels of the parent.
  *      (4) When writing formatted output, such as tiff, png or jpeg,
  *          the pad bits have no effect on the raster image that is
  *          generated by reading back from the file.  However, in some
@@ -1319,6 +1332,8 @@ l_uint32  *data, *pword;
     pixGetDimensions(pix, &w, &h, &d);
     if (d == 32)  /* no padding exists for 32 bpp */
         return 0;
+    if (pixIsView(pix))  /* bits to the right belong to the parent */
+        return 0;
 
     data = pixGetData(pix);
     wpl = pixGetWpl(pix);
@@ -1361,6 +1376,7 @@ l_uint32  *data, *pword;
  *          32-bit word in each scanline, within the specified
  *          band of raster lines.
  *      (3) For 32 bpp pix, there are no pad bits, so this is a no-op.
+ *          It is also a no-op for a view; see pixSetPadBits().
  * </pre>
  */
 l_ok
@@ -1381,6 +1397,8 @@ l_uint32  *data, *pword;
     pixGetDimensions(pix, &w, &h, &d);
     if (d == 32)  /* no padding exists for 32 bpp */
         return 0;
+    if (pixIsView(pix))  /* bits to the right belong to the parent */
+        return 0;
 
     if (by < 0)
         by = 0;
@@ -2881,8 +2899,8 @@ l_int32    wpls;
 PIX *
 pixEndianByteSwapNew(PIX  *pixs)
 {
-l_uint32  *datas, *datad;
-l_int32    i, j, h, wpl;
+l_uint32  *datas, *datad, *lines, *lined;
+l_int32    i, j, h, wpls, wpld;
 l_uint32   word;
 PIX       *pixd;
 
@@ -2898,17 +2916,20 @@ PIX       *pixd;
         return (PIX *)ERROR_PTR("pixs not defined", procName, NULL);
 
     datas = pixGetData(pixs);
-    wpl = pixGetWpl(pixs);
+    wpls = pixGetWpl(pixs);
     h = pixGetHeight(pixs);
     pixd = pixCreateTemplate(pixs);
     datad = pixGetData(pixd);
+    wpld = pixGetWpl(pixd);  /* less than wpls if pixs is a view */
     for (i = 0; i < h; i++) {
-        for (j = 0; j < wpl; j++, datas++, datad++) {
-            word = *datas;
-            *datad = (word >> 24) |
-                    ((word >> 8) & 0x0000ff00) |
-                    ((word << 8) & 0x00ff0000) |
-                    (word << 24);
+        lines = datas + i * wpls;
+        lined = datad + i * wpld;
+        for (j = 0; j < wpld; j++) {
+            word = lines[j];
+            lined[j] = (word >> 24) |
+                       ((word >> 8) & 0x0000ff00) |
+                       ((word << 8) & 0x00ff0000) |
+                       (word << 24);
         }
     }
 
@@ -3055,8 +3076,8 @@ l_uint32  word;
 PIX *
 pixEndianTwoByteSwapNew(PIX  *pixs)
 {
-l_uint32  *datas, *datad;
-l_int32    i, j, h, wpl;
+l_uint32  *datas, *datad, *lines, *lined;
+l_int32    i, j, h, wpls, wpld;
 l_uint32   word;
 PIX       *pixd;
 
@@ -3072,14 +3093,17 @@ PIX       *pixd;
         return (PIX *)ERROR_PTR("pixs not defined", procName, NULL);
 
     datas = pixGetData(pixs);
-    wpl = pixGetWpl(pixs);
+    wpls = pixGetWpl(pixs);
     h = pixGetHeight(pixs);
     pixd = pixCreateTemplate(pixs);
     datad = pixGetData(pixd);
+    wpld = pixGetWpl(pixd);  /* less than wpls if pixs is a view */
     for (i = 0; i < h; i++) {
-        for (j = 0; j < wpl; j++, datas++, datad++) {
-            word = *datas;
-            *datad = (word << 16) | (word >> 16);
+        lines = datas + i * wpls;
+        lined = datad + i * wpld;
+        for (j = 0; j < wpld; j++) {
+            word = lines[j];
+            lined[j] = (word << 16) | (word >> 16);
         }
     }
 
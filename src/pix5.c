@@ -56,6 +56,8 @@
  *    Extract rectangular region
  *           PIXA       *pixClipRectangles()
  *           PIX        *pixClipRectangle()
+ *           PIXA       *pixClipRectanglesView()
+ *           PIX        *pixClipRectangleView()
  *           PIX        *pixClipMasked()
  *           l_int32     pixCropToMatch()
  *           PIX        *pixCropToSize()
@@ -1061,6 +1063,127 @@ PIX     *pixd;
 }
 
 
+/*!
+ * \brief   pixClipRectanglesView()
+ *
+ * \param[in]    pixs
+ * \param[in]    boxa  requested clipping regions
+ * \return  pixa consisting of views of the requested regions,
+ *              or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *     (1) This is the same as pixClipRectangles(), except that each
+ *         region is a view into pixs where possible, and is copied
+ *         otherwise.  See pixClipRectangleView().
+ *     (2) The returned pixa includes the actual regions clipped out from
+ *         the input pixs.
+ * </pre>
+ */
+PIXA *
+pixClipRectanglesView(PIX   *pixs,
+                      BOXA  *boxa)
+{
+l_int32  i, n;
+BOX     *box, *boxc;
+PIX     *pix;
+PIXA    *pixa;
+
+    PROCNAME("pixClipRectanglesView");
+
+    if (!pixs)
+        return (PIXA *)ERROR_PTR("pixs not defined", procName, NULL);
+    if (!boxa)
+        return (PIXA *)ERROR_PTR("boxa not defined", procName, NULL);
+
+    n = boxaGetCount(boxa);
+    pixa = pixaCreate(n);
+    for (i = 0; i < n; i++) {
+        box = boxaGetBox(boxa, i, L_CLONE);
+        pix = pixClipRectangleView(pixs, box, &boxc);
+        pixaAddPix(pixa, pix, L_INSERT);
+        pixaAddBox(pixa, boxc, L_INSERT);
+        boxDestroy(&box);
+    }
+
+    return pixa;
+}
+
+
+/*!
+ * \brief   pixClipRectangleView()
+ *
+ * \param[in]    pixs
+ * \param[in]    box    requested clipping region; const
+ * \param[out]   pboxc  [optional] actual box of clipped region
+ * \return  view or copy of the clipped region, or NULL on error or
+ *              if rectangle doesn't intersect pixs
+ *
+ * <pre>
+ * Notes:
+ *      (1) This clips the box to pixs, as in pixClipRectangle().  If
+ *          the clipped region can be represented as a view into the
+ *          data of pixs, it is returned without copying the pixels.
+ *          Otherwise, the region is copied.  Use pixIsView() to tell
+ *          which was done.
+ *      (2) A view is possible when the left edge of the region is on
+ *          a 32-bit word boundary, and the region either starts at
+ *          x = 0 or does not reach the bottom of pixs.  For 32 bpp,
+ *          the left edge is always on a word boundary.
+ *      (3) For depths less than 8, the region must also end on a word
+ *          boundary.  Otherwise, the bits at the end of each line, which
+ *          would be pad bits in a copy, are pixels of pixs, and some
+ *          word-level operations on 1 bpp images require them to be 0.
+ *      (4) The view holds a reference to pixs, and shares its pixels.
+ *          It is intended for functions that do not write to their input.
+ *          See pixCreateView() for details.
+ * </pre>
+ */
+PIX *
+pixClipRectangleView(PIX   *pixs,
+                     BOX   *box,
+                     BOX  **pboxc)
+{
+l_int32  w, h, d, bx, by, bw, bh;
+BOX     *boxc;
+PIX     *pixd;
+
+    PROCNAME("pixClipRectangleView");
+
+    if (pboxc) *pboxc = NULL;
+    if (!pixs)
+        return (PIX *)ERROR_PTR("pixs not defined", procName, NULL);
+    if (!box)
+        return (PIX *)ERROR_PTR("box not defined", procName, NULL);
+
+        /* Clip the input box to the pix */
+    pixGetDimensions(pixs, &w, &h, &d);
+    if ((boxc = boxClipToRectangle(box, w, h)) == NULL) {
+        L_WARNING("box doesn't overlap pix\n", procName);
+        return NULL;
+    }
+    boxGetGeometry(boxc, &bx, &by, &bw, &bh);
+
+        /* Make a view if possible; otherwise, copy */
+    if ((bx * d) % 32 == 0 && (d >= 8 || (bw * d) % 32 == 0) &&
+        (bx == 0 || by + bh < h))
+        pixd = pixCreateView(pixs, bx, by, bw, bh);
+    else
+        pixd = pixClipRectangle(pixs, boxc, NULL);
+    if (!pixd) {
+        boxDestroy(&boxc);
+        return (PIX *)ERROR_PTR("pixd not made", procName, NULL);
+    }
+
+    if (pboxc)
+        *pboxc = boxc;
+    else
+        boxDestroy(&boxc);
+
+    return pixd;
+}
+
+
 /*!
  * \brief   pixClipMasked()
  *
@@ -3064,7 +3187,7 @@ PTA       *pta;
 PIX *
 pixRankRowTransform(PIX  *pixs)
 {
-l_int32    i, j, k, m, w, h, wpl, val;
+l_int32    i, j, k, m, w, h, wpls, wpld, val;
 l_int32    histo[256];
 l_uint32  *datas, *datad, *lines, *lined;
 PIX       *pixd;
@@ -3082,11 +3205,12 @@ PIX       *pixd;
     pixd = pixCreateTemplate(pixs);
     datas = pixGetData(pixs);
     datad = pixGetData(pixd);
-    wpl = pixGetWpl(pixs);
+    wpls = pixGetWpl(pixs);
+    wpld = pixGetWpl(pixd);
     for (i = 0; i < h; i++) {
         memset(histo, 0, 1024);
-        lines = datas + i * wpl;
-        lined = datad + i * wpl;
+        lines = datas + i * wpls;
+        lined = datad + i * wpld;
         for (j = 0; j < w; j++) {
             val = GET_DATA_BYTE(lines, j);
             histo[val]++;
@@ -263,6 +263,8 @@ PIXA    *pixa;
  *          or entirely outside the pix, a warning is returned as TRUE.
  *      (3) pixad will have only the properly clipped elements, and
  *          the internal boxa will be correct.
+ *      (4) Each region is copied.  To avoid copying regions that are
+ *          only read, use pixClipRectanglesView().
  * </pre>
  */
 PIXA *
@@ -812,6 +814,8 @@ BOX  *box;
     if (accesstype != L_COPY && accesstype != L_CLONE)
         return (BOX *)ERROR_PTR("invalid accesstype", procName, NULL);
 
+    if (boxaIsCompact(pixa->boxa))
+        return boxaGetBox(pixa->boxa, index, accesstype);
     box = pixa->boxa->box[index];
     if (box) {
         if (accesstype == L_COPY)
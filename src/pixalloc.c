@@ -38,10 +38,65 @@
  *          l_int32       pmsGetLevelForAlloc()
  *          l_int32       pmsGetLevelForDealloc()
  *          void          pmsLogInfo()
+ *
+ *      Scoped scratch arena with allocator and deallocator
+ *
+ *          l_int32       pixArenaOpen()
+ *          PIX          *pixArenaClose()
+ *          void          pixArenaDestroy()
+ *          void         *pixArenaAlloc()
+ *          void          pixArenaDealloc()
+ *          l_int32       pixArenaGetInfo()
+ *          l_uint32      pixArenaGetScope()
+ *          void          pixArenaSuspend()
+ *
+ *      Recycling pool with allocator and deallocator
+ *
+ *          l_int32       pixPoolCreate()
+ *          void          pixPoolDestroy()
+ *          void         *pixPoolAlloc()
+ *          void          pixPoolDealloc()
+ *          l_int32       pixPoolGetStats()
+ *
+ *      Accounting of image data
+ *
+ *          void          pixMemRecordAlloc()
+ *          void          pixMemRecordFree()
+ *          l_int32       pixMemGetStats()
+ *          l_int32       pixMemResetStats()
+ *
+ *      Static helpers
+ *          static size_t  pixPoolRoundSize()
+ *          static void    pixMemUpdatePeak()
  * </pre>
  */
 
+#include <string.h>
 #include "allheaders.h"
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif  /* _MSC_VER */
+
+    /* Thread-local storage for the arena, pool and counters */
+#if defined(_MSC_VER)
+#define  L_THREAD_LOCAL  __declspec(thread)
+#elif defined(__GNUC__) || defined(__clang__)
+#define  L_THREAD_LOCAL  __thread
+#else
+#define  L_THREAD_LOCAL  /* no thread-local storage: only one thread */
+#endif
+
+    /* Atomic add, returning the new value, for the global counters */
+#if defined(_MSC_VER)
+#define  L_ATOMIC_ADD(p, v)  (_InterlockedExchangeAdd64((p), (v)) + (v))
+#elif defined(__GNUC__) || defined(__clang__)
+#define  L_ATOMIC_ADD(p, v)  __atomic_add_fetch((p), (v), __ATOMIC_RELAXED)
+#else
+#define  L_ATOMIC_ADD(p, v)  (*(p) += (v))
+#endif
+
+static size_t pixPoolRoundSize(size_t nbytes, l_int32 *pindex);
+static void pixMemUpdatePeak(l_int64 *ppeak, l_int64 current);
 
 /*-------------------------------------------------------------------------*
  *                          Pix Memory Storage                             *
@@ -530,3 +585,882 @@ L_PIX_MEM_STORE  *pms;
 
     return;
 }
+
+
+/*-------------------------------------------------------------------------*
+ *                        Pix Scratch Arena                                *
+ *                                                                         *
+ *  This is a simple utility for the pix made and destroyed within a       *
+ *  composite operation.  It is enabled by setting the PixMemoryManager    *
+ *  allocators to the functions that are defined here                      *
+ *        pixArenaAlloc()                                                  *
+ *        pixArenaDealloc()                                                *
+ *  Use pixArenaOpen() and pixArenaClose() around the operation, and       *
+ *  pixArenaDestroy() at the end to clean it up.                           *
+ *-------------------------------------------------------------------------*/
+/*
+ *  Between pixArenaOpen() and pixArenaClose(), the image data of every
+ *  pix that is made in the thread is taken from the top of a single
+ *  block of memory (the arena), simply by advancing an offset.
+ *  Destroying such a pix does nothing.  When the scope is closed,
+ *  the offset is reset to where it was when the scope was opened, so
+ *  the data of all the pix made in the scope is released at once.
+ *  The block is kept for the next scope, so after the first use there
+ *  are no page faults from the temporary pix.
+ *
+ *  Outside a scope, or if the arena is full, the allocator and
+ *  deallocator use the heap, exactly as with the default memory manager.
+ *
+ *  A typical use is:
+ *        setPixMemoryManager(pixArenaAlloc, pixArenaDealloc);
+ *        ...
+ *        pixArenaOpen(0);
+ *        pix1 = pixBackgroundNorm(pixs, ...);
+ *        pix2 = pixContrastNorm(NULL, pix1, ...);
+ *        pixd = pixArenaClose(&pix2);  // keep pix2; pixd is on the heap
+ *        pixDestroy(&pix1);
+ *        ...
+ *        pixArenaDestroy();
+ *
+ *  Scopes can be nested.  Each thread has its own arena, and the pix
+ *  made in a scope must be destroyed in the same thread.  Every pix
+ *  made in a scope, except one that is kept with pixArenaClose(), is
+ *  invalid after the scope is closed and must not be used, although it
+ *  can still be destroyed safely.  The arena counts the chunks that have
+ *  not yet been freed, and it is neither replaced by pixArenaOpen() nor
+ *  freed by pixArenaDestroy() while any of them remain.  For the same
+ *  reason, do not use pixExtractData() on these pix.
+ *
+ *  Each pix is tagged with the scope in which it was made.  New data
+ *  for a pix that was made outside the innermost scope, such as from
+ *  pixResizeImageData() or pixReuseOrCreate(), is taken from the heap,
+ *  so that pix stays valid after the scope is closed.
+ */
+
+    /* Default size of the arena, and alignment of each chunk */
+static const size_t  DefaultArenaSize = 64000000;
+static const size_t  ArenaAlignment = 32;
+
+    /* Max depth of nested scopes */
+#define  MAX_ARENA_DEPTH   32
+
+/*! Pix scratch arena */
+struct PixScratchArena
+{
+    l_uint8         *block;      /*!< Allocated memory                      */
+    l_uint8         *baseptr;    /*!< Aligned start of the arena            */
+    size_t           nbytes;     /*!< Size of the arena                     */
+    size_t           used;       /*!< Bytes in use from the start           */
+    size_t           maxused;    /*!< log: max bytes ever in use            */
+    size_t           nheap;      /*!< log: bytes from the heap in a scope   */
+                                 /*!<      because the arena was full       */
+    l_int32          depth;      /*!< Number of open scopes                 */
+    l_int32          suspend;    /*!< Use the heap when > 0                 */
+    l_int32          nchunks;    /*!< Chunks in the arena not yet freed     */
+    l_uint32         nscopes;    /*!< Number of scopes ever opened          */
+    size_t           marks[MAX_ARENA_DEPTH];  /*!< Bytes in use when each  */
+                                              /*!< scope was opened        */
+    l_uint32         ids[MAX_ARENA_DEPTH];    /*!< Id of each open scope   */
+};
+typedef struct PixScratchArena   L_PIX_ARENA;
+
+static L_THREAD_LOCAL L_PIX_ARENA  ThreadArena;
+
+
+/*!
+ * \brief   pixArenaOpen()
+ *
+ * \param[in]    nbytes    size of the arena to make; use 0 for default
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This opens a scope in the arena of the calling thread.
+ *          Until the matching pixArenaClose(), the data of the pix
+ *          made in this thread come from the arena.
+ *      (2) The arena is made on the first call.  If no scope is open
+ *          and %nbytes is larger than the existing arena, it is
+ *          replaced by a larger one.  This is an error if a pix made
+ *          in an earlier scope has not been destroyed, because its
+ *          data is in the existing arena.  Otherwise %nbytes is ignored.
+ *          Use pixArenaGetInfo() to find the size that is needed.
+ *      (3) This has no effect on the pix data unless the allocators
+ *          have been set with
+ *             setPixMemoryManager(pixArenaAlloc, pixArenaDealloc);
+ * </pre>
+ */
+l_ok
+pixArenaOpen(size_t  nbytes)
+{
+L_PIX_ARENA  *pa;
+
+    PROCNAME("pixArenaOpen");
+
+    pa = &ThreadArena;
+    if (pa->depth >= MAX_ARENA_DEPTH)
+        return ERROR_INT("too many nested scopes", procName, 1);
+
+    if (nbytes == 0)
+        nbytes = (pa->block) ? pa->nbytes : DefaultArenaSize;
+    if (pa->depth == 0 && (!pa->block || nbytes > pa->nbytes)) {
+        if (pa->nchunks > 0) {
+            L_ERROR("%d pix still use the arena\n", procName, pa->nchunks);
+            return 1;
+        }
+        LEPT_FREE(pa->block);
+        pa->baseptr = NULL;
+        pa->nbytes = 0;
+        pa->used = 0;
+        if ((pa->block = (l_uint8 *)LEPT_MALLOC(nbytes + ArenaAlignment))
+            == NULL)
+            return ERROR_INT("arena not made", procName, 1);
+        pa->baseptr = pa->block + ArenaAlignment -
+                      (l_uintptr_t)pa->block % ArenaAlignment;
+        pa->nbytes = nbytes;
+    }
+
+    pa->nscopes++;
+    if (pa->nscopes == 0)  /* 0 is reserved for no scope */
+        pa->nscopes = 1;
+    pa->marks[pa->depth] = pa->used;
+    pa->ids[pa->depth] = pa->nscopes;
+    pa->depth++;
+    return 0;
+}
+
+
+/*!
+ * \brief   pixArenaClose()
+ *
+ * \param[in,out]  ppixs   [optional] pix to be kept; can be null
+ * \return  pixd   the kept pix, or NULL if none or on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This closes the innermost open scope of the calling thread,
+ *          releasing the data of all the pix made in the scope.
+ *      (2) If %ppixs is given, the pix it points to survives: if its data
+ *          is in the arena, it is copied to the heap and put back in the
+ *          same pix before the scope is closed, so that clones of the
+ *          pix also stay valid.  *ppixs is consumed (nulled), and the
+ *          pix is returned.
+ * </pre>
+ */
+PIX *
+pixArenaClose(PIX  **ppixs)
+{
+l_uint8      *data;
+PIX          *pixd, *pix1;
+L_PIX_ARENA  *pa;
+
+    PROCNAME("pixArenaClose");
+
+    pa = &ThreadArena;
+    pixd = NULL;
+    if (ppixs && (pixd = *ppixs) != NULL) {
+        data = (l_uint8 *)pixGetData(pixd);
+        if (data >= pa->baseptr && data < pa->baseptr + pa->nbytes) {
+            pixArenaSuspend(1);  /* allocate the copy from the heap */
+            pix1 = pixCopy(NULL, pixd);
+            pixArenaSuspend(0);
+            if (!pix1)
+                L_ERROR("heap copy of pixs not made\n", procName);
+            else
+                pixTransferAllData(pixd, &pix1, 0, 0);
+        }
+        pixd->arenascope = 0;
+        *ppixs = NULL;
+    }
+
+    if (pa->depth == 0) {
+        L_ERROR("no scope is open\n", procName);
+        return pixd;
+    }
+    pa->depth--;
+    pa->used = pa->marks[pa->depth];
+    return pixd;
+}
+
+
+/*!
+ * \brief   pixArenaDestroy()
+ *
+ * <pre>
+ * Notes:
+ *      (1) This frees the arena of the calling thread.  Call it after
+ *          the last scope has been closed and after the pix that were
+ *          made in the arena have been destroyed.  Otherwise it is an
+ *          error, and the arena is not freed.
+ * </pre>
+ */
+void
+pixArenaDestroy()
+{
+L_PIX_ARENA  *pa;
+
+    PROCNAME("pixArenaDestroy");
+
+    pa = &ThreadArena;
+    if (pa->depth > 0) {
+        L_ERROR("%d scopes are still open\n", procName, pa->depth);
+        return;
+    }
+    if (pa->nchunks > 0) {
+        L_ERROR("%d pix still use the arena\n", procName, pa->nchunks);
+        return;
+    }
+    LEPT_FREE(pa->block);
+    memset(pa, 0, sizeof(L_PIX_ARENA));
+    return;
+}
+
+
+/*!
+ * \brief   pixArenaAlloc()
+ *
+ * \param[in]   nbytes    number of bytes requested
+ * \return  data ptr
+ *
+ * <pre>
+ * Notes:
+ *      (1) Within a scope, this takes the chunk from the top of the
+ *          arena.  Otherwise, and if the arena is full, the chunk is
+ *          taken from the heap.
+ * </pre>
+ */
+void *
+pixArenaAlloc(size_t  nbytes)
+{
+size_t        size;
+void         *data;
+L_PIX_ARENA  *pa;
+
+    pa = &ThreadArena;
+    if (pa->depth == 0 || pa->suspend > 0)
+        return LEPT_MALLOC(nbytes);
+
+    size = (nbytes + ArenaAlignment - 1) & ~(ArenaAlignment - 1);
+    if (size > pa->nbytes - pa->used) {  /* full */
+        pa->nheap += nbytes;
+        return LEPT_MALLOC(nbytes);
+    }
+
+    data = pa->baseptr + pa->used;
+    pa->used += size;
+    pa->nchunks++;
+    if (pa->used > pa->maxused)
+        pa->maxused = pa->used;
+    return data;
+}
+
+
+/*!
+ * \brief   pixArenaDealloc()
+ *
+ * \param[in]   data    to be freed, or released with the scope
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) Chunks in the arena are released all at once when the
+ *          scope is closed, so this only frees chunks from the heap.
+ *          It counts the chunks in the arena that are freed.
+ * </pre>
+ */
+void
+pixArenaDealloc(void  *data)
+{
+L_PIX_ARENA  *pa;
+
+    pa = &ThreadArena;
+    if ((l_uint8 *)data >= pa->baseptr &&
+        (l_uint8 *)data < pa->baseptr + pa->nbytes) {
+        pa->nchunks--;
+        return;
+    }
+    LEPT_FREE(data);
+    return;
+}
+
+
+/*!
+ * \brief   pixArenaGetInfo()
+ *
+ * \param[out]   psize      [optional] size of the arena, in bytes
+ * \param[out]   pused      [optional] bytes now in use
+ * \param[out]   pmaxused   [optional] max bytes that have been in use
+ * \param[out]   pnheap     [optional] bytes taken from the heap in a
+ *                          scope because the arena was full
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) These are for the arena of the calling thread.  If %nheap
+ *          is not 0, the arena should be made larger; %maxused + %nheap
+ *          is an upper bound on the size needed.
+ * </pre>
+ */
+l_ok
+pixArenaGetInfo(size_t  *psize,
+                size_t  *pused,
+                size_t  *pmaxused,
+                size_t  *pnheap)
+{
+L_PIX_ARENA  *pa;
+
+    PROCNAME("pixArenaGetInfo");
+
+    if (psize) *psize = 0;
+    if (pused) *pused = 0;
+    if (pmaxused) *pmaxused = 0;
+    if (pnheap) *pnheap = 0;
+    if (!psize && !pused && !pmaxused && !pnheap)
+        return ERROR_INT("no output requested", procName, 1);
+
+    pa = &ThreadArena;
+    if (psize) *psize = pa->nbytes;
+    if (pused) *pused = pa->used;
+    if (pmaxused) *pmaxused = pa->maxused;
+    if (pnheap) *pnheap = pa->nheap;
+    return 0;
+}
+
+
+/*!
+ * \brief   pixArenaGetScope()
+ *
+ * \return  id of the innermost open scope of the calling thread,
+ *          or 0 if no scope is open
+ *
+ * <pre>
+ * Notes:
+ *      (1) Every scope that is opened gets a new id.  This is used to
+ *          tag each pix with the scope in which it was made.
+ * </pre>
+ */
+l_uint32
+pixArenaGetScope()
+{
+L_PIX_ARENA  *pa;
+
+    pa = &ThreadArena;
+    return (pa->depth > 0) ? pa->ids[pa->depth - 1] : 0;
+}
+
+
+/*!
+ * \brief   pixArenaSuspend()
+ *
+ * \param[in]   flag    1 to suspend use of the arena; 0 to resume it
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) While suspended, pixArenaAlloc() takes all chunks from the
+ *          heap.  Calls can be nested, and each call with %flag = 1
+ *          must be matched by a call with %flag = 0.
+ * </pre>
+ */
+void
+pixArenaSuspend(l_int32  flag)
+{
+L_PIX_ARENA  *pa;
+
+    pa = &ThreadArena;
+    if (flag)
+        pa->suspend++;
+    else if (pa->suspend > 0)
+        pa->suspend--;
+    return;
+}
+
+
+/*-------------------------------------------------------------------------*
+ *                        Pix Recycling Pool                               *
+ *                                                                         *
+ *  This is an adaptive alternative to the pix memory storage above.       *
+ *  It is enabled by setting the PixMemoryManager allocators to the        *
+ *  functions that are defined here                                        *
+ *        pixPoolAlloc()                                                   *
+ *        pixPoolDealloc()                                                 *
+ *  Use pixPoolCreate() to start keeping freed data for reuse, and         *
+ *  pixPoolDestroy() at the end to clean it up.                            *
+ *-------------------------------------------------------------------------*/
+/*
+ *  Unlike the memory store, the pool does not need to know the sizes
+ *  in advance.  Each requested size is rounded up to a size class;
+ *  there are 8 classes between successive powers of 2, so at most
+ *  1/8 of a chunk is unused.  When a pix is destroyed, its data is put
+ *  on a free list for its class, and the next request in that class
+ *  reuses the most recently freed chunk.  When the same sizes are used
+ *  over and over, as when a series of pages of the same size is
+ *  processed, nearly every chunk is reused.
+ *
+ *  The total size of the chunks that are kept on the free lists is
+ *  bounded by %maxbytes.  When a freed chunk would exceed the bound,
+ *  it is freed to the heap instead.
+ *
+ *  Each chunk is preceded by a small header that holds its size class,
+ *  so a chunk can be returned to the pool in any thread, and chunks
+ *  that were allocated before pixPoolCreate() was called are handled
+ *  properly.  However, every chunk must be allocated with pixPoolAlloc()
+ *  and freed with pixPoolDealloc(), so the allocators must be set
+ *  before any pix is made, and data extracted with pixExtractData()
+ *  must only be given back to a pix with pixSetData().
+ *
+ *  Each thread has its own pool, with its own counters.
+ */
+
+    /* Default bound on the bytes kept in the pool */
+static const size_t  DefaultPoolMaxBytes = 256000000;
+
+    /* Smallest size class; power of 2 */
+static const size_t  MinPoolSize = 256;
+
+    /* Number of size classes: 8 for each power of 2 in a size_t */
+#define  NUM_POOL_CLASSES   (8 * 8 * sizeof(size_t) + 8)
+
+/*! Header preceding each chunk; its size keeps the chunk aligned */
+union PixPoolHeader
+{
+    struct {
+        size_t                 size;   /*!< Size of chunk without header */
+        l_int32                index;  /*!< Size class of chunk          */
+    } info;
+    union PixPoolHeader       *next;   /*!< Next free chunk in the class */
+    l_uint8                    pad[32];
+};
+typedef union PixPoolHeader   L_POOL_HEADER;
+
+/*! Pix recycling pool */
+struct PixRecyclingPool
+{
+    L_POOL_HEADER  *freelist[NUM_POOL_CLASSES];  /*!< Free chunks by class */
+    size_t          maxbytes;    /*!< Max bytes kept in free lists         */
+    size_t          nbytes;      /*!< Bytes now kept in free lists         */
+    l_int32         active;      /*!< Keep freed chunks when set           */
+    l_int32         nhits;       /*!< log: allocs from a free list         */
+    l_int32         nmisses;     /*!< log: allocs from the heap            */
+};
+typedef struct PixRecyclingPool   L_PIX_POOL;
+
+static L_THREAD_LOCAL L_PIX_POOL  ThreadPool;
+
+
+/*!
+ * \brief   pixPoolCreate()
+ *
+ * \param[in]    maxbytes    max bytes kept for reuse; use 0 for default
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This starts keeping freed chunks in the pool of the calling
+ *          thread, and resets the counters.  If the pool is already
+ *          in use, this just changes %maxbytes.
+ *      (2) This has no effect on the pix data unless the allocators
+ *          have been set, before any pix is made, with
+ *             setPixMemoryManager(pixPoolAlloc, pixPoolDealloc);
+ * </pre>
+ */
+l_ok
+pixPoolCreate(size_t  maxbytes)
+{
+L_PIX_POOL  *pp;
+
+    pp = &ThreadPool;
+    pp->maxbytes = (maxbytes == 0) ? DefaultPoolMaxBytes : maxbytes;
+    if (!pp->active) {
+        pp->active = 1;
+        pp->nhits = 0;
+        pp->nmisses = 0;
+    }
+    return 0;
+}
+
+
+/*!
+ * \brief   pixPoolDestroy()
+ *
+ * <pre>
+ * Notes:
+ *      (1) This frees all the chunks kept in the pool of the calling
+ *          thread.  After this, freed chunks are returned to the heap.
+ *          The pix that are still in use can be destroyed normally.
+ * </pre>
+ */
+void
+pixPoolDestroy()
+{
+l_int32         i;
+L_POOL_HEADER  *head, *next;
+L_PIX_POOL     *pp;
+
+    pp = &ThreadPool;
+    for (i = 0; i < NUM_POOL_CLASSES; i++) {
+        for (head = pp->freelist[i]; head; head = next) {
+            next = head->next;
+            LEPT_FREE(head);
+        }
+        pp->freelist[i] = NULL;
+    }
+    pp->nbytes = 0;
+    pp->active = 0;
+    return;
+}
+
+
+/*!
+ * \brief   pixPoolAlloc()
+ *
+ * \param[in]   nbytes    number of bytes requested
+ * \return  data ptr
+ *
+ * <pre>
+ * Notes:
+ *      (1) This reuses the most recently freed chunk in the size class
+ *          of %nbytes, if there is one.  Otherwise a new chunk of the
+ *          full class size is taken from the heap.
+ * </pre>
+ */
+void *
+pixPoolAlloc(size_t  nbytes)
+{
+l_int32         index;
+size_t          size;
+L_POOL_HEADER  *head;
+L_PIX_POOL     *pp;
+
+    PROCNAME("pixPoolAlloc");
+
+    pp = &ThreadPool;
+    size = pixPoolRoundSize(nbytes, &index);
+    if ((head = pp->freelist[index]) != NULL) {
+        pp->freelist[index] = head->next;
+        pp->nbytes -= size;
+        pp->nhits++;
+    } else {
+        head = (L_POOL_HEADER *)LEPT_MALLOC(sizeof(L_POOL_HEADER) + size);
+        if (!head)
+            return ERROR_PTR("chunk not made", procName, NULL);
+        pp->nmisses++;
+    }
+    head->info.size = size;
+    head->info.index = index;
+    return (void *)(head + 1);
+}
+
+
+/*!
+ * \brief   pixPoolDealloc()
+ *
+ * \param[in]   data    to be kept for reuse, or freed
+ * \return  void
+ */
+void
+pixPoolDealloc(void  *data)
+{
+l_int32         index;
+size_t          size;
+L_POOL_HEADER  *head;
+L_PIX_POOL     *pp;
+
+    if (!data) return;
+
+    pp = &ThreadPool;
+    head = (L_POOL_HEADER *)data - 1;
+    size = head->info.size;
+    index = head->info.index;
+    if (!pp->active || pp->nbytes + size > pp->maxbytes) {
+        LEPT_FREE(head);
+        return;
+    }
+    head->next = pp->freelist[index];
+    pp->freelist[index] = head;
+    pp->nbytes += size;
+    return;
+}
+
+
+/*!
+ * \brief   pixPoolGetStats()
+ *
+ * \param[out]   pnhits     [optional] number of allocs from the pool
+ * \param[out]   pnmisses   [optional] number of allocs from the heap
+ * \param[out]   pnbytes    [optional] bytes now kept in the pool
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) These are for the pool of the calling thread, since the last
+ *          call to pixPoolCreate() on an inactive pool.
+ * </pre>
+ */
+l_ok
+pixPoolGetStats(l_int32  *pnhits,
+                l_int32  *pnmisses,
+                size_t   *pnbytes)
+{
+L_PIX_POOL  *pp;
+
+    PROCNAME("pixPoolGetStats");
+
+    if (pnhits) *pnhits = 0;
+    if (pnmisses) *pnmisses = 0;
+    if (pnbytes) *pnbytes = 0;
+    if (!pnhits && !pnmisses && !pnbytes)
+        return ERROR_INT("no output requested", procName, 1);
+
+    pp = &ThreadPool;
+    if (pnhits) *pnhits = pp->nhits;
+    if (pnmisses) *pnmisses = pp->nmisses;
+    if (pnbytes) *pnbytes = pp->nbytes;
+    return 0;
+}
+
+
+/*!
+ * \brief   pixPoolRoundSize()
+ *
+ * \param[in]    nbytes    number of bytes requested
+ * \param[out]   pindex    size class
+ * \return  size of chunks in the size class
+ *
+ * <pre>
+ * Notes:
+ *      (1) With 2^k <= %nbytes < 2^(k+1), the sizes in the classes
+ *          are multiples of 2^(k-3), so there are 8 classes between
+ *          2^k and 2^(k+1).
+ * </pre>
+ */
+static size_t
+pixPoolRoundSize(size_t    nbytes,
+                 l_int32  *pindex)
+{
+l_int32  k;
+size_t   step, m;
+
+    if (nbytes < MinPoolSize)
+        nbytes = MinPoolSize;
+    for (k = 0; (nbytes >> k) > 1; k++)
+        ;
+    step = (size_t)1 << (k - 3);
+    m = (nbytes + step - 1) / step;  /* 8 <= m <= 16 */
+    *pindex = 8 * k + (l_int32)(m - 8);
+    return m * step;
+}
+
+
+/*-------------------------------------------------------------------------*
+ *                       Accounting of Image Data                          *
+ *                                                                         *
+ *  These counters record the image data of Pix, FPix and DPix, and the    *
+ *  compressed data of PixComp, as it is allocated and freed.  They are    *
+ *  kept both for all threads together and for each thread, and are       *
+ *  read with pixMemGetStats().                                            *
+ *-------------------------------------------------------------------------*/
+/*
+ *  The counters are independent of the allocator: they are updated
+ *  where the data is allocated and freed, whether the pix memory
+ *  manager is the heap, the memory store, the arena or the pool.
+ *  Only data that is owned by a Pix, FPix, DPix or PixComp is counted.
+ *  In particular, the data of a view or of a file mapping is not
+ *  counted, and data that is removed with pixExtractData() is no
+ *  longer counted.
+ *
+ *  A typical use is to find the stage of a pipeline that is
+ *  responsible for the peak memory, or to enforce a memory budget
+ *  for a job:
+ *        pixMemResetStats(L_MEM_THREAD);
+ *        ... stage 1 ...
+ *        pixMemGetStats(L_MEM_THREAD, &stats);
+ *        if (stats.peak > budget) ...
+ *
+ *  The counters for each thread are for the data that the thread has
+ *  allocated and freed.  If data is allocated in one thread and freed
+ *  in another, %current can be negative for the thread that frees it.
+ *  The global counters are updated atomically, except on compilers
+ *  that have no atomic operations.
+ */
+
+static L_MEM_STATS                 GlobalMemStats;
+static L_THREAD_LOCAL L_MEM_STATS  ThreadMemStats;
+
+
+/*!
+ * \brief   pixMemRecordAlloc()
+ *
+ * \param[in]   type      L_MEM_PIX, L_MEM_FPIX, L_MEM_DPIX, L_MEM_PIXCOMP
+ * \param[in]   nbytes    size of the allocated data
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) This is called where the data of an image is allocated.
+ *          Each call must be matched by a call to pixMemRecordFree()
+ *          with the same type and size.
+ * </pre>
+ */
+void
+pixMemRecordAlloc(l_int32  type,
+                  size_t   nbytes)
+{
+l_int32       k;
+l_int64       current;
+L_MEM_STATS  *ts, *gs;
+
+    if (type < 0 || type >= L_MEM_NUM_TYPES || nbytes == 0)
+        return;
+
+    for (k = 0; k < L_MEM_NUM_BUCKETS - 1 &&
+                (nbytes >> 10) >= ((size_t)1 << k); k++)
+        ;
+
+    ts = &ThreadMemStats;
+    ts->current += nbytes;
+    if (ts->current > ts->peak)
+        ts->peak = ts->current;
+    ts->nalloc++;
+    ts->typebytes[type] += nbytes;
+    ts->buckets[k]++;
+
+    gs = &GlobalMemStats;
+    current = L_ATOMIC_ADD(&gs->current, (l_int64)nbytes);
+    pixMemUpdatePeak(&gs->peak, current);
+    L_ATOMIC_ADD(&gs->nalloc, 1);
+    L_ATOMIC_ADD(&gs->typebytes[type], (l_int64)nbytes);
+    L_ATOMIC_ADD(&gs->buckets[k], 1);
+    return;
+}
+
+
+/*!
+ * \brief   pixMemRecordFree()
+ *
+ * \param[in]   type      L_MEM_PIX, L_MEM_FPIX, L_MEM_DPIX, L_MEM_PIXCOMP
+ * \param[in]   nbytes    size of the data being freed
+ * \return  void
+ */
+void
+pixMemRecordFree(l_int32  type,
+                 size_t   nbytes)
+{
+L_MEM_STATS  *ts, *gs;
+
+    if (type < 0 || type >= L_MEM_NUM_TYPES || nbytes == 0)
+        return;
+
+    ts = &ThreadMemStats;
+    ts->current -= nbytes;
+    ts->nfree++;
+    ts->typebytes[type] -= nbytes;
+
+    gs = &GlobalMemStats;
+    L_ATOMIC_ADD(&gs->current, -(l_int64)nbytes);
+    L_ATOMIC_ADD(&gs->nfree, 1);
+    L_ATOMIC_ADD(&gs->typebytes[type], -(l_int64)nbytes);
+    return;
+}
+
+
+/*!
+ * \brief   pixMemGetStats()
+ *
+ * \param[in]    scope     L_MEM_GLOBAL or L_MEM_THREAD
+ * \param[out]   stats     filled in with a copy of the counters
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) With L_MEM_GLOBAL, the copy is not atomic, so if other
+ *          threads are allocating, the fields can be slightly
+ *          inconsistent with each other.
+ * </pre>
+ */
+l_ok
+pixMemGetStats(l_int32       scope,
+               L_MEM_STATS  *stats)
+{
+    PROCNAME("pixMemGetStats");
+
+    if (!stats)
+        return ERROR_INT("stats not defined", procName, 1);
+    memset(stats, 0, sizeof(L_MEM_STATS));
+    if (scope == L_MEM_GLOBAL)
+        *stats = GlobalMemStats;
+    else if (scope == L_MEM_THREAD)
+        *stats = ThreadMemStats;
+    else
+        return ERROR_INT("invalid scope", procName, 1);
+    return 0;
+}
+
+
+/*!
+ * \brief   pixMemResetStats()
+ *
+ * \param[in]    scope     L_MEM_GLOBAL or L_MEM_THREAD
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This sets the peak to the bytes now allocated, and sets the
+ *          counts of allocations and deallocations to 0.  The bytes
+ *          now allocated, in total and by type, are not changed.
+ *      (2) Resetting the global counters is not atomic.  Do it when
+ *          no other thread is allocating image data.
+ * </pre>
+ */
+l_ok
+pixMemResetStats(l_int32  scope)
+{
+L_MEM_STATS  *ms;
+
+    PROCNAME("pixMemResetStats");
+
+    if (scope == L_MEM_GLOBAL)
+        ms = &GlobalMemStats;
+    else if (scope == L_MEM_THREAD)
+        ms = &ThreadMemStats;
+    else
+        return ERROR_INT("invalid scope", procName, 1);
+
+    ms->peak = ms->current;
+    ms->nalloc = 0;
+    ms->nfree = 0;
+    memset(ms->buckets, 0, sizeof(ms->buckets));
+    return 0;
+}
+
+
+/*!
+ * \brief   pixMemUpdatePeak()
+ *
+ * \param[in]    ppeak      address of the global peak
+ * \param[in]    current    bytes now allocated
+ * \return  void
+ */
+static void
+pixMemUpdatePeak(l_int64  *ppeak,
+                 l_int64   current)
+{
+#if defined(_MSC_VER)
+l_int64  peak;
+
+    while (current > (peak = *ppeak) &&
+           _InterlockedCompareExchange64(ppeak, current, peak) != peak)
+        ;
+#elif defined(__GNUC__) || defined(__clang__)
+l_int64  peak;
+
+    peak = __atomic_load_n(ppeak, __ATOMIC_RELAXED);
+    while (current > peak &&
+           !__atomic_compare_exchange_n(ppeak, &peak, current, 1,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+#else
+    if (current > *ppeak)
+        *ppeak = current;
+#endif
+    return;
+}
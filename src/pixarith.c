@@ -1156,7 +1156,7 @@ pixMaxDynamicRange(PIX     *pixs,
                    l_int32  type)
 {
 l_uint8     dval;
-l_int32     i, j, w, h, d, wpls, wpld, max;
+l_int32     i, j, w, h, d, wpls, wpld, nswords, max;
 l_uint32   *datas, *datad;
 l_uint32    word, sval;
 l_uint32   *lines, *lined;
@@ -1181,12 +1181,13 @@ PIX        *pixd;
     datad = pixGetData(pixd);
     wpls = pixGetWpl(pixs);
     wpld = pixGetWpl(pixd);
+    nswords = (w * d + 31) / 32;  /* words with pixels in each src line */
 
         /* Get max */
     max = 0;
     for (i = 0; i < h; i++) {
         lines = datas + i * wpls;
-        for (j = 0; j < wpls; j++) {
+        for (j = 0; j < nswords; j++) {
             word = *(lines + j);
             if (d == 4) {
                 max = L_MAX(max, word >> 28);
@@ -1368,7 +1369,7 @@ PIX        *pixd;
     max = 0;
     for (i = 0; i < h; i++) {
         lines = datas + i * wpls;
-        for (j = 0; j < wpls; j++) {
+        for (j = 0; j < w; j++) {
             word = lines[j];
             max = L_MAX(max, word >> 24);
             max = L_MAX(max, (word >> 16) & 0xff);
@@ -73,6 +73,15 @@
  *           l_int32   pixacompGetOffset()
  *           l_int32   pixacompSetOffset()
  *
+ *      Pixacomp cache of decoded pix
+ *           l_int32   pixacompSetCache()
+ *           l_int32   pixacompGetCacheStats()
+ *           static L_PIX_CACHE  *pixCacheCreate()
+ *           static void          pixCacheDestroy()
+ *           static l_int32       pixCacheExtendArrays()
+ *           static PIX          *pixCacheGetPix()
+ *           static void          pixCacheRemove()
+ *
  *      Pixacomp conversion to Pixa
  *           PIXA     *pixaCreateFromPixacomp()
  *
@@ -164,6 +173,11 @@ extern const char  *ImageFileFormatExtensions[];
 
     /* Static functions */
 static l_int32 pixacompExtendArray(PIXAC *pixac);
+static L_PIX_CACHE *pixCacheCreate(l_int32 n, size_t maxbytes);
+static void pixCacheDestroy(L_PIX_CACHE **pcache);
+static l_int32 pixCacheExtendArrays(L_PIX_CACHE *cache, l_int32 n);
+static PIX *pixCacheGetPix(L_PIX_CACHE *cache, l_int32 aindex, PIXC *pixc);
+static void pixCacheRemove(L_PIX_CACHE *cache, l_int32 aindex);
 static l_int32 pixcompFastConvertToPdfData(PIXC *pixc, const char *title,
                                            l_uint8 **pdata, size_t *pnbytes);
 
@@ -222,6 +236,7 @@ PIXC     *pixc;
     }
     pixc->data = data;
     pixc->size = size;
+    pixMemRecordAlloc(L_MEM_PIXCOMP, size);
 
     return pixc;
 }
@@ -271,6 +286,8 @@ PIXC    *pixc;
     else
         pixc->data = l_binaryCopy(data, size);
     pixc->size = size;
+    if (pixc->data)
+        pixMemRecordAlloc(L_MEM_PIXCOMP, size);
     return pixc;
 }
 
@@ -368,7 +385,10 @@ PIXC  *pixc;
     if ((pixc = *ppixc) == NULL)
         return;
 
-    LEPT_FREE(pixc->data);
+    if (pixc->data) {
+        LEPT_FREE(pixc->data);
+        pixMemRecordFree(L_MEM_PIXCOMP, pixc->size);
+    }
     if (pixc->text)
         LEPT_FREE(pixc->text);
     LEPT_FREE(pixc);
@@ -416,6 +436,7 @@ PIXC     *pixcd;
     memcpy(datad, datas, size);
     pixcd->data = datad;
     pixcd->size = size;
+    pixMemRecordAlloc(L_MEM_PIXCOMP, size);
     return pixcd;
 }
 
@@ -884,6 +905,7 @@ PIXAC   *pixac;
         pixcompDestroy(&pixac->pixc[i]);
     LEPT_FREE(pixac->pixc);
     boxaDestroy(&pixac->boxa);
+    pixCacheDestroy(&pixac->cache);
     LEPT_FREE(pixac);
 
     *ppixac = NULL;
@@ -1010,6 +1032,8 @@ pixacompExtendArray(PIXAC  *pixac)
         return ERROR_INT("new ptr array not returned", procName, 1);
     pixac->nalloc = 2 * pixac->nalloc;
     boxaExtendArray(pixac->boxa);
+    if (pixac->cache && pixCacheExtendArrays(pixac->cache, pixac->nalloc))
+        return ERROR_INT("cache arrays not extended", procName, 1);
     return 0;
 }
 
@@ -1098,6 +1122,8 @@ PIXC    *pixct;
     pixct = pixacompGetPixcomp(pixac, index, L_NOCOPY);  /* use %index */
     pixcompDestroy(&pixct);
     pixac->pixc[aindex] = pixc;  /* replace; use array index */
+    if (pixac->cache)  /* the decoded pix is no longer valid */
+        pixCacheRemove(pixac->cache, aindex);
 
     return 0;
 }
@@ -1202,6 +1228,9 @@ l_int32  aindex;
  * Notes:
  *      (1) The %index includes the offset, which must be subtracted
  *          to get the actual index into the ptr array.
+ *      (2) If the pixac has a cache (see pixacompSetCache()), this
+ *          returns a clone of the cached pix, which must not be
+ *          changed in place.  Otherwise, the pix is a new one.
  * </pre>
  */
 PIX *
@@ -1220,6 +1249,8 @@ PIXC    *pixc;
         return (PIX *)ERROR_PTR("array index not valid", procName, NULL);
 
     pixc = pixacompGetPixcomp(pixac, index, L_NOCOPY);
+    if (pixac->cache)
+        return pixCacheGetPix(pixac->cache, aindex, pixc);
     return pixCreateFromPixcomp(pixc);
 }
 
@@ -1350,6 +1381,8 @@ BOX     *box;
     if (accesstype != L_COPY && accesstype != L_CLONE)
         return (BOX *)ERROR_PTR("invalid accesstype", procName, NULL);
 
+    if (boxaIsCompact(pixac->boxa))
+        return boxaGetBox(pixac->boxa, aindex, accesstype);
     box = pixac->boxa->box[aindex];
     if (box) {
         if (accesstype == L_COPY)
@@ -1455,6 +1488,286 @@ pixacompSetOffset(PIXAC   *pixac,
 }
 
 
+/*---------------------------------------------------------------------*
+ *                    Pixacomp cache of decoded pix                    *
+ *---------------------------------------------------------------------*/
+/*!
+ * \brief   pixacompSetCache()
+ *
+ * \param[in]    pixac
+ * \param[in]    maxbytes   bound on the image data of the cached pix;
+ *                          use 0 to remove the cache
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) With a cache, pixacompGetPix() keeps the pix it decodes, and
+ *          returns a clone of the kept pix when the same index is
+ *          requested again.  This avoids repeated decoding when pages
+ *          are revisited.
+ *      (2) When the total size of the image data of the kept pix would
+ *          exceed %maxbytes, the least recently used pix are released.
+ *          A pix that is larger than %maxbytes is not kept.
+ *      (3) If the pixac already has a cache, this changes the bound;
+ *          the hit and miss counts are not reset.
+ *      (4) The pix returned by pixacompGetPix() is shared with the
+ *          cache, so it must not be changed in place.  Because clones
+ *          are not thread-safe, a pixac with a cache must only be
+ *          accessed by one thread at a time.
+ *      (5) pixaCreateFromPixacomp() does not use the cache, because
+ *          the pix in the resulting pixa may be changed in place.
+ * </pre>
+ */
+l_ok
+pixacompSetCache(PIXAC   *pixac,
+                 size_t   maxbytes)
+{
+l_int32       index;
+L_PIX_CACHE  *cache;
+
+    PROCNAME("pixacompSetCache");
+
+    if (!pixac)
+        return ERROR_INT("pixac not defined", procName, 1);
+
+    if (maxbytes == 0) {
+        pixCacheDestroy(&pixac->cache);
+        return 0;
+    }
+
+    if ((cache = pixac->cache) == NULL) {
+        if ((cache = pixCacheCreate(pixac->nalloc, maxbytes)) == NULL)
+            return ERROR_INT("cache not made", procName, 1);
+        pixac->cache = cache;
+        return 0;
+    }
+
+    cache->maxbytes = maxbytes;
+    while (cache->nbytes > cache->maxbytes) {
+        index = cache->tail;
+        pixCacheRemove(cache, index);
+    }
+    return 0;
+}
+
+
+/*!
+ * \brief   pixacompGetCacheStats()
+ *
+ * \param[in]    pixac
+ * \param[out]   pnhits     [optional] number of requests found in cache
+ * \param[out]   pnmisses   [optional] number of requests decoded
+ * \param[out]   pnbytes    [optional] bytes of image data now cached
+ * \return  0 if OK, 1 on error or if the pixac has no cache
+ */
+l_ok
+pixacompGetCacheStats(PIXAC    *pixac,
+                      l_int32  *pnhits,
+                      l_int32  *pnmisses,
+                      size_t   *pnbytes)
+{
+L_PIX_CACHE  *cache;
+
+    PROCNAME("pixacompGetCacheStats");
+
+    if (pnhits) *pnhits = 0;
+    if (pnmisses) *pnmisses = 0;
+    if (pnbytes) *pnbytes = 0;
+    if (!pnhits && !pnmisses && !pnbytes)
+        return ERROR_INT("no output requested", procName, 1);
+    if (!pixac)
+        return ERROR_INT("pixac not defined", procName, 1);
+    if ((cache = pixac->cache) == NULL)
+        return ERROR_INT("pixac has no cache", procName, 1);
+
+    if (pnhits) *pnhits = cache->nhits;
+    if (pnmisses) *pnmisses = cache->nmisses;
+    if (pnbytes) *pnbytes = cache->nbytes;
+    return 0;
+}
+
+
+/*!
+ * \brief   pixCacheCreate()
+ *
+ * \param[in]    n          size of the arrays
+ * \param[in]    maxbytes   bound on the image data of the cached pix
+ * \return  cache, or NULL on error
+ */
+static L_PIX_CACHE *
+pixCacheCreate(l_int32  n,
+               size_t   maxbytes)
+{
+L_PIX_CACHE  *cache;
+
+    PROCNAME("pixCacheCreate");
+
+    cache = (L_PIX_CACHE *)LEPT_CALLOC(1, sizeof(L_PIX_CACHE));
+    cache->head = cache->tail = -1;
+    cache->maxbytes = maxbytes;
+    if (pixCacheExtendArrays(cache, n)) {
+        pixCacheDestroy(&cache);
+        return (L_PIX_CACHE *)ERROR_PTR("arrays not made", procName, NULL);
+    }
+    return cache;
+}
+
+
+/*!
+ * \brief   pixCacheDestroy()
+ *
+ * \param[in,out]   pcache   will be set to null before returning
+ * \return  void
+ */
+static void
+pixCacheDestroy(L_PIX_CACHE  **pcache)
+{
+l_int32       i;
+L_PIX_CACHE  *cache;
+
+    if (!pcache || (cache = *pcache) == NULL)
+        return;
+
+    for (i = 0; i < cache->nalloc; i++)
+        pixDestroy(&cache->pix[i]);
+    LEPT_FREE(cache->pix);
+    LEPT_FREE(cache->prev);
+    LEPT_FREE(cache->next);
+    LEPT_FREE(cache);
+    *pcache = NULL;
+}
+
+
+/*!
+ * \brief   pixCacheExtendArrays()
+ *
+ * \param[in]    cache
+ * \param[in]    n       new size of the arrays
+ * \return  0 if OK, 1 on error
+ */
+static l_int32
+pixCacheExtendArrays(L_PIX_CACHE  *cache,
+                     l_int32       n)
+{
+    PROCNAME("pixCacheExtendArrays");
+
+    if (n <= cache->nalloc)
+        return 0;
+    if ((cache->pix = (PIX **)reallocNew((void **)&cache->pix,
+                            sizeof(PIX *) * cache->nalloc,
+                            sizeof(PIX *) * n)) == NULL)
+        return ERROR_INT("new pix array not returned", procName, 1);
+    if ((cache->prev = (l_int32 *)reallocNew((void **)&cache->prev,
+                            sizeof(l_int32) * cache->nalloc,
+                            sizeof(l_int32) * n)) == NULL)
+        return ERROR_INT("new prev array not returned", procName, 1);
+    if ((cache->next = (l_int32 *)reallocNew((void **)&cache->next,
+                            sizeof(l_int32) * cache->nalloc,
+                            sizeof(l_int32) * n)) == NULL)
+        return ERROR_INT("new next array not returned", procName, 1);
+    cache->nalloc = n;
+    return 0;
+}
+
+
+/*!
+ * \brief   pixCacheGetPix()
+ *
+ * \param[in]    cache
+ * \param[in]    aindex   index into the pixcomp ptr array
+ * \param[in]    pixc     at %aindex; decoded if the pix is not cached
+ * \return  clone of the cached pix, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) The requested pix is moved to the head of the list, and the
+ *          least recently used pix are removed until the cached data
+ *          is within the bound.
+ * </pre>
+ */
+static PIX *
+pixCacheGetPix(L_PIX_CACHE  *cache,
+               l_int32       aindex,
+               PIXC         *pixc)
+{
+size_t  size;
+PIX    *pix;
+
+    PROCNAME("pixCacheGetPix");
+
+    if (aindex >= cache->nalloc)
+        return (PIX *)ERROR_PTR("index not in cache", procName, NULL);
+
+    if ((pix = cache->pix[aindex]) != NULL) {
+        cache->nhits++;
+        if (cache->head == aindex)
+            return pixClone(pix);
+        pixClone(pix);  /* hold it while it is unlinked */
+        pixCacheRemove(cache, aindex);
+    } else {
+        cache->nmisses++;
+        if ((pix = pixCreateFromPixcomp(pixc)) == NULL)
+            return (PIX *)ERROR_PTR("pix not made", procName, NULL);
+    }
+
+        /* Insert at the head, if it fits */
+    size = 4 * (size_t)pixGetWpl(pix) * pixGetHeight(pix);
+    if (size > cache->maxbytes)
+        return pix;
+    cache->pix[aindex] = pix;
+    cache->nbytes += size;
+    cache->prev[aindex] = -1;
+    cache->next[aindex] = cache->head;
+    if (cache->head >= 0)
+        cache->prev[cache->head] = aindex;
+    cache->head = aindex;
+    if (cache->tail < 0)
+        cache->tail = aindex;
+    while (cache->nbytes > cache->maxbytes)
+        pixCacheRemove(cache, cache->tail);
+    return pixClone(pix);
+}
+
+
+/*!
+ * \brief   pixCacheRemove()
+ *
+ * \param[in]    cache
+ * \param[in]    aindex   index into the pixcomp ptr array
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) This unlinks the pix at %aindex, if any, and releases the
+ *          reference held by the cache.
+ * </pre>
+ */
+static void
+pixCacheRemove(L_PIX_CACHE  *cache,
+               l_int32       aindex)
+{
+l_int32  prev, next;
+PIX     *pix;
+
+    if (aindex < 0 || aindex >= cache->nalloc ||
+        (pix = cache->pix[aindex]) == NULL)
+        return;
+
+    prev = cache->prev[aindex];
+    next = cache->next[aindex];
+    if (prev >= 0)
+        cache->next[prev] = next;
+    else
+        cache->head = next;
+    if (next >= 0)
+        cache->prev[next] = prev;
+    else
+        cache->tail = prev;
+    cache->nbytes -= 4 * (size_t)pixGetWpl(pix) * pixGetHeight(pix);
+    pixDestroy(&cache->pix[aindex]);
+}
+
+
 /*---------------------------------------------------------------------*
  *                      Pixacomp conversion to Pixa                    *
  *---------------------------------------------------------------------*/
@@ -1468,8 +1781,10 @@ pixacompSetOffset(PIXAC   *pixac,
  * <pre>
  * Notes:
  *      (1) Because the pixa has no notion of offset, the offset must
- *          be set to 0 before the conversion, so that pixacompGetPix()
+ *          be set to 0 before the conversion, so that pixacompGetPixcomp()
  *          fetches all the pixcomps.  It is reset at the end.
+ *      (2) The pix are always decoded, without using a cache, so that
+ *          they can be changed in place.
  * </pre>
  */
 PIXA *
@@ -1479,6 +1794,7 @@ pixaCreateFromPixacomp(PIXAC   *pixac,
 l_int32  i, n, offset;
 PIX     *pix;
 PIXA    *pixa;
+PIXC    *pixc;
 
     PROCNAME("pixaCreateFromPixacomp");
 
@@ -1494,7 +1810,8 @@ PIXA    *pixa;
     if ((pixa = pixaCreate(n)) == NULL)
         return (PIXA *)ERROR_PTR("pixa not made", procName, NULL);
     for (i = 0; i < n; i++) {
-        if ((pix = pixacompGetPix(pixac, i)) == NULL) {
+        pixc = pixacompGetPixcomp(pixac, i, L_NOCOPY);
+        if ((pix = pixCreateFromPixcomp(pixc)) == NULL) {
             L_WARNING("pix %d not made\n", procName, i);
             continue;
         }
@@ -1758,6 +2075,7 @@ PIXAC    *pixac;
         pixc->cmapflag = cmapflag;
         pixc->data = data;
         pixc->size = size;
+        pixMemRecordAlloc(L_MEM_PIXCOMP, size);
         pixacompAddPixcomp(pixac, pixc, L_INSERT);
     }
     return pixac;
@@ -2358,6 +2676,8 @@ pixcompWriteStreamInfo(FILE        *fp,
  *          except it works on a Pixacomp instead of a Pix.  It is particularly
  *          useful for showing the images in a Pixacomp at reduced resolution.
  *      (2) See pixaDisplayTiledAndScaled() for details.
+ *      (3) The pix are fetched with pixacompGetPix(), so that a cache
+ *          in the pixac is used.  They are not changed.
  * </pre>
  */
 PIX *
@@ -2369,16 +2689,26 @@ pixacompDisplayTiledAndScaled(PIXAC   *pixac,
                               l_int32  spacing,
                               l_int32  border)
 {
-PIX   *pixd;
-PIXA  *pixa;
+l_int32  i, n, offset;
+PIX     *pix, *pixd;
+PIXA    *pixa;
 
     PROCNAME("pixacompDisplayTiledAndScaled");
 
     if (!pixac)
         return (PIX *)ERROR_PTR("pixac not defined", procName, NULL);
 
-    if ((pixa = pixaCreateFromPixacomp(pixac, L_COPY)) == NULL)
+    n = pixacompGetCount(pixac);
+    offset = pixacompGetOffset(pixac);
+    if ((pixa = pixaCreate(n)) == NULL)
         return (PIX *)ERROR_PTR("pixa not made", procName, NULL);
+    for (i = 0; i < n; i++) {
+        if ((pix = pixacompGetPix(pixac, offset + i)) == NULL) {
+            L_WARNING("pix %d not made\n", procName, i);
+            continue;
+        }
+        pixaAddPix(pixa, pix, L_INSERT);
+    }
 
     pixd = pixaDisplayTiledAndScaled(pixa, outdepth, tilewidth, ncols,
                                      background, spacing, border);
@@ -45,6 +45,7 @@
  *      Conversion from RGB color to grayscale
  *           PIX        *pixConvertRGBToLuminance()
  *           PIX        *pixConvertRGBToGray()
+ *           PIX        *pixConvertRGBToGrayInto()
  *           PIX        *pixConvertRGBToGrayFast()
  *           PIX        *pixConvertRGBToGrayMinMax()
  *           PIX        *pixConvertRGBToGraySatBoost()
@@ -109,6 +110,7 @@
  *
  *      Top-level conversion to 8 bpp
  *           PIX        *pixConvertTo8()
+ *           PIX        *pixConvertTo8Into()
  *           PIX        *pixConvertTo8BySampling()
  *           PIX        *pixConvertTo8Colormap()
  *
@@ -759,11 +761,7 @@ pixConvertRGBToGray(PIX       *pixs,
                     l_float32  gwt,
                     l_float32  bwt)
 {
-l_int32    i, j, w, h, wpls, wpld, val;
-l_uint32   word;
-l_uint32  *datas, *lines, *datad, *lined;
 l_float32  sum;
-PIX       *pixd;
 
     PROCNAME("pixConvertRGBToGray");
 
@@ -774,6 +772,62 @@ PIX       *pixd;
     if (rwt < 0.0 || gwt < 0.0 || bwt < 0.0)
         return (PIX *)ERROR_PTR("weights not all >= 0.0", procName, NULL);
 
+        /* Normalize the weights here, so that any warning names
+         * this function */
+    sum = rwt + gwt + bwt;
+    if (sum > 0.0 && L_ABS(sum - 1.0) > 0.0001) {
+        L_WARNING("weights don't sum to 1; maintaining ratios\n", procName);
+        rwt = rwt / sum;
+        gwt = gwt / sum;
+        bwt = bwt / sum;
+    }
+
+    return pixConvertRGBToGrayInto(NULL, pixs, rwt, gwt, bwt);
+}
+
+
+/*!
+ * \brief   pixConvertRGBToGrayInto()
+ *
+ * \param[in]    pixd           [optional] pix to be reused; can be null
+ * \param[in]    pixs           32 bpp RGB
+ * \param[in]    rwt, gwt, bwt  non-negative; these should add to 1.0,
+ *                              or use 0.0 for default
+ * \return  pixd 8 bpp, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This is pixConvertRGBToGray(), written into pixd.  If pixd
+ *          is null, a new pix is made.  Otherwise pixd is resized as
+ *          required, and its image data is reused when the size of the
+ *          result does not change.  See pixReuseOrCreate().
+ *      (2) pixd cannot be the same as pixs.
+ * </pre>
+ */
+PIX *
+pixConvertRGBToGrayInto(PIX       *pixd,
+                        PIX       *pixs,
+                        l_float32  rwt,
+                        l_float32  gwt,
+                        l_float32  bwt)
+{
+l_int32    i, j, w, h, wpls, wpld, val;
+l_uint32   word;
+l_uint32  *datas, *lines, *datad, *lined;
+l_float32  sum;
+PIX       *pixt;
+
+    PROCNAME("pixConvertRGBToGrayInto");
+
+    if (!pixs)
+        return (PIX *)ERROR_PTR("pixs not defined", procName, pixd);
+    if (pixGetDepth(pixs) != 32)
+        return (PIX *)ERROR_PTR("pixs not 32 bpp", procName, pixd);
+    if (pixd == pixs)
+        return (PIX *)ERROR_PTR("pixd == pixs", procName, pixd);
+    if (rwt < 0.0 || gwt < 0.0 || bwt < 0.0)
+        return (PIX *)ERROR_PTR("weights not all >= 0.0", procName, pixd);
+
         /* Make sure the sum of weights is 1.0; otherwise, you can get
          * overflow in the gray value. */
     if (rwt == 0.0 && gwt == 0.0 && bwt == 0.0) {
@@ -792,8 +846,9 @@ PIX       *pixd;
     pixGetDimensions(pixs, &w, &h, NULL);
     datas = pixGetData(pixs);
     wpls = pixGetWpl(pixs);
-    if ((pixd = pixCreate(w, h, 8)) == NULL)
-        return (PIX *)ERROR_PTR("pixd not made", procName, NULL);
+    if ((pixt = pixReuseOrCreate(pixd, w, h, 8)) == NULL)
+        return (PIX *)ERROR_PTR("pixd not made", procName, pixd);
+    pixd = pixt;
     pixCopyResolution(pixd, pixs);
     pixCopyInputFormat(pixd, pixs);
     datad = pixGetData(pixd);
@@ -1694,7 +1749,7 @@ pixConvert16To8(PIX     *pixs,
                 l_int32  type)
 {
 l_uint16   dword;
-l_int32    w, h, wpls, wpld, i, j, val, use_lsb;
+l_int32    w, h, wpls, wpld, nswords, i, j, val, use_lsb;
 l_uint32   sword, first, second;
 l_uint32  *datas, *datad, *lines, *lined;
 PIX       *pixd;
@@ -1715,6 +1770,7 @@ PIX       *pixd;
     pixCopyInputFormat(pixd, pixs);
     pixCopyResolution(pixd, pixs);
     wpls = pixGetWpl(pixs);
+    nswords = (w + 1) / 2;  /* words with pixels in each src line */
     datas = pixGetData(pixs);
     wpld = pixGetWpl(pixd);
     datad = pixGetData(pixd);
@@ -1723,7 +1779,7 @@ PIX       *pixd;
         use_lsb = TRUE;
         for (i = 0; i < h; i++) {
             lines = datas + i * wpls;
-            for (j = 0; j < wpls; j++) {
+            for (j = 0; j < nswords; j++) {
                  val = GET_DATA_TWO_BYTES(lines, j);
                  if (val > 255) {
                      use_lsb = FALSE;
@@ -1740,19 +1796,19 @@ PIX       *pixd;
         lines = datas + i * wpls;
         lined = datad + i * wpld;
         if (type == L_LS_BYTE) {
-            for (j = 0; j < wpls; j++) {
+            for (j = 0; j < nswords; j++) {
                 sword = *(lines + j);
                 dword = ((sword >> 8) & 0xff00) | (sword & 0xff);
                 SET_DATA_TWO_BYTES(lined, j, dword);
             }
         } else if (type == L_MS_BYTE) {
-            for (j = 0; j < wpls; j++) {
+            for (j = 0; j < nswords; j++) {
                 sword = *(lines + j);
                 dword = ((sword >> 16) & 0xff00) | ((sword >> 8) & 0xff);
                 SET_DATA_TWO_BYTES(lined, j, dword);
             }
         } else {  /* type == L_CLIP_TO_FF */
-            for (j = 0; j < wpls; j++) {
+            for (j = 0; j < nswords; j++) {
                 sword = *(lines + j);
                 first = (sword >> 24) ? 255 : ((sword >> 16) & 0xff);
                 second = ((sword >> 8) & 0xff) ? 255 : (sword & 0xff);
@@ -1941,6 +1997,8 @@ PIX  *pixd;
  *      (1) If pixd is null, a new pix is made.
  *      (2) If pixd is not null, it must be of equal width and height
  *          as pixs.  It is always returned.
+ *      (3) Each src word is read once, and unpacked 2 pixels at a time
+ *          into 16 dest words.
  * </pre>
  */
 PIX *
@@ -1949,9 +2007,9 @@ pixConvert1To16(PIX      *pixd,
                 l_uint16  val0,
                 l_uint16  val1)
 {
-l_int32    w, h, i, j, dibit, ndibits, wpls, wpld;
+l_int32    w, h, i, j, k, jd, nd, nswords, wpls, wpld;
 l_uint16   val[2];
-l_uint32   index;
+l_uint32   index, sword;
 l_uint32  *tab, *datas, *datad, *lines, *lined;
 
     PROCNAME("pixConvert1To16");
@@ -1986,13 +2044,15 @@ l_uint32  *tab, *datas, *datad, *lines, *lined;
     wpls = pixGetWpl(pixs);
     datad = pixGetData(pixd);
     wpld = pixGetWpl(pixd);
-    ndibits = (w + 1) / 2;
+    nswords = (w + 31) / 32;
     for (i = 0; i < h; i++) {
         lines = datas + i * wpls;
         lined = datad + i * wpld;
-        for (j = 0; j < ndibits; j++) {
-            dibit = GET_DATA_DIBIT(lines, j);
-            lined[j] = tab[dibit];
+        for (j = 0, jd = 0; j < nswords; j++, jd += 16) {
+            sword = lines[j];
+            nd = L_MIN(16, wpld - jd);  /* 16 dest words per src word */
+            for (k = 0; k < nd; k++)
+                lined[jd + k] = tab[(sword >> (30 - 2 * k)) & 3];
         }
     }
 
@@ -2015,6 +2075,9 @@ l_uint32  *tab, *datas, *datad, *lines, *lined;
  *      (1) If pixd is null, a new pix is made.
  *      (2) If pixd is not null, it must be of equal width and height
  *          as pixs.  It is always returned.
+ *      (3) Each src word is read once.  Src words that are all 0 or
+ *          all 1, which are most of the words in a document image,
+ *          are written as a run of %val0 or %val1.
  * </pre>
  */
 PIX *
@@ -2023,7 +2086,8 @@ pixConvert1To32(PIX      *pixd,
                 l_uint32  val0,
                 l_uint32  val1)
 {
-l_int32    w, h, i, j, wpls, wpld, bit;
+l_int32    w, h, i, j, k, jd, nd, nswords, wpls, wpld;
+l_uint32   sword;
 l_uint32   val[2];
 l_uint32  *datas, *datad, *lines, *lined;
 
@@ -2053,12 +2117,23 @@ l_uint32  *datas, *datad, *lines, *lined;
     wpls = pixGetWpl(pixs);
     datad = pixGetData(pixd);
     wpld = pixGetWpl(pixd);
+    nswords = (w + 31) / 32;
     for (i = 0; i < h; i++) {
         lines = datas + i * wpls;
         lined = datad + i * wpld;
-        for (j = 0; j <w; j++) {
-            bit = GET_DATA_BIT(lines, j);
-            lined[j] = val[bit];
+        for (j = 0, jd = 0; j < nswords; j++, jd += 32) {
+            sword = lines[j];
+            nd = L_MIN(32, w - jd);  /* 32 dest pixels per src word */
+            if (sword == 0) {
+                for (k = 0; k < nd; k++)
+                    lined[jd + k] = val0;
+            } else if (sword == 0xffffffff) {
+                for (k = 0; k < nd; k++)
+                    lined[jd + k] = val1;
+            } else {
+                for (k = 0; k < nd; k++)
+                    lined[jd + k] = val[(sword >> (31 - k)) & 1];
+            }
         }
     }
 
@@ -2364,6 +2439,8 @@ PIXCMAP  *cmap;
  *      (3) A simple unpacking might use val0 = 0 and val1 = 255, or v.v.
  *      (4) To have a colormap associated with the 8 bpp pixd,
  *          use pixConvert1To8Cmap().
+ *      (5) Each src word is read once, and unpacked 4 pixels at a time
+ *          into 8 dest words.
  * </pre>
  */
 PIX *
@@ -2372,9 +2449,9 @@ pixConvert1To8(PIX     *pixd,
                l_uint8  val0,
                l_uint8  val1)
 {
-l_int32    w, h, i, j, qbit, nqbits, wpls, wpld;
+l_int32    w, h, i, j, k, jd, nd, nswords, wpls, wpld;
 l_uint8    val[2];
-l_uint32   index;
+l_uint32   index, sword;
 l_uint32  *tab, *datas, *datad, *lines, *lined;
 
     PROCNAME("pixConvert1To8");
@@ -2412,13 +2489,20 @@ l_uint32  *tab, *datas, *datad, *lines, *lined;
     wpls = pixGetWpl(pixs);
     datad = pixGetData(pixd);
     wpld = pixGetWpl(pixd);
-    nqbits = (w + 3) / 4;
+    nswords = (w + 31) / 32;
     for (i = 0; i < h; i++) {
         lines = datas + i * wpls;
         lined = datad + i * wpld;
-        for (j = 0; j < nqbits; j++) {
-            qbit = GET_DATA_QBIT(lines, j);
-            lined[j] = tab[qbit];
+        for (j = 0, jd = 0; j < nswords; j++, jd += 8) {
+            sword = lines[j];
+            nd = L_MIN(8, wpld - jd);  /* 8 dest words per src word */
+            if (sword == 0) {
+                for (k = 0; k < nd; k++)
+                    lined[jd + k] = tab[0];
+            } else {
+                for (k = 0; k < nd; k++)
+                    lined[jd + k] = tab[(sword >> (28 - 4 * k)) & 0xf];
+            }
         }
     }
 
@@ -2465,9 +2549,9 @@ pixConvert2To8(PIX     *pixs,
                l_uint8  val3,
                l_int32  cmapflag)
 {
-l_int32    w, h, i, j, nbytes, wpls, wpld, dibit, byte;
+l_int32    w, h, i, j, k, jd, nd, nswords, wpls, wpld;
 l_uint8    val[4];
-l_uint32   index;
+l_uint32   index, sword;
 l_uint32  *tab, *datas, *datad, *lines, *lined;
 PIX       *pixd;
 PIXCMAP   *cmaps, *cmapd;
@@ -2505,38 +2589,38 @@ PIXCMAP   *cmaps, *cmapd;
             pixcmapAddColor(cmapd, val3, val3, val3);
         }
         pixSetColormap(pixd, cmapd);
-        for (i = 0; i < h; i++) {
-            lines = datas + i * wpls;
-            lined = datad + i * wpld;
-            for (j = 0; j < w; j++) {
-                dibit = GET_DATA_DIBIT(lines, j);
-                SET_DATA_BYTE(lined, j, dibit);
-            }
-        }
-        return pixd;
+
+            /* The dest pixels are the colormap indices */
+        val[0] = 0;
+        val[1] = 1;
+        val[2] = 2;
+        val[3] = 3;
+    } else {
+            /* No colormap in either pixs or pixd; use the input values */
+        val[0] = val0;
+        val[1] = val1;
+        val[2] = val2;
+        val[3] = val3;
     }
 
-        /* Last case: no colormap in either pixs or pixd.
-         * Use input values and build a table to convert 1 src byte
-         * (4 src pixels) at a time */
+        /* Build a table to convert 1 src byte (4 src pixels) at a time,
+         * and unpack each src word into 4 dest words */
     tab = (l_uint32 *)LEPT_CALLOC(256, sizeof(l_uint32));
-    val[0] = val0;
-    val[1] = val1;
-    val[2] = val2;
-    val[3] = val3;
     for (index = 0; index < 256; index++) {
-        tab[index] = (val[(index >> 6) & 3] << 24) |
+        tab[index] = ((l_uint32)val[(index >> 6) & 3] << 24) |
                      (val[(index >> 4) & 3] << 16) |
                      (val[(index >> 2) & 3] << 8) | val[index & 3];
     }
 
-    nbytes = (w + 3) / 4;
+    nswords = (w + 15) / 16;
     for (i = 0; i < h; i++) {
         lines = datas + i * wpls;
         lined = datad + i * wpld;
-        for (j = 0; j < nbytes; j++) {
-            byte = GET_DATA_BYTE(lines, j);
-            lined[j] = tab[byte];
+        for (j = 0, jd = 0; j < nswords; j++, jd += 4) {
+            sword = lines[j];
+            nd = L_MIN(4, wpld - jd);
+            for (k = 0; k < nd; k++)
+                lined[jd + k] = tab[(sword >> (24 - 8 * k)) & 0xff];
         }
     }
 
@@ -2573,7 +2657,9 @@ PIX *
 pixConvert4To8(PIX     *pixs,
                l_int32  cmapflag)
 {
-l_int32    w, h, i, j, wpls, wpld, byte, qbit;
+l_int32    w, h, i, j, k, jd, nd, nswords, wpls, wpld, hi, lo;
+l_uint16   tab[256];
+l_uint32   sword;
 l_uint32  *datas, *datad, *lines, *lined;
 PIX       *pixd;
 PIXCMAP   *cmaps, *cmapd;
@@ -2608,26 +2694,34 @@ PIXCMAP   *cmaps, *cmapd;
                 pixcmapAddColor(cmapd, 17 * i, 17 * i, 17 * i);
         }
         pixSetColormap(pixd, cmapd);
-        for (i = 0; i < h; i++) {
-            lines = datas + i * wpls;
-            lined = datad + i * wpld;
-            for (j = 0; j < w; j++) {
-                qbit = GET_DATA_QBIT(lines, j);
-                SET_DATA_BYTE(lined, j, qbit);
-            }
+    }
+
+        /* Build a table to convert 1 src byte (2 src pixels) at a time.
+         * With a colormap, the dest pixels are the colormap indices.
+         * Otherwise, the qbit value is replicated into 8 bits. */
+    for (hi = 0; hi < 16; hi++) {
+        for (lo = 0; lo < 16; lo++) {
+            if (cmapflag == TRUE)
+                tab[(hi << 4) | lo] = (hi << 8) | lo;
+            else
+                tab[(hi << 4) | lo] = (17 * hi << 8) | (17 * lo);
         }
-        return pixd;
     }
 
-        /* Last case: no colormap in either pixs or pixd.
-         * Replicate the qbit value into 8 bits. */
+        /* Unpack each src word into 2 dest words */
+    pixSetPadBits(pixs, 0);
+    nswords = (w + 7) / 8;
     for (i = 0; i < h; i++) {
         lines = datas + i * wpls;
         lined = datad + i * wpld;
-        for (j = 0; j < w; j++) {
-            qbit = GET_DATA_QBIT(lines, j);
-            byte = (qbit << 4) | qbit;
-            SET_DATA_BYTE(lined, j, byte);
+        for (j = 0, jd = 0; j < nswords; j++, jd += 2) {
+            sword = lines[j];
+            nd = L_MIN(2, wpld - jd);
+            for (k = 0; k < nd; k++) {
+                lined[jd + k] =
+                    ((l_uint32)tab[(sword >> (24 - 16 * k)) & 0xff] << 16) |
+                    tab[(sword >> (16 - 16 * k)) & 0xff];
+            }
         }
     }
     return pixd;
@@ -2775,7 +2869,7 @@ PIX     *pix1, *pix2, *pix3, *pixd;
 PIX *
 pixConvert8To2(PIX  *pix)
 {
-l_int32    i, j, w, h, wpls, wpld;
+l_int32    i, j, w, h, wpls, wpld, nswords;
 l_uint32   word;
 l_uint32  *datas, *lines, *datad, *lined;
 PIX       *pixs, *pixd;
@@ -2792,13 +2886,14 @@ PIX       *pixs, *pixd;
     pixGetDimensions(pixs, &w, &h, NULL);
     datas = pixGetData(pixs);
     wpls = pixGetWpl(pixs);
+    nswords = (w + 3) / 4;  /* words with pixels in each src line */
     pixd = pixCreate(w, h, 2);
     datad = pixGetData(pixd);
     wpld = pixGetWpl(pixd);
     for (i = 0; i < h; i++) {
         lines = datas + i * wpls;
         lined = datad + i * wpld;
-        for (j = 0; j < wpls; j++) {  /* march through 4 pixels at a time */
+        for (j = 0; j < nswords; j++) {  /* march through 4 pixels at a time */
             word = lines[j] & 0xc0c0c0c0;  /* top 2 bits of each byte */
             word = (word >> 24) | ((word & 0xff0000) >> 18) |
                    ((word & 0xff00) >> 12) | ((word & 0xff) >> 6);
@@ -3149,6 +3244,148 @@ PIXCMAP  *cmap;
 }
 
 
+/*!
+ * \brief   pixConvertTo8Into()
+ *
+ * \param[in]    pixd       [optional] pix to be reused; can be null
+ * \param[in]    pixs       1, 2, 4, 8, 16 or 32 bpp
+ * \param[in]    cmapflag   TRUE if pixd is to have a colormap; FALSE otherwise
+ * \return  pixd 8 bpp, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This is pixConvertTo8(), written into pixd.  If pixd is null,
+ *          a new pix is made.  Otherwise pixd is resized as required,
+ *          and its image data is reused when the size of the result
+ *          does not change.  See pixReuseOrCreate().
+ *      (2) pixd cannot be the same as pixs.
+ *      (3) The image data of pixd is reused for all input depths.
+ *          The conversions from 2, 4 and 16 bpp, and from 8 bpp with a
+ *          colormap to gray, are done a pixel at a time through a table,
+ *          and give the same result as pixConvertTo8().
+ * </pre>
+ */
+PIX *
+pixConvertTo8Into(PIX     *pixd,
+                  PIX     *pixs,
+                  l_int32  cmapflag)
+{
+l_int32    i, j, w, h, d, wpls, wpld, ncolors, val, rval, gval, bval;
+l_uint8    tab[256];
+l_uint32  *datas, *datad, *lines, *lined;
+PIX       *pixt;
+PIXCMAP   *cmap, *cmapd;
+
+    PROCNAME("pixConvertTo8Into");
+
+    if (!pixs)
+        return (PIX *)ERROR_PTR("pixs not defined", procName, pixd);
+    if (pixd == pixs)
+        return (PIX *)ERROR_PTR("pixd == pixs", procName, pixd);
+    pixGetDimensions(pixs, &w, &h, &d);
+    if (d != 1 && d != 2 && d != 4 && d != 8 && d != 16 && d != 32)
+        return (PIX *)ERROR_PTR("depth not {1,2,4,8,16,32}", procName, pixd);
+
+    if (d == 1) {
+        if ((pixt = pixReuseOrCreate(pixd, w, h, 8)) == NULL)
+            return (PIX *)ERROR_PTR("pixd not made", procName, pixd);
+        pixd = pixt;
+        if (!cmapflag)
+            return pixConvert1To8(pixd, pixs, 255, 0);
+        pixConvert1To8(pixd, pixs, 0, 1);
+        cmap = pixcmapCreate(8);
+        pixcmapAddColor(cmap, 255, 255, 255);
+        pixcmapAddColor(cmap, 0, 0, 0);
+        pixSetColormap(pixd, cmap);
+        return pixd;
+    } else if (d == 8 && (!pixGetColormap(pixs) || cmapflag)) {
+        if ((pixd = pixCopy(pixd, pixs)) == NULL)
+            return (PIX *)ERROR_PTR("pixd not made", procName, NULL);
+        if (cmapflag && !pixGetColormap(pixd))
+            pixAddGrayColormap8(pixd);
+        return pixd;
+    } else if (d == 32) {
+        if ((pixt = pixConvertRGBToGrayInto(pixd, pixs, 0.0, 0.0, 0.0))
+            == NULL)
+            return (PIX *)ERROR_PTR("pixd not made", procName, pixd);
+        pixd = pixt;
+        if (cmapflag)
+            pixAddGrayColormap8(pixd);
+        return pixd;
+    }
+
+        /* The rest are done a pixel at a time.  For 2 and 4 bpp, and
+         * for 8 bpp with a colormap to gray, the table maps each src
+         * value to a gray value or, if cmapflag, to a colormap index. */
+    cmap = pixGetColormap(pixs);
+    ncolors = (cmap) ? pixcmapGetCount(cmap) : 0;
+    if (d != 16 && ncolors > (1 << d))
+        return (PIX *)ERROR_PTR("too many colors for pixel depth",
+                                procName, pixd);
+    memset(tab, 0, sizeof(tab));
+    if (d != 16) {
+        for (i = 0; i < (1 << d); i++) {
+            if (cmapflag) {
+                tab[i] = i;
+            } else if (cmap) {  /* same as REMOVE_CMAP_TO_GRAYSCALE */
+                if (i >= ncolors) continue;
+                pixcmapGetColor(cmap, i, &rval, &gval, &bval);
+                tab[i] = (l_uint32)(L_RED_WEIGHT * rval +
+                                    L_GREEN_WEIGHT * gval +
+                                    L_BLUE_WEIGHT * bval + 0.5);
+            } else {  /* even increments over the dynamic range */
+                tab[i] = 255 * i / ((1 << d) - 1);
+            }
+        }
+    }
+
+    if ((pixt = pixReuseOrCreate(pixd, w, h, 8)) == NULL)
+        return (PIX *)ERROR_PTR("pixd not made", procName, pixd);
+    pixd = pixt;
+    pixCopyResolution(pixd, pixs);
+    pixCopyInputFormat(pixd, pixs);
+    datas = pixGetData(pixs);
+    wpls = pixGetWpl(pixs);
+    datad = pixGetData(pixd);
+    wpld = pixGetWpl(pixd);
+    for (i = 0; i < h; i++) {
+        lines = datas + i * wpls;
+        lined = datad + i * wpld;
+        if (d == 2) {
+            for (j = 0; j < w; j++)
+                SET_DATA_BYTE(lined, j, tab[GET_DATA_DIBIT(lines, j)]);
+        } else if (d == 4) {
+            for (j = 0; j < w; j++)
+                SET_DATA_BYTE(lined, j, tab[GET_DATA_QBIT(lines, j)]);
+        } else if (d == 8) {
+            for (j = 0; j < w; j++)
+                SET_DATA_BYTE(lined, j, tab[GET_DATA_BYTE(lines, j)]);
+        } else {  /* d == 16; use the most significant byte */
+            for (j = 0; j < w; j++) {
+                val = GET_DATA_TWO_BYTES(lines, j);
+                SET_DATA_BYTE(lined, j, val >> 8);
+            }
+        }
+    }
+
+    if (cmapflag) {
+        if (cmap) {
+            cmapd = pixcmapConvertTo8(cmap);
+        } else if (d == 16) {
+            cmapd = pixcmapCreateLinear(8, 256);
+        } else {  /* the same gray values as without cmapflag */
+            cmapd = pixcmapCreate(8);
+            for (i = 0; i < (1 << d); i++) {
+                val = 255 * i / ((1 << d) - 1);
+                pixcmapAddColor(cmapd, val, val, val);
+            }
+        }
+        pixSetColormap(pixd, cmapd);
+    }
+    return pixd;
+}
+
+
 /*!
  * \brief   pixConvertTo8BySampling()
  *
@@ -3379,14 +3616,15 @@ PIX       *pix1, *pixd;
  * Notes:
  *      (1) If there is no colormap, replicates the gray value
  *          into the 3 MSB of the dest pixel.
+ *      (2) Each src word is read once and unpacked into 4 dest words.
  * </pre>
  */
 PIX *
 pixConvert8To32(PIX  *pixs)
 {
-l_int32    i, j, w, h, wpls, wpld, val;
+l_int32    i, j, jd, nswords, w, h, wpls, wpld;
+l_uint32   sword;
 l_uint32  *datas, *datad, *lines, *lined;
-l_uint32  *tab;
 PIX       *pixd;
 
     PROCNAME("pixConvert8To32");
@@ -3409,22 +3647,21 @@ PIX       *pixd;
     datad = pixGetData(pixd);
     wpld = pixGetWpl(pixd);
 
-        /* Replication table gray --> rgb */
-    tab = (l_uint32 *)LEPT_CALLOC(256, sizeof(l_uint32));
-    for (i = 0; i < 256; i++)
-      tab[i] = (i << 24) | (i << 16) | (i << 8);
-
         /* Replicate 1 --> 4 bytes (alpha byte not set) */
+    nswords = w / 4;  /* full src words */
     for (i = 0; i < h; i++) {
         lines = datas + i * wpls;
         lined = datad + i * wpld;
-        for (j = 0; j < w; j++) {
-            val = GET_DATA_BYTE(lines, j);
-            lined[j] = tab[val];
+        for (j = 0, jd = 0; j < nswords; j++, jd += 4) {
+            sword = lines[j];
+            lined[jd] = (sword >> 24) * 0x01010100U;
+            lined[jd + 1] = ((sword >> 16) & 0xff) * 0x01010100U;
+            lined[jd + 2] = ((sword >> 8) & 0xff) * 0x01010100U;
+            lined[jd + 3] = (sword & 0xff) * 0x01010100U;
         }
+        for (jd = 4 * nswords; jd < w; jd++)
+            lined[jd] = (l_uint32)GET_DATA_BYTE(lines, jd) * 0x01010100U;
     }
-
-    LEPT_FREE(tab);
     return pixd;
 }
 
@@ -3649,19 +3886,19 @@ PIX       *pixd;
         lines = datas + i * wpls;
         lined = datad + i * wpld;
         if (type == L_LS_TWO_BYTES) {
-            for (j = 0; j < wpls; j++) {
+            for (j = 0; j < w; j++) {
                 sword = *(lines + j);
                 dword = sword & 0xffff;
                 SET_DATA_TWO_BYTES(lined, j, dword);
             }
         } else if (type == L_MS_TWO_BYTES) {
-            for (j = 0; j < wpls; j++) {
+            for (j = 0; j < w; j++) {
                 sword = *(lines + j);
                 dword = sword >> 16;
                 SET_DATA_TWO_BYTES(lined, j, dword);
             }
         } else {  /* type == L_CLIP_TO_FFFF */
-            for (j = 0; j < wpls; j++) {
+            for (j = 0; j < w; j++) {
                 sword = *(lines + j);
                 dword = (sword >> 16) ? 0xffff : (sword & 0xffff);
                 SET_DATA_TWO_BYTES(lined, j, dword);
@@ -113,10 +113,7 @@ pixConnCompTransform(PIX     *pixs,
                      l_int32  connect,
                      l_int32  depth)
 {
-l_int32  i, n, index, w, h, xb, yb, wb, hb;
-BOXA    *boxa;
-PIX     *pix1, *pix2, *pixd;
-PIXA    *pixa;
+PIX  *pixd;
 
     PROCNAME("pixConnCompTransform");
 
@@ -127,45 +124,9 @@ PIXA    *pixa;
     if (depth != 0 && depth != 8 && depth != 16 && depth != 32)
         return (PIX *)ERROR_PTR("depth must be 0, 8, 16 or 32", procName, NULL);
 
-    boxa = pixConnComp(pixs, &pixa, connect);
-    n = pixaGetCount(pixa);
-    boxaDestroy(&boxa);
-    pixGetDimensions(pixs, &w, &h, NULL);
-    if (depth == 0) {
-        if (n < 254)
-            depth = 8;
-        else if (n < 0xfffe)
-            depth = 16;
-        else
-            depth = 32;
-    }
-    pixd = pixCreate(w, h, depth);
-    pixSetSpp(pixd, 1);
-    if (n == 0) {  /* no fg */
-        pixaDestroy(&pixa);
-        return pixd;
-    }
-
-       /* Label each component and blit it in */
-    for (i = 0; i < n; i++) {
-        pixaGetBoxGeometry(pixa, i, &xb, &yb, &wb, &hb);
-        pix1 = pixaGetPix(pixa, i, L_CLONE);
-        if (depth == 8) {
-            index = 1 + (i % 254);
-            pix2 = pixConvert1To8(NULL, pix1, 0, index);
-        } else if (depth == 16) {
-            index = 1 + (i % 0xfffe);
-            pix2 = pixConvert1To16(NULL, pix1, 0, index);
-        } else {  /* depth == 32 */
-            index = 1 + i;
-            pix2 = pixConvert1To32(NULL, pix1, 0, index);
-        }
-        pixRasterop(pixd, xb, yb, wb, hb, PIX_PAINT, pix2, 0, 0);
-        pixDestroy(&pix1);
-        pixDestroy(&pix2);
-    }
-
-    pixaDestroy(&pixa);
+        /* Label each component directly from its runs */
+    if (pixConnCompLabel(pixs, connect, depth, &pixd, NULL, NULL, NULL))
+        return (PIX *)ERROR_PTR("pixd not made", procName, NULL);
     return pixd;
 }
 
@@ -192,11 +153,11 @@ PIX *
 pixConnCompAreaTransform(PIX     *pixs,
                          l_int32  connect)
 {
-l_int32   i, n, npix, w, h, xb, yb, wb, hb;
-l_int32  *tab8;
-BOXA     *boxa;
-PIX      *pix1, *pix2, *pixd;
-PIXA     *pixa;
+l_int32    i, j, w, h, n, wpl, val;
+l_int32   *area;
+l_uint32  *data, *line;
+NUMA      *naa;
+PIX       *pixd;
 
     PROCNAME("pixConnCompAreaTransform");
 
@@ -205,31 +166,33 @@ PIXA     *pixa;
     if (connect != 4 && connect != 8)
         return (PIX *)ERROR_PTR("connectivity must be 4 or 8", procName, NULL);
 
-    boxa = pixConnComp(pixs, &pixa, connect);
-    n = pixaGetCount(pixa);
-    boxaDestroy(&boxa);
-    pixGetDimensions(pixs, &w, &h, NULL);
-    pixd = pixCreate(w, h, 32);
-    pixSetSpp(pixd, 1);
+        /* Label the components, and then replace each label by the
+         * area of its component */
+    if (pixConnCompLabel(pixs, connect, 32, &pixd, NULL, &naa, NULL))
+        return (PIX *)ERROR_PTR("pixd not made", procName, NULL);
+    n = numaGetCount(naa);
     if (n == 0) {  /* no fg */
-        pixaDestroy(&pixa);
+        numaDestroy(&naa);
         return pixd;
     }
-
-       /* Label each component and blit it in */
-    tab8 = makePixelSumTab8();
-    for (i = 0; i < n; i++) {
-        pixaGetBoxGeometry(pixa, i, &xb, &yb, &wb, &hb);
-        pix1 = pixaGetPix(pixa, i, L_CLONE);
-        pixCountPixels(pix1, &npix, tab8);
-        pix2 = pixConvert1To32(NULL, pix1, 0, npix);
-        pixRasterop(pixd, xb, yb, wb, hb, PIX_PAINT, pix2, 0, 0);
-        pixDestroy(&pix1);
-        pixDestroy(&pix2);
+    area = numaGetIArray(naa);
+    numaDestroy(&naa);
+    if (!area) {
+        pixDestroy(&pixd);
+        return (PIX *)ERROR_PTR("area array not made", procName, NULL);
+    }
+    pixGetDimensions(pixd, &w, &h, NULL);
+    data = pixGetData(pixd);
+    wpl = pixGetWpl(pixd);
+    for (i = 0; i < h; i++) {
+        line = data + i * wpl;
+        for (j = 0; j < w; j++) {
+            if ((val = line[j]) > 0 && val <= n)
+                line[j] = area[val - 1];
+        }
     }
 
-    pixaDestroy(&pixa);
-    LEPT_FREE(tab8);
+    LEPT_FREE(area);
     return pixd;
 }
 
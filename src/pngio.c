@@ -50,6 +50,14 @@
  *    Set flag for special read mode
  *          void        l_pngSetReadStrip16To8()
  *
+ *    Strip-streaming png
+ *          l_int32     stripReadOpenPng()
+ *          l_int32     stripReadRowsPng()
+ *          void        stripReadClosePng()
+ *          l_int32     stripWriteOpenPng()
+ *          l_int32     stripWriteRowsPng()
+ *          l_int32     stripWriteClosePng()
+ *
  *    Low-level memio utility (thanks to T. D. Hintz)
  *          static void memio_png_write_data()
  *          static void memio_png_flush()
@@ -1291,6 +1299,378 @@ l_pngSetReadStrip16To8(l_int32  flag)
 }
 
 
+/*---------------------------------------------------------------------*
+ *                       Strip-streaming png I/O                       *
+ *---------------------------------------------------------------------*/
+    /*! Decoder or encoder state for strip-streaming png */
+struct PngStripState
+{
+    png_structp  png_ptr;     /*!< libpng read or write struct            */
+    png_infop    info_ptr;    /*!< libpng info struct                     */
+    png_bytep    rowbuffer;   /*!< one row of png samples                 */
+};
+typedef struct PngStripState  PNG_STRIP_STATE;
+
+/*!
+ * \brief   stripReadOpenPng()
+ *
+ * \param[in]    sr     strip reader, with open stream
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This reads the png header and sets up libpng to deliver
+ *          rows that map to a 1, 8 or 32 bpp pix:
+ *            ~ 1 bps gray --> 1 bpp
+ *            ~ 2, 4, 8 and 16 bps gray, with or without alpha --> 8 bpp
+ *            ~ rgb and palette color --> 32 bpp, with spp = 4 if
+ *              there is transparency
+ *      (2) Interlaced png cannot be decoded in row order, and is
+ *          not supported.
+ *      (3) On error, the caller must call stripReadClosePng().
+ * </pre>
+ */
+l_ok
+stripReadOpenPng(L_STRIP_READER  *sr)
+{
+png_byte          bit_depth, color_type, channels;
+png_uint_32       xres, yres;
+PNG_STRIP_STATE  *ps;
+
+    PROCNAME("stripReadOpenPng");
+
+    if (!sr || !sr->fp)
+        return ERROR_INT("sr or stream not defined", procName, 1);
+
+    if ((ps = (PNG_STRIP_STATE *)LEPT_CALLOC(1, sizeof(PNG_STRIP_STATE)))
+        == NULL)
+        return ERROR_INT("ps not made", procName, 1);
+    sr->codec = ps;
+    if ((ps->png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING,
+                       (png_voidp)NULL, NULL, NULL)) == NULL)
+        return ERROR_INT("png_ptr not made", procName, 1);
+    if ((ps->info_ptr = png_create_info_struct(ps->png_ptr)) == NULL)
+        return ERROR_INT("info_ptr not made", procName, 1);
+
+        /* Set up png setjmp error handling */
+    if (setjmp(png_jmpbuf(ps->png_ptr)))
+        return ERROR_INT("internal png error", procName, 1);
+
+    rewind(sr->fp);
+    png_init_io(ps->png_ptr, sr->fp);
+    png_read_info(ps->png_ptr, ps->info_ptr);
+    if (png_get_interlace_type(ps->png_ptr, ps->info_ptr) !=
+        PNG_INTERLACE_NONE)
+        return ERROR_INT("interlaced png not supported", procName, 1);
+
+        /* Set the transforms */
+    bit_depth = png_get_bit_depth(ps->png_ptr, ps->info_ptr);
+    color_type = png_get_color_type(ps->png_ptr, ps->info_ptr);
+    if (bit_depth == 16)
+        png_set_strip_16(ps->png_ptr);
+    if (color_type == PNG_COLOR_TYPE_PALETTE) {
+        png_set_palette_to_rgb(ps->png_ptr);
+        if (png_get_valid(ps->png_ptr, ps->info_ptr, PNG_INFO_tRNS))
+            png_set_tRNS_to_alpha(ps->png_ptr);
+    } else if (color_type == PNG_COLOR_TYPE_RGB) {
+        if (png_get_valid(ps->png_ptr, ps->info_ptr, PNG_INFO_tRNS))
+            png_set_tRNS_to_alpha(ps->png_ptr);
+    } else if (color_type == PNG_COLOR_TYPE_GRAY_ALPHA) {
+        png_set_strip_alpha(ps->png_ptr);
+    }
+    if ((color_type & PNG_COLOR_MASK_COLOR) == 0 &&
+        (bit_depth == 2 || bit_depth == 4))
+        png_set_expand_gray_1_2_4_to_8(ps->png_ptr);
+    png_read_update_info(ps->png_ptr, ps->info_ptr);
+
+    sr->w = png_get_image_width(ps->png_ptr, ps->info_ptr);
+    sr->h = png_get_image_height(ps->png_ptr, ps->info_ptr);
+    bit_depth = png_get_bit_depth(ps->png_ptr, ps->info_ptr);
+    channels = png_get_channels(ps->png_ptr, ps->info_ptr);
+    if (channels == 1) {
+        sr->d = (bit_depth == 1) ? 1 : 8;
+        sr->spp = 1;
+    } else if (channels == 3 || channels == 4) {
+        sr->d = 32;
+        sr->spp = channels;
+    } else {
+        return ERROR_INT("invalid number of channels", procName, 1);
+    }
+    xres = png_get_x_pixels_per_meter(ps->png_ptr, ps->info_ptr);
+    yres = png_get_y_pixels_per_meter(ps->png_ptr, ps->info_ptr);
+    sr->xres = (l_int32)((l_float32)xres / 39.37 + 0.5);  /* to ppi */
+    sr->yres = (l_int32)((l_float32)yres / 39.37 + 0.5);
+
+    ps->rowbuffer = (png_bytep)LEPT_CALLOC(
+                         png_get_rowbytes(ps->png_ptr, ps->info_ptr), 1);
+    if (!ps->rowbuffer)
+        return ERROR_INT("rowbuffer not made", procName, 1);
+    return 0;
+}
+
+
+/*!
+ * \brief   stripReadRowsPng()
+ *
+ * \param[in]    sr       strip reader, opened with stripReadOpenPng()
+ * \param[in]    pix      width and depth given by %sr
+ * \param[in]    nrows    number of rows to decode into the top of %pix
+ * \return  0 if OK, 1 on error
+ */
+l_ok
+stripReadRowsPng(L_STRIP_READER  *sr,
+                 PIX             *pix,
+                 l_int32          nrows)
+{
+l_int32           i, j, k, w, wpl, nbytes;
+l_uint32         *data, *line, *ppixel;
+png_bytep         rowbuf;
+PNG_STRIP_STATE  *ps;
+
+    PROCNAME("stripReadRowsPng");
+
+    if (!sr || (ps = (PNG_STRIP_STATE *)sr->codec) == NULL)
+        return ERROR_INT("sr or decoder not defined", procName, 1);
+    if (!pix || pixGetHeight(pix) < nrows)
+        return ERROR_INT("pix not defined or too small", procName, 1);
+
+        /* Set up png setjmp error handling */
+    if (setjmp(png_jmpbuf(ps->png_ptr)))
+        return ERROR_INT("internal png error", procName, 1);
+
+    w = sr->w;
+    nbytes = (w + 7) / 8;
+    rowbuf = ps->rowbuffer;
+    data = pixGetData(pix);
+    wpl = pixGetWpl(pix);
+    for (i = 0; i < nrows; i++) {
+        png_read_row(ps->png_ptr, rowbuf, NULL);
+        line = data + i * wpl;
+        if (sr->d == 1) {  /* png has black as 0 */
+            for (j = 0; j < nbytes; j++)
+                SET_DATA_BYTE(line, j, 255 - rowbuf[j]);
+        } else if (sr->d == 8) {
+            for (j = 0; j < w; j++)
+                SET_DATA_BYTE(line, j, rowbuf[j]);
+        } else {  /* d == 32 */
+            ppixel = line;
+            for (j = k = 0; j < w; j++) {
+                SET_DATA_BYTE(ppixel, COLOR_RED, rowbuf[k++]);
+                SET_DATA_BYTE(ppixel, COLOR_GREEN, rowbuf[k++]);
+                SET_DATA_BYTE(ppixel, COLOR_BLUE, rowbuf[k++]);
+                if (sr->spp == 4)
+                    SET_DATA_BYTE(ppixel, L_ALPHA_CHANNEL, rowbuf[k++]);
+                ppixel++;
+            }
+        }
+    }
+    if (sr->d == 1)
+        pixSetPadBits(pix, 0);
+    return 0;
+}
+
+
+/*!
+ * \brief   stripReadClosePng()
+ *
+ * \param[in]    sr     strip reader
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) This destroys the decoder state.  It is safe to call
+ *          after a failure in stripReadOpenPng().
+ * </pre>
+ */
+void
+stripReadClosePng(L_STRIP_READER  *sr)
+{
+PNG_STRIP_STATE  *ps;
+
+    if (!sr || (ps = (PNG_STRIP_STATE *)sr->codec) == NULL)
+        return;
+    if (ps->png_ptr)
+        png_destroy_read_struct(&ps->png_ptr, &ps->info_ptr, NULL);
+    LEPT_FREE(ps->rowbuffer);
+    LEPT_FREE(ps);
+    sr->codec = NULL;
+}
+
+
+/*!
+ * \brief   stripWriteOpenPng()
+ *
+ * \param[in]    sw     strip writer, with open stream and image parameters
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This writes the png header.  The depth must be 1, 8 or 32;
+ *          for 32 bpp, the alpha channel is written if spp == 4.
+ *      (2) On error, the caller must call stripWriteClosePng().
+ * </pre>
+ */
+l_ok
+stripWriteOpenPng(L_STRIP_WRITER  *sw)
+{
+png_byte          bit_depth, color_type;
+png_uint_32       xres, yres;
+PNG_STRIP_STATE  *ps;
+
+    PROCNAME("stripWriteOpenPng");
+
+    if (!sw || !sw->fp)
+        return ERROR_INT("sw or stream not defined", procName, 1);
+    if (sw->d == 32 && sw->spp == 4) {
+        bit_depth = 8;
+        color_type = PNG_COLOR_TYPE_RGBA;
+    } else if (sw->d == 32) {
+        bit_depth = 8;
+        color_type = PNG_COLOR_TYPE_RGB;
+    } else if (sw->d == 1 || sw->d == 8) {
+        bit_depth = sw->d;
+        color_type = PNG_COLOR_TYPE_GRAY;
+    } else {
+        return ERROR_INT("depth not in {1,8,32}", procName, 1);
+    }
+
+    if ((ps = (PNG_STRIP_STATE *)LEPT_CALLOC(1, sizeof(PNG_STRIP_STATE)))
+        == NULL)
+        return ERROR_INT("ps not made", procName, 1);
+    sw->codec = ps;
+    if ((ps->png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING,
+                       (png_voidp)NULL, NULL, NULL)) == NULL)
+        return ERROR_INT("png_ptr not made", procName, 1);
+    if ((ps->info_ptr = png_create_info_struct(ps->png_ptr)) == NULL)
+        return ERROR_INT("info_ptr not made", procName, 1);
+    if ((ps->rowbuffer = (png_bytep)LEPT_CALLOC(sw->w, 4)) == NULL)
+        return ERROR_INT("rowbuffer not made", procName, 1);
+
+        /* Set up png setjmp error handling */
+    if (setjmp(png_jmpbuf(ps->png_ptr)))
+        return ERROR_INT("internal png error", procName, 1);
+
+    png_init_io(ps->png_ptr, sw->fp);
+    png_set_compression_level(ps->png_ptr, Z_DEFAULT_COMPRESSION);
+    png_set_IHDR(ps->png_ptr, ps->info_ptr, sw->w, sw->h, bit_depth,
+                 color_type, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_BASE,
+                 PNG_FILTER_TYPE_BASE);
+    xres = (png_uint_32)(39.37 * (l_float32)sw->xres + 0.5);
+    yres = (png_uint_32)(39.37 * (l_float32)sw->yres + 0.5);
+    if ((xres == 0) || (yres == 0))
+        png_set_pHYs(ps->png_ptr, ps->info_ptr, 0, 0,
+                     PNG_RESOLUTION_UNKNOWN);
+    else
+        png_set_pHYs(ps->png_ptr, ps->info_ptr, xres, yres,
+                     PNG_RESOLUTION_METER);
+    png_write_info(ps->png_ptr, ps->info_ptr);
+    return 0;
+}
+
+
+/*!
+ * \brief   stripWriteRowsPng()
+ *
+ * \param[in]    sw     strip writer, opened with stripWriteOpenPng()
+ * \param[in]    pix    strip; all rows are encoded
+ * \return  0 if OK, 1 on error
+ */
+l_ok
+stripWriteRowsPng(L_STRIP_WRITER  *sw,
+                  PIX             *pix)
+{
+l_int32           i, j, k, w, h, wpl, nbytes;
+l_uint32         *data, *line, *ppixel;
+png_bytep         rowbuf;
+PNG_STRIP_STATE  *ps;
+
+    PROCNAME("stripWriteRowsPng");
+
+    if (!sw || (ps = (PNG_STRIP_STATE *)sw->codec) == NULL)
+        return ERROR_INT("sw or encoder not defined", procName, 1);
+    if (!pix)
+        return ERROR_INT("pix not defined", procName, 1);
+
+        /* Set up png setjmp error handling */
+    if (setjmp(png_jmpbuf(ps->png_ptr)))
+        return ERROR_INT("internal png error", procName, 1);
+
+    w = sw->w;
+    h = pixGetHeight(pix);
+    nbytes = (w + 7) / 8;
+    rowbuf = ps->rowbuffer;
+    data = pixGetData(pix);
+    wpl = pixGetWpl(pix);
+    for (i = 0; i < h; i++) {
+        line = data + i * wpl;
+        if (sw->d == 1) {  /* png has black as 0 */
+            for (j = 0; j < nbytes; j++)
+                rowbuf[j] = 255 - GET_DATA_BYTE(line, j);
+        } else if (sw->d == 8) {
+            for (j = 0; j < w; j++)
+                rowbuf[j] = GET_DATA_BYTE(line, j);
+        } else {  /* d == 32 */
+            ppixel = line;
+            for (j = k = 0; j < w; j++) {
+                rowbuf[k++] = GET_DATA_BYTE(ppixel, COLOR_RED);
+                rowbuf[k++] = GET_DATA_BYTE(ppixel, COLOR_GREEN);
+                rowbuf[k++] = GET_DATA_BYTE(ppixel, COLOR_BLUE);
+                if (sw->spp == 4)
+                    rowbuf[k++] = GET_DATA_BYTE(ppixel, L_ALPHA_CHANNEL);
+                ppixel++;
+            }
+        }
+        png_write_row(ps->png_ptr, rowbuf);
+    }
+    return 0;
+}
+
+
+/*!
+ * \brief   stripWriteClosePng()
+ *
+ * \param[in]    sw       strip writer
+ * \param[in]    finish   1 to complete the png; 0 to abandon it
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This destroys the encoder state.  It is safe to call
+ *          after a failure in stripWriteOpenPng(), with %finish = 0.
+ * </pre>
+ */
+l_ok
+stripWriteClosePng(L_STRIP_WRITER  *sw,
+                   l_int32          finish)
+{
+l_int32           ret;
+PNG_STRIP_STATE  *ps;
+
+    PROCNAME("stripWriteClosePng");
+
+    if (!sw)
+        return ERROR_INT("sw not defined", procName, 1);
+    if ((ps = (PNG_STRIP_STATE *)sw->codec) == NULL)
+        return 0;
+
+    ret = 0;
+    if (finish && ps->png_ptr) {
+        if (setjmp(png_jmpbuf(ps->png_ptr))) {
+            L_ERROR("internal png error\n", procName);
+            ret = 1;
+        } else {
+            png_write_end(ps->png_ptr, ps->info_ptr);
+        }
+    }
+    if (ps->png_ptr)
+        png_destroy_write_struct(&ps->png_ptr, &ps->info_ptr);
+    LEPT_FREE(ps->rowbuffer);
+    LEPT_FREE(ps);
+    sw->codec = NULL;
+    return ret;
+}
+
+
 /*-------------------------------------------------------------------------*
  *                               Memio utility                             *
  *    libpng read/write callback replacements for performing memory I/O    *
@@ -138,6 +138,49 @@ l_ok pixWriteMemPng(l_uint8 **pfiledata, size_t *pfilesize, PIX *pix,
     return ERROR_INT("function not present", "pixWriteMemPng", 1);
 }
 
+/* ----------------------------------------------------------------------*/
+
+l_ok stripReadOpenPng(L_STRIP_READER *sr)
+{
+    return ERROR_INT("function not present", "stripReadOpenPng", 1);
+}
+
+/* ----------------------------------------------------------------------*/
+
+l_ok stripReadRowsPng(L_STRIP_READER *sr, PIX *pix, l_int32 nrows)
+{
+    return ERROR_INT("function not present", "stripReadRowsPng", 1);
+}
+
+/* ----------------------------------------------------------------------*/
+
+void stripReadClosePng(L_STRIP_READER *sr)
+{
+    L_ERROR("function not present\n", "stripReadClosePng");
+    return;
+}
+
+/* ----------------------------------------------------------------------*/
+
+l_ok stripWriteOpenPng(L_STRIP_WRITER *sw)
+{
+    return ERROR_INT("function not present", "stripWriteOpenPng", 1);
+}
+
+/* ----------------------------------------------------------------------*/
+
+l_ok stripWriteRowsPng(L_STRIP_WRITER *sw, PIX *pix)
+{
+    return ERROR_INT("function not present", "stripWriteRowsPng", 1);
+}
+
+/* ----------------------------------------------------------------------*/
+
+l_ok stripWriteClosePng(L_STRIP_WRITER *sw, l_int32 finish)
+{
+    return ERROR_INT("function not present", "stripWriteClosePng", 1);
+}
+
 /* --------------------------------------------*/
 #endif  /* !HAVE_LIBPNG */
 /* --------------------------------------------*/
@@ -761,7 +761,7 @@ PIX       *pixs;
         } else {  /* 32 bpp rgb */
             for (i = 0; i < h; i++) {
                 lines = datas + i * wpls;
-                for (j = 0; j < wpls; j++) {
+                for (j = 0; j < w; j++) {
                     pword = lines + j;
                     pel[0] = GET_DATA_BYTE(pword, COLOR_RED);
                     pel[1] = GET_DATA_BYTE(pword, COLOR_GREEN);
@@ -1039,7 +1039,7 @@ PIX       *pixs;
         case 3:
             for (i = 0; i < h; i++) {
                 lines = datas + i * wpls;
-                for (j = 0; j < wpls; j++) {
+                for (j = 0; j < w; j++) {
                     pword = lines + j;
                     pel[0] = GET_DATA_BYTE(pword, COLOR_RED);
                     pel[1] = GET_DATA_BYTE(pword, COLOR_GREEN);
@@ -1052,7 +1052,7 @@ PIX       *pixs;
         case 4:
             for (i = 0; i < h; i++) {
                 lines = datas + i * wpls;
-                for (j = 0; j < wpls; j++) {
+                for (j = 0; j < w; j++) {
                     pword = lines + j;
                     pel[0] = GET_DATA_BYTE(pword, COLOR_RED);
                     pel[1] = GET_DATA_BYTE(pword, COLOR_GREEN);
@@ -32,6 +32,9 @@
  *          l_int32   pixQuadtreeMean()
  *          l_int32   pixQuadtreeVariance()
  *
+ *      Top level quadtree rank statistics
+ *          l_int32   pixQuadtreeRank()
+ *
  *      Statistics in an arbitrary rectangle
  *          l_int32   pixMeanInRectangle()
  *          l_int32   pixVarianceInRectangle()
@@ -49,8 +52,10 @@
  *
  *
  *  There are many other statistical quantities that can be computed
- *  in a quadtree, such as rank values, and these can be added as
- *  the need arises.
+ *  in a quadtree, and these can be added as the need arises.  Rank
+ *  values are found from an integral histogram (see ihisto.c), which
+ *  gives the histogram of each quadtree region without rescanning
+ *  the pixels for every level.
  *
  *  Similar results that can approximate a single level of the quadtree
  *  can be generated by pixGetAverageTiled().  There we specify the
@@ -242,6 +247,99 @@ DPIX      *dpix_msac;  /* msa clone */
 }
 
 
+/*----------------------------------------------------------------------*
+ *                   Top-level quadtree rank statistics                 *
+ *----------------------------------------------------------------------*/
+/*!
+ * \brief   pixQuadtreeRank()
+ *
+ * \param[in]    pixs      8 bpp, no colormap
+ * \param[in]    nlevels   in quadtree; max allowed depends on image size
+ * \param[in]    rank      between 0.0 and 1.0; 0.5 is the median
+ * \param[in]    ih        input integral histogram; can be null
+ * \param[out]   pfpixa    rank values in quadtree
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) The returned fpixa has %nlevels of fpix, each containing
+ *          the rank values at its level.
+ *      (2) If %ih is null, an integral histogram with 256 bins is made
+ *          here.  Pass one in to compute several ranks on the same
+ *          image, or to use fewer bins.
+ *      (3) The histogram of each region takes a time independent of
+ *          the size of the region, so the total cost is dominated by
+ *          making the integral histogram, which is linear in the
+ *          number of pixels.
+ * </pre>
+ */
+l_ok
+pixQuadtreeRank(PIX        *pixs,
+                l_int32     nlevels,
+                l_float32   rank,
+                L_IHISTO   *ih,
+                FPIXA     **pfpixa)
+{
+l_int32    i, j, w, h, wi, hi, size, n;
+l_float32  val;
+BOX       *box;
+BOXA      *boxa;
+BOXAA     *baa;
+FPIX      *fpix;
+L_IHISTO  *ihc;
+
+    PROCNAME("pixQuadtreeRank");
+
+    if (!pfpixa)
+        return ERROR_INT("&fpixa not defined", procName, 1);
+    *pfpixa = NULL;
+    if (!pixs || pixGetDepth(pixs) != 8)
+        return ERROR_INT("pixs not defined or not 8 bpp", procName, 1);
+    if (rank < 0.0 || rank > 1.0)
+        return ERROR_INT("rank not in [0.0 ... 1.0]", procName, 1);
+    pixGetDimensions(pixs, &w, &h, NULL);
+    if (nlevels > quadtreeMaxLevels(w, h))
+        return ERROR_INT("nlevels too large for image", procName, 1);
+    if (ih) {
+        ihistoGetParameters(ih, &wi, &hi, NULL, NULL);
+        if (wi != w || hi != h)
+            return ERROR_INT("ih and pixs sizes differ", procName, 1);
+    }
+
+    if (!ih)
+        ihc = ihistoCreate(pixs, 256, 16);
+    else
+        ihc = ih;
+    if (!ihc)
+        return ERROR_INT("ihc not made", procName, 1);
+
+    if ((baa = boxaaQuadtreeRegions(w, h, nlevels)) == NULL) {
+        if (!ih) ihistoDestroy(&ihc);
+        return ERROR_INT("baa not made", procName, 1);
+    }
+
+    *pfpixa = fpixaCreate(nlevels);
+    for (i = 0; i < nlevels; i++) {
+        boxa = boxaaGetBoxa(baa, i, L_CLONE);
+        size = 1 << i;
+        n = boxaGetCount(boxa);  /* n == size * size */
+        fpix = fpixCreate(size, size);
+        for (j = 0; j < n; j++) {
+            box = boxaGetBox(boxa, j, L_CLONE);
+            ihistoGetRankValue(ihc, box, rank, &val);
+            fpixSetPixel(fpix, j % size, j / size, val);
+            boxDestroy(&box);
+        }
+        fpixaAddFPix(*pfpixa, fpix, L_INSERT);
+        boxaDestroy(&boxa);
+    }
+
+    if (!ih) ihistoDestroy(&ihc);
+    boxaaDestroy(&baa);
+    return 0;
+}
+
+
 /*----------------------------------------------------------------------*
  *                  Statistics in an arbitrary rectangle                *
  *----------------------------------------------------------------------*/
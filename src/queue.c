@@ -43,6 +43,17 @@
  *      Debug output
  *          l_int32         lqueuePrint()
  *
+ *      Create/Destroy L_PairQueue
+ *          L_PAIRQUEUE    *lpairqueueCreate()
+ *          void            lpairqueueDestroy()
+ *
+ *      Operations to add/remove to/from a L_PairQueue
+ *          l_int32         lpairqueueAdd()
+ *          l_int32         lpairqueueRemove()
+ *
+ *      Accessors
+ *          l_int32         lpairqueueGetCount()
+ *
  *    The lqueue is a fifo that implements a queue of void* pointers.
  *    It can be used to hold a queue of any type of struct.
  *    Internally, it maintains two counters:
@@ -59,6 +70,11 @@
  *    [A circular queue would allow us to skip the shifting and
  *    to resize only when the buffer is full.  For most applications,
  *    the extra work we do for a linear queue is not significant.]
+ *
+ *    The lpairqueue is a circular fifo of pairs of ints, such as
+ *    pixel locations.  It is used where many small items go through
+ *    the queue, as in the propagation step of a fill, so the pairs
+ *    are stored in the array instead of being allocated one at a time.
  * </pre>
  */
 
@@ -321,3 +337,169 @@ l_int32  i;
 
     return 0;
 }
+
+
+/*--------------------------------------------------------------------------*
+ *                       L_PairQueue create/destroy                         *
+ *--------------------------------------------------------------------------*/
+/*!
+ * \brief   lpairqueueCreate()
+ *
+ * \param[in]    nalloc     number of pairs to be alloc'd; 0 for default
+ * \return  lpairqueue, or NULL on error
+ */
+L_PAIRQUEUE *
+lpairqueueCreate(l_int32  nalloc)
+{
+L_PAIRQUEUE  *lpq;
+
+    PROCNAME("lpairqueueCreate");
+
+    if (nalloc < MIN_BUFFER_SIZE)
+        nalloc = INITIAL_BUFFER_ARRAYSIZE;
+
+    if ((lpq = (L_PAIRQUEUE *)LEPT_CALLOC(1, sizeof(L_PAIRQUEUE))) == NULL)
+        return (L_PAIRQUEUE *)ERROR_PTR("lpq not made", procName, NULL);
+    if ((lpq->array = (l_int32 *)LEPT_CALLOC(2 * nalloc,
+                                             sizeof(l_int32))) == NULL) {
+        lpairqueueDestroy(&lpq);
+        return (L_PAIRQUEUE *)ERROR_PTR("int array not made", procName, NULL);
+    }
+    lpq->nalloc = nalloc;
+    return lpq;
+}
+
+
+/*!
+ * \brief   lpairqueueDestroy()
+ *
+ * \param[in,out]   plpq     will be set to null before returning
+ * \return  void
+ */
+void
+lpairqueueDestroy(L_PAIRQUEUE  **plpq)
+{
+L_PAIRQUEUE  *lpq;
+
+    PROCNAME("lpairqueueDestroy");
+
+    if (plpq == NULL) {
+        L_WARNING("ptr address is NULL\n", procName);
+        return;
+    }
+    if ((lpq = *plpq) == NULL)
+        return;
+
+    LEPT_FREE(lpq->array);
+    LEPT_FREE(lpq);
+    *plpq = NULL;
+    return;
+}
+
+
+/*--------------------------------------------------------------------------*
+ *                     L_PairQueue add/remove and count                     *
+ *--------------------------------------------------------------------------*/
+/*!
+ * \brief   lpairqueueAdd()
+ *
+ * \param[in]    lpq       lpairqueue
+ * \param[in]    v1, v2    pair to be added to the tail of the queue
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) When the array is full, it is doubled in size, and the
+ *          pairs are unwrapped so that the head is at the beginning.
+ *          If that fails, the pair is not added and the queue is
+ *          unchanged.
+ * </pre>
+ */
+l_ok
+lpairqueueAdd(L_PAIRQUEUE  *lpq,
+              l_int32       v1,
+              l_int32       v2)
+{
+l_int32   i, index, nalloc;
+l_int32  *array;
+
+    PROCNAME("lpairqueueAdd");
+
+    if (!lpq)
+        return ERROR_INT("lpq not defined", procName, 1);
+
+    nalloc = lpq->nalloc;
+    if (lpq->nelem == nalloc) {
+        if ((array = (l_int32 *)LEPT_CALLOC(4 * nalloc,
+                                            sizeof(l_int32))) == NULL)
+            return ERROR_INT("new int array not made", procName, 1);
+        for (i = 0; i < nalloc; i++) {
+            index = (lpq->nhead + i) % nalloc;
+            array[2 * i] = lpq->array[2 * index];
+            array[2 * i + 1] = lpq->array[2 * index + 1];
+        }
+        LEPT_FREE(lpq->array);
+        lpq->array = array;
+        lpq->nhead = 0;
+        lpq->nalloc = 2 * nalloc;
+        nalloc = lpq->nalloc;
+    }
+
+    index = lpq->nhead + lpq->nelem;
+    if (index >= nalloc)
+        index -= nalloc;
+    lpq->array[2 * index] = v1;
+    lpq->array[2 * index + 1] = v2;
+    lpq->nelem++;
+    return 0;
+}
+
+
+/*!
+ * \brief   lpairqueueRemove()
+ *
+ * \param[in]    lpq       lpairqueue
+ * \param[out]   pv1, pv2  pair removed from the head of the queue
+ * \return  0 if OK, 1 if the queue is empty or on error
+ */
+l_ok
+lpairqueueRemove(L_PAIRQUEUE  *lpq,
+                 l_int32      *pv1,
+                 l_int32      *pv2)
+{
+    PROCNAME("lpairqueueRemove");
+
+    if (!pv1 || !pv2)
+        return ERROR_INT("&v1 and &v2 not both defined", procName, 1);
+    *pv1 = *pv2 = 0;
+    if (!lpq)
+        return ERROR_INT("lpq not defined", procName, 1);
+
+    if (lpq->nelem == 0)
+        return 1;
+    *pv1 = lpq->array[2 * lpq->nhead];
+    *pv2 = lpq->array[2 * lpq->nhead + 1];
+    lpq->nhead++;
+    if (lpq->nhead == lpq->nalloc)
+        lpq->nhead = 0;
+    lpq->nelem--;
+    return 0;
+}
+
+
+/*!
+ * \brief   lpairqueueGetCount()
+ *
+ * \param[in]    lpq   lpairqueue
+ * \return  count, or 0 on error
+ */
+l_int32
+lpairqueueGetCount(L_PAIRQUEUE  *lpq)
+{
+    PROCNAME("lpairqueueGetCount");
+
+    if (!lpq)
+        return ERROR_INT("lpq not defined", procName, 0);
+
+    return lpq->nelem;
+}
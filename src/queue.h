@@ -57,6 +57,12 @@
  *      items popped from the queue.  It is not made by default.
  *
  *      For further implementation details, see queue.c.
+ *
+ *      The L_PairQueue is a fifo of pairs of ints, such as the
+ *      locations of pixels in a fill.  The pairs are stored in the
+ *      array itself, so nothing is allocated for each pair.  It is a
+ *      circular queue: the tail wraps around to the beginning of the
+ *      array, and the array doubles in size only when it is full.
  * </pre>
  */
 
@@ -73,5 +79,16 @@ struct L_Queue
 };
 typedef struct L_Queue L_QUEUE;
 
+/*! Expandable circular queue of pairs of ints */
+struct L_PairQueue
+{
+    l_int32          nalloc;   /*!< number of pairs allocated              */
+    l_int32          nhead;    /*!< location of head (in pairs) from the   */
+                               /*!< beginning of the array                 */
+    l_int32          nelem;    /*!< number of pairs stored in the queue    */
+    l_int32         *array;    /*!< 2 * nalloc ints: v1, v2, v1, v2, ...   */
+};
+typedef struct L_PairQueue L_PAIRQUEUE;
+
 
 #endif  /* LEPTONICA_QUEUE_H */
@@ -33,6 +33,7 @@
  *           PIXA      *pixaReadFilesSA()
  *           PIX       *pixRead()
  *           PIX       *pixReadWithHint()
+ *           PIX       *pixReadRegion()
  *           PIX       *pixReadIndexed()
  *           PIX       *pixReadStream()
  *
@@ -246,6 +247,64 @@ PIX   *pix;
 }
 
 
+/*!
+ * \brief   pixReadRegion()
+ *
+ * \param[in]    filename    with full pathname or in local directory
+ * \param[in]    box         region to be read
+ * \return  pix if OK; NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This returns the part of the image within %box, clipped to
+ *          the image.  It is the same as clipping the image returned
+ *          by pixRead(), but for jpeg and tiff only the part of the
+ *          compressed image that is needed is decoded.  See
+ *          pixReadJpegRegion() and pixReadTiffRegion().  Images in
+ *          other formats are read entirely and clipped.
+ *      (2) For multipage tiff, the region is read from the first page.
+ * </pre>
+ */
+PIX *
+pixReadRegion(const char  *filename,
+              BOX         *box)
+{
+l_int32  format;
+FILE    *fp;
+PIX     *pix, *pixd;
+
+    PROCNAME("pixReadRegion");
+
+    if (!filename)
+        return (PIX *)ERROR_PTR("filename not defined", procName, NULL);
+    if (!box)
+        return (PIX *)ERROR_PTR("box not defined", procName, NULL);
+
+    if ((fp = fopenReadStream(filename)) == NULL)
+        return (PIX *)ERROR_PTR("image file not found", procName, NULL);
+    findFileFormatStream(fp, &format);
+    if (format == IFF_JFIF_JPEG) {
+        pixd = pixReadStreamJpegRegion(fp, box, 1, NULL, 0);
+    } else if (fileFormatIsTiff(fp)) {
+        pixd = pixReadStreamTiffRegion(fp, 0, box);
+    } else {
+        pixd = NULL;
+        if ((pix = pixReadStream(fp, 0)) != NULL) {
+            if ((pixd = pixClipRectangle(pix, box, NULL)) != NULL) {
+                pixCopySpp(pixd, pix);
+                pixCopyInputFormat(pixd, pix);
+            }
+            pixDestroy(&pix);
+        }
+    }
+    fclose(fp);
+
+    if (!pixd)
+        return (PIX *)ERROR_PTR("region not read", procName, NULL);
+    return pixd;
+}
+
+
 /*!
  * \brief   pixReadIndexed()
  *
@@ -90,6 +90,7 @@
  */
 
 #include <string.h>
+#include <math.h>
 #include "allheaders.h"
 
     /* There are two methods for splitting characters: DID and greedy.
@@ -637,7 +638,7 @@ PIX       *pix1, *pix2;
             ptaGetIPt(recog->pta_u, i, NULL, &ycent2);
             pixCorrelationBestShift(pix1, pix2, nasum, namoment, area2, ycent2,
                                     recog->maxyshift, recog->sumtab, &delx,
-                                    &dely, &score, 1);
+                                    &dely, &score, (ppixdb) ? 1 : 0);
             if (ppixdb) {
                 fprintf(stderr,
                     "Best match template %d: (x,y) = (%d,%d), score = %5.3f\n",
@@ -719,7 +720,10 @@ PIX       *pix1, *pix2;
  *          and where the centroid of pix2 is aligned, within +-maxyshift,
  *          with the centroid of a window of pix1 of the same width.
  *          The correlation is taken over the full height of pix1.
- *          This can be made more efficient.
+ *      (4) For each x shift, the counts for all y shifts are found
+ *          together with pixCorrelationCountShifts().  Except when
+ *          making the debug image, the count is abandoned early if no
+ *          y shift can exceed the best score found so far.
  * </pre>
  */
 static l_int32
@@ -736,13 +740,13 @@ pixCorrelationBestShift(PIX        *pix1,
                         l_float32  *pscore,
                         l_int32     debugflag)
 {
-l_int32     w1, w2, h1, h2, i, j, nx, shifty, delx, dely;
-l_int32     sum, moment, count;
-l_int32    *tab, *area1, *arraysum, *arraymoment;
+l_int32     w1, w2, h1, h2, i, j, nx, ny, shifty, delx, dely;
+l_int32     sum, moment, count, mincount, abandoned;
+l_int32    *tab, *area1, *arraysum, *arraymoment, *counts;
 l_float32   maxscore, score;
 l_float32  *ycent1;
 FPIX       *fpix;
-PIX        *pixt, *pixt1, *pixt2;
+PIX        *pixt1, *pixt2;
 
     PROCNAME("pixCorrelationBestShift");
 
@@ -798,24 +802,29 @@ PIX        *pixt, *pixt1, *pixt2;
     area1[nx - 1] = sum;
     ycent1[nx - 1] = (sum == 0) ? ycent2 : (l_float32)moment / (l_float32)sum;
 
-        /* Find the best match location for pix2.  At each location,
-         * to insure that pixels are ON only within the intersection of
-         * pix and the shifted pix2:
-         *  (1) Start with pixt cleared and equal in size to pix1.
-         *  (2) Blit the shifted pix2 onto pixt.  Then all ON pixels
-         *      are within the intersection of pix1 and the shifted pix2.
-         *  (3) AND pix1 with pixt. */
-    pixt = pixCreate(w2, h1, 1);
+        /* Find the best match location for pix2.  At each x location,
+         * the correlation counts for all the y shifts are found in
+         * a single pass over pix2.  Pixels are counted only within
+         * the intersection of pix1 and the shifted pix2.  Unless
+         * the debug image is requested, the pass is abandoned as soon
+         * as none of the y shifts can beat the best score so far. */
+    ny = 2 * maxyshift + 1;
+    counts = (l_int32 *)LEPT_CALLOC(ny, sizeof(l_int32));
     maxscore = 0;
     delx = 0;
     dely = 0;  /* amount to shift pix2 relative to pix1 to get alignment */
     for (i = 0; i < nx; i++) {
         shifty = (l_int32)(ycent1[i] - ycent2 + 0.5);
+        mincount = 0;
+        if (debugflag <= 0 && maxscore > 0.0) {
+            mincount = (l_int32)sqrt((l_float64)maxscore * area1[i] * area2);
+            mincount = L_MAX(0, mincount - 1);
+        }
+        pixCorrelationCountShifts(pix1, pix2, i, shifty - maxyshift, 1, ny,
+                                  mincount, tab, counts, &abandoned);
+        if (abandoned) continue;
         for (j = -maxyshift; j <= maxyshift; j++) {
-            pixClearAll(pixt);
-            pixRasterop(pixt, 0, shifty + j, w2, h2, PIX_SRC, pix2, 0, 0);
-            pixRasterop(pixt, 0, 0, w2, h1, PIX_SRC & PIX_DST, pix1, i, 0);
-            pixCountPixels(pixt, &count, tab);
+            count = counts[maxyshift + j];
             score = (l_float32)count * (l_float32)count /
                     ((l_float32)area1[i] * (l_float32)area2);
             if (score > maxscore) {
@@ -828,6 +837,7 @@ PIX        *pixt, *pixt1, *pixt2;
                 fpixSetPixel(fpix, i, maxyshift + j, 1000.0 * score);
         }
     }
+    LEPT_FREE(counts);
 
     if (debugflag > 0) {
         lept_mkdir("lept/recog");
@@ -849,7 +859,6 @@ PIX        *pixt, *pixt1, *pixt2;
     LEPT_FREE(ycent1);
     LEPT_FREE(arraysum);
     LEPT_FREE(arraymoment);
-    pixDestroy(&pixt);
     return 0;
 }
 
@@ -35,6 +35,8 @@
  *                PIX         *pixRotateAM()
  *                PIX         *pixRotateAMColor()
  *                PIX         *pixRotateAMGray()
+ *                PIX         *pixRotateAMColorInto()
+ *                PIX         *pixRotateAMGrayInto()
  *                static void  rotateAMColorLow()
  *                static void  rotateAMGrayLow()
  *
@@ -232,10 +234,6 @@ pixRotateAMColor(PIX       *pixs,
                  l_float32  angle,
                  l_uint32   colorval)
 {
-l_int32    w, h, wpls, wpld;
-l_uint32  *datas, *datad;
-PIX       *pix1, *pix2, *pixd;
-
     PROCNAME("pixRotateAMColor");
 
     if (!pixs)
@@ -243,13 +241,96 @@ PIX       *pix1, *pix2, *pixd;
     if (pixGetDepth(pixs) != 32)
         return (PIX *)ERROR_PTR("pixs must be 32 bpp", procName, NULL);
 
+    return pixRotateAMColorInto(NULL, pixs, angle, colorval);
+}
+
+
+/*!
+ * \brief   pixRotateAMGray()
+ *
+ * \param[in]    pixs 8 bpp
+ * \param[in]    angle radians; clockwise is positive
+ * \param[in]    grayval 0 to bring in BLACK, 255 for WHITE
+ * \return  pixd, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) Rotates about image center.
+ *      (2) A positive angle gives a clockwise rotation.
+ *      (3) Specify the grayvalue to be brought in from outside the image.
+ * </pre>
+ */
+PIX *
+pixRotateAMGray(PIX       *pixs,
+                l_float32  angle,
+                l_uint8    grayval)
+{
+    PROCNAME("pixRotateAMGray");
+
+    if (!pixs)
+        return (PIX *)ERROR_PTR("pixs not defined", procName, NULL);
+    if (pixGetDepth(pixs) != 8)
+        return (PIX *)ERROR_PTR("pixs must be 8 bpp", procName, NULL);
+
+    return pixRotateAMGrayInto(NULL, pixs, angle, grayval);
+}
+
+
+/*!
+ * \brief   pixRotateAMColorInto()
+ *
+ * \param[in]    pixd       [optional] pix to be reused; can be null
+ * \param[in]    pixs       32 bpp
+ * \param[in]    angle      radians; clockwise is positive
+ * \param[in]    colorval   e.g., 0 to bring in BLACK, 0xffffff00 for WHITE
+ * \return  pixd, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This is pixRotateAMColor(), written into pixd.  If pixd is
+ *          null, a new pix is made.  Otherwise pixd is resized as
+ *          required, and its image data is reused when the size of
+ *          the result does not change.  See pixReuseOrCreate().
+ *      (2) pixd cannot be the same as pixs.
+ *      (3) If the angle is too small to rotate, this returns a clone
+ *          of pixs if pixd is null, and otherwise copies pixs to pixd.
+ *      (4) With an alpha channel, the rotation of the alpha component
+ *          makes temporary pix.
+ * </pre>
+ */
+PIX *
+pixRotateAMColorInto(PIX       *pixd,
+                     PIX       *pixs,
+                     l_float32  angle,
+                     l_uint32   colorval)
+{
+l_int32    w, h, wpls, wpld;
+l_uint32  *datas, *datad;
+PIX       *pix1, *pix2, *pixt;
+
+    PROCNAME("pixRotateAMColorInto");
+
+    if (!pixs)
+        return (PIX *)ERROR_PTR("pixs not defined", procName, pixd);
+    if (pixGetDepth(pixs) != 32)
+        return (PIX *)ERROR_PTR("pixs must be 32 bpp", procName, pixd);
+    if (pixd == pixs)
+        return (PIX *)ERROR_PTR("pixd == pixs", procName, pixd);
+
     if (L_ABS(angle) < MinAngleToRotate)
-        return pixClone(pixs);
+        return (pixd) ? pixCopy(pixd, pixs) : pixClone(pixs);
 
     pixGetDimensions(pixs, &w, &h, NULL);
     datas = pixGetData(pixs);
     wpls = pixGetWpl(pixs);
-    pixd = pixCreateTemplate(pixs);
+    if ((pixt = pixReuseOrCreate(pixd, w, h, 32)) == NULL)
+        return (PIX *)ERROR_PTR("pixd not made", procName, pixd);
+    pixd = pixt;
+    pixCopySpp(pixd, pixs);
+    pixCopyResolution(pixd, pixs);
+    pixCopyColormap(pixd, pixs);
+    pixCopyText(pixd, pixs);
+    pixCopyInputFormat(pixd, pixs);
     datad = pixGetData(pixd);
     wpld = pixGetWpl(pixd);
 
@@ -267,43 +348,53 @@ PIX       *pix1, *pix2, *pixd;
 
 
 /*!
- * \brief   pixRotateAMGray()
+ * \brief   pixRotateAMGrayInto()
  *
- * \param[in]    pixs 8 bpp
- * \param[in]    angle radians; clockwise is positive
- * \param[in]    grayval 0 to bring in BLACK, 255 for WHITE
+ * \param[in]    pixd       [optional] pix to be reused; can be null
+ * \param[in]    pixs       8 bpp
+ * \param[in]    angle      radians; clockwise is positive
+ * \param[in]    grayval    0 to bring in BLACK, 255 for WHITE
  * \return  pixd, or NULL on error
  *
  * <pre>
  * Notes:
- *      (1) Rotates about image center.
- *      (2) A positive angle gives a clockwise rotation.
- *      (3) Specify the grayvalue to be brought in from outside the image.
+ *      (1) This is pixRotateAMGray(), written into pixd.  See the notes
+ *          in pixRotateAMColorInto().
  * </pre>
  */
 PIX *
-pixRotateAMGray(PIX       *pixs,
-                l_float32  angle,
-                l_uint8    grayval)
+pixRotateAMGrayInto(PIX       *pixd,
+                    PIX       *pixs,
+                    l_float32  angle,
+                    l_uint8    grayval)
 {
 l_int32    w, h, wpls, wpld;
 l_uint32  *datas, *datad;
-PIX        *pixd;
+PIX       *pixt;
 
-    PROCNAME("pixRotateAMGray");
+    PROCNAME("pixRotateAMGrayInto");
 
     if (!pixs)
-        return (PIX *)ERROR_PTR("pixs not defined", procName, NULL);
+        return (PIX *)ERROR_PTR("pixs not defined", procName, pixd);
     if (pixGetDepth(pixs) != 8)
-        return (PIX *)ERROR_PTR("pixs must be 8 bpp", procName, NULL);
+        return (PIX *)ERROR_PTR("pixs must be 8 bpp", procName, pixd);
+    if (pixd == pixs)
+        return (PIX *)ERROR_PTR("pixd == pixs", procName, pixd);
 
     if (L_ABS(angle) < MinAngleToRotate)
-        return pixClone(pixs);
+        return (pixd) ? pixCopy(pixd, pixs) : pixClone(pixs);
 
     pixGetDimensions(pixs, &w, &h, NULL);
     datas = pixGetData(pixs);
     wpls = pixGetWpl(pixs);
-    pixd = pixCreateTemplate(pixs);
+    if ((pixt = pixReuseOrCreate(pixd, w, h, 8)) == NULL)
+        return (PIX *)ERROR_PTR("pixd not made", procName, pixd);
+    pixd = pixt;
+    pixCopySpp(pixd, pixs);
+    pixCopyResolution(pixd, pixs);
+    pixCopyColormap(pixd, pixs);
+    pixCopyText(pixd, pixs);
+    pixCopyInputFormat(pixd, pixs);
     datad = pixGetData(pixd);
     wpld = pixGetWpl(pixd);
 
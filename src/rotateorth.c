@@ -36,6 +36,8 @@
  *
  *      90-degree rotation (both directions)
  *            PIX             *pixRotate90()
+ *            static void      rotate90Tiled()
+ *            static void      rotate90Binary()
  *
  *      Left-right flip
  *            PIX             *pixFlipLR()
@@ -53,10 +55,20 @@
 #include <string.h>
 #include "allheaders.h"
 
+static void rotate90Tiled(l_uint32 *datad, l_int32 wpld, l_uint32 *datas,
+                          l_int32 wpls, l_int32 wd, l_int32 hd, l_int32 d,
+                          l_int32 direction);
+static void rotate90Binary(l_uint32 *datad, l_int32 wpld, l_uint32 *datas,
+                           l_int32 wpls, l_int32 wd, l_int32 hd,
+                           l_int32 direction);
 static l_uint8 *makeReverseByteTab1(void);
 static l_uint8 *makeReverseByteTab2(void);
 static l_uint8 *makeReverseByteTab4(void);
 
+    /* Size of square tiles for 90 degree rotation; the source and dest
+     * tiles together should fit in the L1 cache */
+static const l_int32  Rotate90TileSize = 64;
+
 
 /*------------------------------------------------------------------*
  *           Top-level rotation by multiples of 90 degrees          *
@@ -157,6 +169,10 @@ l_int32  d;
  *      (1) This does a 90 degree rotation of the image about the center,
  *          either cw or ccw, returning a new pix.
  *      (2) The direction must be either 1 (cw) or -1 (ccw).
+ *      (3) Walking down the columns of the source is very cache-unfriendly
+ *          for large images.  Instead, the rotation is done in square
+ *          tiles that fit in the L1 cache.  For 1 bpp, the tiles are
+ *          8 x 8 bit matrices that are transposed in a 64-bit word.
  * </pre>
  */
 PIX *
@@ -164,9 +180,7 @@ pixRotate90(PIX     *pixs,
             l_int32  direction)
 {
 l_int32    wd, hd, d, wpls, wpld;
-l_int32    i, j, k, m, iend, nswords;
-l_uint32   val, word;
-l_uint32  *lines, *datas, *lined, *datad;
+l_uint32  *datas, *datad;
 PIX       *pixd;
 
     PROCNAME("pixRotate90");
@@ -192,185 +206,186 @@ PIX       *pixd;
     datad = pixGetData(pixd);
     wpld = pixGetWpl(pixd);
 
-    if (direction == 1) {  /* clockwise */
-        switch (d)
-        {
-            case 32:
-                for (i = 0; i < hd; i++) {
-                    lined = datad + i * wpld;
-                    lines = datas + (wd - 1) * wpls;
-                    for (j = 0; j < wd; j++) {
-                        lined[j] = lines[i];
-                        lines -= wpls;
-                    }
+    if (d == 1)
+        rotate90Binary(datad, wpld, datas, wpls, wd, hd, direction);
+    else
+        rotate90Tiled(datad, wpld, datas, wpls, wd, hd, d, direction);
+
+    return pixd;
+}
+
+
+/*!
+ * \brief   rotate90Tiled()
+ *
+ * \param[in]    datad      dest data, wd x hd
+ * \param[in]    wpld       dest words/line
+ * \param[in]    datas      src data, hd x wd
+ * \param[in]    wpls       src words/line
+ * \param[in]    wd, hd     dest width and height
+ * \param[in]    d          depth: 2, 4, 8, 16 or 32 bpp
+ * \param[in]    direction  clockwise = 1, counterclockwise = -1
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) For cw rotation, dest pixel (i, j) is src pixel (wd - 1 - j, i);
+ *          for ccw rotation, it is src pixel (j, hd - 1 - i), where
+ *          (row, column) indexing is used.
+ *      (2) The dest is visited in square tiles, so that the src lines
+ *          read for each tile stay in the cache.
+ * </pre>
+ */
+static void
+rotate90Tiled(l_uint32  *datad,
+              l_int32    wpld,
+              l_uint32  *datas,
+              l_int32    wpls,
+              l_int32    wd,
+              l_int32    hd,
+              l_int32    d,
+              l_int32    direction)
+{
+l_int32    i, j, i0, j0, iend, jend, is, ts, del;
+l_uint32   val;
+l_uint32  *lines, *lined;
+
+    ts = (d == 32) ? Rotate90TileSize / 2 : Rotate90TileSize;
+    del = (direction == 1) ? -wpls : wpls;  /* src line increment for j */
+    for (i0 = 0; i0 < hd; i0 += ts) {
+        iend = L_MIN(i0 + ts, hd);
+        for (j0 = 0; j0 < wd; j0 += ts) {
+            jend = L_MIN(j0 + ts, wd);
+            for (i = i0; i < iend; i++) {
+                lined = datad + i * wpld;
+                if (direction == 1) {
+                    lines = datas + (wd - 1 - j0) * wpls;
+                    is = i;
+                } else {
+                    lines = datas + j0 * wpls;
+                    is = hd - 1 - i;
                 }
-                break;
-            case 16:
-                for (i = 0; i < hd; i++) {
-                    lined = datad + i * wpld;
-                    lines = datas + (wd - 1) * wpls;
-                    for (j = 0; j < wd; j++) {
-                        if ((val = GET_DATA_TWO_BYTES(lines, i)))
+                switch (d)
+                {
+                case 32:
+                    for (j = j0; j < jend; j++, lines += del)
+                        lined[j] = lines[is];
+                    break;
+                case 16:
+                    for (j = j0; j < jend; j++, lines += del) {
+                        if ((val = GET_DATA_TWO_BYTES(lines, is)))
                             SET_DATA_TWO_BYTES(lined, j, val);
-                        lines -= wpls;
                     }
-                }
-                break;
-            case 8:
-                for (i = 0; i < hd; i++) {
-                    lined = datad + i * wpld;
-                    lines = datas + (wd - 1) * wpls;
-                    for (j = 0; j < wd; j++) {
-                        if ((val = GET_DATA_BYTE(lines, i)))
+                    break;
+                case 8:
+                    for (j = j0; j < jend; j++, lines += del) {
+                        if ((val = GET_DATA_BYTE(lines, is)))
                             SET_DATA_BYTE(lined, j, val);
-                        lines -= wpls;
                     }
-                }
-                break;
-            case 4:
-                for (i = 0; i < hd; i++) {
-                    lined = datad + i * wpld;
-                    lines = datas + (wd - 1) * wpls;
-                    for (j = 0; j < wd; j++) {
-                        if ((val = GET_DATA_QBIT(lines, i)))
+                    break;
+                case 4:
+                    for (j = j0; j < jend; j++, lines += del) {
+                        if ((val = GET_DATA_QBIT(lines, is)))
                             SET_DATA_QBIT(lined, j, val);
-                        lines -= wpls;
                     }
-                }
-                break;
-            case 2:
-                for (i = 0; i < hd; i++) {
-                    lined = datad + i * wpld;
-                    lines = datas + (wd - 1) * wpls;
-                    for (j = 0; j < wd; j++) {
-                        if ((val = GET_DATA_DIBIT(lines, i)))
+                    break;
+                case 2:
+                    for (j = j0; j < jend; j++, lines += del) {
+                        if ((val = GET_DATA_DIBIT(lines, is)))
                             SET_DATA_DIBIT(lined, j, val);
-                        lines -= wpls;
                     }
+                    break;
+                default:
+                    break;
                 }
-                break;
-            case 1:
-                nswords = hd / 32;
-                for (j = 0; j < wd; j++) {
-                    lined = datad;
-                    lines = datas + (wd - 1 - j) * wpls;
-                    for (k = 0; k < nswords; k++) {
-                        word = lines[k];
-                        if (!word) {
-                            lined += 32 * wpld;
-                            continue;
-                        } else {
-                            iend = 32 * (k + 1);
-                            for (m = 0, i = 32 * k; i < iend; i++, m++) {
-                                if ((word << m) & 0x80000000)
-                                    SET_DATA_BIT(lined, j);
-                                lined += wpld;
-                            }
-                        }
-                    }
-                    for (i = 32 * nswords; i < hd; i++) {
-                        if (GET_DATA_BIT(lines, i))
-                            SET_DATA_BIT(lined, j);
-                        lined += wpld;
-                    }
-                }
-                break;
-            default:
-                pixDestroy(&pixd);
-                L_ERROR("illegal depth: %d\n", procName, d);
-                break;
+            }
         }
-    } else  {     /* direction counter-clockwise */
-        switch (d)
-        {
-            case 32:
-                for (i = 0; i < hd; i++) {
-                    lined = datad + i * wpld;
-                    lines = datas;
-                    for (j = 0; j < wd; j++) {
-                        lined[j] = lines[hd - 1 - i];
-                        lines += wpls;
-                    }
-                }
-                break;
-            case 16:
-                for (i = 0; i < hd; i++) {
-                    lined = datad + i * wpld;
-                    lines = datas;
-                    for (j = 0; j < wd; j++) {
-                        if ((val = GET_DATA_TWO_BYTES(lines, hd - 1 - i)))
-                            SET_DATA_TWO_BYTES(lined, j, val);
-                        lines += wpls;
-                    }
-                }
-                break;
-            case 8:
-                for (i = 0; i < hd; i++) {
-                    lined = datad + i * wpld;
-                    lines = datas;
-                    for (j = 0; j < wd; j++) {
-                        if ((val = GET_DATA_BYTE(lines, hd - 1 - i)))
-                            SET_DATA_BYTE(lined, j, val);
-                        lines += wpls;
-                    }
-                }
-                break;
-            case 4:
-                for (i = 0; i < hd; i++) {
-                    lined = datad + i * wpld;
-                    lines = datas;
-                    for (j = 0; j < wd; j++) {
-                        if ((val = GET_DATA_QBIT(lines, hd - 1 - i)))
-                            SET_DATA_QBIT(lined, j, val);
-                        lines += wpls;
-                    }
-                }
-                break;
-            case 2:
-                for (i = 0; i < hd; i++) {
-                    lined = datad + i * wpld;
-                    lines = datas;
-                    for (j = 0; j < wd; j++) {
-                        if ((val = GET_DATA_DIBIT(lines, hd - 1 - i)))
-                            SET_DATA_DIBIT(lined, j, val);
-                        lines += wpls;
-                    }
+    }
+}
+
+
+/*!
+ * \brief   rotate90Binary()
+ *
+ * \param[in]    datad      dest data, wd x hd, initialized to 0
+ * \param[in]    wpld       dest words/line
+ * \param[in]    datas      src data, hd x wd
+ * \param[in]    wpls       src words/line
+ * \param[in]    wd, hd     dest width and height
+ * \param[in]    direction  clockwise = 1, counterclockwise = -1
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) The src is taken in blocks of 8 x 8 pixels: one byte from each
+ *          of 8 consecutive lines.  The 8 bytes are packed into a 64-bit
+ *          word and the bit matrix is transposed in 3 steps of
+ *          masked shifts.  Each byte of the result is then written
+ *          to one of 8 dest lines.
+ *      (2) For either direction, the src lines of a block are taken
+ *          in the order of the dest columns, and the bytes of the
+ *          transposed block go to successive dest lines, which are
+ *          increasing for cw and decreasing for ccw rotation.
+ *      (3) Blocks with no ON pixels are skipped, because the dest has
+ *          been cleared.  Src lines beyond the image are taken as 0,
+ *          so no pixels are written into the dest padding.
+ *      (4) The byte columns of the src are visited in strips, so that
+ *          the dest lines being written stay in the cache.
+ * </pre>
+ */
+static void
+rotate90Binary(l_uint32  *datad,
+               l_int32    wpld,
+               l_uint32  *datas,
+               l_int32    wpls,
+               l_int32    wd,
+               l_int32    hd,
+               l_int32    direction)
+{
+l_int32    a, a0, aend, b, c, r, id, srow, nbytess, nbytesd;
+l_uint32  *lines[8];
+l_uint64   x;
+
+    nbytess = (hd + 7) / 8;  /* bytes in a src line that hold pixels */
+    nbytesd = (wd + 7) / 8;  /* bytes in a dest line that hold pixels */
+    for (a0 = 0; a0 < nbytess; a0 += Rotate90TileSize / 2) {
+        aend = L_MIN(a0 + Rotate90TileSize / 2, nbytess);
+        for (b = 0; b < nbytesd; b++) {
+                /* The 8 src lines that go to dest byte column b */
+            for (r = 0; r < 8; r++) {
+                srow = (direction == 1) ? wd - 1 - 8 * b - r : 8 * b + r;
+                lines[r] = (srow >= 0 && srow < wd) ?
+                           datas + srow * wpls : NULL;
+            }
+            for (a = a0; a < aend; a++) {
+                for (r = 0, x = 0; r < 8; r++) {
+                    x <<= 8;
+                    if (lines[r])
+                        x |= GET_DATA_BYTE(lines[r], a);
                 }
-                break;
-            case 1:
-                nswords = hd / 32;
-                for (j = 0; j < wd; j++) {
-                    lined = datad + (hd - 1) * wpld;
-                    lines = datas + (wd - 1 - j) * wpls;
-                    for (k = 0; k < nswords; k++) {
-                        word = lines[k];
-                        if (!word) {
-                            lined -= 32 * wpld;
-                            continue;
-                        } else {
-                            iend = 32 * (k + 1);
-                            for (m = 0, i = 32 * k; i < iend; i++, m++) {
-                                if ((word << m) & 0x80000000)
-                                    SET_DATA_BIT(lined, wd - 1 - j);
-                                lined -= wpld;
-                            }
-                        }
-                    }
-                    for (i = 32 * nswords; i < hd; i++) {
-                        if (GET_DATA_BIT(lines, i))
-                            SET_DATA_BIT(lined, wd - 1 - j);
-                        lined -= wpld;
-                    }
+                if (!x) continue;
+
+                    /* Transpose the 8 x 8 bit matrix */
+                x = (x & 0xaa55aa55aa55aa55ULL) |
+                    ((x & 0x00aa00aa00aa00aaULL) << 7) |
+                    ((x >> 7) & 0x00aa00aa00aa00aaULL);
+                x = (x & 0xcccc3333cccc3333ULL) |
+                    ((x & 0x0000cccc0000ccccULL) << 14) |
+                    ((x >> 14) & 0x0000cccc0000ccccULL);
+                x = (x & 0xf0f0f0f00f0f0f0fULL) |
+                    ((x & 0x00000000f0f0f0f0ULL) << 28) |
+                    ((x >> 28) & 0x00000000f0f0f0f0ULL);
+
+                    /* Byte c goes to the dest line for src column 8a + c */
+                for (c = 0; c < 8; c++) {
+                    id = (direction == 1) ? 8 * a + c : hd - 1 - 8 * a - c;
+                    if (id < 0 || id >= hd) continue;
+                    SET_DATA_BYTE(datad + id * wpld, b,
+                                  (x >> (56 - 8 * c)) & 0xff);
                 }
-                break;
-            default:
-                pixDestroy(&pixd);
-                L_ERROR("illegal depth: %d\n", procName, d);
-                break;
+            }
         }
     }
-
-    return pixd;
 }
 
 
@@ -45,6 +45,38 @@
  *     Compute runlength-to-membership transform on a line
  *           l_int32      runlengthMembershipOnLine()
  *
+ *     Run-length encoded 1 bpp image (L_Rle)
+ *           L_RLE       *rleCreate()
+ *           void         rleDestroy()
+ *           L_RLE       *rleCopy()
+ *           l_int32      rleGetDimensions()
+ *           static l_int32  rleExtendArrays()
+ *           static l_int32  rleAddRun()
+ *
+ *     Conversion between Pix and L_Rle
+ *           L_RLE       *pixConvertToRle()
+ *           PIX         *rleConvertToPix()
+ *           void         setLineRun()
+ *
+ *     Boolean operations on L_Rle
+ *           L_RLE       *rleRasterop()
+ *           L_RLE       *rleInvert()
+ *           L_RLE       *rleAnd()
+ *           L_RLE       *rleOr()
+ *           L_RLE       *rleXor()
+ *           L_RLE       *rleSubtract()
+ *           static void  rleCombineLines()
+ *
+ *     Brick morphology on L_Rle
+ *           L_RLE       *rleDilateBrick()
+ *           L_RLE       *rleErodeBrick()
+ *           static L_RLE  *rleMorphHoriz()
+ *           static L_RLE  *rleMorphVert()
+ *
+ *     Measurements on L_Rle
+ *           l_int32      rleCountPixels()
+ *           l_int32      rleFindBoundingBox()
+ *
  *     Make byte position LUT
  *           l_int32      makeMSBitLocTab()
  *
@@ -53,6 +85,14 @@
  *  are selectable from given sets of angles.  Most of the other runs
  *  are oriented either horizontally along the raster lines or
  *  vertically along pixel columns.
+ *
+ *  The L_Rle holds a 1 bpp image as the runs of fg pixels on each
+ *  raster line.  For text and line art, which are mostly bg, it is
+ *  much smaller than the Pix, and the operations here (boolean ops,
+ *  brick dilation and erosion, pixel counting and bounding box) take
+ *  time proportional to the number of runs rather than the number
+ *  of pixels.  Connected components of an L_Rle are found with
+ *  rleConnCompBB() and rleCountConnComp() in conncomp.c.
  * </pre>
  */
 
@@ -61,6 +101,15 @@
 #include "allheaders.h"
 
 static PIX *pixFindMinRunsOrthogonal(PIX *pixs, l_float32 angle, l_int32 depth);
+static l_int32 rleExtendArrays(L_RLE *rle);
+static l_int32 rleAddRun(L_RLE *rle, l_int32 y, l_int32 x0, l_int32 x1);
+static void rleCombineLines(L_RLE *rled, l_int32 y, l_int32 *ax0,
+                            l_int32 *ax1, l_int32 na, l_int32 *bx0,
+                            l_int32 *bx1, l_int32 nb, l_int32 op);
+static L_RLE *rleMorphHoriz(L_RLE *rles, l_int32 hsize, l_int32 type);
+static L_RLE *rleMorphVert(L_RLE *rles, l_int32 vsize, l_int32 type);
+
+static const l_int32  INITIAL_RUN_ARRAYSIZE = 256;   /*!< n'importe quoi */
 
 
 /*-----------------------------------------------------------------------*
@@ -767,6 +816,892 @@ l_int32  i, j, first, last, diff, max;
 }
 
 
+/*-----------------------------------------------------------------------*
+ *                Run-length encoded 1 bpp image (L_Rle)                 *
+ *-----------------------------------------------------------------------*/
+/*!
+ * \brief   rleCreate()
+ *
+ * \param[in]    w, h     size of the image
+ * \param[in]    n        initial size of the run arrays; use 0 for default
+ * \return  rle, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) The returned rle has no fg pixels.
+ * </pre>
+ */
+L_RLE *
+rleCreate(l_int32  w,
+          l_int32  h,
+          l_int32  n)
+{
+L_RLE  *rle;
+
+    PROCNAME("rleCreate");
+
+    if (w <= 0 || h <= 0)
+        return (L_RLE *)ERROR_PTR("w and h must be > 0", procName, NULL);
+    if (n <= 0)
+        n = INITIAL_RUN_ARRAYSIZE;
+
+    rle = (L_RLE *)LEPT_CALLOC(1, sizeof(L_RLE));
+    rle->w = w;
+    rle->h = h;
+    rle->nalloc = n;
+    rle->x0 = (l_int32 *)LEPT_CALLOC(n, sizeof(l_int32));
+    rle->x1 = (l_int32 *)LEPT_CALLOC(n, sizeof(l_int32));
+    rle->linestart = (l_int32 *)LEPT_CALLOC(h + 1, sizeof(l_int32));
+    if (!rle->x0 || !rle->x1 || !rle->linestart) {
+        rleDestroy(&rle);
+        return (L_RLE *)ERROR_PTR("run arrays not made", procName, NULL);
+    }
+    return rle;
+}
+
+
+/*!
+ * \brief   rleDestroy()
+ *
+ * \param[in,out]   prle    will be set to null before returning
+ * \return  void
+ */
+void
+rleDestroy(L_RLE  **prle)
+{
+L_RLE  *rle;
+
+    PROCNAME("rleDestroy");
+
+    if (prle == NULL) {
+        L_WARNING("ptr address is null!\n", procName);
+        return;
+    }
+    if ((rle = *prle) == NULL)
+        return;
+
+    LEPT_FREE(rle->x0);
+    LEPT_FREE(rle->x1);
+    LEPT_FREE(rle->linestart);
+    LEPT_FREE(rle);
+    *prle = NULL;
+    return;
+}
+
+
+/*!
+ * \brief   rleCopy()
+ *
+ * \param[in]    rles
+ * \return  rled, or NULL on error
+ */
+L_RLE *
+rleCopy(L_RLE  *rles)
+{
+L_RLE  *rled;
+
+    PROCNAME("rleCopy");
+
+    if (!rles)
+        return (L_RLE *)ERROR_PTR("rles not defined", procName, NULL);
+
+    if ((rled = rleCreate(rles->w, rles->h, L_MAX(1, rles->nruns))) == NULL)
+        return (L_RLE *)ERROR_PTR("rled not made", procName, NULL);
+    rled->nruns = rles->nruns;
+    memcpy(rled->x0, rles->x0, sizeof(l_int32) * rles->nruns);
+    memcpy(rled->x1, rles->x1, sizeof(l_int32) * rles->nruns);
+    memcpy(rled->linestart, rles->linestart, sizeof(l_int32) * (rles->h + 1));
+    return rled;
+}
+
+
+/*!
+ * \brief   rleGetDimensions()
+ *
+ * \param[in]    rle
+ * \param[out]   pw, ph    [optional] each can be null
+ * \param[out]   pnruns    [optional] number of runs of fg pixels
+ * \return  0 if OK, 1 on error
+ */
+l_ok
+rleGetDimensions(L_RLE    *rle,
+                 l_int32  *pw,
+                 l_int32  *ph,
+                 l_int32  *pnruns)
+{
+    PROCNAME("rleGetDimensions");
+
+    if (pw) *pw = 0;
+    if (ph) *ph = 0;
+    if (pnruns) *pnruns = 0;
+    if (!rle)
+        return ERROR_INT("rle not defined", procName, 1);
+    if (pw) *pw = rle->w;
+    if (ph) *ph = rle->h;
+    if (pnruns) *pnruns = rle->nruns;
+    return 0;
+}
+
+
+/*!
+ * \brief   rleExtendArrays()
+ *
+ * \param[in]    rle
+ * \return  0 if OK, 1 on error
+ */
+static l_int32
+rleExtendArrays(L_RLE  *rle)
+{
+size_t  oldsize, newsize;
+
+    PROCNAME("rleExtendArrays");
+
+    oldsize = rle->nalloc * sizeof(l_int32);
+    newsize = 2 * oldsize;
+    if ((rle->x0 = (l_int32 *)reallocNew((void **)&rle->x0,
+                                         oldsize, newsize)) == NULL)
+        return ERROR_INT("new x0 array not returned", procName, 1);
+    if ((rle->x1 = (l_int32 *)reallocNew((void **)&rle->x1,
+                                         oldsize, newsize)) == NULL)
+        return ERROR_INT("new x1 array not returned", procName, 1);
+    rle->nalloc *= 2;
+    return 0;
+}
+
+
+/*!
+ * \brief   rleAddRun()
+ *
+ * \param[in]    rle
+ * \param[in]    y        line that is being built
+ * \param[in]    x0, x1   first and last pixel of the run
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) Lines are built in order.  When line %y is started,
+ *          linestart[y] must be set, and when it is finished, the
+ *          caller sets linestart[y + 1] = nruns.
+ *      (2) Runs on a line are added in order of increasing %x0.  A run
+ *          that overlaps or touches the previous run on the line is
+ *          merged with it.
+ * </pre>
+ */
+static l_int32
+rleAddRun(L_RLE   *rle,
+          l_int32  y,
+          l_int32  x0,
+          l_int32  x1)
+{
+l_int32  n;
+
+    PROCNAME("rleAddRun");
+
+    n = rle->nruns;
+    if (n > rle->linestart[y] && x0 <= rle->x1[n - 1] + 1) {
+        rle->x1[n - 1] = L_MAX(rle->x1[n - 1], x1);
+        return 0;
+    }
+    if (n >= rle->nalloc && rleExtendArrays(rle))
+        return ERROR_INT("run arrays not extended", procName, 1);
+    rle->x0[n] = x0;
+    rle->x1[n] = x1;
+    rle->nruns++;
+    return 0;
+}
+
+
+/*-----------------------------------------------------------------------*
+ *                  Conversion between Pix and L_Rle                     *
+ *-----------------------------------------------------------------------*/
+/*!
+ * \brief   pixConvertToRle()
+ *
+ * \param[in]    pixs    1 bpp
+ * \return  rle, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) The runs are counted first, a word at a time, so that the
+ *          run arrays are allocated once with the exact size.
+ *      (2) When extracting the runs, words that are all bg outside
+ *          of a run, or all fg inside a run, are skipped.
+ *      (3) The pad bits are masked out, so pixs is not changed.
+ * </pre>
+ */
+L_RLE *
+pixConvertToRle(PIX  *pixs)
+{
+l_int32    i, k, b, w, h, wpl, nwords, nruns, r, start, inrun;
+l_int32   *tab8, *x0, *x1;
+l_uint32   word, starts, prev, endmask;
+l_uint32  *data, *line;
+L_RLE     *rle;
+
+    PROCNAME("pixConvertToRle");
+
+    if (!pixs || pixGetDepth(pixs) != 1)
+        return (L_RLE *)ERROR_PTR("pixs undefined or not 1 bpp",
+                                  procName, NULL);
+
+    pixGetDimensions(pixs, &w, &h, NULL);
+    data = pixGetData(pixs);
+    wpl = pixGetWpl(pixs);
+    nwords = (w + 31) / 32;  /* mask out the pad bits in the last word */
+    endmask = (w % 32) ? 0xffffffff << (32 - w % 32) : 0xffffffff;
+
+        /* Count the runs, from the number of 0 --> 1 transitions */
+    tab8 = makePixelSumTab8();
+    nruns = 0;
+    for (i = 0; i < h; i++) {
+        line = data + i * wpl;
+        prev = 0;
+        for (k = 0; k < nwords; k++) {
+            word = line[k];
+            if (k == nwords - 1)
+                word &= endmask;
+            starts = word & ~((word >> 1) | (prev << 31));
+            nruns += tab8[starts & 0xff] + tab8[(starts >> 8) & 0xff] +
+                     tab8[(starts >> 16) & 0xff] + tab8[starts >> 24];
+            prev = word;
+        }
+    }
+    LEPT_FREE(tab8);
+
+    if ((rle = rleCreate(w, h, L_MAX(1, nruns))) == NULL)
+        return (L_RLE *)ERROR_PTR("rle not made", procName, NULL);
+    x0 = rle->x0;
+    x1 = rle->x1;
+    r = 0;
+    for (i = 0; i < h; i++) {
+        line = data + i * wpl;
+        inrun = FALSE;
+        start = 0;
+        for (k = 0; k < nwords; k++) {
+            word = line[k];
+            if (k == nwords - 1)
+                word &= endmask;
+            if ((!inrun && word == 0) || (inrun && word == 0xffffffff))
+                continue;
+            for (b = 0; b < 32; b++) {
+                if ((word >> (31 - b)) & 1) {
+                    if (!inrun) {
+                        start = 32 * k + b;
+                        inrun = TRUE;
+                    }
+                } else if (inrun) {
+                    x0[r] = start;
+                    x1[r++] = 32 * k + b - 1;
+                    inrun = FALSE;
+                }
+            }
+        }
+        if (inrun) {  /* the run ends at the right side */
+            x0[r] = start;
+            x1[r++] = w - 1;
+        }
+        rle->linestart[i + 1] = r;
+    }
+    rle->nruns = r;
+    return rle;
+}
+
+
+/*!
+ * \brief   rleConvertToPix()
+ *
+ * \param[in]    rle
+ * \return  pixd 1 bpp, or NULL on error
+ */
+PIX *
+rleConvertToPix(L_RLE  *rle)
+{
+l_int32    i, k, wpld;
+l_uint32  *datad;
+PIX       *pixd;
+
+    PROCNAME("rleConvertToPix");
+
+    if (!rle)
+        return (PIX *)ERROR_PTR("rle not defined", procName, NULL);
+
+    if ((pixd = pixCreate(rle->w, rle->h, 1)) == NULL)
+        return (PIX *)ERROR_PTR("pixd not made", procName, NULL);
+    datad = pixGetData(pixd);
+    wpld = pixGetWpl(pixd);
+    for (i = 0; i < rle->h; i++) {
+        for (k = rle->linestart[i]; k < rle->linestart[i + 1]; k++)
+            setLineRun(datad + i * wpld, rle->x0[k], rle->x1[k]);
+    }
+    return pixd;
+}
+
+
+/*!
+ * \brief   setLineRun()
+ *
+ * \param[in]    line     of 1 bpp image
+ * \param[in]    x0, x1   first and last pixel of the run to be set
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) This sets the pixels in [x0 ... x1] a word at a time.
+ *          There is no checking of the range.
+ * </pre>
+ */
+void
+setLineRun(l_uint32  *line,
+           l_int32    x0,
+           l_int32    x1)
+{
+l_int32   k, k0, k1;
+l_uint32  mask0, mask1;
+
+    k0 = x0 >> 5;
+    k1 = x1 >> 5;
+    mask0 = 0xffffffff >> (x0 & 31);
+    mask1 = 0xffffffff << (31 - (x1 & 31));
+    if (k0 == k1) {
+        line[k0] |= mask0 & mask1;
+        return;
+    }
+    line[k0] |= mask0;
+    for (k = k0 + 1; k < k1; k++)
+        line[k] = 0xffffffff;
+    line[k1] |= mask1;
+}
+
+
+/*-----------------------------------------------------------------------*
+ *                      Boolean operations on L_Rle                      *
+ *-----------------------------------------------------------------------*/
+/*!
+ * \brief   rleRasterop()
+ *
+ * \param[in]    rled    dest image for the operation
+ * \param[in]    rles    src image for the operation
+ * \param[in]    op      any of the 16 rasterop operations, such as
+ *                       PIX_SRC | PIX_DST or PIX_NOT(PIX_SRC) & PIX_DST
+ * \return  rle with the result, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This is the run-length analog of pixRasterop() on two
+ *          images of the same size, with the result in a new L_Rle.
+ *          Neither input is changed.
+ *      (2) Each line is found by merging the runs of the two inputs,
+ *          so the time is proportional to the number of runs.  The op
+ *          is evaluated as a truth table, with bit (2 * s + d) of %op
+ *          giving the result for src pixel s and dest pixel d.
+ * </pre>
+ */
+L_RLE *
+rleRasterop(L_RLE   *rled,
+            L_RLE   *rles,
+            l_int32  op)
+{
+l_int32  i, w, h, sd, ss;
+L_RLE   *rle;
+
+    PROCNAME("rleRasterop");
+
+    if (!rled || !rles)
+        return (L_RLE *)ERROR_PTR("rled and rles not both defined",
+                                  procName, NULL);
+    if (op < 0 || op > 15)
+        return (L_RLE *)ERROR_PTR("invalid op", procName, NULL);
+    w = rled->w;
+    h = rled->h;
+    if (rles->w != w || rles->h != h)
+        return (L_RLE *)ERROR_PTR("rled and rles not same size",
+                                  procName, NULL);
+
+    if ((rle = rleCreate(w, h, L_MAX(1, rled->nruns + rles->nruns))) == NULL)
+        return (L_RLE *)ERROR_PTR("rle not made", procName, NULL);
+    for (i = 0; i < h; i++) {
+        sd = rled->linestart[i];
+        ss = rles->linestart[i];
+        rleCombineLines(rle, i, rled->x0 + sd, rled->x1 + sd,
+                        rled->linestart[i + 1] - sd, rles->x0 + ss,
+                        rles->x1 + ss, rles->linestart[i + 1] - ss, op);
+        rle->linestart[i + 1] = rle->nruns;
+    }
+    return rle;
+}
+
+
+/*!
+ * \brief   rleInvert()
+ *
+ * \param[in]    rles
+ * \return  rle with fg and bg exchanged, or NULL on error
+ */
+L_RLE *
+rleInvert(L_RLE  *rles)
+{
+    PROCNAME("rleInvert");
+
+    if (!rles)
+        return (L_RLE *)ERROR_PTR("rles not defined", procName, NULL);
+    return rleRasterop(rles, rles, PIX_NOT(PIX_DST));
+}
+
+
+/*!
+ * \brief   rleAnd()
+ *
+ * \param[in]    rle1, rle2    of the same size
+ * \return  rle with the intersection, or NULL on error
+ */
+L_RLE *
+rleAnd(L_RLE  *rle1,
+       L_RLE  *rle2)
+{
+    return rleRasterop(rle1, rle2, PIX_SRC & PIX_DST);
+}
+
+
+/*!
+ * \brief   rleOr()
+ *
+ * \param[in]    rle1, rle2    of the same size
+ * \return  rle with the union, or NULL on error
+ */
+L_RLE *
+rleOr(L_RLE  *rle1,
+      L_RLE  *rle2)
+{
+    return rleRasterop(rle1, rle2, PIX_SRC | PIX_DST);
+}
+
+
+/*!
+ * \brief   rleXor()
+ *
+ * \param[in]    rle1, rle2    of the same size
+ * \return  rle with the exclusive or, or NULL on error
+ */
+L_RLE *
+rleXor(L_RLE  *rle1,
+       L_RLE  *rle2)
+{
+    return rleRasterop(rle1, rle2, PIX_SRC ^ PIX_DST);
+}
+
+
+/*!
+ * \brief   rleSubtract()
+ *
+ * \param[in]    rle1, rle2    of the same size
+ * \return  rle with the fg of %rle1 that is not in %rle2, or NULL on error
+ */
+L_RLE *
+rleSubtract(L_RLE  *rle1,
+            L_RLE  *rle2)
+{
+    return rleRasterop(rle1, rle2, PIX_DST & PIX_NOT(PIX_SRC));
+}
+
+
+/*!
+ * \brief   rleCombineLines()
+ *
+ * \param[in]    rled          rle being built
+ * \param[in]    y             line of %rled that is being built
+ * \param[in]    ax0, ax1, na  runs of the dest line
+ * \param[in]    bx0, bx1, nb  runs of the src line
+ * \param[in]    op            rasterop operation
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) This walks along the line from one run boundary of either
+ *          input to the next.  Between boundaries, both inputs are
+ *          constant, so the op gives a single value for the segment.
+ * </pre>
+ */
+static void
+rleCombineLines(L_RLE    *rled,
+                l_int32   y,
+                l_int32  *ax0,
+                l_int32  *ax1,
+                l_int32   na,
+                l_int32  *bx0,
+                l_int32  *bx1,
+                l_int32   nb,
+                l_int32   op)
+{
+l_int32  w, x, i, j, sa, sb, nexta, nextb, next;
+
+    w = rled->w;
+    x = i = j = 0;
+    while (x < w) {
+        if (i < na && ax0[i] <= x) {
+            sa = 1;
+            nexta = ax1[i] + 1;
+        } else {
+            sa = 0;
+            nexta = (i < na) ? ax0[i] : w;
+        }
+        if (j < nb && bx0[j] <= x) {
+            sb = 1;
+            nextb = bx1[j] + 1;
+        } else {
+            sb = 0;
+            nextb = (j < nb) ? bx0[j] : w;
+        }
+        next = L_MIN(nexta, nextb);
+        if ((op >> (2 * sb + sa)) & 1)
+            rleAddRun(rled, y, x, next - 1);
+        x = next;
+        if (i < na && x > ax1[i]) i++;
+        if (j < nb && x > bx1[j]) j++;
+    }
+}
+
+
+/*-----------------------------------------------------------------------*
+ *                      Brick morphology on L_Rle                        *
+ *-----------------------------------------------------------------------*/
+/*!
+ * \brief   rleDilateBrick()
+ *
+ * \param[in]    rles
+ * \param[in]    hsize    width of brick Sel
+ * \param[in]    vsize    height of brick Sel
+ * \return  rled, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This gives the same result as pixDilateBrick() on the
+ *          corresponding Pix: the Sel is a brick with the origin
+ *          at (hsize / 2, vsize / 2), and it is decomposed into
+ *          a horizontal and a vertical dilation.
+ *      (2) The horizontal dilation extends each run and merges
+ *          the runs that overlap.  The vertical dilation ORs the
+ *          lines in a window of %vsize lines, using log2(vsize)
+ *          passes in which the window size is doubled.
+ * </pre>
+ */
+L_RLE *
+rleDilateBrick(L_RLE   *rles,
+               l_int32  hsize,
+               l_int32  vsize)
+{
+L_RLE  *rle1, *rled;
+
+    PROCNAME("rleDilateBrick");
+
+    if (!rles)
+        return (L_RLE *)ERROR_PTR("rles not defined", procName, NULL);
+    if (hsize < 1 || vsize < 1)
+        return (L_RLE *)ERROR_PTR("hsize and vsize not >= 1", procName, NULL);
+
+    if (hsize == 1 && vsize == 1)
+        return rleCopy(rles);
+    if (vsize == 1)
+        return rleMorphHoriz(rles, hsize, L_MORPH_DILATE);
+    if (hsize == 1)
+        return rleMorphVert(rles, vsize, L_MORPH_DILATE);
+    if ((rle1 = rleMorphHoriz(rles, hsize, L_MORPH_DILATE)) == NULL)
+        return (L_RLE *)ERROR_PTR("rle1 not made", procName, NULL);
+    rled = rleMorphVert(rle1, vsize, L_MORPH_DILATE);
+    rleDestroy(&rle1);
+    return rled;
+}
+
+
+/*!
+ * \brief   rleErodeBrick()
+ *
+ * \param[in]    rles
+ * \param[in]    hsize    width of brick Sel
+ * \param[in]    vsize    height of brick Sel
+ * \return  rled, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This gives the same result as pixErodeBrick() on the
+ *          corresponding Pix, including the boundary condition
+ *          set by resetMorphBoundaryCondition().
+ * </pre>
+ */
+L_RLE *
+rleErodeBrick(L_RLE   *rles,
+              l_int32  hsize,
+              l_int32  vsize)
+{
+L_RLE  *rle1, *rled;
+
+    PROCNAME("rleErodeBrick");
+
+    if (!rles)
+        return (L_RLE *)ERROR_PTR("rles not defined", procName, NULL);
+    if (hsize < 1 || vsize < 1)
+        return (L_RLE *)ERROR_PTR("hsize and vsize not >= 1", procName, NULL);
+
+    if (hsize == 1 && vsize == 1)
+        return rleCopy(rles);
+    if (vsize == 1)
+        return rleMorphHoriz(rles, hsize, L_MORPH_ERODE);
+    if (hsize == 1)
+        return rleMorphVert(rles, vsize, L_MORPH_ERODE);
+    if ((rle1 = rleMorphHoriz(rles, hsize, L_MORPH_ERODE)) == NULL)
+        return (L_RLE *)ERROR_PTR("rle1 not made", procName, NULL);
+    rled = rleMorphVert(rle1, vsize, L_MORPH_ERODE);
+    rleDestroy(&rle1);
+    return rled;
+}
+
+
+/*!
+ * \brief   rleMorphHoriz()
+ *
+ * \param[in]    rles
+ * \param[in]    hsize    width of horizontal brick Sel
+ * \param[in]    type     L_MORPH_DILATE or L_MORPH_ERODE
+ * \return  rled, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) With the Sel origin at cx = hsize / 2, dilation maps the
+ *          run [x0, x1] to [x0 - cx, x1 + (hsize - 1 - cx)], and
+ *          erosion maps it to [x0 + cx, x1 - (hsize - 1 - cx)].
+ *      (2) For erosion with the symmetric boundary condition, the
+ *          pixels outside the image are fg, so runs that touch the
+ *          image boundary are not shrunk from that side.
+ * </pre>
+ */
+static L_RLE *
+rleMorphHoriz(L_RLE   *rles,
+              l_int32  hsize,
+              l_int32  type)
+{
+l_int32  i, k, w, h, cx, left, right, bordercolor, xa, xb;
+L_RLE   *rled;
+
+    PROCNAME("rleMorphHoriz");
+
+    w = rles->w;
+    h = rles->h;
+    cx = hsize / 2;
+    if (type == L_MORPH_DILATE) {
+        left = -cx;
+        right = hsize - 1 - cx;
+    } else {
+        left = cx;
+        right = -(hsize - 1 - cx);
+    }
+    bordercolor = getMorphBorderPixelColor(type, 1);
+
+    if ((rled = rleCreate(w, h, L_MAX(1, rles->nruns))) == NULL)
+        return (L_RLE *)ERROR_PTR("rled not made", procName, NULL);
+    for (i = 0; i < h; i++) {
+        for (k = rles->linestart[i]; k < rles->linestart[i + 1]; k++) {
+            xa = rles->x0[k] + left;
+            xb = rles->x1[k] + right;
+            if (bordercolor) {
+                if (rles->x0[k] == 0) xa = 0;
+                if (rles->x1[k] == w - 1) xb = w - 1;
+            }
+            xa = L_MAX(0, xa);
+            xb = L_MIN(w - 1, xb);
+            if (xa <= xb)
+                rleAddRun(rled, i, xa, xb);
+        }
+        rled->linestart[i + 1] = rled->nruns;
+    }
+    return rled;
+}
+
+
+/*!
+ * \brief   rleMorphVert()
+ *
+ * \param[in]    rles
+ * \param[in]    vsize    height of vertical brick Sel
+ * \param[in]    type     L_MORPH_DILATE or L_MORPH_ERODE
+ * \return  rled, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) With the Sel origin at cy = vsize / 2, line y of the result
+ *          is the OR (dilation) or AND (erosion) of a window of %vsize
+ *          lines of %rles, starting at line y - (vsize - 1 - cy) for
+ *          dilation and y - cy for erosion.
+ *      (2) The source is first embedded in a taller image, with
+ *          (vsize - 1) added lines of the border color, so that every
+ *          window is inside it.  Then the window size is doubled in
+ *          each pass until it is at least half of %vsize, and the
+ *          result is found from two overlapping windows.
+ * </pre>
+ */
+static L_RLE *
+rleMorphVert(L_RLE   *rles,
+             l_int32  vsize,
+             l_int32  type)
+{
+l_int32  i, k, y, w, h, he, cy, top, op, bordercolor, size, sa, sb, nb;
+l_int32  fullx0[1], fullx1[1];
+L_RLE   *rle1, *rle2, *rled;
+
+    PROCNAME("rleMorphVert");
+
+    w = rles->w;
+    h = rles->h;
+    he = h + vsize - 1;
+    cy = vsize / 2;
+    if (type == L_MORPH_DILATE) {
+        top = vsize - 1 - cy;
+        op = PIX_SRC | PIX_DST;
+    } else {
+        top = cy;
+        op = PIX_SRC & PIX_DST;
+    }
+    bordercolor = getMorphBorderPixelColor(type, 1);
+    fullx0[0] = 0;
+    fullx1[0] = w - 1;
+
+        /* Embed the source, with line y at line y + top */
+    rle1 = rleCreate(w, he, rles->nruns + (bordercolor ? vsize : 0) + 1);
+    if (!rle1)
+        return (L_RLE *)ERROR_PTR("rle1 not made", procName, NULL);
+    for (i = 0; i < he; i++) {
+        y = i - top;
+        if (y >= 0 && y < h) {
+            for (k = rles->linestart[y]; k < rles->linestart[y + 1]; k++)
+                rleAddRun(rle1, i, rles->x0[k], rles->x1[k]);
+        } else if (bordercolor) {
+            rleAddRun(rle1, i, 0, w - 1);
+        }
+        rle1->linestart[i + 1] = rle1->nruns;
+    }
+
+        /* After each pass, line i of rle1 is the op on the %size lines
+         * of the embedded source starting at line i.  Lines below the
+         * embedded source have the border color. */
+    for (size = 1; 2 * size <= vsize; size *= 2) {
+        if ((rle2 = rleCreate(w, he, L_MAX(1, rle1->nruns))) == NULL) {
+            rleDestroy(&rle1);
+            return (L_RLE *)ERROR_PTR("rle2 not made", procName, NULL);
+        }
+        for (i = 0; i < he; i++) {
+            sa = rle1->linestart[i];
+            if (i + size < he) {
+                sb = rle1->linestart[i + size];
+                nb = rle1->linestart[i + size + 1] - sb;
+                rleCombineLines(rle2, i, rle1->x0 + sa, rle1->x1 + sa,
+                                rle1->linestart[i + 1] - sa,
+                                rle1->x0 + sb, rle1->x1 + sb, nb, op);
+            } else {
+                rleCombineLines(rle2, i, rle1->x0 + sa, rle1->x1 + sa,
+                                rle1->linestart[i + 1] - sa,
+                                fullx0, fullx1, bordercolor, op);
+            }
+            rle2->linestart[i + 1] = rle2->nruns;
+        }
+        rleDestroy(&rle1);
+        rle1 = rle2;
+    }
+
+        /* Cover the window of %vsize lines with two windows of %size */
+    if ((rled = rleCreate(w, h, L_MAX(1, rles->nruns))) == NULL) {
+        rleDestroy(&rle1);
+        return (L_RLE *)ERROR_PTR("rled not made", procName, NULL);
+    }
+    for (i = 0; i < h; i++) {
+        sa = rle1->linestart[i];
+        sb = rle1->linestart[i + vsize - size];
+        nb = rle1->linestart[i + vsize - size + 1] - sb;
+        rleCombineLines(rled, i, rle1->x0 + sa, rle1->x1 + sa,
+                        rle1->linestart[i + 1] - sa,
+                        rle1->x0 + sb, rle1->x1 + sb, nb, op);
+        rled->linestart[i + 1] = rled->nruns;
+    }
+    rleDestroy(&rle1);
+    return rled;
+}
+
+
+/*-----------------------------------------------------------------------*
+ *                        Measurements on L_Rle                          *
+ *-----------------------------------------------------------------------*/
+/*!
+ * \brief   rleCountPixels()
+ *
+ * \param[in]    rle
+ * \param[out]   pcount    number of fg pixels
+ * \return  0 if OK, 1 on error
+ */
+l_ok
+rleCountPixels(L_RLE    *rle,
+               l_int32  *pcount)
+{
+l_int32  k, count;
+
+    PROCNAME("rleCountPixels");
+
+    if (!pcount)
+        return ERROR_INT("&count not defined", procName, 1);
+    *pcount = 0;
+    if (!rle)
+        return ERROR_INT("rle not defined", procName, 1);
+
+    count = 0;
+    for (k = 0; k < rle->nruns; k++)
+        count += rle->x1[k] - rle->x0[k] + 1;
+    *pcount = count;
+    return 0;
+}
+
+
+/*!
+ * \brief   rleFindBoundingBox()
+ *
+ * \param[in]    rle
+ * \param[out]   pbox    bounding box of the fg pixels
+ * \return  0 if OK; 1 on error or if there are no fg pixels
+ *
+ * <pre>
+ * Notes:
+ *      (1) The runs on each line are ordered, so only the first
+ *          and last run on each line are examined.
+ * </pre>
+ */
+l_ok
+rleFindBoundingBox(L_RLE  *rle,
+                   BOX   **pbox)
+{
+l_int32  i, xmin, xmax, ymin, ymax;
+
+    PROCNAME("rleFindBoundingBox");
+
+    if (!pbox)
+        return ERROR_INT("&box not defined", procName, 1);
+    *pbox = NULL;
+    if (!rle)
+        return ERROR_INT("rle not defined", procName, 1);
+    if (rle->nruns == 0)
+        return 1;
+
+    xmin = rle->w;
+    xmax = -1;
+    ymin = -1;
+    ymax = -1;
+    for (i = 0; i < rle->h; i++) {
+        if (rle->linestart[i + 1] == rle->linestart[i])
+            continue;
+        if (ymin < 0) ymin = i;
+        ymax = i;
+        xmin = L_MIN(xmin, rle->x0[rle->linestart[i]]);
+        xmax = L_MAX(xmax, rle->x1[rle->linestart[i + 1] - 1]);
+    }
+    *pbox = boxCreate(xmin, ymin, xmax - xmin + 1, ymax - ymin + 1);
+    return 0;
+}
+
+
 /*-----------------------------------------------------------------------*
  *                       Make byte position LUT                          *
  *-----------------------------------------------------------------------*/
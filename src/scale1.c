@@ -74,6 +74,11 @@
  *         Binary scaling by closest pixel sampling
  *               PIX      *pixScaleBinary()
  *
+ *         Scaling into an existing pix
+ *               PIX      *pixScaleGrayLIInto()
+ *               PIX      *pixScaleColorLIInto()
+ *               PIX      *pixScaleBySamplingInto()
+ *
  *     Low-level static functions:
  *
  *         Color (interpolated) scaling: general case
@@ -2188,6 +2193,217 @@ PIX       *pixd;
 }
 
 
+/*------------------------------------------------------------------*
+ *                   Scaling into an existing pix                   *
+ *------------------------------------------------------------------*/
+/*!
+ * \brief   pixScaleGrayLIInto()
+ *
+ * \param[in]    pixd       [optional] pix to be reused; can be null
+ * \param[in]    pixs       8 bpp grayscale, no cmap
+ * \param[in]    scalex     must be >= 0.7
+ * \param[in]    scaley     must be >= 0.7
+ * \return  pixd, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This gives the same result as pixScaleGrayLI(), written
+ *          into pixd.  If pixd is null, a new pix is made.  Otherwise
+ *          pixd is resized as required, and its image data is reused
+ *          when the size of the result does not change, so repeated
+ *          scaling of images of the same size does not allocate.
+ *          See pixReuseOrCreate().
+ *      (2) pixd cannot be the same as pixs.
+ *      (3) Unlike pixScaleGrayLI(), this does not fall back to area
+ *          mapping for scale factors less than 0.7.
+ * </pre>
+ */
+PIX *
+pixScaleGrayLIInto(PIX       *pixd,
+                   PIX       *pixs,
+                   l_float32  scalex,
+                   l_float32  scaley)
+{
+l_int32    ws, hs, wpls, wd, hd, wpld;
+l_uint32  *datas, *datad;
+PIX       *pixt;
+
+    PROCNAME("pixScaleGrayLIInto");
+
+    if (!pixs || pixGetDepth(pixs) != 8 || pixGetColormap(pixs))
+        return (PIX *)ERROR_PTR("pixs undefined, cmapped or not 8 bpp",
+                                procName, pixd);
+    if (pixd == pixs)
+        return (PIX *)ERROR_PTR("pixd == pixs", procName, pixd);
+    if (L_MAX(scalex, scaley) < 0.7)
+        return (PIX *)ERROR_PTR("scaling factors < 0.7", procName, pixd);
+    if (scalex == 1.0 && scaley == 1.0)
+        return pixCopy(pixd, pixs);
+
+    pixGetDimensions(pixs, &ws, &hs, NULL);
+    if (scalex == 2.0 && scaley == 2.0) {
+        wd = 2 * ws;
+        hd = 2 * hs;
+    } else if (scalex == 4.0 && scaley == 4.0) {
+        wd = 4 * ws;
+        hd = 4 * hs;
+    } else {
+        wd = (l_int32)(scalex * (l_float32)ws + 0.5);
+        hd = (l_int32)(scaley * (l_float32)hs + 0.5);
+    }
+    if ((pixt = pixReuseOrCreate(pixd, wd, hd, 8)) == NULL)
+        return (PIX *)ERROR_PTR("pixd not made", procName, pixd);
+    pixd = pixt;
+    pixCopyText(pixd, pixs);
+    pixCopyResolution(pixd, pixs);
+    pixCopyInputFormat(pixd, pixs);
+    pixScaleResolution(pixd, scalex, scaley);
+    datas = pixGetData(pixs);
+    wpls = pixGetWpl(pixs);
+    datad = pixGetData(pixd);
+    wpld = pixGetWpl(pixd);
+    if (scalex == 2.0 && scaley == 2.0)
+        scaleGray2xLILow(datad, wpld, datas, ws, hs, wpls);
+    else if (scalex == 4.0 && scaley == 4.0)
+        scaleGray4xLILow(datad, wpld, datas, ws, hs, wpls);
+    else
+        scaleGrayLILow(datad, wd, hd, wpld, datas, ws, hs, wpls);
+    return pixd;
+}
+
+
+/*!
+ * \brief   pixScaleColorLIInto()
+ *
+ * \param[in]    pixd       [optional] pix to be reused; can be null
+ * \param[in]    pixs       32 bpp, representing rgb
+ * \param[in]    scalex     must be >= 0.7
+ * \param[in]    scaley     must be >= 0.7
+ * \return  pixd, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This is pixScaleColorLI(), written into pixd.  See the notes
+ *          in pixScaleGrayLIInto().
+ *      (2) The special case of 4x expansion uses the general method,
+ *          because pixScaleColor4xLI() scales each component separately.
+ *      (3) With an alpha channel, the scaling of the alpha component
+ *          makes temporary pix.
+ * </pre>
+ */
+PIX *
+pixScaleColorLIInto(PIX       *pixd,
+                    PIX       *pixs,
+                    l_float32  scalex,
+                    l_float32  scaley)
+{
+l_int32    ws, hs, wpls, wd, hd, wpld;
+l_uint32  *datas, *datad;
+PIX       *pixt;
+
+    PROCNAME("pixScaleColorLIInto");
+
+    if (!pixs || (pixGetDepth(pixs) != 32))
+        return (PIX *)ERROR_PTR("pixs undefined or not 32 bpp",
+                                procName, pixd);
+    if (pixd == pixs)
+        return (PIX *)ERROR_PTR("pixd == pixs", procName, pixd);
+    if (L_MAX(scalex, scaley) < 0.7)
+        return (PIX *)ERROR_PTR("scaling factors < 0.7", procName, pixd);
+    if (scalex == 1.0 && scaley == 1.0)
+        return pixCopy(pixd, pixs);
+
+    pixGetDimensions(pixs, &ws, &hs, NULL);
+    if (scalex == 2.0 && scaley == 2.0) {
+        wd = 2 * ws;
+        hd = 2 * hs;
+    } else {
+        wd = (l_int32)(scalex * (l_float32)ws + 0.5);
+        hd = (l_int32)(scaley * (l_float32)hs + 0.5);
+    }
+    if ((pixt = pixReuseOrCreate(pixd, wd, hd, 32)) == NULL)
+        return (PIX *)ERROR_PTR("pixd not made", procName, pixd);
+    pixd = pixt;
+    pixCopyResolution(pixd, pixs);
+    pixCopyInputFormat(pixd, pixs);
+    pixScaleResolution(pixd, scalex, scaley);
+    datas = pixGetData(pixs);
+    wpls = pixGetWpl(pixs);
+    datad = pixGetData(pixd);
+    wpld = pixGetWpl(pixd);
+    if (scalex == 2.0 && scaley == 2.0)
+        scaleColor2xLILow(datad, wpld, datas, ws, hs, wpls);
+    else
+        scaleColorLILow(datad, wd, hd, wpld, datas, ws, hs, wpls);
+    if (pixGetSpp(pixs) == 4)
+        pixScaleAndTransferAlpha(pixd, pixs, scalex, scaley);
+    return pixd;
+}
+
+
+/*!
+ * \brief   pixScaleBySamplingInto()
+ *
+ * \param[in]    pixd       [optional] pix to be reused; can be null
+ * \param[in]    pixs       1, 2, 4, 8, 16, 32 bpp
+ * \param[in]    scalex     must be > 0.0
+ * \param[in]    scaley     must be > 0.0
+ * \return  pixd, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This is pixScaleBySampling(), written into pixd.  See the
+ *          notes in pixScaleGrayLIInto().
+ * </pre>
+ */
+PIX *
+pixScaleBySamplingInto(PIX       *pixd,
+                       PIX       *pixs,
+                       l_float32  scalex,
+                       l_float32  scaley)
+{
+l_int32    ws, hs, d, wpls, wd, hd, wpld;
+l_uint32  *datas, *datad;
+PIX       *pixt;
+
+    PROCNAME("pixScaleBySamplingInto");
+
+    if (!pixs)
+        return (PIX *)ERROR_PTR("pixs not defined", procName, pixd);
+    if (pixd == pixs)
+        return (PIX *)ERROR_PTR("pixd == pixs", procName, pixd);
+    if (scalex <= 0.0 || scaley <= 0.0)
+        return (PIX *)ERROR_PTR("scale factor <= 0", procName, pixd);
+    if (scalex == 1.0 && scaley == 1.0)
+        return pixCopy(pixd, pixs);
+
+    pixGetDimensions(pixs, &ws, &hs, &d);
+    wd = (l_int32)(scalex * (l_float32)ws + 0.5);
+    hd = (l_int32)(scaley * (l_float32)hs + 0.5);
+    if ((pixt = pixReuseOrCreate(pixd, wd, hd, d)) == NULL)
+        return (PIX *)ERROR_PTR("pixd not made", procName, pixd);
+    pixd = pixt;
+    pixCopyResolution(pixd, pixs);
+    pixScaleResolution(pixd, scalex, scaley);
+    pixCopyColormap(pixd, pixs);
+    pixCopyText(pixd, pixs);
+    pixCopyInputFormat(pixd, pixs);
+    pixCopySpp(pixd, pixs);
+    datas = pixGetData(pixs);
+    wpls = pixGetWpl(pixs);
+    datad = pixGetData(pixd);
+    wpld = pixGetWpl(pixd);
+    if (d == 1) {
+        scaleBinaryLow(datad, wd, hd, wpld, datas, ws, hs, wpls);
+    } else {
+        scaleBySamplingLow(datad, wd, hd, wpld, datas, ws, hs, d, wpls);
+        if (d == 32 && pixGetSpp(pixs) == 4)
+            pixScaleAndTransferAlpha(pixd, pixs, scalex, scaley);
+    }
+    return pixd;
+}
+
+
 /* ================================================================ *
  *                    Low level static functions                    *
  * ================================================================ */
@@ -38,6 +38,7 @@
  *               PIX      *pixScaleToGray6()
  *               PIX      *pixScaleToGray8()
  *               PIX      *pixScaleToGray16()
+ *               PIX      *pixScaleToGrayInto()
  *
  *         Scale-to-gray by mipmap(1 bpp --> 8 bpp, arbitrary reduction)
  *               PIX      *pixScaleToGrayMipmap()
@@ -684,6 +685,120 @@ PIX       *pixd;
 }
 
 
+/*!
+ * \brief   pixScaleToGrayInto()
+ *
+ * \param[in]    pixd     [optional] pix to be reused; can be null
+ * \param[in]    pixs     1 bpp
+ * \param[in]    factor   reduction factor: 2, 3, 4, 6, 8 or 16
+ * \return  pixd 8 bpp, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This gives the same result as pixScaleToGray2() ...
+ *          pixScaleToGray16(), written into pixd.  If pixd is null,
+ *          a new pix is made.  Otherwise pixd is resized as required,
+ *          and its image data is reused when the size of the result
+ *          does not change.  See pixReuseOrCreate().
+ *      (2) pixd cannot be the same as pixs.
+ * </pre>
+ */
+PIX *
+pixScaleToGrayInto(PIX     *pixd,
+                   PIX     *pixs,
+                   l_int32  factor)
+{
+l_uint8   *valtab;
+l_int32    ws, hs, wd, hd, wpld, wpls;
+l_int32   *tab8;
+l_uint32  *sumtab;
+l_uint32  *datas, *datad;
+PIX       *pixt;
+
+    PROCNAME("pixScaleToGrayInto");
+
+    if (!pixs)
+        return (PIX *)ERROR_PTR("pixs not defined", procName, pixd);
+    if (pixGetDepth(pixs) != 1)
+        return (PIX *)ERROR_PTR("pixs must be 1 bpp", procName, pixd);
+    if (pixd == pixs)
+        return (PIX *)ERROR_PTR("pixd == pixs", procName, pixd);
+
+        /* The width is truncated as in the corresponding functions */
+    pixGetDimensions(pixs, &ws, &hs, NULL);
+    wd = ws / factor;
+    hd = hs / factor;
+    switch (factor) {
+    case 2:
+    case 8:
+    case 16:
+        break;
+    case 3:
+    case 6:
+        wd &= 0xfffffff8;
+        break;
+    case 4:
+        wd &= 0xfffffffe;
+        break;
+    default:
+        return (PIX *)ERROR_PTR("invalid factor", procName, pixd);
+    }
+    if (wd == 0 || hd == 0)
+        return (PIX *)ERROR_PTR("pixs too small", procName, pixd);
+
+    if ((pixt = pixReuseOrCreate(pixd, wd, hd, 8)) == NULL)
+        return (PIX *)ERROR_PTR("pixd not made", procName, pixd);
+    pixd = pixt;
+    pixCopyInputFormat(pixd, pixs);
+    pixCopyResolution(pixd, pixs);
+    pixScaleResolution(pixd, 1.0 / factor, 1.0 / factor);
+    datas = pixGetData(pixs);
+    datad = pixGetData(pixd);
+    wpls = pixGetWpl(pixs);
+    wpld = pixGetWpl(pixd);
+
+    sumtab = NULL;
+    valtab = NULL;
+    tab8 = NULL;
+    switch (factor) {
+    case 2:
+        sumtab = makeSumTabSG2();
+        valtab = makeValTabSG2();
+        scaleToGray2Low(datad, wd, hd, wpld, datas, wpls, sumtab, valtab);
+        break;
+    case 3:
+        sumtab = makeSumTabSG3();
+        valtab = makeValTabSG3();
+        scaleToGray3Low(datad, wd, hd, wpld, datas, wpls, sumtab, valtab);
+        break;
+    case 4:
+        sumtab = makeSumTabSG4();
+        valtab = makeValTabSG4();
+        scaleToGray4Low(datad, wd, hd, wpld, datas, wpls, sumtab, valtab);
+        break;
+    case 6:
+        tab8 = makePixelSumTab8();
+        valtab = makeValTabSG6();
+        scaleToGray6Low(datad, wd, hd, wpld, datas, wpls, tab8, valtab);
+        break;
+    case 8:
+        tab8 = makePixelSumTab8();
+        valtab = makeValTabSG8();
+        scaleToGray8Low(datad, wd, hd, wpld, datas, wpls, tab8, valtab);
+        break;
+    default:  /* 16 */
+        tab8 = makePixelSumTab8();
+        scaleToGray16Low(datad, wd, hd, wpld, datas, wpls, tab8);
+        break;
+    }
+
+    LEPT_FREE(sumtab);
+    LEPT_FREE(valtab);
+    LEPT_FREE(tab8);
+    return pixd;
+}
+
+
 /*------------------------------------------------------------------*
  *    Scale-to-gray mipmap(1 bpp --> 8 bpp, arbitrary reduction)    *
  *------------------------------------------------------------------*/
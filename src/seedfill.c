@@ -32,6 +32,7 @@
  *               PIX         *pixSeedfillBinary()
  *               PIX         *pixSeedfillBinaryRestricted()
  *               static void  seedfillBinaryLow()
+ *               static l_int32  seedfillBinaryQueueLow()
  *
  *      Applications of binary seedfill to find and fill holes,
  *      remove c.c. touching the border and fill bg from border:
@@ -47,9 +48,8 @@
  *      Gray seedfill (source: Luc Vincent:fast-hybrid-grayscale-reconstruction)
  *               l_int32      pixSeedfillGray()
  *               l_int32      pixSeedfillGrayInv()
- *               static void  seedfillGrayLow()
- *               static void  seedfillGrayInvLow()
-
+ *               static l_int32  seedfillGrayLow()
+ *               static l_int32  seedfillGrayInvLow()
  *
  *      Gray seedfill (source: Luc Vincent: sequential-reconstruction algorithm)
  *               l_int32      pixSeedfillGraySimple()
@@ -68,6 +68,12 @@
  *               PIX         *pixSeedspread()
  *               static void  seedspreadLow()
  *
+ *      Exact Euclidean distance function (source: Felzenszwalb/Huttenlocher)
+ *               PIX         *pixEuclideanDistance()
+ *               FPIX        *pixEuclideanDistanceFPix()
+ *               PIX         *pixSeedspreadEuclidean()
+ *               static l_int32  euclideanDistanceLow()
+ *
  *      Local extrema:
  *               l_int32      pixLocalExtrema()
  *            static l_int32  pixQualifyLocalMinima()
@@ -96,7 +102,12 @@
  *      in most situations to use the 4-connected version.)
  *      The algorithm proceeds from UR to LL of the image, and
  *      then reverses and sweeps up from LL to UR.
- *      These double sweeps are iterated until there is no change.
+ *      These double sweeps could be iterated until there is no change,
+ *      but for regions that wind back and forth the number of sweeps
+ *      is unbounded.  Instead, we use Vincent's hybrid method: after
+ *      a single pair of sweeps, every pixel that can still be filled
+ *      from an ON neighbor is put on a FIFO queue, and the fill is
+ *      completed by breadth-first propagation from the queue.
  *      At this point, the seed has entirely filled the region it
  *      is allowed to, as delimited by the mask image.
  *
@@ -167,22 +178,19 @@
 #include <math.h>
 #include "allheaders.h"
 
-struct L_Pixel
-{
-    l_int32    x;
-    l_int32    y;
-};
-typedef struct L_Pixel  L_PIXEL;
-
 static void seedfillBinaryLow(l_uint32 *datas, l_int32 hs, l_int32 wpls,
                               l_uint32 *datam, l_int32 hm, l_int32 wplm,
                               l_int32 connectivity);
-static void seedfillGrayLow(l_uint32 *datas, l_int32 w, l_int32 h,
-                            l_int32 wpls, l_uint32 *datam, l_int32 wplm,
-                            l_int32 connectivity);
-static void seedfillGrayInvLow(l_uint32 *datas, l_int32 w, l_int32 h,
+static l_int32 seedfillBinaryQueueLow(l_uint32 *datas, l_int32 hs,
+                                      l_int32 wpls, l_uint32 *datam,
+                                      l_int32 hm, l_int32 wplm,
+                                      l_int32 connectivity);
+static l_int32 seedfillGrayLow(l_uint32 *datas, l_int32 w, l_int32 h,
                                l_int32 wpls, l_uint32 *datam, l_int32 wplm,
                                l_int32 connectivity);
+static l_int32 seedfillGrayInvLow(l_uint32 *datas, l_int32 w, l_int32 h,
+                                  l_int32 wpls, l_uint32 *datam, l_int32 wplm,
+                                  l_int32 connectivity);
 static void seedfillGrayLowSimple(l_uint32 *datas, l_int32 w, l_int32 h,
                                   l_int32 wpls, l_uint32 *datam, l_int32 wplm,
                                   l_int32 connectivity);
@@ -193,6 +201,8 @@ static void distanceFunctionLow(l_uint32 *datad, l_int32 w, l_int32 h,
                                 l_int32 d, l_int32 wpld, l_int32 connectivity);
 static void seedspreadLow(l_uint32 *datad, l_int32 w, l_int32 h, l_int32 wpld,
                           l_uint32 *datat, l_int32 wplt, l_int32 connectivity);
+static l_int32 euclideanDistanceLow(PIX *pixs, l_int32 boundcond,
+                                    l_uint32 *datad, l_int32 *nearest);
 
 
 static l_int32 pixQualifyLocalMinima(PIX *pixs, PIX *pixm, l_int32 maxval);
@@ -201,7 +211,8 @@ static l_int32 pixQualifyLocalMinima(PIX *pixs, PIX *pixm, l_int32 maxval);
 #define   DEBUG_PRINT_ITERS    0
 #endif  /* ~NO_CONSOLE_IO */
 
-  /* Two-way (UL --> LR, LR --> UL) sweep iterations; typically need only 4 */
+  /* Two-way (UL --> LR, LR --> UL) sweep iterations for the simple
+   * grayscale seedfills; typically need only 4 */
 static const l_int32  MaxIters = 40;
 
 
@@ -216,7 +227,7 @@ static const l_int32  MaxIters = 40;
  * \param[in]    pixs          1 bpp seed
  * \param[in]    pixm          1 bpp filling mask
  * \param[in]    connectivity  4 or 8
- * \return  pixd always
+ * \return  pixd always, except NULL if the fill can't be completed
  *
  * <pre>
  * Notes:
@@ -235,8 +246,16 @@ static const l_int32  MaxIters = 40;
  *      (5) The input seed and mask images can be different sizes, but
  *          in typical use the difference, if any, would be only
  *          a few pixels in each direction.  If the sizes differ,
- *          the clipping is handled by the low-level function
- *          seedfillBinaryLow().
+ *          the clipping is handled by the low-level functions
+ *          seedfillBinaryLow() and seedfillBinaryQueueLow().
+ *      (6) This uses the hybrid method: one raster and one anti-raster
+ *          sweep on 32-bit words, followed by breadth-first propagation
+ *          from the pixels that can still be filled.  Unlike iterating
+ *          the sweeps until there is no change, the amount of work
+ *          does not depend on how many times the region winds back
+ *          and forth, and the fill always runs to completion.
+ *      (7) If the propagation queue can't be enlarged, an error is
+ *          returned: NULL, and a new pixd is destroyed.
  * </pre>
  */
 PIX *
@@ -245,10 +264,9 @@ pixSeedfillBinary(PIX     *pixd,
                   PIX     *pixm,
                   l_int32  connectivity)
 {
-l_int32    i, boolval;
-l_int32    hd, hm, wpld, wplm;
+l_int32    hd, hm, wpld, wplm, ret;
 l_uint32  *datad, *datam;
-PIX       *pixt;
+PIX       *pixdin, *pixmc;
 
     PROCNAME("pixSeedfillBinary");
 
@@ -260,35 +278,34 @@ PIX       *pixt;
         return (PIX *)ERROR_PTR("connectivity not in {4,8}", procName, pixd);
 
         /* Prepare pixd as a copy of pixs if not identical */
+    pixdin = pixd;
     if ((pixd = pixCopy(pixd, pixs)) == NULL)
         return (PIX *)ERROR_PTR("pixd not made", procName, NULL);
 
-        /* pixt is used to test for completion */
-    if ((pixt = pixCreateTemplate(pixs)) == NULL)
-        return (PIX *)ERROR_PTR("pixt not made", procName, pixd);
+        /* The pad bits of the mask must be 0.  In a view, they are
+         * pixels of the parent, so the view is copied. */
+    if (pixIsView(pixm))
+        pixmc = pixCopy(NULL, pixm);
+    else
+        pixmc = pixClone(pixm);
+    pixSetPadBits(pixmc, 0);
 
     hd = pixGetHeight(pixd);
-    hm = pixGetHeight(pixm);  /* included so seedfillBinaryLow() can clip */
+    hm = pixGetHeight(pixmc);  /* included so the low-level functions clip */
     datad = pixGetData(pixd);
-    datam = pixGetData(pixm);
+    datam = pixGetData(pixmc);
     wpld = pixGetWpl(pixd);
-    wplm = pixGetWpl(pixm);
-
-    pixSetPadBits(pixm, 0);
-
-    for (i = 0; i < MaxIters; i++) {
-        pixCopy(pixt, pixd);
-        seedfillBinaryLow(datad, hd, wpld, datam, hm, wplm, connectivity);
-        pixEqual(pixd, pixt, &boolval);
-        if (boolval == 1) {
-#if DEBUG_PRINT_ITERS
-            fprintf(stderr, "Binary seed fill converged: %d iters\n", i + 1);
-#endif  /* DEBUG_PRINT_ITERS */
-            break;
-        }
+    wplm = pixGetWpl(pixmc);
+
+    seedfillBinaryLow(datad, hd, wpld, datam, hm, wplm, connectivity);
+    ret = seedfillBinaryQueueLow(datad, hd, wpld, datam, hm, wplm,
+                                 connectivity);
+    pixDestroy(&pixmc);
+    if (ret) {
+        if (pixd != pixdin)
+            pixDestroy(&pixd);
+        return (PIX *)ERROR_PTR("fill not completed", procName, NULL);
     }
-
-    pixDestroy(&pixt);
     return pixd;
 }
 
@@ -578,6 +595,135 @@ l_uint32  *lines, *linem;
     }
 }
 
+/*!
+ * \brief   seedfillBinaryQueueLow()
+ *
+ *  Notes:
+ *      (1) This completes an in-place fill that has been started with
+ *          one cycle of seedfillBinaryLow().  Every OFF pixel in the
+ *          filling mask that has an ON neighbor in the seed is turned
+ *          on and put on a FIFO queue.  These are found a word at a
+ *          time.  Then the fill is propagated breadth-first from the
+ *          queue, one pixel at a time.
+ *      (2) After the raster sweeps, few pixels are usually queued,
+ *          so the extra cost over one cycle of seedfillBinaryLow()
+ *          is small.  However, the queue allows the fill to reach
+ *          the end of regions that wind back and forth, each of
+ *          which would otherwise require another cycle of sweeps.
+ *      (3) Assume the mask is a filling mask, and that its RHS pad
+ *          bits are properly set to 0.
+ *      (4) Clip to the smallest dimensions to avoid invalid reads.
+ *      (5) Returns 0 if OK, 1 on error.  If a pixel can't be queued,
+ *          the fill is incomplete and this returns 1.
+ */
+static l_int32
+seedfillBinaryQueueLow(l_uint32  *datas,
+                       l_int32    hs,
+                       l_int32    wpls,
+                       l_uint32  *datam,
+                       l_int32    hm,
+                       l_int32    wplm,
+                       l_int32    connectivity)
+{
+l_int32       i, j, k, b, h, wpl, imax, jmax, ni, nj, di, dj, ret;
+l_uint32      word, grow, wordabove, wordbelow;
+l_uint32     *lines, *linem;
+L_PAIRQUEUE  *lpq;
+
+    PROCNAME("seedfillBinaryQueueLow");
+
+    if (connectivity != 4 && connectivity != 8)
+        return ERROR_INT("connectivity must be 4 or 8", procName, 1);
+
+    h = L_MIN(hs, hm);
+    wpl = L_MIN(wpls, wplm);
+    imax = h - 1;
+    jmax = 32 * wpl - 1;
+    if ((lpq = lpairqueueCreate(2 * (32 * wpl + h))) == NULL)
+        return ERROR_INT("lpq not made", procName, 1);
+    ret = 1;
+
+        /* Turn on and queue all OFF pixels under the mask that have
+         * an ON neighbor.  For 8-connectivity, the words above and
+         * below are dilated horizontally before they are used. */
+    for (i = 0; i < h; i++) {
+        lines = datas + i * wpls;
+        linem = datam + i * wplm;
+        for (k = 0; k < wpl; k++) {
+            word = *(lines + k);
+            grow = word | (word >> 1) | (word << 1);
+            if (k > 0)
+                grow |= *(lines + k - 1) << 31;
+            if (k < wpl - 1)
+                grow |= *(lines + k + 1) >> 31;
+            if (i > 0) {
+                wordabove = *(lines - wpls + k);
+                if (connectivity == 8) {
+                    wordabove |= (wordabove >> 1) | (wordabove << 1);
+                    if (k > 0)
+                        wordabove |= *(lines - wpls + k - 1) << 31;
+                    if (k < wpl - 1)
+                        wordabove |= *(lines - wpls + k + 1) >> 31;
+                }
+                grow |= wordabove;
+            }
+            if (i < imax) {
+                wordbelow = *(lines + wpls + k);
+                if (connectivity == 8) {
+                    wordbelow |= (wordbelow >> 1) | (wordbelow << 1);
+                    if (k > 0)
+                        wordbelow |= *(lines + wpls + k - 1) << 31;
+                    if (k < wpl - 1)
+                        wordbelow |= *(lines + wpls + k + 1) >> 31;
+                }
+                grow |= wordbelow;
+            }
+            grow &= *(linem + k) & ~word;
+            if (!grow)
+                continue;
+            *(lines + k) = word | grow;
+            for (b = 0; b < 32; b++) {
+                if ((grow & (0x80000000 >> b)) &&
+                    lpairqueueAdd(lpq, i, 32 * k + b))
+                    goto cleanup_queue;
+            }
+        }
+    }
+
+        /* Propagation step: turn on and queue each OFF neighbor
+         * under the mask of the pixels taken from the queue */
+    while (lpairqueueGetCount(lpq) > 0) {
+        lpairqueueRemove(lpq, &i, &j);
+        for (di = -1; di <= 1; di++) {
+            ni = i + di;
+            if (ni < 0 || ni > imax)
+                continue;
+            lines = datas + ni * wpls;
+            linem = datam + ni * wplm;
+            for (dj = -1; dj <= 1; dj++) {
+                if ((di == 0 && dj == 0) ||
+                    (connectivity == 4 && di != 0 && dj != 0))
+                    continue;
+                nj = j + dj;
+                if (nj < 0 || nj > jmax)
+                    continue;
+                if (GET_DATA_BIT(linem, nj) && !GET_DATA_BIT(lines, nj)) {
+                    SET_DATA_BIT(lines, nj);
+                    if (lpairqueueAdd(lpq, ni, nj))
+                        goto cleanup_queue;
+                }
+            }
+        }
+    }
+
+    ret = 0;
+
+cleanup_queue:
+    lpairqueueDestroy(&lpq);
+    return ret;
+}
+
+
 
 /*!
  * \brief   pixHolesByFilling()
@@ -944,8 +1090,8 @@ l_uint32  *datas, *datam;
     wpls = pixGetWpl(pixs);
     wplm = pixGetWpl(pixm);
     pixGetDimensions(pixs, &w, &h, NULL);
-    seedfillGrayLow(datas, w, h, wpls, datam, wplm, connectivity);
-
+    if (seedfillGrayLow(datas, w, h, wpls, datam, wplm, connectivity))
+        return ERROR_INT("fill not completed", procName, 1);
     return 0;
 }
 
@@ -1003,8 +1149,8 @@ l_uint32  *datas, *datam;
     wpls = pixGetWpl(pixs);
     wplm = pixGetWpl(pixm);
     pixGetDimensions(pixs, &w, &h, NULL);
-    seedfillGrayInvLow(datas, w, h, wpls, datam, wplm, connectivity);
-
+    if (seedfillGrayInvLow(datas, w, h, wpls, datam, wplm, connectivity))
+        return ERROR_INT("fill not completed", procName, 1);
     return 0;
 }
 
@@ -1053,8 +1199,10 @@ l_uint32  *datas, *datam;
  *            L. Vincent, Morphological grayscale reconstruction in image
  *            analysis: applications and efficient algorithms, IEEE Transactions
  *            on  Image Processing, vol. 2, no. 2, pp. 176-201, 1993.
+ *      (4) Returns 0 if OK, 1 on error.  If a pixel can't be queued,
+ *          the fill is incomplete and this returns 1.
  */
-static void
+static l_int32
 seedfillGrayLow(l_uint32  *datas,
                 l_int32    w,
                 l_int32    h,
@@ -1063,19 +1211,16 @@ seedfillGrayLow(l_uint32  *datas,
                 l_int32    wplm,
                 l_int32    connectivity)
 {
-l_uint8    val1, val2, val3, val4, val5, val6, val7, val8;
-l_uint8    val, maxval, maskval, boolval;
-l_int32    i, j, imax, jmax, queue_size;
-l_uint32  *lines, *linem;
-L_PIXEL *pixel;
-L_QUEUE  *lq_pixel;
+l_uint8       val1, val2, val3, val4, val5, val6, val7, val8;
+l_uint8       val, maxval, maskval, boolval;
+l_int32       i, j, imax, jmax, ret;
+l_uint32     *lines, *linem;
+L_PAIRQUEUE  *lpq;
 
     PROCNAME("seedfillGrayLow");
 
-    if (connectivity != 4 && connectivity != 8) {
-        L_ERROR("connectivity must be 4 or 8\n", procName);
-        return;
-    }
+    if (connectivity != 4 && connectivity != 8)
+        return ERROR_INT("connectivity must be 4 or 8", procName, 1);
 
     imax = h - 1;
     jmax = w - 1;
@@ -1084,7 +1229,9 @@ L_QUEUE  *lq_pixel;
          * onto the FIFO queue during anti-raster scan.  However this
          * will rarely happen, and we initialize the queue ptr size to
          * the image perimeter. */
-    lq_pixel = lqueueCreate(2 * (w + h));
+    if ((lpq = lpairqueueCreate(2 * (w + h))) == NULL)
+        return ERROR_INT("lpq not made", procName, 1);
+    ret = 1;
 
     switch (connectivity)
     {
@@ -1157,10 +1304,8 @@ L_QUEUE  *lq_pixel;
                         }
                     }
                     if (boolval) {
-                        pixel = (L_PIXEL *)LEPT_CALLOC(1, sizeof(L_PIXEL));
-                        pixel->x = i;
-                        pixel->y = j;
-                        lqueueAdd(lq_pixel, pixel);
+                        if (lpairqueueAdd(lpq, i, j))
+                            goto cleanup_queue;
                     }
                 }
             }
@@ -1176,12 +1321,8 @@ L_QUEUE  *lq_pixel;
              *            end
              *          end
              *        end */
-        queue_size = lqueueGetCount(lq_pixel);
-        while (queue_size) {
-            pixel = (L_PIXEL *)lqueueRemove(lq_pixel);
-            i = pixel->x;
-            j = pixel->y;
-            LEPT_FREE(pixel);
+        while (lpairqueueGetCount(lpq) > 0) {
+            lpairqueueRemove(lpq, &i, &j);
             lines = datas + i * wpls;
             linem = datam + i * wplm;
 
@@ -1191,10 +1332,8 @@ L_QUEUE  *lq_pixel;
                     maskval = GET_DATA_BYTE(linem - wplm, j);
                     if (val > val2 && val2 != maskval) {
                         SET_DATA_BYTE(lines - wpls, j, L_MIN(val, maskval));
-                        pixel = (L_PIXEL *)LEPT_CALLOC(1, sizeof(L_PIXEL));
-                        pixel->x = i - 1;
-                        pixel->y = j;
-                        lqueueAdd(lq_pixel, pixel);
+                        if (lpairqueueAdd(lpq, i - 1, j))
+                            goto cleanup_queue;
                     }
 
                 }
@@ -1203,10 +1342,8 @@ L_QUEUE  *lq_pixel;
                     maskval = GET_DATA_BYTE(linem, j - 1);
                     if (val > val4 && val4 != maskval) {
                         SET_DATA_BYTE(lines, j - 1, L_MIN(val, maskval));
-                        pixel = (L_PIXEL *)LEPT_CALLOC(1, sizeof(L_PIXEL));
-                        pixel->x = i;
-                        pixel->y = j - 1;
-                        lqueueAdd(lq_pixel, pixel);
+                        if (lpairqueueAdd(lpq, i, j - 1))
+                            goto cleanup_queue;
                     }
                 }
                 if (i < imax) {
@@ -1214,10 +1351,8 @@ L_QUEUE  *lq_pixel;
                     maskval = GET_DATA_BYTE(linem + wplm, j);
                     if (val > val7 && val7 != maskval) {
                         SET_DATA_BYTE(lines + wpls, j, L_MIN(val, maskval));
-                        pixel = (L_PIXEL *)LEPT_CALLOC(1, sizeof(L_PIXEL));
-                        pixel->x = i + 1;
-                        pixel->y = j;
-                        lqueueAdd(lq_pixel, pixel);
+                        if (lpairqueueAdd(lpq, i + 1, j))
+                            goto cleanup_queue;
                     }
                 }
                 if (j < jmax) {
@@ -1225,15 +1360,11 @@ L_QUEUE  *lq_pixel;
                     maskval = GET_DATA_BYTE(linem, j + 1);
                     if (val > val5 && val5 != maskval) {
                         SET_DATA_BYTE(lines, j + 1, L_MIN(val, maskval));
-                        pixel = (L_PIXEL *)LEPT_CALLOC(1, sizeof(L_PIXEL));
-                        pixel->x = i;
-                        pixel->y = j + 1;
-                        lqueueAdd(lq_pixel, pixel);
+                        if (lpairqueueAdd(lpq, i, j + 1))
+                            goto cleanup_queue;
                     }
                 }
             }
-
-            queue_size = lqueueGetCount(lq_pixel);
         }
 
         break;
@@ -1337,10 +1468,8 @@ L_QUEUE  *lq_pixel;
                         }
                     }
                     if (boolval) {
-                        pixel = (L_PIXEL *)LEPT_CALLOC(1, sizeof(L_PIXEL));
-                        pixel->x = i;
-                        pixel->y = j;
-                        lqueueAdd(lq_pixel, pixel);
+                        if (lpairqueueAdd(lpq, i, j))
+                            goto cleanup_queue;
                     }
                 }
             }
@@ -1356,12 +1485,8 @@ L_QUEUE  *lq_pixel;
              *            end
              *          end
              *        end */
-        queue_size = lqueueGetCount(lq_pixel);
-        while (queue_size) {
-            pixel = (L_PIXEL *)lqueueRemove(lq_pixel);
-            i = pixel->x;
-            j = pixel->y;
-            LEPT_FREE(pixel);
+        while (lpairqueueGetCount(lpq) > 0) {
+            lpairqueueRemove(lpq, &i, &j);
             lines = datas + i * wpls;
             linem = datam + i * wplm;
 
@@ -1373,10 +1498,8 @@ L_QUEUE  *lq_pixel;
                         if (val > val1 && val1 != maskval) {
                             SET_DATA_BYTE(lines - wpls, j - 1,
                                           L_MIN(val, maskval));
-                            pixel = (L_PIXEL *)LEPT_CALLOC(1, sizeof(L_PIXEL));
-                            pixel->x = i - 1;
-                            pixel->y = j - 1;
-                            lqueueAdd(lq_pixel, pixel);
+                            if (lpairqueueAdd(lpq, i - 1, j - 1))
+                                goto cleanup_queue;
                         }
                     }
                     if (j < jmax) {
@@ -1385,20 +1508,16 @@ L_QUEUE  *lq_pixel;
                         if (val > val3 && val3 != maskval) {
                             SET_DATA_BYTE(lines - wpls, j + 1,
                                           L_MIN(val, maskval));
-                            pixel = (L_PIXEL *)LEPT_CALLOC(1, sizeof(L_PIXEL));
-                            pixel->x = i - 1;
-                            pixel->y = j + 1;
-                            lqueueAdd(lq_pixel, pixel);
+                            if (lpairqueueAdd(lpq, i - 1, j + 1))
+                                goto cleanup_queue;
                         }
                     }
                     val2 = GET_DATA_BYTE(lines - wpls, j);
                     maskval = GET_DATA_BYTE(linem - wplm, j);
                     if (val > val2 && val2 != maskval) {
                         SET_DATA_BYTE(lines - wpls, j, L_MIN(val, maskval));
-                        pixel = (L_PIXEL *)LEPT_CALLOC(1, sizeof(L_PIXEL));
-                        pixel->x = i - 1;
-                        pixel->y = j;
-                        lqueueAdd(lq_pixel, pixel);
+                        if (lpairqueueAdd(lpq, i - 1, j))
+                            goto cleanup_queue;
                     }
 
                 }
@@ -1407,10 +1526,8 @@ L_QUEUE  *lq_pixel;
                     maskval = GET_DATA_BYTE(linem, j - 1);
                     if (val > val4 && val4 != maskval) {
                         SET_DATA_BYTE(lines, j - 1, L_MIN(val, maskval));
-                        pixel = (L_PIXEL *)LEPT_CALLOC(1, sizeof(L_PIXEL));
-                        pixel->x = i;
-                        pixel->y = j - 1;
-                        lqueueAdd(lq_pixel, pixel);
+                        if (lpairqueueAdd(lpq, i, j - 1))
+                            goto cleanup_queue;
                     }
                 }
                 if (i < imax) {
@@ -1420,10 +1537,8 @@ L_QUEUE  *lq_pixel;
                         if (val > val6 && val6 != maskval) {
                             SET_DATA_BYTE(lines + wpls, j - 1,
                                           L_MIN(val, maskval));
-                            pixel = (L_PIXEL *)LEPT_CALLOC(1, sizeof(L_PIXEL));
-                            pixel->x = i + 1;
-                            pixel->y = j - 1;
-                            lqueueAdd(lq_pixel, pixel);
+                            if (lpairqueueAdd(lpq, i + 1, j - 1))
+                                goto cleanup_queue;
                         }
                     }
                     if (j < jmax) {
@@ -1432,20 +1547,16 @@ L_QUEUE  *lq_pixel;
                         if (val > val8 && val8 != maskval) {
                             SET_DATA_BYTE(lines + wpls, j + 1,
                                           L_MIN(val, maskval));
-                            pixel = (L_PIXEL *)LEPT_CALLOC(1, sizeof(L_PIXEL));
-                            pixel->x = i + 1;
-                            pixel->y = j + 1;
-                            lqueueAdd(lq_pixel, pixel);
+                            if (lpairqueueAdd(lpq, i + 1, j + 1))
+                                goto cleanup_queue;
                         }
                     }
                     val7 = GET_DATA_BYTE(lines + wpls, j);
                     maskval = GET_DATA_BYTE(linem + wplm, j);
                     if (val > val7 && val7 != maskval) {
                         SET_DATA_BYTE(lines + wpls, j, L_MIN(val, maskval));
-                        pixel = (L_PIXEL *)LEPT_CALLOC(1, sizeof(L_PIXEL));
-                        pixel->x = i + 1;
-                        pixel->y = j;
-                        lqueueAdd(lq_pixel, pixel);
+                        if (lpairqueueAdd(lpq, i + 1, j))
+                            goto cleanup_queue;
                     }
                 }
                 if (j < jmax) {
@@ -1453,15 +1564,11 @@ L_QUEUE  *lq_pixel;
                     maskval = GET_DATA_BYTE(linem, j + 1);
                     if (val > val5 && val5 != maskval) {
                         SET_DATA_BYTE(lines, j + 1, L_MIN(val, maskval));
-                        pixel = (L_PIXEL *)LEPT_CALLOC(1, sizeof(L_PIXEL));
-                        pixel->x = i;
-                        pixel->y = j + 1;
-                        lqueueAdd(lq_pixel, pixel);
+                        if (lpairqueueAdd(lpq, i, j + 1))
+                            goto cleanup_queue;
                     }
                 }
             }
-
-            queue_size = lqueueGetCount(lq_pixel);
         }
         break;
 
@@ -1469,8 +1576,11 @@ L_QUEUE  *lq_pixel;
         L_ERROR("shouldn't get here!\n", procName);
         break;
     }
+    ret = 0;
 
-    lqueueDestroy(&lq_pixel, TRUE);
+cleanup_queue:
+    lpairqueueDestroy(&lpq);
+    return ret;
 }
 
 
@@ -1506,8 +1616,10 @@ L_QUEUE  *lq_pixel;
  *            L. Vincent, Morphological grayscale reconstruction in image
  *            analysis: applications and efficient algorithms, IEEE Transactions
  *            on  Image Processing, vol. 2, no. 2, pp. 176-201, 1993.
+ *      (5) Returns 0 if OK, 1 on error.  If a pixel can't be queued,
+ *          the fill is incomplete and this returns 1.
  */
-static void
+static l_int32
 seedfillGrayInvLow(l_uint32  *datas,
                    l_int32    w,
                    l_int32    h,
@@ -1516,19 +1628,16 @@ seedfillGrayInvLow(l_uint32  *datas,
                    l_int32    wplm,
                    l_int32    connectivity)
 {
-l_uint8    val1, val2, val3, val4, val5, val6, val7, val8;
-l_uint8    val, maxval, maskval, boolval;
-l_int32    i, j, imax, jmax, queue_size;
-l_uint32  *lines, *linem;
-L_PIXEL *pixel;
-L_QUEUE  *lq_pixel;
+l_uint8       val1, val2, val3, val4, val5, val6, val7, val8;
+l_uint8       val, maxval, maskval, boolval;
+l_int32       i, j, imax, jmax, ret;
+l_uint32     *lines, *linem;
+L_PAIRQUEUE  *lpq;
 
     PROCNAME("seedfillGrayInvLow");
 
-    if (connectivity != 4 && connectivity != 8) {
-        L_ERROR("connectivity must be 4 or 8\n", procName);
-        return;
-    }
+    if (connectivity != 4 && connectivity != 8)
+        return ERROR_INT("connectivity must be 4 or 8", procName, 1);
 
     imax = h - 1;
     jmax = w - 1;
@@ -1537,7 +1646,9 @@ L_QUEUE  *lq_pixel;
          * onto the FIFO queue during anti-raster scan.  However this
          * will rarely happen, and we initialize the queue ptr size to
          * the image perimeter. */
-    lq_pixel = lqueueCreate(2 * (w + h));
+    if ((lpq = lpairqueueCreate(2 * (w + h))) == NULL)
+        return ERROR_INT("lpq not made", procName, 1);
+    ret = 1;
 
     switch (connectivity)
     {
@@ -1617,10 +1728,8 @@ L_QUEUE  *lq_pixel;
                         }
                     }
                     if (boolval) {
-                        pixel = (L_PIXEL *)LEPT_CALLOC(1, sizeof(L_PIXEL));
-                        pixel->x = i;
-                        pixel->y = j;
-                        lqueueAdd(lq_pixel, pixel);
+                        if (lpairqueueAdd(lpq, i, j))
+                            goto cleanup_queue;
                     }
                 }
             }
@@ -1636,12 +1745,8 @@ L_QUEUE  *lq_pixel;
              *            end
              *          end
              *        end */
-        queue_size = lqueueGetCount(lq_pixel);
-        while (queue_size) {
-            pixel = (L_PIXEL *)lqueueRemove(lq_pixel);
-            i = pixel->x;
-            j = pixel->y;
-            LEPT_FREE(pixel);
+        while (lpairqueueGetCount(lpq) > 0) {
+            lpairqueueRemove(lpq, &i, &j);
             lines = datas + i * wpls;
             linem = datam + i * wplm;
 
@@ -1651,10 +1756,8 @@ L_QUEUE  *lq_pixel;
                     maskval = GET_DATA_BYTE(linem - wplm, j);
                     if (val > val2 && val > maskval) {
                         SET_DATA_BYTE(lines - wpls, j, val);
-                        pixel = (L_PIXEL *)LEPT_CALLOC(1, sizeof(L_PIXEL));
-                        pixel->x = i - 1;
-                        pixel->y = j;
-                        lqueueAdd(lq_pixel, pixel);
+                        if (lpairqueueAdd(lpq, i - 1, j))
+                            goto cleanup_queue;
                     }
 
                 }
@@ -1663,10 +1766,8 @@ L_QUEUE  *lq_pixel;
                     maskval = GET_DATA_BYTE(linem, j - 1);
                     if (val > val4 && val > maskval) {
                         SET_DATA_BYTE(lines, j - 1, val);
-                        pixel = (L_PIXEL *)LEPT_CALLOC(1, sizeof(L_PIXEL));
-                        pixel->x = i;
-                        pixel->y = j - 1;
-                        lqueueAdd(lq_pixel, pixel);
+                        if (lpairqueueAdd(lpq, i, j - 1))
+                            goto cleanup_queue;
                     }
                 }
                 if (i < imax) {
@@ -1674,10 +1775,8 @@ L_QUEUE  *lq_pixel;
                     maskval = GET_DATA_BYTE(linem + wplm, j);
                     if (val > val7 && val > maskval) {
                         SET_DATA_BYTE(lines + wpls, j, val);
-                        pixel = (L_PIXEL *)LEPT_CALLOC(1, sizeof(L_PIXEL));
-                        pixel->x = i + 1;
-                        pixel->y = j;
-                        lqueueAdd(lq_pixel, pixel);
+                        if (lpairqueueAdd(lpq, i + 1, j))
+                            goto cleanup_queue;
                     }
                 }
                 if (j < jmax) {
@@ -1685,15 +1784,11 @@ L_QUEUE  *lq_pixel;
                     maskval = GET_DATA_BYTE(linem, j + 1);
                     if (val > val5 && val > maskval) {
                         SET_DATA_BYTE(lines, j + 1, val);
-                        pixel = (L_PIXEL *)LEPT_CALLOC(1, sizeof(L_PIXEL));
-                        pixel->x = i;
-                        pixel->y = j + 1;
-                        lqueueAdd(lq_pixel, pixel);
+                        if (lpairqueueAdd(lpq, i, j + 1))
+                            goto cleanup_queue;
                     }
                 }
             }
-
-            queue_size = lqueueGetCount(lq_pixel);
         }
 
         break;
@@ -1804,10 +1899,8 @@ L_QUEUE  *lq_pixel;
                         }
                     }
                     if (boolval) {
-                        pixel = (L_PIXEL *)LEPT_CALLOC(1, sizeof(L_PIXEL));
-                        pixel->x = i;
-                        pixel->y = j;
-                        lqueueAdd(lq_pixel, pixel);
+                        if (lpairqueueAdd(lpq, i, j))
+                            goto cleanup_queue;
                     }
                 }
             }
@@ -1823,12 +1916,8 @@ L_QUEUE  *lq_pixel;
              *            end
              *          end
              *        end */
-        queue_size = lqueueGetCount(lq_pixel);
-        while (queue_size) {
-            pixel = (L_PIXEL *)lqueueRemove(lq_pixel);
-            i = pixel->x;
-            j = pixel->y;
-            LEPT_FREE(pixel);
+        while (lpairqueueGetCount(lpq) > 0) {
+            lpairqueueRemove(lpq, &i, &j);
             lines = datas + i * wpls;
             linem = datam + i * wplm;
 
@@ -1839,10 +1928,8 @@ L_QUEUE  *lq_pixel;
                         maskval = GET_DATA_BYTE(linem - wplm, j - 1);
                         if (val > val1 && val > maskval) {
                             SET_DATA_BYTE(lines - wpls, j - 1, val);
-                            pixel = (L_PIXEL *)LEPT_CALLOC(1, sizeof(L_PIXEL));
-                            pixel->x = i - 1;
-                            pixel->y = j - 1;
-                            lqueueAdd(lq_pixel, pixel);
+                            if (lpairqueueAdd(lpq, i - 1, j - 1))
+                                goto cleanup_queue;
                         }
                     }
                     if (j < jmax) {
@@ -1850,20 +1937,16 @@ L_QUEUE  *lq_pixel;
                         maskval = GET_DATA_BYTE(linem - wplm, j + 1);
                         if (val > val3 && val > maskval) {
                             SET_DATA_BYTE(lines - wpls, j + 1, val);
-                            pixel = (L_PIXEL *)LEPT_CALLOC(1, sizeof(L_PIXEL));
-                            pixel->x = i - 1;
-                            pixel->y = j + 1;
-                            lqueueAdd(lq_pixel, pixel);
+                            if (lpairqueueAdd(lpq, i - 1, j + 1))
+                                goto cleanup_queue;
                         }
                     }
                     val2 = GET_DATA_BYTE(lines - wpls, j);
                     maskval = GET_DATA_BYTE(linem - wplm, j);
                     if (val > val2 && val > maskval) {
                         SET_DATA_BYTE(lines - wpls, j, val);
-                        pixel = (L_PIXEL *)LEPT_CALLOC(1, sizeof(L_PIXEL));
-                        pixel->x = i - 1;
-                        pixel->y = j;
-                        lqueueAdd(lq_pixel, pixel);
+                        if (lpairqueueAdd(lpq, i - 1, j))
+                            goto cleanup_queue;
                     }
 
                 }
@@ -1872,10 +1955,8 @@ L_QUEUE  *lq_pixel;
                     maskval = GET_DATA_BYTE(linem, j - 1);
                     if (val > val4 && val > maskval) {
                         SET_DATA_BYTE(lines, j - 1, val);
-                        pixel = (L_PIXEL *)LEPT_CALLOC(1, sizeof(L_PIXEL));
-                        pixel->x = i;
-                        pixel->y = j - 1;
-                        lqueueAdd(lq_pixel, pixel);
+                        if (lpairqueueAdd(lpq, i, j - 1))
+                            goto cleanup_queue;
                     }
                 }
                 if (i < imax) {
@@ -1884,10 +1965,8 @@ L_QUEUE  *lq_pixel;
                         maskval = GET_DATA_BYTE(linem + wplm, j - 1);
                         if (val > val6 && val > maskval) {
                             SET_DATA_BYTE(lines + wpls, j - 1, val);
-                            pixel = (L_PIXEL *)LEPT_CALLOC(1, sizeof(L_PIXEL));
-                            pixel->x = i + 1;
-                            pixel->y = j - 1;
-                            lqueueAdd(lq_pixel, pixel);
+                            if (lpairqueueAdd(lpq, i + 1, j - 1))
+                                goto cleanup_queue;
                         }
                     }
                     if (j < jmax) {
@@ -1895,20 +1974,16 @@ L_QUEUE  *lq_pixel;
                         maskval = GET_DATA_BYTE(linem + wplm, j + 1);
                         if (val > val8 && val > maskval) {
                             SET_DATA_BYTE(lines + wpls, j + 1, val);
-                            pixel = (L_PIXEL *)LEPT_CALLOC(1, sizeof(L_PIXEL));
-                            pixel->x = i + 1;
-                            pixel->y = j + 1;
-                            lqueueAdd(lq_pixel, pixel);
+                            if (lpairqueueAdd(lpq, i + 1, j + 1))
+                                goto cleanup_queue;
                         }
                     }
                     val7 = GET_DATA_BYTE(lines + wpls, j);
                     maskval = GET_DATA_BYTE(linem + wplm, j);
                     if (val > val7 && val > maskval) {
                         SET_DATA_BYTE(lines + wpls, j, val);
-                        pixel = (L_PIXEL *)LEPT_CALLOC(1, sizeof(L_PIXEL));
-                        pixel->x = i + 1;
-                        pixel->y = j;
-                        lqueueAdd(lq_pixel, pixel);
+                        if (lpairqueueAdd(lpq, i + 1, j))
+                            goto cleanup_queue;
                     }
                 }
                 if (j < jmax) {
@@ -1916,15 +1991,11 @@ L_QUEUE  *lq_pixel;
                     maskval = GET_DATA_BYTE(linem, j + 1);
                     if (val > val5 && val > maskval) {
                         SET_DATA_BYTE(lines, j + 1, val);
-                        pixel = (L_PIXEL *)LEPT_CALLOC(1, sizeof(L_PIXEL));
-                        pixel->x = i;
-                        pixel->y = j + 1;
-                        lqueueAdd(lq_pixel, pixel);
+                        if (lpairqueueAdd(lpq, i, j + 1))
+                            goto cleanup_queue;
                     }
                 }
             }
-
-            queue_size = lqueueGetCount(lq_pixel);
         }
         break;
 
@@ -1932,8 +2003,11 @@ L_QUEUE  *lq_pixel;
         L_ERROR("shouldn't get here!\n", procName);
         break;
     }
+    ret = 0;
 
-    lqueueDestroy(&lq_pixel, TRUE);
+cleanup_queue:
+    lpairqueueDestroy(&lpq);
+    return ret;
 }
 
 
@@ -2526,6 +2600,9 @@ PIX  *pixbi, *pixmi, *pixsd;
  *          1-boundary pixels, and go all the way to the right
  *          and bottom; then coming back reset left and top.  But we
  *          instead use a method that works for both 4- and 8-connected.
+ *      (5) This gives the city-block (4-cc) or chessboard (8-cc)
+ *          distance.  For the exact Euclidean distance, use
+ *          pixEuclideanDistance() or pixEuclideanDistanceFPix().
  * </pre>
  */
 PIX *
@@ -2973,6 +3050,362 @@ l_uint32  *linet, *lined;
 }
 
 
+/*-----------------------------------------------------------------------*
+ *                  Exact Euclidean distance function                    *
+ *-----------------------------------------------------------------------*/
+/*!
+ * \brief   pixEuclideanDistance()
+ *
+ * \param[in]    pixs        1 bpp
+ * \param[in]    outdepth    16 or 32 bits for pixd
+ * \param[in]    boundcond   L_BOUNDARY_BG, L_BOUNDARY_FG
+ * \return  pixd, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This computes the exact Euclidean distance of each pixel
+ *          from the nearest background pixel.  All bg pixels have a
+ *          distance of 0, and fg pixels adjacent to bg have a distance
+ *          of 1.  As with pixDistanceFunction(), invert the input to
+ *          get the distance of each pixel from the nearest fg pixel.
+ *      (2) For %outdepth = 32, each pixel is the squared distance,
+ *          which is an integer and is exact.  For %outdepth = 16, each
+ *          pixel is the distance, rounded to the nearest integer and
+ *          clipped to 0xffff.  Use pixEuclideanDistanceFPix() for
+ *          the unrounded distance.
+ *      (3) With L_BOUNDARY_BG, pixels outside the image are taken
+ *          to be bg, so the distance of a fg pixel on the image
+ *          boundary is 1.  With L_BOUNDARY_FG, they are taken to be fg,
+ *          and the distance is to the nearest bg pixel in the image.
+ *          With L_BOUNDARY_FG, pixs must have at least one bg pixel.
+ *      (4) The time is linear in the number of pixels, independent of
+ *          the distances.  See euclideanDistanceLow() for details.
+ * </pre>
+ */
+PIX *
+pixEuclideanDistance(PIX     *pixs,
+                     l_int32  outdepth,
+                     l_int32  boundcond)
+{
+l_int32    i, j, w, h, wpl1, wpld;
+l_uint32   val;
+l_uint32  *data1, *datad, *line1, *lined;
+PIX       *pix1, *pixd;
+
+    PROCNAME("pixEuclideanDistance");
+
+    if (!pixs || pixGetDepth(pixs) != 1)
+        return (PIX *)ERROR_PTR("!pixs or pixs not 1 bpp", procName, NULL);
+    if (outdepth != 16 && outdepth != 32)
+        return (PIX *)ERROR_PTR("outdepth not 16 or 32 bpp", procName, NULL);
+    if (boundcond != L_BOUNDARY_BG && boundcond != L_BOUNDARY_FG)
+        return (PIX *)ERROR_PTR("invalid boundcond", procName, NULL);
+
+    pixGetDimensions(pixs, &w, &h, NULL);
+    if ((pix1 = pixCreate(w, h, 32)) == NULL)
+        return (PIX *)ERROR_PTR("pix1 not made", procName, NULL);
+    pixCopyResolution(pix1, pixs);
+    if (euclideanDistanceLow(pixs, boundcond, pixGetData(pix1), NULL)) {
+        pixDestroy(&pix1);
+        return (PIX *)ERROR_PTR("distance not found", procName, NULL);
+    }
+    if (outdepth == 32)
+        return pix1;
+
+    pixd = pixCreate(w, h, 16);
+    pixCopyResolution(pixd, pixs);
+    data1 = pixGetData(pix1);
+    wpl1 = pixGetWpl(pix1);
+    datad = pixGetData(pixd);
+    wpld = pixGetWpl(pixd);
+    for (i = 0; i < h; i++) {
+        line1 = data1 + i * wpl1;
+        lined = datad + i * wpld;
+        for (j = 0; j < w; j++) {
+            val = (l_uint32)(sqrt((l_float64)line1[j]) + 0.5);
+            SET_DATA_TWO_BYTES(lined, j, L_MIN(val, 0xffff));
+        }
+    }
+    pixDestroy(&pix1);
+    return pixd;
+}
+
+
+/*!
+ * \brief   pixEuclideanDistanceFPix()
+ *
+ * \param[in]    pixs        1 bpp
+ * \param[in]    boundcond   L_BOUNDARY_BG, L_BOUNDARY_FG
+ * \return  fpixd, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This returns the exact Euclidean distance of each pixel
+ *          from the nearest background pixel.
+ *      (2) See pixEuclideanDistance() for details.
+ * </pre>
+ */
+FPIX *
+pixEuclideanDistanceFPix(PIX     *pixs,
+                         l_int32  boundcond)
+{
+l_int32     i, w, h;
+l_uint32   *data1;
+l_float32  *datad;
+FPIX       *fpixd;
+PIX        *pix1;
+
+    PROCNAME("pixEuclideanDistanceFPix");
+
+    if (!pixs || pixGetDepth(pixs) != 1)
+        return (FPIX *)ERROR_PTR("!pixs or pixs not 1 bpp", procName, NULL);
+    if (boundcond != L_BOUNDARY_BG && boundcond != L_BOUNDARY_FG)
+        return (FPIX *)ERROR_PTR("invalid boundcond", procName, NULL);
+
+    if ((pix1 = pixEuclideanDistance(pixs, 32, boundcond)) == NULL)
+        return (FPIX *)ERROR_PTR("pix1 not made", procName, NULL);
+    pixGetDimensions(pix1, &w, &h, NULL);
+    if ((fpixd = fpixCreate(w, h)) == NULL) {
+        pixDestroy(&pix1);
+        return (FPIX *)ERROR_PTR("fpixd not made", procName, NULL);
+    }
+    fpixSetResolution(fpixd, pixGetXRes(pixs), pixGetYRes(pixs));
+
+        /* For 32 bpp pix and fpix, wpl == w, so the data arrays
+         * can be traversed as a single line. */
+    data1 = pixGetData(pix1);
+    datad = fpixGetData(fpixd);
+    for (i = 0; i < w * h; i++)
+        datad[i] = (l_float32)sqrt((l_float64)data1[i]);
+    pixDestroy(&pix1);
+    return fpixd;
+}
+
+
+/*!
+ * \brief   pixSeedspreadEuclidean()
+ *
+ * \param[in]    pixs    8 bpp
+ * \return  pixd, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) Like pixSeedspread(), this spreads the nonzero (seed) pixels
+ *          in pixs to fill all the pixels in pixd.  Each pixel takes
+ *          the value of the seed pixel that is nearest in Euclidean
+ *          distance, so the result is an exact Voronoi tiling of
+ *          the seeds.
+ *      (2) Pixels that are equidistant from two or more seeds take the
+ *          value of one of them; the choice is arbitrary but
+ *          deterministic.
+ *      (3) If pixs has no seed pixels, this returns a copy of pixs.
+ * </pre>
+ */
+PIX *
+pixSeedspreadEuclidean(PIX  *pixs)
+{
+l_int32    i, j, w, h, wpls, wpld, k;
+l_int32   *nearest;
+l_uint32  *datas, *datad, *lined;
+PIX       *pixm, *pix1, *pixd;
+
+    PROCNAME("pixSeedspreadEuclidean");
+
+    if (!pixs || pixGetDepth(pixs) != 8)
+        return (PIX *)ERROR_PTR("!pixs or pixs not 8 bpp", procName, NULL);
+
+        /* The seeds are the bg pixels in pixm */
+    pixm = pixThresholdToBinary(pixs, 1);
+    pixGetDimensions(pixs, &w, &h, NULL);
+    pixCountPixels(pixm, &k, NULL);
+    if (k == w * h) {
+        L_WARNING("no seed pixels\n", procName);
+        pixDestroy(&pixm);
+        return pixCopy(NULL, pixs);
+    }
+
+    nearest = (l_int32 *)LEPT_CALLOC((size_t)w * h, sizeof(l_int32));
+    pix1 = pixCreate(w, h, 32);
+    euclideanDistanceLow(pixm, L_BOUNDARY_FG, pixGetData(pix1), nearest);
+    pixDestroy(&pix1);
+    pixDestroy(&pixm);
+
+    pixd = pixCreateTemplate(pixs);
+    datas = pixGetData(pixs);
+    wpls = pixGetWpl(pixs);
+    datad = pixGetData(pixd);
+    wpld = pixGetWpl(pixd);
+    for (i = 0; i < h; i++) {
+        lined = datad + i * wpld;
+        for (j = 0; j < w; j++) {
+            k = nearest[i * w + j];
+            SET_DATA_BYTE(lined, j,
+                          GET_DATA_BYTE(datas + (k / w) * wpls, k % w));
+        }
+    }
+
+    LEPT_FREE(nearest);
+    return pixd;
+}
+
+
+/*!
+ * \brief   euclideanDistanceLow()
+ *
+ * \param[in]    pixs        1 bpp; the bg pixels are the sites
+ * \param[in]    boundcond   L_BOUNDARY_BG, L_BOUNDARY_FG
+ * \param[in]    datad       w * h array for the squared distances
+ * \param[in]    nearest     [optional] w * h array for the index
+ *                           (i * w + j) of the nearest bg pixel
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This is the separable lower envelope method of
+ *          Felzenszwalb and Huttenlocher, "Distance Transforms of
+ *          Sampled Functions" (2004).  The squared distance
+ *            D(i,j) = min over (k,l) of (i - k)^2 + (j - l)^2
+ *          where (k,l) are the bg pixels, separates as
+ *            D(i,j) = min over l of (j - l)^2 + G(i,l)^2
+ *          where G(i,l) is the distance in column l to the nearest
+ *          bg pixel in that column.
+ *      (2) G is found with one downward and one upward sweep, a row
+ *          at a time, and stored in %datad.  Then each row of %datad
+ *          is replaced by the lower envelope of the parabolas
+ *          (j - l)^2 + G(i,l)^2, found in linear time.  The rows are
+ *          independent of each other in both passes.
+ *      (3) For L_BOUNDARY_BG, virtual bg pixels are placed just
+ *          outside the image on all four sides.  These are never
+ *          reported in %nearest, which is only used with L_BOUNDARY_FG.
+ *      (4) With L_BOUNDARY_FG, this returns an error if there are
+ *          no bg pixels.
+ * </pre>
+ */
+static l_int32
+euclideanDistanceLow(PIX       *pixs,
+                     l_int32    boundcond,
+                     l_uint32  *datad,
+                     l_int32   *nearest)
+{
+l_int32     i, j, k, w, h, wpls, ginf, bgfound, q;
+l_int32    *v, *rowk;
+l_uint32   *datas, *lines, *lined, *linep;
+l_float64   fq, s, dist;
+l_float64  *f, *z;
+
+    PROCNAME("euclideanDistanceLow");
+
+    pixGetDimensions(pixs, &w, &h, NULL);
+    datas = pixGetData(pixs);
+    wpls = pixGetWpl(pixs);
+    ginf = w + h + 2;  /* larger than any distance within a column */
+
+        /* Downward sweep: distance to the nearest bg pixel above.
+         * The row of that pixel is saved in %nearest. */
+    bgfound = FALSE;
+    for (i = 0; i < h; i++) {
+        lines = datas + i * wpls;
+        lined = datad + i * w;
+        linep = lined - w;
+        for (j = 0; j < w; j++) {
+            if (!GET_DATA_BIT(lines, j)) {
+                lined[j] = 0;
+                if (nearest) nearest[i * w + j] = i;
+                bgfound = TRUE;
+            } else if (i == 0) {
+                lined[j] = (boundcond == L_BOUNDARY_BG) ? 1 : ginf;
+                if (nearest) nearest[j] = -1;
+            } else {
+                lined[j] = L_MIN(linep[j] + 1, ginf);
+                if (nearest) nearest[i * w + j] = nearest[(i - 1) * w + j];
+            }
+        }
+    }
+    if (!bgfound && boundcond == L_BOUNDARY_FG)
+        return ERROR_INT("no bg pixels", procName, 1);
+
+        /* Upward sweep: use the distance to the nearest bg pixel
+         * below, if that is closer */
+    for (i = h - 1; i >= 0; i--) {
+        lined = datad + i * w;
+        linep = lined + w;
+        for (j = 0; j < w; j++) {
+            if (i == h - 1) {
+                if (boundcond == L_BOUNDARY_BG && lined[j] > 1)
+                    lined[j] = 1;
+            } else if (linep[j] + 1 < lined[j]) {
+                lined[j] = linep[j] + 1;
+                if (nearest) nearest[i * w + j] = nearest[(i + 1) * w + j];
+            }
+        }
+    }
+
+        /* For each row, find the lower envelope of the parabolas
+         * (j - q)^2 + f(q), where f(q) = G(i,q)^2 at each site q.
+         * The parabolas in the envelope are at sites v[0 ... k], and
+         * parabola m is the lowest for z[m] <= j <= z[m + 1].
+         * For L_BOUNDARY_BG, the sites at q = -1 and q = w have
+         * f = 0.  For L_BOUNDARY_FG, there is at least one column
+         * with a bg pixel, so the envelope is never empty. */
+    v = (l_int32 *)LEPT_CALLOC(w + 2, sizeof(l_int32));
+    rowk = (l_int32 *)LEPT_CALLOC(w, sizeof(l_int32));
+    f = (l_float64 *)LEPT_CALLOC(w + 2, sizeof(l_float64));
+    z = (l_float64 *)LEPT_CALLOC(w + 3, sizeof(l_float64));
+    for (i = 0; i < h; i++) {
+        lined = datad + i * w;
+        k = -1;
+        for (q = -1; q <= w; q++) {
+            if (q == -1 || q == w) {
+                if (boundcond != L_BOUNDARY_BG) continue;
+                fq = 0.0;
+            } else {
+                if (lined[q] >= ginf) continue;  /* no bg in this column */
+                fq = (l_float64)lined[q] * lined[q];
+            }
+            if (k == -1) {
+                k = 0;
+                v[0] = q;
+                f[0] = fq;
+                z[0] = -1.0e30;
+                z[1] = 1.0e30;
+                continue;
+            }
+            while (1) {
+                s = ((fq + (l_float64)q * q) -
+                     (f[k] + (l_float64)v[k] * v[k])) / (2.0 * (q - v[k]));
+                if (s > z[k]) break;
+                k--;
+            }
+            k++;
+            v[k] = q;
+            f[k] = fq;
+            z[k] = s;
+            z[k + 1] = 1.0e30;
+        }
+
+            /* Read the squared distances off the envelope */
+        if (nearest) {  /* save the rows of the nearest bg in each column */
+            for (j = 0; j < w; j++)
+                rowk[j] = nearest[i * w + j];
+        }
+        for (j = 0, k = 0; j < w; j++) {
+            while (z[k + 1] < j)
+                k++;
+            dist = (l_float64)(j - v[k]) * (j - v[k]) + f[k];
+            lined[j] = (dist > 4294967295.0) ? 0xffffffff : (l_uint32)dist;
+            if (nearest)
+                nearest[i * w + j] = rowk[v[k]] * w + v[k];
+        }
+    }
+
+    LEPT_FREE(v);
+    LEPT_FREE(rowk);
+    LEPT_FREE(f);
+    LEPT_FREE(z);
+    return 0;
+}
+
+
 /*-----------------------------------------------------------------------*
  *                              Local extrema                            *
  *-----------------------------------------------------------------------*/
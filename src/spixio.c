@@ -35,6 +35,7 @@
  *
  *      Reading spix from file
  *           PIX        *pixReadStreamSpix()
+ *           PIX        *pixReadSpixMapped()
  *           l_int32     readHeaderSpix()
  *           l_int32     freadHeaderSpix()
  *           l_int32     sreadHeaderSpix()
@@ -48,6 +49,9 @@
  *           l_int32     pixSerializeToMemory()
  *           PIX        *pixDeserializeFromMemory()
  *
+ *      Static helper
+ *           static l_int32  spixCheckData()
+ *
  *    Note: these functions have not been extensively tested for fuzzing
  *    (bad input data that can result in, e.g., memory faults).
  *    The spix serialization format is only defined here, in leptonica.
@@ -57,6 +61,12 @@
  */
 
 #include <string.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif  /* !_WIN32 */
 #include "allheaders.h"
 
     /* Image dimension limits */
@@ -68,6 +78,10 @@ static const l_int64  MaxAllowedArea = 400000000LL;
 #define  DEBUG_SERIALIZE      0
 #endif  /* ~NO_CONSOLE_IO */
 
+static l_int32 spixCheckData(const l_uint32 *data, size_t nbytes,
+                             l_int32 mapped, l_int32 *pw, l_int32 *ph,
+                             l_int32 *pd, l_int32 *pncolors);
+
 
 /*-----------------------------------------------------------------------*
  *                          Reading spix from file                       *
@@ -106,6 +120,111 @@ PIX      *pix;
 }
 
 
+/*!
+ * \brief   pixReadSpixMapped()
+ *
+ * \param[in]    filename    spix file
+ * \return  pix, or NULL on error.
+ *
+ * <pre>
+ * Notes:
+ *      (1) The raster in an spix file has the same layout as the data
+ *          of a pix, and it starts on a word boundary.  This maps the
+ *          file into memory and uses the raster in place, so nothing
+ *          is read until the pixels are accessed, and pages that are
+ *          never accessed are never read.
+ *      (2) The mapping is private: the pix can be written to, but the
+ *          changes are not carried through to the file.  The mapping
+ *          is removed when the pix data is freed.  Because the data is
+ *          not owned in the usual way, pixExtractData() always returns
+ *          a copy of it.
+ *      (3) spix is written in the byte order of the machine, so the
+ *          file must have been written on a machine with the same
+ *          endianness.
+ *      (4) Where file mapping is not available, the file is read into
+ *          a new pix with pixReadStreamSpix().
+ *      (5) Because no memory is allocated for the raster, the limit of
+ *          400M pixels used when deserializing from memory is not
+ *          applied here.  The raster is still limited to less than
+ *          2^31 bytes, as for every pix (see pixCreateHeader()).
+ *          For 32 bpp, that is about 536M pixels; e.g., 23000 x 23000.
+ * </pre>
+ */
+PIX *
+pixReadSpixMapped(const char  *filename)
+{
+#ifndef _WIN32
+char        *fname;
+int          fd;
+l_int32      w, h, d, ncolors;
+size_t       nbytes;
+void        *addr;
+struct stat  st;
+PIX         *pix;
+PIXCMAP     *cmap;
+
+    PROCNAME("pixReadSpixMapped");
+
+    if (!filename)
+        return (PIX *)ERROR_PTR("filename not defined", procName, NULL);
+
+    fname = genPathname(filename, NULL);
+    fd = open(fname, O_RDONLY);
+    LEPT_FREE(fname);
+    if (fd < 0)
+        return (PIX *)ERROR_PTR("file not opened", procName, NULL);
+    if (fstat(fd, &st) != 0 || st.st_size < 28) {
+        close(fd);
+        return (PIX *)ERROR_PTR("invalid file size", procName, NULL);
+    }
+    nbytes = (size_t)st.st_size;
+    addr = mmap(NULL, nbytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);  /* the mapping stays valid */
+    if (addr == MAP_FAILED)
+        return (PIX *)ERROR_PTR("file not mapped", procName, NULL);
+
+    if (spixCheckData((l_uint32 *)addr, nbytes, 1, &w, &h, &d, &ncolors)) {
+        munmap(addr, nbytes);
+        return (PIX *)ERROR_PTR("invalid spix data", procName, NULL);
+    }
+    if ((pix = pixCreateHeader(w, h, d)) == NULL) {
+        munmap(addr, nbytes);
+        return (PIX *)ERROR_PTR("pix not made", procName, NULL);
+    }
+    if (ncolors > 0) {
+        cmap = pixcmapDeserializeFromMemory((l_uint8 *)addr + 24, 4, ncolors);
+        if (!cmap) {
+            pixDestroy(&pix);
+            munmap(addr, nbytes);
+            return (PIX *)ERROR_PTR("cmap not made", procName, NULL);
+        }
+        pixSetColormap(pix, cmap);
+    }
+
+    pixSetData(pix, (l_uint32 *)addr + 7 + ncolors);
+    pix->mapaddr = addr;
+    pix->mapsize = nbytes;
+    return pix;
+#else
+FILE  *fp;
+PIX   *pix;
+
+    PROCNAME("pixReadSpixMapped");
+
+    if (!filename)
+        return (PIX *)ERROR_PTR("filename not defined", procName, NULL);
+
+    if ((fp = fopenReadStream(filename)) == NULL)
+        return (PIX *)ERROR_PTR("stream not opened", procName, NULL);
+    pix = pixReadStreamSpix(fp);
+    fclose(fp);
+    if (!pix)
+        return (PIX *)ERROR_PTR("pix not read", procName, NULL);
+    return pix;
+#endif  /* !_WIN32 */
+}
+
+
 /*!
  * \brief   readHeaderSpix()
  *
@@ -340,6 +459,8 @@ pixWriteMemSpix(l_uint8  **pdata,
  *            rdatasize (4 bytes) -- size of serialized raster data
  *                                   = 4 * wpl * h
  *            rdata     (rdatasize)
+ *      (2) A view is serialized from a copy, so that the raster data
+ *          has no more than the minimum wpl.
  * </pre>
  */
 l_ok
@@ -352,6 +473,7 @@ l_int32    w, h, d, wpl, rdatasize, ncolors, nbytes, index;
 l_uint8   *cdata;  /* data in colormap array (4 bytes/color table entry) */
 l_uint32  *data;
 l_uint32  *rdata;  /* data in pix raster */
+PIX       *pix1;
 PIXCMAP   *cmap;
 
     PROCNAME("pixSerializeToMemory");
@@ -363,19 +485,26 @@ PIXCMAP   *cmap;
     if (!pixs)
         return ERROR_INT("pixs not defined", procName, 1);
 
-    pixGetDimensions(pixs, &w, &h, &d);
-    wpl = pixGetWpl(pixs);
-    rdata = pixGetData(pixs);
+    if (pixIsView(pixs))
+        pix1 = pixCopy(NULL, pixs);
+    else
+        pix1 = pixClone(pixs);
+    if (!pix1)
+        return ERROR_INT("pix1 not made", procName, 1);
+    pixGetDimensions(pix1, &w, &h, &d);
+    wpl = pixGetWpl(pix1);
+    rdata = pixGetData(pix1);
     rdatasize = 4 * wpl * h;
     ncolors = 0;
     cdata = NULL;
-    if ((cmap = pixGetColormap(pixs)) != NULL)
+    if ((cmap = pixGetColormap(pix1)) != NULL)
         pixcmapSerializeToMemory(cmap, 4, &ncolors, &cdata);
 
     nbytes = 24 + 4 * ncolors + 4 + rdatasize;
     if ((data = (l_uint32 *)LEPT_CALLOC(nbytes / 4, sizeof(l_uint32)))
          == NULL) {
         LEPT_FREE(cdata);
+        pixDestroy(&pix1);
         return ERROR_INT("data not made", procName, 1);
     }
     *pdata = data;
@@ -403,6 +532,7 @@ PIXCMAP   *cmap;
 #endif  /* DEBUG_SERIALIZE */
 
     LEPT_FREE(cdata);
+    pixDestroy(&pix1);
     return 0;
 }
 
@@ -424,50 +554,18 @@ PIX *
 pixDeserializeFromMemory(const l_uint32  *data,
                          size_t           nbytes)
 {
-char      *id;
-l_int32    w, h, d, pixdata_size, memdata_size, imdata_size, ncolors;
+l_int32    w, h, d, imdata_size, ncolors;
 l_uint32  *imdata;  /* data in pix raster */
-PIX       *pix1, *pixd;
+PIX       *pixd;
 PIXCMAP   *cmap;
 
     PROCNAME("pixDeserializeFromMemory");
 
     if (!data)
         return (PIX *)ERROR_PTR("data not defined", procName, NULL);
-    if (nbytes < 28 || nbytes > ((1LL << 31) - 1)) {
-        L_ERROR("invalid nbytes = %zu\n", procName, nbytes);
-        return NULL;
-    }
-
-    id = (char *)data;
-    if (id[0] != 's' || id[1] != 'p' || id[2] != 'i' || id[3] != 'x')
-        return (PIX *)ERROR_PTR("invalid id string", procName, NULL);
-    w = data[1];
-    h = data[2];
-    d = data[3];
-    ncolors = data[5];
-
-        /* Sanity checks on the amount of image data */
-    if (w < 1 || w > MaxAllowedWidth)
-        return (PIX *)ERROR_PTR("invalid width", procName, NULL);
-    if (h < 1 || h > MaxAllowedHeight)
-        return (PIX *)ERROR_PTR("invalid height", procName, NULL);
-    if (1LL * w * h > MaxAllowedArea)
-        return (PIX *)ERROR_PTR("area too large", procName, NULL);
-    if (ncolors < 0 || ncolors > 256 || ncolors + 6 >= nbytes/sizeof(l_int32))
-        return (PIX *)ERROR_PTR("invalid ncolors", procName, NULL);
-    if ((pix1 = pixCreateHeader(w, h, d)) == NULL)  /* just make the header */
-        return (PIX *)ERROR_PTR("failed to make header", procName, NULL);
-    pixdata_size = 4 * h * pixGetWpl(pix1);
-    memdata_size = nbytes - 24 - 4 * ncolors - 4;
+    if (spixCheckData(data, nbytes, 0, &w, &h, &d, &ncolors))
+        return (PIX *)ERROR_PTR("invalid spix data", procName, NULL);
     imdata_size = data[6 + ncolors];
-    pixDestroy(&pix1);
-    if (pixdata_size != memdata_size || pixdata_size != imdata_size) {
-        L_ERROR("pixdata_size = %d, memdata_size = %d, imdata_size = %d "
-                "not all equal!\n", procName, pixdata_size, memdata_size,
-                imdata_size);
-        return NULL;
-    }
 
     if ((pixd = pixCreate(w, h, d)) == NULL)
         return (PIX *)ERROR_PTR("pix not made", procName, NULL);
@@ -491,3 +589,85 @@ PIXCMAP   *cmap;
 
     return pixd;
 }
+
+
+/*-----------------------------------------------------------------------*
+ *                            Static helper                              *
+ *-----------------------------------------------------------------------*/
+/*!
+ * \brief   spixCheckData()
+ *
+ * \param[in]    data       serialized data in memory
+ * \param[in]    nbytes     number of bytes in data string
+ * \param[in]    mapped     1 if the data is mapped from a file; 0 otherwise
+ * \param[out]   pw, ph, pd     image dimensions
+ * \param[out]   pncolors   number of colors in the colormap; 0 if none
+ * \return  0 if the data is a valid spix serialization, 1 otherwise
+ *
+ * <pre>
+ * Notes:
+ *      (1) This checks the header against the image size limits and
+ *          the size of the raster against both the header and nbytes.
+ *      (2) For mapped data, nothing is allocated for the raster, so
+ *          the limits on nbytes and on the image area are not applied.
+ *          The raster size is still limited by pixCreateHeader().
+ * </pre>
+ */
+static l_int32
+spixCheckData(const l_uint32  *data,
+              size_t           nbytes,
+              l_int32          mapped,
+              l_int32         *pw,
+              l_int32         *ph,
+              l_int32         *pd,
+              l_int32         *pncolors)
+{
+char     *id;
+l_int32   w, h, d, ncolors;
+size_t    pixdata_size, memdata_size, imdata_size;
+PIX      *pix1;
+
+    PROCNAME("spixCheckData");
+
+    *pw = *ph = *pd = *pncolors = 0;
+    if (nbytes < 28 || (!mapped && nbytes > ((1LL << 31) - 1))) {
+        L_ERROR("invalid nbytes = %zu\n", procName, nbytes);
+        return 1;
+    }
+
+    id = (char *)data;
+    if (id[0] != 's' || id[1] != 'p' || id[2] != 'i' || id[3] != 'x')
+        return ERROR_INT("invalid id string", procName, 1);
+    w = data[1];
+    h = data[2];
+    d = data[3];
+    ncolors = data[5];
+
+        /* Sanity checks on the amount of image data */
+    if (w < 1 || w > MaxAllowedWidth)
+        return ERROR_INT("invalid width", procName, 1);
+    if (h < 1 || h > MaxAllowedHeight)
+        return ERROR_INT("invalid height", procName, 1);
+    if (!mapped && 1LL * w * h > MaxAllowedArea)
+        return ERROR_INT("area too large", procName, 1);
+    if (ncolors < 0 || ncolors > 256 || ncolors + 6 >= nbytes/sizeof(l_int32))
+        return ERROR_INT("invalid ncolors", procName, 1);
+    if ((pix1 = pixCreateHeader(w, h, d)) == NULL)  /* just make the header */
+        return ERROR_INT("failed to make header", procName, 1);
+    pixdata_size = 4 * (size_t)h * pixGetWpl(pix1);
+    memdata_size = nbytes - 24 - 4 * ncolors - 4;
+    imdata_size = data[6 + ncolors];
+    pixDestroy(&pix1);
+    if (pixdata_size != memdata_size || pixdata_size != imdata_size) {
+        L_ERROR("pixdata_size = %zu, memdata_size = %zu, imdata_size = %zu "
+                "not all equal!\n", procName, pixdata_size, memdata_size,
+                imdata_size);
+        return 1;
+    }
+
+    *pw = w;
+    *ph = h;
+    *pd = d;
+    *pncolors = ncolors;
+    return 0;
+}
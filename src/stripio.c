@@ -0,0 +1,965 @@
+/*====================================================================*
+ -  Copyright (C) 2001 Leptonica.  All rights reserved.
+ -
+ -  Redistribution and use in source and binary forms, with or without
+ -  modification, are permitted provided that the following conditions
+ -  are met:
+ -  1. Redistributions of source code must retain the above copyright
+ -     notice, this list of conditions and the following disclaimer.
+ -  2. Redistributions in binary form must reproduce the above
+ -     copyright notice, this list of conditions and the following
+ -     disclaimer in the documentation and/or other materials
+ -     provided with the distribution.
+ -
+ -  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ -  ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ -  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ -  A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL ANY
+ -  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ -  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ -  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ -  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ -  OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ -  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ -  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *====================================================================*/
+
+/*!
+ * \file stripio.c
+ * <pre>
+ *
+ *     Strip reader
+ *           L_STRIP_READER  *stripReaderCreate()
+ *           void             stripReaderDestroy()
+ *           l_int32          stripReaderGetDimensions()
+ *           PIX             *stripReaderRead()
+ *
+ *     Strip writer
+ *           L_STRIP_WRITER  *stripWriterCreate()
+ *           void             stripWriterDestroy()
+ *           l_int32          stripWriterWrite()
+ *           l_int32          stripWriterFinish()
+ *
+ *     Strip pipeline
+ *           L_STRIP_PIPE    *stripPipeCreate()
+ *           void             stripPipeDestroy()
+ *           l_int32          stripPipeAddTRC()
+ *           l_int32          stripPipeAddConvertToGray()
+ *           l_int32          stripPipeAddThreshold()
+ *           l_int32          stripPipeAddBlockconv()
+ *           static l_int32   stripPipeExtendArray()
+ *           PIX             *stripPipeApply()
+ *           l_int32          stripPipeProcess()
+ *           static PIX      *stripReadWindow()
+ *
+ *     Format helpers
+ *           static l_int32   stripFormatIsTiff()
+ *
+ *  These decode, process and encode an image a band of rows (a strip)
+ *  at a time.  Peak memory is then proportional to the strip height
+ *  rather than to the image height, which matters for very large
+ *  scanned pages and for servers that handle many images at once.
+ *
+ *  The format-specific decoding and encoding is done by functions in
+ *  pngio.c, jpegio.c and tiffio.c, which keep the codec state in
+ *  the reader or writer.  The returned strips are 1, 8 or 32 bpp,
+ *  without colormap; see the notes for stripReaderCreate().
+ *
+ *  An L_Strip_Pipe is a sequence of point and neighborhood operations
+ *  to be applied to each strip.  Neighborhood operations such as
+ *  block convolution need rows above and below the strip; the pipe
+ *  keeps track of this 'halo', and stripPipeProcess() decodes enough
+ *  extra rows that each output strip is identical to the same rows
+ *  of the result of stripPipeApply() on the entire image.
+ *
+ *  Typical use:
+ *      L_STRIP_PIPE *pipe = stripPipeCreate();
+ *      stripPipeAddConvertToGray(pipe, 0.0, 0.0, 0.0);
+ *      stripPipeAddBlockconv(pipe, 2, 2);
+ *      stripPipeAddThreshold(pipe, 130);
+ *      stripPipeProcess(pipe, "big.jpg", "big.png", IFF_PNG, 64, 0);
+ *      stripPipeDestroy(&pipe);
+ * </pre>
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config_auto.h>
+#endif  /* HAVE_CONFIG_H */
+
+#include "allheaders.h"
+
+    /* Default number of ops in a strip pipe */
+static const l_int32  INITIAL_PTR_ARRAYSIZE = 8;
+
+static l_int32 stripPipeExtendArray(L_STRIP_PIPE *pipe);
+static PIX *stripReadWindow(L_STRIP_READER *sr, PIX *pixw, l_int32 wy0,
+                            l_int32 y0, l_int32 y1);
+static l_int32 stripFormatIsTiff(l_int32 format);
+
+
+/*---------------------------------------------------------------------*
+ *                             Strip reader                            *
+ *---------------------------------------------------------------------*/
+/*!
+ * \brief   stripReaderCreate()
+ *
+ * \param[in]    filename
+ * \return  sr, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This opens the file and reads the header.  The image is
+ *          decoded in row order with stripReaderRead().
+ *      (2) Supported formats are png, jpeg and tiff.  The strips
+ *          are returned at 1, 8 or 32 bpp:
+ *            ~ 1 bpp gray stays at 1 bpp
+ *            ~ other gray is returned at 8 bpp
+ *            ~ rgb and colormapped images are returned at 32 bpp,
+ *              with spp = 4 if there is an alpha channel
+ *          Interlaced png and tiled or colormapped tiff are not
+ *          supported; use pixRead() for these.
+ * </pre>
+ */
+L_STRIP_READER *
+stripReaderCreate(const char  *filename)
+{
+l_int32          format, ret;
+L_STRIP_READER  *sr;
+
+    PROCNAME("stripReaderCreate");
+
+    if (!filename)
+        return (L_STRIP_READER *)ERROR_PTR("filename not defined",
+                                           procName, NULL);
+
+    sr = (L_STRIP_READER *)LEPT_CALLOC(1, sizeof(L_STRIP_READER));
+    if ((sr->fp = fopenReadStream(filename)) == NULL) {
+        LEPT_FREE(sr);
+        return (L_STRIP_READER *)ERROR_PTR("image file not found",
+                                           procName, NULL);
+    }
+    findFileFormatStream(sr->fp, &format);
+    rewind(sr->fp);
+    sr->format = format;
+
+    if (format == IFF_PNG) {
+        ret = stripReadOpenPng(sr);
+    } else if (format == IFF_JFIF_JPEG) {
+        ret = stripReadOpenJpeg(sr);
+    } else if (stripFormatIsTiff(format)) {
+        ret = stripReadOpenTiff(sr);
+    } else {
+        L_ERROR("format %d not supported for strip reading\n",
+                procName, format);
+        ret = 1;
+    }
+
+    if (ret) {
+        stripReaderDestroy(&sr);
+        return (L_STRIP_READER *)ERROR_PTR("decoder not opened",
+                                           procName, NULL);
+    }
+    return sr;
+}
+
+
+/*!
+ * \brief   stripReaderDestroy()
+ *
+ * \param[in,out]   psr    will be set to null before returning
+ * \return  void
+ */
+void
+stripReaderDestroy(L_STRIP_READER  **psr)
+{
+L_STRIP_READER  *sr;
+
+    PROCNAME("stripReaderDestroy");
+
+    if (psr == NULL) {
+        L_WARNING("ptr address is null!\n", procName);
+        return;
+    }
+    if ((sr = *psr) == NULL)
+        return;
+
+    if (sr->format == IFF_PNG)
+        stripReadClosePng(sr);
+    else if (sr->format == IFF_JFIF_JPEG)
+        stripReadCloseJpeg(sr);
+    else if (stripFormatIsTiff(sr->format))
+        stripReadCloseTiff(sr);
+    if (sr->fp) fclose(sr->fp);
+    LEPT_FREE(sr);
+    *psr = NULL;
+}
+
+
+/*!
+ * \brief   stripReaderGetDimensions()
+ *
+ * \param[in]    sr
+ * \param[out]   pw, ph, pd    [optional] each can be null
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) The depth %d is that of the returned strips, not
+ *          necessarily the depth stored in the file.
+ * </pre>
+ */
+l_ok
+stripReaderGetDimensions(L_STRIP_READER  *sr,
+                         l_int32         *pw,
+                         l_int32         *ph,
+                         l_int32         *pd)
+{
+    PROCNAME("stripReaderGetDimensions");
+
+    if (pw) *pw = 0;
+    if (ph) *ph = 0;
+    if (pd) *pd = 0;
+    if (!sr)
+        return ERROR_INT("sr not defined", procName, 1);
+    if (pw) *pw = sr->w;
+    if (ph) *ph = sr->h;
+    if (pd) *pd = sr->d;
+    return 0;
+}
+
+
+/*!
+ * \brief   stripReaderRead()
+ *
+ * \param[in]    sr
+ * \param[in]    nrows    number of rows to decode; >= 1
+ * \return  pix holding the next strip, or NULL on error or when
+ *              all rows have been read
+ *
+ * <pre>
+ * Notes:
+ *      (1) The last strip is clipped to the bottom of the image,
+ *          so it may have fewer than %nrows rows.
+ *      (2) Returns NULL without an error message after the last
+ *          row has been read.
+ * </pre>
+ */
+PIX *
+stripReaderRead(L_STRIP_READER  *sr,
+                l_int32          nrows)
+{
+l_int32  ret;
+PIX     *pix;
+
+    PROCNAME("stripReaderRead");
+
+    if (!sr || !sr->codec)
+        return (PIX *)ERROR_PTR("sr or decoder not defined", procName, NULL);
+    if (nrows < 1)
+        return (PIX *)ERROR_PTR("nrows < 1", procName, NULL);
+    if (sr->nextrow >= sr->h)
+        return NULL;
+
+    nrows = L_MIN(nrows, sr->h - sr->nextrow);
+    if ((pix = pixCreate(sr->w, nrows, sr->d)) == NULL)
+        return (PIX *)ERROR_PTR("pix not made", procName, NULL);
+    pixSetSpp(pix, sr->spp);
+    pixSetResolution(pix, sr->xres, sr->yres);
+    pixSetInputFormat(pix, sr->format);
+
+    if (sr->format == IFF_PNG)
+        ret = stripReadRowsPng(sr, pix, nrows);
+    else if (sr->format == IFF_JFIF_JPEG)
+        ret = stripReadRowsJpeg(sr, pix, nrows);
+    else  /* tiff */
+        ret = stripReadRowsTiff(sr, pix, nrows);
+    if (ret) {
+        pixDestroy(&pix);
+        return (PIX *)ERROR_PTR("rows not decoded", procName, NULL);
+    }
+    sr->nextrow += nrows;
+    return pix;
+}
+
+
+/*---------------------------------------------------------------------*
+ *                             Strip writer                            *
+ *---------------------------------------------------------------------*/
+/*!
+ * \brief   stripWriterCreate()
+ *
+ * \param[in]    filename
+ * \param[in]    format     IFF_PNG, IFF_JFIF_JPEG, or one of the
+ *                          IFF_TIFF* formats
+ * \param[in]    h          full height of the image to be written
+ * \param[in]    quality    jpeg quality; use 0 for default
+ * \return  sw, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) The encoder is opened when the first strip is written;
+ *          the width, depth, spp and resolution are taken from it.
+ *      (2) All strips must be written with stripWriterWrite(),
+ *          followed by stripWriterFinish() to complete the file.
+ *          Then destroy the writer.
+ *      (3) Jpeg output requires 8 or 32 bpp strips.  The tiff fax
+ *          compressions are replaced by zip for strips that are
+ *          not 1 bpp.
+ * </pre>
+ */
+L_STRIP_WRITER *
+stripWriterCreate(const char  *filename,
+                  l_int32      format,
+                  l_int32      h,
+                  l_int32      quality)
+{
+L_STRIP_WRITER  *sw;
+
+    PROCNAME("stripWriterCreate");
+
+    if (!filename)
+        return (L_STRIP_WRITER *)ERROR_PTR("filename not defined",
+                                           procName, NULL);
+    if (format != IFF_PNG && format != IFF_JFIF_JPEG &&
+        !stripFormatIsTiff(format))
+        return (L_STRIP_WRITER *)ERROR_PTR("invalid format", procName, NULL);
+    if (h < 1)
+        return (L_STRIP_WRITER *)ERROR_PTR("h < 1", procName, NULL);
+    if (quality < 0 || quality > 100)
+        return (L_STRIP_WRITER *)ERROR_PTR("invalid quality", procName, NULL);
+
+    sw = (L_STRIP_WRITER *)LEPT_CALLOC(1, sizeof(L_STRIP_WRITER));
+    if ((sw->fp = fopenWriteStream(filename, "wb+")) == NULL) {
+        LEPT_FREE(sw);
+        return (L_STRIP_WRITER *)ERROR_PTR("stream not opened",
+                                           procName, NULL);
+    }
+    sw->format = format;
+    sw->h = h;
+    sw->quality = quality;
+    return sw;
+}
+
+
+/*!
+ * \brief   stripWriterDestroy()
+ *
+ * \param[in,out]   psw    will be set to null before returning
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) If stripWriterFinish() has not been called, the encoder
+ *          is abandoned and the file is incomplete.
+ * </pre>
+ */
+void
+stripWriterDestroy(L_STRIP_WRITER  **psw)
+{
+L_STRIP_WRITER  *sw;
+
+    PROCNAME("stripWriterDestroy");
+
+    if (psw == NULL) {
+        L_WARNING("ptr address is null!\n", procName);
+        return;
+    }
+    if ((sw = *psw) == NULL)
+        return;
+
+    if (sw->format == IFF_PNG)
+        stripWriteClosePng(sw, 0);
+    else if (sw->format == IFF_JFIF_JPEG)
+        stripWriteCloseJpeg(sw, 0);
+    else
+        stripWriteCloseTiff(sw, 0);
+    if (sw->fp) fclose(sw->fp);
+    LEPT_FREE(sw);
+    *psw = NULL;
+}
+
+
+/*!
+ * \brief   stripWriterWrite()
+ *
+ * \param[in]    sw
+ * \param[in]    pix    next strip; 1, 8 or 32 bpp, without colormap
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) All strips must have the width and depth of the first one,
+ *          and the total number of rows must not exceed the height
+ *          given to stripWriterCreate().
+ * </pre>
+ */
+l_ok
+stripWriterWrite(L_STRIP_WRITER  *sw,
+                 PIX             *pix)
+{
+l_int32  w, h, d, ret;
+
+    PROCNAME("stripWriterWrite");
+
+    if (!sw || !sw->fp)
+        return ERROR_INT("sw or stream not defined", procName, 1);
+    if (!pix)
+        return ERROR_INT("pix not defined", procName, 1);
+    if (pixGetColormap(pix))
+        return ERROR_INT("pix has colormap", procName, 1);
+    pixGetDimensions(pix, &w, &h, &d);
+    if (sw->nextrow + h > sw->h)
+        return ERROR_INT("too many rows for image", procName, 1);
+
+        /* Open the encoder with the parameters of the first strip */
+    if (sw->nextrow == 0 && !sw->codec) {
+        if (d != 1 && d != 8 && d != 32)
+            return ERROR_INT("depth not 1, 8 or 32 bpp", procName, 1);
+        sw->w = w;
+        sw->d = d;
+        sw->spp = (d == 32) ? pixGetSpp(pix) : 1;
+        pixGetResolution(pix, &sw->xres, &sw->yres);
+        if (sw->format == IFF_PNG)
+            ret = stripWriteOpenPng(sw);
+        else if (sw->format == IFF_JFIF_JPEG)
+            ret = stripWriteOpenJpeg(sw);
+        else
+            ret = stripWriteOpenTiff(sw);
+        if (ret) {
+            if (sw->format == IFF_PNG)
+                stripWriteClosePng(sw, 0);
+            else if (sw->format == IFF_JFIF_JPEG)
+                stripWriteCloseJpeg(sw, 0);
+            else
+                stripWriteCloseTiff(sw, 0);
+            return ERROR_INT("encoder not opened", procName, 1);
+        }
+    }
+    if (!sw->codec)
+        return ERROR_INT("encoder not defined", procName, 1);
+    if (w != sw->w || d != sw->d)
+        return ERROR_INT("strip size differs from first strip", procName, 1);
+
+    if (sw->format == IFF_PNG)
+        ret = stripWriteRowsPng(sw, pix);
+    else if (sw->format == IFF_JFIF_JPEG)
+        ret = stripWriteRowsJpeg(sw, pix);
+    else
+        ret = stripWriteRowsTiff(sw, pix);
+    if (ret)
+        return ERROR_INT("rows not encoded", procName, 1);
+    sw->nextrow += h;
+    return 0;
+}
+
+
+/*!
+ * \brief   stripWriterFinish()
+ *
+ * \param[in]    sw
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This completes and closes the file.  It is an error if
+ *          fewer rows have been written than the image height.
+ * </pre>
+ */
+l_ok
+stripWriterFinish(L_STRIP_WRITER  *sw)
+{
+l_int32  ret;
+
+    PROCNAME("stripWriterFinish");
+
+    if (!sw || !sw->fp || !sw->codec)
+        return ERROR_INT("sw, stream or encoder not defined", procName, 1);
+    if (sw->nextrow != sw->h)
+        return ERROR_INT("not all rows written", procName, 1);
+
+    if (sw->format == IFF_PNG)
+        ret = stripWriteClosePng(sw, 1);
+    else if (sw->format == IFF_JFIF_JPEG)
+        ret = stripWriteCloseJpeg(sw, 1);
+    else
+        ret = stripWriteCloseTiff(sw, 1);
+    if (fclose(sw->fp))
+        ret = 1;
+    sw->fp = NULL;
+    if (ret)
+        return ERROR_INT("file not completed", procName, 1);
+    return 0;
+}
+
+
+/*---------------------------------------------------------------------*
+ *                            Strip pipeline                           *
+ *---------------------------------------------------------------------*/
+/*!
+ * \brief   stripPipeCreate()
+ *
+ * \return  pipe, or NULL on error
+ */
+L_STRIP_PIPE *
+stripPipeCreate(void)
+{
+L_STRIP_PIPE  *pipe;
+
+    pipe = (L_STRIP_PIPE *)LEPT_CALLOC(1, sizeof(L_STRIP_PIPE));
+    pipe->nalloc = INITIAL_PTR_ARRAYSIZE;
+    pipe->op = (L_STRIP_OP *)LEPT_CALLOC(pipe->nalloc, sizeof(L_STRIP_OP));
+    return pipe;
+}
+
+
+/*!
+ * \brief   stripPipeDestroy()
+ *
+ * \param[in,out]   ppipe    will be set to null before returning
+ * \return  void
+ */
+void
+stripPipeDestroy(L_STRIP_PIPE  **ppipe)
+{
+l_int32        i;
+L_STRIP_PIPE  *pipe;
+
+    PROCNAME("stripPipeDestroy");
+
+    if (ppipe == NULL) {
+        L_WARNING("ptr address is null!\n", procName);
+        return;
+    }
+    if ((pipe = *ppipe) == NULL)
+        return;
+
+    for (i = 0; i < pipe->n; i++)
+        numaDestroy(&pipe->op[i].na);
+    LEPT_FREE(pipe->op);
+    LEPT_FREE(pipe);
+    *ppipe = NULL;
+}
+
+
+/*!
+ * \brief   stripPipeAddTRC()
+ *
+ * \param[in]    pipe
+ * \param[in]    na     map from input to output value; 256 entries
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) A copy of %na is stored.  The map is applied with
+ *          pixTRCMap() to 8 bpp gray, or to each component of rgb.
+ *          Use, e.g., numaGammaTRC() to make the map.
+ * </pre>
+ */
+l_ok
+stripPipeAddTRC(L_STRIP_PIPE  *pipe,
+                NUMA          *na)
+{
+L_STRIP_OP  *op;
+
+    PROCNAME("stripPipeAddTRC");
+
+    if (!pipe)
+        return ERROR_INT("pipe not defined", procName, 1);
+    if (!na || numaGetCount(na) != 256)
+        return ERROR_INT("na not defined or not of size 256", procName, 1);
+
+    if (pipe->n >= pipe->nalloc && stripPipeExtendArray(pipe))
+        return ERROR_INT("extension failed", procName, 1);
+    op = &pipe->op[pipe->n++];
+    op->type = L_STRIP_TRC;
+    op->na = numaCopy(na);
+    return 0;
+}
+
+
+/*!
+ * \brief   stripPipeAddConvertToGray()
+ *
+ * \param[in]    pipe
+ * \param[in]    rwt, gwt, bwt    non-negative; these should add to 1.0,
+ *                                or use 0.0 for default
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) See pixConvertRGBToGray().  An 8 bpp strip is unchanged.
+ * </pre>
+ */
+l_ok
+stripPipeAddConvertToGray(L_STRIP_PIPE  *pipe,
+                          l_float32      rwt,
+                          l_float32      gwt,
+                          l_float32      bwt)
+{
+L_STRIP_OP  *op;
+
+    PROCNAME("stripPipeAddConvertToGray");
+
+    if (!pipe)
+        return ERROR_INT("pipe not defined", procName, 1);
+    if (rwt < 0.0 || gwt < 0.0 || bwt < 0.0)
+        return ERROR_INT("weights not all >= 0.0", procName, 1);
+
+    if (pipe->n >= pipe->nalloc && stripPipeExtendArray(pipe))
+        return ERROR_INT("extension failed", procName, 1);
+    op = &pipe->op[pipe->n++];
+    op->type = L_STRIP_CONVERT_TO_GRAY;
+    op->fval[0] = rwt;
+    op->fval[1] = gwt;
+    op->fval[2] = bwt;
+    return 0;
+}
+
+
+/*!
+ * \brief   stripPipeAddThreshold()
+ *
+ * \param[in]    pipe
+ * \param[in]    thresh    threshold value for an 8 bpp strip
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) See pixThresholdToBinary().  The strip must be 8 bpp
+ *          when this operation is reached.
+ * </pre>
+ */
+l_ok
+stripPipeAddThreshold(L_STRIP_PIPE  *pipe,
+                      l_int32        thresh)
+{
+L_STRIP_OP  *op;
+
+    PROCNAME("stripPipeAddThreshold");
+
+    if (!pipe)
+        return ERROR_INT("pipe not defined", procName, 1);
+    if (thresh < 0 || thresh > 256)
+        return ERROR_INT("thresh not in [0 ... 256]", procName, 1);
+
+    if (pipe->n >= pipe->nalloc && stripPipeExtendArray(pipe))
+        return ERROR_INT("extension failed", procName, 1);
+    op = &pipe->op[pipe->n++];
+    op->type = L_STRIP_THRESHOLD;
+    op->ival[0] = thresh;
+    return 0;
+}
+
+
+/*!
+ * \brief   stripPipeAddBlockconv()
+ *
+ * \param[in]    pipe
+ * \param[in]    wc, hc   half width/height of convolution kernel; >= 0
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) See pixBlockconv().  The strip must be 8 or 32 bpp.
+ *      (2) This adds (hc + 1) rows to the halo of the pipe.
+ * </pre>
+ */
+l_ok
+stripPipeAddBlockconv(L_STRIP_PIPE  *pipe,
+                      l_int32        wc,
+                      l_int32        hc)
+{
+L_STRIP_OP  *op;
+
+    PROCNAME("stripPipeAddBlockconv");
+
+    if (!pipe)
+        return ERROR_INT("pipe not defined", procName, 1);
+    if (wc < 0 || hc < 0)
+        return ERROR_INT("wc and hc not both >= 0", procName, 1);
+
+    if (pipe->n >= pipe->nalloc && stripPipeExtendArray(pipe))
+        return ERROR_INT("extension failed", procName, 1);
+    op = &pipe->op[pipe->n++];
+    op->type = L_STRIP_BLOCKCONV;
+    op->ival[0] = wc;
+    op->ival[1] = hc;
+    pipe->halo += hc + 1;
+    return 0;
+}
+
+
+/*!
+ * \brief   stripPipeExtendArray()
+ *
+ * \param[in]    pipe
+ * \return  0 if OK, 1 on error
+ */
+static l_int32
+stripPipeExtendArray(L_STRIP_PIPE  *pipe)
+{
+    PROCNAME("stripPipeExtendArray");
+
+    if ((pipe->op = (L_STRIP_OP *)reallocNew((void **)&pipe->op,
+                                sizeof(L_STRIP_OP) * pipe->nalloc,
+                                2 * sizeof(L_STRIP_OP) * pipe->nalloc)) == NULL)
+        return ERROR_INT("new ptr array not returned", procName, 1);
+    pipe->nalloc *= 2;
+    return 0;
+}
+
+
+/*!
+ * \brief   stripPipeApply()
+ *
+ * \param[in]    pipe
+ * \param[in]    pixs    strip or entire image
+ * \return  pixd, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This applies the operations of the pipe in order.  pixs
+ *          is not altered.
+ *      (2) Applied to an entire image, this gives the result that
+ *          stripPipeProcess() produces a strip at a time.
+ * </pre>
+ */
+PIX *
+stripPipeApply(L_STRIP_PIPE  *pipe,
+               PIX           *pixs)
+{
+l_int32      i, d;
+L_STRIP_OP  *op;
+PIX         *pix1, *pix2;
+
+    PROCNAME("stripPipeApply");
+
+    if (!pipe)
+        return (PIX *)ERROR_PTR("pipe not defined", procName, NULL);
+    if (!pixs)
+        return (PIX *)ERROR_PTR("pixs not defined", procName, NULL);
+    if (pixGetColormap(pixs))
+        return (PIX *)ERROR_PTR("pixs has colormap", procName, NULL);
+
+    pix1 = pixClone(pixs);
+    for (i = 0; i < pipe->n; i++) {
+        op = &pipe->op[i];
+        d = pixGetDepth(pix1);
+        pix2 = NULL;
+        switch (op->type)
+        {
+        case L_STRIP_TRC:
+            if (d != 8 && d != 32) {
+                L_ERROR("TRC requires 8 or 32 bpp\n", procName);
+                break;
+            }
+            if ((pix2 = pixCopy(NULL, pix1)) != NULL)
+                pixTRCMap(pix2, NULL, op->na);
+            break;
+        case L_STRIP_CONVERT_TO_GRAY:
+            if (d == 8)
+                pix2 = pixClone(pix1);
+            else if (d == 32)
+                pix2 = pixConvertRGBToGray(pix1, op->fval[0], op->fval[1],
+                                           op->fval[2]);
+            else
+                L_ERROR("gray conversion requires 8 or 32 bpp\n", procName);
+            break;
+        case L_STRIP_THRESHOLD:
+            if (d != 8) {
+                L_ERROR("threshold requires 8 bpp\n", procName);
+                break;
+            }
+            pix2 = pixThresholdToBinary(pix1, op->ival[0]);
+            break;
+        case L_STRIP_BLOCKCONV:
+            if (d != 8 && d != 32) {
+                L_ERROR("blockconv requires 8 or 32 bpp\n", procName);
+                break;
+            }
+            pix2 = pixBlockconv(pix1, op->ival[0], op->ival[1]);
+            break;
+        default:
+            L_ERROR("invalid op type %d\n", procName, op->type);
+            break;
+        }
+        pixDestroy(&pix1);
+        if (!pix2)
+            return (PIX *)ERROR_PTR("operation failed", procName, NULL);
+        pix1 = pix2;
+    }
+    return pix1;
+}
+
+
+/*!
+ * \brief   stripPipeProcess()
+ *
+ * \param[in]    pipe       [optional] can be null to transcode only
+ * \param[in]    filein     png, jpeg or tiff
+ * \param[in]    fileout
+ * \param[in]    format     IFF_PNG, IFF_JFIF_JPEG, or one of IFF_TIFF*
+ * \param[in]    striph     number of output rows in each strip
+ * \param[in]    quality    jpeg quality; use 0 for default
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This decodes %filein, applies the pipe and encodes the
+ *          result to %fileout, a strip at a time.  Only a window of
+ *          %striph rows plus the halo of the pipe above and below
+ *          is held in memory.
+ *      (2) %striph is raised to (2 * halo + 1) if necessary, so that
+ *          the neighborhood operations always see a window at least
+ *          as large as their kernel.  The last strip takes any rows
+ *          that remain, to avoid a sliver at the bottom.
+ *      (3) Rows of the window that are still needed for the next strip
+ *          are carried over, so each row is decoded only once.
+ * </pre>
+ */
+l_ok
+stripPipeProcess(L_STRIP_PIPE  *pipe,
+                 const char    *filein,
+                 const char    *fileout,
+                 l_int32        format,
+                 l_int32        striph,
+                 l_int32        quality)
+{
+l_int32          w, h, halo, y0, y1, wy0, wy1, ret;
+L_STRIP_READER  *sr;
+L_STRIP_WRITER  *sw;
+PIX             *pixw, *pix1, *pix2;
+BOX             *box;
+
+    PROCNAME("stripPipeProcess");
+
+    if (!filein || !fileout)
+        return ERROR_INT("filein and fileout not both defined", procName, 1);
+    if (striph < 1)
+        return ERROR_INT("striph < 1", procName, 1);
+
+    if ((sr = stripReaderCreate(filein)) == NULL)
+        return ERROR_INT("reader not made", procName, 1);
+    stripReaderGetDimensions(sr, &w, &h, NULL);
+    if ((sw = stripWriterCreate(fileout, format, h, quality)) == NULL) {
+        stripReaderDestroy(&sr);
+        return ERROR_INT("writer not made", procName, 1);
+    }
+    halo = (pipe) ? pipe->halo : 0;
+    striph = L_MAX(striph, 2 * halo + 1);
+
+        /* The window holds rows [wy0, wy1) of the input image */
+    ret = 0;
+    pixw = NULL;
+    wy0 = 0;
+    for (y0 = 0; y0 < h; y0 = y1) {
+        y1 = y0 + striph;
+        if (h - y1 < striph) y1 = h;
+        wy1 = L_MIN(h, y1 + halo);
+        if ((pix1 = stripReadWindow(sr, pixw, wy0, L_MAX(0, y0 - halo),
+                                    wy1)) == NULL) {
+            L_ERROR("window not read at y = %d\n", procName, y0);
+            ret = 1;
+            break;
+        }
+        pixDestroy(&pixw);
+        pixw = pix1;
+        wy0 = L_MAX(0, y0 - halo);
+
+        pix1 = (pipe) ? stripPipeApply(pipe, pixw) : pixClone(pixw);
+        box = boxCreate(0, y0 - wy0, w, y1 - y0);
+        pix2 = pixClipRectangle(pix1, box, NULL);
+        pixCopySpp(pix2, pix1);
+        boxDestroy(&box);
+        pixDestroy(&pix1);
+        if (!pix2 || stripWriterWrite(sw, pix2)) {
+            L_ERROR("strip not written at y = %d\n", procName, y0);
+            pixDestroy(&pix2);
+            ret = 1;
+            break;
+        }
+        pixDestroy(&pix2);
+    }
+    pixDestroy(&pixw);
+
+    if (!ret && stripWriterFinish(sw))
+        ret = 1;
+    stripWriterDestroy(&sw);
+    stripReaderDestroy(&sr);
+    if (ret)
+        return ERROR_INT("file not processed", procName, 1);
+    return 0;
+}
+
+
+/*!
+ * \brief   stripReadWindow()
+ *
+ * \param[in]    sr
+ * \param[in]    pixw    [optional] current window, holding rows starting
+ *                       at %wy0 and ending at the next row to be decoded
+ * \param[in]    wy0     first image row in %pixw
+ * \param[in]    y0      first image row of the new window
+ * \param[in]    y1      first image row below the new window
+ * \return  pix holding rows [y0, y1) of the image, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) Rows in both windows are copied from %pixw; the rest are
+ *          decoded.  It is required that %wy0 <= %y0, and that %y0
+ *          is not below the rows held in %pixw.
+ * </pre>
+ */
+static PIX *
+stripReadWindow(L_STRIP_READER  *sr,
+                PIX             *pixw,
+                l_int32          wy0,
+                l_int32          y0,
+                l_int32          y1)
+{
+l_int32  ncopy, nread;
+PIX     *pixd, *pix1;
+
+    PROCNAME("stripReadWindow");
+
+    ncopy = (pixw) ? sr->nextrow - y0 : 0;
+    nread = y1 - sr->nextrow;
+    if (ncopy < 0 || nread < 0 || y0 < wy0)
+        return (PIX *)ERROR_PTR("invalid window", procName, NULL);
+
+    if ((pixd = pixCreate(sr->w, y1 - y0, sr->d)) == NULL)
+        return (PIX *)ERROR_PTR("pixd not made", procName, NULL);
+    pixSetSpp(pixd, sr->spp);
+    pixSetResolution(pixd, sr->xres, sr->yres);
+    pixSetInputFormat(pixd, sr->format);
+    if (ncopy > 0)
+        pixRasterop(pixd, 0, 0, sr->w, ncopy, PIX_SRC, pixw, 0, y0 - wy0);
+    if (nread > 0) {
+        if ((pix1 = stripReaderRead(sr, nread)) == NULL) {
+            pixDestroy(&pixd);
+            return (PIX *)ERROR_PTR("rows not read", procName, NULL);
+        }
+        pixRasterop(pixd, 0, ncopy, sr->w, nread, PIX_SRC, pix1, 0, 0);
+        pixDestroy(&pix1);
+    }
+    return pixd;
+}
+
+
+/*---------------------------------------------------------------------*
+ *                            Format helpers                           *
+ *---------------------------------------------------------------------*/
+/*!
+ * \brief   stripFormatIsTiff()
+ *
+ * \param[in]    format
+ * \return  1 if one of the tiff formats, 0 otherwise
+ */
+static l_int32
+stripFormatIsTiff(l_int32  format)
+{
+    return (format == IFF_TIFF || format == IFF_TIFF_PACKBITS ||
+            format == IFF_TIFF_RLE || format == IFF_TIFF_G3 ||
+            format == IFF_TIFF_G4 || format == IFF_TIFF_LZW ||
+            format == IFF_TIFF_ZIP || format == IFF_TIFF_JPEG);
+}
@@ -40,6 +40,12 @@
  *             PIX       *pixReadStreamTiff()
  *      static PIX       *pixReadFromTiffStream()
  *
+ *     Reading region of tiff:
+ *             PIX       *pixReadTiffRegion()       [ special top level ]
+ *             PIX       *pixReadStreamTiffRegion()
+ *      static PIX       *pixReadFromTiffRegion()
+ *      static void       tiffBlockToPix()
+ *
  *     Writing tiff:
  *             l_int32    pixWriteTiff()            [ special top level ]
  *             l_int32    pixWriteTiffCustom()      [ special top level ]
@@ -70,6 +76,14 @@
  *     Extraction of tiff g4 data:
  *             l_int32    extractG4DataFromFile()
  *
+ *     Strip-streaming tiff:
+ *             l_int32    stripReadOpenTiff()
+ *             l_int32    stripReadRowsTiff()
+ *             void       stripReadCloseTiff()
+ *             l_int32    stripWriteOpenTiff()
+ *             l_int32    stripWriteRowsTiff()
+ *             l_int32    stripWriteCloseTiff()
+ *
  *     Open tiff stream from file stream
  *      static TIFF      *fopenTiff()
  *
@@ -125,6 +139,7 @@ static const l_uint32  MaxTiffBufferSize = 1 << 24;  /* 16MiB */
 
     /* All functions with TIFF interfaces are static. */
 static PIX      *pixReadFromTiffStream(TIFF *tif);
+static PIX      *pixReadFromTiffRegion(TIFF *tif, BOX *box);
 static l_int32   getTiffStreamResolution(TIFF *tif, l_int32 *pxres,
                                          l_int32 *pyres);
 static l_int32   tiffReadHeaderTiff(TIFF *tif, l_int32 *pwidth,
@@ -143,10 +158,24 @@ static TIFF     *openTiff(const char *filename, const char *modestring);
     /* Static helper for tiff compression type */
 static l_int32   getTiffCompressedFormat(l_uint16 tiffcomp);
 
+    /* Static helper for reading a region */
+static void      tiffBlockToPix(l_uint8 *buf, l_int32 bpl, l_int32 nrows,
+                                l_int32 spp, l_int32 bps, PIX *pixt);
+
     /* Static function for memory I/O */
 static TIFF     *fopenTiffMemstream(const char *filename, const char *operation,
                                     l_uint8 **pdata, size_t *pdatasize);
 
+    /* Decoder or encoder state for strip-streaming tiff */
+struct TiffStripState
+{
+    TIFF      *tif;
+    l_uint8   *linebuf;     /* one scanline of tiff samples */
+    l_uint32   tiffbpl;     /* bytes in a tiff scanline */
+    l_int32    invert;      /* samples must be inverted on read */
+};
+typedef struct TiffStripState  TIFF_STRIP_STATE;
+
     /* This structure defines a transform to be performed on a TIFF image
      * (note that the same transformation can be represented in
      * several different ways using this structure since
@@ -710,6 +739,367 @@ PIXCMAP   *cmap;
 
 
 
+/*--------------------------------------------------------------*
+ *                  Reading region from file                    *
+ *--------------------------------------------------------------*/
+/*!
+ * \brief   pixReadTiffRegion()
+ *
+ * \param[in]    filename
+ * \param[in]    n           page number 0 based
+ * \param[in]    box         region to be read
+ * \return  pix, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This is a version of pixReadTiff() that decodes only the
+ *          tiles or strips that intersect %box.
+ *          See pixReadStreamTiffRegion().
+ * </pre>
+ */
+PIX *
+pixReadTiffRegion(const char  *filename,
+                  l_int32      n,
+                  BOX         *box)
+{
+FILE  *fp;
+PIX   *pix;
+
+    PROCNAME("pixReadTiffRegion");
+
+    if (!filename)
+        return (PIX *)ERROR_PTR("filename not defined", procName, NULL);
+    if (!box)
+        return (PIX *)ERROR_PTR("box not defined", procName, NULL);
+
+    if ((fp = fopenReadStream(filename)) == NULL)
+        return (PIX *)ERROR_PTR("image file not found", procName, NULL);
+    pix = pixReadStreamTiffRegion(fp, n, box);
+    fclose(fp);
+    return pix;
+}
+
+
+/*!
+ * \brief   pixReadStreamTiffRegion()
+ *
+ * \param[in]    fp     file stream
+ * \param[in]    n      page number: 0 based
+ * \param[in]    box    region to be read
+ * \return  pix, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) %box is clipped to the image.  The result is the same as
+ *          clipping %box from the image returned by pixReadStreamTiff().
+ *      (2) For a tiled image, only the tiles that intersect %box are
+ *          decoded.  For an image in strips, only the strips that
+ *          intersect %box are decoded, and decoding stops at the bottom
+ *          of %box.  A compressed strip can only be decoded from its
+ *          start, so the rows above %box in the first strip are also
+ *          decoded.  One tile or one row is held in memory at a time.
+ *      (3) The region is read directly for the following images,
+ *          with samples stored contiguously in the normal orientation:
+ *            ~ 1 spp (gray or colormapped): 1, 2, 4, 8, 16 bps
+ *            ~ 2 spp (gray+alpha): 8 bps
+ *            ~ 3 spp (rgb) and 4 spp (rgba with associated alpha): 8 bps
+ *          Other images, such as those in old jpeg, YCbCr or with
+ *          rotated orientation, are read entirely and then clipped.
+ * </pre>
+ */
+PIX *
+pixReadStreamTiffRegion(FILE    *fp,
+                        l_int32  n,
+                        BOX     *box)
+{
+PIX   *pix;
+TIFF  *tif;
+
+    PROCNAME("pixReadStreamTiffRegion");
+
+    if (!fp)
+        return (PIX *)ERROR_PTR("stream not defined", procName, NULL);
+    if (!box)
+        return (PIX *)ERROR_PTR("box not defined", procName, NULL);
+
+    if ((tif = fopenTiff(fp, "r")) == NULL)
+        return (PIX *)ERROR_PTR("tif not opened", procName, NULL);
+    if (TIFFSetDirectory(tif, n) == 0) {
+        TIFFCleanup(tif);
+        return (PIX *)ERROR_PTR("page not found", procName, NULL);
+    }
+    pix = pixReadFromTiffRegion(tif, box);
+    TIFFCleanup(tif);
+    return pix;
+}
+
+
+/*!
+ * \brief   pixReadFromTiffRegion()
+ *
+ * \param[in]    tif    TIFF handle
+ * \param[in]    box    region to be read
+ * \return  pix, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) The tiles, or the rows of the strips, are decoded in order
+ *          into a temporary pix, and the part within %box is copied
+ *          into the returned pix.  Photometric inversion and the
+ *          colormap are handled as in pixReadFromTiffStream().
+ * </pre>
+ */
+static PIX *
+pixReadFromTiffRegion(TIFF  *tif,
+                      BOX   *box)
+{
+char      *text;
+l_uint8   *buf;
+l_uint16   spp, bps, sample_fmt, planar, photometry, tiffcomp;
+l_uint16   orientation, nextra;
+l_uint16  *redmap, *greenmap, *bluemap, *extra;
+l_int32    d, i, ncolors, bx, by, bw, bh, x0, y0, x1, y1, tx, ty, ty0;
+l_int32    nrows, xres, yres, direct, tiled;
+l_uint32   w, h, tw, th, rowsperstrip, tilebpl, bufsize;
+BOX       *boxc;
+PIX       *pixd, *pixt, *pix1;
+PIXCMAP   *cmap;
+
+    PROCNAME("pixReadFromTiffRegion");
+
+    if (!tif)
+        return (PIX *)ERROR_PTR("tif not defined", procName, NULL);
+
+        /* Decide if the region can be read directly */
+    TIFFGetFieldDefaulted(tif, TIFFTAG_SAMPLEFORMAT, &sample_fmt);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_BITSPERSAMPLE, &bps);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_SAMPLESPERPIXEL, &spp);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_PLANARCONFIG, &planar);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_COMPRESSION, &tiffcomp);
+    if (!TIFFGetField(tif, TIFFTAG_PHOTOMETRIC, &photometry)) {
+        if (tiffcomp == COMPRESSION_CCITTFAX3 ||
+            tiffcomp == COMPRESSION_CCITTFAX4 ||
+            tiffcomp == COMPRESSION_CCITTRLE ||
+            tiffcomp == COMPRESSION_CCITTRLEW) {
+            photometry = PHOTOMETRIC_MINISWHITE;
+        } else {
+            photometry = PHOTOMETRIC_MINISBLACK;
+        }
+    }
+    orientation = ORIENTATION_TOPLEFT;
+    TIFFGetField(tif, TIFFTAG_ORIENTATION, &orientation);
+    nextra = 0;
+    TIFFGetField(tif, TIFFTAG_EXTRASAMPLES, &nextra, &extra);
+    direct = (sample_fmt == SAMPLEFORMAT_UINT &&
+              planar == PLANARCONFIG_CONTIG &&
+              tiffcomp != COMPRESSION_OJPEG &&
+              orientation == ORIENTATION_TOPLEFT);
+    if (spp == 1) {
+        direct = direct &&
+                 (bps == 1 || bps == 2 || bps == 4 || bps == 8 || bps == 16) &&
+                 (photometry == PHOTOMETRIC_MINISWHITE ||
+                  photometry == PHOTOMETRIC_MINISBLACK ||
+                  photometry == PHOTOMETRIC_PALETTE);
+    } else if (spp == 2) {
+        direct = direct && bps == 8 &&
+                 (photometry == PHOTOMETRIC_MINISWHITE ||
+                  photometry == PHOTOMETRIC_MINISBLACK);
+    } else if (spp == 3 || spp == 4) {
+            /* Unassociated alpha is premultiplied by libtiff in
+             * pixReadFromTiffStream(), so it must be read that way */
+        direct = direct && bps == 8 && photometry == PHOTOMETRIC_RGB &&
+                 (spp == 3 || nextra == 0 ||
+                  extra[0] == EXTRASAMPLE_ASSOCALPHA);
+    } else {
+        return (PIX *)ERROR_PTR("spp not in set {1,2,3,4}", procName, NULL);
+    }
+
+    if (!direct) {
+        L_INFO("reading the entire image\n", procName);
+        if ((pix1 = pixReadFromTiffStream(tif)) == NULL)
+            return (PIX *)ERROR_PTR("pix1 not read", procName, NULL);
+        pixd = pixClipRectangle(pix1, box, NULL);
+        if (pixd) {
+            pixCopySpp(pixd, pix1);
+            pixCopyInputFormat(pixd, pix1);
+        }
+        pixDestroy(&pix1);
+        if (!pixd)
+            return (PIX *)ERROR_PTR("box not within image", procName, NULL);
+        return pixd;
+    }
+
+        /* Find the block size: a tile, or one row of a strip.
+         * Reading of strips starts at the first row of the strip
+         * that contains the top of the box. */
+    TIFFGetField(tif, TIFFTAG_IMAGEWIDTH, &w);
+    TIFFGetField(tif, TIFFTAG_IMAGELENGTH, &h);
+    if ((boxc = boxClipToRectangle(box, w, h)) == NULL)
+        return (PIX *)ERROR_PTR("box not within image", procName, NULL);
+    boxGetGeometry(boxc, &bx, &by, &bw, &bh);
+    boxDestroy(&boxc);
+    tiled = TIFFIsTiled(tif);
+    if (tiled) {
+        tw = th = 0;
+        TIFFGetField(tif, TIFFTAG_TILEWIDTH, &tw);
+        TIFFGetField(tif, TIFFTAG_TILELENGTH, &th);
+        if (tw == 0 || th == 0)
+            return (PIX *)ERROR_PTR("bad tiff file: invalid tile size",
+                                    procName, NULL);
+        tilebpl = TIFFTileRowSize(tif);
+        bufsize = TIFFTileSize(tif);
+        ty0 = by - by % th;
+    } else {
+        tw = w;
+        th = 1;
+        tilebpl = TIFFScanlineSize(tif);
+        bufsize = tilebpl;
+        TIFFGetFieldDefaulted(tif, TIFFTAG_ROWSPERSTRIP, &rowsperstrip);
+        rowsperstrip = L_MAX(1, L_MIN(rowsperstrip, h));
+        ty0 = by - by % rowsperstrip;
+    }
+    if (bufsize > MaxTiffBufferSize)
+        return (PIX *)ERROR_PTR("bad tiff file: block is too large",
+                                procName, NULL);
+    if (tilebpl < ((l_uint64)bps * spp * tw + 7) / 8 ||
+        bufsize / th < tilebpl)
+        return (PIX *)ERROR_PTR("bad tiff file: block is too small",
+                                procName, NULL);
+
+    d = (spp == 1) ? bps : 32;
+    pixd = pixCreate(bw, bh, d);
+    pixt = pixCreate(tw, th, d);
+    buf = (l_uint8 *)LEPT_CALLOC(bufsize + 1, sizeof(l_uint8));
+    if (!pixd || !pixt || !buf) {
+        pixDestroy(&pixd);
+        pixDestroy(&pixt);
+        LEPT_FREE(buf);
+        return (PIX *)ERROR_PTR("pixd, pixt or buf not made", procName, NULL);
+    }
+    if (spp == 2 || spp == 4) {  /* gray+alpha is returned as rgba */
+        pixSetSpp(pixd, 4);
+        pixSetSpp(pixt, 4);
+    }
+
+    for (ty = ty0; ty < by + bh; ty += th) {
+        nrows = L_MIN(th, h - ty);
+        for (tx = bx - bx % tw; tx < bx + bw; tx += tw) {
+            if ((tiled && TIFFReadEncodedTile(tif,
+                                  TIFFComputeTile(tif, tx, ty, 0, 0),
+                                  buf, bufsize) < 0) ||
+                (!tiled && TIFFReadScanline(tif, buf, ty, 0) < 0)) {
+                pixDestroy(&pixd);
+                pixDestroy(&pixt);
+                LEPT_FREE(buf);
+                return (PIX *)ERROR_PTR("block read fail", procName, NULL);
+            }
+            y0 = L_MAX(by, ty);
+            y1 = L_MIN(by + bh, ty + nrows);
+            if (y1 <= y0)  /* row of the first strip above the box */
+                continue;
+            x0 = L_MAX(bx, tx);
+            x1 = L_MIN(bx + bw, tx + tw);
+            tiffBlockToPix(buf, tilebpl, nrows, spp, bps, pixt);
+            pixRasterop(pixd, x0 - bx, y0 - by, x1 - x0, y1 - y0, PIX_SRC,
+                        pixt, x0 - tx, y0 - ty);
+        }
+    }
+    pixDestroy(&pixt);
+    LEPT_FREE(buf);
+
+    if (getTiffStreamResolution(tif, &xres, &yres) == 0) {
+        pixSetXRes(pixd, xres);
+        pixSetYRes(pixd, yres);
+    }
+    pixSetInputFormat(pixd, getTiffCompressedFormat(tiffcomp));
+
+    if (TIFFGetField(tif, TIFFTAG_COLORMAP, &redmap, &greenmap, &bluemap)) {
+        if (bps > 8) {
+            pixDestroy(&pixd);
+            return (PIX *)ERROR_PTR("colormap size > 256", procName, NULL);
+        }
+        if ((cmap = pixcmapCreate(bps)) == NULL) {
+            pixDestroy(&pixd);
+            return (PIX *)ERROR_PTR("colormap not made", procName, NULL);
+        }
+        ncolors = 1 << bps;
+        for (i = 0; i < ncolors; i++)
+            pixcmapAddColor(cmap, redmap[i] >> 8, greenmap[i] >> 8,
+                            bluemap[i] >> 8);
+        pixSetColormap(pixd, cmap);
+    } else if ((d == 1 && photometry == PHOTOMETRIC_MINISBLACK) ||
+               (d == 8 && photometry == PHOTOMETRIC_MINISWHITE)) {
+        pixInvert(pixd, pixd);
+    }
+
+    text = NULL;
+    TIFFGetField(tif, TIFFTAG_IMAGEDESCRIPTION, &text);
+    if (text) pixSetText(pixd, text);
+    return pixd;
+}
+
+
+/*!
+ * \brief   tiffBlockToPix()
+ *
+ * \param[in]    buf      decoded tile or row, as stored in the tiff file
+ * \param[in]    bpl      bytes/line in %buf
+ * \param[in]    nrows    number of rows in %buf
+ * \param[in]    spp      samples/pixel: 1, 2, 3 or 4
+ * \param[in]    bps      bits/sample; 8 if %spp > 1
+ * \param[in]    pixt     pix of the block size, into which the rows
+ *                        are written
+ * \return  void
+ */
+static void
+tiffBlockToPix(l_uint8  *buf,
+               l_int32   bpl,
+               l_int32   nrows,
+               l_int32   spp,
+               l_int32   bps,
+               PIX      *pixt)
+{
+l_uint8   *rowptr;
+l_int32    i, j, k, w, wpl, rval, gval, bval, aval;
+l_uint32  *data, *ppixel;
+
+    w = pixGetWidth(pixt);
+    data = pixGetData(pixt);
+    wpl = pixGetWpl(pixt);
+    if (spp == 1) {
+        for (i = 0; i < nrows; i++)
+            memcpy(data + i * wpl, buf + i * bpl, L_MIN(bpl, 4 * wpl));
+        if (bps <= 8)
+            pixEndianByteSwap(pixt);
+        else   /* bps == 16 */
+            pixEndianTwoByteSwap(pixt);
+        return;
+    }
+
+    for (i = 0; i < nrows; i++) {
+        rowptr = buf + i * bpl;
+        ppixel = data + i * wpl;
+        for (j = k = 0; j < w; j++) {
+            if (spp == 2) {  /* copy gray value into r, g and b */
+                rval = gval = bval = rowptr[k++];
+                aval = rowptr[k++];
+                composeRGBAPixel(rval, gval, bval, aval, ppixel);
+            } else {
+                rval = rowptr[k++];
+                gval = rowptr[k++];
+                bval = rowptr[k++];
+                if (spp == 3) {
+                    composeRGBPixel(rval, gval, bval, ppixel);
+                } else {  /* spp == 4 */
+                    aval = rowptr[k++];
+                    composeRGBAPixel(rval, gval, bval, aval, ppixel);
+                }
+            }
+            ppixel++;
+        }
+    }
+}
+
 /*--------------------------------------------------------------*
  *                       Writing to file                        *
  *--------------------------------------------------------------*/
@@ -2159,6 +2549,389 @@ TIFF     *tif;
 }
 
 
+/*--------------------------------------------------------------*
+ *                   Strip-streaming tiff I/O                   *
+ *--------------------------------------------------------------*/
+/*!
+ * \brief   stripReadOpenTiff()
+ *
+ * \param[in]    sr     strip reader, with open stream
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This reads the header of the first image and prepares to
+ *          decode it a scanline at a time.  Supported are:
+ *            ~ 1 bps gray --> 1 bpp
+ *            ~ 8 bps gray --> 8 bpp
+ *            ~ 8 bps rgb and rgba, contiguous samples --> 32 bpp
+ *          Colormapped, tiled and old-jpeg tiff are not supported;
+ *          use pixReadTiff() for those.  The orientation tag is ignored.
+ *      (2) On error, the caller must call stripReadCloseTiff().
+ * </pre>
+ */
+l_ok
+stripReadOpenTiff(L_STRIP_READER  *sr)
+{
+l_uint16           spp, bps, photometry, tiffcomp, sample_fmt, planar;
+l_uint16          *redmap, *greenmap, *bluemap;
+l_int32            xres, yres;
+l_uint32           w, h;
+TIFF_STRIP_STATE  *ts;
+
+    PROCNAME("stripReadOpenTiff");
+
+    if (!sr || !sr->fp)
+        return ERROR_INT("sr or stream not defined", procName, 1);
+
+    if ((ts = (TIFF_STRIP_STATE *)LEPT_CALLOC(1, sizeof(TIFF_STRIP_STATE)))
+        == NULL)
+        return ERROR_INT("ts not made", procName, 1);
+    sr->codec = ts;
+    if ((ts->tif = fopenTiff(sr->fp, "r")) == NULL)
+        return ERROR_INT("tif not opened", procName, 1);
+
+    TIFFGetFieldDefaulted(ts->tif, TIFFTAG_SAMPLEFORMAT, &sample_fmt);
+    if (sample_fmt != SAMPLEFORMAT_UINT)
+        return ERROR_INT("sample format is not uint", procName, 1);
+    if (TIFFIsTiled(ts->tif))
+        return ERROR_INT("tiled format is not supported", procName, 1);
+    TIFFGetFieldDefaulted(ts->tif, TIFFTAG_COMPRESSION, &tiffcomp);
+    if (tiffcomp == COMPRESSION_OJPEG)
+        return ERROR_INT("old jpeg format is not supported", procName, 1);
+    if (TIFFGetField(ts->tif, TIFFTAG_COLORMAP, &redmap, &greenmap,
+                     &bluemap))
+        return ERROR_INT("colormap is not supported", procName, 1);
+    TIFFGetFieldDefaulted(ts->tif, TIFFTAG_BITSPERSAMPLE, &bps);
+    TIFFGetFieldDefaulted(ts->tif, TIFFTAG_SAMPLESPERPIXEL, &spp);
+    TIFFGetFieldDefaulted(ts->tif, TIFFTAG_PLANARCONFIG, &planar);
+    if (spp == 1 && (bps == 1 || bps == 8)) {
+        sr->d = bps;
+        sr->spp = 1;
+    } else if ((spp == 3 || spp == 4) && bps == 8 &&
+               planar == PLANARCONFIG_CONTIG) {
+        sr->d = 32;
+        sr->spp = spp;
+    } else {
+        L_ERROR("spp = %d, bps = %d not supported\n", procName, spp, bps);
+        return 1;
+    }
+
+    TIFFGetField(ts->tif, TIFFTAG_IMAGEWIDTH, &w);
+    TIFFGetField(ts->tif, TIFFTAG_IMAGELENGTH, &h);
+    sr->w = w;
+    sr->h = h;
+    ts->tiffbpl = TIFFScanlineSize(ts->tif);
+    if (ts->tiffbpl < (bps * spp * w + 7) / 8)
+        return ERROR_INT("bad tiff file: tiffbpl is too small", procName, 1);
+    if (ts->tiffbpl > MaxTiffBufferSize)
+        return ERROR_INT("bad tiff file: tiffbpl is too large", procName, 1);
+    if (getTiffStreamResolution(ts->tif, &xres, &yres) == 0) {
+        sr->xres = xres;
+        sr->yres = yres;
+    }
+
+        /* Find if the samples must be inverted; see
+         * pixReadFromTiffStream() for the default photometry */
+    if (!TIFFGetField(ts->tif, TIFFTAG_PHOTOMETRIC, &photometry)) {
+        if (tiffcomp == COMPRESSION_CCITTFAX3 ||
+            tiffcomp == COMPRESSION_CCITTFAX4 ||
+            tiffcomp == COMPRESSION_CCITTRLE ||
+            tiffcomp == COMPRESSION_CCITTRLEW)
+            photometry = PHOTOMETRIC_MINISWHITE;
+        else
+            photometry = PHOTOMETRIC_MINISBLACK;
+    }
+    ts->invert = (sr->d == 1 && photometry == PHOTOMETRIC_MINISBLACK) ||
+                 (sr->d == 8 && photometry == PHOTOMETRIC_MINISWHITE);
+
+    if ((ts->linebuf = (l_uint8 *)LEPT_CALLOC(ts->tiffbpl + 1,
+                                              sizeof(l_uint8))) == NULL)
+        return ERROR_INT("linebuf not made", procName, 1);
+    return 0;
+}
+
+
+/*!
+ * \brief   stripReadRowsTiff()
+ *
+ * \param[in]    sr       strip reader, opened with stripReadOpenTiff()
+ * \param[in]    pix      width and depth given by %sr
+ * \param[in]    nrows    number of rows to decode into the top of %pix
+ * \return  0 if OK, 1 on error
+ */
+l_ok
+stripReadRowsTiff(L_STRIP_READER  *sr,
+                  PIX             *pix,
+                  l_int32          nrows)
+{
+l_uint8           *rowbuf;
+l_int32            i, j, k, w, wpl, nbytes;
+l_uint32          *data, *line, *ppixel;
+TIFF_STRIP_STATE  *ts;
+
+    PROCNAME("stripReadRowsTiff");
+
+    if (!sr || (ts = (TIFF_STRIP_STATE *)sr->codec) == NULL)
+        return ERROR_INT("sr or decoder not defined", procName, 1);
+    if (!pix || pixGetHeight(pix) < nrows)
+        return ERROR_INT("pix not defined or too small", procName, 1);
+
+    w = sr->w;
+    nbytes = (sr->d == 1) ? (w + 7) / 8 : w;
+    rowbuf = ts->linebuf;
+    data = pixGetData(pix);
+    wpl = pixGetWpl(pix);
+    for (i = 0; i < nrows; i++) {
+        if (TIFFReadScanline(ts->tif, rowbuf, sr->nextrow + i, 0) < 0)
+            return ERROR_INT("line read fail", procName, 1);
+        line = data + i * wpl;
+        if (sr->d != 32) {
+            for (j = 0; j < nbytes; j++) {
+                if (ts->invert)
+                    SET_DATA_BYTE(line, j, 255 - rowbuf[j]);
+                else
+                    SET_DATA_BYTE(line, j, rowbuf[j]);
+            }
+        } else {
+            ppixel = line;
+            for (j = k = 0; j < w; j++) {
+                SET_DATA_BYTE(ppixel, COLOR_RED, rowbuf[k++]);
+                SET_DATA_BYTE(ppixel, COLOR_GREEN, rowbuf[k++]);
+                SET_DATA_BYTE(ppixel, COLOR_BLUE, rowbuf[k++]);
+                if (sr->spp == 4)
+                    SET_DATA_BYTE(ppixel, L_ALPHA_CHANNEL, rowbuf[k++]);
+                ppixel++;
+            }
+        }
+    }
+    if (sr->d == 1)
+        pixSetPadBits(pix, 0);
+    return 0;
+}
+
+
+/*!
+ * \brief   stripReadCloseTiff()
+ *
+ * \param[in]    sr     strip reader
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) This destroys the decoder state.  It is safe to call
+ *          after a failure in stripReadOpenTiff().
+ * </pre>
+ */
+void
+stripReadCloseTiff(L_STRIP_READER  *sr)
+{
+TIFF_STRIP_STATE  *ts;
+
+    if (!sr || (ts = (TIFF_STRIP_STATE *)sr->codec) == NULL)
+        return;
+    if (ts->tif)
+        TIFFCleanup(ts->tif);
+    LEPT_FREE(ts->linebuf);
+    LEPT_FREE(ts);
+    sr->codec = NULL;
+}
+
+
+/*!
+ * \brief   stripWriteOpenTiff()
+ *
+ * \param[in]    sw     strip writer, with open stream and image parameters
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This sets up the tiff header for encoding a scanline at
+ *          a time.  The depth must be 1, 8 or 32.  The compression
+ *          is given by %sw->format, as in pixWriteToTiffStream().
+ *          The g3, g4 and rle encodings apply only to 1 bpp; for
+ *          other depths they are replaced by zip.
+ *      (2) Several rows are put in each tiff strip, so that the
+ *          encoder need not buffer the entire image.
+ *      (3) On error, the caller must call stripWriteCloseTiff().
+ * </pre>
+ */
+l_ok
+stripWriteOpenTiff(L_STRIP_WRITER  *sw)
+{
+l_int32            comptype, xres, yres;
+l_uint16           val[1];
+TIFF_STRIP_STATE  *ts;
+
+    PROCNAME("stripWriteOpenTiff");
+
+    if (!sw || !sw->fp)
+        return ERROR_INT("sw or stream not defined", procName, 1);
+    if (sw->d != 1 && sw->d != 8 && sw->d != 32)
+        return ERROR_INT("depth not in {1,8,32}", procName, 1);
+
+    if ((ts = (TIFF_STRIP_STATE *)LEPT_CALLOC(1, sizeof(TIFF_STRIP_STATE)))
+        == NULL)
+        return ERROR_INT("ts not made", procName, 1);
+    sw->codec = ts;
+    if ((ts->tif = fopenTiff(sw->fp, "w")) == NULL)
+        return ERROR_INT("tif not opened", procName, 1);
+
+    xres = (sw->xres == 0) ? DefaultResolution : sw->xres;
+    yres = (sw->yres == 0) ? DefaultResolution : sw->yres;
+    TIFFSetField(ts->tif, TIFFTAG_RESOLUTIONUNIT, (l_uint32)RESUNIT_INCH);
+    TIFFSetField(ts->tif, TIFFTAG_XRESOLUTION, (l_float64)xres);
+    TIFFSetField(ts->tif, TIFFTAG_YRESOLUTION, (l_float64)yres);
+    TIFFSetField(ts->tif, TIFFTAG_IMAGEWIDTH, (l_uint32)sw->w);
+    TIFFSetField(ts->tif, TIFFTAG_IMAGELENGTH, (l_uint32)sw->h);
+    TIFFSetField(ts->tif, TIFFTAG_ORIENTATION, ORIENTATION_TOPLEFT);
+    if (sw->d == 1) {
+        TIFFSetField(ts->tif, TIFFTAG_PHOTOMETRIC, PHOTOMETRIC_MINISWHITE);
+        TIFFSetField(ts->tif, TIFFTAG_BITSPERSAMPLE, (l_uint16)1);
+        TIFFSetField(ts->tif, TIFFTAG_SAMPLESPERPIXEL, (l_uint16)1);
+    } else if (sw->d == 8) {
+        TIFFSetField(ts->tif, TIFFTAG_PHOTOMETRIC, PHOTOMETRIC_MINISBLACK);
+        TIFFSetField(ts->tif, TIFFTAG_BITSPERSAMPLE, (l_uint16)8);
+        TIFFSetField(ts->tif, TIFFTAG_SAMPLESPERPIXEL, (l_uint16)1);
+    } else if (sw->spp == 4) {
+        val[0] = EXTRASAMPLE_ASSOCALPHA;
+        TIFFSetField(ts->tif, TIFFTAG_EXTRASAMPLES, (l_uint16)1, &val);
+        TIFFSetField(ts->tif, TIFFTAG_PHOTOMETRIC, PHOTOMETRIC_RGB);
+        TIFFSetField(ts->tif, TIFFTAG_SAMPLESPERPIXEL, (l_uint16)4);
+        TIFFSetField(ts->tif, TIFFTAG_BITSPERSAMPLE,
+                     (l_uint16)8, (l_uint16)8, (l_uint16)8, (l_uint16)8);
+    } else {
+        TIFFSetField(ts->tif, TIFFTAG_PHOTOMETRIC, PHOTOMETRIC_RGB);
+        TIFFSetField(ts->tif, TIFFTAG_SAMPLESPERPIXEL, (l_uint16)3);
+        TIFFSetField(ts->tif, TIFFTAG_BITSPERSAMPLE,
+                     (l_uint16)8, (l_uint16)8, (l_uint16)8);
+    }
+    TIFFSetField(ts->tif, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
+
+    comptype = sw->format;
+    if (sw->d != 1 && (comptype == IFF_TIFF_G4 || comptype == IFF_TIFF_G3 ||
+                       comptype == IFF_TIFF_RLE)) {
+        L_WARNING("fax encoding requires 1 bpp; using zip\n", procName);
+        comptype = IFF_TIFF_ZIP;
+    }
+    if (comptype == IFF_TIFF_G4)
+        TIFFSetField(ts->tif, TIFFTAG_COMPRESSION, COMPRESSION_CCITTFAX4);
+    else if (comptype == IFF_TIFF_G3)
+        TIFFSetField(ts->tif, TIFFTAG_COMPRESSION, COMPRESSION_CCITTFAX3);
+    else if (comptype == IFF_TIFF_RLE)
+        TIFFSetField(ts->tif, TIFFTAG_COMPRESSION, COMPRESSION_CCITTRLE);
+    else if (comptype == IFF_TIFF_PACKBITS)
+        TIFFSetField(ts->tif, TIFFTAG_COMPRESSION, COMPRESSION_PACKBITS);
+    else if (comptype == IFF_TIFF_LZW)
+        TIFFSetField(ts->tif, TIFFTAG_COMPRESSION, COMPRESSION_LZW);
+    else if (comptype == IFF_TIFF_ZIP)
+        TIFFSetField(ts->tif, TIFFTAG_COMPRESSION, COMPRESSION_ADOBE_DEFLATE);
+    else if (comptype == IFF_TIFF_JPEG && sw->d != 1)
+        TIFFSetField(ts->tif, TIFFTAG_COMPRESSION, COMPRESSION_JPEG);
+    else
+        TIFFSetField(ts->tif, TIFFTAG_COMPRESSION, COMPRESSION_NONE);
+    TIFFSetField(ts->tif, TIFFTAG_ROWSPERSTRIP,
+                 TIFFDefaultStripSize(ts->tif, 0));
+
+    if ((ts->linebuf = (l_uint8 *)LEPT_CALLOC(4 * sw->w + 4,
+                                              sizeof(l_uint8))) == NULL)
+        return ERROR_INT("linebuf not made", procName, 1);
+    return 0;
+}
+
+
+/*!
+ * \brief   stripWriteRowsTiff()
+ *
+ * \param[in]    sw     strip writer, opened with stripWriteOpenTiff()
+ * \param[in]    pix    strip; all rows are encoded
+ * \return  0 if OK, 1 on error
+ */
+l_ok
+stripWriteRowsTiff(L_STRIP_WRITER  *sw,
+                   PIX             *pix)
+{
+l_uint8           *rowbuf;
+l_int32            i, j, k, w, h, wpl, nbytes;
+l_uint32          *data, *line, *ppixel;
+TIFF_STRIP_STATE  *ts;
+
+    PROCNAME("stripWriteRowsTiff");
+
+    if (!sw || (ts = (TIFF_STRIP_STATE *)sw->codec) == NULL)
+        return ERROR_INT("sw or encoder not defined", procName, 1);
+    if (!pix)
+        return ERROR_INT("pix not defined", procName, 1);
+
+    w = sw->w;
+    h = pixGetHeight(pix);
+    nbytes = (sw->d == 1) ? (w + 7) / 8 : w;
+    rowbuf = ts->linebuf;
+    pixSetPadBits(pix, 0);
+    data = pixGetData(pix);
+    wpl = pixGetWpl(pix);
+    for (i = 0; i < h; i++) {
+        line = data + i * wpl;
+        if (sw->d != 32) {
+            for (j = 0; j < nbytes; j++)
+                rowbuf[j] = GET_DATA_BYTE(line, j);
+        } else {
+            ppixel = line;
+            for (j = k = 0; j < w; j++) {
+                rowbuf[k++] = GET_DATA_BYTE(ppixel, COLOR_RED);
+                rowbuf[k++] = GET_DATA_BYTE(ppixel, COLOR_GREEN);
+                rowbuf[k++] = GET_DATA_BYTE(ppixel, COLOR_BLUE);
+                if (sw->spp == 4)
+                    rowbuf[k++] = GET_DATA_BYTE(ppixel, L_ALPHA_CHANNEL);
+                ppixel++;
+            }
+        }
+        if (TIFFWriteScanline(ts->tif, rowbuf, sw->nextrow + i, 0) < 0)
+            return ERROR_INT("line write fail", procName, 1);
+    }
+    return 0;
+}
+
+
+/*!
+ * \brief   stripWriteCloseTiff()
+ *
+ * \param[in]    sw       strip writer
+ * \param[in]    finish   1 to complete the tiff; 0 to abandon it
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This destroys the encoder state.  It is safe to call
+ *          after a failure in stripWriteOpenTiff(), with %finish = 0.
+ * </pre>
+ */
+l_ok
+stripWriteCloseTiff(L_STRIP_WRITER  *sw,
+                    l_int32          finish)
+{
+TIFF_STRIP_STATE  *ts;
+
+    PROCNAME("stripWriteCloseTiff");
+
+    if (!sw)
+        return ERROR_INT("sw not defined", procName, 1);
+    if ((ts = (TIFF_STRIP_STATE *)sw->codec) == NULL)
+        return 0;
+
+    if (ts->tif) {
+        if (finish)
+            TIFFClose(ts->tif);
+        else
+            TIFFCleanup(ts->tif);
+    }
+    LEPT_FREE(ts->linebuf);
+    LEPT_FREE(ts);
+    sw->codec = NULL;
+    return 0;
+}
+
+
 /*--------------------------------------------------------------*
  *               Open tiff stream from file stream              *
  *--------------------------------------------------------------*/
@@ -56,6 +56,21 @@ PIX * pixReadStreamTiff(FILE *fp, l_int32 n)
 
 /* ----------------------------------------------------------------------*/
 
+PIX * pixReadTiffRegion(const char *filename, l_int32 n, BOX *box)
+{
+    return (PIX *)ERROR_PTR("function not present", "pixReadTiffRegion", NULL);
+}
+
+/* ----------------------------------------------------------------------*/
+
+PIX * pixReadStreamTiffRegion(FILE *fp, l_int32 n, BOX *box)
+{
+    return (PIX *)ERROR_PTR("function not present",
+                            "pixReadStreamTiffRegion", NULL);
+}
+
+/* ----------------------------------------------------------------------*/
+
 l_ok pixWriteTiff(const char *filename, PIX *pix, l_int32 comptype,
                   const char *modestring)
 {
@@ -237,6 +252,49 @@ l_ok pixWriteMemTiffCustom(l_uint8 **pdata, size_t *psize, PIX *pix,
     return ERROR_INT("function not present", "pixWriteMemTiffCustom", 1);
 }
 
+/* ----------------------------------------------------------------------*/
+
+l_ok stripReadOpenTiff(L_STRIP_READER *sr)
+{
+    return ERROR_INT("function not present", "stripReadOpenTiff", 1);
+}
+
+/* ----------------------------------------------------------------------*/
+
+l_ok stripReadRowsTiff(L_STRIP_READER *sr, PIX *pix, l_int32 nrows)
+{
+    return ERROR_INT("function not present", "stripReadRowsTiff", 1);
+}
+
+/* ----------------------------------------------------------------------*/
+
+void stripReadCloseTiff(L_STRIP_READER *sr)
+{
+    L_ERROR("function not present\n", "stripReadCloseTiff");
+    return;
+}
+
+/* ----------------------------------------------------------------------*/
+
+l_ok stripWriteOpenTiff(L_STRIP_WRITER *sw)
+{
+    return ERROR_INT("function not present", "stripWriteOpenTiff", 1);
+}
+
+/* ----------------------------------------------------------------------*/
+
+l_ok stripWriteRowsTiff(L_STRIP_WRITER *sw, PIX *pix)
+{
+    return ERROR_INT("function not present", "stripWriteRowsTiff", 1);
+}
+
+/* ----------------------------------------------------------------------*/
+
+l_ok stripWriteCloseTiff(L_STRIP_WRITER *sw, l_int32 finish)
+{
+    return ERROR_INT("function not present", "stripWriteCloseTiff", 1);
+}
+
 /* --------------------------------------------*/
 #endif  /* !HAVE_LIBTIFF */
 /* --------------------------------------------*/
@@ -1335,7 +1335,7 @@ pixStereoFromPair(PIX       *pix1,
                   l_float32  gwt,
                   l_float32  bwt)
 {
-l_int32    i, j, w, h, wpl1, wpl2, rval, gval, bval;
+l_int32    i, j, w, h, wpl1, wpl2, wpld, rval, gval, bval;
 l_uint32   word1, word2;
 l_uint32  *data1, *data2, *datad, *line1, *line2, *lined;
 l_float32  sum;
@@ -1370,10 +1370,11 @@ PIX       *pixd;
     datad = pixGetData(pixd);
     wpl1 = pixGetWpl(pix1);
     wpl2 = pixGetWpl(pix2);
+    wpld = pixGetWpl(pixd);
     for (i = 0; i < h; i++) {
         line1 = data1 + i * wpl1;
         line2 = data2 + i * wpl2;
-        lined = datad + i * wpl1;  /* wpl1 works for pixd */
+        lined = datad + i * wpld;
         for (j = 0; j < w; j++) {
             word1 = *(line1 + j);
             word2 = *(line2 + j);
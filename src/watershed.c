@@ -32,20 +32,24 @@
  *            L_WSHED         *wshedCreate()
  *            void             wshedDestroy()
  *            l_int32          wshedApply()
+ *            l_int32          wshedSetLabelsOnly()
  *
  *      Helpers
  *            static l_int32   identifyWatershedBasin()
  *            static l_int32   mergeLookup()
  *            static l_int32   wshedGetHeight()
- *            static void      pushNewPixel()
+ *            static L_WSQUEUE *wsqueueCreate()
+ *            static void      wsqueueDestroy()
+ *            static l_int32   pushNewPixel()
  *            static void      popNewPixel()
- *            static void      pushWSPixel()
+ *            static l_int32   pushWSPixel()
  *            static void      popWSPixel()
  *            static void      debugPrintLUT()
  *            static void      debugWshedMerge()
  *
  *      Output
  *            l_int32          wshedBasins()
+ *            PIX             *wshedLabels()
  *            PIX             *wshedRenderFill()
  *            PIX             *wshedRenderColors()
  *
@@ -65,7 +69,9 @@
  *    (1) Identify the markers and the local minima, and enter them
  *        into a priority queue based on the pixel value.  Each marker
  *        is shrunk to a single pixel, if necessary, before the
- *        operation starts.
+ *        operation starts.  Because there are only 256 pixel values,
+ *        the priority queue is a set of FIFO buckets, one for each
+ *        value, holding pixel locations and labels in packed arrays.
  *    (2) Feed the priority queue with neighbors of pixels that are
  *        popped off the queue.  Each of these queue pixels is labeled
  *        with the index value of its parent.
@@ -96,6 +102,10 @@
  *         ~ a pixa of the basins
  *         ~ a pta of the markers
  *         ~ a numa of the watershed levels
+ *        If only a label image of the basins is required, call
+ *        wshedSetLabelsOnly() before wshedApply().  The basins are
+ *        then written into a 32 bpp label image, which is returned
+ *        by wshedLabels(), and the pixa is not made.
  *
  *  Typical usage:
  *      L_WShed *wshed = wshedCreate(pixs, pixseed, mindepth, 0);
@@ -120,23 +130,19 @@
 
 static const l_uint32  MAX_LABEL_VALUE = 0x7fffffff;  /* largest l_int32 */
 
-/*! New pixel coordinates */
-struct L_NewPixel
+/*! Priority queue for watershed filling.  Because pixs is 8 bpp, there
+ *  are only 256 priorities, so this is a bucket queue with a FIFO for
+ *  each pixel value.  Each entry is a pair of ints: the pixel location,
+ *  packed as (y * w + x), and the label for the set to which the
+ *  pixel belongs. */
+struct L_WSQueue
 {
-    l_int32    x;      /*!< x coordinate */
-    l_int32    y;      /*!< y coordinate */
+    L_PAIRQUEUE  *fifo[256];  /*!< one FIFO for each pixel value        */
+    l_int32    w;          /*!< image width, for packing locations      */
+    l_int32    minval;     /*!< no FIFO below this value has entries    */
+    l_int32    count;      /*!< total number of entries in all FIFOs    */
 };
-typedef struct L_NewPixel  L_NEWPIXEL;
-
-/*! Wartshed pixel */
-struct L_WSPixel
-{
-    l_float32  val;    /*!< pixel value */
-    l_int32    x;      /*!< x coordinate */
-    l_int32    y;      /*!< y coordinate */
-    l_int32    index;  /*!< label for set to which pixel belongs */
-};
-typedef struct L_WSPixel  L_WSPIXEL;
+typedef struct L_WSQueue  L_WSQUEUE;
 
 
     /* Static functions for obtaining bitmap of watersheds  */
@@ -154,17 +160,22 @@ static l_int32 mergeLookup(L_WSHED *wshed, l_int32 sindex, l_int32 dindex);
 static l_int32 wshedGetHeight(L_WSHED *wshed, l_int32 val, l_int32 label,
                               l_int32 *pheight);
 
-    /* Static accessors for NewPixel on a queue */
-static void pushNewPixel(L_QUEUE *lq, l_int32 x, l_int32 y,
-                         l_int32 *pminx, l_int32 *pmaxx,
-                         l_int32 *pminy, l_int32 *pmaxy);
-static void popNewPixel(L_QUEUE *lq, l_int32 *px, l_int32 *py);
+    /* Static bucket queue of packed pixels */
+static L_WSQUEUE *wsqueueCreate(l_int32 w);
+static void wsqueueDestroy(L_WSQUEUE **pwsq);
 
-    /* Static accessors for WSPixel on a heap */
-static void pushWSPixel(L_HEAP *lh, L_STACK *stack, l_int32 val,
-                        l_int32 x, l_int32 y, l_int32 index);
-static void popWSPixel(L_HEAP *lh, L_STACK *stack, l_int32 *pval,
-                       l_int32 *px, l_int32 *py, l_int32 *pindex);
+    /* Static accessors for pixels on a FIFO */
+static l_int32 pushNewPixel(L_PAIRQUEUE *lpq, l_int32 w, l_int32 x,
+                            l_int32 y, l_int32 *pminx, l_int32 *pmaxx,
+                            l_int32 *pminy, l_int32 *pmaxy);
+static void popNewPixel(L_PAIRQUEUE *lpq, l_int32 w, l_int32 *px,
+                        l_int32 *py);
+
+    /* Static accessors for pixels on the bucket queue */
+static l_int32 pushWSPixel(L_WSQUEUE *wsq, l_int32 val, l_int32 x,
+                           l_int32 y, l_int32 index);
+static void popWSPixel(L_WSQUEUE *wsq, l_int32 *pval, l_int32 *px,
+                       l_int32 *py, l_int32 *pindex);
 
     /* Static debug print output */
 static void debugPrintLUT(l_int32 *lut, l_int32 size, l_int32 debug);
@@ -266,6 +277,7 @@ L_WSHED  *wshed;
     pixDestroy(&wshed->pixm);
     pixDestroy(&wshed->pixlab);
     pixDestroy(&wshed->pixt);
+    pixDestroy(&wshed->pixbasin);
     if (wshed->lines8) LEPT_FREE(wshed->lines8);
     if (wshed->linem1) LEPT_FREE(wshed->linem1);
     if (wshed->linelab32) LEPT_FREE(wshed->linelab32);
@@ -317,16 +329,15 @@ char      minima_absorbed_by_filler_or_another[] =
 l_int32   nseeds, nother, nboth, arraysize;
 l_int32   i, j, val, x, y, w, h, index, mindepth;
 l_int32   imin, imax, jmin, jmax, cindex, clabel, nindex;
-l_int32   hindex, hlabel, hmin, hmax, minhindex, maxhindex;
+l_int32   hindex, hlabel, hmin, hmax, minhindex, maxhindex, ret;
 l_int32  *lut;
 l_uint32  ulabel, uval;
 void    **lines8, **linelab32;
 NUMA     *nalut, *nalevels, *nash, *namh, *nasi;
 NUMA    **links;
-L_HEAP   *lh;
+L_WSQUEUE  *wsq;
 PIX      *pixmin, *pixsd;
 PIXA     *pixad;
-L_STACK  *rstack;
 PTA      *ptas, *ptao;
 
     PROCNAME("wshedApply");
@@ -338,9 +349,13 @@ PTA      *ptas, *ptao;
      *  Initialize priority queue and pixlab with seeds and minima  *
      * ------------------------------------------------------------ */
 
-    lh = lheapCreate(0, L_SORT_INCREASING);  /* remove lowest values first */
-    rstack = lstackCreate(0);  /* for reusing the WSPixels */
     pixGetDimensions(wshed->pixs, &w, &h, NULL);
+    if ((wsq = wsqueueCreate(w)) == NULL)
+        return ERROR_INT("wsq not made", procName, 1);
+    ret = 1;
+    nalut = NULL;
+    pixmin = pixsd = NULL;
+    ptao = NULL;
     lines8 = wshed->lines8;  /* wshed owns this */
     linelab32 = wshed->linelab32;  /* ditto */
 
@@ -348,16 +363,17 @@ PTA      *ptas, *ptao;
     pixSelectMinInConnComp(wshed->pixs, wshed->pixm, &ptas, &nash);
     pixsd = pixGenerateFromPta(ptas, w, h);
     nseeds = ptaGetCount(ptas);
-    for (i = 0; i < nseeds; i++) {
-        ptaGetIPt(ptas, i, &x, &y);
-        uval = GET_DATA_BYTE(lines8[y], x);
-        pushWSPixel(lh, rstack, (l_int32)uval, x, y, i);
-    }
     wshed->ptas = ptas;
     nasi = numaMakeConstant(1, nseeds);  /* indicator array */
     wshed->nasi = nasi;
     wshed->nash = nash;
     wshed->nseeds = nseeds;
+    for (i = 0; i < nseeds; i++) {
+        ptaGetIPt(ptas, i, &x, &y);
+        uval = GET_DATA_BYTE(lines8[y], x);
+        if (pushWSPixel(wsq, (l_int32)uval, x, y, i))
+            goto cleanup_queue;
+    }
 
         /* Identify minima that are not seeds.  Use these 4 steps:
          *  (1) Get the local minima, which can have components
@@ -370,12 +386,13 @@ PTA      *ptas, *ptao;
     pixRemoveSeededComponents(pixmin, pixsd, pixmin, 8, 2);
     pixSelectMinInConnComp(wshed->pixs, pixmin, &ptao, &namh);
     nother = ptaGetCount(ptao);
+    wshed->namh = namh;
     for (i = 0; i < nother; i++) {
         ptaGetIPt(ptao, i, &x, &y);
         uval = GET_DATA_BYTE(lines8[y], x);
-        pushWSPixel(lh, rstack, (l_int32)uval, x, y, nseeds + i);
+        if (pushWSPixel(wsq, (l_int32)uval, x, y, nseeds + i))
+            goto cleanup_queue;
     }
-    wshed->namh = namh;
 
     /* ------------------------------------------------------------ *
      *                Initialize merging lookup tables              *
@@ -400,12 +417,16 @@ PTA      *ptas, *ptao;
      * ------------------------------------------------------------ */
 
     pixad = pixaCreate(nseeds);
-    wshed->pixad = pixad;  /* wshed owns this */
+    wshed->pixad = pixad;  /* wshed owns this; empty if labels only */
+    if (wshed->labelsonly) {
+        pixDestroy(&wshed->pixbasin);
+        wshed->pixbasin = pixCreate(w, h, 32);
+    }
     nalevels = numaCreate(nseeds);
     wshed->nalevels = nalevels;  /* wshed owns this */
     L_INFO("nseeds = %d, nother = %d\n", procName, nseeds, nother);
-    while (lheapGetCount(lh) > 0) {
-        popWSPixel(lh, rstack, &val, &x, &y, &index);
+    while (wsq->count > 0) {
+        popWSPixel(wsq, &val, &x, &y, &index);
 /*        fprintf(stderr, "x = %d, y = %d, index = %d\n", x, y, index); */
         ulabel = GET_DATA_FOUR_BYTES(linelab32[y], x);
         if (ulabel == MAX_LABEL_VALUE)
@@ -425,7 +446,8 @@ PTA      *ptas, *ptao;
                 for (j = jmin; j <= jmax; j++) {
                     if (i == y && j == x) continue;
                     uval = GET_DATA_BYTE(lines8[i], j);
-                    pushWSPixel(lh, rstack, (l_int32)uval, j, i, cindex);
+                    if (pushWSPixel(wsq, (l_int32)uval, j, i, cindex))
+                        goto cleanup_queue;
                 }
             }
         } else {  /* pixel is already labeled (differently); must resolve */
@@ -522,13 +544,49 @@ PTA      *ptas, *ptao;
         }
     }
 #endif
+    ret = 0;
 
+cleanup_queue:
     numaDestroy(&nalut);
     pixDestroy(&pixmin);
     pixDestroy(&pixsd);
     ptaDestroy(&ptao);
-    lheapDestroy(&lh, TRUE);
-    lstackDestroy(&rstack, TRUE);
+    wsqueueDestroy(&wsq);
+    if (ret)
+        return ERROR_INT("pixel not queued; fill not completed", procName, 1);
+    return 0;
+}
+
+
+/*!
+ * \brief   wshedSetLabelsOnly()
+ *
+ * \param[in]    wshed
+ * \param[in]    flag    1 to make only a label image of the basins;
+ *                       0 to make the pixa of basins (default)
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) Call this before wshedApply().  When %flag is set, each
+ *          basin is written into a 32 bpp label image instead of
+ *          being clipped out as a 1 bpp pix and saved in a pixa.
+ *          This is faster and uses less memory when there are many
+ *          basins.  Get the label image with wshedLabels().
+ *      (2) The levels are saved in both cases.  The pixa returned by
+ *          wshedBasins() is empty if only labels are made, so
+ *          wshedRenderFill() and wshedRenderColors() cannot be used.
+ * </pre>
+ */
+l_ok
+wshedSetLabelsOnly(L_WSHED  *wshed,
+                   l_int32   flag)
+{
+    PROCNAME("wshedSetLabelsOnly");
+
+    if (!wshed)
+        return ERROR_INT("wshed not defined", procName, 1);
+    wshed->labelsonly = (flag) ? 1 : 0;
     return 0;
 }
 
@@ -568,8 +626,12 @@ PIX  *pix;
     }
 
     if (identifyWatershedBasin(wshed, index, level, &box, &pix) == 0) {
-        pixaAddPix(wshed->pixad, pix, L_INSERT);
-        pixaAddBox(wshed->pixad, box, L_INSERT);
+        if (wshed->labelsonly) {
+            boxDestroy(&box);
+        } else {
+            pixaAddPix(wshed->pixad, pix, L_INSERT);
+            pixaAddBox(wshed->pixad, box, L_INSERT);
+        }
         numaAddNumber(wshed->nalevels, level - 1);
     }
     return;
@@ -583,7 +645,8 @@ PIX  *pix;
  * \param[in]    index   index of basin to be located
  * \param[in]    level   of basin at point at which the two basins met
  * \param[out]   pbox    bounding box of basin
- * \param[out]   ppixd   pix of basin, cropped to its bounding box
+ * \param[out]   ppixd   pix of basin, cropped to its bounding box;
+ *                       null if only labels are made
  * \return  0 if OK, 1 on error
  *
  * <pre>
@@ -595,6 +658,9 @@ PIX  *pix;
  *      (3) It is used whenever two seeded basins meet (typically at a saddle),
  *          or when one seeded basin meets a 'filler'.  All identified
  *          basins are saved as a watershed.
+ *      (4) If only labels are made, the selected pixels are also set
+ *          in pixbasin to the 1-based index of this basin in nalevels,
+ *          and pixt is cleared within the bounding box.
  * </pre>
  */
 static l_int32
@@ -604,14 +670,15 @@ identifyWatershedBasin(L_WSHED  *wshed,
                        BOX     **pbox,
                        PIX     **ppixd)
 {
-l_int32   imin, imax, jmin, jmax, minx, miny, maxx, maxy;
-l_int32   bw, bh, i, j, w, h, x, y;
-l_int32  *lut;
-l_uint32  label, bval, lval;
-void    **lines8, **linelab32, **linet1;
-BOX      *box;
-PIX      *pixs, *pixt, *pixd;
-L_QUEUE  *lq;
+l_int32       imin, imax, jmin, jmax, minx, miny, maxx, maxy;
+l_int32       bw, bh, i, j, w, h, x, y, wplb;
+l_int32      *lut;
+l_uint32      label, bval, lval, basinval;
+l_uint32     *datab;
+void        **lines8, **linelab32, **linet1;
+BOX          *box;
+PIX          *pixs, *pixt, *pixd;
+L_PAIRQUEUE  *lpq;
 
     PROCNAME("identifyWatershedBasin");
 
@@ -624,10 +691,6 @@ L_QUEUE  *lq;
     if (!wshed)
         return ERROR_INT("wshed not defined", procName, 1);
 
-        /* Make a queue and an auxiliary stack */
-    lq = lqueueCreate(0);
-    lq->stack = lstackCreate(0);
-
     pixs = wshed->pixs;
     pixt = wshed->pixt;
     lines8 = wshed->lines8;
@@ -635,13 +698,25 @@ L_QUEUE  *lq;
     linet1 = wshed->linet1;
     lut = wshed->lut;
     pixGetDimensions(pixs, &w, &h, NULL);
+    datab = NULL;
+    wplb = 0;
+    basinval = 0;
+    if (wshed->labelsonly) {
+        datab = pixGetData(wshed->pixbasin);
+        wplb = pixGetWpl(wshed->pixbasin);
+        basinval = numaGetCount(wshed->nalevels) + 1;
+    }
 
         /* Prime the queue with the seed pixel for this watershed. */
+    if ((lpq = lpairqueueCreate(0)) == NULL)
+        return ERROR_INT("lpq not made", procName, 1);
     minx = miny = 1000000;
     maxx = maxy = 0;
     ptaGetIPt(wshed->ptas, index, &x, &y);
     pixSetPixel(pixt, x, y, 1);
-    pushNewPixel(lq, x, y, &minx, &maxx, &miny, &maxy);
+    if (datab)
+        SET_DATA_FOUR_BYTES(datab + y * wplb, x, basinval);
+    pushNewPixel(lpq, w, x, y, &minx, &maxx, &miny, &maxy);
     if (wshed->debug) fprintf(stderr, "prime: (x,y) = (%d, %d)\n", x, y);
 
         /* Each pixel in a spreading breadth-first search is inspected.
@@ -651,8 +726,8 @@ L_QUEUE  *lq;
          *     (2) The pixel value is less than %level, the overflow
          *         height at which the two basins join.
          *     (3) It has not yet been seen in this search.  */
-    while (lqueueGetCount(lq) > 0) {
-        popNewPixel(lq, &x, &y);
+    while (lpairqueueGetCount(lpq) > 0) {
+        popNewPixel(lpq, w, &x, &y);
         imin = L_MAX(0, y - 1);
         imax = L_MIN(h - 1, y + 1);
         jmin = L_MAX(0, x - 1);
@@ -667,7 +742,12 @@ L_QUEUE  *lq;
                 lval = GET_DATA_BYTE(lines8[i], j);
                 if (lval >= level) continue;  /* too high */
                 SET_DATA_BIT(linet1[i], j);
-                pushNewPixel(lq, j, i, &minx, &maxx, &miny, &maxy);
+                if (datab)
+                    SET_DATA_FOUR_BYTES(datab + i * wplb, j, basinval);
+                if (pushNewPixel(lpq, w, j, i, &minx, &maxx, &miny, &maxy)) {
+                    lpairqueueDestroy(&lpq);
+                    return ERROR_INT("pixel not queued", procName, 1);
+                }
             }
         }
     }
@@ -676,12 +756,16 @@ L_QUEUE  *lq;
     bw = maxx - minx + 1;
     bh = maxy - miny + 1;
     box = boxCreate(minx, miny, bw, bh);
-    pixd = pixClipRectangle(pixt, box, NULL);
-    pixRasterop(pixt, minx, miny, bw, bh, PIX_SRC ^ PIX_DST, pixd, 0, 0);
+    if (wshed->labelsonly) {
+        pixRasterop(pixt, minx, miny, bw, bh, PIX_CLR, NULL, 0, 0);
+    } else {
+        pixd = pixClipRectangle(pixt, box, NULL);
+        pixRasterop(pixt, minx, miny, bw, bh, PIX_SRC ^ PIX_DST, pixd, 0, 0);
+        *ppixd = pixd;
+    }
     *pbox = box;
-    *ppixd = pixd;
 
-    lqueueDestroy(&lq, 1);
+    lpairqueueDestroy(&lpq);
     return 0;
 }
 
@@ -803,90 +887,108 @@ l_int32  minval;
 
 
 /*
- * \brief   pushNewPixel()
+ * \brief   wsqueueCreate()
  *
- * \param[in]     lqueue
- * \param[in]     x, y                          pixel coordinates
- * \param[out]    pminx, pmaxx, pminy, pmaxy    bounding box update
- * \return   void
+ * \param[in]    w      width of pixs, for packing pixel locations
+ * \return   wsq, or NULL on error
  *
  * <pre>
  * Notes:
- *      (1) This is a wrapper for adding a NewPixel to a queue, which
- *          updates the bounding box for all pixels on that queue and
- *          uses the storage stack to retrieve a NewPixel.
+ *      (1) The fifo for each value is made when the first pixel
+ *          with that value is added.
  * </pre>
  */
-static void
-pushNewPixel(L_QUEUE  *lq,
-             l_int32   x,
-             l_int32   y,
-             l_int32  *pminx,
-             l_int32  *pmaxx,
-             l_int32  *pminy,
-             l_int32  *pmaxy)
+static L_WSQUEUE *
+wsqueueCreate(l_int32  w)
 {
-L_NEWPIXEL  *np;
+L_WSQUEUE  *wsq;
+
+    PROCNAME("wsqueueCreate");
 
-    PROCNAME("pushNewPixel");
+    if ((wsq = (L_WSQUEUE *)LEPT_CALLOC(1, sizeof(L_WSQUEUE))) == NULL)
+        return (L_WSQUEUE *)ERROR_PTR("wsq not made", procName, NULL);
+    wsq->w = w;
+    wsq->minval = 256;
+    return wsq;
+}
+
+
+/*
+ * \brief   wsqueueDestroy()
+ *
+ * \param[in,out]   pwsq     will be set to null before returning
+ * \return   void
+ */
+static void
+wsqueueDestroy(L_WSQUEUE  **pwsq)
+{
+l_int32     i;
+L_WSQUEUE  *wsq;
 
-    if (!lq) {
-        L_ERROR("queue not defined\n", procName);
+    if (pwsq == NULL || (wsq = *pwsq) == NULL)
         return;
-    }
+    for (i = 0; i < 256; i++)
+        lpairqueueDestroy(&wsq->fifo[i]);
+    LEPT_FREE(wsq);
+    *pwsq = NULL;
+    return;
+}
 
+
+/*
+ * \brief   pushNewPixel()
+ *
+ * \param[in]     lpq                           fifo
+ * \param[in]     w                             width of pixs
+ * \param[in]     x, y                          pixel coordinates
+ * \param[out]    pminx, pmaxx, pminy, pmaxy    bounding box update
+ * \return   0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This is a wrapper for adding a pixel to a fifo, which
+ *          updates the bounding box for all pixels on that fifo.
+ * </pre>
+ */
+static l_int32
+pushNewPixel(L_PAIRQUEUE  *lpq,
+             l_int32       w,
+             l_int32       x,
+             l_int32       y,
+             l_int32      *pminx,
+             l_int32      *pmaxx,
+             l_int32      *pminy,
+             l_int32      *pmaxy)
+{
         /* Adjust bounding box */
     *pminx = L_MIN(*pminx, x);
     *pmaxx = L_MAX(*pmaxx, x);
     *pminy = L_MIN(*pminy, y);
     *pmaxy = L_MAX(*pmaxy, y);
 
-        /* Get a newpixel to use */
-    if (lstackGetCount(lq->stack) > 0)
-        np = (L_NEWPIXEL *)lstackRemove(lq->stack);
-    else
-        np = (L_NEWPIXEL *)LEPT_CALLOC(1, sizeof(L_NEWPIXEL));
-
-    np->x = x;
-    np->y = y;
-    lqueueAdd(lq, np);
-    return;
+    return lpairqueueAdd(lpq, y * w + x, 0);
 }
 
 
 /*
  * \brief   popNewPixel()
  *
- * \param[in]    lqueue
- * \param[out]   px, py    pixel coordinates
+ * \param[in]    lpq      fifo; must not be empty
+ * \param[in]    w        width of pixs
+ * \param[out]   px, py   pixel coordinates
  * \return   void
- *
- * <pre>
- * Notes:
- *      (1) This is a wrapper for removing a NewPixel from a queue,
- *          which returns the pixel coordinates and saves the NewPixel
- *          on the storage stack.
- * </pre>
  */
 static void
-popNewPixel(L_QUEUE  *lq,
-            l_int32  *px,
-            l_int32  *py)
+popNewPixel(L_PAIRQUEUE  *lpq,
+            l_int32       w,
+            l_int32      *px,
+            l_int32      *py)
 {
-L_NEWPIXEL  *np;
-
-    PROCNAME("popNewPixel");
+l_int32  loc, index;
 
-    if (!lq) {
-        L_ERROR("lqueue not defined\n", procName);
-        return;
-    }
-
-    if ((np = (L_NEWPIXEL *)lqueueRemove(lq)) == NULL)
-        return;
-    *px = np->x;
-    *py = np->y;
-    lstackAdd(lq->stack, np);  /* save for re-use */
+    lpairqueueRemove(lpq, &loc, &index);
+    *py = loc / w;
+    *px = loc - w * (*py);
     return;
 }
 
@@ -894,60 +996,43 @@ L_NEWPIXEL  *np;
 /*
  * \brief   pushWSPixel()
  *
- * \param[in]    lh       priority queue
- * \param[in]    stack    of reusable WSPixels
- * \param[in]    val      pixel value: used for ordering the heap
+ * \param[in]    wsq      priority queue
+ * \param[in]    val      pixel value: selects the fifo
  * \param[in]    x, y     pixel coordinates
  * \param[in]    index    label for set to which pixel belongs
- * \return    void
+ * \return    0 if OK, 1 on error
  *
  * <pre>
  * Notes:
- *      (1) This is a wrapper for adding a WSPixel to a heap.  It
- *          uses the storage stack to retrieve a WSPixel.
+ *      (1) This is a wrapper for adding a pixel to the fifo for
+ *          its value, keeping track of the lowest nonempty fifo.
  * </pre>
  */
-static void
-pushWSPixel(L_HEAP   *lh,
-            L_STACK  *stack,
-            l_int32   val,
-            l_int32   x,
-            l_int32   y,
-            l_int32   index)
+static l_int32
+pushWSPixel(L_WSQUEUE  *wsq,
+            l_int32     val,
+            l_int32     x,
+            l_int32     y,
+            l_int32     index)
 {
-L_WSPIXEL  *wsp;
-
     PROCNAME("pushWSPixel");
 
-    if (!lh) {
-        L_ERROR("heap not defined\n", procName);
-        return;
-    }
-    if (!stack) {
-        L_ERROR("stack not defined\n", procName);
-        return;
-    }
-
-        /* Get a wspixel to use */
-    if (lstackGetCount(stack) > 0)
-        wsp = (L_WSPIXEL *)lstackRemove(stack);
-    else
-        wsp = (L_WSPIXEL *)LEPT_CALLOC(1, sizeof(L_WSPIXEL));
-
-    wsp->val = (l_float32)val;
-    wsp->x = x;
-    wsp->y = y;
-    wsp->index = index;
-    lheapAdd(lh, wsp);
-    return;
+    if (!wsq->fifo[val] &&
+        (wsq->fifo[val] = lpairqueueCreate(0)) == NULL)
+        return ERROR_INT("fifo not made", procName, 1);
+    if (lpairqueueAdd(wsq->fifo[val], y * wsq->w + x, index))
+        return 1;
+    wsq->count++;
+    if (val < wsq->minval)
+        wsq->minval = val;
+    return 0;
 }
 
 
 /*
  * \brief  popWSPixel()
  *
- * \param[in]     lh        priority queue
- * \param[in]     stack     of reusable WSPixels
+ * \param[in]     wsq       priority queue; must not be empty
  * \param[out]    pval      pixel value
  * \param[out]    px, py    pixel coordinates
  * \param[out]    pindex    label for set to which pixel belongs
@@ -955,43 +1040,28 @@ L_WSPIXEL  *wsp;
  *
  * <pre>
  * Notes:
- *      (1) This is a wrapper for removing a WSPixel from a heap,
- *          which returns the WSPixel data and saves the WSPixel
- *          on the storage stack.
+ *      (1) This removes the oldest pixel from the lowest nonempty fifo.
+ *          Pixels with the same value are removed in the order in
+ *          which they were added.
  * </pre>
  */
 static void
-popWSPixel(L_HEAP   *lh,
-           L_STACK  *stack,
-           l_int32  *pval,
-           l_int32  *px,
-           l_int32  *py,
-           l_int32  *pindex)
+popWSPixel(L_WSQUEUE  *wsq,
+           l_int32    *pval,
+           l_int32    *px,
+           l_int32    *py,
+           l_int32    *pindex)
 {
-L_WSPIXEL  *wsp;
-
-    PROCNAME("popWSPixel");
-
-    if (!lh) {
-        L_ERROR("lheap not defined\n", procName);
-        return;
-    }
-    if (!stack) {
-        L_ERROR("stack not defined\n", procName);
-        return;
-    }
-    if (!pval || !px || !py || !pindex) {
-        L_ERROR("data can't be returned\n", procName);
-        return;
-    }
-
-    if ((wsp = (L_WSPIXEL *)lheapRemove(lh)) == NULL)
-        return;
-    *pval = (l_int32)wsp->val;
-    *px = wsp->x;
-    *py = wsp->y;
-    *pindex = wsp->index;
-    lstackAdd(stack, wsp);  /* save for re-use */
+l_int32  loc;
+
+    while (!wsq->fifo[wsq->minval] ||
+           lpairqueueGetCount(wsq->fifo[wsq->minval]) == 0)
+        wsq->minval++;
+    lpairqueueRemove(wsq->fifo[wsq->minval], &loc, pindex);
+    wsq->count--;
+    *pval = wsq->minval;
+    *py = loc / wsq->w;
+    *px = loc - wsq->w * (*py);
     return;
 }
 
@@ -1058,6 +1128,53 @@ wshedBasins(L_WSHED  *wshed,
 }
 
 
+/*!
+ * \brief   wshedLabels()
+ *
+ * \param[in]    wshed
+ * \return  pixd   32 bpp label image of the basins, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) Each pixel in basin i is labeled i + 1, where i is the
+ *          index of the basin in the pixa and in the numa of levels
+ *          returned by wshedBasins().  Pixels in no basin are 0.
+ *      (2) If wshedSetLabelsOnly() was called, this is a copy of the
+ *          label image made by wshedApply(); otherwise it is rendered
+ *          from the pixa of basins.
+ * </pre>
+ */
+PIX *
+wshedLabels(L_WSHED  *wshed)
+{
+l_int32  i, n, bx, by, w, h;
+PIX     *pix, *pixd;
+
+    PROCNAME("wshedLabels");
+
+    if (!wshed)
+        return (PIX *)ERROR_PTR("wshed not defined", procName, NULL);
+
+    if (wshed->labelsonly) {
+        if (!wshed->pixbasin)
+            return (PIX *)ERROR_PTR("wshed not applied", procName, NULL);
+        return pixCopy(NULL, wshed->pixbasin);
+    }
+
+    pixGetDimensions(wshed->pixs, &w, &h, NULL);
+    if ((pixd = pixCreate(w, h, 32)) == NULL)
+        return (PIX *)ERROR_PTR("pixd not made", procName, NULL);
+    n = pixaGetCount(wshed->pixad);
+    for (i = 0; i < n; i++) {
+        pix = pixaGetPix(wshed->pixad, i, L_CLONE);
+        pixaGetBoxGeometry(wshed->pixad, i, &bx, &by, NULL, NULL);
+        pixPaintThroughMask(pixd, pix, bx, by, i + 1);
+        pixDestroy(&pix);
+    }
+    return pixd;
+}
+
+
 /*!
  * \brief   wshedRenderFill()
  *
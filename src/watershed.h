@@ -58,6 +58,8 @@ struct L_WShed
     struct Numa  **links;     /*!< back-links into lut, for updates         */
     l_int32        arraysize; /*!< size of links array                      */
     l_int32        debug;     /*!< set to 1 for debug output                */
+    l_int32        labelsonly; /*!< 1 to make only pixbasin, not pixad      */
+    struct Pix    *pixbasin;  /*!< result: 32 bpp label pix of basins       */
 };
 typedef struct L_WShed L_WSHED;
 